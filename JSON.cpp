@@ -11,22 +11,64 @@
 
 #include "JSON.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+#ifdef JSON_UTF8
+//macOS & POSIX specific
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
-namespace json
-{
+#if defined(__x86_64__) || defined(_M_X64)
+//x86-64 specific
+#define JSON_SIMD_X64 1
 
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define JSON_TARGET_AVX2
+#else
+#define JSON_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
 
-#ifdef __APPLE__
-int thread_local CJSON::g_tls_LastErr;
 #endif
 
 
+namespace json
+{
+
 
-int CJSON::parseJSON(LPCTSTR pStr, JSON_DATA& outJEs, JSON_ERROR* pJError)
+int CJSON::parseJSON(LPCTSTR pStr, JSON_DATA& outJEs, JSON_ERROR* pJError, UINT nParseFlags)
 {
     //Parse 'pStr' as JSON
     //'outJEs' = receives parsed JSON data -- must be newly created
     //'pJError' = if not nullptr, will be filled with parsing error details
+    //'nParseFlags' = one or more of JPF_* values
+    //                 INFO: If JPF_REFERENCE_SOURCE is used, 'pStr' must not change or be freed while 'outJEs' is in use!
+    //RETURN:
+    //		= 1 if got it OK
+    //		= 0 if JSON format error
+    //		= -1 if other non-JSON related error (such as out of memory, etc.)
+    //           INFO: Check CJSON::GetLastError() for more info.
+    return parseJSON(pStr, pStr ? STRLEN(pStr) : 0, outJEs, pJError, nParseFlags);
+}
+
+
+int CJSON::parseJSON(LPCTSTR pStr, intptr_t nchLen, JSON_DATA& outJEs, JSON_ERROR* pJError, UINT nParseFlags)
+{
+    //Parse 'nchLen' characters of 'pStr' as JSON
+    //INFO: 'pStr' doesn't need to be null-terminated
+    //'outJEs' = receives parsed JSON data -- must be newly created
+    //'pJError' = if not nullptr, will be filled with parsing error details
+    //'nParseFlags' = one or more of JPF_* values
+    //                 INFO: If JPF_REFERENCE_SOURCE is used, 'pStr' must not change or be freed while 'outJEs' is in use!
     //RETURN:
     //		= 1 if got it OK
     //		= 0 if JSON format error
@@ -34,14 +76,18 @@ int CJSON::parseJSON(LPCTSTR pStr, JSON_DATA& outJEs, JSON_ERROR* pJError)
     //           INFO: Check CJSON::GetLastError() for more info.
     int nRes = -1;
 
-    if(pStr)
+    if(pStr &&
+        nchLen >= 0)
     {
         //Clear the data variable
         outJEs.emptyData();
 
+        JSON_PARSE_CTX ctx(pJError, outJEs.getArena(), nParseFlags);
+        JSON_PARSE_CTX* pCtx = &ctx;
+
         //Begin
         intptr_t i = 0;
-        intptr_t nLen = STRLEN(pStr);
+        intptr_t nLen = nchLen;
 
         //Reset last error before we begin
         CJSON::SetLastError(0);
@@ -51,7 +97,7 @@ int CJSON::parseJSON(LPCTSTR pStr, JSON_DATA& outJEs, JSON_ERROR* pJError)
         if(c)
         {
             //Begin from the root object
-            nRes = _parseForValue(outJEs.val, pStr, i, nLen, pJError);
+            nRes = _parseForValue(outJEs.val, pStr, i, nLen, pCtx);
             if(nRes == 1)
             {
                 //Skip to the end
@@ -62,6 +108,11 @@ int CJSON::parseJSON(LPCTSTR pStr, JSON_DATA& outJEs, JSON_ERROR* pJError)
                     _describeError(pJError, i, L("Unexpected data after the root node"));
                     nRes = 0;
                 }
+                else if(ctx.pArena)
+                {
+                    //All of it is in the arena, so it can be emptied by resetting the arena
+                    outJEs.bOnlyInArena = true;
+                }
             }
         }
         else
@@ -82,4495 +133,12694 @@ int CJSON::parseJSON(LPCTSTR pStr, JSON_DATA& outJEs, JSON_ERROR* pJError)
 }
 
 
+struct JSON_ARRAY_PARSE_STATE
+{
+    //Shared state of threads in CJSON::parseJSONParallel()
+    const WCHAR* pData;                 //JSON to parse
+    intptr_t nLen;                      //Length of 'pData' in TCHARs
+    UINT nParseFlags;                   //JPF_* flags to parse with
+    std::vector<intptr_t> arrSeps;      //Index of the opening '[', of each ',' between elements, and of the closing ']'
+    JSON_ARRAY* pJA;                    //Root array to parse elements into (it already has all of them)
+    size_t nCntPerBatch;                //Number of elements that each thread takes at a time
+
+    std::atomic<size_t> nNextBatch;     //Next batch of elements to parse
+    std::atomic<bool> bFailed;          //true if any of the elements failed to parse
+};
 
 
-WCHAR CJSON::_skipWhiteSpaces(const WCHAR* pData, intptr_t& i, intptr_t nLen)
+int CJSON::parseJSONParallel(LPCTSTR pStr, intptr_t nchLen, JSON_DATA& outJEs, JSON_ERROR* pJError, UINT nParseFlags, UINT nCntThreads)
 {
-    //Update 'i' to point to the next non-white space WCHAR
-    //'pData' = beginning of JSON string to parse
-    //'i' = index of the WCHAR to begin skipping white spaces from
-    //		INFO: It will be updated upon return to point to the first non-space char on or after original 'i'
-    //'nLen' = length of 'pData' in TCHARs
+    //Parse 'nchLen' characters of 'pStr' as JSON, and if its root is an array, parse its elements in several threads
+    //INFO: Elements of the root array are found first, without parsing them, then parsed in separate threads and put into the
+    //      array in their order. If anything fails, the whole JSON is parsed again in one thread, so the result and the error
+    //      details are always the same as with CJSON::parseJSON().
+    //INFO: JSON data that uses an arena (see JSON_DATA::useArena) is parsed in one thread.
+    //INFO: Threads are started on each call. If they can't be started, the calling thread parses what they would have.
+    //'pStr' = JSON to parse (doesn't need to be null-terminated)
+    //'outJEs' = receives parsed JSON data -- must be newly created
+    //'pJError' = if not nullptr, will be filled with parsing error details
+    //'nParseFlags' = one or more of JPF_* values
+    //                 INFO: If JPF_REFERENCE_SOURCE is used, 'pStr' must not change or be freed while 'outJEs' is in use!
+    //'nCntThreads' = number of threads to parse with, including the calling thread, or 0 to use one per CPU core
     //RETURN:
-    //		= Non-0 for the next non-white-space WCHAR on or after 'i' (and 'i' will point to this non-white-space char in 'pData')
-    //		= 0 if end-of-data is reached (and 'i' is out of scope)
-    for(; i < nLen; i++)
+    //		= 1 if got it OK
+    //		= 0 if JSON format error
+    //		= -1 if other non-JSON related error (such as out of memory, etc.)
+    //           INFO: Check CJSON::GetLastError() for more info.
+    if(!nCntThreads)
+        nCntThreads = std::thread::hardware_concurrency();
+
+    //Not worth it for small JSON
+    if(pStr &&
+        nchLen >= JSON_PARALLEL_MIN_LEN &&
+        nCntThreads > 1 &&
+        !outJEs.getArena())
     {
-        WCHAR z = pData[i];
-        ASSERT(z);
-        if(_isWhiteSpace(z))
-            continue;
+        JSON_ARRAY_PARSE_STATE state;
+        if(_findArrayElements(pStr, nchLen, state.arrSeps) &&
+            state.arrSeps.size() > 2)
+        {
+            outJEs.emptyData();
 
-        return z;
+            size_t nCntElmts = state.arrSeps.size() - 1;
+
+            JSON_ARRAY* pJA = _newJSON_ARRAY(nullptr);
+            if(pJA)
+            {
+                pJA->arrArrElmts.resize(nCntElmts);
+
+                state.pData = pStr;
+                state.nLen = nchLen;
+                state.nParseFlags = nParseFlags;
+                state.pJA = pJA;
+                state.nCntPerBatch = nCntElmts / ((size_t)nCntThreads * 16) + 1;
+                state.nNextBatch = 0;
+                state.bFailed = false;
+
+                //Parse elements in other threads and in this one
+                std::vector<std::thread> arrThreads;
+                try
+                {
+                    for(size_t t = 1; t < nCntThreads && t < nCntElmts; t++)
+                    {
+                        arrThreads.push_back(std::thread(_parseArrayElements, &state));
+                    }
+                }
+                catch(const std::system_error&)
+                {
+                    //Couldn't start a thread, parse with the ones that we have
+                }
+
+                _parseArrayElements(&state);
+
+                for(size_t t = 0; t < arrThreads.size(); t++)
+                {
+                    arrThreads[t].join();
+                }
+
+                if(!state.bFailed)
+                {
+                    //Done
+                    outJEs.val.valType = JVT_ARRAY;
+                    outJEs.val.pValue = pJA;
+
+                    CJSON::SetLastError(0);
+                    return 1;
+                }
+
+                //Parse it again below to get the same error
+                _freeJSON_ARRAY(pJA);
+            }
+        }
     }
 
-    //End of file
-    return 0;
+    return parseJSON(pStr, nchLen, outJEs, pJError, nParseFlags);
 }
 
 
-
-int CJSON::_parseDoubleQuotedString(std_wstring& str, const WCHAR* pData, intptr_t& i, intptr_t nLen, JSON_ERROR* pJError)
+bool CJSON::_findArrayElements(const WCHAR* pData, intptr_t nLen, std::vector<intptr_t>& arrSeps)
 {
-    //Parse double quoted string into 'str'
-    //'pData' = beginning of JSON string to parse
-    //'i' = index of the '"' WCHAR to begin parsing the "string" from
-    //		INFO: It will be updated upon return to point to the char one after the last one in the "string"
+    //Find where elements of the root array begin and end, without parsing them
+    //INFO: Only strings and nesting are tracked here, so the elements still need to be parsed to know that they're valid
+    //'pData' = JSON to look in
     //'nLen' = length of 'pData' in TCHARs
+    //'arrSeps' = receives the index of the opening '[', of each ',' between elements, and of the closing ']'
     //RETURN:
-    //		= 1 if got it OK, 'i' points to the next WCHAR after the "string"
-    //		= 0 if format error, 'i' may be out of range
-    //		= -1 if other non-JSON related error (such as out of memory, check CJSON::GetLastError() for info)
+    //		= true if the root is an array that is closed, and nothing but white spaces follow it
+    arrSeps.clear();
 
-    //Clear the string
-    str.clear();
+    intptr_t i = 0;
+    if(_skipWhiteSpaces(pData, i, nLen) != '[')
+        return false;
 
-    WCHAR buffHex[5];
-    buffHex[SIZEOF(buffHex) - 1] = 0;
+    arrSeps.push_back(i++);
 
-    intptr_t i_delta = 1;
-    
-    //Fill out string
-    for(i++;; i += i_delta)
+    intptr_t nDepth = 0;
+    for(; i < nLen; i++)
     {
-        if(i >= nLen)
+        WCHAR c = pData[i];
+        if(c == '"')
         {
-            //Reached EOF
-            ASSERT(nullptr);
-            _describeError(pJError, i, L("Unexpected EOF"));
-            return 0;
-        }
+            //Skip to the closing quote
+            for(i++;;)
+            {
+                i = _findStringSpecialChar(pData, i, nLen);
+                if(i >= nLen)
+                    return false;
 
-#ifdef _WIN32
-//Windows specific
-        WCHAR z = pData[i];
-        
-#elif __APPLE__
-//macOS specific
-        
-        UINT z;
-        i_delta = JSON_NODE::getUtf8Char(pData, i, nLen, &z);
-        if(i_delta <= 0)
-        {
-            //Error
-            ASSERT(nullptr);
-            _describeError(pJError, i, L("Bad UTF-8 sequence"));
-            return 0;
-        }
-#endif
-        
-        if(z == '"')
-        {
-            //End of string reached
-            i += i_delta;
+                if(pData[i] == '"')
+                    break;
 
-            return 1;
+                i += pData[i] == '\\' ? 2 : 1;
+            }
         }
-        else if(z == '\n' || z == '\r')
+        else if(c == '[' ||
+            c == '{')
         {
-            //Error in formatting
-            ASSERT(nullptr);
-            _describeError(pJError, i, L("Newline in quote"));
-            return 0;
+            nDepth++;
         }
-        else if(z == '\\')
+        else if(c == ']' ||
+            c == '}')
         {
-            //Escaping, get next char
-            i += i_delta;
-            
-            if(i >= nLen)
+            if(nDepth == 0)
             {
-                //Error
-                ASSERT(nullptr);
-                _describeError(pJError, i, L("Unexpected EOF"));
-                return 0;
+                //End of the root array?
+                if(c != ']')
+                    return false;
+
+                arrSeps.push_back(i++);
+                return _skipWhiteSpaces(pData, i, nLen) == 0;
             }
 
-            //Get next char, look for special cases
-            //%x22 /          ; "    quotation mark  U+0022
-            //%x5C /          ; \    reverse solidus U+005C
-            //%x2F /          ; /    solidus         U+002F
-            //%x62 /          ; b    backspace       U+0008
-            //%x66 /          ; f    form feed       U+000C
-            //%x6E /          ; n    line feed       U+000A
-            //%x72 /          ; r    carriage return U+000D
-            //%x74 /          ; t    tab             U+0009
-            //%x75 4HEXDIG )  ; uXXXX                U+XXXX
-            ASSERT('\b' == 0x0008);
-            ASSERT('\f' == 0x000C);
-            ASSERT('\n' == 0x000A);
-            ASSERT('\r' == 0x000D);
-            ASSERT('\t' == 0x0009);
+            nDepth--;
+        }
+        else if(c == ',' &&
+            nDepth == 0)
+        {
+            arrSeps.push_back(i);
+        }
+    }
+
+    return false;
+}
 
-            z = pData[i];
-            if(z == '"' ||
-                z == '\\' ||
-                z == '/')
-            {
-                //Keep it as is
-            }
-            else if(z == 'b')
-            {
-                z = '\b';
-            }
-            else if(z == 'f')
-            {
-                z = '\f';
-            }
-            else if(z == 'n')
-            {
-                z = '\n';
-            }
-            else if(z == 'r')
-            {
-                z = '\r';
-            }
-            else if(z == 't')
-            {
-                z = '\t';
-            }
-            else if(z == 'u')
-            {
-                //\u005C
-                if(i + 4 >= nLen)
-                {
-                    //Error
-                    ASSERT(nullptr);
-                    _describeError(pJError, i, L("Unexpected EOF"));
-                    return 0;
-                }
 
-                buffHex[0] = pData[++i];
-                buffHex[1] = pData[++i];
-                buffHex[2] = pData[++i];
-                buffHex[3] = pData[++i];
+void CJSON::_parseArrayElements(JSON_ARRAY_PARSE_STATE* pState)
+{
+    //Parse batches of root array elements until there are none left (runs in each thread)
+    //INFO: Errors are not described, since CJSON::parseJSONParallel() parses it again if anything fails
+    JSON_PARSE_CTX ctx(nullptr, nullptr, pState->nParseFlags);
 
-                UINT uZ = 0;
+    const intptr_t* pSeps = pState->arrSeps.data();
+    JSON_ARRAY_ELEMENT* pJAEs = pState->pJA->arrArrElmts.data();
+    size_t nCntElmts = pState->pJA->arrArrElmts.size();
 
-#ifdef _WIN32
-//Windows specific
-                if(_stscanf_s(buffHex, L"%x", &uZ) != 1 ||
-                    uZ > 0xFFFF)
-                {
-                    //Error
-                    ASSERT(nullptr);
-                    _describeError(pJError, i, L("Failed to unescape"));
-                    return 0;
-                }
+    while(!pState->bFailed)
+    {
+        size_t nFrom = pState->nNextBatch++ * pState->nCntPerBatch;
+        if(nFrom >= nCntElmts)
+            break;
 
-                z = (WCHAR)uZ;
+        size_t nTo = nFrom + pState->nCntPerBatch < nCntElmts ? nFrom + pState->nCntPerBatch : nCntElmts;
 
-#elif __APPLE__
-//macOS specific
-                if(sscanf(buffHex, "%x", &uZ) != 1 ||
-                   uZ > UTF8_MAX_VAL)
-                {
-                    //Error
-                    ASSERT(nullptr);
-                    _describeError(pJError, i, L("Failed to unescape"));
-                    return 0;
-                }
-                
-                z = uZ;
-#endif
-            }
-            else
+        for(size_t e = nFrom; e < nTo; e++)
+        {
+            //Each element must take all the space up to the next separator
+            intptr_t i = pSeps[e] + 1;
+            if(_parseForValue(pJAEs[e].val, pState->pData, i, pSeps[e + 1], &ctx) != 1 ||
+                _skipWhiteSpaces(pState->pData, i, pSeps[e + 1]) != 0)
             {
-                //Technically an error = but don't quit
-                ASSERT(nullptr);		//Bad escaping
+                pState->bFailed = true;
+                break;
             }
         }
-
-        //Add it to name
-#ifdef _WIN32
-//Windows specific
-        str += z;
-        
-#elif __APPLE__
-//macOS specific
-        if(!JSON_NODE::appendUtf8Char(str, z))
-        {
-            //Failed
-            ASSERT(nullptr);
-            _describeError(pJError, i, L("Failed to add UTF-8 character"));
-            return 0;
-        }
-#endif
     }
-
-    ASSERT(nullptr);
-    _describeError(pJError, i, L("Bad execution branch"));
-    CJSON::SetLastError(ERROR_HANDLE_EOF);
-    return -1;
 }
 
 
-int CJSON::_parseForArray(JSON_ARRAY& ja, const WCHAR* pData, intptr_t& i, intptr_t nLen, JSON_ERROR* pJError)
+int CJSON::parseJSONFile(LPCTSTR pStrFilePath, JSON_DATA& outJEs, JSON_ERROR* pJError, UINT nParseFlags, uint64_t ncbSzMaxFileSz, UINT nCntThreads)
 {
-    //Parse for array
-    //'ja' = array to parse into -- must be freshly created
-    //'pData' = beginning of JSON string to parse
-    //'i' = index of the WCHAR to begin parsing from (may be space) -- must be the char right after the opening '['
-    //		INFO: It will be updated upon return to point to the char one after the last one in the array, i.e. ']'
-    //'nLen' = length of 'pData' in TCHARs
+    //Parse JSON from a file, without reading it into memory first
+    //INFO: The file is mapped into memory, and if it is already in the encoding of LPCTSTR strings (UTF-8 on macOS & POSIX,
+    //      or UTF-16 on Windows) it is parsed straight from there. Otherwise it is converted first.
+    //'pStrFilePath' = file path (takes into account BOMs for text file encodings)
+    //'outJEs' = receives parsed JSON data -- must be newly created
+    //'pJError' = if not nullptr, will be filled with parsing error details
+    //'nParseFlags' = one or more of JPF_* values
+    //                 INFO: JPF_REFERENCE_SOURCE is ignored, since the file is unmapped upon return
+    //'ncbSzMaxFileSz' = if not 0, maximum allowed file size in BYTEs
+    //'nCntThreads' = number of threads to parse elements of the root array with (see CJSON::parseJSONParallel), or 0 to use one per CPU core
     //RETURN:
-    //		= 1 if got it OK, 'i' points to the next WCHAR after the value
-    //		= 0 if format error, 'i' may be out of range
-    //		= -1 if other non-JSON related error (such as out of memory, check CJSON::GetLastError() for info)
-    int nR;
+    //		= 1 if got it OK
+    //		= 0 if JSON format error
+    //		= -1 if other non-JSON related error (such as failure to read the file, out of memory, etc.)
+    //           INFO: Check CJSON::GetLastError() for more info.
+    int nRes = -1;
+    int nOSError = NO_ERROR;
 
-    bool bGotPreviousComma = true;
+    nParseFlags &= ~JPF_REFERENCE_SOURCE;
 
-    for(intptr_t cnt = 0;; cnt++)
+    JSON_FILE_MAPPING fileMap;
+    if(fileMap.open(pStrFilePath, ncbSzMaxFileSz))
     {
-        //Go to next non-white-space
-        WCHAR c = _skipWhiteSpaces(pData, i, nLen);
-        if(!c)
-        {
-            //Reached EOF too early
-            ASSERT(nullptr);
-            _describeError(pJError, i, L("Unexpected EOF"));
-            return 0;
-        }
+        static const BYTE kEmpty[1] = {};
 
-        if(c == ']')
-        {
-            //End of array
-            i++;
+        const BYTE* pData = fileMap.getData() ? fileMap.getData() : kEmpty;
+        size_t ncbDataSz = (size_t)fileMap.getSize();
 
-            return 1;
+        int ncbSzBOM;
+        JSON_ENCODING enc = _detectFileEncoding(pData, ncbDataSz, &ncbSzBOM);
+
+        pData += ncbSzBOM;
+        ncbDataSz -= ncbSzBOM;
+
+#ifdef _WIN32
+        //Windows specific
+        if(enc == JENC_UNICODE_16 &&
+            ncbDataSz % sizeof(WCHAR) == 0)
+#elif JSON_UTF8
+        //macOS & POSIX specific
+        if(enc == JENC_UTF_8)
+#endif
+        {
+            //Already in the encoding that we need
+            nRes = parseJSONParallel((const WCHAR*)pData, ncbDataSz / sizeof(WCHAR), outJEs, pJError, nParseFlags, nCntThreads);
         }
-        else if(c == ',')
+        else
         {
-            //Comma separator between elements (only if not the first element)
-            if(cnt == 0 ||
-                bGotPreviousComma)
+            //Need to convert it
+            std_wstring str;
+            if(CJSON::convertStringToUnicode((const char*)pData, ncbDataSz, enc, &str))
             {
-                //Error
-                ASSERT(nullptr);
-                _describeError(pJError, i, L("Unexpected comma"));
-                return 0;
+                //Don't need the file anymore
+                fileMap.close();
+
+                nRes = parseJSONParallel(str.c_str(), str.size(), outJEs, pJError, nParseFlags, nCntThreads);
+            }
+            else
+            {
+                nOSError = CJSON::GetLastError();
+                _describeError(pJError, -1, L("Failed to convert file contents"));
             }
+        }
 
-            //Signal that we got it
-            bGotPreviousComma = true;
+        if(nRes >= 0)
+            return nRes;
+    }
+    else
+    {
+        nOSError = CJSON::GetLastError();
+        _describeError(pJError, -1, L("Failed to read file"));
+    }
 
-            //Otherwise skip it
-            i++;
-            continue;
-        }
+    //Nothing was parsed
+    outJEs.emptyData();
 
-        //Make sure that we've got a comma before
-        if(!bGotPreviousComma)
+    CJSON::SetLastError(nOSError);
+    return nRes;
+}
+
+
+struct JSON_LINE_RESULT
+{
+    //Parsed line of JSON Lines input
+    intptr_t nLine;                     //0-based index of the line in the input
+    int nRes;                           //Result of CJSON::parseJSON() for the line
+    int nOSError;                       //Last error if 'nRes' is -1
+    JSON_DATA* pJData;                  //Parsed line, or nullptr if failed
+    JSON_ERROR jErr;                    //Parsing error details
+};
+
+struct JSON_LINES_CHUNK
+{
+    //Range of whole lines of JSON Lines input that is parsed by one thread
+    intptr_t nBegin;                    //Index of the first WCHAR in the input
+    intptr_t nEnd;                      //Index after the last WCHAR in the input
+    intptr_t nFirstLine;                //0-based index of the first line in the chunk
+    bool bDone;                         //true when all lines in the chunk were parsed
+    std::vector<JSON_LINE_RESULT> arrResults;
+};
+
+struct JSON_LINES_CTX
+{
+    //Shared state of threads in CJSON::parseJSONLines()
+    const WCHAR* pStr;                  //JSON Lines input
+    UINT nParseFlags;                   //JPF_* flags to parse each line with
+    bool bInOrder;                      //true to deliver lines in the order they appear in the input
+    bool bDirect;                       //true to deliver each line as soon as it's parsed (when parsing in one thread)
+    JSON_LINE_CALLBACK pfnCallback;
+    void* pCbkParam;
+
+    std::vector<JSON_LINES_CHUNK> arrChunks;
+    size_t nMaxChunksAhead;             //Number of chunks that can be parsed ahead of the ones not delivered yet
+
+    std::mutex mtx;                     //Protects fields below
+    std::condition_variable cvDelivered;//Signaled when a chunk is delivered
+    size_t nNextChunk;                  //Next chunk to parse
+    size_t nNextToDeliver;              //Next chunk to deliver (if 'bInOrder')
+    bool bDelivering;                   //true if one of the threads is delivering chunks
+    std::mutex mtxCallback;             //Used to call 'pfnCallback' from one thread at a time (if not 'bInOrder')
+
+    std::atomic<bool> bStop;            //true to stop parsing (when callback returned false)
+    std::atomic<int> nWorstRes;         //Lowest result of CJSON::parseJSON() for all lines delivered
+    std::atomic<int> nOSError;          //Last error to return from CJSON::parseJSONLines()
+};
+
+
+static intptr_t _findNewLine(const WCHAR* pStr, intptr_t i, intptr_t nLen)
+{
+    //RETURN: = Index of the next '\n' in 'pStr' on or after 'i', or 'nLen' if none
+#ifdef _WIN32
+    //Windows specific
+    const WCHAR* pFnd = wmemchr(pStr + i, L'\n', nLen - i);
+#elif JSON_UTF8
+    //macOS & POSIX specific
+    const char* pFnd = (const char*)memchr(pStr + i, '\n', nLen - i);
+#endif
+
+    return pFnd ? pFnd - pStr : nLen;
+}
+
+
+static void _deliverJSONLine(JSON_LINES_CTX* pCtx, JSON_LINE_RESULT& res)
+{
+    //Pass parsed line to the callback
+    //INFO: Must be called from one thread at a time
+    if(!pCtx->bStop)
+    {
+        if(res.nRes < pCtx->nWorstRes)
         {
-            //Error - missing comma
-            ASSERT(nullptr);
-            _describeError(pJError, i, L("Expected a comma"));
-            return 0;
-        }
+            pCtx->nWorstRes = res.nRes;
 
-        JSON_ARRAY_ELEMENT jae;
+            if(res.nRes < 0)
+                pCtx->nOSError = res.nOSError;
+        }
 
-        //Parse value
-        nR = _parseForValue(jae.val, pData, i, nLen, pJError);
-        if(nR != 1)
+        if(!pCtx->pfnCallback(res.nLine, res.nRes, res.nRes == 1 ? res.pJData : nullptr, &res.jErr, pCtx->pCbkParam))
         {
-            //Error
-            ASSERT(nullptr);
-            _describeError(pJError, i, L("Value parsing failed"));
-            return nR;
+            //Stop parsing
+            pCtx->bStop = true;
+            pCtx->nOSError = ERROR_CANCELLED;
         }
+    }
+}
 
-        //Add it
-        ja.arrArrElmts.push_back(jae);
 
-        //Reset comma flag
-        bGotPreviousComma = false;
+static void _deliverJSONLinesChunk(JSON_LINES_CTX* pCtx, JSON_LINES_CHUNK& chunk)
+{
+    //Pass parsed lines from 'chunk' to the callback, and free them
+    //INFO: Must be called from one thread at a time
+    for(size_t r = 0; r < chunk.arrResults.size(); r++)
+    {
+        JSON_LINE_RESULT& res = chunk.arrResults[r];
+        _deliverJSONLine(pCtx, res);
+
+        if(res.pJData)
+        {
+            delete res.pJData;
+            res.pJData = nullptr;
+        }
     }
 
-//	_describeError(pJError, i, L("Bad execution branch"));
-//    CJSON::SetLastError(ERROR_INVALID_DATA);
-//	return -1;
+    //Free memory
+    std::vector<JSON_LINE_RESULT>().swap(chunk.arrResults);
 }
 
 
-
-int CJSON::_parseForObject(JSON_OBJECT& jo, const WCHAR* pData, intptr_t& i, intptr_t nLen, JSON_ERROR* pJError)
+static void _parseJSONLinesChunks(JSON_LINES_CTX* pCtx)
 {
-    //Parse for object
-    //'jo' = object to parse into -- must be freshly created
-    //'pData' = beginning of JSON string to parse
-    //'i' = index of the WCHAR to begin parsing from (may be space) -- must be the char right after the opening '{'
-    //		INFO: It will be updated upon return to point to the char one after the last one in the object, i.e. '}'
-    //'nLen' = length of 'pData' in TCHARs
-    //RETURN:
-    //		= 1 if got it OK, 'i' points to the next WCHAR after the object
-    //		= 0 if format error, 'i' may be out of range
-    //		= -1 if other non-JSON related error (such as out of memory, check CJSON::GetLastError() for info)
-    int nR;
-
-    bool bGotPreviousComma = true;
+    //Parse chunks of JSON Lines input until there are none left (runs in each thread)
+    std::unique_lock<std::mutex> lock(pCtx->mtx);
 
-    for(intptr_t cnt = 0;; cnt++)
+    for(;;)
     {
-        //Go to next non-white-space
-        WCHAR c = _skipWhiteSpaces(pData, i, nLen);
-        if(!c)
+        //Don't get too far ahead of the chunks that are waiting to be delivered in order
+        while(pCtx->bInOrder &&
+            !pCtx->bStop &&
+            pCtx->nNextChunk < pCtx->arrChunks.size() &&
+            pCtx->nNextChunk >= pCtx->nNextToDeliver + pCtx->nMaxChunksAhead)
         {
-            //Reached EOF too early
-            ASSERT(nullptr);
-            _describeError(pJError, i, L("Unexpected EOF"));
-            return 0;
+            pCtx->cvDelivered.wait(lock);
         }
 
-        if(c == '}')
+        if(pCtx->bStop ||
+            pCtx->nNextChunk >= pCtx->arrChunks.size())
         {
-            //End of object
-            i++;
-
-            return 1;
+            break;
         }
-        else if(c == ',')
-        {
-            //Comma separator between elements (only if not the first element)
-            if(cnt == 0 ||
-                bGotPreviousComma)
-            {
-                //Error
-                ASSERT(nullptr);
-                _describeError(pJError, i, L("Unexpected comma"));
-                return 0;
-            }
 
-            //Signal that we got it
-            bGotPreviousComma = true;
+        size_t c = pCtx->nNextChunk++;
+        JSON_LINES_CHUNK& chunk = pCtx->arrChunks[c];
 
-            //Otherwise skip it
-            i++;
-            continue;
-        }
-        else if(c == '"')
+        lock.unlock();
+
+        //Parse each line in the chunk
+        const WCHAR* pStr = pCtx->pStr;
+        intptr_t nLine = chunk.nFirstLine;
+        JSON_DATA jDataDirect;
+
+        for(intptr_t i = chunk.nBegin; i < chunk.nEnd && !pCtx->bStop; nLine++)
         {
-            //Name
+            intptr_t nEOL = _findNewLine(pStr, i, chunk.nEnd);
 
-            //Make sure that we've got a comma before
-            if(!bGotPreviousComma)
+            //Skip empty lines
+            intptr_t j = i;
+            while(j < nEOL &&
+                (pStr[j] == ' ' || pStr[j] == '\t' || pStr[j] == '\r'))
             {
-                //Error - missing comma
-                ASSERT(nullptr);
-                _describeError(pJError, i, L("Expected a comma"));
-                return 0;
+                j++;
             }
 
-            JSON_OBJECT_ELEMENT joe;
-
-            //Parse name
-            nR = _parseDoubleQuotedString(joe.strName, pData, i, nLen, pJError);
-            if(nR != 1)
+            if(j < nEOL &&
+                pCtx->bDirect)
             {
-                //Error
-                ASSERT(nullptr);
-                _describeError(pJError, i, L("Quote parsing failed"));
-                return nR;
+                //Parsed in one thread, so pass it on right away
+                JSON_LINE_RESULT res;
+                res.nLine = nLine;
+                res.pJData = &jDataDirect;
+                res.nRes = CJSON::parseJSON(pStr + i, nEOL - i, jDataDirect, &res.jErr, pCtx->nParseFlags);
+                res.nOSError = res.nRes < 0 ? CJSON::GetLastError() : NO_ERROR;
+
+                _deliverJSONLine(pCtx, res);
             }
-            
-            //Go to next non-white-space
-            c = _skipWhiteSpaces(pData, i, nLen);
-            if(!c)
+            else if(j < nEOL)
             {
-                //Reached EOF too early
-                ASSERT(nullptr);
-                _describeError(pJError, i, L("Unexpected EOF"));
-                return 0;
-            }
+                //Keep it until the chunk is delivered
+                chunk.arrResults.push_back(JSON_LINE_RESULT());
+                JSON_LINE_RESULT& res = chunk.arrResults.back();
 
-            if(c != ':')
-            {
-                //Wrong format
-                ASSERT(nullptr);
-                _describeError(pJError, i, L("Expected a colon"));
-                return 0;
-            }
-            
-            i++;
+                res.nLine = nLine;
+                res.pJData = new (std::nothrow) JSON_DATA;
+                if(res.pJData)
+                {
+                    res.nRes = CJSON::parseJSON(pStr + i, nEOL - i, *res.pJData, &res.jErr, pCtx->nParseFlags);
+                    res.nOSError = res.nRes < 0 ? CJSON::GetLastError() : NO_ERROR;
 
-            //Go to next non-white-space
-            c = _skipWhiteSpaces(pData, i, nLen);
-            if(!c)
-            {
-                //Reached EOF too early
-                ASSERT(nullptr);
-                _describeError(pJError, i, L("Unexpected EOF"));
-                return 0;
+                    if(res.nRes != 1)
+                    {
+                        //Don't keep what failed to parse
+                        delete res.pJData;
+                        res.pJData = nullptr;
+                    }
+                }
+                else
+                {
+                    res.nRes = -1;
+                    res.nOSError = ERROR_OUTOFMEMORY;
+                }
             }
 
-            //Parse value
-            nR = _parseForValue(joe.val, pData, i, nLen, pJError);
-            if(nR != 1)
+            i = nEOL + 1;
+        }
+
+        if(pCtx->bInOrder)
+        {
+            lock.lock();
+            chunk.bDone = true;
+
+            if(!pCtx->bDelivering)
             {
-                //Error
-                ASSERT(nullptr);
-                _describeError(pJError, i, L("Value parsing failed"));
-                return nR;
-            }
+                //Deliver all chunks that are ready, in order
+                pCtx->bDelivering = true;
 
-            //Add it to the object
-            jo.arrObjElmts.push_back(joe);
+                while(pCtx->nNextToDeliver < pCtx->arrChunks.size() &&
+                    pCtx->arrChunks[pCtx->nNextToDeliver].bDone)
+                {
+                    JSON_LINES_CHUNK& chunkDlv = pCtx->arrChunks[pCtx->nNextToDeliver];
 
-            //Reset comma flag
-            bGotPreviousComma = false;
+                    lock.unlock();
+                    _deliverJSONLinesChunk(pCtx, chunkDlv);
+                    lock.lock();
+
+                    pCtx->nNextToDeliver++;
+                    pCtx->cvDelivered.notify_all();
+                }
+
+                pCtx->bDelivering = false;
+            }
         }
         else
         {
-            //Error
-            ASSERT(nullptr);
-            _describeError(pJError, i, L("Unexpected formatting character"));
-            return 0;
+            {
+                std::lock_guard<std::mutex> lockCbk(pCtx->mtxCallback);
+                _deliverJSONLinesChunk(pCtx, chunk);
+            }
+
+            lock.lock();
         }
     }
 
-//    CJSON::SetLastError(ERROR_INVALID_DATA);
-//	return -1;
+    //Wake up others if we stopped
+    pCtx->cvDelivered.notify_all();
 }
 
 
-int CJSON::_parseForValue(JSON_VALUE& jv, const WCHAR* pData, intptr_t& i, intptr_t nLen, JSON_ERROR* pJError)
+int CJSON::parseJSONLines(LPCTSTR pStr, intptr_t nchLen, JSON_LINE_CALLBACK pfnCallback, void* pCbkParam, UINT nCntThreads, bool bInOrder, UINT nParseFlags)
 {
-    //Parse for value in "name" : "value" JSON pair
-    //'jv' = will be filled out with the value
-    //'pData' = beginning of JSON string to parse
-    //'i' = index of the WCHAR right after ':' in the example above -- it will be updated upon return to point to the char one after last in the "value"
-    //'nLen' = length of 'pData' in TCHARs
+    //Parse JSON Lines (or NDJSON) input, where each line is a separate JSON value, in several threads
+    //INFO: The input is split into chunks of whole lines that are parsed by each thread
+    //INFO: Threads are started on each call. If they can't be started, the calling thread parses what they would have.
+    //'pStr' = JSON Lines input (doesn't need to be null-terminated)
+    //'nchLen' = length of 'pStr' in TCHARs
+    //'pfnCallback' = called for each parsed line (see JSON_LINE_CALLBACK)
+    //'pCbkParam' = parameter to pass to 'pfnCallback'
+    //'nCntThreads' = number of threads to parse with, including the calling thread, or 0 to use one per CPU core
+    //'bInOrder' = true to deliver lines to 'pfnCallback' in the order they appear in 'pStr',
+    //             false to deliver them as soon as they are parsed, which is faster if lines take very different time to parse
+    //'nParseFlags' = one or more of JPF_* values
+    //                 INFO: If JPF_REFERENCE_SOURCE is used, 'pStr' must not change or be freed while parsed data is in use!
     //RETURN:
-    //		= 1 if got it OK, 'i' points to the next WCHAR after the "value"
-    //		= 0 if format error, 'i' may be out of range
-    //		= -1 if other non-JSON related error (such as out of memory, check CJSON::GetLastError() for info)
-    int nR;
+    //		= 1 if all lines were parsed OK
+    //		= 0 if some lines had JSON format errors (they were reported to 'pfnCallback')
+    //		= -1 if other non-JSON related error (such as out of memory, or if 'pfnCallback' returned false)
+    //           INFO: Check CJSON::GetLastError() for more info.
+    if(!pStr ||
+        nchLen < 0 ||
+        !pfnCallback)
+    {
+        CJSON::SetLastError(ERROR_INVALID_PARAMETER);
+        return -1;
+    }
 
-    //Go to next non-white-space
-    if(!_skipWhiteSpaces(pData, i, nLen))
+    if(!nCntThreads)
     {
-        //Reached EOF too early
-        ASSERT(nullptr);
-        _describeError(pJError, i, L("Unexpected EOF"));
-        return 0;
+        nCntThreads = std::thread::hardware_concurrency();
+        if(!nCntThreads)
+            nCntThreads = 1;
     }
 
-    intptr_t i_delta;
-    
-#ifdef _WIN32
-//Windows specific
-    
-    WCHAR c = pData[i];
-    i_delta = 1;
-    
-#elif __APPLE__
-//macOS specific
-    
-    UINT c;
-    i_delta = JSON_NODE::getUtf8Char(pData, i, nLen, &c);
-    if(i_delta <= 0)
+    JSON_LINES_CTX ctx;
+    ctx.pStr = pStr;
+    ctx.nParseFlags = nParseFlags;
+    ctx.bInOrder = bInOrder;
+    ctx.bDirect = false;
+    ctx.pfnCallback = pfnCallback;
+    ctx.pCbkParam = pCbkParam;
+    ctx.nMaxChunksAhead = (size_t)nCntThreads * 4;
+    ctx.nNextChunk = 0;
+    ctx.nNextToDeliver = 0;
+    ctx.bDelivering = false;
+    ctx.bStop = false;
+    ctx.nWorstRes = 1;
+    ctx.nOSError = NO_ERROR;
+
+    //Split input into chunks of whole lines (a few per thread, so that they even out)
+    intptr_t nchChunk = nchLen / ((intptr_t)nCntThreads * 8);
+    if(nchChunk < 0x4000)
+        nchChunk = 0x4000;
+    else if(nchChunk > 0x100000)
+        nchChunk = 0x100000;
+
+    intptr_t nLine = 0;
+    for(intptr_t i = 0; i < nchLen; )
     {
-        //Error
-        ASSERT(nullptr);
-        _describeError(pJError, i, L("Bad UTF-8 sequence"));
-        return 0;
+        JSON_LINES_CHUNK chunk;
+        chunk.nBegin = i;
+        chunk.nFirstLine = nLine;
+        chunk.bDone = false;
+
+        intptr_t nEnd = nchLen - i > nchChunk ? i + nchChunk : nchLen;
+
+        //Count lines in it, and end it after a new-line
+        for(;;)
+        {
+            i = _findNewLine(pStr, i, nchLen);
+            if(i >= nchLen)
+                break;
+
+            nLine++;
+            i++;
+
+            if(i >= nEnd)
+                break;
+        }
+
+        chunk.nEnd = i;
+        ctx.arrChunks.push_back(std::move(chunk));
     }
 
-#endif
+    //Parse in other threads and in this one
+    ctx.bDirect = nCntThreads <= 1 || ctx.arrChunks.size() <= 1;
 
-    //See what type of value is it
-    if(c == '"')
+    std::vector<std::thread> arrThreads;
+    try
     {
-        //Begin quoted value
-        jv.valType = JVT_DOUBLE_QUOTED;
-
-        //Parse it
-        nR = _parseDoubleQuotedString(jv.strValue, pData, i, nLen, pJError);
-        if(nR != 1)
+        for(size_t t = 1; t < nCntThreads && t < ctx.arrChunks.size(); t++)
         {
-            //Failed
-            ASSERT(nullptr);
-            _describeError(pJError, i, L("Quote parsing failed"));
-            return nR;
+            arrThreads.push_back(std::thread(_parseJSONLinesChunks, &ctx));
         }
+    }
+    catch(const std::system_error&)
+    {
+        //Couldn't start a thread, parse with the ones that we have
+        if(arrThreads.empty())
+            ctx.bDirect = true;
+    }
 
+    _parseJSONLinesChunks(&ctx);
+
+    for(size_t t = 0; t < arrThreads.size(); t++)
+    {
+        arrThreads[t].join();
     }
-    else if(_isPlainValueChar(c))
+
+    //Free what wasn't delivered (if stopped)
+    for(size_t c = 0; c < ctx.arrChunks.size(); c++)
     {
-        //Begin plain value
-        jv.valType = JVT_PLAIN;
-        jv.strValue = c;
+        _deliverJSONLinesChunk(&ctx, ctx.arrChunks[c]);
+    }
 
-        //Look for the end
-        for(i += i_delta; ; i += i_delta)
-        {
-            if(i >= nLen)
-            {
-                //Reached EOF, it's OK
-                break;
-            }
+    int nRes = ctx.bStop ? -1 : ctx.nWorstRes.load();
 
-#ifdef _WIN32
-//Windows specific
-    
-            WCHAR z = pData[i];
-            
-#elif __APPLE__
-//macOS specific
-    
-            UINT z;
-            i_delta = JSON_NODE::getUtf8Char(pData, i, nLen, &z);
-            if(i_delta <= 0)
-            {
-                //Error
-                ASSERT(nullptr);
-                _describeError(pJError, i, L("Bad UTF-8 sequence"));
-                return 0;
-            }
-#endif
+    CJSON::SetLastError(nRes < 0 ? ctx.nOSError.load() : NO_ERROR);
+    return nRes;
+}
 
-            if(_isWhiteSpace(z) ||
-                z == ',' ||
-                z == '}' ||
-                z == ']')
-            {
-                //End of value
-                break;
-            }
 
-            //Chars must be formatted correctly
-            ASSERT(_isPlainValueChar(z));
+int CJSON::parseJSONLinesFile(LPCTSTR pStrFilePath, JSON_LINE_CALLBACK pfnCallback, void* pCbkParam, UINT nCntThreads, bool bInOrder, UINT nParseFlags)
+{
+    //Parse JSON Lines (or NDJSON) file, where each line is a separate JSON value, in several threads
+    //INFO: The file is mapped into memory and parsed straight from there, if it doesn't need to be converted (see CJSON::parseJSONFile)
+    //'pStrFilePath' = file path (takes into account BOMs for text file encodings)
+    //'pfnCallback' = called for each parsed line (see JSON_LINE_CALLBACK)
+    //'pCbkParam' = parameter to pass to 'pfnCallback'
+    //'nCntThreads' = number of threads to parse with, including the calling thread, or 0 to use one per CPU core
+    //'bInOrder' = true to deliver lines to 'pfnCallback' in the order they appear in the file
+    //'nParseFlags' = one or more of JPF_* values
+    //                 INFO: JPF_REFERENCE_SOURCE is ignored, since the file is unmapped upon return
+    //RETURN:
+    //		= 1 if all lines were parsed OK
+    //		= 0 if some lines had JSON format errors (they were reported to 'pfnCallback')
+    //		= -1 if other non-JSON related error (such as failure to read the file, or if 'pfnCallback' returned false)
+    //           INFO: Check CJSON::GetLastError() for more info.
+    nParseFlags &= ~JPF_REFERENCE_SOURCE;
+
+    JSON_FILE_MAPPING fileMap;
+    if(!fileMap.open(pStrFilePath))
+        return -1;
+
+    static const BYTE kEmpty[1] = {};
+
+    const BYTE* pData = fileMap.getData() ? fileMap.getData() : kEmpty;
+    size_t ncbDataSz = (size_t)fileMap.getSize();
+
+    int ncbSzBOM;
+    JSON_ENCODING enc = _detectFileEncoding(pData, ncbDataSz, &ncbSzBOM);
+
+    pData += ncbSzBOM;
+    ncbDataSz -= ncbSzBOM;
 
 #ifdef _WIN32
-//Windows specific
-    
-            jv.strValue += z;
-            
-#elif __APPLE__
-//macOS specific
-            
-            if(!JSON_NODE::appendUtf8Char(jv.strValue, z))
-            {
-                //Failed
-                ASSERT(nullptr);
-                _describeError(pJError, i, L("Failed to add UTF-8 character"));
-                return 0;
-            }
+    //Windows specific
+    if(enc == JENC_UNICODE_16 &&
+        ncbDataSz % sizeof(WCHAR) == 0)
+#elif JSON_UTF8
+    //macOS & POSIX specific
+    if(enc == JENC_UTF_8)
 #endif
-        }
-    }
-    else if(c == '[')
     {
-        //Begain array
-        jv.strValue.clear();
+        //Already in the encoding that we need
+        return parseJSONLines((const WCHAR*)pData, ncbDataSz / sizeof(WCHAR), pfnCallback, pCbkParam, nCntThreads, bInOrder, nParseFlags);
+    }
 
-        i += i_delta;
+    //Need to convert it
+    std_wstring str;
+    if(!CJSON::convertStringToUnicode((const char*)pData, ncbDataSz, enc, &str))
+        return -1;
 
-        //Create new array
-        JSON_ARRAY* pJA = new (std::nothrow) JSON_ARRAY;
-        if(!pJA)
-        {
-            //Out of memory
-            ASSERT(nullptr);
-            _describeError(pJError, i, L("Out of memory"));
-            CJSON::SetLastError(ERROR_OUTOFMEMORY);
-            return -1;
-        }
+    //Don't need the file anymore
+    fileMap.close();
 
-        //Parse it
-        nR = _parseForArray(*pJA, pData, i, nLen, pJError);
-        if(nR != 1)
-        {
-            //Error
-            int nErr = CJSON::GetLastError();
-            ASSERT(nullptr);
-            _describeError(pJError, i, L("Array parsing failed"));
+    return parseJSONLines(str.c_str(), str.size(), pfnCallback, pCbkParam, nCntThreads, bInOrder, nParseFlags);
+}
 
-            //Delete it
-            _freeJSON_ARRAY(pJA);
 
-            CJSON::SetLastError(nErr);
-            return nR;
-        }
 
-        //Mark it
-        jv.valType = JVT_ARRAY;
 
-        //Add it then
-        jv.pValue = pJA;
-    }
-    else if(c == '{')
+void JSON_PUSH_PARSER::begin(JSON_DATA& outJEs, JSON_ERROR* pJErr)
+{
+    //Begin parsing a new JSON document
+    //'outJEs' = receives parsed JSON data -- it is emptied here, and should not be used until finish() succeeds
+    //'pJErr' = if not nullptr, will be filled with parsing error details
+    pJData = &outJEs;
+    pJError = pJErr;
+
+    //Clear the data variable
+    outJEs.emptyData();
+
+    ctx = JSON_PARSE_CTX(nullptr, outJEs.getArena(), JPF_NONE);
+
+    nState = PPS_VALUE;
+    nFailRes = 0;
+    arrStack.clear();
+    pSlot = &outJEs.val;
+    strPending.clear();
+    nPendingBase = 0;
+    nTokenScan = -1;
+
+    //Reset last error before we begin
+    CJSON::SetLastError(0);
+}
+
+int JSON_PUSH_PARSER::feed(const WCHAR* pData, intptr_t nchLen)
+{
+    //Parse the next piece of JSON
+    //'pData' = piece of JSON (does not need to be null-terminated) -- it is not needed after this function returns
+    //'nchLen' = length of 'pData' in TCHARs
+    //RETURN:
+    //		= 1 if OK so far (call feed() with the next piece, or finish() if there's no more)
+    //		= 0 if JSON format error
+    //		= -1 if other non-JSON related error (such as out of memory, etc.)
+    //           INFO: Check CJSON::GetLastError() for more info.
+    if(nState == PPS_FAILED)
+        return nFailRes;
+
+    if(nState == PPS_NONE ||
+        nState == PPS_DONE ||
+        nchLen < 0 ||
+        (!pData && nchLen))
     {
-        //Begin object
-        jv.strValue.clear();
+        CJSON::_describeError(pJError, -1, L("Bad input parameter(s)"));
+        CJSON::SetLastError(ERROR_INVALID_PARAMETER);
+        return -1;
+    }
 
-        i += i_delta;
+    intptr_t i = 0;
+    int nRes;
 
-        //Create new object
-        JSON_OBJECT* pJO = new (std::nothrow) JSON_OBJECT;
-        if(!pJO)
+    if(strPending.empty())
+    {
+        //Parse straight from the piece, and keep only what's left of it
+        nRes = _parse(pData, nchLen, nPendingBase, false, i);
+        if(nRes == 1)
         {
-            //Out of memory
-            ASSERT(nullptr);
-            _describeError(pJError, i, L("Out of memory"));
-            CJSON::SetLastError(ERROR_OUTOFMEMORY);
-            return -1;
+            strPending.assign(pData + i, nchLen - i);
+            nPendingBase += i;
         }
+    }
+    else
+    {
+        //Continue with what was left from before
+        strPending.append(pData, nchLen);
 
-        //Parse it
-        nR = _parseForObject(*pJO, pData, i, nLen, pJError);
-        if(nR != 1)
+        nRes = _parse(strPending.data(), strPending.size(), nPendingBase, false, i);
+        if(nRes == 1)
         {
-            //Error
-            int nErr = CJSON::GetLastError();
-            ASSERT(nullptr);
-            _describeError(pJError, i, L("Object parsing failed"));
-
-            //Delete it then
-            _freeJSON_OBJECT(pJO);
-
-            CJSON::SetLastError(nErr);
-            return nR;
+            //INFO: Only the incomplete token at the end is left here
+            strPending.erase(0, i);
+            nPendingBase += i;
         }
+    }
 
-        //Mark it
-        jv.valType = JVT_OBJECT;
+    return nRes;
+}
 
-        //Add it then
-        jv.pValue = pJO;
-    }
-    else
+int JSON_PUSH_PARSER::finish()
+{
+    //Finish parsing after the last piece was passed to feed()
+    //RETURN:
+    //		= 1 if got it OK
+    //		= 0 if JSON format error
+    //		= -1 if other non-JSON related error (such as out of memory, etc.)
+    //           INFO: Check CJSON::GetLastError() for more info.
+    if(nState == PPS_FAILED)
+        return nFailRes;
+
+    if(nState == PPS_NONE ||
+        nState == PPS_DONE)
     {
-        //Error in format
-        ASSERT(nullptr);
-        _describeError(pJError, i, L("Unexpected formatting character"));
-        return 0;
+        CJSON::_describeError(pJError, -1, L("Bad input parameter(s)"));
+        CJSON::SetLastError(ERROR_INVALID_PARAMETER);
+        return -1;
     }
 
-    return 1;
-}
+    intptr_t i = 0;
+    int nRes = _parse(strPending.data(), strPending.size(), nPendingBase, true, i);
+    if(nRes == 1)
+    {
+        //Done
+        ASSERT(nState == PPS_AFTER_ROOT);
+        nState = PPS_DONE;
 
+        strPending.clear();
+    }
 
-bool JSON_DATA::json_toString(JSON_DATA* pJE, JSON_FORMATTING* pJFormat, std_wstring* pOutStr)
-{
-    //Redirect
-    return CJSON::toString(pJE, pJFormat, pOutStr);
+    return nRes;
 }
 
-bool CJSON::toString(JSON_DATA* pJE, JSON_FORMATTING* pJFormat, std_wstring* pOutStr)
+int JSON_PUSH_PARSER::_parse(const WCHAR* pData, intptr_t nLen, intptr_t nBase, bool bFinal, intptr_t& i)
 {
-    //Convert 'pJE' to JSON string
-    //'pJFormat' = if not nullptr, formatting to use for JSON, or nullptr to use defaults
-    //'pOutStr' = if not nullptr, receives formatted JSON (if nullptr, can be used to check correctness of data in 'pJE')
+    //Parse as much of 'pData' as we can
+    //'pData' = JSON to parse
+    //'nLen' = length of 'pData' in TCHARs
+    //'nBase' = index of 'pData[0]' from the beginning of the first piece
+    //'bFinal' = true if no more JSON follows 'pData'
+    //'i' = index of the WCHAR to begin parsing from
+    //		INFO: It will be updated upon return to point to the first char that was not parsed yet (of an incomplete token)
     //RETURN:
-    //		= true if success
-    //		= false if error (check CJSON::GetLastError() for info)
-    bool bRes = false;
-    int nOSError = NO_ERROR;
+    //		= 1 if OK so far
+    //		= 0 if format error
+    //		= -1 if other non-JSON related error (such as out of memory, check CJSON::GetLastError() for info)
+    JSON_ERROR jErr;
+    ctx.pJError = &jErr;
 
-    if(pJE)
+    int nR;
+
+    for(;;)
     {
-        //Do we have a formatting struct
-        JSON_FORMATTING jFmt;
-        if(!pJFormat)
+        //Go to next non-white-space
+        WCHAR c = CJSON::_skipWhiteSpaces(pData, i, nLen);
+        if(!c)
         {
-            //Use defaults
-            pJFormat = &jFmt;
-        }
-
-        //Empty string
-        if(pOutStr)
-            pOutStr->clear();
+            if(!bFinal ||
+                nState == PPS_AFTER_ROOT)
+            {
+                //Need more
+                return 1;
+            }
 
-        //Measure how much data do we need
-        //INFO: We need this to speed up _toString_Value() method!
-        //		If 'pOutStr' == nullptr then:
-        //			0 if success
-        //			-1 if error
-        //		If 'pOutStr' != nullptr then:
-        //			[0 and up) number of TCHARs required for this value
-        //			-1 if error
-        size_t n_res_cnt = _toString_Value(pJE->val, pJFormat, nullptr, 1);
+            //Reached EOF too early
+            ASSERT(nullptr);
+            return _fail(0, nBase + i, L("Unexpected EOF"));
+        }
 
-        if(n_res_cnt != -1)
+        switch(nState)
         {
-            //Only if we have a pointer
-            if(pOutStr)
+        case PPS_VALUE:
             {
-                //And print
-                size_t n_res_cnt2 = _toString_Value(pJE->val, pJFormat, pOutStr, 1);
-                if(n_res_cnt2 != -1)
+                if(c == '[' ||
+                    c == '{')
                 {
-                    //Check that we calculate the size correctly
-                    //INFO: It is OK if we miscalculated it a little bit...
-                    size_t nCntStrChk = pOutStr->size();
-                    ASSERT(nCntStrChk == n_res_cnt);
+                    //Begin array or object
+                    pSlot->strValue.clear();
 
-                    //Done
-                    bRes = true;
+                    i++;
+
+                    void* pValue;
+                    if(c == '[')
+                    {
+                        pValue = CJSON::_newJSON_ARRAY(ctx.pArena);
+                        pSlot->valType = JVT_ARRAY;
+                        nState = PPS_ARRAY_NEXT;
+                    }
+                    else
+                    {
+                        pValue = CJSON::_newJSON_OBJECT(ctx.pArena);
+                        pSlot->valType = JVT_OBJECT;
+                        nState = PPS_OBJECT_NEXT;
+                    }
+
+                    if(!pValue)
+                    {
+                        //Out of memory
+                        ASSERT(nullptr);
+                        pSlot->valType = JVT_NONE;
+                        CJSON::SetLastError(ERROR_OUTOFMEMORY);
+                        return _fail(-1, nBase + i, L("Out of memory"));
+                    }
+
+                    pSlot->pValue = pValue;
+
+                    PP_FRAME frm = {pSlot, true, true};
+                    arrStack.push_back(frm);
+
+                    pSlot = nullptr;
                 }
                 else
                 {
-                    //Error
-                    nOSError = ERROR_BAD_FORMAT;
-                    pOutStr->clear();
+                    //String or plain value (unless it's a bad character), wait until we have all of it
+                    if(!bFinal &&
+                        (c == '"' || (c & ~0x7F) || CJSON::_isPlainValueChar((UINT)c)) &&
+                        !_isTokenComplete(pData, i, nLen, nBase))
+                    {
+                        return 1;
+                    }
+
+                    nR = CJSON::_parseForValue(*pSlot, pData, i, nLen, &ctx);
+                    if(nR != 1)
+                    {
+                        //Error
+                        return _failWith(nR, jErr, nBase);
+                    }
+
+                    _endValue();
                 }
             }
-            else
-            {
-                //Then success
-                bRes = true;
-            }
-        }
-        else
-        {
-            //Failed
-            nOSError = ERROR_BAD_FORMAT;
+            break;
 
-            if(pOutStr)
+        case PPS_ARRAY_NEXT:
+        case PPS_OBJECT_NEXT:
             {
-                //If failed, clear the string
-                pOutStr->clear();
-            }
-        }
-    }
-    else
-        nOSError = ERROR_INVALID_PARAMETER;
-
-    CJSON::SetLastError(nOSError);
-    return bRes;
-}
-
-
-size_t CJSON::_toString_Value(JSON_VALUE& val, JSON_FORMATTING* pJFormat, std_wstring* pOutStr, intptr_t nIndent)
-{
-    //RETURN:
-    //		If 'pOutStr' == nullptr then:
-    //			0 if success
-    //			-1 if error
-    //		If 'pOutStr' != nullptr then:
-    //			[0 and up) number of TCHARs required for this value
-    //			-1 if error
-    size_t nResCount = 0;
-    
-    std_wstring strTabIndent, strTabIndent_1;
-    bool bHumanReadable = pJFormat->bHumanReadable;
-    if(bHumanReadable)
-    {
-        //Prep tab index
-        std_wstring strTab;
-        if(pJFormat->spacesType == JSP_USE_SPACES)
-        {
-            int nNmSps = pJFormat->nSpacesPerTab;
-            if(nNmSps < 1)
-                nNmSps = 1;
-            else if(nNmSps > 64)
-                nNmSps = 64;
+                PP_FRAME& frm = arrStack.back();
+                bool bArray = nState == PPS_ARRAY_NEXT;
 
-            for(int s = 0; s < nNmSps; s++)
-            {
-                strTab += ' ';
-            }
-        }
-        else
-            strTab = '\t';
+                if(c == (bArray ? ']' : '}'))
+                {
+                    //End of array or object
+                    i++;
 
-        for(intptr_t t = 0; t < nIndent - 1; t++)
-        {
-            strTabIndent_1 += strTab;
-        }
+                    arrStack.pop_back();
+                    _endValue();
+                }
+                else if(c == ',')
+                {
+                    //Comma separator between elements (only if not the first element)
+                    if(frm.bFirst ||
+                        frm.bGotPreviousComma)
+                    {
+                        //Error
+                        ASSERT(nullptr);
+                        return _fail(0, nBase + i, L("Unexpected comma"));
+                    }
 
-        strTabIndent = strTabIndent_1 + strTab;
-    }
+                    //Signal that we got it
+                    frm.bFirst = false;
+                    frm.bGotPreviousComma = true;
 
-    switch(val.valType)
-    {
-    case JVT_PLAIN:					// 25, 167.6, 12E40, -12, +12, true, false, null
-        {
-            if(pOutStr)
-                pOutStr->operator +=(val.strValue);
-            else
-                nResCount += val.strValue.size();
-        }
-        break;
+                    i++;
+                }
+                else if(bArray)
+                {
+                    //Make sure that we've got a comma before
+                    if(!frm.bGotPreviousComma)
+                    {
+                        //Error - missing comma
+                        ASSERT(nullptr);
+                        return _fail(0, nBase + i, L("Expected a comma"));
+                    }
 
-    case JVT_DOUBLE_QUOTED:			// "string"
-        {
-            if(pOutStr)
-            {
-                pOutStr->operator +=('"');
-                _escapeDoubleQuotedVal(val.strValue, pJFormat, pOutStr);
-                pOutStr->operator +=('"');
-            }
-            else
-            {
-                nResCount += 2 + _escapeDoubleQuotedVal(val.strValue, pJFormat);
-            }
-        }
-        break;
+                    //Parse the element in place
+                    JSON_ARRAY* pJA = (JSON_ARRAY*)frm.pVal->pValue;
+                    pJA->arrArrElmts.push_back(JSON_ARRAY_ELEMENT());
 
-    case JVT_ARRAY:					// [ val1, val2 ]
-        {
-            if(pOutStr)
-            {
-                pOutStr->operator +=('[');
-            }
-            else
-                nResCount += 1;
+                    frm.bFirst = false;
 
-            JSON_ARRAY* pJA = (JSON_ARRAY*)val.pValue;
-            if(pJA)
-            {
-                intptr_t nCnt = pJA->arrArrElmts.size();
-                for(intptr_t i = 0; i < nCnt; i++)
+                    pSlot = &pJA->arrArrElmts.back().val;
+                    nState = PPS_VALUE;
+                }
+                else if(c == '"')
                 {
-                    //Print each element
-                    size_t n_res_chrsA = _toString_Value(pJA->arrArrElmts[i].val, pJFormat, pOutStr, nIndent);
-                    if(n_res_chrsA != -1)
-                    {
-                        //Add to other value
-                        nResCount += n_res_chrsA;
-                    }
-                    else
+                    //Name
+
+                    //Make sure that we've got a comma before
+                    if(!frm.bGotPreviousComma)
                     {
-                        //Failed
+                        //Error - missing comma
                         ASSERT(nullptr);
-                        nResCount = -1;
-                        break;
+                        return _fail(0, nBase + i, L("Expected a comma"));
                     }
 
-                    if(i + 1 < nCnt)
+                    if(!bFinal &&
+                        !_isTokenComplete(pData, i, nLen, nBase))
                     {
-                        //Add comma
-                        if(pOutStr)
-                            pOutStr->operator +=(',');
-                        else
-                            nResCount += 1;
+                        return 1;
+                    }
 
-                        if(bHumanReadable)
-                        {
-                            if(pOutStr)
-                                pOutStr->operator +=(' ');
-                            else
-                                nResCount += 1;
-                        }
+                    //Parse the element in place
+                    JSON_OBJECT* pJO = (JSON_OBJECT*)frm.pVal->pValue;
+                    pJO->arrObjElmts.push_back(JSON_OBJECT_ELEMENT());
+
+                    JSON_OBJECT_ELEMENT& joe = pJO->arrObjElmts.back();
+
+                    nR = CJSON::_parseDoubleQuotedForData(joe.strName, joe.pNameRef, joe.nchNameRef, pData, i, nLen, &ctx);
+                    if(nR != 1)
+                    {
+                        //Error
+                        return _failWith(nR, jErr, nBase);
                     }
+
+                    frm.bFirst = false;
+
+                    nState = PPS_OBJECT_COLON;
+                }
+                else
+                {
+                    //Error
+                    ASSERT(nullptr);
+                    return _fail(0, nBase + i, L("Unexpected formatting character"));
                 }
             }
-            else
+            break;
+
+        case PPS_OBJECT_COLON:
             {
-                //Error
+                if(c != ':')
+                {
+                    //Wrong format
+                    ASSERT(nullptr);
+                    return _fail(0, nBase + i, L("Expected a colon"));
+                }
+
+                i++;
+
+                //Value goes into the element that we've just added
+                JSON_OBJECT* pJO = (JSON_OBJECT*)arrStack.back().pVal->pValue;
+                pSlot = &pJO->arrObjElmts.back().val;
+                nState = PPS_VALUE;
+            }
+            break;
+
+        case PPS_AFTER_ROOT:
+            {
+                //Something else follows { ... } main root object
                 ASSERT(nullptr);
-                nResCount = -1;
+                return _fail(0, nBase + i, L("Unexpected data after the root node"));
             }
+            break;
 
-            if(pOutStr)
-                pOutStr->operator +=(L']');
-            else
-                nResCount += 1;
+        default:
+            {
+                ASSERT(nullptr);
+                CJSON::SetLastError(ERROR_INVALID_DATA);
+                return _fail(-1, nBase + i, L("Bad execution branch"));
+            }
+            break;
         }
-        break;
+    }
+}
 
-    case JVT_OBJECT:				// { "name1":"value1", "name2" : "value2" }
+bool JSON_PUSH_PARSER::_isTokenComplete(const WCHAR* pData, intptr_t i, intptr_t nLen, intptr_t nBase)
+{
+    //Check if the whole "string" or plain value that begins at 'i' is in 'pData'
+    //'nBase' = index of 'pData[0]' from the beginning of the first piece
+    //INFO: Where it stopped looking is kept in 'nTokenScan' for the next call, so a long token isn't scanned over and over again
+    //RETURN:
+    //		= true if the token can be parsed from 'pData'
+    intptr_t j = nTokenScan >= 0 ? nTokenScan - nBase : i + 1;
+    ASSERT(j > i);
+
+    if(pData[i] == '"')
+    {
+        //Look for the closing quote (or a newline that ends it with an error)
+        for(;;)
         {
-            if(pOutStr)
-                pOutStr->operator +=('{');
-            else
-                nResCount += 1;
+            j = CJSON::_findStringSpecialChar(pData, j, nLen);
+            if(j >= nLen)
+                break;
 
-            JSON_OBJECT* pJO = (JSON_OBJECT*)val.pValue;
-            if(pJO)
+            WCHAR z = pData[j];
+            if(z == '"' ||
+                z == '\n' ||
+                z == '\r')
             {
-                intptr_t nCnt = pJO->arrObjElmts.size();
-                JSON_OBJECT_ELEMENT* pJOEs = pJO->arrObjElmts.data();
-
-                for(intptr_t i = 0; i < nCnt; i++)
+                //INFO: \u escapes right before it may look up to 6 TCHARs ahead, so wait for those as well
+                if(j + 6 < nLen)
                 {
-                    //Element name
-                    if(bHumanReadable &&
-                        i == 0)
-                    {
-                        if(pOutStr)
-                        {
-                            pOutStr->operator +=(pJFormat->strNewLine);
-                            pOutStr->operator +=(strTabIndent);
-                        }
-                        else
-                            nResCount += pJFormat->strNewLine.size() + strTabIndent.size();
-                    }
-
-                    if(pOutStr)
-                    {
-                        CJSON::appendFormat(*pOutStr, 
-                            L("\"%s\":%s"),
-                            pJOEs[i].strName.c_str(),
-                            bHumanReadable ? L(" ") : L("")
-                        );
-                    }
-                    else
-                        nResCount += 1 + pJOEs[i].strName.size() + 1 + 1 + (bHumanReadable ? 1 : 0);
-
-                    //Print value
-                    size_t n_res_chrsO = _toString_Value(pJOEs[i].val, pJFormat, pOutStr, nIndent + 1);
-                    if(n_res_chrsO != -1)
-                    {
-                        //Add to other value
-                        nResCount += n_res_chrsO;
-                    }
-                    else
-                    {
-                        //Failed
-                        ASSERT(nullptr);
-                        nResCount = -1;
-                        break;
-                    }
-
-                    if(i + 1 < nCnt)
-                    {
-                        //Add comma
-                        if(pOutStr)
-                            pOutStr->operator +=(',');
-                        else
-                            nResCount += 1;
-
-                        if(bHumanReadable)
-                        {
-                            if(pOutStr)
-                            {
-                                pOutStr->operator +=(pJFormat->strNewLine);
-                                pOutStr->operator +=(strTabIndent);
-                            }
-                            else
-                                nResCount += pJFormat->strNewLine.size() + strTabIndent.size();
-                        }
-                    }
-                    else if(i + 1 == nCnt &&
-                        bHumanReadable)
-                    {
-                        //Last element
-                        if(pOutStr)
-                        {
-                            pOutStr->operator +=(pJFormat->strNewLine);
-                            pOutStr->operator +=(strTabIndent_1);
-                        }
-                        else
-                            nResCount += pJFormat->strNewLine.size() + strTabIndent_1.size();
-                    }
+                    nTokenScan = -1;
+                    return true;
                 }
+
+                break;
             }
-            else
+            else if(z == '\\')
             {
-                //Error
-                ASSERT(nullptr);
-                nResCount = -1;
-            }
+                //Skip the escaped character
+                if(j + 1 >= nLen)
+                    break;
 
-            if(pOutStr)
-                pOutStr->operator +=(L'}');
+                j += 2;
+            }
             else
-                nResCount += 1;
+                j++;
         }
-        break;
-
-    default:
+    }
+    else
+    {
+        //Plain value ends where CJSON::_parseForValue() ends it
+        for(; j < nLen; j++)
         {
-            //Bad type
-            ASSERT(nullptr);
-            nResCount = -1;
+            WCHAR z = pData[j];
+            if(CJSON::_isWhiteSpace((UINT)z) ||
+                z == ',' ||
+                z == '}' ||
+                z == ']')
+            {
+                nTokenScan = -1;
+                return true;
+            }
         }
-        break;
     }
 
-    return nResCount;
+    nTokenScan = nBase + j;
+    return false;
 }
 
-std_wstring& CJSON::appendFormat(std_wstring& str, LPCTSTR pszFormat, ...)
+void JSON_PUSH_PARSER::_endValue()
 {
-	//Format string the same way as wsprintf() does
-	int nOSError = CJSON::GetLastError();
-
-	va_list args;
-	va_start(args, pszFormat);
-
-    va_list args2;
-    va_copy(args2, args);
+    //Go back to the array or object that contains the value that was just parsed
+    pSlot = nullptr;
 
-#ifdef _WIN32
+    if(arrStack.empty())
+    {
+        nState = PPS_AFTER_ROOT;
+        return;
+    }
 
-    //Windows specific
-	intptr_t nSz = _vscwprintf(pszFormat, args);
+    PP_FRAME& frm = arrStack.back();
 
-#elif __APPLE__
-    //macOS specific
-    intptr_t nSz = vprintf(pszFormat, args);
+    //Reset comma flag
+    frm.bGotPreviousComma = false;
 
-#endif
+    nState = frm.pVal->valType == JVT_ARRAY ? PPS_ARRAY_NEXT : PPS_OBJECT_NEXT;
+}
 
-	if(nSz >= 0)
-    {
-		WCHAR* p_buff = new (std::nothrow) WCHAR[nSz + 1];
-		if(p_buff)
-        {
-			p_buff[0] = 0; 
+int JSON_PUSH_PARSER::_fail(int nRes, intptr_t nIndex, LPCTSTR pErrDesc)
+{
+    //Stop parsing with an error
+    //'nRes' = 0 for format error, or -1 for other error
+    //'nIndex' = index of the error from the beginning of the first piece
+    //RETURN: = 'nRes'
+    CJSON::_describeError(pJError, nIndex, pErrDesc);
 
-#ifdef _WIN32
-            //Windows specific
-			vswprintf_s(p_buff, nSz + 1, pszFormat, args2);
-#elif __APPLE__
-            //macOS specific
-            vsnprintf(p_buff, nSz + 1, pszFormat, args2);
-#endif
-			remove_nulls_from_str(p_buff, (size_t&)nSz);
-			str.append(p_buff, nSz);
+    //Keep the last error, as freeing the data may change it
+    int nErr = CJSON::GetLastError();
 
-			delete[] p_buff;
-		}
-	}
+    pJData->emptyData();
 
-    va_end(args);
-    va_end(args2);
+    arrStack.clear();
+    pSlot = nullptr;
+    strPending.clear();
+    nTokenScan = -1;
 
-    CJSON::SetLastError(nOSError);
+    nState = PPS_FAILED;
+    nFailRes = nRes;
 
-	return str;
+    CJSON::SetLastError(nErr);
+    return nRes;
 }
 
-WCHAR* CJSON::remove_nulls_from_str(WCHAR* p_str, size_t& szch)
+int JSON_PUSH_PARSER::_failWith(int nRes, JSON_ERROR& jErr, intptr_t nBase)
 {
-    //Remove all internal nulls that may be in 'p_str'
-    //'szch' = original size of 'p_str' in WCHARs, without last null. It may be adjusted after this function returns
-    //RETURN:
-    //		= Pointer to 'p_str'
+    //Stop parsing with an error from one of the CJSON parsing functions
+    //'jErr' = error info, with the index in the data that was passed to them
+    //'nBase' = index of that data from the beginning of the first piece
+    //RETURN: = 'nRes'
+    ASSERT(nRes != 1);
+    return _fail(nRes != 1 ? nRes : 0,
+                 !jErr.isEmpty() && jErr.nErrIndex >= 0 ? nBase + jErr.nErrIndex : -1,
+                 jErr.strErrDesc.c_str());
+}
 
-    if(p_str &&
-        szch)
-    {
-        size_t szch0 = szch;
 
-        WCHAR* pE = p_str + szch;
-        for(WCHAR* pS = pE - 1; pS >= p_str; pS--)
-        {
-            if(!*pS)
-            {
-                if(pS + 1 < pE)
-                {
-                    //Remove it
-                    memcpy(pS, pS + 1, (pE - pS - 1) * sizeof(WCHAR));
-                }
 
-                szch--;
-            }
-        }
 
-        //Set last null
-        if(szch < szch0)
-        {
-            //Last null
-            p_str[szch] = 0;
-        }
-    }
+//SIMD level used by the parser, or -1 if not detected yet
+static std::atomic<int> g_nSimdLevel(-1);
 
-    return p_str;
-}
 
+#ifdef JSON_SIMD_X64
+//x86-64 specific
 
-std_wstring& CJSON::lTrim(std_wstring &s)
+static inline UINT _countTrailingZeros(UINT uMask)
 {
-    //Trim all white-spaces from the left side of 's'
-    //RETURN: = Same trimmed string
-    
-#ifdef _WIN32
-    //Windows specific
-    s.erase(s.begin(), std::find_if(s.begin(), s.end(), std::not1(std::ptr_fun<int, int>(std::isspace))));
-    
-#elif __APPLE__
-    //macOS specific
-    s.erase(s.begin(), std::find_if(s.begin(), s.end(), [](int c) {return !std::isspace(c);}));
-
+    //'uMask' = must not be 0
+    //RETURN: = Index of the lowest set bit in 'uMask'
+    ASSERT(uMask);
+#ifdef _MSC_VER
+    unsigned long nIdx;
+    _BitScanForward(&nIdx, uMask);
+    return (UINT)nIdx;
+#else
+    return (UINT)__builtin_ctz(uMask);
 #endif
-    
-    return s;
 }
 
-std_wstring& CJSON::rTrim(std_wstring &s)
+static intptr_t _findStringSpecialChar_SSE2(const WCHAR* pData, intptr_t i, intptr_t nLen)
 {
-    //Trim all white-spaces from the right side of 's'
-    //RETURN: = Same trimmed string
+    //RETURN: = Index of the first special character (see CJSON::_findStringSpecialChar()) on or after 'i',
+    //          or the index where less than 16 bytes remain
+    const intptr_t nchBlock = 16 / sizeof(WCHAR);
 
 #ifdef _WIN32
-    //Windows specific
-    s.erase(std::find_if(s.rbegin(), s.rend(), std::not1(std::ptr_fun<int, int>(std::isspace))).base(), s.end());
+//Windows specific
+    const __m128i vQuote = _mm_set1_epi16('"');
+    const __m128i vBkSlash = _mm_set1_epi16('\\');
+    const __m128i vCtrl = _mm_set1_epi16(0x1F);
+    const __m128i vZero = _mm_setzero_si128();
 
-#elif __APPLE__
-    //macOS specific
-    s.erase(std::find_if(s.rbegin(), s.rend(), [](int c) {return !std::isspace(c);}).base(), s.end());
-    
+    for(; i + nchBlock <= nLen; i += nchBlock)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(pData + i));
+
+        //Characters <= 0x1F turn to 0 after the saturated subtraction
+        __m128i vFnd = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi16(v, vQuote), _mm_cmpeq_epi16(v, vBkSlash)),
+                                    _mm_cmpeq_epi16(_mm_subs_epu16(v, vCtrl), vZero));
+
+        UINT uMask = (UINT)_mm_movemask_epi8(vFnd);
+        if(uMask)
+            return i + _countTrailingZeros(uMask) / sizeof(WCHAR);
+    }
+
+#elif JSON_UTF8
+//macOS & POSIX specific
+    const __m128i vQuote = _mm_set1_epi8('"');
+    const __m128i vBkSlash = _mm_set1_epi8('\\');
+    const __m128i vCtrl = _mm_set1_epi8(0x20);
+
+    for(; i + nchBlock <= nLen; i += nchBlock)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(pData + i));
+
+        //Signed comparison also picks bytes >= 0x80 (that must be checked as UTF-8)
+        __m128i vFnd = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, vQuote), _mm_cmpeq_epi8(v, vBkSlash)),
+                                    _mm_cmplt_epi8(v, vCtrl));
+
+        UINT uMask = (UINT)_mm_movemask_epi8(vFnd);
+        if(uMask)
+            return i + _countTrailingZeros(uMask);
+    }
 #endif
 
-    return s;
+    return i;
 }
 
-std_wstring& CJSON::Trim(std_wstring &s)
+JSON_TARGET_AVX2
+static intptr_t _findStringSpecialChar_AVX2(const WCHAR* pData, intptr_t i, intptr_t nLen)
 {
-    //Trim all white-spaces from 's'
-    //RETURN: = Same trimmed string
-    return lTrim(rTrim(s));
-}
+    //RETURN: = Index of the first special character (see CJSON::_findStringSpecialChar()) on or after 'i',
+    //          or the index where less than 32 bytes remain
+    const intptr_t nchBlock = 32 / sizeof(WCHAR);
 
+#ifdef _WIN32
+//Windows specific
+    const __m256i vQuote = _mm256_set1_epi16('"');
+    const __m256i vBkSlash = _mm256_set1_epi16('\\');
+    const __m256i vCtrl = _mm256_set1_epi16(0x1F);
+    const __m256i vZero = _mm256_setzero_si256();
 
+    for(; i + nchBlock <= nLen; i += nchBlock)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(pData + i));
 
-size_t CJSON::_escapeDoubleQuotedVal(std_wstring& s, JSON_FORMATTING* pJFormat, std_wstring* pOutStr)
-{
-    //'pOutStr' = if specified, will receive escaped string
-    //			= if nullptr, will return length of required string
-    //RETURN:
-    //		= Size of escaped quote in TCHARs if 'pOutStr' == nullptr
-    //		= 0 if 'pOutStr' != nullptr, or if error
-    ASSERT(pJFormat);
-    size_t nResCnt = 0;
-     
-    JSON_ESCAPE_TYPE escTp = pJFormat ? pJFormat->escapeType : JESCT_NO_UNICODE_ESCAPING;
+        //Characters <= 0x1F turn to 0 after the saturated subtraction
+        __m256i vFnd = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi16(v, vQuote), _mm256_cmpeq_epi16(v, vBkSlash)),
+                                       _mm256_cmpeq_epi16(_mm256_subs_epu16(v, vCtrl), vZero));
 
-    ASSERT('\b' == 0x0008);
-    ASSERT('\f' == 0x000C);
-    ASSERT('\n' == 0x000A);
-    ASSERT('\r' == 0x000D);
-    ASSERT('\t' == 0x0009);
+        UINT uMask = (UINT)_mm256_movemask_epi8(vFnd);
+        if(uMask)
+            return i + _countTrailingZeros(uMask) / sizeof(WCHAR);
+    }
 
-    intptr_t i_delta = 1;
-    
-    intptr_t nLn = s.size();
-    LPCTSTR pStr = s.c_str();
+#elif JSON_UTF8
+//macOS & POSIX specific
+    const __m256i vQuote = _mm256_set1_epi8('"');
+    const __m256i vBkSlash = _mm256_set1_epi8('\\');
+    const __m256i vCtrl = _mm256_set1_epi8(0x20);
 
-    for(intptr_t i = 0; i < nLn; i += i_delta)
+    for(; i + nchBlock <= nLen; i += nchBlock)
     {
-#ifdef _WIN32
-//Windows specific
-        WCHAR z = pStr[i];
-        
-#elif __APPLE__
-//macOS specific
-        UINT z;
-        i_delta = JSON_NODE::getUtf8Char(pStr, i, nLn, &z);
-        if(i_delta <= 0)
-        {
-            //Error
-            ASSERT(nullptr);
-            if(pOutStr)
-                pOutStr->clear();
-            
-            return 0;
-        }
-#endif
-        
-        //%x22 /          ; "    quotation mark  U+0022
-        //%x5C /          ; \    reverse solidus U+005C
-        //%x2F /          ; /    solidus         U+002F
-        //%x62 /          ; b    backspace       U+0008
-        //%x66 /          ; f    form feed       U+000C
-        //%x6E /          ; n    line feed       U+000A
-        //%x72 /          ; r    carriage return U+000D
-        //%x74 /          ; t    tab             U+0009
-        //%x75 4HEXDIG )  ; uXXXX                U+XXXX
-        if(z == '"' ||
-            z == '\\' ||
-            z == '/')
-        {
-            if(pOutStr)
-            {
-                pOutStr->operator +=('\\');
-                pOutStr->operator +=((WCHAR)z);
-            }
-            else
-                nResCnt += TSIZEOF(L("\\z"));
-        }
-        else if(z == '\b')
-        {
-            if(pOutStr)
-                pOutStr->operator +=(L("\\b"));
-            else
-                nResCnt += TSIZEOF(L("\\b"));
-        }
-        else if(z == '\f')
-        {
-            if(pOutStr)
-                pOutStr->operator +=(L("\\f"));
-            else
-                nResCnt += TSIZEOF(L("\\f"));
-        }
-        else if(z == '\n')
-        {
-            if(pOutStr)
-                pOutStr->operator +=(L("\\n"));
-            else
-                nResCnt += TSIZEOF(L("\\n"));
-        }
-        else if(z == '\r')
-        {
-            if(pOutStr)
-                pOutStr->operator +=(L("\\r"));
-            else
-                nResCnt += TSIZEOF(L("\\r"));
-        }
-        else if(z == '\t')
-        {
-            if(pOutStr)
-                pOutStr->operator +=(L("\\t"));
-            else
-                nResCnt += TSIZEOF(L("\\t"));
-        }
-        else if(z == 0)
-        {
-            //nullptr if it's there for some reason
-            if(pOutStr)
-                pOutStr->operator +=(L("\\0"));
-            else
-                nResCnt += TSIZEOF(L("\\0"));
-        }
-        else
-        {
-            //Do we need to do the escaping?
-            bool bEscIt;
-
-#ifdef _WIN32
-            //Windows specific
-            bEscIt = (z >= 0x80 && escTp == JESCT_ESCAPE_CHARS_AFTER_0x80) ||
-                     (z >= 0x100 && escTp == JESCT_ESCAPE_CHARS_AFTER_0x100);
-            
-#elif __APPLE__
-            //macOS specific
-            //INFO: We can't escape UTF-8 characters larger than 2 bytes!
-            bEscIt = (z >= 0x80 && z <= 0xffff && escTp == JESCT_ESCAPE_CHARS_AFTER_0x80) ||
-                     (z >= 0x100 && z <= 0xffff && escTp == JESCT_ESCAPE_CHARS_AFTER_0x100);
-#endif
-            
-            if(bEscIt)
-            {
-                //Escape Unicode
-                ASSERT(z >= 0 && z <= 0xffff);
+        __m256i v = _mm256_loadu_si256((const __m256i*)(pData + i));
 
-                if(pOutStr)
-                {
-                    CJSON::appendFormat(*pOutStr, L("\\u%04x"), z);
-                }
-                else
-                    nResCnt += TSIZEOF(L("\\u0000"));
-            }
-            else
-            {
-                //Just add it as-is
-#ifdef _WIN32
-                //Windows specific
-                if(pOutStr)
-                    pOutStr->operator +=(z);
-                else
-                    nResCnt += TSIZEOF(L("z"));
-                
-#elif __APPLE__
-                //macOS specific
-                if(pOutStr)
-                {
-                    if(!JSON_NODE::appendUtf8Char(*pOutStr, z))
-                    {
-                        //Error
-                        ASSERT(nullptr);
-                        if(pOutStr)
-                            pOutStr->clear();
-                        
-                        return 0;
-                    }
-                }
-                else
-                    nResCnt += i_delta;
+        //Signed comparison also picks bytes >= 0x80 (that must be checked as UTF-8)
+        __m256i vFnd = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, vQuote), _mm256_cmpeq_epi8(v, vBkSlash)),
+                                       _mm256_cmpgt_epi8(vCtrl, v));
 
-#endif
-            }
-        }
+        UINT uMask = (UINT)_mm256_movemask_epi8(vFnd);
+        if(uMask)
+            return i + _countTrailingZeros(uMask);
     }
+#endif
 
-    return nResCnt;
+    return i;
 }
 
-void CJSON::_freeJSON_ARRAY(JSON_ARRAY* pJA)
+static intptr_t _skipWhiteSpaceRun_SSE2(const WCHAR* pData, intptr_t i, intptr_t nLen)
 {
-    //INFO: When this method returns 'pJA' will be no longer valid!
-    if(pJA)
+    //RETURN: = Index of the first non-white-space character on or after 'i',
+    //          or the index where less than 16 bytes remain
+    const intptr_t nchBlock = 16 / sizeof(WCHAR);
+
+#ifdef _WIN32
+//Windows specific
+    const __m128i vSpace = _mm_set1_epi16(' ');
+    const __m128i vTab = _mm_set1_epi16('\t');
+    const __m128i vLF = _mm_set1_epi16('\n');
+    const __m128i vCR = _mm_set1_epi16('\r');
+
+    for(; i + nchBlock <= nLen; i += nchBlock)
     {
-        for(intptr_t i = 0; i < (intptr_t)pJA->arrArrElmts.size(); i++)
-        {
-            //Free its children first
-            _freeJSON_VALUE(pJA->arrArrElmts[i].val);
-        }
+        __m128i v = _mm_loadu_si128((const __m128i*)(pData + i));
+        __m128i vWS = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi16(v, vSpace), _mm_cmpeq_epi16(v, vTab)),
+                                   _mm_or_si128(_mm_cmpeq_epi16(v, vLF), _mm_cmpeq_epi16(v, vCR)));
 
-        //Then free the array
-        delete pJA;
+        UINT uMask = ~(UINT)_mm_movemask_epi8(vWS) & 0xFFFF;
+        if(uMask)
+            return i + _countTrailingZeros(uMask) / sizeof(WCHAR);
     }
-}
 
-void CJSON::_freeJSON_OBJECT(JSON_OBJECT* pJO)
-{
-    //INFO: When this method returns 'pJO' will be no longer valid!
-    if(pJO)
+#elif JSON_UTF8
+//macOS & POSIX specific
+    const __m128i vSpace = _mm_set1_epi8(' ');
+    const __m128i vTab = _mm_set1_epi8('\t');
+    const __m128i vLF = _mm_set1_epi8('\n');
+    const __m128i vCR = _mm_set1_epi8('\r');
+
+    for(; i + nchBlock <= nLen; i += nchBlock)
     {
-        for(intptr_t i = 0; i < (intptr_t)pJO->arrObjElmts.size(); i++)
-        {
-            //Free its children first
-            _freeJSON_VALUE(pJO->arrObjElmts[i].val);
-        }
+        __m128i v = _mm_loadu_si128((const __m128i*)(pData + i));
+        __m128i vWS = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, vSpace), _mm_cmpeq_epi8(v, vTab)),
+                                   _mm_or_si128(_mm_cmpeq_epi8(v, vLF), _mm_cmpeq_epi8(v, vCR)));
 
-        //Then free the object
-        delete pJO;
+        UINT uMask = ~(UINT)_mm_movemask_epi8(vWS) & 0xFFFF;
+        if(uMask)
+            return i + _countTrailingZeros(uMask);
     }
-}
+#endif
 
-void JSON_DATA::_freeJSON_VALUE(JSON_VALUE& val)
-{
-    //Redirect
-    CJSON::_freeJSON_VALUE(val);
-}
-void JSON_NODE::_freeJSON_VALUE(JSON_VALUE& val)
-{
-    //Redirect
-    CJSON::_freeJSON_VALUE(val);
+    return i;
 }
 
-void CJSON::_freeJSON_VALUE(JSON_VALUE& val)
+JSON_TARGET_AVX2
+static intptr_t _skipWhiteSpaceRun_AVX2(const WCHAR* pData, intptr_t i, intptr_t nLen)
 {
-    switch(val.valType)
+    //RETURN: = Index of the first non-white-space character on or after 'i',
+    //          or the index where less than 32 bytes remain
+    const intptr_t nchBlock = 32 / sizeof(WCHAR);
+
+#ifdef _WIN32
+//Windows specific
+    const __m256i vSpace = _mm256_set1_epi16(' ');
+    const __m256i vTab = _mm256_set1_epi16('\t');
+    const __m256i vLF = _mm256_set1_epi16('\n');
+    const __m256i vCR = _mm256_set1_epi16('\r');
+
+    for(; i + nchBlock <= nLen; i += nchBlock)
     {
-    case JVT_ARRAY:
-        {
-            JSON_ARRAY* pJA = (JSON_ARRAY*)val.pValue;
-            ASSERT(pJA);
-            _freeJSON_ARRAY(pJA);
-        }
-        break;
+        __m256i v = _mm256_loadu_si256((const __m256i*)(pData + i));
+        __m256i vWS = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi16(v, vSpace), _mm256_cmpeq_epi16(v, vTab)),
+                                      _mm256_or_si256(_mm256_cmpeq_epi16(v, vLF), _mm256_cmpeq_epi16(v, vCR)));
 
-    case JVT_OBJECT:
-        {
-            JSON_OBJECT* pJO = (JSON_OBJECT*)val.pValue;
-            ASSERT(pJO);
-            _freeJSON_OBJECT(pJO);
-        }
-        break;
-            
-    default:
-        break;
+        UINT uMask = ~(UINT)_mm256_movemask_epi8(vWS);
+        if(uMask)
+            return i + _countTrailingZeros(uMask) / sizeof(WCHAR);
     }
-}
 
+#elif JSON_UTF8
+//macOS & POSIX specific
+    const __m256i vSpace = _mm256_set1_epi8(' ');
+    const __m256i vTab = _mm256_set1_epi8('\t');
+    const __m256i vLF = _mm256_set1_epi8('\n');
+    const __m256i vCR = _mm256_set1_epi8('\r');
 
-void CJSON::_describeError(JSON_ERROR* pJError, intptr_t i, LPCTSTR pErrDesc)
-{
-    //Adds error description to 'pJError' if it's not there already
-    //INFO: In other words, it keeps only the first error info
-    if(pJError)
+    for(; i + nchBlock <= nLen; i += nchBlock)
     {
-        if(pJError->isEmpty())
-        {
-            pJError->nErrIndex = i;
-            pJError->strErrDesc = pErrDesc ? pErrDesc : L("");
-            pJError->markFilled();
-        }
-    }
-}
+        __m256i v = _mm256_loadu_si256((const __m256i*)(pData + i));
+        __m256i vWS = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, vSpace), _mm256_cmpeq_epi8(v, vTab)),
+                                      _mm256_or_si256(_mm256_cmpeq_epi8(v, vLF), _mm256_cmpeq_epi8(v, vCR)));
 
+        UINT uMask = ~(UINT)_mm256_movemask_epi8(vWS);
+        if(uMask)
+            return i + _countTrailingZeros(uMask);
+    }
+#endif
 
-bool JSON_NODE::parseFloat(LPCTSTR pStr, double* pfOutVal)
-{
-    //Redirect
-    return CJSON::parseFloat(pStr, pfOutVal);
+    return i;
 }
 
-bool CJSON::parseFloat(LPCTSTR pStr, double* pfOutVal)
-{
-    //Parse float value from 'pStr' presented in local format
-    //'pfOutVal' = if not nullptr, receives value parsed
-    //RETURN:
-    //		= true if success
-    bool bRes = false;
+#endif
 
-    double fVal = 0.0;
 
-    WCHAR* pp = nullptr;
 
-#ifdef _WIN32
-    //Windows specific
-    fVal = _tcstod(pStr, &pp);
-    
-#elif __APPLE__
-    //macOS specific
-    fVal = strtod(pStr, &pp);
-    
+JSON_SIMD_LEVEL CJSON::_detectSimdLevel()
+{
+    //RETURN: = Best SIMD level supported by this CPU (and OS)
+#ifdef JSON_SIMD_X64
+//x86-64 specific
+
+#ifdef _MSC_VER
+    int nRegs[4];
+    __cpuid(nRegs, 0);
+    if(nRegs[0] >= 7)
+    {
+        //Need OSXSAVE and AVX, with the OS saving YMM registers
+        __cpuid(nRegs, 1);
+        if((nRegs[2] & (1 << 27)) &&
+            (nRegs[2] & (1 << 28)) &&
+            (_xgetbv(0) & 0x6) == 0x6)
+        {
+            __cpuidex(nRegs, 7, 0);
+            if(nRegs[1] & (1 << 5))
+                return JSIMD_AVX2;
+        }
+    }
+#else
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2"))
+        return JSIMD_AVX2;
 #endif
-    
-    //Did we succeed?
-    bRes = pp && *pp == 0;
 
-    if(pfOutVal)
-        *pfOutVal = fVal;
+    //SSE2 is always there on x86-64
+    return JSIMD_SSE2;
 
-    return bRes;
+#else
+    return JSIMD_NONE;
+#endif
 }
 
-
-bool CJSON::isFloatingPointNumberString(LPCTSTR pStr)
+JSON_SIMD_LEVEL CJSON::getSimdLevel()
 {
-    //Checks if 'pStr' contains an floating point number
-    //RETURN:
-    //		= true if yes
-    return parseFloat(pStr);
+    //RETURN: = SIMD level currently used by the parser
+    int nLevel = g_nSimdLevel.load(std::memory_order_relaxed);
+    if(nLevel < 0)
+    {
+        nLevel = _detectSimdLevel();
+        g_nSimdLevel.store(nLevel, std::memory_order_relaxed);
+    }
+
+    return (JSON_SIMD_LEVEL)nLevel;
 }
 
-bool JSON_NODE::isIntegerBase10String(LPCTSTR pStr)
+JSON_SIMD_LEVEL CJSON::setSimdLevel(JSON_SIMD_LEVEL level)
 {
-    //Redirect
-    return CJSON::isIntegerBase10String(pStr);
+    //Change the SIMD level used by the parser (mostly to compare performance)
+    //INFO: By default the best level supported by the CPU is used
+    //'level' = level to use -- it will be lowered if the CPU does not support it
+    //RETURN: = Level that was set
+    JSON_SIMD_LEVEL levelMax = _detectSimdLevel();
+    if(level > levelMax)
+        level = levelMax;
+
+    g_nSimdLevel.store(level, std::memory_order_relaxed);
+
+    return level;
 }
 
-bool CJSON::isIntegerBase10String(LPCTSTR pStr)
+WCHAR CJSON::_skipWhiteSpaces(const WCHAR* pData, intptr_t& i, intptr_t nLen)
 {
-    //Checks if 'pStr' contains an integer
+    //Update 'i' to point to the next non-white space WCHAR
+    //'pData' = beginning of JSON string to parse
+    //'i' = index of the WCHAR to begin skipping white spaces from
+    //		INFO: It will be updated upon return to point to the first non-space char on or after original 'i'
+    //'nLen' = length of 'pData' in TCHARs
     //RETURN:
-    //		= true if yes
-    bool bRes = false;
+    //		= Non-0 for the next non-white-space WCHAR on or after 'i' (and 'i' will point to this non-white-space char in 'pData')
+    //		= 0 if end-of-data is reached (and 'i' is out of scope)
+    if(i < nLen &&
+        !_isWhiteSpace(pData[i]))
+    {
+        //Most of the time there's nothing to skip
+        ASSERT(pData[i]);
+        return pData[i];
+    }
 
-    if(pStr &&
-        pStr[0])
+#ifdef JSON_SIMD_X64
+//x86-64 specific
+
+    //Skip long runs (such as indentation) in blocks
+    switch(getSimdLevel())
     {
-        //Assume yes
-        bRes = true;
+    case JSIMD_AVX2:
+        i = _skipWhiteSpaceRun_AVX2(pData, i, nLen);
+        break;
+    case JSIMD_SSE2:
+        i = _skipWhiteSpaceRun_SSE2(pData, i, nLen);
+        break;
+    default:
+        break;
+    }
+#endif
 
-        intptr_t nLn = STRLEN(pStr);
-        for(intptr_t i = 0; i < nLn; i++)
-        {
-            WCHAR z = pStr[i];
+    for(; i < nLen; i++)
+    {
+        WCHAR z = pData[i];
+        ASSERT(z);
+        if(_isWhiteSpace(z))
+            continue;
 
-            //For first char only
-            if(i == 0)
-            {
-                if(z == '+' ||
-                    z == '-')
-                {
-                    //Good char
-                    continue;
-                }
-            }
+        return z;
+    }
 
-            if(z >= '0' &&
-                z <= '9')
-            {
-                //Good char
-                continue;
-            }
+    //End of file
+    return 0;
+}
 
-            //Bad char
-            bRes = false;
+intptr_t CJSON::_findStringSpecialChar(const WCHAR* pData, intptr_t i, intptr_t nLen)
+{
+    //Find the next character in a "string" that can't be simply copied: '"', '\', control characters,
+    //and (for UTF-8) bytes of non-ASCII characters that must be validated
+    //'pData' = beginning of JSON string to parse
+    //'i' = index of the WCHAR to begin looking from
+    //'nLen' = length of 'pData' in TCHARs
+    //RETURN:
+    //		= Index of the special character on or after 'i'
+    //		= 'nLen' if none was found
+#ifdef JSON_SIMD_X64
+//x86-64 specific
+    switch(getSimdLevel())
+    {
+    case JSIMD_AVX2:
+        i = _findStringSpecialChar_AVX2(pData, i, nLen);
+        break;
+    case JSIMD_SSE2:
+        i = _findStringSpecialChar_SSE2(pData, i, nLen);
+        break;
+    default:
+        break;
+    }
+#endif
+
+#ifdef JSON_UTF8
+//macOS & POSIX specific
+
+    //Check 8 bytes at a time for: bytes < 0x20 or >= 0x80, and '"' or '\\'
+    for(; i + (intptr_t)sizeof(uint64_t) <= nLen; i += sizeof(uint64_t))
+    {
+        uint64_t uiWord;
+        memcpy(&uiWord, pData + i, sizeof(uiWord));
+
+        const uint64_t kOnes = 0x0101010101010101ULL;
+        const uint64_t kHighs = 0x8080808080808080ULL;
+
+        uint64_t uiQuote = uiWord ^ (kOnes * '"');
+        uint64_t uiBkSlash = uiWord ^ (kOnes * '\\');
+
+        if(((uiWord - kOnes * 0x20) |
+            ((uiQuote - kOnes) & ~uiQuote) |
+            ((uiBkSlash - kOnes) & ~uiBkSlash) |
+            uiWord) & kHighs)
+        {
+            //Find which byte below
             break;
         }
     }
+#endif
 
-    return bRes;
+    for(; i < nLen; i++)
+    {
+#ifdef _WIN32
+//Windows specific
+        WCHAR z = pData[i];
+        if(z == '"' ||
+            z == '\\' ||
+            z < 0x20)
+        {
+            return i;
+        }
+
+#elif JSON_UTF8
+//macOS & POSIX specific
+        BYTE z = (BYTE)pData[i];
+        if(z == '"' ||
+            z == '\\' ||
+            z < 0x20 ||
+            z >= 0x80)
+        {
+            return i;
+        }
+#endif
+    }
+
+    return nLen;
 }
 
 
 
-JSON_NODE_TYPE CJSON::_determineNodeTypeSafe(JSON_VALUE* pVal)
+//Values of hex digits for ASCII characters, or 0xFF if not a hex digit
+static const BYTE g_hexDigitVals[0x80] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0,    1,    2,    3,    4,    5,    6,    7,    8,    9,    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 10,   11,   12,   13,   14,   15,   0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 10,   11,   12,   13,   14,   15,   0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+bool CJSON::_parseHex4(const WCHAR* pHex, UINT* pOutVal)
 {
+    //Convert exactly 4 hex digits into a value
+    //'pHex' = points to 4 characters to convert (must be readable)
+    //'pOutVal' = receives the value [0 - 0xFFFF], or 0 if error
     //RETURN:
-    //		= Type of node by 'pVal', or
-    //		  INFO: Cannot be JNT_ERROR or JNT_NONE, uses JNT_STRING instead
-    JSON_NODE_TYPE type = _determineNodeType(pVal);
-    if(type == JNT_ERROR ||
-        type == JNT_NONE)
+    //		= true if all 4 characters were hex digits
+    UINT uVal = 0;
+    UINT uBad = 0;
+
+    for(int d = 0; d < 4; d++)
     {
-        //Use default value
-        ASSERT(nullptr);
-        type = JNT_STRING;
+#ifdef _WIN32
+//Windows specific
+        UINT z = pHex[d];
+#elif JSON_UTF8
+//macOS & POSIX specific
+        UINT z = (BYTE)pHex[d];
+#endif
+
+        //Anything past ASCII is not a digit either
+        UINT uDigit = g_hexDigitVals[z & 0x7F] | (z >= 0x80 ? 0xFF : 0);
+
+        uBad |= uDigit;
+        uVal = (uVal << 4) | (uDigit & 0xF);
     }
 
-    return type;
-}
+    bool bRes = (uBad & 0xF0) == 0;
 
-JSON_NODE_TYPE JSON_NODE::_determineNodeType(JSON_VALUE* pVal)
-{
-    //Redirect
-    return CJSON::_determineNodeType(pVal);
+    if(pOutVal)
+        *pOutVal = bRes ? uVal : 0;
+
+    return bRes;
 }
 
-JSON_NODE_TYPE CJSON::_determineNodeType(JSON_VALUE* pVal)
+
+int CJSON::_skipPlainValue(const WCHAR* pData, intptr_t& i, intptr_t nLen, intptr_t i_delta, JSON_ERROR* pJError)
 {
+    //Go to the end of a plain value, such as: 25, -1.5e3, true, null
+    //'pData' = beginning of JSON string to parse
+    //'i' = index of the first char of the value -- it will be updated upon return to point to the char one after the last one in the value
+    //'nLen' = length of 'pData' in TCHARs
+    //'i_delta' = size of the first char in TCHARs
+    //'pJError' = if not nullptr, receives error details
     //RETURN:
-    //		= Type of node by 'pVal', or
-    //		= JNT_ERROR if error
-    if(pVal)
+    //		= 1 if got it OK
+    //		= 0 if format error
+    for(i += i_delta; ; i += i_delta)
     {
-        if(pVal->valType == JVT_ARRAY)
-            return JNT_ARRAY;
-        else if(pVal->valType == JVT_OBJECT)
-            return JNT_OBJECT;
-        else if(pVal->valType == JVT_NONE)
-            return JNT_NONE;
-        else if(pVal->valType == JVT_DOUBLE_QUOTED)
+        if(i >= nLen)
         {
-            //Just a string
-            return JNT_STRING;
+            //Reached EOF, it's OK
+            break;
         }
-        else if(pVal->valType == JVT_PLAIN)
+
+#ifdef _WIN32
+//Windows specific
+    
+        WCHAR z = pData[i];
+        
+#elif JSON_UTF8
+//macOS & POSIX specific
+    
+        UINT z = (BYTE)pData[i];
+        if(z < 0x80)
         {
-            //Check special cases
-            //if(pVal->strValue.Compare(L"null") == 0)
-            if(json::JSON_NODE::compareStringsEqual(pVal->strValue, L("null"), true))
-                return JNT_NULL;
-            //else if(pVal->strValue.Compare(L"true") == 0 ||
-            //	pVal->strValue.Compare(L"false") == 0)
-            else if(json::JSON_NODE::compareStringsEqual(pVal->strValue, L("true"), true) ||
-                json::JSON_NODE::compareStringsEqual(pVal->strValue, L("false"), true))
-                return JNT_BOOLEAN;
-
-            //See if it's an integer or a floating point number
-            if(isIntegerBase10String(pVal->strValue.c_str()))
-                return JNT_INTEGER;
-            else if(isFloatingPointNumberString(pVal->strValue.c_str()))
-                return JNT_FLOAT;
-            else
+            //ASCII needs no decoding
+            i_delta = 1;
+        }
+        else
+        {
+            i_delta = JSON_NODE::getUtf8Char(pData, i, nLen, &z);
+            if(i_delta <= 0)
             {
-                //Else just a string
-                return JNT_STRING;
+                //Error
+                ASSERT(nullptr);
+                _describeError(pJError, i, L("Bad UTF-8 sequence"));
+                return 0;
             }
         }
+#endif
+
+        if(_isWhiteSpace(z) ||
+            z == ',' ||
+            z == '}' ||
+            z == ']')
+        {
+            //End of value
+            break;
+        }
+
+        //Chars must be formatted correctly
+        ASSERT(_isPlainValueChar(z));
     }
 
-    return JNT_ERROR;
+    return 1;
 }
 
 
-JSON_NODE_TYPE JSON_NODE::findNodeByIndex(intptr_t nIndex, JSON_NODE* pJNodeFound)
+
+int CJSON::parseJSONWithHandler(LPCTSTR pStr, JSON_SAX_HANDLER& handler, JSON_ERROR* pJError)
 {
-    //Look for the node in this node with the 'nIndex'
-    //INFO: This node must be an object or array node
-    //'nIndex' = node zero-based index (use JSON_NODE::getNodeCount() to get number of nodes)
-    //'pJNodeFound' = if not nullptr, receives the data for the node found
+    //Parse 'pStr' as JSON without building JSON_DATA, by sending what's in it to 'handler'
+    //INFO: It follows the same rules and gives the same errors as CJSON::parseJSON(), but doesn't allocate objects or arrays.
+    //'handler' = receives events as 'pStr' is parsed
+    //'pJError' = if not nullptr, will be filled with parsing error details
     //RETURN:
-    //		= Node type if found, or
-    //		= JNT_ERROR if error in search parameters
-    JSON_NODE_TYPE resType = JNT_ERROR;
-
-    if(isNodeSet())
+    //		= 1 if got it OK
+    //		= 0 if JSON format error
+    //		= -1 if other non-JSON related error (such as out of memory, etc.)
+    //           INFO: Check CJSON::GetLastError() for more info. It will be ERROR_CANCELLED if 'handler' returned JSAX_ABORT.
+    if(!pStr)
     {
-        ASSERT(pVal);
-        if(pVal)
-        {
-            //Check node type
-            if(pVal->valType == JVT_OBJECT)
-            {
-                JSON_OBJECT* pJO = (JSON_OBJECT*)pVal->pValue;
-                ASSERT(pJO);
-                if(pJO)
-                {
-                    if(nIndex >= 0 &&
-                        nIndex < (intptr_t)pJO->arrObjElmts.size())
-                    {
-                        //Got it
-                        JSON_OBJECT_ELEMENT* pJOE = &pJO->arrObjElmts[nIndex];
+        _describeError(pJError, -1, L("Bad input parameter(s)"));
+        CJSON::SetLastError(ERROR_INVALID_PARAMETER);
+        return -1;
+    }
 
-                        //Type
-                        resType = CJSON::_determineNodeTypeSafe(&pJOE->val);
-                        ASSERT(resType != JNT_NONE && resType != JNT_ERROR);
+    //INFO: Strings without escapes are passed to 'handler' straight from 'pStr'
+    JSON_PARSE_CTX ctx(pJError, nullptr, JPF_REFERENCE_SOURCE, &handler);
 
-                        if(pJNodeFound)
-                        {
-                            pJNodeFound->typeNode = resType;
-                            pJNodeFound->strName = pJOE->strName;
-                            pJNodeFound->pVal = &pJOE->val;
+    return _saxParse(pStr, STRLEN(pStr), &ctx);
+}
 
-                            pJNodeFound->pJSONData = pJSONData;
-                        }
-                    }
-                }
-            }
-            else if(pVal->valType == JVT_ARRAY)
-            {
-                JSON_ARRAY* pJA = (JSON_ARRAY*)pVal->pValue;
-                ASSERT(pJA);
-                if(pJA)
-                {
-                    if(nIndex >= 0 &&
-                        nIndex < (intptr_t)pJA->arrArrElmts.size())
-                    {
-                        //Got it
-                        JSON_ARRAY_ELEMENT* pJAE = &pJA->arrArrElmts[nIndex];
 
-                        //Type
-                        resType = CJSON::_determineNodeTypeSafe(&pJAE->val);
-                        ASSERT(resType != JNT_NONE && resType != JNT_ERROR);
+int CJSON::_saxParse(const WCHAR* pData, intptr_t nLen, JSON_PARSE_CTX* pCtx)
+{
+    //Parse 'pData' as JSON and send what's in it to the handler in 'pCtx'
+    //'nLen' = length of 'pData' in TCHARs
+    //RETURN:
+    //		= 1 if got it OK
+    //		= 0 if JSON format error
+    //		= -1 if other non-JSON related error (check CJSON::GetLastError() for info)
+    int nRes;
 
-                        if(pJNodeFound)
-                        {
-                            pJNodeFound->typeNode = resType;
-                            pJNodeFound->strName.clear();
-                            pJNodeFound->pVal = &pJAE->val;
+    //Begin
+    intptr_t i = 0;
 
-                            pJNodeFound->pJSONData = pJSONData;
-                        }
-                    }
-                }
+    //Reset last error before we begin
+    CJSON::SetLastError(0);
+
+    //Go to next non-white-space
+    WCHAR c = _skipWhiteSpaces(pData, i, nLen);
+    if(c)
+    {
+        //Begin from the root object
+        nRes = _saxParseForValue(pData, i, nLen, pCtx, false);
+        if(nRes == 1)
+        {
+            //Skip to the end
+            if(_skipWhiteSpaces(pData, i, nLen) != 0)
+            {
+                //Something else follows { ... } main root object
+                ASSERT(nullptr);
+                _describeError(pCtx->pJError, i, L("Unexpected data after the root node"));
+                nRes = 0;
             }
         }
     }
+    else
+    {
+        //Error
+        ASSERT(nullptr);
+        _describeError(pCtx->pJError, i, L("Unexpected EOF"));
+        nRes = 0;
+    }
 
-    return resType;
+    return nRes;
 }
 
 
-JSON_NODE_TYPE JSON_NODE::findNodeByName(LPCTSTR pStrName, JSON_NODE* pJNodeFound, bool bCaseSensitive, JSON_SRCH* pJSrch)
+int CJSON::_saxResult(JSON_SAX_ACTION action, intptr_t i, JSON_PARSE_CTX* pCtx)
 {
-    //Look for the next node in this node with the name 'pStrName'
-    //INFO: Can be called repeatedly if 'JSON_SRCH' is used
-    //INFO: This node must be an object node only
-    //'pStrName' = node (or element) name to look for (cannot be ""!)
-    //'pJNodeFound' = if not nullptr, receives the data for the node found
-    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
-    //'pJSrch' = if not nullptr, must be used for repeated searches for the same node name (keep calling this method while it succeeds in finding)
+    //Check what a JSON_SAX_HANDLER method returned
+    //'i' = index in JSON that it was called for
     //RETURN:
-    //		= Node type if found, or
-    //		= JNT_NONE if nothing was found, or
-    //		= JNT_ERROR if error in search parameters
-    JSON_NODE_TYPE resType = JNT_ERROR;
-
-    if(isNodeSet() &&
-        pStrName &&
-        pStrName[0])
+    //		= 1 to continue
+    //		= 2 to skip
+    //		= -1 to abort
+    switch(action)
     {
-        ASSERT(pVal);
-        if(pVal)
-        {
-            //Only if it's an object
-            if(pVal->valType == JVT_OBJECT)
-            {
-                JSON_OBJECT* pJO = (JSON_OBJECT*)pVal->pValue;
-                if(pJO)
-                {
-                    //Assume nothing was found
-                    resType = JNT_NONE;
-
-                    intptr_t nCntJOs = (intptr_t)pJO->arrObjElmts.size();
-                    JSON_OBJECT_ELEMENT* pJOEs = pJO->arrObjElmts.data();
+        case JSAX_CONTINUE:
+            return 1;
+        case JSAX_SKIP:
+            return 2;
+        default:
+            break;
+    }
 
-                    intptr_t nFndInd = -1;
-                    intptr_t nLnStrName = STRLEN(pStrName);
+    _describeError(pCtx->pJError, i, L("Aborted by the handler"));
+    CJSON::SetLastError(ERROR_CANCELLED);
+    return -1;
+}
 
-                    if(bCaseSensitive)
-                    {
-                        //Case sensitive search
-                        for(intptr_t i = pJSrch ? pJSrch->nIndex : 0; i < nCntJOs; i++)
-                        {
-                            if(nLnStrName == pJOEs[i].strName.size() &&
-                                memcmp(pJOEs[i].strName.c_str(), pStrName, nLnStrName * sizeof(WCHAR)) == 0)
-                            {
-                                //Matched
-                                nFndInd = i;
-                                break;
-                            }
-                        }
-                    }
-                    else
-                    {
-                        //Case insensitive search
-                        for(intptr_t i = pJSrch ? pJSrch->nIndex : 0; i < nCntJOs; i++)
-                        {
-                            if(JSON_NODE::compareStringsEqual(pJOEs[i].strName.c_str(),
-                                                              pJOEs[i].strName.size(),
-                                                              pStrName,
-                                                              nLnStrName,
-                                                              false))
-                            {
-                                //Matched
-                                nFndInd = i;
-                                break;
-                            }
-                        }
-                    }
 
-                    //Did we find it?
-                    if(nFndInd >= 0 &&
-                        nFndInd < nCntJOs)
-                    {
-                        //Determine node type
-                        resType = CJSON::_determineNodeTypeSafe(&pJOEs[nFndInd].val);
-                        ASSERT(resType != JNT_NONE && resType != JNT_ERROR);
+int CJSON::_saxPlainValue(const WCHAR* pStr, intptr_t nchLen, intptr_t i, JSON_PARSE_CTX* pCtx)
+{
+    //Send plain value to the handler
+    //'pStr' = plain value (not null-terminated), 'nchLen' = its length in TCHARs
+    //'i' = index of the value in JSON
+    //RETURN:
+    //		= 1 to continue
+    //		= -1 to abort
+    JSON_SAX_HANDLER* pHandler = pCtx->pHandler;
 
-                        //Do we need to return it?
-                        if(pJNodeFound)
-                        {
-                            //Fill out the node found
-                            pJNodeFound->typeNode = resType;
-                            pJNodeFound->strName = pJOEs[nFndInd].strName;
-                            pJNodeFound->pVal = &pJOEs[nFndInd].val;
+    //Use the same rules as for parsed nodes
+    JSON_VALUE jv;
+    jv.valType = JVT_PLAIN;
+    jv.pStrRef = pStr;
+    jv.nchStrRef = nchLen;
 
-                            pJNodeFound->pJSONData = pJSONData;
-                        }
+    JSON_SAX_ACTION action;
 
-                        //Did we have a search struct?
-                        if(pJSrch)
-                        {
-                            //Update index for the next search
-                            pJSrch->nIndex = nFndInd + 1;
-                        }
-                    }
-                }
-            }
-        }
+    JSON_NODE_TYPE type = _determineNodeTypeSafe(&jv);
+    switch(type)
+    {
+        case JNT_NULL:
+            action = pHandler->onNull();
+            break;
+        case JNT_BOOLEAN:
+            action = pHandler->onBoolean(JSON_NODE::compareStringsEqual(pStr, nchLen, L("true"), -1, true));
+            break;
+        case JNT_INTEGER:
+        case JNT_FLOAT:
+            action = pHandler->onNumber(pStr, nchLen, type);
+            break;
+        default:
+            action = pHandler->onString(pStr, nchLen);
+            break;
     }
 
-    return resType;
+    return _saxResult(action, i, pCtx) < 0 ? -1 : 1;
 }
 
 
-JSON_NODE_TYPE JSON_NODE::findNodeByNameAndGetValueAsString(LPCTSTR pStrName, std_wstring* pOutStr, bool bCaseSensitive)
+int CJSON::_saxParseForArray(const WCHAR* pData, intptr_t& i, intptr_t nLen, JSON_PARSE_CTX* pCtx, bool bSkip)
 {
-    //Look for the first node in this node with the name 'pStrName'
-    //INFO: This node must be an object node only
-    //INFO: In case of more than one node matching the search, only the first one is retrieved
-    //'pStrName' = node (or element) name to look for (cannot be ""!)
-    //'pOutStr' = if not nullptr, receives the found node value
-    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
+    //Parse for array and send its elements to the handler
+    //'pData' = beginning of JSON string to parse
+    //'i' = index of the WCHAR to begin parsing from (may be space) -- must be the char right after the opening '['
+    //		INFO: It will be updated upon return to point to the char one after the last one in the array, i.e. ']'
+    //'nLen' = length of 'pData' in TCHARs
+    //'pCtx' = parsing context (error info and the handler)
+    //'bSkip' = true to only check the array without sending anything to the handler
     //RETURN:
-    //		= Node type if found, or
-    //		= JNT_NONE if nothing was found, or
-    //		= JNT_ERROR if error in search parameters, or retrieval
-    JSON_NODE jsnNd;
-    JSON_NODE_TYPE type = findNodeByName(pStrName, &jsnNd);
-    if(type > JNT_NONE)
+    //		= 1 if got it OK, 'i' points to the next WCHAR after the value
+    //		= 0 if format error, 'i' may be out of range
+    //		= -1 if other non-JSON related error (such as if the handler aborted, check CJSON::GetLastError() for info)
+    JSON_ERROR* pJError = pCtx->pJError;
+    int nR;
+
+    bool bGotPreviousComma = true;
+
+    for(intptr_t cnt = 0;; cnt++)
     {
-        //Read as string
-        if(!jsnNd.getValueAsString(pOutStr))
+        //Go to next non-white-space
+        WCHAR c = _skipWhiteSpaces(pData, i, nLen);
+        if(!c)
         {
-            //Failed
+            //Reached EOF too early
             ASSERT(nullptr);
-            type = JNT_ERROR;
+            _describeError(pJError, i, L("Unexpected EOF"));
+            return 0;
         }
-    }
-
-    return type;
-}
 
-JSON_NODE_TYPE JSON_NODE::findNodeByNameAndGetValueAsInt32(LPCTSTR pStrName, int* pOuVal, bool bCaseSensitive)
-{
-    //Look for the first node in this node with the name 'pStrName'
-    //INFO: This node must be an object node only
-    //INFO: In case of more than one node matching the search, only the first one is retrieved
-    //'pStrName' = node (or element) name to look for (cannot be ""!)
-    //'pOuVal' = if not nullptr, receives the found node value
-    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
-    //RETURN:
-    //        = Node type if found, or
-    //        = JNT_NONE if nothing was found, or
-    //        = JNT_ERROR if error in search parameters, or retrieval
-    JSON_NODE jsnNd;
-    JSON_NODE_TYPE type = findNodeByName(pStrName, &jsnNd);
-    if(type > JNT_NONE)
-    {
-        //Read as string
-        if(!jsnNd.getValueAsInt32(pOuVal))
+        if(c == ']')
         {
-            //Failed
-            ASSERT(nullptr);
-            type = JNT_ERROR;
+            //End of array
+            if(!bSkip &&
+                _saxResult(pCtx->pHandler->onEndArray(), i, pCtx) < 0)
+            {
+                return -1;
+            }
+
+            i++;
+
+            return 1;
         }
-    }
+        else if(c == ',')
+        {
+            //Comma separator between elements (only if not the first element)
+            if(cnt == 0 ||
+                bGotPreviousComma)
+            {
+                //Error
+                ASSERT(nullptr);
+                _describeError(pJError, i, L("Unexpected comma"));
+                return 0;
+            }
 
-    return type;
-}
+            //Signal that we got it
+            bGotPreviousComma = true;
 
-JSON_NODE_TYPE JSON_NODE::findNodeByNameAndGetValueAsInt64(LPCTSTR pStrName, int64_t* pOuVal, bool bCaseSensitive)
-{
-    //Look for the first node in this node with the name 'pStrName'
-    //INFO: This node must be an object node only
-    //INFO: In case of more than one node matching the search, only the first one is retrieved
-    //'pStrName' = node (or element) name to look for (cannot be ""!)
-    //'pOuVal' = if not nullptr, receives the found node value
-    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
-    //RETURN:
-    //        = Node type if found, or
-    //        = JNT_NONE if nothing was found, or
-    //        = JNT_ERROR if error in search parameters, or retrieval
-    JSON_NODE jsnNd;
-    JSON_NODE_TYPE type = findNodeByName(pStrName, &jsnNd);
-    if(type > JNT_NONE)
-    {
-        //Read as string
-        if(!jsnNd.getValueAsInt64(pOuVal))
+            //Otherwise skip it
+            i++;
+            continue;
+        }
+
+        //Make sure that we've got a comma before
+        if(!bGotPreviousComma)
         {
-            //Failed
+            //Error - missing comma
             ASSERT(nullptr);
-            type = JNT_ERROR;
+            _describeError(pJError, i, L("Expected a comma"));
+            return 0;
         }
-    }
-
-    return type;
-}
 
-JSON_NODE_TYPE JSON_NODE::findNodeByNameAndGetValueAsBool(LPCTSTR pStrName, bool* pOuVal, bool bCaseSensitive)
-{
-    //Look for the first node in this node with the name 'pStrName'
-    //INFO: This node must be an object node only
-    //INFO: In case of more than one node matching the search, only the first one is retrieved
-    //'pStrName' = node (or element) name to look for (cannot be ""!)
-    //'pOuVal' = if not nullptr, receives the found node value
-    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
-    //RETURN:
-    //        = Node type if found, or
-    //        = JNT_NONE if nothing was found, or
-    //        = JNT_ERROR if error in search parameters, or retrieval
-    JSON_NODE jsnNd;
-    JSON_NODE_TYPE type = findNodeByName(pStrName, &jsnNd);
-    if(type > JNT_NONE)
-    {
-        //Read as string
-        if(!jsnNd.getValueAsBool(pOuVal))
+        //Parse value
+        nR = _saxParseForValue(pData, i, nLen, pCtx, bSkip);
+        if(nR != 1)
         {
-            //Failed
-            ASSERT(nullptr);
-            type = JNT_ERROR;
+            //Error
+            _describeError(pJError, i, L("Value parsing failed"));
+            return nR;
         }
-    }
 
-    return type;
+        //Reset comma flag
+        bGotPreviousComma = false;
+    }
 }
 
 
-JSON_NODE_TYPE JSON_NODE::findNodeByIndexAndGetValueAsString(intptr_t nIndex, std_wstring* pOutStr)
+int CJSON::_saxParseForObject(const WCHAR* pData, intptr_t& i, intptr_t nLen, JSON_PARSE_CTX* pCtx, bool bSkip)
 {
-    //Look for the node in this node with the 'nIndex'
-    //INFO: This node must be an object or array node
-    //'nIndex' = node zero-based index (use JSON_NODE::getNodeCount() to get number of nodes)
-    //'pOutStr' = if not nullptr, receives the found node value
+    //Parse for object and send its names and values to the handler
+    //'pData' = beginning of JSON string to parse
+    //'i' = index of the WCHAR to begin parsing from (may be space) -- must be the char right after the opening '{'
+    //		INFO: It will be updated upon return to point to the char one after the last one in the object, i.e. '}'
+    //'nLen' = length of 'pData' in TCHARs
+    //'pCtx' = parsing context (error info and the handler)
+    //'bSkip' = true to only check the object without sending anything to the handler
     //RETURN:
-    //		= Node type if found, or
-    //		= JNT_ERROR if error in search parameters
-    JSON_NODE jsnNd;
-    JSON_NODE_TYPE type = this->findNodeByIndex(nIndex, &jsnNd);
-    if(type > JNT_NONE)
+    //		= 1 if got it OK, 'i' points to the next WCHAR after the object
+    //		= 0 if format error, 'i' may be out of range
+    //		= -1 if other non-JSON related error (such as if the handler aborted, check CJSON::GetLastError() for info)
+    JSON_ERROR* pJError = pCtx->pJError;
+    int nR;
+
+    bool bGotPreviousComma = true;
+
+    for(intptr_t cnt = 0;; cnt++)
     {
-        //Read as string
-        if(!jsnNd.getValueAsString(pOutStr))
+        //Go to next non-white-space
+        WCHAR c = _skipWhiteSpaces(pData, i, nLen);
+        if(!c)
         {
-            //Failed
+            //Reached EOF too early
             ASSERT(nullptr);
-            type = JNT_ERROR;
+            _describeError(pJError, i, L("Unexpected EOF"));
+            return 0;
         }
-    }
 
-    return type;
-}
+        if(c == '}')
+        {
+            //End of object
+            if(!bSkip &&
+                _saxResult(pCtx->pHandler->onEndObject(), i, pCtx) < 0)
+            {
+                return -1;
+            }
 
+            i++;
 
-bool JSON_NODE::setAsRootNode(JSON_DATA* pJSON_Data)
-{
-    //Set this node as a root node
-    //INFO: This will erase all data from this node
-    //INFO: Can be called on the node that is not set yet, or on a previous root node only
-    //'pJSON_Data' = JSON data holder, or nullptr to reuse existing data holder (if one was previously present)
-    //RETURN:
-    //		= true if success
-    bool bRes = false;
+            return 1;
+        }
+        else if(c == ',')
+        {
+            //Comma separator between elements (only if not the first element)
+            if(cnt == 0 ||
+                bGotPreviousComma)
+            {
+                //Error
+                ASSERT(nullptr);
+                _describeError(pJError, i, L("Unexpected comma"));
+                return 0;
+            }
 
-    //Is it OK to change it
-    bool bOKToSetIt = true;
+            //Signal that we got it
+            bGotPreviousComma = true;
 
-    //Is this node set?
-    bool bNodeIsSet = this->isNodeSet();
-    if(bNodeIsSet)
-    {
-        if(this->typeNode != JNT_ROOT)
-        {
-            //Can't make it a root node
-            bOKToSetIt = false;
+            //Otherwise skip it
+            i++;
+            continue;
         }
-    }
+        else if(c == '"')
+        {
+            //Name
 
-    if(bOKToSetIt)
-    {
-        //Pick JSON data
-        if(!pJSON_Data)
-            pJSON_Data = pJSONData;
+            //Make sure that we've got a comma before
+            if(!bGotPreviousComma)
+            {
+                //Error - missing comma
+                ASSERT(nullptr);
+                _describeError(pJError, i, L("Expected a comma"));
+                return 0;
+            }
 
-        ASSERT(pJSON_Data);
-        if(pJSON_Data)
-        {
-            //First create an empty object
-            JSON_OBJECT* pJO = new (std::nothrow) JSON_OBJECT;
-            if(pJO)
+            intptr_t iName = i;
+
+            //Parse name
+            const WCHAR* pNameRef;
+            intptr_t nchNameRef;
+            nR = _parseDoubleQuotedString(pCtx->strBuff, pNameRef, nchNameRef, pData, i, nLen, pCtx);
+            if(nR != 1)
             {
-                //Was it set?
-                if(bNodeIsSet)
-                {
-                    //Delete its data first
-                    ASSERT(pVal);
-                    _freeJSON_VALUE(*pVal);
+                //Error
+                ASSERT(nullptr);
+                _describeError(pJError, i, L("Quote parsing failed"));
+                return nR;
+            }
 
-                    pVal = nullptr;
-                }
+            bool bSkipValue = bSkip;
+            if(!bSkip)
+            {
+                nR = _saxResult(pNameRef ? pCtx->pHandler->onName(pNameRef, nchNameRef) :
+                                    pCtx->pHandler->onName(pCtx->strBuff.c_str(), pCtx->strBuff.size()),
+                                iName, pCtx);
+                if(nR < 0)
+                    return nR;
 
-                //Remember JSON data
-                pJSONData = pJSON_Data;
+                bSkipValue = nR == 2;
+            }
+            
+            //Go to next non-white-space
+            c = _skipWhiteSpaces(pData, i, nLen);
+            if(!c)
+            {
+                //Reached EOF too early
+                ASSERT(nullptr);
+                _describeError(pJError, i, L("Unexpected EOF"));
+                return 0;
+            }
 
-                //Set root data
-                pJSON_Data->val.strValue.clear();
-                pJSON_Data->val.valType = JVT_OBJECT;
-                pJSON_Data->val.pValue = pJO;
+            if(c != ':')
+            {
+                //Wrong format
+                ASSERT(nullptr);
+                _describeError(pJError, i, L("Expected a colon"));
+                return 0;
+            }
+            
+            i++;
 
-                //Set it as an empty object
-                this->strName.clear();
-                this->typeNode = JNT_ROOT;
-                this->pVal = &pJSON_Data->val;
+            //Go to next non-white-space
+            c = _skipWhiteSpaces(pData, i, nLen);
+            if(!c)
+            {
+                //Reached EOF too early
+                ASSERT(nullptr);
+                _describeError(pJError, i, L("Unexpected EOF"));
+                return 0;
+            }
 
-                //Done
-                bRes = true;
+            //Parse value
+            nR = _saxParseForValue(pData, i, nLen, pCtx, bSkipValue);
+            if(nR != 1)
+            {
+                //Error
+                _describeError(pJError, i, L("Value parsing failed"));
+                return nR;
             }
+
+            //Reset comma flag
+            bGotPreviousComma = false;
+        }
+        else
+        {
+            //Error
+            ASSERT(nullptr);
+            _describeError(pJError, i, L("Unexpected formatting character"));
+            return 0;
         }
     }
-
-    return bRes;
 }
 
 
-bool JSON_NODE::setAsEmptyNode(JSON_DATA* pJSON_Data, JSON_NODE_TYPE type)
+int CJSON::_saxParseForValue(const WCHAR* pData, intptr_t& i, intptr_t nLen, JSON_PARSE_CTX* pCtx, bool bSkip)
 {
-    //Set this node as a empty node
-    //INFO: This will erase all data from this node
-    //INFO: Can be called on the node that is not set yet, or on a previously used node
-    //'pJSON_Data' = JSON data holder, or nullptr to reuse existing data holder (if one was previously present)
-    //'type' = type of node to set, can be: JNT_OBJECT or JNT_ARRAY
+    //Parse for value and send it to the handler
+    //'pData' = beginning of JSON string to parse
+    //'i' = index of the first WCHAR of the value -- it will be updated upon return to point to the char one after last in the value
+    //'nLen' = length of 'pData' in TCHARs
+    //'pCtx' = parsing context (error info and the handler)
+    //'bSkip' = true to only check the value without sending anything to the handler
     //RETURN:
-    //		= true if success
-    bool bRes = false;
+    //		= 1 if got it OK, 'i' points to the next WCHAR after the value
+    //		= 0 if format error, 'i' may be out of range
+    //		= -1 if other non-JSON related error (such as if the handler aborted, check CJSON::GetLastError() for info)
+    JSON_ERROR* pJError = pCtx->pJError;
+    JSON_SAX_HANDLER* pHandler = pCtx->pHandler;
+    int nR;
 
-    //Pick JSON data
-    if(!pJSON_Data)
-        pJSON_Data = pJSONData;
+    //Go to next non-white-space
+    if(!_skipWhiteSpaces(pData, i, nLen))
+    {
+        //Reached EOF too early
+        ASSERT(nullptr);
+        _describeError(pJError, i, L("Unexpected EOF"));
+        return 0;
+    }
 
-    ASSERT(pJSON_Data);
-    if(pJSON_Data)
+    intptr_t i_delta;
+    
+#ifdef _WIN32
+//Windows specific
+    
+    WCHAR c = pData[i];
+    i_delta = 1;
+    
+#elif JSON_UTF8
+//macOS & POSIX specific
+    
+    UINT c;
+    i_delta = JSON_NODE::getUtf8Char(pData, i, nLen, &c);
+    if(i_delta <= 0)
     {
-        //Create new element
-        if(type == JNT_OBJECT)
-        {
-            JSON_OBJECT* pJO = new (std::nothrow) JSON_OBJECT;
-            ASSERT(pJO);
-            if(pJO)
-            {
-                //Was node set?
-                if(isNodeSet())
-                {
-                    //Delete its data first
-                    ASSERT(pVal);
-                    _freeJSON_VALUE(*pVal);
+        //Error
+        ASSERT(nullptr);
+        _describeError(pJError, i, L("Bad UTF-8 sequence"));
+        return 0;
+    }
 
-                    pVal = nullptr;
-                }
+#endif
 
-                //Remember JSON data
-                pJSONData = pJSON_Data;
+    intptr_t iStart = i;
 
-                //Set root data
-                pJSON_Data->val.strValue.clear();
-                pJSON_Data->val.valType = JVT_OBJECT;
-                pJSON_Data->val.pValue = pJO;
+    //See what type of value is it
+    if(c == '"')
+    {
+        //Quoted value
+        const WCHAR* pStrRef;
+        intptr_t nchStrRef;
+        nR = _parseDoubleQuotedString(pCtx->strBuff, pStrRef, nchStrRef, pData, i, nLen, pCtx);
+        if(nR != 1)
+        {
+            //Failed
+            ASSERT(nullptr);
+            _describeError(pJError, i, L("Quote parsing failed"));
+            return nR;
+        }
 
-                //Set it as an empty object
-                this->strName.clear();
-                this->typeNode = JNT_OBJECT;
-                this->pVal = &pJSON_Data->val;
+        if(!bSkip &&
+            _saxResult(pStrRef ? pHandler->onString(pStrRef, nchStrRef) :
+                           pHandler->onString(pCtx->strBuff.c_str(), pCtx->strBuff.size()),
+                       iStart, pCtx) < 0)
+        {
+            return -1;
+        }
+    }
+    else if(_isPlainValueChar(c))
+    {
+        //Plain value
+        nR = _skipPlainValue(pData, i, nLen, i_delta, pJError);
+        if(nR != 1)
+            return nR;
 
-                //Done
-                bRes = true;
-            }
+        if(!bSkip &&
+            _saxPlainValue(pData + iStart, i - iStart, iStart, pCtx) < 0)
+        {
+            return -1;
         }
-        else if(type == JNT_ARRAY)
+    }
+    else if(c == '[' ||
+        c == '{')
+    {
+        //Array or object
+        bool bSkipIt = bSkip;
+        if(!bSkip)
         {
-            JSON_ARRAY* pJA = new (std::nothrow) JSON_ARRAY;
-            ASSERT(pJA);
-            if(pJA)
-            {
-                //Was node set?
-                if(isNodeSet())
-                {
-                    //Delete its data first
-                    ASSERT(pVal);
-                    _freeJSON_VALUE(*pVal);
-
-                    pVal = nullptr;
-                }
-
-                //Remember JSON data
-                pJSONData = pJSON_Data;
-
-                //Set root data
-                pJSON_Data->val.strValue.clear();
-                pJSON_Data->val.valType = JVT_ARRAY;
-                pJSON_Data->val.pValue = pJA;
-
-                //Set it as an empty object
-                this->strName.clear();
-                this->typeNode = JNT_ARRAY;
-                this->pVal = &pJSON_Data->val;
+            nR = _saxResult(c == '[' ? pHandler->onStartArray() : pHandler->onStartObject(), iStart, pCtx);
+            if(nR < 0)
+                return nR;
 
-                //Done
-                bRes = true;
-            }
+            bSkipIt = nR == 2;
         }
 
-    }
+        i += i_delta;
 
-    return bRes;
+        //Parse it
+        nR = c == '[' ? _saxParseForArray(pData, i, nLen, pCtx, bSkipIt) : _saxParseForObject(pData, i, nLen, pCtx, bSkipIt);
+        if(nR != 1)
+        {
+            //Error
+            _describeError(pJError, i, c == '[' ? L("Array parsing failed") : L("Object parsing failed"));
+            return nR;
+        }
+    }
+    else
+    {
+        //Error in format
+        ASSERT(nullptr);
+        _describeError(pJError, i, L("Unexpected formatting character"));
+        return 0;
+    }
+
+    return 1;
 }
 
 
 
-bool CJSON::_deepCopyJSON_VALUE(JSON_VALUE* pDestV, JSON_VALUE* pSrcV)
+int CJSON::_parseDoubleQuotedString(std_wstring& str, const WCHAR*& pStrRef, intptr_t& nchStrRef, const WCHAR* pData, intptr_t& i, intptr_t nLen, JSON_PARSE_CTX* pCtx)
 {
-    //Copy 'pSrcV' into 'pDestV' by erasing previous values in 'pDestV'
+    //Parse double quoted string into 'str'
+    //'pStrRef' = receives pointer to the string in 'pData' if it has no escapes and JPF_REFERENCE_SOURCE was used ('str' is left empty then), or nullptr otherwise
+    //'nchStrRef' = receives the length of 'pStrRef' in TCHARs
+    //'pData' = beginning of JSON string to parse
+    //'i' = index of the '"' WCHAR to begin parsing the "string" from
+    //		INFO: It will be updated upon return to point to the char one after the last one in the "string"
+    //'nLen' = length of 'pData' in TCHARs
+    //'pCtx' = parsing context (error info and where to allocate from)
     //RETURN:
-    //		= true if success
-    bool bRes = false;
+    //		= 1 if got it OK, 'i' points to the next WCHAR after the "string"
+    //		= 0 if format error, 'i' may be out of range
+    //		= -1 if other non-JSON related error (such as out of memory, check CJSON::GetLastError() for info)
+    JSON_ERROR* pJError = pCtx->pJError;
 
-    if(pDestV &&
-        pSrcV)
+    //Clear the string
+    str.clear();
+    pStrRef = nullptr;
+    nchStrRef = 0;
+
+    intptr_t i_delta = 1;
+    
+    //Most strings have no escapes, so first look for the end of the run of characters that can be taken as-is
+    intptr_t iStart = ++i;
+    for(;; i += i_delta)
     {
-        //First erase the dest
-        if(!pDestV->isEmptyValue())
+        //Skip to the next character that needs a closer look
+        i = _findStringSpecialChar(pData, i, nLen);
+
+        if(i >= nLen)
         {
-            CJSON::_freeJSON_VALUE(*pDestV);
+            //Reached EOF
+            ASSERT(nullptr);
+            _describeError(pJError, i, L("Unexpected EOF"));
+            return 0;
+        }
 
-            pDestV->pValue = nullptr;
-            pDestV->valType = JVT_NONE;
-            pDestV->strValue.clear();
+#ifdef _WIN32
+//Windows specific
+        WCHAR z = pData[i];
+        
+#elif JSON_UTF8
+//macOS & POSIX specific
+        
+        UINT z;
+        i_delta = JSON_NODE::getUtf8Char(pData, i, nLen, &z);
+        if(i_delta <= 0)
+        {
+            //Error
+            ASSERT(nullptr);
+            _describeError(pJError, i, L("Bad UTF-8 sequence"));
+            return 0;
         }
+#endif
 
-        //Then begin copying
-        bRes = __copySingleVal(pDestV, pSrcV);
-    }
+        if(z == '"')
+        {
+            //End of string reached without escapes
+            if(pCtx->nFlags & JPF_REFERENCE_SOURCE)
+            {
+                pStrRef = pData + iStart;
+                nchStrRef = i - iStart;
+            }
+            else
+                str.assign(pData + iStart, i - iStart);
 
-    return bRes;
-}
+            i += i_delta;
 
-bool CJSON::__copySingleVal(JSON_VALUE* pDestV, JSON_VALUE* pSrcV)
-{
-    bool bRes = false;
-    ASSERT(pDestV);
-    ASSERT(pSrcV);
+            return 1;
+        }
+        else if(z == '\\')
+        {
+            //Need to unescape it
+            break;
+        }
+        else if(z == '\n' || z == '\r')
+        {
+            //Error in formatting
+            ASSERT(nullptr);
+            _describeError(pJError, i, L("Newline in quote"));
+            return 0;
+        }
+    }
 
-    switch(pSrcV->valType)
+    //Take what we have so far, and unescape the rest
+    str.assign(pData + iStart, i - iStart);
+
+    //Fill out string
+    for(;; i += i_delta)
     {
-    case JVT_NONE:
-    case JVT_PLAIN:
-    case JVT_DOUBLE_QUOTED:
+        //Copy characters in between escapes as-is
+        intptr_t iRun = _findStringSpecialChar(pData, i, nLen);
+        if(iRun > i)
         {
-            pDestV->valType = pSrcV->valType;
-            pDestV->strValue = pSrcV->strValue;
-            pDestV->pValue = nullptr;
+            str.append(pData + i, iRun - i);
+            i = iRun;
+        }
 
-            bRes = true;
+        if(i >= nLen)
+        {
+            //Reached EOF
+            ASSERT(nullptr);
+            _describeError(pJError, i, L("Unexpected EOF"));
+            return 0;
         }
-        break;
 
-    case JVT_ARRAY:
+#ifdef _WIN32
+//Windows specific
+        WCHAR z = pData[i];
+        
+#elif JSON_UTF8
+//macOS & POSIX specific
+        
+        UINT z;
+        i_delta = JSON_NODE::getUtf8Char(pData, i, nLen, &z);
+        if(i_delta <= 0)
         {
-            pDestV->valType = pSrcV->valType;
-            pDestV->strValue = pSrcV->strValue;
-            pDestV->pValue = nullptr;
+            //Error
+            ASSERT(nullptr);
+            _describeError(pJError, i, L("Bad UTF-8 sequence"));
+            return 0;
+        }
+#endif
+        
+        if(z == '"')
+        {
+            //End of string reached
+            i += i_delta;
 
-            JSON_ARRAY* pSrcJA = (JSON_ARRAY*)pSrcV->pValue;
-            ASSERT(pSrcJA);
-            if(pSrcJA)
+            return 1;
+        }
+        else if(z == '\n' || z == '\r')
+        {
+            //Error in formatting
+            ASSERT(nullptr);
+            _describeError(pJError, i, L("Newline in quote"));
+            return 0;
+        }
+        else if(z == '\\')
+        {
+            //Escaping, get next char
+            i += i_delta;
+            
+            if(i >= nLen)
             {
-                JSON_ARRAY* pDestJA = new (std::nothrow) JSON_ARRAY;
-                ASSERT(pDestJA);
-                if(pDestJA)
+                //Error
+                ASSERT(nullptr);
+                _describeError(pJError, i, L("Unexpected EOF"));
+                return 0;
+            }
+
+            //Get next char, look for special cases
+            //%x22 /          ; "    quotation mark  U+0022
+            //%x5C /          ; \    reverse solidus U+005C
+            //%x2F /          ; /    solidus         U+002F
+            //%x62 /          ; b    backspace       U+0008
+            //%x66 /          ; f    form feed       U+000C
+            //%x6E /          ; n    line feed       U+000A
+            //%x72 /          ; r    carriage return U+000D
+            //%x74 /          ; t    tab             U+0009
+            //%x75 4HEXDIG )  ; uXXXX                U+XXXX
+            ASSERT('\b' == 0x0008);
+            ASSERT('\f' == 0x000C);
+            ASSERT('\n' == 0x000A);
+            ASSERT('\r' == 0x000D);
+            ASSERT('\t' == 0x0009);
+
+            z = pData[i];
+            if(z == '"' ||
+                z == '\\' ||
+                z == '/')
+            {
+                //Keep it as is
+            }
+            else if(z == 'b')
+            {
+                z = '\b';
+            }
+            else if(z == 'f')
+            {
+                z = '\f';
+            }
+            else if(z == 'n')
+            {
+                z = '\n';
+            }
+            else if(z == 'r')
+            {
+                z = '\r';
+            }
+            else if(z == 't')
+            {
+                z = '\t';
+            }
+            else if(z == 'u')
+            {
+                //\u005C, or a surrogate pair, such as: \uD834\uDD1E
+                intptr_t iEsc = i - 1;
+
+                if(i + 4 >= nLen)
                 {
-                    //Assume success
-                    bRes = true;
+                    //Error
+                    ASSERT(nullptr);
+                    _describeError(pJError, i, L("Unexpected EOF"));
+                    return 0;
+                }
 
-                    for(intptr_t i = 0; i < (intptr_t)pSrcJA->arrArrElmts.size(); i++)
-                    {
-                        JSON_ARRAY_ELEMENT jae;
-                        if(__copySingleVal(&jae.val, &pSrcJA->arrArrElmts[i].val))
-                        {
-                            pDestJA->arrArrElmts.push_back(jae);
-                        }
-                        else
-                        {
-                            //Error
-                            bRes = false;
-                            break;
-                        }
-                    }
+                UINT uZ;
+                if(!_parseHex4(pData + i + 1, &uZ))
+                {
+                    //Error
+                    ASSERT(nullptr);
+                    _describeError(pJError, iEsc, L("Bad \\u escape"));
+                    return 0;
+                }
 
-                    //Did it go thru?
-                    if(bRes)
+                i += 4;
+
+                if(uZ >= 0xD800 &&
+                    uZ <= 0xDFFF)
+                {
+                    //Must be a high surrogate followed by an escaped low surrogate
+                    UINT uZ2;
+                    if(uZ <= 0xDBFF &&
+                        i + 6 < nLen &&
+                        pData[i + 1] == '\\' &&
+                        pData[i + 2] == 'u' &&
+                        _parseHex4(pData + i + 3, &uZ2) &&
+                        uZ2 >= 0xDC00 &&
+                        uZ2 <= 0xDFFF)
                     {
-                        //Remember the pointer
-                        pDestV->pValue = pDestJA;
+                        i += 6;
+
+#ifdef _WIN32
+//Windows specific
+                        //Keep it as a UTF-16 pair
+                        str += (WCHAR)uZ;
+                        z = (WCHAR)uZ2;
+
+#elif JSON_UTF8
+//macOS & POSIX specific
+                        z = 0x10000 + ((uZ - 0xD800) << 10) + (uZ2 - 0xDC00);
+#endif
                     }
                     else
                     {
-                        //Free it
-                        _freeJSON_ARRAY(pDestJA);
+                        //Error
+                        ASSERT(nullptr);
+                        _describeError(pJError, iEsc, L("Unpaired surrogate in \\u escape"));
+                        return 0;
                     }
                 }
+                else
+                {
+#ifdef _WIN32
+//Windows specific
+                    z = (WCHAR)uZ;
+
+#elif JSON_UTF8
+//macOS & POSIX specific
+                    z = uZ;
+#endif
+                }
+            }
+            else
+            {
+                //Technically an error = but don't quit
+                ASSERT(nullptr);		//Bad escaping
             }
         }
-        break;
 
-    case JVT_OBJECT:
+        //Add it to name
+#ifdef _WIN32
+//Windows specific
+        str += z;
+        
+#elif JSON_UTF8
+//macOS & POSIX specific
+        if(!JSON_NODE::appendUtf8Char(str, z))
         {
-            pDestV->valType = pSrcV->valType;
-            pDestV->strValue = pSrcV->strValue;
-            pDestV->pValue = nullptr;
+            //Failed
+            ASSERT(nullptr);
+            _describeError(pJError, i, L("Failed to add UTF-8 character"));
+            return 0;
+        }
+#endif
+    }
 
-            JSON_OBJECT* pSrcJO = (JSON_OBJECT*)pSrcV->pValue;
-            ASSERT(pSrcJO);
-            if(pSrcJO)
-            {
-                JSON_OBJECT* pDestJO = new (std::nothrow) JSON_OBJECT;
-                ASSERT(pDestJO);
-                if(pDestJO)
-                {
-                    //Assume success
-                    bRes = true;
+    ASSERT(nullptr);
+    _describeError(pJError, i, L("Bad execution branch"));
+    CJSON::SetLastError(ERROR_HANDLE_EOF);
+    return -1;
+}
 
-                    intptr_t nCntJOs = (intptr_t)pSrcJO->arrObjElmts.size();
-                    JSON_OBJECT_ELEMENT* pJOEs = pSrcJO->arrObjElmts.data();
 
-                    for(intptr_t i = 0; i < nCntJOs; i++)
-                    {
-                        JSON_OBJECT_ELEMENT joe;
-                        if(__copySingleVal(&joe.val, &pJOEs[i].val))
-                        {
-                            joe.strName = pJOEs[i].strName;
+int CJSON::_parseDoubleQuotedForData(std_wstring& str, const WCHAR*& pStrRef, intptr_t& nchStrRef, const WCHAR* pData, intptr_t& i, intptr_t nLen, JSON_PARSE_CTX* pCtx)
+{
+    //Parse double quoted string for a name or value of JSON_DATA
+    //INFO: Same as _parseDoubleQuotedString(), except that when parsing into an arena, the string is put into the arena
+    //      (unless it's referenced in the source JSON string), and 'str' is left empty
+    //RETURN:
+    //		= 1 if got it OK, 'i' points to the next WCHAR after the "string"
+    //		= 0 if format error, 'i' may be out of range
+    //		= -1 if other non-JSON related error (such as out of memory, check CJSON::GetLastError() for info)
+    if(!pCtx->pArena)
+        return _parseDoubleQuotedString(str, pStrRef, nchStrRef, pData, i, nLen, pCtx);
 
-                            pDestJO->arrObjElmts.push_back(joe);
-                        }
-                        else
-                        {
-                            //Error
-                            bRes = false;
-                            break;
-                        }
-                    }
+    str.clear();
 
-                    //Did it go thru?
-                    if(bRes)
-                    {
-                        //Remember the pointer
-                        pDestV->pValue = pDestJO;
-                    }
-                    else
-                    {
-                        //Free it
-                        _freeJSON_OBJECT(pDestJO);
-                    }
-                }
-            }
+    //Unescape it into the reusable buffer first
+    int nR = _parseDoubleQuotedString(pCtx->strBuff, pStrRef, nchStrRef, pData, i, nLen, pCtx);
+    if(nR == 1 &&
+        !pStrRef)
+    {
+        if(!_copyToArena(pCtx->pArena, pCtx->strBuff.c_str(), (intptr_t)pCtx->strBuff.size(), pStrRef, nchStrRef))
+        {
+            //Out of memory
+            ASSERT(nullptr);
+            _describeError(pCtx->pJError, i, L("Out of memory"));
+            return -1;
         }
-        break;
     }
 
-    return bRes;
+    return nR;
 }
 
 
-bool JSON_NODE::addNode(JSON_NODE* pJNode)
+bool CJSON::_copyToArena(JSON_ARENA* pArena, const WCHAR* pStr, intptr_t nch, const WCHAR*& pStrRef, intptr_t& nchStrRef)
 {
-    //Add new 'pJNode' node to this node (where this node is either an object or array node)
-    //INFO: It makes a "deep" copy of 'pJNode'
-    //INFO: Can't be used to add nodes from the same JSON data.
+    //Copy string into 'pArena'
+    //'pStr' = string to copy (does not need to be null-terminated)
+    //'nch' = length of 'pStr' in TCHARs
+    //'pStrRef' = receives pointer to the copy (it is not null-terminated)
+    //'nchStrRef' = receives length of 'pStrRef' in TCHARs
     //RETURN:
     //		= true if success
-    bool bRes = false;
-    ASSERT(pJSONData);
+    //		= false if out of memory (check CJSON::GetLastError() for info)
+    ASSERT(pArena);
+    ASSERT(nch >= 0);
 
-    //Node must be specified and it must have a name
-    if(pJNode &&
-        pJSONData)
+    if(nch > 0)
     {
-        //Make sure that JSON data is not the same
-        if(this->pJSONData != pJNode->pJSONData &&
-            pJNode->pJSONData)
-        {
-            ASSERT(pVal);
-            if(pVal->valType == JVT_OBJECT)
-            {
-                //We must have a name for this node
-                if(!pJNode->strName.empty())
-                {
-                    JSON_OBJECT* pJO = (JSON_OBJECT*)pVal->pValue;
-                    ASSERT(pJO);
-                    if(pJO)
-                    {
-                        //Add new
-                        JSON_OBJECT_ELEMENT joe;
+        WCHAR* pMem = (WCHAR*)pArena->allocMem(nch * sizeof(WCHAR));
+        if(!pMem)
+            return false;
 
-                        //Copy node name
-                        joe.strName = pJNode->strName;
+        memcpy(pMem, pStr, nch * sizeof(WCHAR));
+        pStrRef = pMem;
+    }
+    else
+        pStrRef = L("");
 
-                        //Copy value
-                        if(CJSON::_deepCopyJSON_VALUE(&joe.val, pJNode->pVal))
-                        {
-                            //Add it
-                            pJO->arrObjElmts.push_back(joe);
+    nchStrRef = nch;
 
-                            //Done
-                            bRes = true;
-                        }
-                    }
-                }
-            }
-            else if(pVal->valType == JVT_ARRAY)
-            {
-                JSON_ARRAY* pJA = (JSON_ARRAY*)pVal->pValue;
-                ASSERT(pJA);
-                if(pJA)
-                {
-                    //Add new
-                    JSON_ARRAY_ELEMENT jae;
+    return true;
+}
 
-                    //Copy value
-                    if(CJSON::_deepCopyJSON_VALUE(&jae.val, pJNode->pVal))
-                    {
-                        //Add it
-                        pJA->arrArrElmts.push_back(jae);
 
-                        //Done
-                        bRes = true;
-                    }
-                }
-            }
-            else
+int CJSON::_parseForArray(JSON_ARRAY& ja, const WCHAR* pData, intptr_t& i, intptr_t nLen, JSON_PARSE_CTX* pCtx)
+{
+    //Parse for array
+    //'ja' = array to parse into -- must be freshly created
+    //'pData' = beginning of JSON string to parse
+    //'i' = index of the WCHAR to begin parsing from (may be space) -- must be the char right after the opening '['
+    //		INFO: It will be updated upon return to point to the char one after the last one in the array, i.e. ']'
+    //'nLen' = length of 'pData' in TCHARs
+    //'pCtx' = parsing context (error info and where to allocate from)
+    //RETURN:
+    //		= 1 if got it OK, 'i' points to the next WCHAR after the value
+    //		= 0 if format error, 'i' may be out of range
+    //		= -1 if other non-JSON related error (such as out of memory, check CJSON::GetLastError() for info)
+    JSON_ERROR* pJError = pCtx->pJError;
+    int nR;
+
+    bool bGotPreviousComma = true;
+
+    for(intptr_t cnt = 0;; cnt++)
+    {
+        //Go to next non-white-space
+        WCHAR c = _skipWhiteSpaces(pData, i, nLen);
+        if(!c)
+        {
+            //Reached EOF too early
+            ASSERT(nullptr);
+            _describeError(pJError, i, L("Unexpected EOF"));
+            return 0;
+        }
+
+        if(c == ']')
+        {
+            //End of array
+            i++;
+
+            return 1;
+        }
+        else if(c == ',')
+        {
+            //Comma separator between elements (only if not the first element)
+            if(cnt == 0 ||
+                bGotPreviousComma)
             {
-                //Can add only to the Array or Object note
+                //Error
                 ASSERT(nullptr);
+                _describeError(pJError, i, L("Unexpected comma"));
+                return 0;
             }
+
+            //Signal that we got it
+            bGotPreviousComma = true;
+
+            //Otherwise skip it
+            i++;
+            continue;
         }
-        else
+
+        //Make sure that we've got a comma before
+        if(!bGotPreviousComma)
         {
-            //Can't use same JSON object
+            //Error - missing comma
+            ASSERT(nullptr);
+            _describeError(pJError, i, L("Expected a comma"));
+            return 0;
+        }
+
+        JSON_ARRAY_ELEMENT jae;
+
+        //Parse value
+        nR = _parseForValue(jae.val, pData, i, nLen, pCtx);
+        if(nR != 1)
+        {
+            //Error
             ASSERT(nullptr);
+            _describeError(pJError, i, L("Value parsing failed"));
+            return nR;
         }
+
+        //Add it
+        ja.arrArrElmts.push_back(jae);
+
+        //Reset comma flag
+        bGotPreviousComma = false;
     }
 
-    return bRes;
+//	_describeError(pJError, i, L("Bad execution branch"));
+//    CJSON::SetLastError(ERROR_INVALID_DATA);
+//	return -1;
 }
 
 
-bool JSON_NODE::_addNode_WithType(LPCTSTR pStrName, JSON_VALUE_TYPE type, LPCTSTR pStrValue)
+
+int CJSON::_parseForObject(JSON_OBJECT& jo, const WCHAR* pData, intptr_t& i, intptr_t nLen, JSON_PARSE_CTX* pCtx)
 {
-    //Add new node to this node (where this node is either an object or array node)
-    //'pStrName' = node name (cannot be empty for objects and not used for arrays)
-    //				INFO: JSON specs do not allow duplicate names (this class allows it.)
-    //				INFO: JSON specs specifies that names are case-sensitive (this class can treat them as case-insensitive when looking for nodes)
-    //						http://tools.ietf.org/html/rfc7158
-    //'type' = type to assign to value. Can be JVT_PLAIN or JVT_DOUBLE_QUOTED
-    //'pStrValue' = value
+    //Parse for object
+    //'jo' = object to parse into -- must be freshly created
+    //'pData' = beginning of JSON string to parse
+    //'i' = index of the WCHAR to begin parsing from (may be space) -- must be the char right after the opening '{'
+    //		INFO: It will be updated upon return to point to the char one after the last one in the object, i.e. '}'
+    //'nLen' = length of 'pData' in TCHARs
+    //'pCtx' = parsing context (error info and where to allocate from)
     //RETURN:
-    //		= true if success
-    bool bRes = false;
-    ASSERT(pJSONData);
+    //		= 1 if got it OK, 'i' points to the next WCHAR after the object
+    //		= 0 if format error, 'i' may be out of range
+    //		= -1 if other non-JSON related error (such as out of memory, check CJSON::GetLastError() for info)
+    JSON_ERROR* pJError = pCtx->pJError;
+    int nR;
 
-    if(pJSONData)
+    bool bGotPreviousComma = true;
+
+    for(intptr_t cnt = 0;; cnt++)
     {
-        //Check allowed types
-        if(type == JVT_PLAIN ||
-            type == JVT_DOUBLE_QUOTED)
+        //Go to next non-white-space
+        WCHAR c = _skipWhiteSpaces(pData, i, nLen);
+        if(!c)
         {
-            ASSERT(pVal);
-            if(pVal->valType == JVT_OBJECT)
-            {
-                //Only if we have a name
-                if(pStrName &&
-                    pStrName[0])
-                {
-                    JSON_OBJECT* pJO = (JSON_OBJECT*)pVal->pValue;
-                    ASSERT(pJO);
-                    if(pJO)
-                    {
-                        //Add new
-                        JSON_OBJECT_ELEMENT joe;
-
-                        //Copy node name
-                        joe.strName = pStrName;
+            //Reached EOF too early
+            ASSERT(nullptr);
+            _describeError(pJError, i, L("Unexpected EOF"));
+            return 0;
+        }
+
+        if(c == '}')
+        {
+            //End of object
+            i++;
+
+            return 1;
+        }
+        else if(c == ',')
+        {
+            //Comma separator between elements (only if not the first element)
+            if(cnt == 0 ||
+                bGotPreviousComma)
+            {
+                //Error
+                ASSERT(nullptr);
+                _describeError(pJError, i, L("Unexpected comma"));
+                return 0;
+            }
+
+            //Signal that we got it
+            bGotPreviousComma = true;
+
+            //Otherwise skip it
+            i++;
+            continue;
+        }
+        else if(c == '"')
+        {
+            //Name
+
+            //Make sure that we've got a comma before
+            if(!bGotPreviousComma)
+            {
+                //Error - missing comma
+                ASSERT(nullptr);
+                _describeError(pJError, i, L("Expected a comma"));
+                return 0;
+            }
+
+            JSON_OBJECT_ELEMENT joe;
+
+            //Parse name
+            nR = _parseDoubleQuotedForData(joe.strName, joe.pNameRef, joe.nchNameRef, pData, i, nLen, pCtx);
+            if(nR != 1)
+            {
+                //Error
+                ASSERT(nullptr);
+                _describeError(pJError, i, L("Quote parsing failed"));
+                return nR;
+            }
+            
+            //Go to next non-white-space
+            c = _skipWhiteSpaces(pData, i, nLen);
+            if(!c)
+            {
+                //Reached EOF too early
+                ASSERT(nullptr);
+                _describeError(pJError, i, L("Unexpected EOF"));
+                return 0;
+            }
+
+            if(c != ':')
+            {
+                //Wrong format
+                ASSERT(nullptr);
+                _describeError(pJError, i, L("Expected a colon"));
+                return 0;
+            }
+            
+            i++;
+
+            //Go to next non-white-space
+            c = _skipWhiteSpaces(pData, i, nLen);
+            if(!c)
+            {
+                //Reached EOF too early
+                ASSERT(nullptr);
+                _describeError(pJError, i, L("Unexpected EOF"));
+                return 0;
+            }
+
+            //Parse value
+            nR = _parseForValue(joe.val, pData, i, nLen, pCtx);
+            if(nR != 1)
+            {
+                //Error
+                ASSERT(nullptr);
+                _describeError(pJError, i, L("Value parsing failed"));
+                return nR;
+            }
+
+            //Add it to the object
+            jo.arrObjElmts.push_back(joe);
+
+            //Reset comma flag
+            bGotPreviousComma = false;
+        }
+        else
+        {
+            //Error
+            ASSERT(nullptr);
+            _describeError(pJError, i, L("Unexpected formatting character"));
+            return 0;
+        }
+    }
+
+//    CJSON::SetLastError(ERROR_INVALID_DATA);
+//	return -1;
+}
+
+
+int CJSON::_parseForValue(JSON_VALUE& jv, const WCHAR* pData, intptr_t& i, intptr_t nLen, JSON_PARSE_CTX* pCtx)
+{
+    //Parse for value in "name" : "value" JSON pair
+    //'jv' = will be filled out with the value
+    //'pData' = beginning of JSON string to parse
+    //'i' = index of the WCHAR right after ':' in the example above -- it will be updated upon return to point to the char one after last in the "value"
+    //'nLen' = length of 'pData' in TCHARs
+    //'pCtx' = parsing context (error info and where to allocate from)
+    //RETURN:
+    //		= 1 if got it OK, 'i' points to the next WCHAR after the "value"
+    //		= 0 if format error, 'i' may be out of range
+    //		= -1 if other non-JSON related error (such as out of memory, check CJSON::GetLastError() for info)
+    JSON_ERROR* pJError = pCtx->pJError;
+    int nR;
+
+    //Go to next non-white-space
+    if(!_skipWhiteSpaces(pData, i, nLen))
+    {
+        //Reached EOF too early
+        ASSERT(nullptr);
+        _describeError(pJError, i, L("Unexpected EOF"));
+        return 0;
+    }
+
+    intptr_t i_delta;
+    
+#ifdef _WIN32
+//Windows specific
+    
+    WCHAR c = pData[i];
+    i_delta = 1;
+    
+#elif JSON_UTF8
+//macOS & POSIX specific
+    
+    UINT c;
+    i_delta = JSON_NODE::getUtf8Char(pData, i, nLen, &c);
+    if(i_delta <= 0)
+    {
+        //Error
+        ASSERT(nullptr);
+        _describeError(pJError, i, L("Bad UTF-8 sequence"));
+        return 0;
+    }
+
+#endif
+
+    //See what type of value is it
+    if(c == '"')
+    {
+        //Begin quoted value
+        jv.valType = JVT_DOUBLE_QUOTED;
+
+        //Parse it
+        nR = _parseDoubleQuotedForData(jv.strValue, jv.pStrRef, jv.nchStrRef, pData, i, nLen, pCtx);
+        if(nR != 1)
+        {
+            //Failed
+            ASSERT(nullptr);
+            _describeError(pJError, i, L("Quote parsing failed"));
+            return nR;
+        }
+
+    }
+    else if(_isPlainValueChar(c))
+    {
+        //Begin plain value
+        jv.valType = JVT_PLAIN;
+
+        intptr_t iStart = i;
+
+        //Look for the end
+        nR = _skipPlainValue(pData, i, nLen, i_delta, pJError);
+        if(nR != 1)
+            return nR;
+
+        //Convert it now, if asked to
+        if(!(pCtx->nFlags & JPF_NATIVE_VALUES) ||
+            _convertPlainValue(jv, pData + iStart, i - iStart, pCtx))
+        {
+            //Plain values never have escapes, so take them as-is
+            if(pCtx->nFlags & JPF_REFERENCE_SOURCE)
+            {
+                jv.pStrRef = pData + iStart;
+                jv.nchStrRef = i - iStart;
+            }
+            else if(pCtx->pArena)
+            {
+                if(!_copyToArena(pCtx->pArena, pData + iStart, i - iStart, jv.pStrRef, jv.nchStrRef))
+                {
+                    //Out of memory
+                    ASSERT(nullptr);
+                    _describeError(pJError, i, L("Out of memory"));
+                    return -1;
+                }
+            }
+            else
+                jv.strValue.assign(pData + iStart, i - iStart);
+        }
+
+        //Determine its type now, so that lookups don't have to
+        if(jv.nativeType == JNT_NONE &&
+            jv.plainType == JNT_NONE)
+        {
+            jv.plainType = _determinePlainType(&jv);
+        }
+    }
+    else if(c == '[')
+    {
+        //Begain array
+        jv.strValue.clear();
+
+        i += i_delta;
+
+        //Create new array
+        JSON_ARRAY* pJA = _newJSON_ARRAY(pCtx->pArena);
+        if(!pJA)
+        {
+            //Out of memory
+            ASSERT(nullptr);
+            _describeError(pJError, i, L("Out of memory"));
+            CJSON::SetLastError(ERROR_OUTOFMEMORY);
+            return -1;
+        }
+
+        //Parse it
+        nR = _parseForArray(*pJA, pData, i, nLen, pCtx);
+        if(nR != 1)
+        {
+            //Error
+            int nErr = CJSON::GetLastError();
+            ASSERT(nullptr);
+            _describeError(pJError, i, L("Array parsing failed"));
+
+            //Delete it
+            _freeJSON_ARRAY(pJA);
+
+            CJSON::SetLastError(nErr);
+            return nR;
+        }
+
+        //Mark it
+        jv.valType = JVT_ARRAY;
+
+        //Add it then
+        jv.pValue = pJA;
+    }
+    else if(c == '{')
+    {
+        //Begin object
+        jv.strValue.clear();
+
+        i += i_delta;
+
+        //Create new object
+        JSON_OBJECT* pJO = _newJSON_OBJECT(pCtx->pArena);
+        if(!pJO)
+        {
+            //Out of memory
+            ASSERT(nullptr);
+            _describeError(pJError, i, L("Out of memory"));
+            CJSON::SetLastError(ERROR_OUTOFMEMORY);
+            return -1;
+        }
+
+        //Parse it
+        nR = _parseForObject(*pJO, pData, i, nLen, pCtx);
+        if(nR != 1)
+        {
+            //Error
+            int nErr = CJSON::GetLastError();
+            ASSERT(nullptr);
+            _describeError(pJError, i, L("Object parsing failed"));
+
+            //Delete it then
+            _freeJSON_OBJECT(pJO);
+
+            CJSON::SetLastError(nErr);
+            return nR;
+        }
+
+        //Mark it
+        jv.valType = JVT_OBJECT;
+
+        //Add it then
+        jv.pValue = pJO;
+    }
+    else
+    {
+        //Error in format
+        ASSERT(nullptr);
+        _describeError(pJError, i, L("Unexpected formatting character"));
+        return 0;
+    }
+
+    return 1;
+}
+
+
+bool CJSON::_convertPlainValue(JSON_VALUE& jv, const WCHAR* pStr, intptr_t nch, JSON_PARSE_CTX* pCtx)
+{
+    //Convert plain value into 'jv.nativeType' for JPF_NATIVE_VALUES
+    //INFO: Uses the same rules as CJSON::_determineNodeType(), so values that it would not treat as null, boolean or a number are left unconverted
+    //      (their type is then stored in 'jv.plainType', so it doesn't have to be determined again)
+    //'pStr' = value from the source JSON string (not null-terminated)
+    //'nch' = length of 'pStr' in TCHARs
+    //RETURN:
+    //		= true if the text of the value needs to be kept in 'jv'
+    //		= false if the value is fully described by 'jv.nativeType'
+    jv.nativeType = JNT_NONE;
+
+    if(json::JSON_NODE::compareStringsEqual(pStr, nch, L("null"), -1, true))
+    {
+        jv.nativeType = JNT_NULL;
+        return true;
+    }
+    else if(json::JSON_NODE::compareStringsEqual(pStr, nch, L("true"), -1, true))
+    {
+        jv.nativeType = JNT_BOOLEAN;
+        jv.bNative = true;
+        return true;
+    }
+    else if(json::JSON_NODE::compareStringsEqual(pStr, nch, L("false"), -1, true))
+    {
+        jv.nativeType = JNT_BOOLEAN;
+        jv.bNative = false;
+        return true;
+    }
+
+    bool bKeepText = true;
+
+    int64_t iiVal;
+    int nResInt = parseInt64(pStr, nch, &iiVal);
+    if(nResInt != 0)
+    {
+        //Values that don't fit into 64 bits are left as text
+        jv.plainType = JNT_INTEGER;
+
+        if(nResInt > 0)
+        {
+            jv.nativeType = JNT_INTEGER;
+            jv.iiNative = iiVal;
+
+            bKeepText = (pCtx->nFlags & JPF_KEEP_NUMBER_TEXT) != 0;
+        }
+    }
+    else
+    {
+        double fVal;
+        if(parseDouble(pStr, nch, &fVal))
+        {
+            jv.nativeType = JNT_FLOAT;
+            jv.fNative = fVal;
+
+            //Text like "1e999" or "nan" would not be written back the same way, so keep it
+            bKeepText = (pCtx->nFlags & JPF_KEEP_NUMBER_TEXT) ||
+                !std::isfinite(fVal);
+        }
+        else
+            jv.plainType = JNT_STRING;
+    }
+
+    return bKeepText;
+}
+
+
+intptr_t CJSON::_formatNativeValue(const JSON_VALUE& jv, WCHAR* pBuff)
+{
+    //Write a number converted with JPF_NATIVE_VALUES as text
+    //'pBuff' = buffer to write into, must be at least JSON_NUMBER_BUFF_LEN TCHARs long (it will be null-terminated)
+    //RETURN:
+    //		= Length of the text written, or
+    //		= -1 if 'jv' has no converted number
+    if(jv.nativeType == JNT_INTEGER)
+        return _formatInt64(jv.iiNative, pBuff);
+    else if(jv.nativeType == JNT_FLOAT)
+        return _formatDouble(jv.fNative, pBuff);
+
+    pBuff[0] = 0;
+    return -1;
+}
+
+
+void JSON_VALUE::formatNative(std_wstring& str) const
+{
+    //'str' = receives the text for a number converted with JPF_NATIVE_VALUES, or an empty string if there's none
+    WCHAR buff[JSON_NUMBER_BUFF_LEN];
+    intptr_t nLn = CJSON::_formatNativeValue(*this, buff);
+    if(nLn >= 0)
+        str.assign(buff, nLn);
+    else
+        str.clear();
+}
+
+
+bool JSON_DATA::json_toString(JSON_DATA* pJE, JSON_FORMATTING* pJFormat, std_wstring* pOutStr)
+{
+    //Redirect
+    return CJSON::toString(pJE, pJFormat, pOutStr);
+}
+
+bool CJSON::toString(JSON_DATA* pJE, JSON_FORMATTING* pJFormat, std_wstring* pOutStr)
+{
+    //Convert 'pJE' to JSON string
+    //'pJFormat' = if not nullptr, formatting to use for JSON, or nullptr to use defaults
+    //'pOutStr' = if not nullptr, receives formatted JSON (if nullptr, can be used to check correctness of data in 'pJE')
+    //RETURN:
+    //		= true if success
+    //		= false if error (check CJSON::GetLastError() for info)
+    bool bRes = false;
+    int nOSError = NO_ERROR;
+
+    if(pJE)
+    {
+        //Do we have a formatting struct
+        JSON_FORMATTING jFmt;
+        if(!pJFormat)
+        {
+            //Use defaults
+            pJFormat = &jFmt;
+        }
+
+        //Empty string
+        if(pOutStr)
+            pOutStr->clear();
+
+        //INFO: If the caller only wants to check the data, the output is discarded.
+        JSON_WRITER jw(pOutStr, pJFormat);
+
+        if(_serialize(pJE, jw))
+        {
+            //Done
+            bRes = true;
+        }
+        else
+        {
+            //Failed
+            nOSError = jw.nOSError;
+
+            if(pOutStr)
+            {
+                //If failed, clear the string
+                pOutStr->clear();
+            }
+        }
+    }
+    else
+        nOSError = ERROR_INVALID_PARAMETER;
+
+    CJSON::SetLastError(nOSError);
+    return bRes;
+}
+
+
+bool CJSON::_serialize(JSON_DATA* pJE, JSON_WRITER& jw)
+{
+    //Write 'pJE' into 'jw' in a single pass
+    //RETURN:
+    //		= true if success
+    //		= false if error ('jw.nOSError' has the error code)
+    if(!_toString_Value(pJE->val, jw, 1))
+    {
+        if(!jw.bFailed)
+        {
+            //Bad data
+            jw.bFailed = true;
+            jw.nOSError = ERROR_BAD_FORMAT;
+        }
+
+        return false;
+    }
+
+    return jw.finish();
+}
+
+
+void JSON_WRITER::writeNewLineIndent(intptr_t nIndent)
+{
+    //Write new line followed by indentation
+    //'nIndent' = number of indentation steps
+    ASSERT(nIndent >= 0);
+    if(nIndent < 0)
+        nIndent = 0;
+
+    if((size_t)nIndent >= arrNewLineIndents.size())
+    {
+        //Prep one indentation step
+        std_wstring strTab;
+        if(pJFormat->spacesType == JSP_USE_SPACES)
+        {
+            int nNmSps = pJFormat->nSpacesPerTab;
+            if(nNmSps < 1)
+                nNmSps = 1;
+            else if(nNmSps > 64)
+                nNmSps = 64;
+
+            strTab.assign(nNmSps, ' ');
+        }
+        else
+            strTab = '\t';
+
+        if(arrNewLineIndents.empty())
+            arrNewLineIndents.push_back(pJFormat->strNewLine);
+
+        while((size_t)nIndent >= arrNewLineIndents.size())
+        {
+            arrNewLineIndents.push_back(arrNewLineIndents.back() + strTab);
+        }
+    }
+
+    const std_wstring& strIndent = arrNewLineIndents[nIndent];
+    write(strIndent.c_str(), strIndent.size());
+}
+
+void JSON_WRITER::flush()
+{
+    //Move what we have in the buffer into the output string, or pass it to the sink
+    if(pfnSink)
+    {
+        _flushToSink(false);
+        return;
+    }
+
+    if(pStr)
+        pStr->append(buff, pCur - buff);
+
+    pCur = buff;
+}
+
+bool JSON_WRITER::finish()
+{
+    //Flush the rest of the output
+    //RETURN:
+    //		= true if all output was delivered
+    //		= false if error ('nOSError' has the error code)
+    if(pfnSink)
+        _flushToSink(true);
+    else
+        flush();
+
+    return !bFailed;
+}
+
+void JSON_WRITER::_writeLong(const WCHAR* p, size_t nch)
+{
+    //Write 'nch' TCHARs from 'p' that don't fit into what's left of the buffer
+    if(pfnSink)
+    {
+        //Pass it through the buffer, one piece at a time
+        while(nch)
+        {
+            size_t nchFree = buff + SIZEOF(buff) - pCur;
+            if(!nchFree)
+            {
+                flush();
+                continue;
+            }
+
+            size_t nchPiece = nch < nchFree ? nch : nchFree;
+            memcpy(pCur, p, nchPiece * sizeof(WCHAR));
+
+            pCur += nchPiece;
+            p += nchPiece;
+            nch -= nchPiece;
+        }
+
+        return;
+    }
+
+    flush();
+
+    if(nch < SIZEOF(buff))
+    {
+        memcpy(pCur, p, nch * sizeof(WCHAR));
+        pCur += nch;
+    }
+    else if(pStr)
+    {
+        //Too long to buffer
+        pStr->append(p, nch);
+    }
+}
+
+void JSON_WRITER::_setFailed(int nError)
+{
+    //Stop writing output
+    //'nError' = error code, or 0 to use a generic one
+    if(!bFailed)
+    {
+        bFailed = true;
+        nOSError = nError != NO_ERROR ? nError : ERROR_WRITE_FAULT;
+    }
+}
+
+
+bool CJSON::_toString_Value(JSON_VALUE& val, JSON_WRITER& jw, intptr_t nIndent)
+{
+    //Write 'val' into 'jw'
+    //'nIndent' = current indentation level (1 for the root value)
+    //RETURN:
+    //		= true if success
+    //		= false if error
+    switch(val.valType)
+    {
+    case JVT_PLAIN:					// 25, 167.6, 12E40, -12, +12, true, false, null
+        {
+            if(val.isNativeOnly())
+            {
+                //Number that was converted when parsed
+                WCHAR buff[JSON_NUMBER_BUFF_LEN];
+                intptr_t nLn = _formatNativeValue(val, buff);
+                if(nLn < 0)
+                {
+                    //Failed
+                    ASSERT(nullptr);
+                    return false;
+                }
+
+                jw.write(buff, nLn);
+            }
+            else
+                jw.write(val.getStrPtr(), val.getStrLen());
+        }
+        break;
+
+    case JVT_DOUBLE_QUOTED:			// "string"
+        {
+            jw.put('"');
+
+            if(!_escapeDoubleQuotedVal(val.getStrPtr(), val.getStrLen(), jw))
+            {
+                //Failed
+                ASSERT(nullptr);
+                return false;
+            }
+
+            jw.put('"');
+        }
+        break;
+
+    case JVT_ARRAY:					// [ val1, val2 ]
+        {
+            JSON_ARRAY* pJA = (JSON_ARRAY*)val.pValue;
+            if(!pJA)
+            {
+                //Error
+                ASSERT(nullptr);
+                return false;
+            }
+
+            jw.put('[');
+
+            intptr_t nCnt = pJA->arrArrElmts.size();
+            JSON_ARRAY_ELEMENT* pJAEs = pJA->arrArrElmts.data();
+
+            for(intptr_t i = 0; i < nCnt; i++)
+            {
+                if(i != 0)
+                {
+                    //Add comma
+                    if(jw.bHumanReadable)
+                        jw.write(L(", "), 2);
+                    else
+                        jw.put(',');
+                }
+
+                //Print each element
+                if(!_toString_Value(pJAEs[i].val, jw, nIndent) ||
+                    jw.bFailed)
+                {
+                    //Failed (the error was already asserted, or the sink failed)
+                    return false;
+                }
+            }
+
+            jw.put(']');
+        }
+        break;
+
+    case JVT_OBJECT:				// { "name1":"value1", "name2" : "value2" }
+        {
+            JSON_OBJECT* pJO = (JSON_OBJECT*)val.pValue;
+            if(!pJO)
+            {
+                //Error
+                ASSERT(nullptr);
+                return false;
+            }
+
+            jw.put('{');
+
+            intptr_t nCnt = pJO->arrObjElmts.size();
+            JSON_OBJECT_ELEMENT* pJOEs = pJO->arrObjElmts.data();
+
+            if(nCnt > 0)
+            {
+                for(intptr_t i = 0; i < nCnt; i++)
+                {
+                    if(i != 0)
+                    {
+                        //Add comma
+                        jw.put(',');
+                    }
+
+                    if(jw.bHumanReadable)
+                        jw.writeNewLineIndent(nIndent);
+
+                    //Element name
+                    jw.put('"');
+                    jw.write(pJOEs[i].getNamePtr(), pJOEs[i].getNameLen());
+                    if(jw.bHumanReadable)
+                        jw.write(L("\": "), 3);
+                    else
+                        jw.write(L("\":"), 2);
+
+                    //Print value
+                    if(!_toString_Value(pJOEs[i].val, jw, nIndent + 1) ||
+                        jw.bFailed)
+                    {
+                        //Failed (the error was already asserted, or the sink failed)
+                        return false;
+                    }
+                }
+
+                if(jw.bHumanReadable)
+                {
+                    //Last element
+                    jw.writeNewLineIndent(nIndent - 1);
+                }
+            }
+
+            jw.put('}');
+        }
+        break;
+
+    default:
+        {
+            //Bad type
+            ASSERT(nullptr);
+            return false;
+        }
+        break;
+    }
+
+    return true;
+}
+
+std_wstring& CJSON::appendFormat(std_wstring& str, LPCTSTR pszFormat, ...)
+{
+	//Format string the same way as wsprintf() does
+	int nOSError = CJSON::GetLastError();
+
+	va_list args;
+	va_start(args, pszFormat);
+
+    va_list args2;
+    va_copy(args2, args);
+
+#ifdef _WIN32
+
+    //Windows specific
+	intptr_t nSz = _vscwprintf(pszFormat, args);
+
+#elif JSON_UTF8
+    //macOS & POSIX specific
+    intptr_t nSz = vsnprintf(nullptr, 0, pszFormat, args);
+
+#endif
+
+	if(nSz >= 0)
+    {
+		WCHAR* p_buff = new (std::nothrow) WCHAR[nSz + 1];
+		if(p_buff)
+        {
+			p_buff[0] = 0; 
+
+#ifdef _WIN32
+            //Windows specific
+			vswprintf_s(p_buff, nSz + 1, pszFormat, args2);
+#elif JSON_UTF8
+            //macOS & POSIX specific
+            vsnprintf(p_buff, nSz + 1, pszFormat, args2);
+#endif
+			remove_nulls_from_str(p_buff, (size_t&)nSz);
+			str.append(p_buff, nSz);
+
+			delete[] p_buff;
+		}
+	}
+
+    va_end(args);
+    va_end(args2);
+
+    CJSON::SetLastError(nOSError);
+
+	return str;
+}
+
+WCHAR* CJSON::remove_nulls_from_str(WCHAR* p_str, size_t& szch)
+{
+    //Remove all internal nulls that may be in 'p_str'
+    //'szch' = original size of 'p_str' in WCHARs, without last null. It may be adjusted after this function returns
+    //RETURN:
+    //		= Pointer to 'p_str'
+
+    if(p_str &&
+        szch)
+    {
+        size_t szch0 = szch;
+
+        WCHAR* pE = p_str + szch;
+        for(WCHAR* pS = pE - 1; pS >= p_str; pS--)
+        {
+            if(!*pS)
+            {
+                if(pS + 1 < pE)
+                {
+                    //Remove it
+                    memcpy(pS, pS + 1, (pE - pS - 1) * sizeof(WCHAR));
+                }
+
+                szch--;
+            }
+        }
+
+        //Set last null
+        if(szch < szch0)
+        {
+            //Last null
+            p_str[szch] = 0;
+        }
+    }
+
+    return p_str;
+}
+
+
+std_wstring& CJSON::lTrim(std_wstring &s)
+{
+    //Trim all white-spaces from the left side of 's'
+    //RETURN: = Same trimmed string
+    
+#ifdef _WIN32
+    //Windows specific
+    s.erase(s.begin(), std::find_if(s.begin(), s.end(), std::not1(std::ptr_fun<int, int>(std::isspace))));
+    
+#elif JSON_UTF8
+    //macOS & POSIX specific
+    s.erase(s.begin(), std::find_if(s.begin(), s.end(), [](int c) {return !std::isspace(c);}));
+
+#endif
+    
+    return s;
+}
+
+std_wstring& CJSON::rTrim(std_wstring &s)
+{
+    //Trim all white-spaces from the right side of 's'
+    //RETURN: = Same trimmed string
+
+#ifdef _WIN32
+    //Windows specific
+    s.erase(std::find_if(s.rbegin(), s.rend(), std::not1(std::ptr_fun<int, int>(std::isspace))).base(), s.end());
+
+#elif JSON_UTF8
+    //macOS & POSIX specific
+    s.erase(std::find_if(s.rbegin(), s.rend(), [](int c) {return !std::isspace(c);}).base(), s.end());
+    
+#endif
+
+    return s;
+}
+
+std_wstring& CJSON::Trim(std_wstring &s)
+{
+    //Trim all white-spaces from 's'
+    //RETURN: = Same trimmed string
+    return lTrim(rTrim(s));
+}
+
+
+
+//Second character of the escape sequence for ASCII characters that must be escaped, or 0 if the character is written as-is
+static const char g_escapeChars[0x80] = {
+    '0',  0,    0,    0,    0,    0,    0,    0,    'b',  't',  'n',  0,    'f',  'r',  0,    0,
+    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+    0,    0,    '"',  0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    '/',
+    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    '\\', 0,    0,    0,
+    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+};
+
+#ifdef JSON_UTF8
+//macOS & POSIX specific
+static intptr_t _skipUnescapedAsciiRun(const char* pStr, intptr_t i, intptr_t nLn)
+{
+    //Skip ASCII characters that are written without escaping, 8 bytes at a time
+    //'i' = index to begin from
+    //'nLn' = length of 'pStr' in bytes
+    //RETURN: = Index of the first 8-byte block on or after 'i' that may have a character that needs attention
+    const uint64_t kOnes = 0x0101010101010101ULL;
+    const uint64_t kHighs = 0x8080808080808080ULL;
+
+    for(; i + (intptr_t)sizeof(uint64_t) <= nLn; i += sizeof(uint64_t))
+    {
+        uint64_t uiWord;
+        memcpy(&uiWord, pStr + i, sizeof(uiWord));
+
+        uint64_t uiQuote = uiWord ^ (kOnes * '"');
+        uint64_t uiBkSlash = uiWord ^ (kOnes * '\\');
+        uint64_t uiSlash = uiWord ^ (kOnes * '/');
+
+        if(((uiWord - kOnes * 0x20) |
+            ((uiQuote - kOnes) & ~uiQuote) |
+            ((uiBkSlash - kOnes) & ~uiBkSlash) |
+            ((uiSlash - kOnes) & ~uiSlash) |
+            uiWord) & kHighs)
+        {
+            break;
+        }
+    }
+
+    return i;
+}
+#endif
+
+static void _writeUnicodeEscape(JSON_WRITER& jw, UINT z)
+{
+    //Write \uXXXX for 'z' (in lower-case hex)
+    //'z' = value to escape [0 - 0xFFFF]
+    static const char hexDigits[] = "0123456789abcdef";
+
+    WCHAR buff[6] = {'\\', 'u',
+        (WCHAR)hexDigits[(z >> 12) & 0xF],
+        (WCHAR)hexDigits[(z >> 8) & 0xF],
+        (WCHAR)hexDigits[(z >> 4) & 0xF],
+        (WCHAR)hexDigits[z & 0xF]};
+
+    jw.write(buff, 6);
+}
+
+bool CJSON::_escapeDoubleQuotedVal(LPCTSTR pStr, intptr_t nLn, JSON_WRITER& jw)
+{
+    //Write escaped 'pStr' into 'jw'
+    //'pStr' = string to escape (does not need to be null-terminated)
+    //'nLn' = length of 'pStr' in TCHARs
+    //RETURN:
+    //		= true if success
+    //		= false if error (bad UTF-8 in 'pStr')
+    JSON_ESCAPE_TYPE escTp = jw.pJFormat->escapeType;
+
+    //%x22 /          ; "    quotation mark  U+0022
+    //%x5C /          ; \    reverse solidus U+005C
+    //%x2F /          ; /    solidus         U+002F
+    //%x62 /          ; b    backspace       U+0008
+    //%x66 /          ; f    form feed       U+000C
+    //%x6E /          ; n    line feed       U+000A
+    //%x72 /          ; r    carriage return U+000D
+    //%x74 /          ; t    tab             U+0009
+    //%x75 4HEXDIG )  ; uXXXX                U+XXXX
+
+    //INFO: Characters that don't need escaping are collected into runs that are appended at once
+    intptr_t nRunBegin = 0;
+
+    for(intptr_t i = 0; i < nLn; )
+    {
+#ifdef _WIN32
+//Windows specific
+        UINT z = (WCHAR)pStr[i];
+#elif JSON_UTF8
+//macOS & POSIX specific
+        UINT z = (BYTE)pStr[i];
+#endif
+
+        if(z < 0x80)
+        {
+            char chEsc = g_escapeChars[z];
+            if(!chEsc)
+            {
+                //Keep it in the run
+                i++;
+
+#ifdef JSON_UTF8
+                //macOS & POSIX specific
+                i = _skipUnescapedAsciiRun(pStr, i, nLn);
+#endif
+                continue;
+            }
+
+            jw.write(pStr + nRunBegin, i - nRunBegin);
+
+            WCHAR buff[2] = {'\\', (WCHAR)chEsc};
+            jw.write(buff, 2);
+
+            i++;
+            nRunBegin = i;
+            continue;
+        }
+
+        intptr_t i_delta = 1;
+
+#ifdef JSON_UTF8
+        //macOS & POSIX specific
+        i_delta = JSON_NODE::getUtf8Char(pStr, i, nLn, &z);
+        if(i_delta <= 0)
+        {
+            //Error
+            ASSERT(nullptr);
+            return false;
+        }
+#endif
+
+        //Do we need to do the escaping?
+        bool bEscIt = escTp == JESCT_ESCAPE_CHARS_AFTER_0x80 ||
+                      (z >= 0x100 && escTp == JESCT_ESCAPE_CHARS_AFTER_0x100);
+
+        if(bEscIt)
+        {
+            jw.write(pStr + nRunBegin, i - nRunBegin);
+
+            //Escape Unicode
+            //INFO: Characters past 0xFFFF are escaped as UTF-16 surrogate pairs
+            if(z <= 0xffff)
+            {
+                _writeUnicodeEscape(jw, z);
+            }
+            else
+            {
+                _writeUnicodeEscape(jw, 0xD800 + ((z - 0x10000) >> 10));
+                _writeUnicodeEscape(jw, 0xDC00 + ((z - 0x10000) & 0x3FF));
+            }
+
+            i += i_delta;
+            nRunBegin = i;
+        }
+        else
+        {
+            //Just add it as-is
+            i += i_delta;
+        }
+    }
+
+    jw.write(pStr + nRunBegin, nLn - nRunBegin);
+
+    return true;
+}
+
+JSON_ARRAY* CJSON::_newJSON_ARRAY(JSON_ARENA* pArena)
+{
+    //Create new empty array
+    //'pArena' = arena to allocate it from, or nullptr to use the heap
+    //RETURN:
+    //		= New array -- must be freed with _freeJSON_ARRAY()
+    //		= nullptr if out of memory
+    if(pArena)
+    {
+        void* pMem = pArena->allocMem(sizeof(JSON_ARRAY));
+        if(!pMem)
+            return nullptr;
+
+        return new (pMem) JSON_ARRAY(pArena);
+    }
+
+    return new (std::nothrow) JSON_ARRAY;
+}
+
+JSON_OBJECT* CJSON::_newJSON_OBJECT(JSON_ARENA* pArena)
+{
+    //Create new empty object
+    //'pArena' = arena to allocate it from, or nullptr to use the heap
+    //RETURN:
+    //		= New object -- must be freed with _freeJSON_OBJECT()
+    //		= nullptr if out of memory
+    if(pArena)
+    {
+        void* pMem = pArena->allocMem(sizeof(JSON_OBJECT));
+        if(!pMem)
+            return nullptr;
+
+        return new (pMem) JSON_OBJECT(pArena);
+    }
+
+    return new (std::nothrow) JSON_OBJECT;
+}
+
+void CJSON::_freeJSON_ARRAY(JSON_ARRAY* pJA)
+{
+    //INFO: When this method returns 'pJA' will be no longer valid!
+    if(pJA)
+    {
+        for(intptr_t i = 0; i < (intptr_t)pJA->arrArrElmts.size(); i++)
+        {
+            //Free its children first
+            _freeJSON_VALUE(pJA->arrArrElmts[i].val);
+        }
+
+        //Then free the array
+        if(pJA->pArena)
+        {
+            //Its memory belongs to the arena
+            pJA->~JSON_ARRAY();
+        }
+        else
+            delete pJA;
+    }
+}
+
+void CJSON::_freeJSON_OBJECT(JSON_OBJECT* pJO)
+{
+    //INFO: When this method returns 'pJO' will be no longer valid!
+    if(pJO)
+    {
+        for(intptr_t i = 0; i < (intptr_t)pJO->arrObjElmts.size(); i++)
+        {
+            //Free its children first
+            _freeJSON_VALUE(pJO->arrObjElmts[i].val);
+        }
+
+        //Then free the object
+        if(pJO->pArena)
+        {
+            //Its memory belongs to the arena
+            pJO->~JSON_OBJECT();
+        }
+        else
+            delete pJO;
+    }
+}
+
+bool JSON_DATA::useArena(JSON_ARENA* pUseArena, size_t ncbBlockSz)
+{
+    //Make this JSON data allocate its objects and arrays from an arena
+    //INFO: This will erase all data
+    //INFO: Arena memory is recycled each time this JSON data is emptied (or parsed into again). CJSON::parseJSON() also puts elements
+    //      of objects and arrays, names and values into the arena, which makes repeated parsing into the same JSON_DATA mostly allocation-free,
+    //      and lets emptyData() simply reset the arena (until the data is changed with JSON_NODE methods.)
+    //'pUseArena' = arena to use (it must outlive this JSON data), or nullptr to create and own a new arena
+    //              INFO: It can't be used by another JSON data at the same time. This JSON data stops using it when it's deleted,
+    //                    or when it's given another arena with this method.
+    //'ncbBlockSz' = size of blocks for the arena created if 'pUseArena' is nullptr, in BYTEs
+    //RETURN:
+    //		= true if success
+    //		= false if error (check CJSON::GetLastError() for info)
+    //		  INFO: It is ERROR_BUSY if 'pUseArena' is used by another JSON data
+    if(pUseArena &&
+        pUseArena->pUsedBy &&
+        pUseArena->pUsedBy != this)
+    {
+        CJSON::SetLastError(ERROR_BUSY);
+        return false;
+    }
+
+    if(pUseArena &&
+        pUseArena == pArena)
+    {
+        //Already using it
+        emptyData();
+        return true;
+    }
+
+    JSON_ARENA* pNewArena = pUseArena;
+    if(!pNewArena)
+    {
+        pNewArena = new (std::nothrow) JSON_ARENA(ncbBlockSz);
+        if(!pNewArena)
+        {
+            CJSON::SetLastError(ERROR_OUTOFMEMORY);
+            return false;
+        }
+    }
+
+    //Release old data while the old arena is still around
+    emptyData();
+
+    if(bOwnArena)
+    {
+        delete pArena;
+    }
+    else if(pArena)
+    {
+        //Another JSON data can use it now
+        pArena->pUsedBy = nullptr;
+    }
+
+    pArena = pNewArena;
+    bOwnArena = !pUseArena;
+    pArena->pUsedBy = this;
+
+    return true;
+}
+
+
+bool JSON_DATA::freeze()
+{
+    //Make this JSON data read-only, so that it can be read from any number of threads at once without locking
+    //INFO: All lookup caches (name indexes of large objects and types of plain values) are completed here, so that reading
+    //      frozen data never changes it, and searching it doesn't allocate memory (other than to copy names and values out of it.)
+    //      Searches by name in data that is not frozen attach name indexes to large objects (see JSON_NODE::findNodeByName()),
+    //      thus they can't be done while another thread changes the data.
+    //INFO: Spare capacity of all arrays of elements is released, thus nodes retrieved before calling this method must be retrieved again.
+    //INFO: After that all JSON_NODE::addNode*(), setNodeBy*(), removeNode*() and setAs*Node() calls on this data will fail with ERROR_ACCESS_DENIED.
+    //      Call emptyData() (or parse into this data again) to be able to change it, but only after all threads stopped reading it!
+    //RETURN:
+    //		= true if success
+    //		= false if error (check CJSON::GetLastError() for info)
+    if(bFrozen)
+        return true;
+
+    if(!JSON_NODE::_freezeJSON_VALUE(&val))
+        return false;
+
+    bFrozen = true;
+
+    return true;
+}
+
+
+
+size_t JSON_ARENA::_getBlockHeaderSize()
+{
+    //RETURN: = Size of ARENA_BLOCK rounded up, so that the memory after it is aligned for any type
+    return (sizeof(ARENA_BLOCK) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+}
+
+BYTE* JSON_ARENA::_getBlockData(ARENA_BLOCK* pBlock)
+{
+    //RETURN: = Pointer to the usable memory in 'pBlock'
+    ASSERT(pBlock);
+    return (BYTE*)pBlock + _getBlockHeaderSize();
+}
+
+bool JSON_ARENA::_useBlock(ARENA_BLOCK* pBlock, size_t ncbSz)
+{
+    //Start allocating from 'pBlock' if it can fit 'ncbSz' BYTEs
+    //RETURN:
+    //		= true if switched to 'pBlock'
+    if(pBlock &&
+        pBlock->ncbSz >= ncbSz)
+    {
+        pCurBlock = pBlock;
+        pCur = _getBlockData(pBlock);
+        pEnd = pCur + pBlock->ncbSz;
+
+        return true;
+    }
+
+    return false;
+}
+
+void* JSON_ARENA::allocMem(size_t ncbSz)
+{
+    //Allocate memory from the arena
+    //INFO: Such memory is released only by reset() or freeAll()
+    //'ncbSz' = number of BYTEs to allocate
+    //RETURN:
+    //		= Pointer to allocated memory, aligned to be used for any type
+    //		= nullptr if out of memory
+    const size_t ncbAlign = alignof(std::max_align_t);
+    ncbSz = (ncbSz + ncbAlign - 1) & ~(ncbAlign - 1);
+    if(!ncbSz)
+        ncbSz = ncbAlign;
+
+    if((size_t)(pEnd - pCur) < ncbSz)
+    {
+        //Try the blocks left over from before the last reset
+        while(!_useBlock(pCurBlock ? pCurBlock->pNext : pFirstBlock, ncbSz))
+        {
+            ARENA_BLOCK* pNextBlock = pCurBlock ? pCurBlock->pNext : pFirstBlock;
+            if(!pNextBlock)
+            {
+                //Need a new block
+                size_t ncbBlockSz = ncbSz > ncbBlockSize ? ncbSz : ncbBlockSize;
+
+                BYTE* pMem = new (std::nothrow) BYTE[_getBlockHeaderSize() + ncbBlockSz];
+                if(!pMem)
+                {
+                    CJSON::SetLastError(ERROR_OUTOFMEMORY);
+                    return nullptr;
+                }
+
+                ARENA_BLOCK* pNewBlock = (ARENA_BLOCK*)pMem;
+                pNewBlock->pNext = nullptr;
+                pNewBlock->ncbSz = ncbBlockSz;
+
+                if(pCurBlock)
+                    pCurBlock->pNext = pNewBlock;
+                else
+                    pFirstBlock = pNewBlock;
+
+                continue;
+            }
+
+            //This one is too small -- skip it
+            pCurBlock = pNextBlock;
+        }
+    }
+
+    void* pRes = pCur;
+    pCur += ncbSz;
+    ncbUsed += ncbSz;
+
+    return pRes;
+}
+
+void JSON_ARENA::reset()
+{
+    //Make all memory in the arena available again
+    //INFO: Memory blocks are kept for reuse. All pointers previously returned by allocMem() become invalid!
+    _deleteNameIndexes();
+
+    pCurBlock = nullptr;
+    pCur = nullptr;
+    pEnd = nullptr;
+    ncbUsed = 0;
+}
+
+void JSON_ARENA::_addNameIndex(JSON_NAME_INDEX* pIdx)
+{
+    //Add name index of an object from this arena to the list of indexes to delete when the arena is reset
+    //INFO: Searches from several threads can add indexes at once
+    ASSERT(pIdx);
+    pIdx->pNextInArena = pNameIndexes.load(std::memory_order_relaxed);
+    while(!pNameIndexes.compare_exchange_weak(pIdx->pNextInArena, pIdx, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void JSON_ARENA::_deleteNameIndexes()
+{
+    //Delete all name indexes of objects from this arena
+    //INFO: Objects that had them must not be used after that
+    for(JSON_NAME_INDEX* pIdx = pNameIndexes.exchange(nullptr, std::memory_order_acquire); pIdx; )
+    {
+        JSON_NAME_INDEX* pNextIdx = pIdx->pNextInArena;
+        delete pIdx;
+        pIdx = pNextIdx;
+    }
+}
+
+void JSON_ARENA::freeAll()
+{
+    //Return all memory in the arena back to the heap
+    //INFO: All pointers previously returned by allocMem() become invalid!
+    for(ARENA_BLOCK* pBlock = pFirstBlock; pBlock; )
+    {
+        ARENA_BLOCK* pNextBlock = pBlock->pNext;
+        delete[] (BYTE*)pBlock;
+        pBlock = pNextBlock;
+    }
+
+    pFirstBlock = nullptr;
+
+    reset();
+}
+
+size_t JSON_ARENA::getSizeReserved()
+{
+    //RETURN: = Number of BYTEs reserved from the heap by this arena
+    size_t ncbSz = 0;
+    for(ARENA_BLOCK* pBlock = pFirstBlock; pBlock; pBlock = pBlock->pNext)
+    {
+        ncbSz += pBlock->ncbSz;
+    }
+
+    return ncbSz;
+}
+
+
+
+void JSON_DATA::_freeJSON_VALUE(JSON_VALUE& val)
+{
+    //Redirect
+    CJSON::_freeJSON_VALUE(val);
+}
+void JSON_NODE::_freeJSON_VALUE(JSON_VALUE& val)
+{
+    //Redirect
+    CJSON::_freeJSON_VALUE(val);
+}
+
+void CJSON::_freeJSON_VALUE(JSON_VALUE& val)
+{
+    switch(val.valType)
+    {
+    case JVT_ARRAY:
+        {
+            JSON_ARRAY* pJA = (JSON_ARRAY*)val.pValue;
+            ASSERT(pJA);
+            _freeJSON_ARRAY(pJA);
+        }
+        break;
+
+    case JVT_OBJECT:
+        {
+            JSON_OBJECT* pJO = (JSON_OBJECT*)val.pValue;
+            ASSERT(pJO);
+            _freeJSON_OBJECT(pJO);
+        }
+        break;
+            
+    default:
+        break;
+    }
+}
+
+
+void CJSON::_describeError(JSON_ERROR* pJError, intptr_t i, LPCTSTR pErrDesc)
+{
+    //Adds error description to 'pJError' if it's not there already
+    //INFO: In other words, it keeps only the first error info
+    if(pJError)
+    {
+        if(pJError->isEmpty())
+        {
+            pJError->nErrIndex = i;
+            pJError->strErrDesc = pErrDesc ? pErrDesc : L("");
+            pJError->markFilled();
+        }
+    }
+}
+
+
+bool JSON_NODE::parseFloat(LPCTSTR pStr, double* pfOutVal)
+{
+    //Redirect
+    return CJSON::parseFloat(pStr, pfOutVal);
+}
+
+bool CJSON::parseFloat(LPCTSTR pStr, double* pfOutVal)
+{
+    //Parse float value from 'pStr'
+    //INFO: Does not depend on the locale, '.' is always the decimal point
+    //'pfOutVal' = if not nullptr, receives value parsed
+    //RETURN:
+    //		= true if success
+    return parseDouble(pStr, pStr ? STRLEN(pStr) : 0, pfOutVal);
+}
+
+
+int JSON_NODE::parseInt64(const WCHAR* pStr, intptr_t nch, int64_t* piiOutVal)
+{
+    //Redirect
+    return CJSON::parseInt64(pStr, nch, piiOutVal);
+}
+
+int CJSON::parseInt64(const WCHAR* pStr, intptr_t nch, int64_t* piiOutVal)
+{
+    //Parse base-10 integer, such as: 123, -5, +007
+    //INFO: Does not depend on the locale
+    //'pStr' = text to parse (does not need to be null-terminated)
+    //'nch' = length of 'pStr' in TCHARs
+    //'piiOutVal' = if not nullptr, receives value parsed (clamped to INT64_MIN or INT64_MAX if it doesn't fit)
+    //RETURN:
+    //		= 1 if success
+    //		= 0 if 'pStr' is not an integer
+    //		= -1 if 'pStr' is an integer that doesn't fit into 64 bits
+    int64_t iiVal = 0;
+    int nRes = 0;
+
+    intptr_t i = 0;
+    bool bNegative = false;
+    if(nch > 0 &&
+        (pStr[0] == '-' || pStr[0] == '+'))
+    {
+        bNegative = pStr[0] == '-';
+        i++;
+    }
+
+    if(i < nch)
+    {
+        uint64_t uiVal = 0;
+        bool bOverflow = false;
+
+        for(; i < nch; i++)
+        {
+            UINT d = (UINT)pStr[i] - '0';
+            if(d > 9)
+                break;
+
+            //Up to 19 digits always fit, so check only after that
+            bOverflow |= uiVal > (UINT64_MAX - d) / 10;
+            uiVal = uiVal * 10 + d;
+        }
+
+        if(i >= nch)
+        {
+            //Magnitude of INT64_MIN is one more than INT64_MAX
+            const uint64_t uiMax = bNegative ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX;
+            if(!bOverflow &&
+                uiVal <= uiMax)
+            {
+                iiVal = bNegative ? (int64_t)(0 - uiVal) : (int64_t)uiVal;
+                nRes = 1;
+            }
+            else
+            {
+                iiVal = bNegative ? INT64_MIN : INT64_MAX;
+                nRes = -1;
+            }
+        }
+    }
+
+    if(piiOutVal)
+        *piiOutVal = iiVal;
+
+    return nRes;
+}
+
+
+//Significands of powers of 5 from 5^-342 to 5^308, normalized to 128 bits, used by CJSON::parseDouble()
+//INFO: Using the Eisel-Lemire algorithm, see "Number Parsing at a Gigabyte per Second" by Daniel Lemire
+#define JSON_POW5_MIN -342
+#define JSON_POW5_MAX 308
+
+static const struct
+{
+    uint64_t hi;
+    uint64_t lo;
+}
+g_arrPow5_128[] = {
+    { 0xeef453d6923bd65aULL, 0x113faa2906a13b3fULL }, { 0x9558b4661b6565f8ULL, 0x4ac7ca59a424c507ULL },
+    { 0xbaaee17fa23ebf76ULL, 0x5d79bcf00d2df649ULL }, { 0xe95a99df8ace6f53ULL, 0xf4d82c2c107973dcULL },
+    { 0x91d8a02bb6c10594ULL, 0x79071b9b8a4be869ULL }, { 0xb64ec836a47146f9ULL, 0x9748e2826cdee284ULL },
+    { 0xe3e27a444d8d98b7ULL, 0xfd1b1b2308169b25ULL }, { 0x8e6d8c6ab0787f72ULL, 0xfe30f0f5e50e20f7ULL },
+    { 0xb208ef855c969f4fULL, 0xbdbd2d335e51a935ULL }, { 0xde8b2b66b3bc4723ULL, 0xad2c788035e61382ULL },
+    { 0x8b16fb203055ac76ULL, 0x4c3bcb5021afcc31ULL }, { 0xaddcb9e83c6b1793ULL, 0xdf4abe242a1bbf3dULL },
+    { 0xd953e8624b85dd78ULL, 0xd71d6dad34a2af0dULL }, { 0x87d4713d6f33aa6bULL, 0x8672648c40e5ad68ULL },
+    { 0xa9c98d8ccb009506ULL, 0x680efdaf511f18c2ULL }, { 0xd43bf0effdc0ba48ULL, 0x0212bd1b2566def2ULL },
+    { 0x84a57695fe98746dULL, 0x014bb630f7604b57ULL }, { 0xa5ced43b7e3e9188ULL, 0x419ea3bd35385e2dULL },
+    { 0xcf42894a5dce35eaULL, 0x52064cac828675b9ULL }, { 0x818995ce7aa0e1b2ULL, 0x7343efebd1940993ULL },
+    { 0xa1ebfb4219491a1fULL, 0x1014ebe6c5f90bf8ULL }, { 0xca66fa129f9b60a6ULL, 0xd41a26e077774ef6ULL },
+    { 0xfd00b897478238d0ULL, 0x8920b098955522b4ULL }, { 0x9e20735e8cb16382ULL, 0x55b46e5f5d5535b0ULL },
+    { 0xc5a890362fddbc62ULL, 0xeb2189f734aa831dULL }, { 0xf712b443bbd52b7bULL, 0xa5e9ec7501d523e4ULL },
+    { 0x9a6bb0aa55653b2dULL, 0x47b233c92125366eULL }, { 0xc1069cd4eabe89f8ULL, 0x999ec0bb696e840aULL },
+    { 0xf148440a256e2c76ULL, 0xc00670ea43ca250dULL }, { 0x96cd2a865764dbcaULL, 0x380406926a5e5728ULL },
+    { 0xbc807527ed3e12bcULL, 0xc605083704f5ecf2ULL }, { 0xeba09271e88d976bULL, 0xf7864a44c633682eULL },
+    { 0x93445b8731587ea3ULL, 0x7ab3ee6afbe0211dULL }, { 0xb8157268fdae9e4cULL, 0x5960ea05bad82964ULL },
+    { 0xe61acf033d1a45dfULL, 0x6fb92487298e33bdULL }, { 0x8fd0c16206306babULL, 0xa5d3b6d479f8e056ULL },
+    { 0xb3c4f1ba87bc8696ULL, 0x8f48a4899877186cULL }, { 0xe0b62e2929aba83cULL, 0x331acdabfe94de87ULL },
+    { 0x8c71dcd9ba0b4925ULL, 0x9ff0c08b7f1d0b14ULL }, { 0xaf8e5410288e1b6fULL, 0x07ecf0ae5ee44dd9ULL },
+    { 0xdb71e91432b1a24aULL, 0xc9e82cd9f69d6150ULL }, { 0x892731ac9faf056eULL, 0xbe311c083a225cd2ULL },
+    { 0xab70fe17c79ac6caULL, 0x6dbd630a48aaf406ULL }, { 0xd64d3d9db981787dULL, 0x092cbbccdad5b108ULL },
+    { 0x85f0468293f0eb4eULL, 0x25bbf56008c58ea5ULL }, { 0xa76c582338ed2621ULL, 0xaf2af2b80af6f24eULL },
+    { 0xd1476e2c07286faaULL, 0x1af5af660db4aee1ULL }, { 0x82cca4db847945caULL, 0x50d98d9fc890ed4dULL },
+    { 0xa37fce126597973cULL, 0xe50ff107bab528a0ULL }, { 0xcc5fc196fefd7d0cULL, 0x1e53ed49a96272c8ULL },
+    { 0xff77b1fcbebcdc4fULL, 0x25e8e89c13bb0f7aULL }, { 0x9faacf3df73609b1ULL, 0x77b191618c54e9acULL },
+    { 0xc795830d75038c1dULL, 0xd59df5b9ef6a2417ULL }, { 0xf97ae3d0d2446f25ULL, 0x4b0573286b44ad1dULL },
+    { 0x9becce62836ac577ULL, 0x4ee367f9430aec32ULL }, { 0xc2e801fb244576d5ULL, 0x229c41f793cda73fULL },
+    { 0xf3a20279ed56d48aULL, 0x6b43527578c1110fULL }, { 0x9845418c345644d6ULL, 0x830a13896b78aaa9ULL },
+    { 0xbe5691ef416bd60cULL, 0x23cc986bc656d553ULL }, { 0xedec366b11c6cb8fULL, 0x2cbfbe86b7ec8aa8ULL },
+    { 0x94b3a202eb1c3f39ULL, 0x7bf7d71432f3d6a9ULL }, { 0xb9e08a83a5e34f07ULL, 0xdaf5ccd93fb0cc53ULL },
+    { 0xe858ad248f5c22c9ULL, 0xd1b3400f8f9cff68ULL }, { 0x91376c36d99995beULL, 0x23100809b9c21fa1ULL },
+    { 0xb58547448ffffb2dULL, 0xabd40a0c2832a78aULL }, { 0xe2e69915b3fff9f9ULL, 0x16c90c8f323f516cULL },
+    { 0x8dd01fad907ffc3bULL, 0xae3da7d97f6792e3ULL }, { 0xb1442798f49ffb4aULL, 0x99cd11cfdf41779cULL },
+    { 0xdd95317f31c7fa1dULL, 0x40405643d711d583ULL }, { 0x8a7d3eef7f1cfc52ULL, 0x482835ea666b2572ULL },
+    { 0xad1c8eab5ee43b66ULL, 0xda3243650005eecfULL }, { 0xd863b256369d4a40ULL, 0x90bed43e40076a82ULL },
+    { 0x873e4f75e2224e68ULL, 0x5a7744a6e804a291ULL }, { 0xa90de3535aaae202ULL, 0x711515d0a205cb36ULL },
+    { 0xd3515c2831559a83ULL, 0x0d5a5b44ca873e03ULL }, { 0x8412d9991ed58091ULL, 0xe858790afe9486c2ULL },
+    { 0xa5178fff668ae0b6ULL, 0x626e974dbe39a872ULL }, { 0xce5d73ff402d98e3ULL, 0xfb0a3d212dc8128fULL },
+    { 0x80fa687f881c7f8eULL, 0x7ce66634bc9d0b99ULL }, { 0xa139029f6a239f72ULL, 0x1c1fffc1ebc44e80ULL },
+    { 0xc987434744ac874eULL, 0xa327ffb266b56220ULL }, { 0xfbe9141915d7a922ULL, 0x4bf1ff9f0062baa8ULL },
+    { 0x9d71ac8fada6c9b5ULL, 0x6f773fc3603db4a9ULL }, { 0xc4ce17b399107c22ULL, 0xcb550fb4384d21d3ULL },
+    { 0xf6019da07f549b2bULL, 0x7e2a53a146606a48ULL }, { 0x99c102844f94e0fbULL, 0x2eda7444cbfc426dULL },
+    { 0xc0314325637a1939ULL, 0xfa911155fefb5308ULL }, { 0xf03d93eebc589f88ULL, 0x793555ab7eba27caULL },
+    { 0x96267c7535b763b5ULL, 0x4bc1558b2f3458deULL }, { 0xbbb01b9283253ca2ULL, 0x9eb1aaedfb016f16ULL },
+    { 0xea9c227723ee8bcbULL, 0x465e15a979c1cadcULL }, { 0x92a1958a7675175fULL, 0x0bfacd89ec191ec9ULL },
+    { 0xb749faed14125d36ULL, 0xcef980ec671f667bULL }, { 0xe51c79a85916f484ULL, 0x82b7e12780e7401aULL },
+    { 0x8f31cc0937ae58d2ULL, 0xd1b2ecb8b0908810ULL }, { 0xb2fe3f0b8599ef07ULL, 0x861fa7e6dcb4aa15ULL },
+    { 0xdfbdcece67006ac9ULL, 0x67a791e093e1d49aULL }, { 0x8bd6a141006042bdULL, 0xe0c8bb2c5c6d24e0ULL },
+    { 0xaecc49914078536dULL, 0x58fae9f773886e18ULL }, { 0xda7f5bf590966848ULL, 0xaf39a475506a899eULL },
+    { 0x888f99797a5e012dULL, 0x6d8406c952429603ULL }, { 0xaab37fd7d8f58178ULL, 0xc8e5087ba6d33b83ULL },
+    { 0xd5605fcdcf32e1d6ULL, 0xfb1e4a9a90880a64ULL }, { 0x855c3be0a17fcd26ULL, 0x5cf2eea09a55067fULL },
+    { 0xa6b34ad8c9dfc06fULL, 0xf42faa48c0ea481eULL }, { 0xd0601d8efc57b08bULL, 0xf13b94daf124da26ULL },
+    { 0x823c12795db6ce57ULL, 0x76c53d08d6b70858ULL }, { 0xa2cb1717b52481edULL, 0x54768c4b0c64ca6eULL },
+    { 0xcb7ddcdda26da268ULL, 0xa9942f5dcf7dfd09ULL }, { 0xfe5d54150b090b02ULL, 0xd3f93b35435d7c4cULL },
+    { 0x9efa548d26e5a6e1ULL, 0xc47bc5014a1a6dafULL }, { 0xc6b8e9b0709f109aULL, 0x359ab6419ca1091bULL },
+    { 0xf867241c8cc6d4c0ULL, 0xc30163d203c94b62ULL }, { 0x9b407691d7fc44f8ULL, 0x79e0de63425dcf1dULL },
+    { 0xc21094364dfb5636ULL, 0x985915fc12f542e4ULL }, { 0xf294b943e17a2bc4ULL, 0x3e6f5b7b17b2939dULL },
+    { 0x979cf3ca6cec5b5aULL, 0xa705992ceecf9c42ULL }, { 0xbd8430bd08277231ULL, 0x50c6ff782a838353ULL },
+    { 0xece53cec4a314ebdULL, 0xa4f8bf5635246428ULL }, { 0x940f4613ae5ed136ULL, 0x871b7795e136be99ULL },
+    { 0xb913179899f68584ULL, 0x28e2557b59846e3fULL }, { 0xe757dd7ec07426e5ULL, 0x331aeada2fe589cfULL },
+    { 0x9096ea6f3848984fULL, 0x3ff0d2c85def7621ULL }, { 0xb4bca50b065abe63ULL, 0x0fed077a756b53a9ULL },
+    { 0xe1ebce4dc7f16dfbULL, 0xd3e8495912c62894ULL }, { 0x8d3360f09cf6e4bdULL, 0x64712dd7abbbd95cULL },
+    { 0xb080392cc4349decULL, 0xbd8d794d96aacfb3ULL }, { 0xdca04777f541c567ULL, 0xecf0d7a0fc5583a0ULL },
+    { 0x89e42caaf9491b60ULL, 0xf41686c49db57244ULL }, { 0xac5d37d5b79b6239ULL, 0x311c2875c522ced5ULL },
+    { 0xd77485cb25823ac7ULL, 0x7d633293366b828bULL }, { 0x86a8d39ef77164bcULL, 0xae5dff9c02033197ULL },
+    { 0xa8530886b54dbdebULL, 0xd9f57f830283fdfcULL }, { 0xd267caa862a12d66ULL, 0xd072df63c324fd7bULL },
+    { 0x8380dea93da4bc60ULL, 0x4247cb9e59f71e6dULL }, { 0xa46116538d0deb78ULL, 0x52d9be85f074e608ULL },
+    { 0xcd795be870516656ULL, 0x67902e276c921f8bULL }, { 0x806bd9714632dff6ULL, 0x00ba1cd8a3db53b6ULL },
+    { 0xa086cfcd97bf97f3ULL, 0x80e8a40eccd228a4ULL }, { 0xc8a883c0fdaf7df0ULL, 0x6122cd128006b2cdULL },
+    { 0xfad2a4b13d1b5d6cULL, 0x796b805720085f81ULL }, { 0x9cc3a6eec6311a63ULL, 0xcbe3303674053bb0ULL },
+    { 0xc3f490aa77bd60fcULL, 0xbedbfc4411068a9cULL }, { 0xf4f1b4d515acb93bULL, 0xee92fb5515482d44ULL },
+    { 0x991711052d8bf3c5ULL, 0x751bdd152d4d1c4aULL }, { 0xbf5cd54678eef0b6ULL, 0xd262d45a78a0635dULL },
+    { 0xef340a98172aace4ULL, 0x86fb897116c87c34ULL }, { 0x9580869f0e7aac0eULL, 0xd45d35e6ae3d4da0ULL },
+    { 0xbae0a846d2195712ULL, 0x8974836059cca109ULL }, { 0xe998d258869facd7ULL, 0x2bd1a438703fc94bULL },
+    { 0x91ff83775423cc06ULL, 0x7b6306a34627ddcfULL }, { 0xb67f6455292cbf08ULL, 0x1a3bc84c17b1d542ULL },
+    { 0xe41f3d6a7377eecaULL, 0x20caba5f1d9e4a93ULL }, { 0x8e938662882af53eULL, 0x547eb47b7282ee9cULL },
+    { 0xb23867fb2a35b28dULL, 0xe99e619a4f23aa43ULL }, { 0xdec681f9f4c31f31ULL, 0x6405fa00e2ec94d4ULL },
+    { 0x8b3c113c38f9f37eULL, 0xde83bc408dd3dd04ULL }, { 0xae0b158b4738705eULL, 0x9624ab50b148d445ULL },
+    { 0xd98ddaee19068c76ULL, 0x3badd624dd9b0957ULL }, { 0x87f8a8d4cfa417c9ULL, 0xe54ca5d70a80e5d6ULL },
+    { 0xa9f6d30a038d1dbcULL, 0x5e9fcf4ccd211f4cULL }, { 0xd47487cc8470652bULL, 0x7647c3200069671fULL },
+    { 0x84c8d4dfd2c63f3bULL, 0x29ecd9f40041e073ULL }, { 0xa5fb0a17c777cf09ULL, 0xf468107100525890ULL },
+    { 0xcf79cc9db955c2ccULL, 0x7182148d4066eeb4ULL }, { 0x81ac1fe293d599bfULL, 0xc6f14cd848405530ULL },
+    { 0xa21727db38cb002fULL, 0xb8ada00e5a506a7cULL }, { 0xca9cf1d206fdc03bULL, 0xa6d90811f0e4851cULL },
+    { 0xfd442e4688bd304aULL, 0x908f4a166d1da663ULL }, { 0x9e4a9cec15763e2eULL, 0x9a598e4e043287feULL },
+    { 0xc5dd44271ad3cdbaULL, 0x40eff1e1853f29fdULL }, { 0xf7549530e188c128ULL, 0xd12bee59e68ef47cULL },
+    { 0x9a94dd3e8cf578b9ULL, 0x82bb74f8301958ceULL }, { 0xc13a148e3032d6e7ULL, 0xe36a52363c1faf01ULL },
+    { 0xf18899b1bc3f8ca1ULL, 0xdc44e6c3cb279ac1ULL }, { 0x96f5600f15a7b7e5ULL, 0x29ab103a5ef8c0b9ULL },
+    { 0xbcb2b812db11a5deULL, 0x7415d448f6b6f0e7ULL }, { 0xebdf661791d60f56ULL, 0x111b495b3464ad21ULL },
+    { 0x936b9fcebb25c995ULL, 0xcab10dd900beec34ULL }, { 0xb84687c269ef3bfbULL, 0x3d5d514f40eea742ULL },
+    { 0xe65829b3046b0afaULL, 0x0cb4a5a3112a5112ULL }, { 0x8ff71a0fe2c2e6dcULL, 0x47f0e785eaba72abULL },
+    { 0xb3f4e093db73a093ULL, 0x59ed216765690f56ULL }, { 0xe0f218b8d25088b8ULL, 0x306869c13ec3532cULL },
+    { 0x8c974f7383725573ULL, 0x1e414218c73a13fbULL }, { 0xafbd2350644eeacfULL, 0xe5d1929ef90898faULL },
+    { 0xdbac6c247d62a583ULL, 0xdf45f746b74abf39ULL }, { 0x894bc396ce5da772ULL, 0x6b8bba8c328eb783ULL },
+    { 0xab9eb47c81f5114fULL, 0x066ea92f3f326564ULL }, { 0xd686619ba27255a2ULL, 0xc80a537b0efefebdULL },
+    { 0x8613fd0145877585ULL, 0xbd06742ce95f5f36ULL }, { 0xa798fc4196e952e7ULL, 0x2c48113823b73704ULL },
+    { 0xd17f3b51fca3a7a0ULL, 0xf75a15862ca504c5ULL }, { 0x82ef85133de648c4ULL, 0x9a984d73dbe722fbULL },
+    { 0xa3ab66580d5fdaf5ULL, 0xc13e60d0d2e0ebbaULL }, { 0xcc963fee10b7d1b3ULL, 0x318df905079926a8ULL },
+    { 0xffbbcfe994e5c61fULL, 0xfdf17746497f7052ULL }, { 0x9fd561f1fd0f9bd3ULL, 0xfeb6ea8bedefa633ULL },
+    { 0xc7caba6e7c5382c8ULL, 0xfe64a52ee96b8fc0ULL }, { 0xf9bd690a1b68637bULL, 0x3dfdce7aa3c673b0ULL },
+    { 0x9c1661a651213e2dULL, 0x06bea10ca65c084eULL }, { 0xc31bfa0fe5698db8ULL, 0x486e494fcff30a62ULL },
+    { 0xf3e2f893dec3f126ULL, 0x5a89dba3c3efccfaULL }, { 0x986ddb5c6b3a76b7ULL, 0xf89629465a75e01cULL },
+    { 0xbe89523386091465ULL, 0xf6bbb397f1135823ULL }, { 0xee2ba6c0678b597fULL, 0x746aa07ded582e2cULL },
+    { 0x94db483840b717efULL, 0xa8c2a44eb4571cdcULL }, { 0xba121a4650e4ddebULL, 0x92f34d62616ce413ULL },
+    { 0xe896a0d7e51e1566ULL, 0x77b020baf9c81d17ULL }, { 0x915e2486ef32cd60ULL, 0x0ace1474dc1d122eULL },
+    { 0xb5b5ada8aaff80b8ULL, 0x0d819992132456baULL }, { 0xe3231912d5bf60e6ULL, 0x10e1fff697ed6c69ULL },
+    { 0x8df5efabc5979c8fULL, 0xca8d3ffa1ef463c1ULL }, { 0xb1736b96b6fd83b3ULL, 0xbd308ff8a6b17cb2ULL },
+    { 0xddd0467c64bce4a0ULL, 0xac7cb3f6d05ddbdeULL }, { 0x8aa22c0dbef60ee4ULL, 0x6bcdf07a423aa96bULL },
+    { 0xad4ab7112eb3929dULL, 0x86c16c98d2c953c6ULL }, { 0xd89d64d57a607744ULL, 0xe871c7bf077ba8b7ULL },
+    { 0x87625f056c7c4a8bULL, 0x11471cd764ad4972ULL }, { 0xa93af6c6c79b5d2dULL, 0xd598e40d3dd89bcfULL },
+    { 0xd389b47879823479ULL, 0x4aff1d108d4ec2c3ULL }, { 0x843610cb4bf160cbULL, 0xcedf722a585139baULL },
+    { 0xa54394fe1eedb8feULL, 0xc2974eb4ee658828ULL }, { 0xce947a3da6a9273eULL, 0x733d226229feea32ULL },
+    { 0x811ccc668829b887ULL, 0x0806357d5a3f525fULL }, { 0xa163ff802a3426a8ULL, 0xca07c2dcb0cf26f7ULL },
+    { 0xc9bcff6034c13052ULL, 0xfc89b393dd02f0b5ULL }, { 0xfc2c3f3841f17c67ULL, 0xbbac2078d443ace2ULL },
+    { 0x9d9ba7832936edc0ULL, 0xd54b944b84aa4c0dULL }, { 0xc5029163f384a931ULL, 0x0a9e795e65d4df11ULL },
+    { 0xf64335bcf065d37dULL, 0x4d4617b5ff4a16d5ULL }, { 0x99ea0196163fa42eULL, 0x504bced1bf8e4e45ULL },
+    { 0xc06481fb9bcf8d39ULL, 0xe45ec2862f71e1d6ULL }, { 0xf07da27a82c37088ULL, 0x5d767327bb4e5a4cULL },
+    { 0x964e858c91ba2655ULL, 0x3a6a07f8d510f86fULL }, { 0xbbe226efb628afeaULL, 0x890489f70a55368bULL },
+    { 0xeadab0aba3b2dbe5ULL, 0x2b45ac74ccea842eULL }, { 0x92c8ae6b464fc96fULL, 0x3b0b8bc90012929dULL },
+    { 0xb77ada0617e3bbcbULL, 0x09ce6ebb40173744ULL }, { 0xe55990879ddcaabdULL, 0xcc420a6a101d0515ULL },
+    { 0x8f57fa54c2a9eab6ULL, 0x9fa946824a12232dULL }, { 0xb32df8e9f3546564ULL, 0x47939822dc96abf9ULL },
+    { 0xdff9772470297ebdULL, 0x59787e2b93bc56f7ULL }, { 0x8bfbea76c619ef36ULL, 0x57eb4edb3c55b65aULL },
+    { 0xaefae51477a06b03ULL, 0xede622920b6b23f1ULL }, { 0xdab99e59958885c4ULL, 0xe95fab368e45ecedULL },
+    { 0x88b402f7fd75539bULL, 0x11dbcb0218ebb414ULL }, { 0xaae103b5fcd2a881ULL, 0xd652bdc29f26a119ULL },
+    { 0xd59944a37c0752a2ULL, 0x4be76d3346f0495fULL }, { 0x857fcae62d8493a5ULL, 0x6f70a4400c562ddbULL },
+    { 0xa6dfbd9fb8e5b88eULL, 0xcb4ccd500f6bb952ULL }, { 0xd097ad07a71f26b2ULL, 0x7e2000a41346a7a7ULL },
+    { 0x825ecc24c873782fULL, 0x8ed400668c0c28c8ULL }, { 0xa2f67f2dfa90563bULL, 0x728900802f0f32faULL },
+    { 0xcbb41ef979346bcaULL, 0x4f2b40a03ad2ffb9ULL }, { 0xfea126b7d78186bcULL, 0xe2f610c84987bfa8ULL },
+    { 0x9f24b832e6b0f436ULL, 0x0dd9ca7d2df4d7c9ULL }, { 0xc6ede63fa05d3143ULL, 0x91503d1c79720dbbULL },
+    { 0xf8a95fcf88747d94ULL, 0x75a44c6397ce912aULL }, { 0x9b69dbe1b548ce7cULL, 0xc986afbe3ee11abaULL },
+    { 0xc24452da229b021bULL, 0xfbe85badce996168ULL }, { 0xf2d56790ab41c2a2ULL, 0xfae27299423fb9c3ULL },
+    { 0x97c560ba6b0919a5ULL, 0xdccd879fc967d41aULL }, { 0xbdb6b8e905cb600fULL, 0x5400e987bbc1c920ULL },
+    { 0xed246723473e3813ULL, 0x290123e9aab23b68ULL }, { 0x9436c0760c86e30bULL, 0xf9a0b6720aaf6521ULL },
+    { 0xb94470938fa89bceULL, 0xf808e40e8d5b3e69ULL }, { 0xe7958cb87392c2c2ULL, 0xb60b1d1230b20e04ULL },
+    { 0x90bd77f3483bb9b9ULL, 0xb1c6f22b5e6f48c2ULL }, { 0xb4ecd5f01a4aa828ULL, 0x1e38aeb6360b1af3ULL },
+    { 0xe2280b6c20dd5232ULL, 0x25c6da63c38de1b0ULL }, { 0x8d590723948a535fULL, 0x579c487e5a38ad0eULL },
+    { 0xb0af48ec79ace837ULL, 0x2d835a9df0c6d851ULL }, { 0xdcdb1b2798182244ULL, 0xf8e431456cf88e65ULL },
+    { 0x8a08f0f8bf0f156bULL, 0x1b8e9ecb641b58ffULL }, { 0xac8b2d36eed2dac5ULL, 0xe272467e3d222f3fULL },
+    { 0xd7adf884aa879177ULL, 0x5b0ed81dcc6abb0fULL }, { 0x86ccbb52ea94baeaULL, 0x98e947129fc2b4e9ULL },
+    { 0xa87fea27a539e9a5ULL, 0x3f2398d747b36224ULL }, { 0xd29fe4b18e88640eULL, 0x8eec7f0d19a03aadULL },
+    { 0x83a3eeeef9153e89ULL, 0x1953cf68300424acULL }, { 0xa48ceaaab75a8e2bULL, 0x5fa8c3423c052dd7ULL },
+    { 0xcdb02555653131b6ULL, 0x3792f412cb06794dULL }, { 0x808e17555f3ebf11ULL, 0xe2bbd88bbee40bd0ULL },
+    { 0xa0b19d2ab70e6ed6ULL, 0x5b6aceaeae9d0ec4ULL }, { 0xc8de047564d20a8bULL, 0xf245825a5a445275ULL },
+    { 0xfb158592be068d2eULL, 0xeed6e2f0f0d56712ULL }, { 0x9ced737bb6c4183dULL, 0x55464dd69685606bULL },
+    { 0xc428d05aa4751e4cULL, 0xaa97e14c3c26b886ULL }, { 0xf53304714d9265dfULL, 0xd53dd99f4b3066a8ULL },
+    { 0x993fe2c6d07b7fabULL, 0xe546a8038efe4029ULL }, { 0xbf8fdb78849a5f96ULL, 0xde98520472bdd033ULL },
+    { 0xef73d256a5c0f77cULL, 0x963e66858f6d4440ULL }, { 0x95a8637627989aadULL, 0xdde7001379a44aa8ULL },
+    { 0xbb127c53b17ec159ULL, 0x5560c018580d5d52ULL }, { 0xe9d71b689dde71afULL, 0xaab8f01e6e10b4a6ULL },
+    { 0x9226712162ab070dULL, 0xcab3961304ca70e8ULL }, { 0xb6b00d69bb55c8d1ULL, 0x3d607b97c5fd0d22ULL },
+    { 0xe45c10c42a2b3b05ULL, 0x8cb89a7db77c506aULL }, { 0x8eb98a7a9a5b04e3ULL, 0x77f3608e92adb242ULL },
+    { 0xb267ed1940f1c61cULL, 0x55f038b237591ed3ULL }, { 0xdf01e85f912e37a3ULL, 0x6b6c46dec52f6688ULL },
+    { 0x8b61313bbabce2c6ULL, 0x2323ac4b3b3da015ULL }, { 0xae397d8aa96c1b77ULL, 0xabec975e0a0d081aULL },
+    { 0xd9c7dced53c72255ULL, 0x96e7bd358c904a21ULL }, { 0x881cea14545c7575ULL, 0x7e50d64177da2e54ULL },
+    { 0xaa242499697392d2ULL, 0xdde50bd1d5d0b9e9ULL }, { 0xd4ad2dbfc3d07787ULL, 0x955e4ec64b44e864ULL },
+    { 0x84ec3c97da624ab4ULL, 0xbd5af13bef0b113eULL }, { 0xa6274bbdd0fadd61ULL, 0xecb1ad8aeacdd58eULL },
+    { 0xcfb11ead453994baULL, 0x67de18eda5814af2ULL }, { 0x81ceb32c4b43fcf4ULL, 0x80eacf948770ced7ULL },
+    { 0xa2425ff75e14fc31ULL, 0xa1258379a94d028dULL }, { 0xcad2f7f5359a3b3eULL, 0x096ee45813a04330ULL },
+    { 0xfd87b5f28300ca0dULL, 0x8bca9d6e188853fcULL }, { 0x9e74d1b791e07e48ULL, 0x775ea264cf55347eULL },
+    { 0xc612062576589ddaULL, 0x95364afe032a819eULL }, { 0xf79687aed3eec551ULL, 0x3a83ddbd83f52205ULL },
+    { 0x9abe14cd44753b52ULL, 0xc4926a9672793543ULL }, { 0xc16d9a0095928a27ULL, 0x75b7053c0f178294ULL },
+    { 0xf1c90080baf72cb1ULL, 0x5324c68b12dd6339ULL }, { 0x971da05074da7beeULL, 0xd3f6fc16ebca5e04ULL },
+    { 0xbce5086492111aeaULL, 0x88f4bb1ca6bcf585ULL }, { 0xec1e4a7db69561a5ULL, 0x2b31e9e3d06c32e6ULL },
+    { 0x9392ee8e921d5d07ULL, 0x3aff322e62439fd0ULL }, { 0xb877aa3236a4b449ULL, 0x09befeb9fad487c3ULL },
+    { 0xe69594bec44de15bULL, 0x4c2ebe687989a9b4ULL }, { 0x901d7cf73ab0acd9ULL, 0x0f9d37014bf60a11ULL },
+    { 0xb424dc35095cd80fULL, 0x538484c19ef38c95ULL }, { 0xe12e13424bb40e13ULL, 0x2865a5f206b06fbaULL },
+    { 0x8cbccc096f5088cbULL, 0xf93f87b7442e45d4ULL }, { 0xafebff0bcb24aafeULL, 0xf78f69a51539d749ULL },
+    { 0xdbe6fecebdedd5beULL, 0xb573440e5a884d1cULL }, { 0x89705f4136b4a597ULL, 0x31680a88f8953031ULL },
+    { 0xabcc77118461cefcULL, 0xfdc20d2b36ba7c3eULL }, { 0xd6bf94d5e57a42bcULL, 0x3d32907604691b4dULL },
+    { 0x8637bd05af6c69b5ULL, 0xa63f9a49c2c1b110ULL }, { 0xa7c5ac471b478423ULL, 0x0fcf80dc33721d54ULL },
+    { 0xd1b71758e219652bULL, 0xd3c36113404ea4a9ULL }, { 0x83126e978d4fdf3bULL, 0x645a1cac083126eaULL },
+    { 0xa3d70a3d70a3d70aULL, 0x3d70a3d70a3d70a4ULL }, { 0xccccccccccccccccULL, 0xcccccccccccccccdULL },
+    { 0x8000000000000000ULL, 0x0000000000000000ULL }, { 0xa000000000000000ULL, 0x0000000000000000ULL },
+    { 0xc800000000000000ULL, 0x0000000000000000ULL }, { 0xfa00000000000000ULL, 0x0000000000000000ULL },
+    { 0x9c40000000000000ULL, 0x0000000000000000ULL }, { 0xc350000000000000ULL, 0x0000000000000000ULL },
+    { 0xf424000000000000ULL, 0x0000000000000000ULL }, { 0x9896800000000000ULL, 0x0000000000000000ULL },
+    { 0xbebc200000000000ULL, 0x0000000000000000ULL }, { 0xee6b280000000000ULL, 0x0000000000000000ULL },
+    { 0x9502f90000000000ULL, 0x0000000000000000ULL }, { 0xba43b74000000000ULL, 0x0000000000000000ULL },
+    { 0xe8d4a51000000000ULL, 0x0000000000000000ULL }, { 0x9184e72a00000000ULL, 0x0000000000000000ULL },
+    { 0xb5e620f480000000ULL, 0x0000000000000000ULL }, { 0xe35fa931a0000000ULL, 0x0000000000000000ULL },
+    { 0x8e1bc9bf04000000ULL, 0x0000000000000000ULL }, { 0xb1a2bc2ec5000000ULL, 0x0000000000000000ULL },
+    { 0xde0b6b3a76400000ULL, 0x0000000000000000ULL }, { 0x8ac7230489e80000ULL, 0x0000000000000000ULL },
+    { 0xad78ebc5ac620000ULL, 0x0000000000000000ULL }, { 0xd8d726b7177a8000ULL, 0x0000000000000000ULL },
+    { 0x878678326eac9000ULL, 0x0000000000000000ULL }, { 0xa968163f0a57b400ULL, 0x0000000000000000ULL },
+    { 0xd3c21bcecceda100ULL, 0x0000000000000000ULL }, { 0x84595161401484a0ULL, 0x0000000000000000ULL },
+    { 0xa56fa5b99019a5c8ULL, 0x0000000000000000ULL }, { 0xcecb8f27f4200f3aULL, 0x0000000000000000ULL },
+    { 0x813f3978f8940984ULL, 0x4000000000000000ULL }, { 0xa18f07d736b90be5ULL, 0x5000000000000000ULL },
+    { 0xc9f2c9cd04674edeULL, 0xa400000000000000ULL }, { 0xfc6f7c4045812296ULL, 0x4d00000000000000ULL },
+    { 0x9dc5ada82b70b59dULL, 0xf020000000000000ULL }, { 0xc5371912364ce305ULL, 0x6c28000000000000ULL },
+    { 0xf684df56c3e01bc6ULL, 0xc732000000000000ULL }, { 0x9a130b963a6c115cULL, 0x3c7f400000000000ULL },
+    { 0xc097ce7bc90715b3ULL, 0x4b9f100000000000ULL }, { 0xf0bdc21abb48db20ULL, 0x1e86d40000000000ULL },
+    { 0x96769950b50d88f4ULL, 0x1314448000000000ULL }, { 0xbc143fa4e250eb31ULL, 0x17d955a000000000ULL },
+    { 0xeb194f8e1ae525fdULL, 0x5dcfab0800000000ULL }, { 0x92efd1b8d0cf37beULL, 0x5aa1cae500000000ULL },
+    { 0xb7abc627050305adULL, 0xf14a3d9e40000000ULL }, { 0xe596b7b0c643c719ULL, 0x6d9ccd05d0000000ULL },
+    { 0x8f7e32ce7bea5c6fULL, 0xe4820023a2000000ULL }, { 0xb35dbf821ae4f38bULL, 0xdda2802c8a800000ULL },
+    { 0xe0352f62a19e306eULL, 0xd50b2037ad200000ULL }, { 0x8c213d9da502de45ULL, 0x4526f422cc340000ULL },
+    { 0xaf298d050e4395d6ULL, 0x9670b12b7f410000ULL }, { 0xdaf3f04651d47b4cULL, 0x3c0cdd765f114000ULL },
+    { 0x88d8762bf324cd0fULL, 0xa5880a69fb6ac800ULL }, { 0xab0e93b6efee0053ULL, 0x8eea0d047a457a00ULL },
+    { 0xd5d238a4abe98068ULL, 0x72a4904598d6d880ULL }, { 0x85a36366eb71f041ULL, 0x47a6da2b7f864750ULL },
+    { 0xa70c3c40a64e6c51ULL, 0x999090b65f67d924ULL }, { 0xd0cf4b50cfe20765ULL, 0xfff4b4e3f741cf6dULL },
+    { 0x82818f1281ed449fULL, 0xbff8f10e7a8921a4ULL }, { 0xa321f2d7226895c7ULL, 0xaff72d52192b6a0dULL },
+    { 0xcbea6f8ceb02bb39ULL, 0x9bf4f8a69f764490ULL }, { 0xfee50b7025c36a08ULL, 0x02f236d04753d5b4ULL },
+    { 0x9f4f2726179a2245ULL, 0x01d762422c946590ULL }, { 0xc722f0ef9d80aad6ULL, 0x424d3ad2b7b97ef5ULL },
+    { 0xf8ebad2b84e0d58bULL, 0xd2e0898765a7deb2ULL }, { 0x9b934c3b330c8577ULL, 0x63cc55f49f88eb2fULL },
+    { 0xc2781f49ffcfa6d5ULL, 0x3cbf6b71c76b25fbULL }, { 0xf316271c7fc3908aULL, 0x8bef464e3945ef7aULL },
+    { 0x97edd871cfda3a56ULL, 0x97758bf0e3cbb5acULL }, { 0xbde94e8e43d0c8ecULL, 0x3d52eeed1cbea317ULL },
+    { 0xed63a231d4c4fb27ULL, 0x4ca7aaa863ee4bddULL }, { 0x945e455f24fb1cf8ULL, 0x8fe8caa93e74ef6aULL },
+    { 0xb975d6b6ee39e436ULL, 0xb3e2fd538e122b44ULL }, { 0xe7d34c64a9c85d44ULL, 0x60dbbca87196b616ULL },
+    { 0x90e40fbeea1d3a4aULL, 0xbc8955e946fe31cdULL }, { 0xb51d13aea4a488ddULL, 0x6babab6398bdbe41ULL },
+    { 0xe264589a4dcdab14ULL, 0xc696963c7eed2dd1ULL }, { 0x8d7eb76070a08aecULL, 0xfc1e1de5cf543ca2ULL },
+    { 0xb0de65388cc8ada8ULL, 0x3b25a55f43294bcbULL }, { 0xdd15fe86affad912ULL, 0x49ef0eb713f39ebeULL },
+    { 0x8a2dbf142dfcc7abULL, 0x6e3569326c784337ULL }, { 0xacb92ed9397bf996ULL, 0x49c2c37f07965404ULL },
+    { 0xd7e77a8f87daf7fbULL, 0xdc33745ec97be906ULL }, { 0x86f0ac99b4e8dafdULL, 0x69a028bb3ded71a3ULL },
+    { 0xa8acd7c0222311bcULL, 0xc40832ea0d68ce0cULL }, { 0xd2d80db02aabd62bULL, 0xf50a3fa490c30190ULL },
+    { 0x83c7088e1aab65dbULL, 0x792667c6da79e0faULL }, { 0xa4b8cab1a1563f52ULL, 0x577001b891185938ULL },
+    { 0xcde6fd5e09abcf26ULL, 0xed4c0226b55e6f86ULL }, { 0x80b05e5ac60b6178ULL, 0x544f8158315b05b4ULL },
+    { 0xa0dc75f1778e39d6ULL, 0x696361ae3db1c721ULL }, { 0xc913936dd571c84cULL, 0x03bc3a19cd1e38e9ULL },
+    { 0xfb5878494ace3a5fULL, 0x04ab48a04065c723ULL }, { 0x9d174b2dcec0e47bULL, 0x62eb0d64283f9c76ULL },
+    { 0xc45d1df942711d9aULL, 0x3ba5d0bd324f8394ULL }, { 0xf5746577930d6500ULL, 0xca8f44ec7ee36479ULL },
+    { 0x9968bf6abbe85f20ULL, 0x7e998b13cf4e1ecbULL }, { 0xbfc2ef456ae276e8ULL, 0x9e3fedd8c321a67eULL },
+    { 0xefb3ab16c59b14a2ULL, 0xc5cfe94ef3ea101eULL }, { 0x95d04aee3b80ece5ULL, 0xbba1f1d158724a12ULL },
+    { 0xbb445da9ca61281fULL, 0x2a8a6e45ae8edc97ULL }, { 0xea1575143cf97226ULL, 0xf52d09d71a3293bdULL },
+    { 0x924d692ca61be758ULL, 0x593c2626705f9c56ULL }, { 0xb6e0c377cfa2e12eULL, 0x6f8b2fb00c77836cULL },
+    { 0xe498f455c38b997aULL, 0x0b6dfb9c0f956447ULL }, { 0x8edf98b59a373fecULL, 0x4724bd4189bd5eacULL },
+    { 0xb2977ee300c50fe7ULL, 0x58edec91ec2cb657ULL }, { 0xdf3d5e9bc0f653e1ULL, 0x2f2967b66737e3edULL },
+    { 0x8b865b215899f46cULL, 0xbd79e0d20082ee74ULL }, { 0xae67f1e9aec07187ULL, 0xecd8590680a3aa11ULL },
+    { 0xda01ee641a708de9ULL, 0xe80e6f4820cc9495ULL }, { 0x884134fe908658b2ULL, 0x3109058d147fdcddULL },
+    { 0xaa51823e34a7eedeULL, 0xbd4b46f0599fd415ULL }, { 0xd4e5e2cdc1d1ea96ULL, 0x6c9e18ac7007c91aULL },
+    { 0x850fadc09923329eULL, 0x03e2cf6bc604ddb0ULL }, { 0xa6539930bf6bff45ULL, 0x84db8346b786151cULL },
+    { 0xcfe87f7cef46ff16ULL, 0xe612641865679a63ULL }, { 0x81f14fae158c5f6eULL, 0x4fcb7e8f3f60c07eULL },
+    { 0xa26da3999aef7749ULL, 0xe3be5e330f38f09dULL }, { 0xcb090c8001ab551cULL, 0x5cadf5bfd3072cc5ULL },
+    { 0xfdcb4fa002162a63ULL, 0x73d9732fc7c8f7f6ULL }, { 0x9e9f11c4014dda7eULL, 0x2867e7fddcdd9afaULL },
+    { 0xc646d63501a1511dULL, 0xb281e1fd541501b8ULL }, { 0xf7d88bc24209a565ULL, 0x1f225a7ca91a4226ULL },
+    { 0x9ae757596946075fULL, 0x3375788de9b06958ULL }, { 0xc1a12d2fc3978937ULL, 0x0052d6b1641c83aeULL },
+    { 0xf209787bb47d6b84ULL, 0xc0678c5dbd23a49aULL }, { 0x9745eb4d50ce6332ULL, 0xf840b7ba963646e0ULL },
+    { 0xbd176620a501fbffULL, 0xb650e5a93bc3d898ULL }, { 0xec5d3fa8ce427affULL, 0xa3e51f138ab4cebeULL },
+    { 0x93ba47c980e98cdfULL, 0xc66f336c36b10137ULL }, { 0xb8a8d9bbe123f017ULL, 0xb80b0047445d4184ULL },
+    { 0xe6d3102ad96cec1dULL, 0xa60dc059157491e5ULL }, { 0x9043ea1ac7e41392ULL, 0x87c89837ad68db2fULL },
+    { 0xb454e4a179dd1877ULL, 0x29babe4598c311fbULL }, { 0xe16a1dc9d8545e94ULL, 0xf4296dd6fef3d67aULL },
+    { 0x8ce2529e2734bb1dULL, 0x1899e4a65f58660cULL }, { 0xb01ae745b101e9e4ULL, 0x5ec05dcff72e7f8fULL },
+    { 0xdc21a1171d42645dULL, 0x76707543f4fa1f73ULL }, { 0x899504ae72497ebaULL, 0x6a06494a791c53a8ULL },
+    { 0xabfa45da0edbde69ULL, 0x0487db9d17636892ULL }, { 0xd6f8d7509292d603ULL, 0x45a9d2845d3c42b6ULL },
+    { 0x865b86925b9bc5c2ULL, 0x0b8a2392ba45a9b2ULL }, { 0xa7f26836f282b732ULL, 0x8e6cac7768d7141eULL },
+    { 0xd1ef0244af2364ffULL, 0x3207d795430cd926ULL }, { 0x8335616aed761f1fULL, 0x7f44e6bd49e807b8ULL },
+    { 0xa402b9c5a8d3a6e7ULL, 0x5f16206c9c6209a6ULL }, { 0xcd036837130890a1ULL, 0x36dba887c37a8c0fULL },
+    { 0x802221226be55a64ULL, 0xc2494954da2c9789ULL }, { 0xa02aa96b06deb0fdULL, 0xf2db9baa10b7bd6cULL },
+    { 0xc83553c5c8965d3dULL, 0x6f92829494e5acc7ULL }, { 0xfa42a8b73abbf48cULL, 0xcb772339ba1f17f9ULL },
+    { 0x9c69a97284b578d7ULL, 0xff2a760414536efbULL }, { 0xc38413cf25e2d70dULL, 0xfef5138519684abaULL },
+    { 0xf46518c2ef5b8cd1ULL, 0x7eb258665fc25d69ULL }, { 0x98bf2f79d5993802ULL, 0xef2f773ffbd97a61ULL },
+    { 0xbeeefb584aff8603ULL, 0xaafb550ffacfd8faULL }, { 0xeeaaba2e5dbf6784ULL, 0x95ba2a53f983cf38ULL },
+    { 0x952ab45cfa97a0b2ULL, 0xdd945a747bf26183ULL }, { 0xba756174393d88dfULL, 0x94f971119aeef9e4ULL },
+    { 0xe912b9d1478ceb17ULL, 0x7a37cd5601aab85dULL }, { 0x91abb422ccb812eeULL, 0xac62e055c10ab33aULL },
+    { 0xb616a12b7fe617aaULL, 0x577b986b314d6009ULL }, { 0xe39c49765fdf9d94ULL, 0xed5a7e85fda0b80bULL },
+    { 0x8e41ade9fbebc27dULL, 0x14588f13be847307ULL }, { 0xb1d219647ae6b31cULL, 0x596eb2d8ae258fc8ULL },
+    { 0xde469fbd99a05fe3ULL, 0x6fca5f8ed9aef3bbULL }, { 0x8aec23d680043beeULL, 0x25de7bb9480d5854ULL },
+    { 0xada72ccc20054ae9ULL, 0xaf561aa79a10ae6aULL }, { 0xd910f7ff28069da4ULL, 0x1b2ba1518094da04ULL },
+    { 0x87aa9aff79042286ULL, 0x90fb44d2f05d0842ULL }, { 0xa99541bf57452b28ULL, 0x353a1607ac744a53ULL },
+    { 0xd3fa922f2d1675f2ULL, 0x42889b8997915ce8ULL }, { 0x847c9b5d7c2e09b7ULL, 0x69956135febada11ULL },
+    { 0xa59bc234db398c25ULL, 0x43fab9837e699095ULL }, { 0xcf02b2c21207ef2eULL, 0x94f967e45e03f4bbULL },
+    { 0x8161afb94b44f57dULL, 0x1d1be0eebac278f5ULL }, { 0xa1ba1ba79e1632dcULL, 0x6462d92a69731732ULL },
+    { 0xca28a291859bbf93ULL, 0x7d7b8f7503cfdcfeULL }, { 0xfcb2cb35e702af78ULL, 0x5cda735244c3d43eULL },
+    { 0x9defbf01b061adabULL, 0x3a0888136afa64a7ULL }, { 0xc56baec21c7a1916ULL, 0x088aaa1845b8fdd0ULL },
+    { 0xf6c69a72a3989f5bULL, 0x8aad549e57273d45ULL }, { 0x9a3c2087a63f6399ULL, 0x36ac54e2f678864bULL },
+    { 0xc0cb28a98fcf3c7fULL, 0x84576a1bb416a7ddULL }, { 0xf0fdf2d3f3c30b9fULL, 0x656d44a2a11c51d5ULL },
+    { 0x969eb7c47859e743ULL, 0x9f644ae5a4b1b325ULL }, { 0xbc4665b596706114ULL, 0x873d5d9f0dde1feeULL },
+    { 0xeb57ff22fc0c7959ULL, 0xa90cb506d155a7eaULL }, { 0x9316ff75dd87cbd8ULL, 0x09a7f12442d588f2ULL },
+    { 0xb7dcbf5354e9beceULL, 0x0c11ed6d538aeb2fULL }, { 0xe5d3ef282a242e81ULL, 0x8f1668c8a86da5faULL },
+    { 0x8fa475791a569d10ULL, 0xf96e017d694487bcULL }, { 0xb38d92d760ec4455ULL, 0x37c981dcc395a9acULL },
+    { 0xe070f78d3927556aULL, 0x85bbe253f47b1417ULL }, { 0x8c469ab843b89562ULL, 0x93956d7478ccec8eULL },
+    { 0xaf58416654a6babbULL, 0x387ac8d1970027b2ULL }, { 0xdb2e51bfe9d0696aULL, 0x06997b05fcc0319eULL },
+    { 0x88fcf317f22241e2ULL, 0x441fece3bdf81f03ULL }, { 0xab3c2fddeeaad25aULL, 0xd527e81cad7626c3ULL },
+    { 0xd60b3bd56a5586f1ULL, 0x8a71e223d8d3b074ULL }, { 0x85c7056562757456ULL, 0xf6872d5667844e49ULL },
+    { 0xa738c6bebb12d16cULL, 0xb428f8ac016561dbULL }, { 0xd106f86e69d785c7ULL, 0xe13336d701beba52ULL },
+    { 0x82a45b450226b39cULL, 0xecc0024661173473ULL }, { 0xa34d721642b06084ULL, 0x27f002d7f95d0190ULL },
+    { 0xcc20ce9bd35c78a5ULL, 0x31ec038df7b441f4ULL }, { 0xff290242c83396ceULL, 0x7e67047175a15271ULL },
+    { 0x9f79a169bd203e41ULL, 0x0f0062c6e984d386ULL }, { 0xc75809c42c684dd1ULL, 0x52c07b78a3e60868ULL },
+    { 0xf92e0c3537826145ULL, 0xa7709a56ccdf8a82ULL }, { 0x9bbcc7a142b17ccbULL, 0x88a66076400bb691ULL },
+    { 0xc2abf989935ddbfeULL, 0x6acff893d00ea435ULL }, { 0xf356f7ebf83552feULL, 0x0583f6b8c4124d43ULL },
+    { 0x98165af37b2153deULL, 0xc3727a337a8b704aULL }, { 0xbe1bf1b059e9a8d6ULL, 0x744f18c0592e4c5cULL },
+    { 0xeda2ee1c7064130cULL, 0x1162def06f79df73ULL }, { 0x9485d4d1c63e8be7ULL, 0x8addcb5645ac2ba8ULL },
+    { 0xb9a74a0637ce2ee1ULL, 0x6d953e2bd7173692ULL }, { 0xe8111c87c5c1ba99ULL, 0xc8fa8db6ccdd0437ULL },
+    { 0x910ab1d4db9914a0ULL, 0x1d9c9892400a22a2ULL }, { 0xb54d5e4a127f59c8ULL, 0x2503beb6d00cab4bULL },
+    { 0xe2a0b5dc971f303aULL, 0x2e44ae64840fd61dULL }, { 0x8da471a9de737e24ULL, 0x5ceaecfed289e5d2ULL },
+    { 0xb10d8e1456105dadULL, 0x7425a83e872c5f47ULL }, { 0xdd50f1996b947518ULL, 0xd12f124e28f77719ULL },
+    { 0x8a5296ffe33cc92fULL, 0x82bd6b70d99aaa6fULL }, { 0xace73cbfdc0bfb7bULL, 0x636cc64d1001550bULL },
+    { 0xd8210befd30efa5aULL, 0x3c47f7e05401aa4eULL }, { 0x8714a775e3e95c78ULL, 0x65acfaec34810a71ULL },
+    { 0xa8d9d1535ce3b396ULL, 0x7f1839a741a14d0dULL }, { 0xd31045a8341ca07cULL, 0x1ede48111209a050ULL },
+    { 0x83ea2b892091e44dULL, 0x934aed0aab460432ULL }, { 0xa4e4b66b68b65d60ULL, 0xf81da84d5617853fULL },
+    { 0xce1de40642e3f4b9ULL, 0x36251260ab9d668eULL }, { 0x80d2ae83e9ce78f3ULL, 0xc1d72b7c6b426019ULL },
+    { 0xa1075a24e4421730ULL, 0xb24cf65b8612f81fULL }, { 0xc94930ae1d529cfcULL, 0xdee033f26797b627ULL },
+    { 0xfb9b7cd9a4a7443cULL, 0x169840ef017da3b1ULL }, { 0x9d412e0806e88aa5ULL, 0x8e1f289560ee864eULL },
+    { 0xc491798a08a2ad4eULL, 0xf1a6f2bab92a27e2ULL }, { 0xf5b5d7ec8acb58a2ULL, 0xae10af696774b1dbULL },
+    { 0x9991a6f3d6bf1765ULL, 0xacca6da1e0a8ef29ULL }, { 0xbff610b0cc6edd3fULL, 0x17fd090a58d32af3ULL },
+    { 0xeff394dcff8a948eULL, 0xddfc4b4cef07f5b0ULL }, { 0x95f83d0a1fb69cd9ULL, 0x4abdaf101564f98eULL },
+    { 0xbb764c4ca7a4440fULL, 0x9d6d1ad41abe37f1ULL }, { 0xea53df5fd18d5513ULL, 0x84c86189216dc5edULL },
+    { 0x92746b9be2f8552cULL, 0x32fd3cf5b4e49bb4ULL }, { 0xb7118682dbb66a77ULL, 0x3fbc8c33221dc2a1ULL },
+    { 0xe4d5e82392a40515ULL, 0x0fabaf3feaa5334aULL }, { 0x8f05b1163ba6832dULL, 0x29cb4d87f2a7400eULL },
+    { 0xb2c71d5bca9023f8ULL, 0x743e20e9ef511012ULL }, { 0xdf78e4b2bd342cf6ULL, 0x914da9246b255416ULL },
+    { 0x8bab8eefb6409c1aULL, 0x1ad089b6c2f7548eULL }, { 0xae9672aba3d0c320ULL, 0xa184ac2473b529b1ULL },
+    { 0xda3c0f568cc4f3e8ULL, 0xc9e5d72d90a2741eULL }, { 0x8865899617fb1871ULL, 0x7e2fa67c7a658892ULL },
+    { 0xaa7eebfb9df9de8dULL, 0xddbb901b98feeab7ULL }, { 0xd51ea6fa85785631ULL, 0x552a74227f3ea565ULL },
+    { 0x8533285c936b35deULL, 0xd53a88958f87275fULL }, { 0xa67ff273b8460356ULL, 0x8a892abaf368f137ULL },
+    { 0xd01fef10a657842cULL, 0x2d2b7569b0432d85ULL }, { 0x8213f56a67f6b29bULL, 0x9c3b29620e29fc73ULL },
+    { 0xa298f2c501f45f42ULL, 0x8349f3ba91b47b8fULL }, { 0xcb3f2f7642717713ULL, 0x241c70a936219a73ULL },
+    { 0xfe0efb53d30dd4d7ULL, 0xed238cd383aa0110ULL }, { 0x9ec95d1463e8a506ULL, 0xf4363804324a40aaULL },
+    { 0xc67bb4597ce2ce48ULL, 0xb143c6053edcd0d5ULL }, { 0xf81aa16fdc1b81daULL, 0xdd94b7868e94050aULL },
+    { 0x9b10a4e5e9913128ULL, 0xca7cf2b4191c8326ULL }, { 0xc1d4ce1f63f57d72ULL, 0xfd1c2f611f63a3f0ULL },
+    { 0xf24a01a73cf2dccfULL, 0xbc633b39673c8cecULL }, { 0x976e41088617ca01ULL, 0xd5be0503e085d813ULL },
+    { 0xbd49d14aa79dbc82ULL, 0x4b2d8644d8a74e18ULL }, { 0xec9c459d51852ba2ULL, 0xddf8e7d60ed1219eULL },
+    { 0x93e1ab8252f33b45ULL, 0xcabb90e5c942b503ULL }, { 0xb8da1662e7b00a17ULL, 0x3d6a751f3b936243ULL },
+    { 0xe7109bfba19c0c9dULL, 0x0cc512670a783ad4ULL }, { 0x906a617d450187e2ULL, 0x27fb2b80668b24c5ULL },
+    { 0xb484f9dc9641e9daULL, 0xb1f9f660802dedf6ULL }, { 0xe1a63853bbd26451ULL, 0x5e7873f8a0396973ULL },
+    { 0x8d07e33455637eb2ULL, 0xdb0b487b6423e1e8ULL }, { 0xb049dc016abc5e5fULL, 0x91ce1a9a3d2cda62ULL },
+    { 0xdc5c5301c56b75f7ULL, 0x7641a140cc7810fbULL }, { 0x89b9b3e11b6329baULL, 0xa9e904c87fcb0a9dULL },
+    { 0xac2820d9623bf429ULL, 0x546345fa9fbdcd44ULL }, { 0xd732290fbacaf133ULL, 0xa97c177947ad4095ULL },
+    { 0x867f59a9d4bed6c0ULL, 0x49ed8eabcccc485dULL }, { 0xa81f301449ee8c70ULL, 0x5c68f256bfff5a74ULL },
+    { 0xd226fc195c6a2f8cULL, 0x73832eec6fff3111ULL }, { 0x83585d8fd9c25db7ULL, 0xc831fd53c5ff7eabULL },
+    { 0xa42e74f3d032f525ULL, 0xba3e7ca8b77f5e55ULL }, { 0xcd3a1230c43fb26fULL, 0x28ce1bd2e55f35ebULL },
+    { 0x80444b5e7aa7cf85ULL, 0x7980d163cf5b81b3ULL }, { 0xa0555e361951c366ULL, 0xd7e105bcc332621fULL },
+    { 0xc86ab5c39fa63440ULL, 0x8dd9472bf3fefaa7ULL }, { 0xfa856334878fc150ULL, 0xb14f98f6f0feb951ULL },
+    { 0x9c935e00d4b9d8d2ULL, 0x6ed1bf9a569f33d3ULL }, { 0xc3b8358109e84f07ULL, 0x0a862f80ec4700c8ULL },
+    { 0xf4a642e14c6262c8ULL, 0xcd27bb612758c0faULL }, { 0x98e7e9cccfbd7dbdULL, 0x8038d51cb897789cULL },
+    { 0xbf21e44003acdd2cULL, 0xe0470a63e6bd56c3ULL }, { 0xeeea5d5004981478ULL, 0x1858ccfce06cac74ULL },
+    { 0x95527a5202df0ccbULL, 0x0f37801e0c43ebc8ULL }, { 0xbaa718e68396cffdULL, 0xd30560258f54e6baULL },
+    { 0xe950df20247c83fdULL, 0x47c6b82ef32a2069ULL }, { 0x91d28b7416cdd27eULL, 0x4cdc331d57fa5441ULL },
+    { 0xb6472e511c81471dULL, 0xe0133fe4adf8e952ULL }, { 0xe3d8f9e563a198e5ULL, 0x58180fddd97723a6ULL },
+    { 0x8e679c2f5e44ff8fULL, 0x570f09eaa7ea7648ULL },
+};
+
+
+static inline uint64_t _mul64x64(uint64_t a, uint64_t b, uint64_t* puiOutHi)
+{
+    //RETURN: = Low 64 bits of a * b, 'puiOutHi' receives high 64 bits
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 r = (unsigned __int128)a * b;
+    *puiOutHi = (uint64_t)(r >> 64);
+    return (uint64_t)r;
+
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return _umul128(a, b, puiOutHi);
+
+#else
+    const uint64_t M32 = 0xFFFFFFFF;
+    uint64_t ad = (a >> 32) * (b & M32);
+    uint64_t bc = (a & M32) * (b >> 32);
+    uint64_t bd = (a & M32) * (b & M32);
+    uint64_t mid = (bd >> 32) + (ad & M32) + (bc & M32);
+    *puiOutHi = (a >> 32) * (b >> 32) + (ad >> 32) + (bc >> 32) + (mid >> 32);
+    return (mid << 32) | (bd & M32);
+
+#endif
+}
+
+
+static inline int _countLeadingZeros64(uint64_t uiVal)
+{
+    //'uiVal' = must not be 0
+    //RETURN: = Number of leading zero bits in 'uiVal'
+    ASSERT(uiVal);
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long nIdx;
+    _BitScanReverse64(&nIdx, uiVal);
+    return 63 - (int)nIdx;
+#elif defined(_MSC_VER)
+    int n = 0;
+    while(!(uiVal & (1ULL << 63)))
+    {
+        uiVal <<= 1;
+        n++;
+    }
+    return n;
+#else
+    return __builtin_clzll(uiVal);
+#endif
+}
+
+
+static bool _computeDoubleEiselLemire(uint64_t w, int q, bool bNegative, double* pfOutVal)
+{
+    //Convert w * 10^q into a correctly rounded double
+    //'w' = up to 19 significant decimal digits, must not be 0
+    //RETURN:
+    //		= true if success
+    //		= false if the result could not be determined this way (very rare), use a slower method then
+    if(q < JSON_POW5_MIN ||
+        q > JSON_POW5_MAX)
+        return false;
+
+    const int nLz = _countLeadingZeros64(w);
+    w <<= nLz;
+
+    //Product with 55 bits of precision
+    const int nIndex = q - JSON_POW5_MIN;
+    uint64_t uiHi;
+    uint64_t uiLo = _mul64x64(w, g_arrPow5_128[nIndex].hi, &uiHi);
+    if((uiHi & 0x1FF) == 0x1FF)
+    {
+        //Use the lower half of the power as well
+        uint64_t uiHi2;
+        _mul64x64(w, g_arrPow5_128[nIndex].lo, &uiHi2);
+        uiLo += uiHi2;
+        if(uiHi2 > uiLo)
+            uiHi++;
+    }
+
+    if(uiLo == UINT64_MAX &&
+        (q < -27 || q > 55))
+    {
+        //Can't tell which way to round
+        return false;
+    }
+
+    const int nUpperBit = (int)(uiHi >> 63);
+    uint64_t uiMantissa = uiHi >> (nUpperBit + 64 - 52 - 3);
+    int nPower2 = (((152170 + 65536) * q) >> 16) + 63 + nUpperBit - nLz + 1023;
+
+    if(nPower2 <= 0)
+    {
+        //Subnormal
+        if(-nPower2 + 1 >= 64)
+        {
+            uiMantissa = 0;
+            nPower2 = 0;
+        }
+        else
+        {
+            uiMantissa >>= -nPower2 + 1;
+            uiMantissa += uiMantissa & 1;
+            uiMantissa >>= 1;
+            nPower2 = uiMantissa < (1ULL << 52) ? 0 : 1;
+        }
+    }
+    else
+    {
+        //Round to even if exactly in between
+        if(uiLo <= 1 &&
+            q >= -4 &&
+            q <= 23 &&
+            (uiMantissa & 3) == 1 &&
+            (uiMantissa << (nUpperBit + 64 - 52 - 3)) == uiHi)
+        {
+            uiMantissa &= ~1ULL;
+        }
+
+        uiMantissa += uiMantissa & 1;
+        uiMantissa >>= 1;
+        if(uiMantissa >= (2ULL << 52))
+        {
+            uiMantissa = 1ULL << 52;
+            nPower2++;
+        }
+
+        uiMantissa &= ~(1ULL << 52);
+
+        if(nPower2 >= 0x7FF)
+        {
+            //Infinity
+            nPower2 = 0x7FF;
+            uiMantissa = 0;
+        }
+    }
+
+    uint64_t u64 = uiMantissa | ((uint64_t)nPower2 << 52) | ((uint64_t)bNegative << 63);
+    memcpy(pfOutVal, &u64, sizeof(*pfOutVal));
+
+    return true;
+}
+
+
+bool JSON_NODE::parseDouble(const WCHAR* pStr, intptr_t nch, double* pfOutVal)
+{
+    //Redirect
+    return CJSON::parseDouble(pStr, nch, pfOutVal);
+}
+
+bool CJSON::parseDouble(const WCHAR* pStr, intptr_t nch, double* pfOutVal)
+{
+    //Parse floating point number, such as: 1.5, -2e10, .5, 5., +1E-3, inf, nan
+    //INFO: Does not depend on the locale, '.' is always the decimal point. The result is correctly rounded.
+    //'pStr' = text to parse (does not need to be null-terminated), may begin with white spaces
+    //'nch' = length of 'pStr' in TCHARs
+    //'pfOutVal' = if not nullptr, receives value parsed
+    //RETURN:
+    //		= true if success
+    double fVal = 0.0;
+    bool bRes = false;
+
+    intptr_t i = 0;
+    while(i < nch &&
+        (pStr[i] == ' ' || (pStr[i] >= '\t' && pStr[i] <= '\r')))
+    {
+        i++;
+    }
+
+    bool bNegative = false;
+    if(i < nch &&
+        (pStr[i] == '-' || pStr[i] == '+'))
+    {
+        bNegative = pStr[i] == '-';
+        i++;
+    }
+
+    intptr_t iNum = i;
+
+    //Significant digits
+    uint64_t w = 0;
+    int nCntDigits = 0;			//Significant digits in 'w'
+    int nCntMantDigits = 0;		//All digits before the exponent
+    int q = 0;
+    bool bTruncated = false;
+
+    for(; i < nch; i++)
+    {
+        UINT d = (UINT)pStr[i] - '0';
+        if(d > 9)
+            break;
+
+        nCntMantDigits++;
+        if(w || d)
+        {
+            if(nCntDigits < 19)
+            {
+                w = w * 10 + d;
+                nCntDigits++;
+            }
+            else
+            {
+                q++;
+                bTruncated |= d != 0;
+            }
+        }
+    }
+
+    if(i < nch &&
+        pStr[i] == '.')
+    {
+        for(i++; i < nch; i++)
+        {
+            UINT d = (UINT)pStr[i] - '0';
+            if(d > 9)
+                break;
+
+            nCntMantDigits++;
+            if(w || d)
+            {
+                if(nCntDigits < 19)
+                {
+                    w = w * 10 + d;
+                    nCntDigits++;
+                    q--;
+                }
+                else
+                    bTruncated |= d != 0;
+            }
+            else
+                q--;
+        }
+    }
+
+    if(nCntMantDigits > 0)
+    {
+        bRes = true;
+
+        if(i < nch &&
+            (pStr[i] == 'e' || pStr[i] == 'E'))
+        {
+            i++;
+
+            bool bNegExp = false;
+            if(i < nch &&
+                (pStr[i] == '-' || pStr[i] == '+'))
+            {
+                bNegExp = pStr[i] == '-';
+                i++;
+            }
+
+            //Need at least one digit
+            bRes = i < nch && (UINT)pStr[i] - '0' <= 9;
+
+            int nExp = 0;
+            for(; i < nch; i++)
+            {
+                UINT d = (UINT)pStr[i] - '0';
+                if(d > 9)
+                    break;
+
+                //Anything this large is 0 or infinity anyway
+                if(nExp < 100000)
+                    nExp = nExp * 10 + (int)d;
+            }
+
+            q += bNegExp ? -nExp : nExp;
+        }
+
+        if(i != nch)
+            bRes = false;
+
+        if(bRes)
+        {
+            if(!w)
+            {
+                fVal = bNegative ? -0.0 : 0.0;
+            }
+            else if(bTruncated ||
+                !_computeDoubleEiselLemire(w, q, bNegative, &fVal))
+            {
+                //Too many digits, or can't tell how to round
+                bRes = _parseDoubleSlow(pStr + iNum, nch - iNum, &fVal);
+                if(bNegative)
+                    fVal = -fVal;
+            }
+        }
+    }
+    else
+    {
+        //Special values, as written by printf()
+        static const struct
+        {
+            const WCHAR* pStrName;
+            double fVal;
+        }
+        kSpecials[] = {
+            { L("infinity"),    HUGE_VAL },
+            { L("inf"),         HUGE_VAL },
+            { L("nan"),         NAN },
+        };
+
+        for(size_t s = 0; s < SIZEOF(kSpecials); s++)
+        {
+            if(JSON_NODE::compareStringsEqual(pStr + i, nch - i, kSpecials[s].pStrName, -1, false))
+            {
+                fVal = bNegative ? -kSpecials[s].fVal : kSpecials[s].fVal;
+                bRes = true;
+                break;
+            }
+        }
+    }
+
+    if(pfOutVal)
+        *pfOutVal = bRes ? fVal : 0.0;
+
+    return bRes;
+}
+
+
+bool CJSON::_parseDoubleSlow(const WCHAR* pStr, intptr_t nch, double* pfOutVal)
+{
+    //Parse floating point number with strtod() as the fallback for CJSON::parseDouble()
+    //'pStr' = number that was already checked by CJSON::parseDouble(), without the sign
+    //'nch' = length of 'pStr' in TCHARs
+    //'pfOutVal' = receives value parsed
+    //RETURN:
+    //		= true if success
+
+    //strtod() uses the decimal point from the current locale
+    const char* pDecPt = ".";
+    struct lconv* pLc = localeconv();
+    if(pLc &&
+        pLc->decimal_point &&
+        pLc->decimal_point[0])
+        pDecPt = pLc->decimal_point;
+
+    std::string str;
+    str.reserve(nch + 8);
+
+    for(intptr_t i = 0; i < nch; i++)
+    {
+        if(pStr[i] == '.')
+            str += pDecPt;
+        else
+            str += (char)pStr[i];
+    }
+
+    int nOSError = CJSON::GetLastError();
+
+    char* pEnd = nullptr;
+    *pfOutVal = strtod(str.c_str(), &pEnd);
+
+    CJSON::SetLastError(nOSError);
+
+    return pEnd && *pEnd == 0;
+}
+
+
+bool CJSON::isFloatingPointNumberString(LPCTSTR pStr)
+{
+    //Checks if 'pStr' contains an floating point number
+    //RETURN:
+    //		= true if yes
+    return parseFloat(pStr);
+}
+
+bool JSON_NODE::isIntegerBase10String(LPCTSTR pStr)
+{
+    //Redirect
+    return CJSON::isIntegerBase10String(pStr);
+}
+
+bool CJSON::isIntegerBase10String(LPCTSTR pStr)
+{
+    //Checks if 'pStr' contains an integer
+    //RETURN:
+    //		= true if yes
+    bool bRes = false;
+
+    if(pStr &&
+        pStr[0])
+    {
+        //Assume yes
+        bRes = true;
+
+        intptr_t nLn = STRLEN(pStr);
+        for(intptr_t i = 0; i < nLn; i++)
+        {
+            WCHAR z = pStr[i];
+
+            //For first char only
+            if(i == 0)
+            {
+                if(z == '+' ||
+                    z == '-')
+                {
+                    //Good char
+                    continue;
+                }
+            }
+
+            if(z >= '0' &&
+                z <= '9')
+            {
+                //Good char
+                continue;
+            }
+
+            //Bad char
+            bRes = false;
+            break;
+        }
+    }
+
+    return bRes;
+}
+
+
+intptr_t CJSON::_formatInt64(int64_t iiValue, WCHAR* pBuff)
+{
+    //Write 'iiValue' as a base-10 integer
+    //INFO: Does not depend on the locale
+    //'pBuff' = buffer to write into, must be at least JSON_NUMBER_BUFF_LEN TCHARs long (it will be null-terminated)
+    //RETURN:
+    //		= Length of the text written in TCHARs
+    WCHAR buffDigits[24];
+    intptr_t nCntDigits = 0;
+
+    //Negate as unsigned, so that INT64_MIN works too
+    uint64_t uiVal = iiValue < 0 ? 0 - (uint64_t)iiValue : (uint64_t)iiValue;
+    do
+    {
+        buffDigits[nCntDigits++] = (WCHAR)('0' + (int)(uiVal % 10));
+        uiVal /= 10;
+    }
+    while(uiVal);
+
+    intptr_t nLn = 0;
+    if(iiValue < 0)
+        pBuff[nLn++] = '-';
+
+    while(nCntDigits > 0)
+    {
+        pBuff[nLn++] = buffDigits[--nCntDigits];
+    }
+
+    pBuff[nLn] = 0;
+
+    return nLn;
+}
+
+
+//Floating point number as f * 2^e, used by _grisu2()
+//INFO: Based on "Printing Floating-Point Numbers Quickly and Accurately with Integers" by Florian Loitsch
+struct JSON_DIY_FP
+{
+    uint64_t f;
+    int e;
+
+    JSON_DIY_FP(uint64_t fp = 0, int exp = 0)
+    {
+        f = fp;
+        e = exp;
+    }
+
+    JSON_DIY_FP minus(const JSON_DIY_FP& rhs) const
+    {
+        return JSON_DIY_FP(f - rhs.f, e);
+    }
+
+    JSON_DIY_FP times(const JSON_DIY_FP& rhs) const
+    {
+        //Upper 64 bits of the 128-bit product, rounded
+        const uint64_t M32 = 0xFFFFFFFF;
+        uint64_t a = f >> 32;
+        uint64_t b = f & M32;
+        uint64_t c = rhs.f >> 32;
+        uint64_t d = rhs.f & M32;
+        uint64_t ac = a * c;
+        uint64_t bc = b * c;
+        uint64_t ad = a * d;
+        uint64_t bd = b * d;
+        uint64_t tmp = (bd >> 32) + (ad & M32) + (bc & M32);
+        tmp += 1U << 31;
+
+        return JSON_DIY_FP(ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), e + rhs.e + 64);
+    }
+
+    JSON_DIY_FP normalize() const
+    {
+        JSON_DIY_FP res = *this;
+        while(!(res.f & (1ULL << 63)))
+        {
+            res.f <<= 1;
+            res.e--;
+        }
+
+        return res;
+    }
+};
+
+static const uint64_t g_uiDpHiddenBit = 0x0010000000000000ULL;
+static const uint64_t g_uiDpSignificandMask = 0x000FFFFFFFFFFFFFULL;
+
+static const uint64_t g_arrPow10[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+    10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+    1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL,
+};
+
+//Normalized 10^-348, 10^-340, ..., 10^340
+static const struct
+{
+    uint64_t f;
+    int e;
+}
+g_arrCachedPow10[] = {
+{ 0xfa8fd5a0081c0288ULL, -1220 }, { 0xbaaee17fa23ebf76ULL, -1193 }, { 0x8b16fb203055ac76ULL, -1166 },
+{ 0xcf42894a5dce35eaULL, -1140 }, { 0x9a6bb0aa55653b2dULL, -1113 }, { 0xe61acf033d1a45dfULL, -1087 },
+{ 0xab70fe17c79ac6caULL, -1060 }, { 0xff77b1fcbebcdc4fULL, -1034 }, { 0xbe5691ef416bd60cULL, -1007 },
+{ 0x8dd01fad907ffc3cULL, -980 }, { 0xd3515c2831559a83ULL, -954 }, { 0x9d71ac8fada6c9b5ULL, -927 },
+{ 0xea9c227723ee8bcbULL, -901 }, { 0xaecc49914078536dULL, -874 }, { 0x823c12795db6ce57ULL, -847 },
+{ 0xc21094364dfb5637ULL, -821 }, { 0x9096ea6f3848984fULL, -794 }, { 0xd77485cb25823ac7ULL, -768 },
+{ 0xa086cfcd97bf97f4ULL, -741 }, { 0xef340a98172aace5ULL, -715 }, { 0xb23867fb2a35b28eULL, -688 },
+{ 0x84c8d4dfd2c63f3bULL, -661 }, { 0xc5dd44271ad3cdbaULL, -635 }, { 0x936b9fcebb25c996ULL, -608 },
+{ 0xdbac6c247d62a584ULL, -582 }, { 0xa3ab66580d5fdaf6ULL, -555 }, { 0xf3e2f893dec3f126ULL, -529 },
+{ 0xb5b5ada8aaff80b8ULL, -502 }, { 0x87625f056c7c4a8bULL, -475 }, { 0xc9bcff6034c13053ULL, -449 },
+{ 0x964e858c91ba2655ULL, -422 }, { 0xdff9772470297ebdULL, -396 }, { 0xa6dfbd9fb8e5b88fULL, -369 },
+{ 0xf8a95fcf88747d94ULL, -343 }, { 0xb94470938fa89bcfULL, -316 }, { 0x8a08f0f8bf0f156bULL, -289 },
+{ 0xcdb02555653131b6ULL, -263 }, { 0x993fe2c6d07b7facULL, -236 }, { 0xe45c10c42a2b3b06ULL, -210 },
+{ 0xaa242499697392d3ULL, -183 }, { 0xfd87b5f28300ca0eULL, -157 }, { 0xbce5086492111aebULL, -130 },
+{ 0x8cbccc096f5088ccULL, -103 }, { 0xd1b71758e219652cULL, -77 }, { 0x9c40000000000000ULL, -50 },
+{ 0xe8d4a51000000000ULL, -24 }, { 0xad78ebc5ac620000ULL, 3 }, { 0x813f3978f8940984ULL, 30 },
+{ 0xc097ce7bc90715b3ULL, 56 }, { 0x8f7e32ce7bea5c70ULL, 83 }, { 0xd5d238a4abe98068ULL, 109 },
+{ 0x9f4f2726179a2245ULL, 136 }, { 0xed63a231d4c4fb27ULL, 162 }, { 0xb0de65388cc8ada8ULL, 189 },
+{ 0x83c7088e1aab65dbULL, 216 }, { 0xc45d1df942711d9aULL, 242 }, { 0x924d692ca61be758ULL, 269 },
+{ 0xda01ee641a708deaULL, 295 }, { 0xa26da3999aef774aULL, 322 }, { 0xf209787bb47d6b85ULL, 348 },
+{ 0xb454e4a179dd1877ULL, 375 }, { 0x865b86925b9bc5c2ULL, 402 }, { 0xc83553c5c8965d3dULL, 428 },
+{ 0x952ab45cfa97a0b3ULL, 455 }, { 0xde469fbd99a05fe3ULL, 481 }, { 0xa59bc234db398c25ULL, 508 },
+{ 0xf6c69a72a3989f5cULL, 534 }, { 0xb7dcbf5354e9beceULL, 561 }, { 0x88fcf317f22241e2ULL, 588 },
+{ 0xcc20ce9bd35c78a5ULL, 614 }, { 0x98165af37b2153dfULL, 641 }, { 0xe2a0b5dc971f303aULL, 667 },
+{ 0xa8d9d1535ce3b396ULL, 694 }, { 0xfb9b7cd9a4a7443cULL, 720 }, { 0xbb764c4ca7a44410ULL, 747 },
+{ 0x8bab8eefb6409c1aULL, 774 }, { 0xd01fef10a657842cULL, 800 }, { 0x9b10a4e5e9913129ULL, 827 },
+{ 0xe7109bfba19c0c9dULL, 853 }, { 0xac2820d9623bf429ULL, 880 }, { 0x80444b5e7aa7cf85ULL, 907 },
+{ 0xbf21e44003acdd2dULL, 933 }, { 0x8e679c2f5e44ff8fULL, 960 }, { 0xd433179d9c8cb841ULL, 986 },
+{ 0x9e19db92b4e31ba9ULL, 1013 }, { 0xeb96bf6ebadf77d9ULL, 1039 }, { 0xaf87023b9bf0ee6bULL, 1066 },
+};
+
+static JSON_DIY_FP _getCachedPower(int e, int& nK)
+{
+    //RETURN: = Cached power of 10 that brings binary exponent 'e' into [-60, -32] when multiplied by it
+    //'nK' = receives its decimal exponent, negated
+    double dk = (-61 - e) * 0.30102999566398114 + 347;	//dk must be positive, so we can use (int) for ceiling
+    int k = (int)dk;
+    if(dk - k > 0.0)
+        k++;
+
+    unsigned int nIndex = (unsigned int)((k >> 3) + 1);
+    nK = -(-348 + (int)(nIndex << 3));
+
+    return JSON_DIY_FP(g_arrCachedPow10[nIndex].f, g_arrCachedPow10[nIndex].e);
+}
+
+static int _countDecimalDigit32(uint32_t n)
+{
+    if(n < 10) return 1;
+    if(n < 100) return 2;
+    if(n < 1000) return 3;
+    if(n < 10000) return 4;
+    if(n < 100000) return 5;
+    if(n < 1000000) return 6;
+    if(n < 10000000) return 7;
+    if(n < 100000000) return 8;
+
+    //Will not reach 10 digits in _digitGen()
+    return 9;
+}
+
+static void _grisuRound(WCHAR* pBuff, intptr_t nLength, uint64_t delta, uint64_t rest, uint64_t ten_kappa, uint64_t wp_w)
+{
+    //Move the last digit closer to the actual value, while staying within the boundaries
+    while(rest < wp_w &&
+        delta - rest >= ten_kappa &&
+        (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w))
+    {
+        pBuff[nLength - 1]--;
+        rest += ten_kappa;
+    }
+}
+
+static void _digitGen(const JSON_DIY_FP& W, const JSON_DIY_FP& Mp, uint64_t delta, WCHAR* pBuff, intptr_t& nLength, int& nK)
+{
+    //Generate the shortest digits of 'W' that stay within 'delta' of 'Mp'
+    const JSON_DIY_FP one(1ULL << -Mp.e, Mp.e);
+    const JSON_DIY_FP wp_w = Mp.minus(W);
+    uint32_t p1 = (uint32_t)(Mp.f >> -one.e);
+    uint64_t p2 = Mp.f & (one.f - 1);
+    int kappa = _countDecimalDigit32(p1);
+    nLength = 0;
+
+    while(kappa > 0)
+    {
+        uint32_t d = 0;
+        switch(kappa)
+        {
+        case 9: d = p1 / 100000000; p1 %= 100000000; break;
+        case 8: d = p1 / 10000000; p1 %= 10000000; break;
+        case 7: d = p1 / 1000000; p1 %= 1000000; break;
+        case 6: d = p1 / 100000; p1 %= 100000; break;
+        case 5: d = p1 / 10000; p1 %= 10000; break;
+        case 4: d = p1 / 1000; p1 %= 1000; break;
+        case 3: d = p1 / 100; p1 %= 100; break;
+        case 2: d = p1 / 10; p1 %= 10; break;
+        case 1: d = p1; p1 = 0; break;
+        default: break;
+        }
+
+        if(d || nLength)
+            pBuff[nLength++] = (WCHAR)('0' + d);
+
+        kappa--;
+        uint64_t tmp = ((uint64_t)p1 << -one.e) + p2;
+        if(tmp <= delta)
+        {
+            nK += kappa;
+            _grisuRound(pBuff, nLength, delta, tmp, g_arrPow10[kappa] << -one.e, wp_w.f);
+            return;
+        }
+    }
+
+    //kappa = 0
+    for(;;)
+    {
+        p2 *= 10;
+        delta *= 10;
+        uint32_t d = (uint32_t)(p2 >> -one.e);
+        if(d || nLength)
+            pBuff[nLength++] = (WCHAR)('0' + d);
+
+        p2 &= one.f - 1;
+        kappa--;
+        if(p2 < delta)
+        {
+            nK += kappa;
+            int nIndex = -kappa;
+            _grisuRound(pBuff, nLength, delta, p2, one.f, wp_w.f * (nIndex < (int)SIZEOF(g_arrPow10) ? g_arrPow10[nIndex] : 0));
+            return;
+        }
+    }
+}
+
+static intptr_t _writeExponent(int nK, WCHAR* pBuff)
+{
+    //RETURN: = Number of TCHARs written
+    intptr_t nLn = 0;
+    if(nK < 0)
+    {
+        pBuff[nLn++] = '-';
+        nK = -nK;
+    }
+
+    if(nK >= 100)
+    {
+        pBuff[nLn++] = (WCHAR)('0' + nK / 100);
+        nK %= 100;
+        pBuff[nLn++] = (WCHAR)('0' + nK / 10);
+    }
+    else if(nK >= 10)
+        pBuff[nLn++] = (WCHAR)('0' + nK / 10);
+
+    pBuff[nLn++] = (WCHAR)('0' + nK % 10);
+
+    return nLn;
+}
+
+
+static void _grisu2(double fValue, WCHAR* pBuff, intptr_t& nLength, int& nK)
+{
+    //Write shortest digits for a positive finite 'fValue' with the Grisu2 algorithm
+    //INFO: Value of the result is: digits * 10^nK
+    //'pBuff' = receives the digits (up to 17, not null-terminated)
+    //'nLength' = receives the number of digits written
+    //'nK' = receives the decimal exponent
+    uint64_t u64;
+    memcpy(&u64, &fValue, sizeof(u64));
+
+    int nBiasedE = (int)((u64 & 0x7FF0000000000000ULL) >> 52);
+    uint64_t uiSignificand = u64 & g_uiDpSignificandMask;
+
+    JSON_DIY_FP v;
+    if(nBiasedE != 0)
+        v = JSON_DIY_FP(uiSignificand + g_uiDpHiddenBit, nBiasedE - 1075);
+    else
+        v = JSON_DIY_FP(uiSignificand, -1074);
+
+    //Boundaries between this value and its neighbors
+    JSON_DIY_FP pl = JSON_DIY_FP((v.f << 1) + 1, v.e - 1);
+    while(!(pl.f & (g_uiDpHiddenBit << 1)))
+    {
+        pl.f <<= 1;
+        pl.e--;
+    }
+
+    pl.f <<= 10;
+    pl.e -= 10;
+
+    JSON_DIY_FP mi = v.f == g_uiDpHiddenBit ? JSON_DIY_FP((v.f << 2) - 1, v.e - 2) : JSON_DIY_FP((v.f << 1) - 1, v.e - 1);
+    mi.f <<= mi.e - pl.e;
+    mi.e = pl.e;
+
+    const JSON_DIY_FP c_mk = _getCachedPower(pl.e, nK);
+    const JSON_DIY_FP W = v.normalize().times(c_mk);
+    JSON_DIY_FP Wp = pl.times(c_mk);
+    JSON_DIY_FP Wm = mi.times(c_mk);
+    Wm.f++;
+    Wp.f--;
+
+    _digitGen(W, Wp, Wp.f - Wm.f, pBuff, nLength, nK);
+}
+
+
+static void _shortenDigits(double fValue, WCHAR* pBuff, intptr_t& nLength, int& nK)
+{
+    //Grisu2 gives one or two more digits than needed for a small share of doubles (about 0.1%), so see if fewer digits
+    //read back as the same double, and keep the shortest of them
+    //INFO: All decimals that read back as 'fValue' are in one range, and the digits from Grisu2 are in it too, thus if any
+    //      decimal with fewer digits is there, then one of the two closest to the digits from Grisu2 is there as well.
+    //INFO: Decimals with up to 15 digits are further apart than doubles, so Grisu2 finds those, and this is only needed
+    //      when it gives 16 or 17 digits.
+    //'fValue' = positive finite value that 'pBuff' has the digits for
+    //'pBuff', 'nLength', 'nK' = digits from _grisu2(), that receive the shorter ones if found
+    for(intptr_t nPrec = 15; nPrec < nLength; nPrec++)
+    {
+        uint64_t w = 0;
+        for(intptr_t i = 0; i < nPrec; i++)
+            w = w * 10 + (UINT)(pBuff[i] - '0');
+
+        int q = nK + (int)(nLength - nPrec);
+
+        //Digits below and above (if it can't tell how to round, it's not worth going the slow way just to write fewer digits)
+        double fValDn, fValUp;
+        bool bDn = _computeDoubleEiselLemire(w, q, false, &fValDn) && fValDn == fValue;
+        bool bUp = _computeDoubleEiselLemire(w + 1, q, false, &fValUp) && fValUp == fValue;
+
+        if(bDn && bUp)
+        {
+            //Both read back the same, so pick the one closer to 'fValue', same as rounding it to 'nPrec' digits would
+            double fValMid;
+            if(_computeDoubleEiselLemire(w * 10 + 5, q - 1, false, &fValMid) &&
+                fValMid != fValue)
+            {
+                bDn = fValue < fValMid;
+            }
+            else
+                bDn = pBuff[nPrec] < '5';
+
+            bUp = !bDn;
+        }
+
+        if(bDn || bUp)
+        {
+            //Trailing zeros go into the exponent
+            uint64_t wOut = bUp ? w + 1 : w;
+            while(wOut % 10 == 0)
+            {
+                wOut /= 10;
+                q++;
+            }
+
+            WCHAR buffDigits[24];
+            intptr_t nCntDigits = 0;
+            do
+            {
+                buffDigits[nCntDigits++] = (WCHAR)('0' + (int)(wOut % 10));
+                wOut /= 10;
+            }
+            while(wOut);
+
+            for(intptr_t i = 0; i < nCntDigits; i++)
+                pBuff[i] = buffDigits[nCntDigits - 1 - i];
+
+            nLength = nCntDigits;
+            nK = q;
+            return;
+        }
+    }
+}
+
+
+static intptr_t _prettifyDouble(WCHAR* pBuff, intptr_t nLength, int nK)
+{
+    //Lay out digits from _grisu2() as a JSON number
+    //'pBuff' = digits to lay out, it must have space for at least JSON_NUMBER_BUFF_LEN - 1 TCHARs (it is not null-terminated)
+    //RETURN:
+    //		= Length of the result in TCHARs
+    const intptr_t kk = nLength + nK;		//10^(kk-1) <= v < 10^kk
+
+    if(nK >= 0 &&
+        kk <= 21)
+    {
+        //1234e7 -> 12340000000.0
+        for(intptr_t i = nLength; i < kk; i++)
+            pBuff[i] = '0';
+
+        pBuff[kk] = '.';
+        pBuff[kk + 1] = '0';
+        return kk + 2;
+    }
+    else if(kk > 0 &&
+        kk <= 21)
+    {
+        //1234e-2 -> 12.34
+        memmove(&pBuff[kk + 1], &pBuff[kk], (nLength - kk) * sizeof(WCHAR));
+        pBuff[kk] = '.';
+        return nLength + 1;
+    }
+    else if(kk > -6 &&
+        kk <= 0)
+    {
+        //1234e-6 -> 0.001234
+        const intptr_t nOffset = 2 - kk;
+        memmove(&pBuff[nOffset], &pBuff[0], nLength * sizeof(WCHAR));
+        pBuff[0] = '0';
+        pBuff[1] = '.';
+        for(intptr_t i = 2; i < nOffset; i++)
+            pBuff[i] = '0';
+
+        return nLength + nOffset;
+    }
+    else if(nLength == 1)
+    {
+        //1e30
+        pBuff[1] = 'e';
+        return 2 + _writeExponent((int)(kk - 1), &pBuff[2]);
+    }
+
+    //1234e30 -> 1.234e33
+    memmove(&pBuff[2], &pBuff[1], (nLength - 1) * sizeof(WCHAR));
+    pBuff[1] = '.';
+    pBuff[nLength + 1] = 'e';
+    return nLength + 2 + _writeExponent((int)(kk - 1), &pBuff[nLength + 2]);
+}
+
+
+intptr_t CJSON::_formatDouble(double fValue, WCHAR* pBuff)
+{
+    //Write 'fValue' with the fewest digits that read back as the same double
+    //INFO: Does not depend on the locale. Always has a decimal point or an exponent, so that it's read back as JNT_FLOAT.
+    //'pBuff' = buffer to write into, must be at least JSON_NUMBER_BUFF_LEN TCHARs long (it will be null-terminated)
+    //RETURN:
+    //		= Length of the text written in TCHARs
+    intptr_t nLn = 0;
+
+    if(std::isnan(fValue))
+    {
+        //Same as printf()
+        pBuff[nLn++] = 'n';
+        pBuff[nLn++] = 'a';
+        pBuff[nLn++] = 'n';
+    }
+    else
+    {
+        if(std::signbit(fValue))
+        {
+            pBuff[nLn++] = '-';
+            fValue = -fValue;
+        }
+
+        if(std::isinf(fValue))
+        {
+            pBuff[nLn++] = 'i';
+            pBuff[nLn++] = 'n';
+            pBuff[nLn++] = 'f';
+        }
+        else if(fValue == 0)
+        {
+            pBuff[nLn++] = '0';
+            pBuff[nLn++] = '.';
+            pBuff[nLn++] = '0';
+        }
+        else
+        {
+            intptr_t nLength;
+            int nK;
+            _grisu2(fValue, pBuff + nLn, nLength, nK);
+            if(nLength > 15)
+                _shortenDigits(fValue, pBuff + nLn, nLength, nK);
+
+            nLn += _prettifyDouble(pBuff + nLn, nLength, nK);
+        }
+    }
+
+    pBuff[nLn] = 0;
+
+    return nLn;
+}
+
+
+
+
+JSON_NODE_TYPE CJSON::_determineNodeTypeSafe(JSON_VALUE* pVal)
+{
+    //RETURN:
+    //		= Type of node by 'pVal', or
+    //		  INFO: Cannot be JNT_ERROR or JNT_NONE, uses JNT_STRING instead
+    JSON_NODE_TYPE type = _determineNodeType(pVal);
+    if(type == JNT_ERROR ||
+        type == JNT_NONE)
+    {
+        //Use default value
+        ASSERT(nullptr);
+        type = JNT_STRING;
+    }
+
+    return type;
+}
+
+JSON_NODE_TYPE JSON_NODE::_determineNodeType(JSON_VALUE* pVal)
+{
+    //Redirect
+    return CJSON::_determineNodeType(pVal);
+}
+
+JSON_NODE_TYPE CJSON::_determineNodeType(JSON_VALUE* pVal)
+{
+    //RETURN:
+    //		= Type of node by 'pVal', or
+    //		= JNT_ERROR if error
+    if(pVal)
+    {
+        if(pVal->valType == JVT_ARRAY)
+            return JNT_ARRAY;
+        else if(pVal->valType == JVT_OBJECT)
+            return JNT_OBJECT;
+        else if(pVal->valType == JVT_NONE)
+            return JNT_NONE;
+        else if(pVal->valType == JVT_DOUBLE_QUOTED)
+        {
+            //Just a string
+            return JNT_STRING;
+        }
+        else if(pVal->valType == JVT_PLAIN)
+        {
+            //Was it converted when parsed?
+            if(pVal->nativeType != JNT_NONE)
+                return pVal->nativeType;
+
+            //Or when it was set?
+            if(pVal->plainType != JNT_NONE)
+                return pVal->plainType;
+
+            //INFO: Not stored here, so that lookups never change the data
+            return _determinePlainType(pVal);
+        }
+    }
+
+    return JNT_ERROR;
+}
+
+
+JSON_NODE_TYPE CJSON::_determinePlainType(const JSON_VALUE* pVal)
+{
+    //Determine node type of a JVT_PLAIN value from its text
+    //RETURN:
+    //		= Type of node by 'pVal'
+    ASSERT(pVal);
+
+    //Check special cases
+    //if(pVal->strValue.Compare(L"null") == 0)
+    if(json::JSON_NODE::compareStringsEqual(pVal->getStrPtr(), pVal->getStrLen(), L("null"), -1, true))
+        return JNT_NULL;
+    //else if(pVal->strValue.Compare(L"true") == 0 ||
+    //	pVal->strValue.Compare(L"false") == 0)
+    else if(json::JSON_NODE::compareStringsEqual(pVal->getStrPtr(), pVal->getStrLen(), L("true"), -1, true) ||
+        json::JSON_NODE::compareStringsEqual(pVal->getStrPtr(), pVal->getStrLen(), L("false"), -1, true))
+        return JNT_BOOLEAN;
+
+    //See if it's an integer (even if it doesn't fit into 64 bits) or a floating point number
+    if(parseInt64(pVal->getStrPtr(), pVal->getStrLen()) != 0)
+        return JNT_INTEGER;
+    else if(parseDouble(pVal->getStrPtr(), pVal->getStrLen()))
+        return JNT_FLOAT;
+
+    //Else just a string
+    return JNT_STRING;
+}
+
+
+JSON_NODE_TYPE JSON_NODE::findNodeByIndex(intptr_t nIndex, JSON_NODE* pJNodeFound)
+{
+    //Look for the node in this node with the 'nIndex'
+    //INFO: This node must be an object or array node
+    //'nIndex' = node zero-based index (use JSON_NODE::getNodeCount() to get number of nodes)
+    //'pJNodeFound' = if not nullptr, receives the data for the node found
+    //RETURN:
+    //		= Node type if found, or
+    //		= JNT_ERROR if error in search parameters
+    JSON_NODE_TYPE resType = JNT_ERROR;
+
+    if(isNodeSet())
+    {
+        ASSERT(pVal);
+        if(pVal)
+        {
+            //Check node type
+            if(pVal->valType == JVT_OBJECT)
+            {
+                JSON_OBJECT* pJO = (JSON_OBJECT*)pVal->pValue;
+                ASSERT(pJO);
+                if(pJO)
+                {
+                    if(nIndex >= 0 &&
+                        nIndex < (intptr_t)pJO->arrObjElmts.size())
+                    {
+                        //Got it
+                        JSON_OBJECT_ELEMENT* pJOE = &pJO->arrObjElmts[nIndex];
+
+                        //Type
+                        resType = CJSON::_determineNodeTypeSafe(&pJOE->val);
+                        ASSERT(resType != JNT_NONE && resType != JNT_ERROR);
+
+                        if(pJNodeFound)
+                        {
+                            pJNodeFound->typeNode = resType;
+                            pJOE->getName(pJNodeFound->strName);
+                            pJNodeFound->pVal = &pJOE->val;
+
+                            pJNodeFound->pJSONData = pJSONData;
+                        }
+                    }
+                }
+            }
+            else if(pVal->valType == JVT_ARRAY)
+            {
+                JSON_ARRAY* pJA = (JSON_ARRAY*)pVal->pValue;
+                ASSERT(pJA);
+                if(pJA)
+                {
+                    if(nIndex >= 0 &&
+                        nIndex < (intptr_t)pJA->arrArrElmts.size())
+                    {
+                        //Got it
+                        JSON_ARRAY_ELEMENT* pJAE = &pJA->arrArrElmts[nIndex];
+
+                        //Type
+                        resType = CJSON::_determineNodeTypeSafe(&pJAE->val);
+                        ASSERT(resType != JNT_NONE && resType != JNT_ERROR);
+
+                        if(pJNodeFound)
+                        {
+                            pJNodeFound->typeNode = resType;
+                            pJNodeFound->strName.clear();
+                            pJNodeFound->pVal = &pJAE->val;
+
+                            pJNodeFound->pJSONData = pJSONData;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return resType;
+}
+
+
+bool JSON_NODE::buildNameIndex(bool bDeep)
+{
+    //Build hash index of names in this object node, no matter how many elements it has
+    //INFO: Otherwise the index is built on the first search by name in objects with at least JSON_NAME_INDEX_MIN_CNT elements.
+    //INFO: Building it ahead of time also makes sure that searches by name don't change the object, which allows
+    //      to search it from several threads at once (as long as nothing else changes it.)
+    //'bDeep' = true to also build it for all objects nested in this node (this node can then be an array as well)
+    //RETURN:
+    //		= true if success
+    //		= false if error (check CJSON::GetLastError() for info)
+    if(isNodeSet() &&
+        pVal &&
+        (pVal->valType == JVT_OBJECT || (bDeep && pVal->valType == JVT_ARRAY)))
+    {
+        //Frozen data already has all indexes that searches use
+        if(pJSONData->isFrozen())
+            return true;
+
+        return _buildNameIndex(pVal, bDeep);
+    }
+
+    CJSON::SetLastError(ERROR_INVALID_PARAMETER);
+    return false;
+}
+
+bool JSON_NODE::_buildNameIndex(JSON_VALUE* pVal, bool bDeep)
+{
+    //Build hash index of names for 'pVal' if it's an object
+    //'bDeep' = true to also do it for all objects nested in 'pVal'
+    //RETURN:
+    //		= true if success
+    if(pVal->valType == JVT_OBJECT)
+    {
+        JSON_OBJECT* pJO = (JSON_OBJECT*)pVal->pValue;
+        ASSERT(pJO);
+
+        if(!_getNameIndex(pJO, true))
+            return false;
+
+        if(bDeep)
+        {
+            for(size_t i = 0; i < pJO->arrObjElmts.size(); i++)
+            {
+                if(!_buildNameIndex(&pJO->arrObjElmts[i].val, true))
+                    return false;
+            }
+        }
+    }
+    else if(pVal->valType == JVT_ARRAY &&
+        bDeep)
+    {
+        JSON_ARRAY* pJA = (JSON_ARRAY*)pVal->pValue;
+        ASSERT(pJA);
+
+        for(size_t i = 0; i < pJA->arrArrElmts.size(); i++)
+        {
+            if(!_buildNameIndex(&pJA->arrArrElmts[i].val, true))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+bool JSON_NODE::_freezeJSON_VALUE(JSON_VALUE* pVal)
+{
+    //Complete all lookup caches for 'pVal' and all values nested in it, and release spare capacity of their arrays of elements
+    //RETURN:
+    //		= true if success
+    //		= false if out of memory (check CJSON::GetLastError() for info)
+    if(pVal->valType == JVT_OBJECT)
+    {
+        JSON_OBJECT* pJO = (JSON_OBJECT*)pVal->pValue;
+        ASSERT(pJO);
+
+        pJO->arrObjElmts.shrink_to_fit();
+
+        //Build the same index that the first search would
+        if((pJO->arrObjElmts.size() >= JSON_NAME_INDEX_MIN_CNT || pJO->pNameIndex.load(std::memory_order_relaxed)) &&
+            !_getNameIndex(pJO, false))
+        {
+            return false;
+        }
+
+        for(size_t i = 0; i < pJO->arrObjElmts.size(); i++)
+        {
+            if(!_freezeJSON_VALUE(&pJO->arrObjElmts[i].val))
+                return false;
+        }
+    }
+    else if(pVal->valType == JVT_ARRAY)
+    {
+        JSON_ARRAY* pJA = (JSON_ARRAY*)pVal->pValue;
+        ASSERT(pJA);
+
+        pJA->arrArrElmts.shrink_to_fit();
+
+        for(size_t i = 0; i < pJA->arrArrElmts.size(); i++)
+        {
+            if(!_freezeJSON_VALUE(&pJA->arrArrElmts[i].val))
+                return false;
+        }
+    }
+    else if(pVal->valType == JVT_PLAIN)
+    {
+        //Values set directly in JSON_VALUE may not have their type yet
+        if(pVal->nativeType == JNT_NONE &&
+            pVal->plainType == JNT_NONE)
+        {
+            pVal->plainType = CJSON::_determinePlainType(pVal);
+        }
+    }
+
+    return true;
+}
+
+JSON_NAME_INDEX* JSON_NODE::_getNameIndex(JSON_OBJECT* pJO, bool bAnySize)
+{
+    //Get hash index of names for 'pJO', building it if needed
+    //'bAnySize' = true to build it no matter how many elements 'pJO' has, false to build it only for JSON_NAME_INDEX_MIN_CNT elements or more
+    //RETURN:
+    //		= Index, or
+    //		= nullptr if 'pJO' doesn't need one, or if out of memory (check CJSON::GetLastError() for info)
+    //INFO: Searches from several threads may get here for the same object at once, thus an installed index is never
+    //      changed here, and a new one is completed before it's installed, and only the first one to be installed is kept.
+    JSON_NAME_INDEX* pIdx = pJO->pNameIndex.load(std::memory_order_acquire);
+    if(pIdx)
+    {
+        //Adding elements updates it (see _addToNameIndex())
+        ASSERT(pIdx->nCntIndexed == pJO->arrObjElmts.size());
+        return pIdx->nCntIndexed == pJO->arrObjElmts.size() ? pIdx : nullptr;
+    }
+
+    if(!bAnySize &&
+        pJO->arrObjElmts.size() < JSON_NAME_INDEX_MIN_CNT)
+    {
+        //Faster to go through it
+        return nullptr;
+    }
+
+    //Reuse the index that was dropped before, if there's one (it's already in the list of the arena)
+    JSON_NAME_INDEX* pIdxSpare = pJO->pSpareNameIndex.exchange(nullptr, std::memory_order_acquire);
+
+    pIdx = pIdxSpare ? pIdxSpare : new (std::nothrow) JSON_NAME_INDEX;
+    if(!pIdx)
+    {
+        CJSON::SetLastError(ERROR_OUTOFMEMORY);
+        return nullptr;
+    }
+
+    _updateNameIndex(pIdx, pJO);
+
+    JSON_NAME_INDEX* pIdxInstalled = nullptr;
+    if(!pJO->pNameIndex.compare_exchange_strong(pIdxInstalled, pIdx, std::memory_order_acq_rel, std::memory_order_acquire))
+    {
+        //Another thread was faster, use its index
+        if(pIdxSpare)
+        {
+            //The arena deletes it, so put it back
+            pIdx->clear();
+            pJO->pSpareNameIndex.store(pIdx, std::memory_order_release);
+        }
+        else
+            delete pIdx;
+
+        pIdx = pIdxInstalled;
+    }
+    else if(pJO->pArena &&
+        !pIdxSpare)
+    {
+        //Objects from an arena may never be freed one by one, so let the arena delete it
+        pJO->pArena->_addNameIndex(pIdx);
+    }
+
+    return pIdx;
+}
+
+void JSON_NODE::_addToNameIndex(JSON_OBJECT* pJO)
+{
+    //Add elements that were just added to the end of 'pJO' to its hash index of names, if it has one
+    //INFO: Searches never change an installed index, so it has to be kept up-to-date by the calls that add elements
+    JSON_NAME_INDEX* pIdx = pJO->pNameIndex.load(std::memory_order_relaxed);
+    if(pIdx)
+    {
+        _updateNameIndex(pIdx, pJO);
+    }
+}
+
+void JSON_NODE::_updateNameIndex(JSON_NAME_INDEX* pIdx, JSON_OBJECT* pJO)
+{
+    //Add elements that were added to the end of 'pJO' since the last time to 'pIdx'
+    size_t nCntElmts = pJO->arrObjElmts.size();
+
+    if(nCntElmts < pIdx->nCntIndexed)
+    {
+        //Elements were removed without dropping the index
+        ASSERT(nullptr);
+        pIdx->clear();
+    }
+
+    //Hash new names
+    pIdx->chainsCS.arrHashes.resize(nCntElmts);
+    pIdx->chainsCI.arrHashes.resize(nCntElmts);
+
+    const JSON_OBJECT_ELEMENT* pJOEs = pJO->arrObjElmts.data();
+    for(size_t i = pIdx->nCntIndexed; i < nCntElmts; i++)
+    {
+        const WCHAR* pName = pJOEs[i].getNamePtr();
+        intptr_t nchName = pJOEs[i].getNameLen();
+
+        pIdx->chainsCS.arrHashes[i] = _getNameHash(pName, nchName);
+
+        if(!_getFoldedNameHash(pName, nchName, &pIdx->chainsCI.arrHashes[i]))
+            pIdx->arrNotFolded.push_back(i);
+    }
+
+    pIdx->chainsCS.arrNext.resize(nCntElmts, -1);
+    pIdx->chainsCI.arrNext.resize(nCntElmts, -1);
+
+    size_t nCntBuckets = pIdx->nMask + 1;
+    if(pIdx->chainsCS.arrHeads.empty() ||
+        nCntElmts > nCntBuckets)
+    {
+        //Need more buckets, so put all elements in again
+        nCntBuckets = JSON_NAME_INDEX_MIN_CNT;
+        while(nCntBuckets < nCntElmts * 2)
+            nCntBuckets *= 2;
+
+        pIdx->nMask = nCntBuckets - 1;
+
+        JSON_NAME_INDEX::CHAINS* pChains[] = { &pIdx->chainsCS, &pIdx->chainsCI };
+        for(size_t c = 0; c < SIZEOF(pChains); c++)
+        {
+            pChains[c]->arrHeads.assign(nCntBuckets, -1);
+            pChains[c]->arrTails.assign(nCntBuckets, -1);
+            pChains[c]->arrNext.assign(nCntElmts, -1);
+        }
+
+        pIdx->nCntIndexed = 0;
+    }
+
+    //Add elements to chains in the order of their indexes
+    const intptr_t* pNotFolded = pIdx->arrNotFolded.data();
+    const intptr_t* pNotFoldedEnd = pNotFolded + pIdx->arrNotFolded.size();
+    pNotFolded = std::lower_bound(pNotFolded, pNotFoldedEnd, (intptr_t)pIdx->nCntIndexed);
+
+    for(size_t i = pIdx->nCntIndexed; i < nCntElmts; i++)
+    {
+        _addToNameChains(pIdx->chainsCS, i, pIdx->nMask);
+
+        if(pNotFolded < pNotFoldedEnd &&
+            *pNotFolded == (intptr_t)i)
+        {
+            //Not in case-insensitive chains
+            pNotFolded++;
+        }
+        else
+            _addToNameChains(pIdx->chainsCI, i, pIdx->nMask);
+    }
+
+    pIdx->nCntIndexed = nCntElmts;
+}
+
+void JSON_NODE::_addToNameChains(JSON_NAME_INDEX::CHAINS& chains, intptr_t nInd, size_t nMask)
+{
+    //Add element 'nInd' to the end of its chain
+    size_t nBucket = chains.arrHashes[nInd] & nMask;
+
+    intptr_t nTail = chains.arrTails[nBucket];
+    if(nTail >= 0)
+        chains.arrNext[nTail] = nInd;
+    else
+        chains.arrHeads[nBucket] = nInd;
+
+    chains.arrTails[nBucket] = nInd;
+}
+
+intptr_t JSON_NODE::_findInNameIndex(JSON_NAME_INDEX* pIdx, JSON_OBJECT* pJO, LPCTSTR pStrName, intptr_t nchName, bool bCaseSensitive, intptr_t nFrom)
+{
+    //Look for the first element in 'pJO' with the name 'pStrName', starting from 'nFrom'
+    //'pIdx' = index of names in 'pJO' (must be up-to-date)
+    //'nchName' = length of 'pStrName' in TCHARs
+    //RETURN:
+    //		= [0 and up) Index of the element found, or
+    //		= -1 if none, or
+    //		= -2 if 'pStrName' can't be looked up in the index
+    ASSERT(pIdx->nCntIndexed == pJO->arrObjElmts.size());
+    const JSON_OBJECT_ELEMENT* pJOEs = pJO->arrObjElmts.data();
+
+    if(bCaseSensitive)
+    {
+        size_t nHash = _getNameHash(pStrName, nchName);
+        const JSON_NAME_INDEX::CHAINS& chains = pIdx->chainsCS;
+
+        //When continuing after an element in the same chain (as with repeated names), go on from it instead of the head of the chain
+        intptr_t i = chains.arrHeads[nHash & pIdx->nMask];
+        if(nFrom > 0 &&
+            nFrom <= (intptr_t)pIdx->nCntIndexed &&
+            ((chains.arrHashes[nFrom - 1] ^ nHash) & pIdx->nMask) == 0)
+        {
+            i = chains.arrNext[nFrom - 1];
+        }
+
+        for(; i >= 0; i = chains.arrNext[i])
+        {
+            if(i >= nFrom &&
+                chains.arrHashes[i] == nHash &&
+                pJOEs[i].getNameLen() == nchName &&
+                memcmp(pJOEs[i].getNamePtr(), pStrName, nchName * sizeof(WCHAR)) == 0)
+            {
+                return i;
+            }
+        }
+
+        return -1;
+    }
+
+    size_t nHash;
+    if(!_getFoldedNameHash(pStrName, nchName, &nHash))
+        return -2;
+
+    intptr_t nFndInd = -1;
+
+    const JSON_NAME_INDEX::CHAINS& chains = pIdx->chainsCI;
+    const intptr_t* pNotFolded = pIdx->arrNotFolded.data();
+    const intptr_t* pNotFoldedEnd = pNotFolded + pIdx->arrNotFolded.size();
+
+    //Same as above, but elements with names that couldn't be case-folded are not in any chain
+    intptr_t i = chains.arrHeads[nHash & pIdx->nMask];
+    if(nFrom > 0 &&
+        nFrom <= (intptr_t)pIdx->nCntIndexed &&
+        ((chains.arrHashes[nFrom - 1] ^ nHash) & pIdx->nMask) == 0 &&
+        !std::binary_search(pNotFolded, pNotFoldedEnd, nFrom - 1))
+    {
+        i = chains.arrNext[nFrom - 1];
+    }
+
+    for(; i >= 0; i = chains.arrNext[i])
+    {
+        if(i >= nFrom &&
+            chains.arrHashes[i] == nHash &&
+            compareStringsEqual(pJOEs[i].getNamePtr(), pJOEs[i].getNameLen(), pStrName, nchName, false))
+        {
+            nFndInd = i;
+            break;
+        }
+    }
+
+    //Names that couldn't be case-folded may still match, so check those before it
+    for(const intptr_t* p = std::lower_bound(pNotFolded, pNotFoldedEnd, nFrom); p < pNotFoldedEnd; p++)
+    {
+        if(nFndInd >= 0 &&
+            *p > nFndInd)
+        {
+            break;
+        }
+
+        if(compareStringsEqual(pJOEs[*p].getNamePtr(), pJOEs[*p].getNameLen(), pStrName, nchName, false))
+        {
+            nFndInd = *p;
+            break;
+        }
+    }
+
+    return nFndInd;
+}
+
+size_t JSON_NODE::_getNameHash(const WCHAR* pStr, intptr_t nchLen)
+{
+    //RETURN: = Hash of the name in 'pStr' of 'nchLen' TCHARs, for case-sensitive search
+    //INFO: FNV-1a
+    uint64_t uiHash = 14695981039346656037ULL;
+
+    for(intptr_t i = 0; i < nchLen; i++)
+    {
+#ifdef _WIN32
+        //Windows specific
+        UINT z = (unsigned short)pStr[i];
+#elif JSON_UTF8
+        //macOS & POSIX specific
+        UINT z = (BYTE)pStr[i];
+#endif
+        uiHash = (uiHash ^ z) * 1099511628211ULL;
+    }
+
+    return (size_t)(uiHash ^ (uiHash >> 32));
+}
+
+bool JSON_NODE::_getFoldedNameHash(const WCHAR* pStr, intptr_t nchLen, size_t* pOutHash)
+{
+    //Calculate hash of the name in 'pStr' of 'nchLen' TCHARs, for case-insensitive search
+    //INFO: Names that compareStringsEqual() sees as equal (when not case-sensitive) must get the same hash.
+    //'pOutHash' = receives the hash
+    //RETURN:
+    //		= true if success
+    //		= false if the name can't be hashed this way (it must be compared with compareStringsEqual() then)
+    uint64_t uiHash = 14695981039346656037ULL;
+
+    for(intptr_t i = 0; i < nchLen; )
+    {
+#ifdef _WIN32
+        //Windows specific
+
+        //INFO: Case-insensitive comparison uses the OS locale rules there, so we can fold only printable ASCII
+        UINT z = (UINT)pStr[i];
+        if(z < 0x20 ||
+            z > 0x7E)
+        {
+            return false;
+        }
+
+        if(z >= 'A' &&
+            z <= 'Z')
+        {
+            z += 'a' - 'A';
+        }
+
+        i++;
+
+#else
+        //macOS & POSIX specific
+
+        //INFO: Same simple per-character case mapping as _compareStringsEqualNoCase_POSIX()
+        UINT z = (BYTE)pStr[i];
+        if(z < 0x80)
+        {
+            z = _toLowerCaseChar_POSIX(z);
+            i++;
+        }
+        else
+        {
+            intptr_t ncb = getUtf8Char(pStr, i, nchLen, &z);
+            if(ncb <= 0)
+                return false;
+
+            z = _toLowerCaseChar_POSIX(z);
+            i += ncb;
+        }
+#endif
+
+        uiHash = (uiHash ^ z) * 1099511628211ULL;
+    }
+
+    *pOutHash = (size_t)(uiHash ^ (uiHash >> 32));
+    return true;
+}
+
+
+JSON_NODE_TYPE JSON_NODE::findNodeByName(LPCTSTR pStrName, JSON_NODE* pJNodeFound, bool bCaseSensitive, JSON_SRCH* pJSrch)
+{
+    //Look for the next node in this node with the name 'pStrName'
+    //INFO: Can be called repeatedly if 'JSON_SRCH' is used
+    //INFO: This node must be an object node only
+    //'pStrName' = node (or element) name to look for (cannot be ""!)
+    //'pJNodeFound' = if not nullptr, receives the data for the node found
+    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
+    //'pJSrch' = if not nullptr, must be used for repeated searches for the same node name (keep calling this method while it succeeds in finding)
+    //RETURN:
+    //		= Node type if found, or
+    //		= JNT_NONE if nothing was found, or
+    //		= JNT_ERROR if error in search parameters
+    JSON_NODE_TYPE resType = JNT_ERROR;
+
+    if(isNodeSet() &&
+        pStrName &&
+        pStrName[0])
+    {
+        ASSERT(pVal);
+        if(pVal)
+        {
+            //Only if it's an object
+            if(pVal->valType == JVT_OBJECT)
+            {
+                JSON_OBJECT* pJO = (JSON_OBJECT*)pVal->pValue;
+                if(pJO)
+                {
+                    //Assume nothing was found
+                    resType = JNT_NONE;
+
+                    intptr_t nCntJOs = (intptr_t)pJO->arrObjElmts.size();
+                    JSON_OBJECT_ELEMENT* pJOEs = pJO->arrObjElmts.data();
+
+                    intptr_t nFndInd = -2;
+                    intptr_t nLnStrName = STRLEN(pStrName);
+
+                    //Use hash index for larger objects
+                    JSON_NAME_INDEX* pIdx = _getNameIndex(pJO, false);
+                    if(pIdx)
+                        nFndInd = _findInNameIndex(pIdx, pJO, pStrName, nLnStrName, bCaseSensitive, pJSrch ? pJSrch->nIndex : 0);
+
+                    if(nFndInd == -2)
+                    {
+                        //Go through all elements
+                        nFndInd = -1;
+
+                        if(bCaseSensitive)
+                        {
+                            //Case sensitive search
+                            for(intptr_t i = pJSrch ? pJSrch->nIndex : 0; i < nCntJOs; i++)
+                            {
+                                if(nLnStrName == pJOEs[i].getNameLen() &&
+                                    memcmp(pJOEs[i].getNamePtr(), pStrName, nLnStrName * sizeof(WCHAR)) == 0)
+                                {
+                                    //Matched
+                                    nFndInd = i;
+                                    break;
+                                }
+                            }
+                        }
+                        else
+                        {
+                            //Case insensitive search
+                            for(intptr_t i = pJSrch ? pJSrch->nIndex : 0; i < nCntJOs; i++)
+                            {
+                                if(JSON_NODE::compareStringsEqual(pJOEs[i].getNamePtr(),
+                                                                  pJOEs[i].getNameLen(),
+                                                                  pStrName,
+                                                                  nLnStrName,
+                                                                  false))
+                                {
+                                    //Matched
+                                    nFndInd = i;
+                                    break;
+                                }
+                            }
+                        }
+                    }
+
+                    //Did we find it?
+                    if(nFndInd >= 0 &&
+                        nFndInd < nCntJOs)
+                    {
+                        //Determine node type
+                        resType = CJSON::_determineNodeTypeSafe(&pJOEs[nFndInd].val);
+                        ASSERT(resType != JNT_NONE && resType != JNT_ERROR);
+
+                        //Do we need to return it?
+                        if(pJNodeFound)
+                        {
+                            //Fill out the node found
+                            pJNodeFound->typeNode = resType;
+                            pJOEs[nFndInd].getName(pJNodeFound->strName);
+                            pJNodeFound->pVal = &pJOEs[nFndInd].val;
+
+                            pJNodeFound->pJSONData = pJSONData;
+                        }
+
+                        //Did we have a search struct?
+                        if(pJSrch)
+                        {
+                            //Update index for the next search
+                            pJSrch->nIndex = nFndInd + 1;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return resType;
+}
+
+
+JSON_NODE_TYPE JSON_NODE::findNodeByNameAndGetValueAsString(LPCTSTR pStrName, std_wstring* pOutStr, bool bCaseSensitive)
+{
+    //Look for the first node in this node with the name 'pStrName'
+    //INFO: This node must be an object node only
+    //INFO: In case of more than one node matching the search, only the first one is retrieved
+    //'pStrName' = node (or element) name to look for (cannot be ""!)
+    //'pOutStr' = if not nullptr, receives the found node value
+    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
+    //RETURN:
+    //		= Node type if found, or
+    //		= JNT_NONE if nothing was found, or
+    //		= JNT_ERROR if error in search parameters, or retrieval
+    JSON_NODE jsnNd;
+    JSON_NODE_TYPE type = findNodeByName(pStrName, &jsnNd, bCaseSensitive);
+    if(type > JNT_NONE)
+    {
+        //Read as string
+        if(!jsnNd.getValueAsString(pOutStr))
+        {
+            //Failed
+            ASSERT(nullptr);
+            type = JNT_ERROR;
+        }
+    }
+
+    return type;
+}
+
+JSON_NODE_TYPE JSON_NODE::findNodeByNameAndGetValueAsInt32(LPCTSTR pStrName, int* pOuVal, bool bCaseSensitive)
+{
+    //Look for the first node in this node with the name 'pStrName'
+    //INFO: This node must be an object node only
+    //INFO: In case of more than one node matching the search, only the first one is retrieved
+    //'pStrName' = node (or element) name to look for (cannot be ""!)
+    //'pOuVal' = if not nullptr, receives the found node value
+    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
+    //RETURN:
+    //        = Node type if found, or
+    //        = JNT_NONE if nothing was found, or
+    //        = JNT_ERROR if error in search parameters, or retrieval
+    JSON_NODE jsnNd;
+    JSON_NODE_TYPE type = findNodeByName(pStrName, &jsnNd, bCaseSensitive);
+    if(type > JNT_NONE)
+    {
+        //Read as string
+        if(!jsnNd.getValueAsInt32(pOuVal))
+        {
+            //Failed
+            ASSERT(nullptr);
+            type = JNT_ERROR;
+        }
+    }
+
+    return type;
+}
+
+JSON_NODE_TYPE JSON_NODE::findNodeByNameAndGetValueAsInt64(LPCTSTR pStrName, int64_t* pOuVal, bool bCaseSensitive)
+{
+    //Look for the first node in this node with the name 'pStrName'
+    //INFO: This node must be an object node only
+    //INFO: In case of more than one node matching the search, only the first one is retrieved
+    //'pStrName' = node (or element) name to look for (cannot be ""!)
+    //'pOuVal' = if not nullptr, receives the found node value
+    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
+    //RETURN:
+    //        = Node type if found, or
+    //        = JNT_NONE if nothing was found, or
+    //        = JNT_ERROR if error in search parameters, or retrieval
+    JSON_NODE jsnNd;
+    JSON_NODE_TYPE type = findNodeByName(pStrName, &jsnNd, bCaseSensitive);
+    if(type > JNT_NONE)
+    {
+        //Read as string
+        if(!jsnNd.getValueAsInt64(pOuVal))
+        {
+            //Failed
+            ASSERT(nullptr);
+            type = JNT_ERROR;
+        }
+    }
+
+    return type;
+}
+
+JSON_NODE_TYPE JSON_NODE::findNodeByNameAndGetValueAsBool(LPCTSTR pStrName, bool* pOuVal, bool bCaseSensitive)
+{
+    //Look for the first node in this node with the name 'pStrName'
+    //INFO: This node must be an object node only
+    //INFO: In case of more than one node matching the search, only the first one is retrieved
+    //'pStrName' = node (or element) name to look for (cannot be ""!)
+    //'pOuVal' = if not nullptr, receives the found node value
+    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
+    //RETURN:
+    //        = Node type if found, or
+    //        = JNT_NONE if nothing was found, or
+    //        = JNT_ERROR if error in search parameters, or retrieval
+    JSON_NODE jsnNd;
+    JSON_NODE_TYPE type = findNodeByName(pStrName, &jsnNd, bCaseSensitive);
+    if(type > JNT_NONE)
+    {
+        //Read as string
+        if(!jsnNd.getValueAsBool(pOuVal))
+        {
+            //Failed
+            ASSERT(nullptr);
+            type = JNT_ERROR;
+        }
+    }
+
+    return type;
+}
+
+
+JSON_NODE_TYPE JSON_NODE::findNodeByIndexAndGetValueAsString(intptr_t nIndex, std_wstring* pOutStr)
+{
+    //Look for the node in this node with the 'nIndex'
+    //INFO: This node must be an object or array node
+    //'nIndex' = node zero-based index (use JSON_NODE::getNodeCount() to get number of nodes)
+    //'pOutStr' = if not nullptr, receives the found node value
+    //RETURN:
+    //		= Node type if found, or
+    //		= JNT_ERROR if error in search parameters
+    JSON_NODE jsnNd;
+    JSON_NODE_TYPE type = this->findNodeByIndex(nIndex, &jsnNd);
+    if(type > JNT_NONE)
+    {
+        //Read as string
+        if(!jsnNd.getValueAsString(pOutStr))
+        {
+            //Failed
+            ASSERT(nullptr);
+            type = JNT_ERROR;
+        }
+    }
+
+    return type;
+}
+
+
+bool JSON_NODE::_canChange(JSON_DATA* pOtherData)
+{
+    //Check that JSON data of this node, and 'pOtherData' (if it's not nullptr) can be changed
+    //RETURN:
+    //		= true if yes
+    //		= false if either one was frozen with JSON_DATA::freeze() (CJSON::GetLastError() is set to ERROR_ACCESS_DENIED)
+    if((pJSONData && pJSONData->isFrozen()) ||
+        (pOtherData && pOtherData->isFrozen()))
+    {
+        CJSON::SetLastError(ERROR_ACCESS_DENIED);
+        return false;
+    }
+
+    //Changes may add memory that is not in the arena, so it has to be freed node by node from now on
+    if(pJSONData)
+        pJSONData->bOnlyInArena = false;
+    if(pOtherData)
+        pOtherData->bOnlyInArena = false;
+
+    return true;
+}
+
+
+bool JSON_NODE::setAsRootNode(JSON_DATA* pJSON_Data)
+{
+    //Set this node as a root node
+    //INFO: This will erase all data from this node
+    //INFO: Can be called on the node that is not set yet, or on a previous root node only
+    //'pJSON_Data' = JSON data holder, or nullptr to reuse existing data holder (if one was previously present)
+    //RETURN:
+    //		= true if success
+    if(!_canChange(pJSON_Data))
+        return false;
+
+    bool bRes = false;
+
+    //Is it OK to change it
+    bool bOKToSetIt = true;
+
+    //Is this node set?
+    bool bNodeIsSet = this->isNodeSet();
+    if(bNodeIsSet)
+    {
+        if(this->typeNode != JNT_ROOT)
+        {
+            //Can't make it a root node
+            bOKToSetIt = false;
+        }
+    }
+
+    if(bOKToSetIt)
+    {
+        //Pick JSON data
+        if(!pJSON_Data)
+            pJSON_Data = pJSONData;
+
+        ASSERT(pJSON_Data);
+        if(pJSON_Data)
+        {
+            //First create an empty object
+            JSON_OBJECT* pJO = CJSON::_newJSON_OBJECT(pJSON_Data->getArena());
+            if(pJO)
+            {
+                //Was it set?
+                if(bNodeIsSet)
+                {
+                    //Delete its data first
+                    ASSERT(pVal);
+                    _freeJSON_VALUE(*pVal);
+
+                    pVal = nullptr;
+                }
+
+                //Remember JSON data
+                pJSONData = pJSON_Data;
+
+                //Set root data
+                pJSON_Data->val.strValue.clear();
+                pJSON_Data->val.resetStrRef();
+                pJSON_Data->val.valType = JVT_OBJECT;
+                pJSON_Data->val.pValue = pJO;
+
+                //Set it as an empty object
+                this->strName.clear();
+                this->typeNode = JNT_ROOT;
+                this->pVal = &pJSON_Data->val;
+
+                //Done
+                bRes = true;
+            }
+        }
+    }
+
+    return bRes;
+}
+
+
+bool JSON_NODE::setAsEmptyNode(JSON_DATA* pJSON_Data, JSON_NODE_TYPE type)
+{
+    //Set this node as a empty node
+    //INFO: This will erase all data from this node
+    //INFO: Can be called on the node that is not set yet, or on a previously used node
+    //'pJSON_Data' = JSON data holder, or nullptr to reuse existing data holder (if one was previously present)
+    //'type' = type of node to set, can be: JNT_OBJECT or JNT_ARRAY
+    //RETURN:
+    //		= true if success
+    if(!_canChange(pJSON_Data))
+        return false;
+
+    bool bRes = false;
+
+    //Pick JSON data
+    if(!pJSON_Data)
+        pJSON_Data = pJSONData;
+
+    ASSERT(pJSON_Data);
+    if(pJSON_Data)
+    {
+        //Create new element
+        if(type == JNT_OBJECT)
+        {
+            JSON_OBJECT* pJO = CJSON::_newJSON_OBJECT(pJSON_Data->getArena());
+            ASSERT(pJO);
+            if(pJO)
+            {
+                //Was node set?
+                if(isNodeSet())
+                {
+                    //Delete its data first
+                    ASSERT(pVal);
+                    _freeJSON_VALUE(*pVal);
+
+                    pVal = nullptr;
+                }
+
+                //Remember JSON data
+                pJSONData = pJSON_Data;
+
+                //Set root data
+                pJSON_Data->val.strValue.clear();
+                pJSON_Data->val.resetStrRef();
+                pJSON_Data->val.valType = JVT_OBJECT;
+                pJSON_Data->val.pValue = pJO;
+
+                //Set it as an empty object
+                this->strName.clear();
+                this->typeNode = JNT_OBJECT;
+                this->pVal = &pJSON_Data->val;
+
+                //Done
+                bRes = true;
+            }
+        }
+        else if(type == JNT_ARRAY)
+        {
+            JSON_ARRAY* pJA = CJSON::_newJSON_ARRAY(pJSON_Data->getArena());
+            ASSERT(pJA);
+            if(pJA)
+            {
+                //Was node set?
+                if(isNodeSet())
+                {
+                    //Delete its data first
+                    ASSERT(pVal);
+                    _freeJSON_VALUE(*pVal);
+
+                    pVal = nullptr;
+                }
+
+                //Remember JSON data
+                pJSONData = pJSON_Data;
+
+                //Set root data
+                pJSON_Data->val.strValue.clear();
+                pJSON_Data->val.resetStrRef();
+                pJSON_Data->val.valType = JVT_ARRAY;
+                pJSON_Data->val.pValue = pJA;
+
+                //Set it as an empty object
+                this->strName.clear();
+                this->typeNode = JNT_ARRAY;
+                this->pVal = &pJSON_Data->val;
+
+                //Done
+                bRes = true;
+            }
+        }
+
+    }
+
+    return bRes;
+}
+
+
+
+bool CJSON::_deepCopyJSON_VALUE(JSON_VALUE* pDestV, JSON_VALUE* pSrcV, JSON_ARENA* pArena)
+{
+    //Copy 'pSrcV' into 'pDestV' by erasing previous values in 'pDestV'
+    //'pArena' = arena of the JSON data that 'pDestV' belongs to, or nullptr if it uses the heap
+    //RETURN:
+    //		= true if success
+    bool bRes = false;
+
+    if(pDestV &&
+        pSrcV)
+    {
+        //First erase the dest
+        if(!pDestV->isEmptyValue())
+        {
+            CJSON::_freeJSON_VALUE(*pDestV);
+
+            pDestV->pValue = nullptr;
+            pDestV->valType = JVT_NONE;
+            pDestV->strValue.clear();
+            pDestV->resetStrRef();
+        }
+
+        //Then begin copying
+        bRes = __copySingleVal(pDestV, pSrcV, pArena);
+    }
+
+    return bRes;
+}
+
+
+bool CJSON::_moveJSON_VALUE(JSON_VALUE* pDestV, JSON_NODE* pSrcNode, JSON_ARENA* pArena)
+{
+    //Move value of 'pSrcNode' into 'pDestV' by erasing previous values in 'pDestV'
+    //INFO: Objects and arrays are taken over without copying, unless the source JSON data uses an arena
+    //INFO: The source value is set to null afterwards, or if it was the root value of its JSON data, that JSON data is emptied
+    //'pArena' = arena of the JSON data that 'pDestV' belongs to, or nullptr if it uses the heap
+    //RETURN:
+    //		= true if success
+    ASSERT(pDestV);
+    ASSERT(pSrcNode);
+    JSON_VALUE* pSrcV = pSrcNode->pVal;
+    JSON_DATA* pSrcData = pSrcNode->pJSONData;
+    if(!pDestV ||
+        !pSrcV ||
+        !pSrcData)
+    {
+        return false;
+    }
+
+    if(pSrcData->getArena())
+    {
+        //Its objects and arrays will be gone when that arena is reset, so copy them
+        if(!_deepCopyJSON_VALUE(pDestV, pSrcV, pArena))
+            return false;
+
+        _freeJSON_VALUE(*pSrcV);
+    }
+    else
+    {
+        //Erase the dest
+        if(!pDestV->isEmptyValue())
+            _freeJSON_VALUE(*pDestV);
+
+        //And take it all over
+        pDestV->valType = pSrcV->valType;
+        pDestV->pValue = pSrcV->pValue;
+        pDestV->strValue.swap(pSrcV->strValue);
+        pDestV->pStrRef = pSrcV->pStrRef;
+        pDestV->nchStrRef = pSrcV->nchStrRef;
+        pDestV->nativeType = pSrcV->nativeType;
+        pDestV->iiNative = pSrcV->iiNative;
+        pDestV->plainType = pSrcV->plainType;
+    }
+
+    pSrcV->valType = JVT_NONE;
+    pSrcV->pValue = nullptr;
+    pSrcV->strValue.clear();
+    pSrcV->resetStrRef();
+
+    if(pSrcV == &pSrcData->val)
+    {
+        //Root value
+        pSrcData->emptyData();
+    }
+    else
+    {
+        //Leave null in its place
+        pSrcV->valType = JVT_PLAIN;
+        pSrcV->strValue = L("null");
+        pSrcV->plainType = JNT_NULL;
+        pSrcNode->typeNode = JNT_NULL;
+    }
+
+    return true;
+}
+
+bool CJSON::__copySingleVal(JSON_VALUE* pDestV, JSON_VALUE* pSrcV, JSON_ARENA* pArena)
+{
+    bool bRes = false;
+    ASSERT(pDestV);
+    ASSERT(pSrcV);
+
+    switch(pSrcV->valType)
+    {
+    case JVT_NONE:
+    case JVT_PLAIN:
+    case JVT_DOUBLE_QUOTED:
+        {
+            pDestV->valType = pSrcV->valType;
+            pDestV->resetStrRef();
+            pDestV->pValue = nullptr;
+
+            //Keep the converted value as well (see JPF_NATIVE_VALUES)
+            if(pSrcV->isNativeOnly())
+                pDestV->strValue.clear();
+            else
+                pSrcV->getStr(pDestV->strValue);
+
+            pDestV->nativeType = pSrcV->nativeType;
+            pDestV->iiNative = pSrcV->iiNative;
+            pDestV->plainType = pSrcV->plainType;
+
+            bRes = true;
+        }
+        break;
+
+    case JVT_ARRAY:
+        {
+            pDestV->valType = pSrcV->valType;
+            pSrcV->getStr(pDestV->strValue);
+            pDestV->resetStrRef();
+            pDestV->pValue = nullptr;
+
+            JSON_ARRAY* pSrcJA = (JSON_ARRAY*)pSrcV->pValue;
+            ASSERT(pSrcJA);
+            if(pSrcJA)
+            {
+                JSON_ARRAY* pDestJA = _newJSON_ARRAY(pArena);
+                ASSERT(pDestJA);
+                if(pDestJA)
+                {
+                    //Assume success
+                    bRes = true;
+
+                    for(intptr_t i = 0; i < (intptr_t)pSrcJA->arrArrElmts.size(); i++)
+                    {
+                        JSON_ARRAY_ELEMENT jae;
+                        if(__copySingleVal(&jae.val, &pSrcJA->arrArrElmts[i].val, pArena))
+                        {
+                            pDestJA->arrArrElmts.push_back(jae);
+                        }
+                        else
+                        {
+                            //Error
+                            bRes = false;
+                            break;
+                        }
+                    }
+
+                    //Did it go thru?
+                    if(bRes)
+                    {
+                        //Remember the pointer
+                        pDestV->pValue = pDestJA;
+                    }
+                    else
+                    {
+                        //Free it
+                        _freeJSON_ARRAY(pDestJA);
+                    }
+                }
+            }
+        }
+        break;
+
+    case JVT_OBJECT:
+        {
+            pDestV->valType = pSrcV->valType;
+            pSrcV->getStr(pDestV->strValue);
+            pDestV->resetStrRef();
+            pDestV->pValue = nullptr;
+
+            JSON_OBJECT* pSrcJO = (JSON_OBJECT*)pSrcV->pValue;
+            ASSERT(pSrcJO);
+            if(pSrcJO)
+            {
+                JSON_OBJECT* pDestJO = _newJSON_OBJECT(pArena);
+                ASSERT(pDestJO);
+                if(pDestJO)
+                {
+                    //Assume success
+                    bRes = true;
+
+                    intptr_t nCntJOs = (intptr_t)pSrcJO->arrObjElmts.size();
+                    JSON_OBJECT_ELEMENT* pJOEs = pSrcJO->arrObjElmts.data();
+
+                    for(intptr_t i = 0; i < nCntJOs; i++)
+                    {
+                        JSON_OBJECT_ELEMENT joe;
+                        if(__copySingleVal(&joe.val, &pJOEs[i].val, pArena))
+                        {
+                            pJOEs[i].getName(joe.strName);
+
+                            pDestJO->arrObjElmts.push_back(joe);
+                        }
+                        else
+                        {
+                            //Error
+                            bRes = false;
+                            break;
+                        }
+                    }
+
+                    //Did it go thru?
+                    if(bRes)
+                    {
+                        //Remember the pointer
+                        pDestV->pValue = pDestJO;
+                    }
+                    else
+                    {
+                        //Free it
+                        _freeJSON_OBJECT(pDestJO);
+                    }
+                }
+            }
+        }
+        break;
+    }
+
+    return bRes;
+}
+
+
+bool JSON_NODE::addNode(JSON_NODE* pJNode)
+{
+    //Add new 'pJNode' node to this node (where this node is either an object or array node)
+    //INFO: It makes a "deep" copy of 'pJNode'
+    //INFO: Can't be used to add nodes from the same JSON data.
+    //RETURN:
+    //		= true if success
+    return _addNode_FromNode(pJNode, false);
+}
+
+bool JSON_NODE::addNodeMove(JSON_NODE* pJNode)
+{
+    //Add new 'pJNode' node to this node (where this node is either an object or array node) by moving its value here
+    //INFO: Objects and arrays in 'pJNode' are taken over without copying, so adding large parts of JSON this way doesn't depend on their size
+    //      (unless the JSON data of 'pJNode' uses an arena, in which case they have to be copied.)
+    //INFO: When this method succeeds, 'pJNode' is set to null, or if it was the root node of its JSON data, that JSON data is emptied.
+    //INFO: Can't be used to add nodes from the same JSON data.
+    //INFO: If the JSON data of 'pJNode' was parsed with JPF_REFERENCE_SOURCE, its source JSON string must remain unchanged for as long as this JSON data is used too!
+    //RETURN:
+    //		= true if success
+    return _addNode_FromNode(pJNode, true);
+}
+
+
+bool JSON_NODE::_addNode_FromNode(JSON_NODE* pJNode, bool bMove)
+{
+    //Add new 'pJNode' node to this node (where this node is either an object or array node)
+    //INFO: Can't be used to add nodes from the same JSON data.
+    //'bMove' = true to move the value out of 'pJNode' (see addNodeMove()), false to make a "deep" copy of it
+    //RETURN:
+    //		= true if success
+    if(!_canChange(bMove && pJNode ? pJNode->pJSONData : nullptr))
+        return false;
+
+    bool bRes = false;
+    ASSERT(pJSONData);
+
+    //Node must be specified and it must have a name
+    if(pJNode &&
+        pJSONData)
+    {
+        //Make sure that JSON data is not the same
+        if(this->pJSONData != pJNode->pJSONData &&
+            pJNode->pJSONData)
+        {
+            ASSERT(pVal);
+            if(pVal->valType == JVT_OBJECT)
+            {
+                //We must have a name for this node
+                if(!pJNode->strName.empty())
+                {
+                    JSON_OBJECT* pJO = (JSON_OBJECT*)pVal->pValue;
+                    ASSERT(pJO);
+                    if(pJO)
+                    {
+                        //Add new
+                        JSON_OBJECT_ELEMENT joe;
+
+                        //Copy node name
+                        joe.strName = pJNode->strName;
+
+                        //Copy or move value
+                        if(bMove ? CJSON::_moveJSON_VALUE(&joe.val, pJNode, pJSONData->getArena()) :
+                            CJSON::_deepCopyJSON_VALUE(&joe.val, pJNode->pVal, pJSONData->getArena()))
+                        {
+                            //Add it
+                            pJO->arrObjElmts.push_back(std::move(joe));
+                            _addToNameIndex(pJO);
+
+                            //Done
+                            bRes = true;
+                        }
+                    }
+                }
+            }
+            else if(pVal->valType == JVT_ARRAY)
+            {
+                JSON_ARRAY* pJA = (JSON_ARRAY*)pVal->pValue;
+                ASSERT(pJA);
+                if(pJA)
+                {
+                    //Add new
+                    JSON_ARRAY_ELEMENT jae;
+
+                    //Copy or move value
+                    if(bMove ? CJSON::_moveJSON_VALUE(&jae.val, pJNode, pJSONData->getArena()) :
+                        CJSON::_deepCopyJSON_VALUE(&jae.val, pJNode->pVal, pJSONData->getArena()))
+                    {
+                        //Add it
+                        pJA->arrArrElmts.push_back(std::move(jae));
+
+                        //Done
+                        bRes = true;
+                    }
+                }
+            }
+            else
+            {
+                //Can add only to the Array or Object note
+                ASSERT(nullptr);
+            }
+        }
+        else
+        {
+            //Can't use same JSON object
+            ASSERT(nullptr);
+        }
+    }
+
+    return bRes;
+}
+
+
+bool JSON_NODE::_addNode_WithType(LPCTSTR pStrName, JSON_VALUE_TYPE type, LPCTSTR pStrValue)
+{
+    //Add new node to this node (where this node is either an object or array node)
+    //'pStrName' = node name (cannot be empty for objects and not used for arrays)
+    //				INFO: JSON specs do not allow duplicate names (this class allows it.)
+    //				INFO: JSON specs specifies that names are case-sensitive (this class can treat them as case-insensitive when looking for nodes)
+    //						http://tools.ietf.org/html/rfc7158
+    //'type' = type to assign to value. Can be JVT_PLAIN or JVT_DOUBLE_QUOTED
+    //'pStrValue' = value
+    //RETURN:
+    //		= true if success
+    if(!_canChange())
+        return false;
+
+    bool bRes = false;
+    ASSERT(pJSONData);
+
+    if(pJSONData)
+    {
+        //Check allowed types
+        if(type == JVT_PLAIN ||
+            type == JVT_DOUBLE_QUOTED)
+        {
+            ASSERT(pVal);
+            if(pVal->valType == JVT_OBJECT)
+            {
+                //Only if we have a name
+                if(pStrName &&
+                    pStrName[0])
+                {
+                    JSON_OBJECT* pJO = (JSON_OBJECT*)pVal->pValue;
+                    ASSERT(pJO);
+                    if(pJO)
+                    {
+                        //Add new
+                        JSON_OBJECT_ELEMENT joe;
+
+                        //Copy node name
+                        joe.strName = pStrName;
 
                         //And value
                         joe.val.valType = type;
+                        joe.val.resetStrRef();
                         joe.val.strValue = pStrValue ? pStrValue : L("");
                         joe.val.pValue = nullptr;
 
-                        if(type == JVT_PLAIN)
-                        {
-                            //Trim value
-                            CJSON::Trim(joe.val.strValue);
-                        }
+                        if(type == JVT_PLAIN)
+                        {
+                            //Trim value
+                            CJSON::Trim(joe.val.strValue);
+
+                            //Determine its type now, so that lookups don't have to
+                            joe.val.plainType = CJSON::_determinePlainType(&joe.val);
+                        }
+
+                        //Add it
+                        pJO->arrObjElmts.push_back(joe);
+                        _addToNameIndex(pJO);
+
+                        //Done
+                        bRes = true;
+                    }
+                }
+            }
+            else if(pVal->valType == JVT_ARRAY)
+            {
+                JSON_ARRAY* pJA = (JSON_ARRAY*)pVal->pValue;
+                ASSERT(pJA);
+                if(pJA)
+                {
+                    //Add new
+                    JSON_ARRAY_ELEMENT jae;
+
+                    //Set value
+                    jae.val.valType = type;
+                    jae.val.resetStrRef();
+                    jae.val.strValue = pStrValue ? pStrValue : L("");
+                    jae.val.pValue = nullptr;
+
+                    if(type == JVT_PLAIN)
+                    {
+                        //Trim value
+                        CJSON::Trim(jae.val.strValue);
+
+                        //Determine its type now, so that lookups don't have to
+                        jae.val.plainType = CJSON::_determinePlainType(&jae.val);
+                    }
+
+                    //Add it
+                    pJA->arrArrElmts.push_back(jae);
+
+                    //Done
+                    bRes = true;
+                }
+            }
+            else
+            {
+                //Can add only to the Array or Object note
+                ASSERT(nullptr);
+            }
+        }
+    }
+
+    return bRes;
+}
+
+bool JSON_NODE::addNode_String(LPCTSTR pStrName, LPCTSTR pStrValue)
+{
+    //Add new string node to this node (where this node is either an object or array node)
+    //'pStrName' = node name (cannot be empty for objects and not used for arrays)
+    //				INFO: JSON specs do not allow duplicate names (this class allows it.)
+    //				INFO: JSON specs specifies that names are case-sensitive (this class can treat them as case-insensitive when looking for nodes)
+    //						http://tools.ietf.org/html/rfc7158
+    //'pStrValue' = value
+    //RETURN:
+    //		= true if success
+    return _addNode_WithType(pStrName, JVT_DOUBLE_QUOTED, pStrValue);
+}
+
+bool JSON_NODE::addNode_BOOL(LPCTSTR pStrName, bool bValue)
+{
+    //Add new boolean node to this node (where this node is either an object or array node)
+    //'pStrName' = node name (cannot be empty for objects and not used for arrays)
+    //				INFO: JSON specs do not allow duplicate names (this class allows it.)
+    //				INFO: JSON specs specifies that names are case-sensitive (this class can treat them as case-insensitive when looking for nodes)
+    //						http://tools.ietf.org/html/rfc7158
+    //'bValue' = value
+    //RETURN:
+    //		= true if success
+
+    //And add it
+    return _addNode_WithType(pStrName, JVT_PLAIN, bValue ? L("true") : L("false"));
+}
+
+bool JSON_NODE::addNode_Bool(LPCTSTR pStrName, bool bValue)
+{
+    //Add new boolean node to this node (where this node is either an object or array node)
+    //'pStrName' = node name (cannot be empty for objects and not used for arrays)
+    //				INFO: JSON specs do not allow duplicate names (this class allows it.)
+    //				INFO: JSON specs specifies that names are case-sensitive (this class can treat them as case-insensitive when looking for nodes)
+    //						http://tools.ietf.org/html/rfc7158
+    //'bValue' = value
+    //RETURN:
+    //		= true if success
+
+    //And add it
+    return _addNode_WithType(pStrName, JVT_PLAIN, bValue ? L("true") : L("false"));
+}
+
+bool JSON_NODE::addNode_Null(LPCTSTR pStrName)
+{
+    //Add new null node to this node (where this node is either an object or array node)
+    //'pStrName' = node name (cannot be empty for objects and not used for arrays)
+    //				INFO: JSON specs do not allow duplicate names (this class allows it.)
+    //				INFO: JSON specs specifies that names are case-sensitive (this class can treat them as case-insensitive when looking for nodes)
+    //						http://tools.ietf.org/html/rfc7158
+    //RETURN:
+    //		= true if success
+
+    //And add it
+    return _addNode_WithType(pStrName, JVT_PLAIN, L("null"));
+}
+
+bool JSON_NODE::addNode_Int(LPCTSTR pStrName, LPCTSTR pStrValue)
+{
+    //Add new integer node to this node (where this node is either an object or array node)
+    //'pStrName' = node name (cannot be empty for objects and not used for arrays)
+    //				INFO: JSON specs do not allow duplicate names (this class allows it.)
+    //				INFO: JSON specs specifies that names are case-sensitive (this class can treat them as case-insensitive when looking for nodes)
+    //						http://tools.ietf.org/html/rfc7158
+    //'pStrValue' = value
+    //RETURN:
+    //		= true if success
+
+    //Check if number
+    if(!CJSON::isIntegerBase10String(pStrValue))
+        return false;
+
+    //And add it
+    return _addNode_WithType(pStrName, JVT_PLAIN, pStrValue);
+}
+
+bool JSON_NODE::addNode_Int(LPCTSTR pStrName, int nValue)
+{
+    //Add new integer node to this node (where this node is either an object or array node)
+    //'pStrName' = node name (cannot be empty for objects and not used for arrays)
+    //				INFO: JSON specs do not allow duplicate names (this class allows it.)
+    //				INFO: JSON specs specifies that names are case-sensitive (this class can treat them as case-insensitive when looking for nodes)
+    //						http://tools.ietf.org/html/rfc7158
+    //'nValue' = value
+    //RETURN:
+    //		= true if success
+
+    //Format it
+    WCHAR buff[JSON_NUMBER_BUFF_LEN];
+    CJSON::_formatInt64(nValue, buff);
+
+    //And add it
+    return _addNode_WithType(pStrName, JVT_PLAIN, buff);
+}
+
+bool JSON_NODE::addNode_Int64(LPCTSTR pStrName, LPCTSTR pStrValue)
+{
+    //Add new 64-bit integer node to this node (where this node is either an object or array node)
+    //'pStrName' = node name (cannot be empty for objects and not used for arrays)
+    //				INFO: JSON specs do not allow duplicate names (this class allows it.)
+    //				INFO: JSON specs specifies that names are case-sensitive (this class can treat them as case-insensitive when looking for nodes)
+    //						http://tools.ietf.org/html/rfc7158
+    //'pStrValue' = value
+    //RETURN:
+    //		= true if success
+    return addNode_Int(pStrName, pStrValue);
+}
+
+bool JSON_NODE::addNode_Int64(LPCTSTR pStrName, int64_t iiValue)
+{
+    //Add new 64-bit integer node to this node (where this node is either an object or array node)
+    //'pStrName' = node name (cannot be empty for objects and not used for arrays)
+    //				INFO: JSON specs do not allow duplicate names (this class allows it.)
+    //				INFO: JSON specs specifies that names are case-sensitive (this class can treat them as case-insensitive when looking for nodes)
+    //						http://tools.ietf.org/html/rfc7158
+    //'nValue' = value
+    //RETURN:
+    //		= true if success
+
+    //Format it
+    WCHAR buff[JSON_NUMBER_BUFF_LEN];
+    CJSON::_formatInt64(iiValue, buff);
+
+    //And add it
+    return _addNode_WithType(pStrName, JVT_PLAIN, buff);
+}
+
+
+bool JSON_NODE::addNode_Double(LPCTSTR pStrName, LPCTSTR pStrValue)
+{
+    //Add new floating point value node to this node (where this node is either an object or array node)
+    //'pStrName' = node name (cannot be empty for objects and not used for arrays)
+    //				INFO: JSON specs do not allow duplicate names (this class allows it.)
+    //				INFO: JSON specs specifies that names are case-sensitive (this class can treat them as case-insensitive when looking for nodes)
+    //						http://tools.ietf.org/html/rfc7158
+    //'pStrValue' = value
+    //RETURN:
+    //		= true if success
+
+    //Check if number
+    if(!CJSON::isFloatingPointNumberString(pStrValue))
+        return false;
+
+    //And add it
+    return _addNode_WithType(pStrName, JVT_PLAIN, pStrValue);
+}
+
+bool JSON_NODE::addNode_Double(LPCTSTR pStrName, double fValue)
+{
+    //Add new floating point value node to this node (where this node is either an object or array node)
+    //'pStrName' = node name (cannot be empty for objects and not used for arrays)
+    //				INFO: JSON specs do not allow duplicate names (this class allows it.)
+    //				INFO: JSON specs specifies that names are case-sensitive (this class can treat them as case-insensitive when looking for nodes)
+    //						http://tools.ietf.org/html/rfc7158
+    //'nValue' = value
+    //RETURN:
+    //		= true if success
+
+    //Format it
+    WCHAR buff[JSON_NUMBER_BUFF_LEN];
+    CJSON::_formatDouble(fValue, buff);
+
+    //And add it
+    return _addNode_WithType(pStrName, JVT_PLAIN, buff);
+}
+
+
+
+intptr_t JSON_NODE::setNodeByName(LPCTSTR pStrName, JSON_NODE* pJNode, bool bCaseSensitive)
+{
+    //Set node with 'pStrName' in this node to a new value
+    //INFO: It makes a "deep" copy of 'pJNode'
+    //INFO: Can't be used to set nodes from the same JSON data.
+    //INFO: Sets ALL nodes with the matching name, if there's more than one
+    //'pStrName' = node name to set (cannot be empty)
+    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
+    //RETURN:
+    //		= [1 and up) number if nodes set, or
+    //		= 0 if no nodes matched the name provided
+    //		= -1 if error setting (some elements might have been copied into destination node)
+    return _setNodeByName_FromNode(pStrName, pJNode, bCaseSensitive, false);
+}
+
+intptr_t JSON_NODE::setNodeByNameMove(LPCTSTR pStrName, JSON_NODE* pJNode, bool bCaseSensitive)
+{
+    //Set node with 'pStrName' in this node to a new value by moving the value of 'pJNode' there
+    //INFO: Works the same as addNodeMove() for the source node
+    //INFO: Sets ALL nodes with the matching name, if there's more than one (the value is moved into the first one, and copied into the rest)
+    //'pStrName' = node name to set (cannot be empty)
+    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
+    //RETURN:
+    //		= [1 and up) number if nodes set, or
+    //		= 0 if no nodes matched the name provided ('pJNode' is not changed then)
+    //		= -1 if error setting (some elements might have been copied into destination node)
+    return _setNodeByName_FromNode(pStrName, pJNode, bCaseSensitive, true);
+}
+
+
+intptr_t JSON_NODE::_setNodeByName_FromNode(LPCTSTR pStrName, JSON_NODE* pJNode, bool bCaseSensitive, bool bMove)
+{
+    //Set node with 'pStrName' in this node to a new value
+    //INFO: Can't be used to set nodes from the same JSON data.
+    //INFO: Sets ALL nodes with the matching name, if there's more than one
+    //'pStrName' = node name to set (cannot be empty)
+    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
+    //'bMove' = true to move the value out of 'pJNode' into the first node found (see setNodeByNameMove()), false to make a "deep" copy of it
+    //RETURN:
+    //		= [1 and up) number if nodes set, or
+    //		= 0 if no nodes matched the name provided
+    //		= -1 if error setting (some elements might have been copied into destination node)
+    if(!_canChange(bMove && pJNode ? pJNode->pJSONData : nullptr))
+        return -1;
+
+    intptr_t nCntNodesSet = -1;
+    ASSERT(pJSONData);
+
+    //Node must be specified and it must have a name
+    if(pJNode &&
+        pStrName &&
+        pStrName[0] &&
+        pJSONData)
+    {
+        //Make sure that JSON data is not the same
+        if(this->pJSONData != pJNode->pJSONData &&
+            pJNode->pJSONData)
+        {
+            ASSERT(pVal);
+            if(pVal->valType == JVT_OBJECT)
+            {
+                JSON_OBJECT* pJO = (JSON_OBJECT*)pVal->pValue;
+                ASSERT(pJO);
+                if(pJO)
+                {
+                    //Assume success
+                    nCntNodesSet = 0;
+
+                    //Where to copy from (it will be the first node set, if moving)
+                    JSON_VALUE* pSrcV = pJNode->pVal;
+
+                    //Start looking for needed nodes
+                    for(JSON_SRCH jSrch;;)
+                    {
+                        //Find next node by name
+                        JSON_NODE_TYPE resFN = findNodeByName(pStrName, nullptr, bCaseSensitive, &jSrch);
+                        if(resFN > JNT_NONE)
+                        {
+                            intptr_t nFndInd = jSrch.getIndexFoundAt();
+                            if(nFndInd >= 0 &&
+                                nFndInd < (intptr_t)pJO->arrObjElmts.size())
+                            {
+                                //Pick element found
+                                JSON_OBJECT_ELEMENT* pJOE = &pJO->arrObjElmts[nFndInd];
+
+                                //First clear the old value
+                            //	CJSON::_freeJSON_VALUE(pJOE->val);			//No need to do it -- it will be done by _deepCopyJSON_VALUE()!
+
+                                //And do "deep" copy, or move it
+                                if(bMove ? CJSON::_moveJSON_VALUE(&pJOE->val, pJNode, pJSONData->getArena()) :
+                                    CJSON::_deepCopyJSON_VALUE(&pJOE->val, pSrcV, pJSONData->getArena()))
+                                {
+                                    if(bMove)
+                                    {
+                                        //Copy the rest from the moved value
+                                        pSrcV = &pJOE->val;
+                                        bMove = false;
+                                    }
+
+                                    //Count the ones set
+                                    if(nCntNodesSet >= 0)
+                                        nCntNodesSet++;
+                                }
+                                else
+                                {
+                                    //Failed
+                                    ASSERT(nullptr);
+                                    nCntNodesSet = -1;
+                                }
+                            }
+                            else
+                            {
+                                //Error
+                                ASSERT(nullptr);
+                                nCntNodesSet = -1;
+                                break;
+                            }
+                        }
+                        else
+                        {
+                            if(resFN == JNT_ERROR)
+                            {
+                                //Error
+                                ASSERT(nullptr);
+                                nCntNodesSet = -1;
+                            }
+
+                            break;
+                        }
+                    }
+
+                }
+            }
+            else
+            {
+                //Can be only an Object node
+                ASSERT(nullptr);
+            }
+        }
+        else
+        {
+            //Can't use same JSON object
+            ASSERT(nullptr);
+        }
+    }
+
+    return nCntNodesSet;
+}
+
+
+bool JSON_NODE::setNodeByIndex(intptr_t nIndex, JSON_NODE* pJNode)
+{
+    //Set node with 'nIndex' in this node to a new value
+    //INFO: It makes a "deep" copy of 'pJNode'
+    //INFO: Can't be used to set nodes from the same JSON data.
+    //'nIndex' = node's 0-based index to set
+    //RETURN:
+    //		= true if success
+    return _setNodeByIndex_FromNode(nIndex, pJNode, false);
+}
+
+bool JSON_NODE::setNodeByIndexMove(intptr_t nIndex, JSON_NODE* pJNode)
+{
+    //Set node with 'nIndex' in this node to a new value by moving the value of 'pJNode' there
+    //INFO: Works the same as addNodeMove() for the source node
+    //'nIndex' = node's 0-based index to set
+    //RETURN:
+    //		= true if success
+    return _setNodeByIndex_FromNode(nIndex, pJNode, true);
+}
+
+
+bool JSON_NODE::_setNodeByIndex_FromNode(intptr_t nIndex, JSON_NODE* pJNode, bool bMove)
+{
+    //Set node with 'nIndex' in this node to a new value
+    //INFO: Can't be used to set nodes from the same JSON data.
+    //'nIndex' = node's 0-based index to set
+    //'bMove' = true to move the value out of 'pJNode' (see setNodeByIndexMove()), false to make a "deep" copy of it
+    //RETURN:
+    //		= true if success
+    if(!_canChange(bMove && pJNode ? pJNode->pJSONData : nullptr))
+        return false;
+
+    bool bRes = false;
+    ASSERT(pJSONData);
+
+    //Node must be specified and valid
+    if(pJNode &&
+        pJSONData)
+    {
+        //Make sure that JSON data is not the same
+        if(this->pJSONData != pJNode->pJSONData &&
+            pJNode->pJSONData)
+        {
+            ASSERT(pVal);
+            if(pVal->valType == JVT_OBJECT)
+            {
+                JSON_OBJECT* pJO = (JSON_OBJECT*)pVal->pValue;
+                ASSERT(pJO);
+                if(pJO)
+                {
+                    //Make sure index is within limits
+                    if(nIndex >= 0 &&
+                        nIndex < (intptr_t)pJO->arrObjElmts.size())
+                    {
+                        //Pick element found
+                        JSON_OBJECT_ELEMENT* pJOE = &pJO->arrObjElmts[nIndex];
+
+                        //First clear the old value
+                    //	CJSON::_freeJSON_VALUE(pJOE->val);			//No need to do it -- it will be done by _deepCopyJSON_VALUE()!
+
+                        //And do "deep" copy, or move it
+                        if(bMove ? CJSON::_moveJSON_VALUE(&pJOE->val, pJNode, pJSONData->getArena()) :
+                            CJSON::_deepCopyJSON_VALUE(&pJOE->val, pJNode->pVal, pJSONData->getArena()))
+                        {
+                            //Done
+                            bRes = true;
+                        }
+                        else
+                        {
+                            //Failed
+                            ASSERT(nullptr);
+                        }
+                    }
+                }
+            }
+            else if(pVal->valType == JVT_ARRAY)
+            {
+                JSON_ARRAY* pJA = (JSON_ARRAY*)pVal->pValue;
+                ASSERT(pJA);
+                if(pJA)
+                {
+                    //Make sure index is within limits
+                    if(nIndex >= 0 &&
+                        nIndex < (intptr_t)pJA->arrArrElmts.size())
+                    {
+                        //Pick element found
+                        JSON_ARRAY_ELEMENT* pJAE = &pJA->arrArrElmts[nIndex];
+
+                        //First clear the old value
+                    //	CJSON::_freeJSON_VALUE(pJAE->val);			//No need to do it -- it will be done by _deepCopyJSON_VALUE()!
+
+                        //And do "deep" copy, or move it
+                        if(bMove ? CJSON::_moveJSON_VALUE(&pJAE->val, pJNode, pJSONData->getArena()) :
+                            CJSON::_deepCopyJSON_VALUE(&pJAE->val, pJNode->pVal, pJSONData->getArena()))
+                        {
+                            //Done
+                            bRes = true;
+                        }
+                        else
+                        {
+                            //Failed
+                            ASSERT(nullptr);
+                        }
+                    }
+                }
+            }
+            else
+            {
+                //Can be only an Object node
+                ASSERT(nullptr);
+            }
+        }
+        else
+        {
+            //Can't use same JSON object
+            ASSERT(nullptr);
+        }
+    }
+
+    return bRes;
+}
+
+
+intptr_t JSON_NODE::_setNodeByName_WithType(LPCTSTR pStrName, JSON_VALUE_TYPE type, LPCTSTR pStrValue, bool bCaseSensitive)
+{
+    //Set node with 'pStrName' in this node to a new value
+    //INFO: This node must be an object.
+    //'pStrName' = node name to set (cannot be empty)
+    //'type' = type to assign to value. Can be JVT_PLAIN or JVT_DOUBLE_QUOTED
+    //'pStrValue' = value
+    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
+    //RETURN:
+    //		= [1 and up) number if nodes set, or
+    //		= 0 if no nodes matched the name provided
+    //		= -1 if error setting (some elements might have been copied into destination node)
+    if(!_canChange())
+        return -1;
+
+    intptr_t nCntNodesSet = -1;
+    ASSERT(pJSONData);
+
+    if(pJSONData)
+    {
+        //Check allowed types
+        if(type == JVT_PLAIN ||
+            type == JVT_DOUBLE_QUOTED)
+        {
+            ASSERT(pVal);
+            if(pVal->valType == JVT_OBJECT)
+            {
+                //Only if we have a name
+                if(pStrName &&
+                    pStrName[0])
+                {
+                    JSON_OBJECT* pJO = (JSON_OBJECT*)pVal->pValue;
+                    ASSERT(pJO);
+                    if(pJO)
+                    {
+                        //Assume success
+                        nCntNodesSet = 0;
+
+                        bool bRenamed = false;
+
+                        //Start looking for needed nodes
+                        for(JSON_SRCH jSrch;;)
+                        {
+                            //Find next node by name
+                            JSON_NODE_TYPE resFN = findNodeByName(pStrName, nullptr, bCaseSensitive, &jSrch);
+                            if(resFN > JNT_NONE)
+                            {
+                                intptr_t nFndInd = jSrch.getIndexFoundAt();
+                                if(nFndInd >= 0 &&
+                                    nFndInd < (intptr_t)pJO->arrObjElmts.size())
+                                {
+                                    //Pick element found
+                                    JSON_OBJECT_ELEMENT* pJOE = &pJO->arrObjElmts[nFndInd];
+
+                                    //First clear the old value
+                                    CJSON::_freeJSON_VALUE(pJOE->val);
+
+                                    //Name may differ in case
+                                    intptr_t nLnStrName = STRLEN(pStrName);
+                                    if(pJOE->getNameLen() != nLnStrName ||
+                                        memcmp(pJOE->getNamePtr(), pStrName, nLnStrName * sizeof(WCHAR)) != 0)
+                                    {
+                                        bRenamed = true;
+                                    }
+
+                                    //And set new simple value
+                                    pJOE->resetNameRef();
+                                    pJOE->strName = pStrName;
+
+                                    //And value
+                                    pJOE->val.valType = type;
+                                    pJOE->val.resetStrRef();
+                                    pJOE->val.strValue = pStrValue ? pStrValue : L("");
+                                    pJOE->val.pValue = nullptr;
+
+                                    if(type == JVT_PLAIN)
+                                    {
+                                        //Trim value
+                                        CJSON::Trim(pJOE->val.strValue);
+
+                                        //Determine its type now, so that lookups don't have to
+                                        pJOE->val.plainType = CJSON::_determinePlainType(&pJOE->val);
+                                    }
+
+                                    //Count the ones set
+                                    if(nCntNodesSet >= 0)
+                                        nCntNodesSet++;
+                                }
+                                else
+                                {
+                                    //Error
+                                    ASSERT(nullptr);
+                                    nCntNodesSet = -1;
+                                    break;
+                                }
+                            }
+                            else
+                            {
+                                if(resFN == JNT_ERROR)
+                                {
+                                    //Error
+                                    ASSERT(nullptr);
+                                    nCntNodesSet = -1;
+                                }
+
+                                break;
+                            }
+                        }
+
+                        if(bRenamed)
+                        {
+                            //Names that were searched for have changed
+                            pJO->dropNameIndex();
+                        }
+                    }
+                }
+            }
+            else
+            {
+                //Can add only to the Array or Object note
+                ASSERT(nullptr);
+            }
+        }
+    }
+
+    return nCntNodesSet;
+}
+
+
+intptr_t JSON_NODE::setNodeByName_String(LPCTSTR pStrName, LPCTSTR pStrValue, bool bCaseSensitive)
+{
+    //Set node with 'pStrName' to the 'pStrValue'
+    //'pStrName' = node name to set (cannot be empty)
+    //'pStrValue' = value to set
+    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
+    //RETURN:
+    //		= [1 and up) number if nodes set, or
+    //		= 0 if no nodes matched the name provided
+    //		= -1 if error setting (some elements might have been copied into destination node)
+    return _setNodeByName_WithType(pStrName, JVT_DOUBLE_QUOTED, pStrValue, bCaseSensitive);
+}
+
+intptr_t JSON_NODE::setNodeByName_BOOL(LPCTSTR pStrName, bool bValue, bool bCaseSensitive)
+{
+    //Set node with 'pStrName' to the 'bValue'
+    //'pStrName' = node name to set (cannot be empty)
+    //'bValue' = value to set
+    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
+    //RETURN:
+    //		= [1 and up) number if nodes set, or
+    //		= 0 if no nodes matched the name provided
+    //		= -1 if error setting (some elements might have been copied into destination node)
+    return _setNodeByName_WithType(pStrName, JVT_PLAIN, bValue ? L("true") : L("false"), bCaseSensitive);
+}
+intptr_t JSON_NODE::setNodeByName_Bool(LPCTSTR pStrName, bool bValue, bool bCaseSensitive)
+{
+    //Set node with 'pStrName' to the 'bValue'
+    //'pStrName' = node name to set (cannot be empty)
+    //'bValue' = value to set
+    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
+    //RETURN:
+    //		= [1 and up) number if nodes set, or
+    //		= 0 if no nodes matched the name provided
+    //		= -1 if error setting (some elements might have been copied into destination node)
+    return _setNodeByName_WithType(pStrName, JVT_PLAIN, bValue ? L("true") : L("false"), bCaseSensitive);
+}
+
+intptr_t JSON_NODE::setNodeByName_Null(LPCTSTR pStrName, bool bCaseSensitive)
+{
+    //Set node with 'pStrName' to the null value
+    //'pStrName' = node name to set (cannot be empty)
+    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
+    //RETURN:
+    //		= [1 and up) number if nodes set, or
+    //		= 0 if no nodes matched the name provided
+    //		= -1 if error setting (some elements might have been copied into destination node)
+    return _setNodeByName_WithType(pStrName, JVT_PLAIN, L("null"), bCaseSensitive);
+}
+
+intptr_t JSON_NODE::setNodeByName_Int(LPCTSTR pStrName, LPCTSTR pStrValue, bool bCaseSensitive)
+{
+    //Set node with 'pStrName' to the 'pStrValue'
+    //'pStrName' = node name to set (cannot be empty)
+    //'pStrValue' = value to set -- it must be an intefer
+    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
+    //RETURN:
+    //		= [1 and up) number if nodes set, or
+    //		= 0 if no nodes matched the name provided
+    //		= -1 if error setting (some elements might have been copied into destination node)
+
+    //Check if number
+    if(!CJSON::isIntegerBase10String(pStrValue))
+        return -1;
+
+    //And add it
+    return _setNodeByName_WithType(pStrName, JVT_PLAIN, pStrValue, bCaseSensitive);
+}
+
+intptr_t JSON_NODE::setNodeByName_Int(LPCTSTR pStrName, int nValue, bool bCaseSensitive)
+{
+    //Set node with 'pStrName' to the 'pStrValue'
+    //'pStrName' = node name to set (cannot be empty)
+    //'nValue' = value to set
+    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
+    //RETURN:
+    //		= [1 and up) number if nodes set, or
+    //		= 0 if no nodes matched the name provided
+    //		= -1 if error setting (some elements might have been copied into destination node)
+
+    //Format it
+    WCHAR buff[JSON_NUMBER_BUFF_LEN];
+    CJSON::_formatInt64(nValue, buff);
+
+    //And add it
+    return _setNodeByName_WithType(pStrName, JVT_PLAIN, buff, bCaseSensitive);
+}
+
+intptr_t JSON_NODE::setNodeByName_Int64(LPCTSTR pStrName, LPCTSTR pStrValue, bool bCaseSensitive)
+{
+    //Set node with 'pStrName' to the 'pStrValue'
+    //'pStrName' = node name to set (cannot be empty)
+    //'pStrValue' = value to set -- it must be an integer
+    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
+    //RETURN:
+    //		= [1 and up) number if nodes set, or
+    //		= 0 if no nodes matched the name provided
+    //		= -1 if error setting (some elements might have been copied into destination node)
+    return setNodeByName_Int(pStrName, pStrValue, bCaseSensitive);
+}
+
+intptr_t JSON_NODE::setNodeByName_Int64(LPCTSTR pStrName, int64_t iiValue, bool bCaseSensitive)
+{
+    //Set node with 'pStrName' to the 'pStrValue'
+    //'pStrName' = node name to set (cannot be empty)
+    //'iiValue' = value to set
+    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
+    //RETURN:
+    //		= [1 and up) number if nodes set, or
+    //		= 0 if no nodes matched the name provided
+    //		= -1 if error setting (some elements might have been copied into destination node)
+
+    //Format it
+    WCHAR buff[JSON_NUMBER_BUFF_LEN];
+    CJSON::_formatInt64(iiValue, buff);
+
+    //And add it
+    return _setNodeByName_WithType(pStrName, JVT_PLAIN, buff, bCaseSensitive);
+}
+
+
+intptr_t JSON_NODE::setNodeByName_Double(LPCTSTR pStrName, LPCTSTR pStrValue, bool bCaseSensitive)
+{
+    //Set node with 'pStrName' to the 'pStrValue'
+    //'pStrName' = node name to set (cannot be empty)
+    //'pStrValue' = value to set -- it must be a floating point value
+    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
+    //RETURN:
+    //		= [1 and up) number if nodes set, or
+    //		= 0 if no nodes matched the name provided
+    //		= -1 if error setting (some elements might have been copied into destination node)
+
+    //Check if number
+    if(!CJSON::isFloatingPointNumberString(pStrValue))
+        return -1;
+
+    //And add it
+    return _setNodeByName_WithType(pStrName, JVT_PLAIN, pStrValue, bCaseSensitive);
+}
+
+intptr_t JSON_NODE::setNodeByName_Double(LPCTSTR pStrName, double fValue, bool bCaseSensitive)
+{
+    //Set node with 'pStrName' to the 'pStrValue'
+    //'pStrName' = node name to set (cannot be empty)
+    //'fValue' = value to set
+    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
+    //RETURN:
+    //		= [1 and up) number if nodes set, or
+    //		= 0 if no nodes matched the name provided
+    //		= -1 if error setting (some elements might have been copied into destination node)
+
+    //Format it
+    WCHAR buff[JSON_NUMBER_BUFF_LEN];
+    CJSON::_formatDouble(fValue, buff);
+
+    //And add it
+    return _setNodeByName_WithType(pStrName, JVT_PLAIN, buff, bCaseSensitive);
+}
+
+
+
+
+
+
+bool JSON_NODE::_setNodeByIndex_WithType(intptr_t nIndex, JSON_VALUE_TYPE type, LPCTSTR pStrValue)
+{
+    //Set node at 'nIndex' in this node to a new value
+    //INFO: This node must be an object or an array.
+    //'nIndex' = 0-based index of the node to set
+    //'type' = type to assign to value. Can be JVT_PLAIN or JVT_DOUBLE_QUOTED
+    //'pStrValue' = value
+    //RETURN:
+    //		= true if success
+    if(!_canChange())
+        return false;
+
+    bool bRes = false;
+    ASSERT(pJSONData);
+
+    if(pJSONData)
+    {
+        //Check allowed types
+        if(type == JVT_PLAIN ||
+            type == JVT_DOUBLE_QUOTED)
+        {
+            ASSERT(pVal);
+            if(pVal->valType == JVT_OBJECT)
+            {
+                JSON_OBJECT* pJO = (JSON_OBJECT*)pVal->pValue;
+                ASSERT(pJO);
+                if(pJO)
+                {
+                    //Make sure index is within limits
+                    if(nIndex >= 0 &&
+                        nIndex < (intptr_t)pJO->arrObjElmts.size())
+                    {
+                        //Pick element found
+                        JSON_OBJECT_ELEMENT* pJOE = &pJO->arrObjElmts[nIndex];
+
+                        //First clear the old value
+                        CJSON::_freeJSON_VALUE(pJOE->val);
+
+                        //And set new simple value
+                        pJOE->val.valType = type;
+                        pJOE->val.resetStrRef();
+                        pJOE->val.strValue = pStrValue ? pStrValue : L("");
+                        pJOE->val.pValue = nullptr;
+
+                        if(type == JVT_PLAIN)
+                        {
+                            //Trim value
+                            CJSON::Trim(pJOE->val.strValue);
+
+                            //Determine its type now, so that lookups don't have to
+                            pJOE->val.plainType = CJSON::_determinePlainType(&pJOE->val);
+                        }
+
+                        //Done
+                        bRes = true;
+                    }
+                }
+            }
+            else if(pVal->valType == JVT_ARRAY)
+            {
+                JSON_ARRAY* pJA = (JSON_ARRAY*)pVal->pValue;
+                ASSERT(pJA);
+                if(pJA)
+                {
+                    //Make sure index is within limits
+                    if(nIndex >= 0 &&
+                        nIndex < (intptr_t)pJA->arrArrElmts.size())
+                    {
+                        //Pick element found
+                        JSON_ARRAY_ELEMENT* pJAE = &pJA->arrArrElmts[nIndex];
+
+                        //First clear the old value
+                        CJSON::_freeJSON_VALUE(pJAE->val);
+
+                        //And set new simple value
+                        pJAE->val.valType = type;
+                        pJAE->val.resetStrRef();
+                        pJAE->val.strValue = pStrValue ? pStrValue : L("");
+                        pJAE->val.pValue = nullptr;
+
+                        if(type == JVT_PLAIN)
+                        {
+                            //Trim value
+                            CJSON::Trim(pJAE->val.strValue);
+
+                            //Determine its type now, so that lookups don't have to
+                            pJAE->val.plainType = CJSON::_determinePlainType(&pJAE->val);
+                        }
+
+                        //Done
+                        bRes = true;
+                    }
+                }
+            }
+            else
+            {
+                //Can add only to the Array or Object note
+                ASSERT(nullptr);
+            }
+        }
+    }
+
+    return bRes;
+}
+
+
+bool JSON_NODE::setNodeByIndex_String(intptr_t nIndex, LPCTSTR pStrValue)
+{
+    //Set node at 'nIndex' in this node to a new value
+    //INFO: This node must be an object or an array.
+    //'nIndex' = 0-based index of the node to set
+    //'pStrValue' = value to set
+    //RETURN:
+    //		= true if success
+    return _setNodeByIndex_WithType(nIndex, JVT_DOUBLE_QUOTED, pStrValue);
+}
+
+bool JSON_NODE::setNodeByIndex_BOOL(intptr_t nIndex, bool bValue)
+{
+    //Set node at 'nIndex' in this node to a new value
+    //INFO: This node must be an object or an array.
+    //'nIndex' = 0-based index of the node to set
+    //'bValue' = value to set
+    //RETURN:
+    //		= true if success
+
+    return _setNodeByIndex_WithType(nIndex, JVT_PLAIN, bValue ? L("true") : L("false"));
+}
+
+bool JSON_NODE::setNodeByIndex_Bool(intptr_t nIndex, bool bValue)
+{
+    //Set node at 'nIndex' in this node to a new value
+    //INFO: This node must be an object or an array.
+    //'nIndex' = 0-based index of the node to set
+    //'bValue' = value to set
+    //RETURN:
+    //		= true if success
+
+    return _setNodeByIndex_WithType(nIndex, JVT_PLAIN, bValue ? L("true") : L("false"));
+}
+
+bool JSON_NODE::setNodeByIndex_Null(intptr_t nIndex)
+{
+    //Set node at 'nIndex' in this node to a new value
+    //INFO: This node must be an object or an array.
+    //'nIndex' = 0-based index of the node to set
+    //RETURN:
+    //		= true if success
+
+    return _setNodeByIndex_WithType(nIndex, JVT_PLAIN, L("null"));
+}
+
+bool JSON_NODE::setNodeByIndex_Int(intptr_t nIndex, LPCTSTR pStrValue)
+{
+    //Set node at 'nIndex' in this node to a new value
+    //INFO: This node must be an object or an array.
+    //'nIndex' = 0-based index of the node to set
+    //'pStrValue' = value to set -- must be an integer
+    //RETURN:
+    //		= true if success
+
+    //Check if number
+    if(!CJSON::isIntegerBase10String(pStrValue))
+        return false;
+
+    //And add it
+    return _setNodeByIndex_WithType(nIndex, JVT_PLAIN, pStrValue);
+}
+
+bool JSON_NODE::setNodeByIndex_Int(intptr_t nIndex, int nValue)
+{
+    //Set node at 'nIndex' in this node to a new value
+    //INFO: This node must be an object or an array.
+    //'nIndex' = 0-based index of the node to set
+    //'nValue' = value to set
+    //RETURN:
+    //		= true if success
+
+    //Format it
+    WCHAR buff[JSON_NUMBER_BUFF_LEN];
+    CJSON::_formatInt64(nValue, buff);
+
+    //And add it
+    return _setNodeByIndex_WithType(nIndex, JVT_PLAIN, buff);
+}
+
+bool JSON_NODE::setNodeByIndex_Int64(intptr_t nIndex, LPCTSTR pStrValue)
+{
+    //Set node at 'nIndex' in this node to a new value
+    //INFO: This node must be an object or an array.
+    //'nIndex' = 0-based index of the node to set
+    //'pStrValue' = value to set -- must be an integer
+    //RETURN:
+    //		= true if success
+    return setNodeByIndex_Int(nIndex, pStrValue);
+}
+
+bool JSON_NODE::setNodeByIndex_Int64(intptr_t nIndex, int64_t iiValue)
+{
+    //Set node at 'nIndex' in this node to a new value
+    //INFO: This node must be an object or an array.
+    //'nIndex' = 0-based index of the node to set
+    //'iiValue' = value to set
+    //RETURN:
+    //		= true if success
+
+    //Format it
+    WCHAR buff[JSON_NUMBER_BUFF_LEN];
+    CJSON::_formatInt64(iiValue, buff);
+
+    //And add it
+    return _setNodeByIndex_WithType(nIndex, JVT_PLAIN, buff);
+}
+
+
+bool JSON_NODE::setNodeByIndex_Double(intptr_t nIndex, LPCTSTR pStrValue)
+{
+    //Set node at 'nIndex' in this node to a new value
+    //INFO: This node must be an object or an array.
+    //'nIndex' = 0-based index of the node to set
+    //'pStrValue' = value to set -- must be a floating point number
+    //RETURN:
+    //		= true if success
+
+    //Check if number
+    if(!CJSON::isFloatingPointNumberString(pStrValue))
+        return false;
+
+    //And add it
+    return _setNodeByIndex_WithType(nIndex, JVT_PLAIN, pStrValue);
+}
+
+bool JSON_NODE::setNodeByIndex_Double(intptr_t nIndex, double fValue)
+{
+    //Set node at 'nIndex' in this node to a new value
+    //INFO: This node must be an object or an array.
+    //'nIndex' = 0-based index of the node to set
+    //'fValue' = value to set
+    //RETURN:
+    //		= true if success
+
+    //Format it
+    WCHAR buff[JSON_NUMBER_BUFF_LEN];
+    CJSON::_formatDouble(fValue, buff);
+
+    //And add it
+    return _setNodeByIndex_WithType(nIndex, JVT_PLAIN, buff);
+}
+
+
+
+intptr_t JSON_NODE::removeNodeByName(LPCTSTR pStrName, bool bCaseSensitive)
+{
+    //Remove nodes from this node that match the name
+    //'pStrName' = node name to remove (cannot be empty)
+    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
+    //RETURN:
+    //		= [1 and up) number if nodes removed, or
+    //		= 0 if no nodes matched the name provided
+    //		= -1 if error (no elements were removed)
+    return removeNodesByNames(&pStrName, 1, bCaseSensitive);
+}
+
+
+intptr_t JSON_NODE::removeNodesByNames(LPCTSTR* ppStrNames, intptr_t nCntNames, bool bCaseSensitive)
+{
+    //Remove nodes from this node that match any of the names in one pass
+    //INFO: This node must be an object node
+    //'ppStrNames' = array of node names to remove (none of them can be empty)
+    //'nCntNames' = number of names in 'ppStrNames'
+    //'bCaseSensitive' = true if names should be matched in case-sensitive way, false if not
+    //RETURN:
+    //		= [1 and up) number if nodes removed, or
+    //		= 0 if no nodes matched the names provided
+    //		= -1 if error (no elements were removed)
+    if(!_canChange())
+        return -1;
+
+    ASSERT(pJSONData);
+
+    if(!ppStrNames ||
+        nCntNames <= 0 ||
+        !pJSONData)
+    {
+        ASSERT(nullptr);
+        return -1;
+    }
+
+    ASSERT(pVal);
+    if(pVal->valType != JVT_OBJECT)
+    {
+        //Can be only an object node
+        ASSERT(nullptr);
+        return -1;
+    }
+
+    JSON_OBJECT* pJO = (JSON_OBJECT*)pVal->pValue;
+    ASSERT(pJO);
+    if(!pJO)
+        return -1;
+
+    //Mark all matching elements first (this uses the name index for large objects)
+    std::vector<bool> arrMarks(pJO->arrObjElmts.size(), false);
+
+    for(intptr_t n = 0; n < nCntNames; n++)
+    {
+        LPCTSTR pStrName = ppStrNames[n];
+        if(!pStrName ||
+            !pStrName[0])
+        {
+            //Name must be provided
+            ASSERT(nullptr);
+            return -1;
+        }
+
+        for(JSON_SRCH jSrch;;)
+        {
+            //Find next node by name
+            JSON_NODE_TYPE resFN = findNodeByName(pStrName, nullptr, bCaseSensitive, &jSrch);
+            if(resFN > JNT_NONE)
+            {
+                intptr_t nFndInd = jSrch.getIndexFoundAt();
+                if(nFndInd >= 0 &&
+                    nFndInd < (intptr_t)arrMarks.size())
+                {
+                    arrMarks[nFndInd] = true;
+                }
+                else
+                {
+                    //Error
+                    ASSERT(nullptr);
+                    return -1;
+                }
+            }
+            else
+            {
+                if(resFN == JNT_ERROR)
+                {
+                    //Error
+                    ASSERT(nullptr);
+                    return -1;
+                }
+
+                break;
+            }
+        }
+    }
+
+    //Then remove them (instead of shifting the rest of elements for each one)
+    return _removeMarkedNodes(arrMarks);
+}
+
+
+intptr_t JSON_NODE::removeNodesByIndexes(const intptr_t* pIndexes, intptr_t nCntIndexes)
+{
+    //Remove nodes from this node by their indexes in one pass
+    //INFO: This node must be an object or array node
+    //'pIndexes' = array of 0-based indexes of nodes to remove, in any order (repeated indexes are removed only once)
+    //'nCntIndexes' = number of indexes in 'pIndexes'
+    //RETURN:
+    //		= [1 and up) number if nodes removed, or
+    //		= 0 if 'nCntIndexes' is 0
+    //		= -1 if error, or if any of the indexes is out of range (no elements were removed)
+    if(!_canChange())
+        return -1;
+
+    intptr_t nCntElmts = getNodeCount();
+    if(nCntElmts < 0 ||
+        nCntIndexes < 0 ||
+        (nCntIndexes && !pIndexes))
+    {
+        ASSERT(nullptr);
+        return -1;
+    }
+
+    std::vector<bool> arrMarks(nCntElmts, false);
+
+    for(intptr_t n = 0; n < nCntIndexes; n++)
+    {
+        intptr_t nIndex = pIndexes[n];
+        if(nIndex < 0 ||
+            nIndex >= nCntElmts)
+        {
+            //Bad index
+            return -1;
+        }
+
+        arrMarks[nIndex] = true;
+    }
+
+    return _removeMarkedNodes(arrMarks);
+}
+
+
+intptr_t JSON_NODE::removeNodesIf(JSON_REMOVE_CALLBACK pfnCallback, void* pCbkParam)
+{
+    //Remove nodes from this node that 'pfnCallback' picks, in one pass
+    //INFO: This node must be an object or array node
+    //'pfnCallback' = callback that is called for each child node, in order
+    //'pCbkParam' = parameter to pass to 'pfnCallback'
+    //RETURN:
+    //		= [1 and up) number if nodes removed, or
+    //		= 0 if no nodes were picked
+    //		= -1 if error (no elements were removed)
+    if(!_canChange())
+        return -1;
+
+    intptr_t nCntElmts = getNodeCount();
+    if(nCntElmts < 0 ||
+        !pfnCallback)
+    {
+        ASSERT(nullptr);
+        return -1;
+    }
+
+    std::vector<bool> arrMarks(nCntElmts, false);
+
+    JSON_NODE jNode;
+    for(intptr_t i = 0; i < nCntElmts; i++)
+    {
+        if(findNodeByIndex(i, &jNode) <= JNT_NONE)
+        {
+            //Error
+            ASSERT(nullptr);
+            return -1;
+        }
+
+        if(pfnCallback(&jNode, i, pCbkParam))
+            arrMarks[i] = true;
+    }
+
+    return _removeMarkedNodes(arrMarks);
+}
+
+
+intptr_t JSON_NODE::_removeMarkedNodes(const std::vector<bool>& arrMarks)
+{
+    //Remove marked nodes from this node, and shift the rest of them only once
+    //'arrMarks' = true for each element to remove (must have as many entries as there are elements in this node)
+    //RETURN:
+    //		= [0 and up) number if nodes removed
+    //		= -1 if error
+    intptr_t nCntDel = 0;
+
+    ASSERT(pVal);
+    if(pVal->valType == JVT_OBJECT)
+    {
+        JSON_OBJECT* pJO = (JSON_OBJECT*)pVal->pValue;
+        ASSERT(pJO);
+        if(!pJO)
+            return -1;
+
+        JSON_OBJECT::ELEMENTS& arrJOEs = pJO->arrObjElmts;
+        if(arrMarks.size() != arrJOEs.size())
+        {
+            ASSERT(nullptr);
+            return -1;
+        }
+
+        size_t nTo = 0;
+        for(size_t i = 0; i < arrJOEs.size(); i++)
+        {
+            if(arrMarks[i])
+            {
+                //Clear its value
+                CJSON::_freeJSON_VALUE(arrJOEs[i].val);
+                nCntDel++;
+            }
+            else
+            {
+                if(nTo != i)
+                    arrJOEs[nTo] = std::move(arrJOEs[i]);
+
+                nTo++;
+            }
+        }
+
+        if(nCntDel)
+        {
+            arrJOEs.erase(arrJOEs.begin() + nTo, arrJOEs.end());
+            pJO->dropNameIndex();
+        }
+    }
+    else if(pVal->valType == JVT_ARRAY)
+    {
+        JSON_ARRAY* pJA = (JSON_ARRAY*)pVal->pValue;
+        ASSERT(pJA);
+        if(!pJA)
+            return -1;
+
+        JSON_ARRAY::ELEMENTS& arrJAEs = pJA->arrArrElmts;
+        if(arrMarks.size() != arrJAEs.size())
+        {
+            ASSERT(nullptr);
+            return -1;
+        }
+
+        size_t nTo = 0;
+        for(size_t i = 0; i < arrJAEs.size(); i++)
+        {
+            if(arrMarks[i])
+            {
+                //Clear its value
+                CJSON::_freeJSON_VALUE(arrJAEs[i].val);
+                nCntDel++;
+            }
+            else
+            {
+                if(nTo != i)
+                    arrJAEs[nTo] = std::move(arrJAEs[i]);
+
+                nTo++;
+            }
+        }
+
+        if(nCntDel)
+            arrJAEs.erase(arrJAEs.begin() + nTo, arrJAEs.end());
+    }
+    else
+    {
+        //Can be only an Object or Array node
+        ASSERT(nullptr);
+        return -1;
+    }
+
+    return nCntDel;
+}
+
+
+bool JSON_NODE::removeNodeByIndex(intptr_t nIndex)
+{
+    //Remove node from this node by the 'nIndex'
+    //'nIndex' = node's 0-based index to remove
+    //RETURN:
+    //		= true if removed OK
+    if(!_canChange())
+        return false;
+
+    bool bRes = false;
+    ASSERT(pJSONData);
+
+    //Node must be specified and valid
+    if(pJSONData)
+    {
+        ASSERT(pVal);
+        if(pVal->valType == JVT_OBJECT)
+        {
+            JSON_OBJECT* pJO = (JSON_OBJECT*)pVal->pValue;
+            ASSERT(pJO);
+            if(pJO)
+            {
+                //Make sure index is within limits
+                if(nIndex >= 0 &&
+                    nIndex < (intptr_t)pJO->arrObjElmts.size())
+                {
+                    //Pick element found
+                    JSON_OBJECT_ELEMENT* pJOE = &pJO->arrObjElmts[nIndex];
+
+                    //First clear the old value
+                    CJSON::_freeJSON_VALUE(pJOE->val);
+
+                    //Then remove the element itself
+                    pJO->arrObjElmts.erase(pJO->arrObjElmts.begin() + nIndex);
+                    pJO->dropNameIndex();
+
+                    //Done
+                    bRes = true;
+                }
+            }
+        }
+        else if(pVal->valType == JVT_ARRAY)
+        {
+            JSON_ARRAY* pJA = (JSON_ARRAY*)pVal->pValue;
+            ASSERT(pJA);
+            if(pJA)
+            {
+                //Make sure index is within limits
+                if(nIndex >= 0 &&
+                    nIndex < (intptr_t)pJA->arrArrElmts.size())
+                {
+                    //Pick element found
+                    JSON_ARRAY_ELEMENT* pJAE = &pJA->arrArrElmts[nIndex];
+
+                    //First clear the old value
+                    CJSON::_freeJSON_VALUE(pJAE->val);
+
+                    //Then remove the element itself
+                    pJA->arrArrElmts.erase(pJA->arrArrElmts.begin() + nIndex);
+
+                    //Done
+                    bRes = true;
+                }
+            }
+        }
+        else
+        {
+            //Can be only an Object or Array node
+            ASSERT(nullptr);
+        }
+    }
+
+    return bRes;
+}
+
+
+#ifdef JSON_UTF8
+//macOS & POSIX specific
+
+unsigned int JSON_NODE::_toLowerCaseChar_POSIX(unsigned int z)
+{
+    //Convert a single Unicode code point 'z' to lower case
+    //INFO: Does not depend on the locale set by the process. It uses "C.UTF-8" (or "UTF-8" on macOS) if the OS has it, or the current locale otherwise.
+    //RETURN:
+    //      = Lower-case code point (or 'z' if it has no lower case form)
+    if(z < 0x80)
+    {
+        //ASCII
+        return (z >= 'A' && z <= 'Z') ? z + ('a' - 'A') : z;
+    }
+
+    //Initialized once, thread-safe in C++11
+    static locale_t s_locUtf8 = []()
+    {
+        locale_t loc = newlocale(LC_CTYPE_MASK, "C.UTF-8", (locale_t)0);
+#ifdef __APPLE__
+        //Older macOS doesn't have "C.UTF-8"
+        if(!loc)
+            loc = newlocale(LC_CTYPE_MASK, "UTF-8", (locale_t)0);
+#endif
+        return loc;
+    }();
+
+    if(s_locUtf8)
+        return (unsigned int)towlower_l((wint_t)z, s_locUtf8);
+
+    return (unsigned int)towlower((wint_t)z);
+}
+
+int JSON_NODE::_compareStringsEqualNoCase_POSIX(const char* pStr1,
+                                                intptr_t ncbStrLen1,
+                                                const char* pStr2,
+                                                intptr_t ncbStrLen2)
+{
+    //Compare two UTF-8 strings in case-insensitive way
+    //INFO: This function takes into account non-English alphabets during comparison (by using simple per-character case mapping.)
+    //'pStr1' = string 1 pointer (may be 0)
+    //'ncbStrLen1' = number of bytes in 'pStr1' to compare, or negative to calculate automatically
+    //'pStr2' = string 2 pointer (may be 0)
+    //'ncbStrLen2' = number of bytes in 'pStr2' to compare, or negative to calculate automatically
+    //RETURN:
+    //      = 1 if equal
+    //      = 0 if not equal
+    //      = -1 if error
+    if(!pStr1)
+        pStr1 = "";
+    if(!pStr2)
+        pStr2 = "";
+
+    if(ncbStrLen1 < 0)
+    {
+        ncbStrLen1 = strlen(pStr1);
+    }
+
+    if(ncbStrLen2 < 0)
+    {
+        ncbStrLen2 = strlen(pStr2);
+    }
+
+    intptr_t i1 = 0;
+    intptr_t i2 = 0;
+
+    while(i1 < ncbStrLen1 &&
+          i2 < ncbStrLen2)
+    {
+        unsigned char c1 = pStr1[i1];
+        unsigned char c2 = pStr2[i2];
+
+        if(!((c1 | c2) & 0x80))
+        {
+            //Both are ASCII
+            if(c1 != c2 &&
+               _toLowerCaseChar_POSIX(c1) != _toLowerCaseChar_POSIX(c2))
+            {
+                return 0;
+            }
+
+            i1++;
+            i2++;
+            continue;
+        }
+
+        unsigned int z1, z2;
+        intptr_t ncb1 = getUtf8Char(pStr1, i1, ncbStrLen1, &z1);
+        intptr_t ncb2 = getUtf8Char(pStr2, i2, ncbStrLen2, &z2);
+        if(ncb1 <= 0 ||
+           ncb2 <= 0)
+        {
+            //Bad UTF-8 sequence
+            return -1;
+        }
+
+        if(z1 != z2 &&
+           _toLowerCaseChar_POSIX(z1) != _toLowerCaseChar_POSIX(z2))
+        {
+            return 0;
+        }
+
+        i1 += ncb1;
+        i2 += ncb2;
+    }
+
+    return i1 == ncbStrLen1 && i2 == ncbStrLen2 ? 1 : 0;
+}
+
+#endif
+
+
+bool JSON_NODE::compareStringsEqual(LPCTSTR pStr1, LPCTSTR pStr2, bool bCaseSensitive)
+{
+    //RETURN:
+    //		= true if strings are equal
+
+    if(pStr1 &&
+        pStr2)
+    {
+#ifdef _WIN32
+        //Windows specific
+        return CompareStringEx(LOCALE_NAME_SYSTEM_DEFAULT, 
+                               bCaseSensitive ? 0 : NORM_IGNORECASE,
+                               pStr1, -1,
+                               pStr2, -1,
+                               nullptr, nullptr, NULL) == CSTR_EQUAL;
+        
+#elif JSON_UTF8
+        //macOS & POSIX specific
+        bool bRes = false;
+        
+        if(bCaseSensitive)
+        {
+            //Use binary comparison
+            intptr_t nchLnStr1 = strlen(pStr1);
+            intptr_t nchLnStr2 = strlen(pStr2);
+
+            if(nchLnStr1 == nchLnStr2)
+            {
+                if(memcmp(pStr1, pStr2, nchLnStr1) == 0)
+                {
+                    bRes = true;
+                }
+            }
+        }
+        else
+        {
+            //Case-insensitive comparison
+            //INFO: We'll use the OS to provide locale-specific comparison.
+            bRes = _compareStringsEqualNoCase_POSIX(pStr1, -1, pStr2, -1) == 1;
+        }
+        
+        return bRes;
+        
+#endif
+    }
+    else if(!pStr1 && !pStr2)
+    {
+        return true;
+    }
+
+    return false;
+}
+
+bool JSON_NODE::compareStringsEqual(LPCTSTR pStr1, intptr_t nchLn1, LPCTSTR pStr2, intptr_t nchLn2, bool bCaseSensitive)
+{
+    //'nchLn1' = length of 'pStr1' in WCHARs, or -1 to calculate automatically
+    //'nchLn2' = length of 'pStr2' in WCHARs, or -1 to calculate automatically
+    //RETURN:
+    //		= true if strings are equal
+
+    if(pStr1 &&
+        pStr2)
+    {
+#ifdef _WIN32
+        //Windows specific
+        
+        //INFO: Values must be either negative, or less than or equal to 0x7FFFFFFF
+        if(nchLn1 <= 0x7FFFFFFF &&
+           nchLn2 <= 0x7FFFFFFF)
+        {
+            return CompareStringEx(LOCALE_NAME_SYSTEM_DEFAULT,
+                                   bCaseSensitive ? 0 : NORM_IGNORECASE,
+                                   pStr1, nchLn1 >= 0 ? (int)nchLn1 : -1,
+                                   pStr2, nchLn2 >= 0 ? (int)nchLn2 : -1,
+                                   nullptr, nullptr, NULL) == CSTR_EQUAL;
+        }
+        else
+        {
+            //Strings are too long!
+            ASSERT(false);
+        }
+        
+#elif JSON_UTF8
+        //macOS & POSIX specific
+        if(nchLn1 < 0)
+        {
+            nchLn1 = strlen(pStr1);
+        }
+
+        if(nchLn2 < 0)
+        {
+            nchLn2 = strlen(pStr2);
+        }
+        
+        if(bCaseSensitive)
+        {
+            if(nchLn1 == nchLn2 &&
+               memcmp(pStr1, pStr2, nchLn1) == 0)
+            {
+                return true;
+            }
+        }
+        else
+        {
+            return _compareStringsEqualNoCase_POSIX(pStr1, nchLn1, pStr2, nchLn2) == 1;
+        }
+#endif
+    }
+    else if(!pStr1 && !pStr2)
+    {
+        return true;
+    }
+
+    return false;
+}
+
+bool JSON_NODE::compareStringsEqual(std_wstring& str1, std_wstring& str2, bool bCaseSensitive)
+{
+    //RETURN:
+    //		= true if strings are equal
+    return compareStringsEqual(str1.c_str(), str1.size(), str2.c_str(), str2.size(), bCaseSensitive);
+}
+
+bool JSON_NODE::compareStringsEqual(std_wstring& str1, LPCTSTR pStr2, bool bCaseSensitive)
+{
+    //RETURN:
+    //		= true if strings are equal
+    return compareStringsEqual(str1.c_str(), str1.size(), pStr2, -1, bCaseSensitive);
+}
+
+
+#ifdef JSON_UTF8
+//macOS & POSIX specific
+
+bool JSON_NODE::appendUtf8Char(std_wstring& str,
+                                unsigned int z)
+{
+    //Append 'z' to 'str' as UTF-8 byte sequence
+    //RETURN:
+    //      = true if success
+    //      = false if 'z' is out of range for UTF-8 and nothing was appended
+    bool bRes = true;
+    
+    //    0x00000000 - 0x0000007F:
+    //        0xxxxxxx
+    //
+    //    0x00000080 - 0x000007FF:
+    //        110xxxxx 10xxxxxx
+    //
+    //    0x00000800 - 0x0000FFFF:
+    //        1110xxxx 10xxxxxx 10xxxxxx
+    //
+    //    0x00010000 - 0x0010FFFF:
+    //        11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
+    //
+    //INFO: Surrogates (0xD800 - 0xDFFF) can't be encoded in UTF-8
+
+    if(z != 0 &&
+        (z < 0xD800 || z > 0xDFFF))
+    {
+        if(z <= 0x7f)
+        {
+            //Just a single char
+            str += (char)z;
+        }
+        else if(z <= 0x7FF)
+        {
+            //110xxxxx 10xxxxxx
+            str += (char)(0xC0 | ((z >> 6) & 0x1F));
+            str += (char)(0x80 | (z & 0x3F));
+        }
+        else if(z <= 0xFFFF)
+        {
+            //1110xxxx 10xxxxxx 10xxxxxx
+            str += (char)(0xE0 | ((z >> 12) & 0xF));
+            str += (char)(0x80 | ((z >> 6) & 0x3F));
+            str += (char)(0x80 | (z & 0x3F));
+        }
+        else if(z <= UTF8_MAX_VAL)
+        {
+            //11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
+            str += (char)(0xF0 | ((z >> 18) & 0x7));
+            str += (char)(0x80 | ((z >> 12) & 0x3F));
+            str += (char)(0x80 | ((z >> 6) & 0x3F));
+            str += (char)(0x80 | (z & 0x3F));
+        }
+        else
+        {
+            //Bad utf-8 sequence
+            bRes = false;
+        }
+    }
+    else
+    {
+        //Can't add a null-char or a surrogate
+        bRes = false;
+    }
+
+    return bRes;
+}
+
+
+intptr_t JSON_NODE::getUtf8Char(const char* pStr,
+                                intptr_t i,
+                                intptr_t nLn,
+                                unsigned int* pOutChar)
+{
+    //Get UTF-8 char, and its length, that starts at index 'i' in 'pStr'
+    //'pStr' = pointer to the beginning of the string - must be valid!
+    //'nLn' = length of 'pStr' in bytes (not including last 0)
+    //'pOutChar' = if not 0, the UTF-8 char itself, or 0 if error
+    //RETURN:
+    //      [1 - up) length of UTF-8 char in bytes,
+    //      0 if end-of-file was reached
+    //      -1 if error in UTF-8 encoding
+    
+    //    0x00000000 - 0x0000007F:
+    //        0xxxxxxx
+    //
+    //    0x00000080 - 0x000007FF:
+    //        110xxxxx 10xxxxxx
+    //
+    //    0x00000800 - 0x0000FFFF:
+    //        1110xxxx 10xxxxxx 10xxxxxx
+    //
+    //    0x00010000 - 0x0010FFFF:
+    //        11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
+    //
+    //INFO: Overlong encodings, surrogates (0xD800 - 0xDFFF) and values above 0x10FFFF are rejected as errors
+    
+    intptr_t ncbLen = 0;
+    unsigned int uiChar = 0;
+    
+    if(i < nLn)
+    {
+        //Assume an error
+        ncbLen = -1;
+        
+        unsigned char c = pStr[i], c1, c2, c3;
+        
+        if(!(c & 0x80))
+        {
+            ncbLen = 1;
+            uiChar = c;
+        }
+        else if((c & 0xE0) == 0xC0)
+        {
+            if(i + 2 <= nLn)
+            {
+                //c        c1
+                //110xxxxx 10xxxxxx
+                
+                c1 = pStr[i + 1];
+                if((c1 & 0xC0) == 0x80 &&
+                   c >= 0xC2)
+                {
+                    //(0xC0 and 0xC1 can only begin overlong encodings)
+                    ncbLen = 2;
+                    uiChar = (c1 & 0x3F) | ((unsigned int)(c & 0x1F) << 6);
+                }
+            }
+        }
+        else if((c & 0xF0) == 0xE0)
+        {
+            if(i + 3 <= nLn)
+            {
+                //c        c1       c2
+                //1110xxxx 10xxxxxx 10xxxxxx
+                
+                c1 = pStr[i + 1];
+                c2 = pStr[i + 2];
+                if((c1 & 0xC0) == 0x80 &&
+                   (c2 & 0xC0) == 0x80)
+                {
+                    uiChar = (c2 & 0x3F) |
+                             ((unsigned int)(c1 & 0x3F) << 6) |
+                             ((unsigned int)(c & 0xF) << 12);
+
+                    //Reject overlong encodings and surrogates
+                    if(uiChar >= 0x800 &&
+                       (uiChar < 0xD800 || uiChar > 0xDFFF))
+                    {
+                        ncbLen = 3;
+                    }
+                    else
+                        uiChar = 0;
+                }
+            }
+        }
+        else if((c & 0xF8) == 0xF0)
+        {
+            if(i + 4 <= nLn)
+            {
+                //c        c1       c2       c3
+                //11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
+                
+                c1 = pStr[i + 1];
+                c2 = pStr[i + 2];
+                c3 = pStr[i + 3];
+                if((c1 & 0xC0) == 0x80 &&
+                   (c2 & 0xC0) == 0x80 &&
+                   (c3 & 0xC0) == 0x80)
+                {
+                    uiChar = (c3 & 0x3F) |
+                             ((unsigned int)(c2 & 0x3F) << 6) |
+                             ((unsigned int)(c1 & 0x3F) << 12) |
+                             ((unsigned int)(c & 0x7) << 18);
+
+                    //Reject overlong encodings and values past the Unicode range
+                    if(uiChar >= 0x10000 &&
+                       uiChar <= 0x10FFFF)
+                    {
+                        ncbLen = 4;
+                    }
+                    else
+                        uiChar = 0;
+                }
+            }
+        }
+    }
+    
+    if(pOutChar)
+        *pOutChar = uiChar;
+    
+    return ncbLen;
+}
+
+intptr_t JSON_NODE::skipAsciiChars(const char* pStr,
+                                   intptr_t i,
+                                   intptr_t nLn)
+{
+    //Skip 7-bit ASCII characters, checking 8 bytes at a time
+    //'pStr' = pointer to the beginning of the string - must be valid!
+    //'i' = index in 'pStr' to begin from
+    //'nLn' = length of 'pStr' in bytes (not including last 0)
+    //RETURN:
+    //      = Index of the first non-ASCII byte on or after 'i', or
+    //      = 'nLn' if there are none
+    for(; i + (intptr_t)sizeof(uint64_t) <= nLn; i += sizeof(uint64_t))
+    {
+        uint64_t uiWord;
+        memcpy(&uiWord, pStr + i, sizeof(uiWord));
+
+        if(uiWord & 0x8080808080808080ULL)
+            break;
+    }
+
+    for(; i < nLn; i++)
+    {
+        if(pStr[i] & 0x80)
+            return i;
+    }
+
+    return nLn;
+}
+
+bool JSON_NODE::isValidUtf8(const char* pStr,
+                            intptr_t nLn)
+{
+    //Check that 'pStr' is a valid UTF-8 string
+    //'pStr' = pointer to the string - must be valid!
+    //'nLn' = length of 'pStr' in bytes (not including last 0)
+    //RETURN:
+    //      = true if it's valid
+    for(intptr_t i = 0; i < nLn; )
+    {
+        //ASCII needs no decoding
+        i = skipAsciiChars(pStr, i, nLn);
+        if(i >= nLn)
+            break;
+
+        intptr_t i_delta = getUtf8Char(pStr, i, nLn);
+        if(i_delta <= 0)
+            return false;
+
+        i += i_delta;
+    }
+
+    return true;
+}
+
+#endif
+
+
+
+
+#ifdef JSON_UTF8
+//macOS & POSIX specific
+
+//Unicode code points for bytes 0x80 - 0x9F in Windows-1252 (the "ANSI" encoding used on macOS),
+//or 0 if the byte is not defined. Other bytes map to the same code points as in ISO-8859-1.
+static const unsigned short g_cp1252_80_9F[0x20] = {
+    0x20AC, 0,      0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+    0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0,      0x017D, 0,
+    0,      0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+    0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0,      0x017E, 0,
+};
+
+static intptr_t _encodeCharForEncoding(UINT z, JSON_ENCODING enc, BYTE* pOut)
+{
+    //Encode one Unicode character 'z' into 'enc' (other than JENC_UTF_8)
+    //'pOut' = receives encoded bytes -- must be at least 4 BYTEs long
+    //RETURN:
+    //		= Number of BYTEs written into 'pOut'
+    //		= -1 if error
+    if(enc == JENC_ANSI)
+    {
+        //Windows-1252, use '?' for characters that can't be represented
+        BYTE chA = '?';
+        
+        if(z < 0x80 ||
+           (z >= 0xA0 && z <= 0xFF))
+        {
+            chA = (BYTE)z;
+        }
+        else
+        {
+            for(int c = 0; c < (int)SIZEOF(g_cp1252_80_9F); c++)
+            {
+                if(g_cp1252_80_9F[c] == z)
+                {
+                    chA = (BYTE)(0x80 + c);
+                    break;
+                }
+            }
+        }
+        
+        pOut[0] = chA;
+        return 1;
+    }
+    else if(enc == JENC_UNICODE_16 ||
+            enc == JENC_UNICODE_16BE)
+    {
+        //UTF-16, use surrogate pairs for characters outside of the BMP
+        unsigned short w[2];
+        int nCntW;
+        
+        if(z <= 0xFFFF)
+        {
+            w[0] = (unsigned short)z;
+            nCntW = 1;
+        }
+        else if(z <= 0x10FFFF)
+        {
+            z -= 0x10000;
+            w[0] = (unsigned short)(0xD800 | (z >> 10));
+            w[1] = (unsigned short)(0xDC00 | (z & 0x3FF));
+            nCntW = 2;
+        }
+        else
+        {
+            //Can't be represented in UTF-16
+            return -1;
+        }
+        
+        for(int c = 0; c < nCntW; c++)
+        {
+            if(enc == JENC_UNICODE_16)
+            {
+                //Little-endian
+                pOut[c * 2] = (BYTE)(w[c] & 0xFF);
+                pOut[c * 2 + 1] = (BYTE)(w[c] >> 8);
+            }
+            else
+            {
+                //Big-endian
+                pOut[c * 2] = (BYTE)(w[c] >> 8);
+                pOut[c * 2 + 1] = (BYTE)(w[c] & 0xFF);
+            }
+        }
+        
+        return nCntW * 2;
+    }
+    
+    return -1;
+}
+
+#endif
+
+
+bool CJSON::getStringForUTF8(LPCTSTR pStr, std::string& strOut)
+{
+    //Convert 'pStr' into UTF-8 string
+    //'strOut' = receives encoding string as a sequence of bytes
+    //RETURN:
+    //		= true if success
+    //		= false if error (check CJSON::GetLastError() for info)
+    return getStringForEncoding(pStr, JENC_UTF_8, strOut);
+}
+
+bool CJSON::getStringForEncoding(LPCTSTR pStr, JSON_ENCODING enc, std::string& strOut
+#ifdef _WIN32
+                                 , bool* pbOutDataLoss
+#endif
+                                 )
+{
+    //Convert 'pStr' into some other encoding
+    //'enc' = encoding to convert into
+    //'strOut' = receives encoding string as a sequence of bytes
+    //'pbOutDataLoss' = if not nullptr, will receive true if data loss occurred during conversion
+    //                  INFO: Works only on Windows!
+    //RETURN:
+    //		= true if success
+    //		= false if error -- check CJSON::GetLastError() for info
+    bool bRes = false;
+    int nOSError = NO_ERROR;
+
+#ifdef _WIN32
+    bool bUsedDefault = false;
+#endif
+
+    //Free string
+    strOut.clear();
+
+    if(pStr &&
+        pStr[0])
+    {
+#ifdef _WIN32
+        //Windows specific
+        UINT nCodePage;
+        
+        switch(enc)
+        {
+            case JENC_ANSI:
+                nCodePage = CP_ACP;
+                break;
+            case JENC_UTF_8:
+                nCodePage = CP_UTF8;
+                break;
+            case JENC_UNICODE_16:
+                nCodePage = 1200;
+                break;
+            case JENC_UNICODE_16BE:
+                nCodePage = 1201;
+                break;
+
+            default:
+                nCodePage = -1;
+                break;
+        }
+        
+        if(nCodePage != -1)
+        {
+            int nchLn = (int)wcslen(pStr);
+            
+            if(nCodePage == 1200)
+            {
+                //No conversion necessary
+                strOut.assign((const char*)pStr, nchLn * sizeof(WCHAR));
+
+                bRes = true;
+            }
+            else if(nCodePage == 1201)
+            {
+                //utf-16 with reversed bytes
+                size_t szcb = nchLn * sizeof(WCHAR);
+                strOut.resize(szcb);
+                
+                char* pD = &strOut[0];
+                const WCHAR* pS = pStr;
+                
+                for(size_t i = 0; i < szcb; pS++)
+                {
+                    WCHAR ch = *pS;
+                    pD[i++] = (char)(ch >> 8);
+                    pD[i++] = (char)(ch);
+                }
+                
+                bRes = true;
+            }
+            else
+            {
+                //Get length needed
+                int ncbLen = ::WideCharToMultiByte(nCodePage, 0, pStr, nchLn, 0, 0, nullptr, nullptr);
+                if(ncbLen > 0)
+                {
+                    //Check if code page accepts default char
+                    bool bUseDefChar = pbOutDataLoss &&
+                        nCodePage != CP_UTF8 &&
+                        nCodePage != CP_UTF7;
+                    
+                    //Reserve mem
+                    strOut.resize(ncbLen);
+                    
+                    BOOL b_UsedDef = FALSE;
+                    
+                    //Convert
+                    const char def[] = "?";
+                    if(::WideCharToMultiByte(nCodePage, 0, pStr, nchLn, &strOut[0], ncbLen,
+                                             bUseDefChar ? def : nullptr, bUseDefChar ? &b_UsedDef : nullptr) == ncbLen)
+                    {
+                        //Success
+                        bRes = true;
+                        
+                        bUsedDefault = !!b_UsedDef;
+                    }
+                    else
+                        nOSError = ::GetLastError();
+                }
+                else
+                    nOSError = ::GetLastError();
+            }
+        }
+        else
+            nOSError = ERROR_INVALID_PARAMETER;
+
+#elif JSON_UTF8
+        //macOS & POSIX specific
+        
+        if(enc == JENC_ANSI ||
+           enc == JENC_UTF_8 ||
+           enc == JENC_UNICODE_16 ||
+           enc == JENC_UNICODE_16BE)
+        {
+            intptr_t ncbLn = strlen(pStr);
+            
+            if(enc == JENC_UTF_8)
+            {
+                //No conversion necessary
+                strOut.assign(pStr, ncbLn);
+                
+                bRes = true;
+            }
+            else
+            {
+                //Assume success
+                bRes = true;
+                
+                strOut.reserve(enc == JENC_ANSI ? ncbLn : ncbLn * sizeof(unsigned short));
+                
+                unsigned int z;
+                intptr_t i_delta;
+                for(intptr_t i = 0; i < ncbLn; i += i_delta)
+                {
+                    i_delta = JSON_NODE::getUtf8Char(pStr, i, ncbLn, &z);
+                    if(i_delta <= 0)
+                    {
+                        //Bad UTF-8 sequence
+                        nOSError = ERROR_BAD_FORMAT;
+                        bRes = false;
+                        break;
+                    }
+                    
+                    BYTE encBuff[4];
+                    intptr_t ncbEnc = _encodeCharForEncoding(z, enc, encBuff);
+                    if(ncbEnc <= 0)
+                    {
+                        //Can't be represented in this encoding
+                        nOSError = ERROR_BAD_FORMAT;
+                        bRes = false;
+                        break;
+                    }
+                    
+                    strOut.append((const char*)encBuff, ncbEnc);
+                }
+                
+                if(!bRes)
+                    strOut.clear();
+            }
+        }
+        else
+            nOSError = ERROR_INVALID_PARAMETER;
+#endif
+    }
+    else
+    {
+        //Empty string
+        bRes = true;
+    }
+
+#ifdef _WIN32
+    if(pbOutDataLoss)
+        *pbOutDataLoss = bUsedDefault;
+#endif
+    
+    CJSON::SetLastError(nOSError);
+    return bRes;
+}
+
+
+
+void JSON_WRITER::_flushToSink(bool bLast)
+{
+    //Encode what we have in the buffer and pass it to 'pfnSink'
+    //'bLast' = true if no more output will follow
+    //INFO: A character that is split at the end of the buffer is kept for the next call
+    size_t nchHave = pCur - buff;
+    size_t nchDone = nchHave;
+    
+    const BYTE* pData = nullptr;
+    size_t ncbData = 0;
+    
+    if(!bFailed &&
+       nchHave)
+    {
+#ifdef _WIN32
+        //Windows specific
+        switch(encSink)
+        {
+            case JENC_UNICODE_16:
+            {
+                //No conversion necessary
+                pData = (const BYTE*)buff;
+                ncbData = nchHave * sizeof(WCHAR);
+            }
+            break;
+            
+            case JENC_UNICODE_16BE:
+            {
+                //utf-16 with reversed bytes
+                strEncoded.resize(nchHave * sizeof(WCHAR));
+                
+                char* pD = &strEncoded[0];
+                for(size_t i = 0; i < nchHave; i++)
+                {
+                    WCHAR ch = buff[i];
+                    pD[i * 2] = (char)(ch >> 8);
+                    pD[i * 2 + 1] = (char)(ch);
+                }
+                
+                pData = (const BYTE*)strEncoded.data();
+                ncbData = strEncoded.size();
+            }
+            break;
+            
+            case JENC_ANSI:
+            case JENC_UTF_8:
+            {
+                //Don't split a surrogate pair
+                WCHAR chLast = buff[nchHave - 1];
+                if(!bLast &&
+                   chLast >= 0xD800 &&
+                   chLast <= 0xDBFF)
+                {
+                    nchDone--;
+                }
+                
+                if(nchDone)
+                {
+                    UINT nCodePage = encSink == JENC_UTF_8 ? CP_UTF8 : CP_ACP;
+                    
+                    strEncoded.resize(nchDone * 3);
+                    
+                    int ncbLen = ::WideCharToMultiByte(nCodePage, 0, buff, (int)nchDone,
+                                                       &strEncoded[0], (int)strEncoded.size(), nullptr, nullptr);
+                    if(ncbLen > 0)
+                    {
+                        pData = (const BYTE*)strEncoded.data();
+                        ncbData = ncbLen;
+                    }
+                    else
+                        _setFailed(::GetLastError());
+                }
+            }
+            break;
+            
+            default:
+                _setFailed(ERROR_INVALID_PARAMETER);
+                break;
+        }
+        
+#elif JSON_UTF8
+        //macOS & POSIX specific
+        if(encSink == JENC_UTF_8)
+        {
+            //No conversion necessary
+            pData = (const BYTE*)buff;
+            ncbData = nchHave;
+        }
+        else
+        {
+            //INFO: Each UTF-8 byte takes at most 2 BYTEs in any of the other encodings
+            strEncoded.resize(nchHave * 2);
+            BYTE* pD = (BYTE*)&strEncoded[0];
+            
+            UINT z;
+            intptr_t i_delta;
+            for(intptr_t i = 0; i < (intptr_t)nchHave; i += i_delta)
+            {
+                i_delta = JSON_NODE::getUtf8Char(buff, i, nchHave, &z);
+                if(i_delta <= 0)
+                {
+                    if(!bLast &&
+                       nchHave - i < 4)
+                    {
+                        //May be a character that continues in the next chunk
+                        nchDone = i;
+                    }
+                    else
+                        _setFailed(ERROR_BAD_FORMAT);
+                    
+                    break;
+                }
+                
+                intptr_t ncbEnc = _encodeCharForEncoding(z, encSink, pD + ncbData);
+                if(ncbEnc <= 0)
+                {
+                    _setFailed(ERROR_BAD_FORMAT);
+                    break;
+                }
+                
+                ncbData += ncbEnc;
+            }
+            
+            pData = pD;
+        }
+#endif
+        
+        if(!bFailed &&
+           ncbData)
+        {
+            //Pass it to the sink
+            CJSON::SetLastError(NO_ERROR);
+            
+            if(!pfnSink(pData, ncbData, pCbkParam))
+            {
+                _setFailed(CJSON::GetLastError());
+            }
+        }
+    }
+    
+    if(bFailed)
+    {
+        //Drop the rest
+        pCur = buff;
+        return;
+    }
+    
+    //Keep what we couldn't encode yet
+    size_t nchLeft = nchHave - nchDone;
+    if(nchLeft &&
+       bLast)
+    {
+        //Incomplete character at the end
+        _setFailed(ERROR_BAD_FORMAT);
+        nchLeft = 0;
+    }
+    
+    memmove(buff, buff + nchDone, nchLeft * sizeof(WCHAR));
+    pCur = buff + nchLeft;
+}
+
+
+bool CJSON::getUnicodeStringFromEncoding(const char* pAStr, intptr_t ncbLen, JSON_ENCODING enc, std_wstring* pOutUnicodeStr)
+{
+    //Convert 'pAStr' encoded sequence into the Unicode string
+    //INFO: For Microsoft it is UTF-16, and for Apple it's UTF-8.
+    //'pAStr' = Byte sequence to convert
+    //'ncbLen' = Length of 'pAStr' in bytes, or -1 if it's a null-terminated string
+    //'enc' = Encoding that 'pAStr' was encoded with
+    //RETURN:
+    //		= true if success, and 'pOutUnicodeStr' received the data (must NOT be nullptr!)
+    //		= false if error (use CJSON::GetLastError() for details)
+    bool bRes = false;
+    int nOSError = NO_ERROR;
+    ASSERT(pOutUnicodeStr);
+    
+    pOutUnicodeStr->clear();
+
+    //Do we have the length
+    if(ncbLen < 0)
+    {
+        ncbLen = 0;
+        while(pAStr[ncbLen])
+            ncbLen++;
+    }
+
+    if(ncbLen)
+    {
+#ifdef _WIN32
+        //Windows specific
+        UINT nCodePage;
+        
+        switch(enc)
+        {
+            case JENC_ANSI:
+                nCodePage = CP_ACP;
+                break;
+            case JENC_UTF_8:
+                nCodePage = CP_UTF8;
+                break;
+            case JENC_UNICODE_16:
+                nCodePage = 1200;
+                break;
+            case JENC_UNICODE_16BE:
+                nCodePage = 1201;
+                break;
+
+            default:
+                nCodePage = -1;
+                break;
+        }
+        
+        if(nCodePage != -1)
+        {
+            if(nCodePage == 1200)
+            {
+                //Use as-is
+                if((ncbLen % sizeof(WCHAR)) == 0)
+                {
+                    pOutUnicodeStr->assign((LPCTSTR)pAStr, ncbLen / sizeof(WCHAR));
+
+                    bRes = true;
+                }
+                else
+                    nOSError = ERROR_INVALID_DATA;
+            }
+            else if(nCodePage == 1201)
+            {
+                //Reverse byte order
+                if((ncbLen % sizeof(WCHAR)) == 0)
+                {
+                    pOutUnicodeStr->resize(ncbLen / sizeof(WCHAR));
+                    
+                    const char* pS = (const char*)pAStr;
+                    WCHAR* pD = &pOutUnicodeStr->at(0);
+                    
+                    for(intptr_t i = 0; i < ncbLen; pD++)
+                    {
+                        WCHAR ch = ((WCHAR)pS[i++] << 8);
+                        ch |= pS[i++];
+                        
+                        *pD = ch;
+                    }
+                    
+                    bRes = true;
+                }
+                else
+                    nOSError = ERROR_INVALID_DATA;
+            }
+            else
+            {
+                //See how much data do we need?
+                int nchLen = ::MultiByteToWideChar(nCodePage, 0, pAStr, (int)ncbLen, nullptr, 0);
+                if(nchLen)
+                {
+                    WCHAR* pWTxt = new(std::nothrow) WCHAR[nchLen];
+                    if(pWTxt)
+                    {
+                        //Convert
+                        if(::MultiByteToWideChar(nCodePage, 0, pAStr, (int)ncbLen, pWTxt, nchLen) == nchLen)
+                        {
+                            //Set text
+                            bRes = true;
+                            
+                            ASSERT(pOutUnicodeStr);
+                            pOutUnicodeStr->assign(pWTxt, nchLen);
+                        }
+                        else
+                            nOSError = ::GetLastError();
+                        
+                        //Free
+                        delete[] pWTxt;
+                        pWTxt = nullptr;
+                    }
+                    else
+                        nOSError = ERROR_OUTOFMEMORY;
+                }
+                else
+                    nOSError = ::GetLastError();
+            }
+        }
+        else
+            nOSError = ERROR_INVALID_PARAMETER;
+
+#elif JSON_UTF8
+        //macOS & POSIX specific
+        
+        if(enc == JENC_ANSI ||
+           enc == JENC_UTF_8 ||
+           enc == JENC_UNICODE_16 ||
+           enc == JENC_UNICODE_16BE)
+        {
+            //Assume success
+            bRes = true;
+            
+            if(enc == JENC_UTF_8)
+            {
+                //Only check that it's a valid UTF-8
+                if(!JSON_NODE::isValidUtf8(pAStr, ncbLen))
+                {
+                    nOSError = ERROR_INVALID_DATA;
+                    bRes = false;
+                }
+                
+                if(bRes)
+                {
+                    pOutUnicodeStr->assign(pAStr, ncbLen);
+                }
+            }
+            else if(enc == JENC_ANSI)
+            {
+                //Windows-1252
+                pOutUnicodeStr->reserve(ncbLen);
+                
+                for(intptr_t i = 0; i < ncbLen; i++)
+                {
+                    unsigned int z = (unsigned char)pAStr[i];
+                    
+                    if(z >= 0x80 &&
+                       z <= 0x9F)
+                    {
+                        z = g_cp1252_80_9F[z - 0x80];
+                        if(!z)
+                        {
+                            //Undefined in this code page
+                            z = '?';
+                        }
+                    }
+                    
+                    if(z &&
+                       !JSON_NODE::appendUtf8Char(*pOutUnicodeStr, z))
+                    {
+                        nOSError = ERROR_INVALID_DATA;
+                        bRes = false;
+                        break;
+                    }
+                }
+            }
+            else
+            {
+                //UTF-16
+                if((ncbLen % sizeof(unsigned short)) == 0)
+                {
+                    pOutUnicodeStr->reserve(ncbLen);
+                    
+                    const unsigned char* pS = (const unsigned char*)pAStr;
+                    
+                    for(intptr_t i = 0; i < ncbLen; i += sizeof(unsigned short))
+                    {
+                        unsigned int z = enc == JENC_UNICODE_16 ?
+                                            pS[i] | ((unsigned int)pS[i + 1] << 8) :
+                                            pS[i + 1] | ((unsigned int)pS[i] << 8);
+                        
+                        if(z >= 0xD800 &&
+                           z <= 0xDBFF &&
+                           i + 2 * (intptr_t)sizeof(unsigned short) <= ncbLen)
+                        {
+                            //See if this is a surrogate pair
+                            unsigned int z2 = enc == JENC_UNICODE_16 ?
+                                                pS[i + 2] | ((unsigned int)pS[i + 3] << 8) :
+                                                pS[i + 3] | ((unsigned int)pS[i + 2] << 8);
+                            
+                            if(z2 >= 0xDC00 &&
+                               z2 <= 0xDFFF)
+                            {
+                                z = 0x10000 + (((z - 0xD800) << 10) | (z2 - 0xDC00));
+                                i += sizeof(unsigned short);
+                            }
+                        }
+                        
+                        if(z &&
+                           !JSON_NODE::appendUtf8Char(*pOutUnicodeStr, z))
+                        {
+                            nOSError = ERROR_INVALID_DATA;
+                            bRes = false;
+                            break;
+                        }
+                    }
+                }
+                else
+                {
+                    nOSError = ERROR_INVALID_DATA;
+                    bRes = false;
+                }
+            }
+            
+            if(!bRes)
+                pOutUnicodeStr->clear();
+        }
+        else
+            nOSError = ERROR_INVALID_PARAMETER;
+        
+#endif
+    }
+    else
+    {
+        //Empty string
+        pOutUnicodeStr->clear();
+        bRes = true;
+    }
+
+    CJSON::SetLastError(nOSError);
+    return bRes;
+}
+
+bool CJSON::convertStringToUnicode(const char* pAStr, intptr_t ncbLen, JSON_ENCODING enc, std_wstring* pOutUnicodeStr)
+{
+    //Convert 'pAStr' encoded sequence into the Unicode string
+    //INFO: For Microsoft it is UTF-16, and for Apple it's UTF-8.
+    //'pAStr' = Byte sequence to convert
+    //'ncbLen' = Length of 'pAStr' in bytes, or -1 if it's a null-terminated string
+    //'enc' = Encoding that 'pAStr' was encoded with
+    //RETURN:
+    //        = true if success, and 'pOutUnicodeStr' received the data (must NOT be nullptr!)
+    //        = false if error (use CJSON::GetLastError() for details)
+    return CJSON::getUnicodeStringFromEncoding(pAStr, ncbLen, enc, pOutUnicodeStr);
+}
+
+bool CJSON::readFileContents(LPCTSTR pStrFilePath, BYTE** ppOutData, UINT* pncbOutDataSz, UINT ncbSzMaxFileSz)
+{
+    //Read file contents into a BYTE array
+    //'pStrFilePath' = file path
+    //'ppOutData' = if not nullptr, receives pointer to the BYTE array (must be removed with delete[]!)
+    //'pncbOutDataSz' = if not nullptr, receives the size of 'ppOutData' array in BYTEs
+    //'ncbSzMaxFileSz' = if not 0, maximum allowed file size in BYTEs
+    //RETURN:
+    //		= true if success
+    //		= false if failed (check CJSON::GetLastError() for info)
+    bool bRes = false;
+    int nOSError = NO_ERROR;
+    BYTE* pFileData = nullptr;
+    UINT ncbSzFileData = 0;
+
+    if(pStrFilePath &&
+        pStrFilePath[0])
+    {
+#ifdef _WIN32
+        //Windows specific
+
+        //Open file
+        HANDLE hFile = ::CreateFile(pStrFilePath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+            OPEN_EXISTING, 0, nullptr);
+        if(hFile != INVALID_HANDLE_VALUE)
+        {
+            LARGE_INTEGER liSz = {0};
+            if(::GetFileSizeEx(hFile, &liSz))
+            {
+                //Check file size (if needed)
+                if(!ncbSzMaxFileSz ||
+                    liSz.QuadPart <= ncbSzMaxFileSz)
+                {
+                    //Reserve mem
+                    ncbSzFileData = (UINT)liSz.QuadPart;
+                    pFileData = new (std::nothrow) BYTE[ncbSzFileData];
+                    if(pFileData)
+                    {
+                        //Read data
+                        DWORD dwcbRead = 0;
+                        if(::ReadFile(hFile, pFileData, ncbSzFileData, &dwcbRead, nullptr))
+                        {
+                            if(ncbSzFileData == dwcbRead)
+                            {
+                                //Got!
+                                bRes = true;
+                            }
+                            else
+                            {
+                                //Bad size read
+                                nOSError = ERROR_BAD_LENGTH;
+                            }
+                        }
+                        else
+                        {
+                            //Error
+                            nOSError = ::GetLastError();
+                        }
+                    }
+                    else
+                    {
+                        //Memory failed
+                        nOSError = ERROR_NOT_ENOUGH_MEMORY;
+                    }
+                }
+                else
+                {
+                    //File is too large
+                    nOSError = ERROR_FILE_TOO_LARGE;
+                }
+            }
+            else
+            {
+                //Error
+                nOSError = ::GetLastError();
+            }
+
+            //Close file
+            VERIFY(::CloseHandle(hFile));
+        }
+        else
+            nOSError = ::GetLastError();
+        
+#elif JSON_UTF8
+        //macOS & POSIX specific
+
+        //Read file contents
+        FILE* pFile = fopen(pStrFilePath, "rb");
+        if(pFile)
+        {
+            //Get file size
+            if(fseek(pFile, 0, SEEK_END) == 0)
+            {
+                long ncbFileSz = ftell(pFile);
+                if(ncbFileSz >= 0)
+                {
+                    if(fseek(pFile, 0, SEEK_SET) == 0)
+                    {
+                        //Check file size (if needed)
+                        if(!ncbSzMaxFileSz ||
+                           ncbFileSz <= ncbSzMaxFileSz)
+                        {
+                            //Reserve mem
+                            pFileData = new (std::nothrow) BYTE[ncbFileSz];
+                            if(pFileData)
+                            {
+                                size_t szcbRead =
+                                fread(pFileData, sizeof(char), ncbFileSz, pFile);
+                                
+                                if(szcbRead == (size_t)ncbFileSz)
+                                {
+                                    //Success
+                                    bRes = true;
+                                    
+                                    ncbSzFileData = (UINT)ncbFileSz;
+                                }
+                                else
+                                {
+                                    //Bad size
+                                    nOSError = EAGAIN;
+                                }
+                            }
+                            else
+                                nOSError = ENOMEM;
+                        }
+                        else
+                            nOSError = EFBIG;
+                    }
+                    else
+                        nOSError = errno;
+                }
+                else
+                    nOSError = errno;
+            }
+            else
+                nOSError = errno;
+            
+            //Close file
+            fclose(pFile);
+        }
+        else
+            nOSError = errno;
+#endif
+    }
+    else
+        nOSError = ERROR_INVALID_PARAMETER;
+
+    //See if we failed, or don't need the data returned
+    if(!bRes ||
+        !ppOutData)
+    {
+        //Free mem
+        if(pFileData)
+        {
+            delete[] pFileData;
+            pFileData = nullptr;
+        }
+
+        ncbSzFileData = 0;
+    }
+
+    if(ppOutData)
+        *ppOutData = pFileData;
+    if(pncbOutDataSz)
+        *pncbOutDataSz = ncbSzFileData;
+
+    CJSON::SetLastError(nOSError);
+    return bRes;
+}
+
+
+
+bool CJSON::readFileContentsAsString(LPCTSTR pStrFilePath, std_wstring* pOutStr, UINT ncbSzMaxFileSz)
+{
+    //Read file contents into a string
+    //INFO: Takes into account BOMs for text file encodings
+    //'pStrFilePath' = file path
+    //'pOutStr' = if not nullptr, receives the data as a string
+    //'ncbSzMaxFileSz' = if not 0, maximum allowed file size in BYTEs
+    //RETURN:
+    //		= true if success
+    //		= false if failed (check CJSON::GetLastError() for info)
+    bool bRes = false;
+    int nOSError = NO_ERROR;
+
+    //Read file as BYTE string first
+    BYTE* pFileData = nullptr;
+    UINT ncbSzFileData = 0;
+    if(CJSON::readFileContents(pStrFilePath, &pFileData, &ncbSzFileData, ncbSzMaxFileSz))
+    {
+        int ncbSzBOM;
+        JSON_ENCODING enc = _detectFileEncoding(pFileData, ncbSzFileData, &ncbSzBOM);
+
+        std_wstring strDummy;
+        if(CJSON::convertStringToUnicode((const char *)(pFileData + ncbSzBOM),
+                                         ncbSzFileData - ncbSzBOM,
+                                         enc,
+                                         pOutStr ? pOutStr : &strDummy))
+        {
+            //Done
+            bRes = true;
+        }
+        else
+            nOSError = CJSON::GetLastError();
+
+        
+    }
+    else
+        nOSError = CJSON::GetLastError();
 
-                        //Add it
-                        pJO->arrObjElmts.push_back(joe);
+    //Free mem
+    if(pFileData)
+    {
+        delete[] pFileData;
+        pFileData = nullptr;
+    }
 
-                        //Done
+    //Only if failed, otherwise it will be set prior
+    if(!bRes &&
+        pOutStr)
+    {
+        pOutStr->clear();
+    }
+
+    CJSON::SetLastError(nOSError);
+    return bRes;
+}
+
+
+
+bool JSON_FILE_MAPPING::open(LPCTSTR pStrFilePath, uint64_t ncbSzMaxFileSz, bool bSequential)
+{
+    //Map contents of a file into memory for reading
+    //INFO: Closes the previously opened file, if any
+    //'pStrFilePath' = file path
+    //'ncbSzMaxFileSz' = if not 0, maximum allowed file size in BYTEs
+    //'bSequential' = true if the file will be read from the beginning to the end, false if it will be read in random order
+    //RETURN:
+    //		= true if success (getData() may return nullptr if the file is empty)
+    //		= false if failed (check CJSON::GetLastError() for info)
+    bool bRes = false;
+    int nOSError = NO_ERROR;
+
+    close();
+
+    if(pStrFilePath &&
+        pStrFilePath[0])
+    {
+#ifdef _WIN32
+        //Windows specific
+
+        //Open file
+        HANDLE hFile = ::CreateFile(pStrFilePath, GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, bSequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS, nullptr);
+        if(hFile != INVALID_HANDLE_VALUE)
+        {
+            LARGE_INTEGER liSz = {0};
+            if(::GetFileSizeEx(hFile, &liSz))
+            {
+                //Check file size (if needed)
+                if((!ncbSzMaxFileSz ||
+                    (uint64_t)liSz.QuadPart <= ncbSzMaxFileSz) &&
+                    (uint64_t)liSz.QuadPart <= (uint64_t)INTPTR_MAX)
+                {
+                    if(liSz.QuadPart == 0)
+                    {
+                        //Empty files can't be mapped
                         bRes = true;
                     }
+                    else
+                    {
+                        HANDLE hMapping = ::CreateFileMapping(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                        if(hMapping)
+                        {
+                            //The view keeps the file mapped after the handles are closed
+                            pData = (const BYTE*)::MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+                            if(pData)
+                            {
+                                ncbDataSz = liSz.QuadPart;
+                                bRes = true;
+                            }
+                            else
+                                nOSError = ::GetLastError();
+
+                            VERIFY(::CloseHandle(hMapping));
+                        }
+                        else
+                            nOSError = ::GetLastError();
+                    }
                 }
-            }
-            else if(pVal->valType == JVT_ARRAY)
-            {
-                JSON_ARRAY* pJA = (JSON_ARRAY*)pVal->pValue;
-                ASSERT(pJA);
-                if(pJA)
+                else
                 {
-                    //Add new
-                    JSON_ARRAY_ELEMENT jae;
+                    //File is too large
+                    nOSError = ERROR_FILE_TOO_LARGE;
+                }
+            }
+            else
+                nOSError = ::GetLastError();
 
-                    //Set value
-                    jae.val.valType = type;
-                    jae.val.strValue = pStrValue ? pStrValue : L("");
-                    jae.val.pValue = nullptr;
+            //Close file
+            VERIFY(::CloseHandle(hFile));
+        }
+        else
+            nOSError = ::GetLastError();
 
-                    if(type == JVT_PLAIN)
+#elif JSON_UTF8
+        //macOS & POSIX specific
+
+        int fd = ::open(pStrFilePath, O_RDONLY | O_CLOEXEC);
+        if(fd != -1)
+        {
+            struct stat st;
+            if(fstat(fd, &st) == 0)
+            {
+                //Check file size (if needed)
+                if((!ncbSzMaxFileSz ||
+                    (uint64_t)st.st_size <= ncbSzMaxFileSz) &&
+                    (uint64_t)st.st_size <= (uint64_t)INTPTR_MAX)
+                {
+                    if(st.st_size == 0)
                     {
-                        //Trim value
-                        CJSON::Trim(jae.val.strValue);
+                        //Empty files can't be mapped
+                        bRes = true;
+                    }
+                    else
+                    {
+                        //The mapping stays after the file is closed
+                        void* pMem = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                        if(pMem != MAP_FAILED)
+                        {
+#ifdef MADV_SEQUENTIAL
+                            //It will be read from the beginning to the end
+                            if(bSequential)
+                                madvise(pMem, (size_t)st.st_size, MADV_SEQUENTIAL);
+#endif
+                            pData = (const BYTE*)pMem;
+                            ncbDataSz = st.st_size;
+                            bRes = true;
+                        }
+                        else
+                            nOSError = errno;
                     }
+                }
+                else
+                    nOSError = EFBIG;
+            }
+            else
+                nOSError = errno;
+
+            //Close file
+            ::close(fd);
+        }
+        else
+            nOSError = errno;
+#endif
+    }
+    else
+        nOSError = ERROR_INVALID_PARAMETER;
+
+    CJSON::SetLastError(nOSError);
+    return bRes;
+}
+
+
+void JSON_FILE_MAPPING::close()
+{
+    //Unmap the file, if it was mapped
+    if(pData)
+    {
+#ifdef _WIN32
+        //Windows specific
+        VERIFY(::UnmapViewOfFile(pData));
+#elif JSON_UTF8
+        //macOS & POSIX specific
+        if(munmap((void*)pData, (size_t)ncbDataSz) != 0)
+        {
+            //Failed to unmap
+            ASSERT(nullptr);
+        }
+#endif
+
+        pData = nullptr;
+    }
+
+    ncbDataSz = 0;
+}
+
+
+
+struct JSON_HAZARD
+{
+    //Hazard pointer of one JSON_SNAPSHOT_REF: version of JSON data that it uses
+    //INFO: They are never freed until JSON_SNAPSHOTS is destroyed, but are reused by other references once released.
+    std::atomic<JSON_DATA*> pJData;     //Version in use, or nullptr if none
+    std::atomic<bool> bTaken;           //true if taken by a JSON_SNAPSHOT_REF
+    JSON_HAZARD* pNext;                 //Next hazard pointer in JSON_SNAPSHOTS_STATE::pHazards
+
+    BYTE padding[64];                   //Keeps hazard pointers used by different threads in separate cache lines
+};
+
+struct JSON_SNAPSHOTS_STATE
+{
+    //Shared state of JSON_SNAPSHOTS
+    std::atomic<JSON_DATA*> pCurrent;   //Current version, or nullptr if none was published yet
+    std::atomic<JSON_HAZARD*> pHazards; //List of all hazard pointers (new ones are added to the front)
+    std::mutex mtxPublish;              //Only for publishing threads
+    std::vector<JSON_DATA*> arrRetired; //Replaced versions that may still be in use (protected by 'mtxPublish')
+};
+
+
+JSON_SNAPSHOTS::JSON_SNAPSHOTS()
+{
+    pState = new (std::nothrow) JSON_SNAPSHOTS_STATE;
+    if(pState)
+    {
+        pState->pCurrent = nullptr;
+        pState->pHazards = nullptr;
+    }
+}
+
+JSON_SNAPSHOTS::~JSON_SNAPSHOTS()
+{
+    //INFO: All JSON_SNAPSHOT_REF must be released before this!
+    if(pState)
+    {
+        delete pState->pCurrent.load();
+
+        for(size_t i = 0; i < pState->arrRetired.size(); i++)
+        {
+            delete pState->arrRetired[i];
+        }
+
+        JSON_HAZARD* pHaz = pState->pHazards.load();
+        while(pHaz)
+        {
+            //There must be no references left
+            ASSERT(!pHaz->bTaken.load());
+
+            JSON_HAZARD* pNext = pHaz->pNext;
+            delete pHaz;
+            pHaz = pNext;
+        }
+
+        delete pState;
+        pState = nullptr;
+    }
+}
+
+
+bool JSON_SNAPSHOTS::publish(JSON_DATA* pJData)
+{
+    //Make 'pJData' the current version of JSON data, that JSON_SNAPSHOT_REF will acquire from now on
+    //INFO: The previous version is deleted once no JSON_SNAPSHOT_REF uses it (see reclaim().)
+    //'pJData' = JSON data allocated with 'new' -- this object takes it over (even if this method fails), or nullptr to have no current version.
+    //           It's frozen (see JSON_DATA::freeze) before it's published.
+    //RETURN:
+    //		= true if success
+    //		= false if error (check CJSON::GetLastError() for info)
+    if(!pState)
+    {
+        delete pJData;
+        CJSON::SetLastError(ERROR_OUTOFMEMORY);
+        return false;
+    }
+
+    if(pJData &&
+        !pJData->freeze())
+    {
+        delete pJData;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(pState->mtxPublish);
+
+    JSON_DATA* pOldJData = pState->pCurrent.exchange(pJData);
+    if(pOldJData)
+    {
+        pState->arrRetired.push_back(pOldJData);
+    }
+
+    _reclaimRetired();
+
+    return true;
+}
+
+
+int JSON_SNAPSHOTS::publishJSON(LPCTSTR pStr, intptr_t nchLen, JSON_ERROR* pJError, UINT nParseFlags)
+{
+    //Parse 'nchLen' characters of 'pStr' as JSON in this thread, and publish it as the current version if it's valid (see publish())
+    //INFO: If it's not valid, the current version stays unchanged.
+    //'pStr' = JSON to parse (doesn't need to be null-terminated)
+    //'pJError' = if not nullptr, will be filled with parsing error details
+    //'nParseFlags' = JPF_* flags to parse with (JPF_REFERENCE_SOURCE is ignored, as 'pStr' may not live as long as the published data)
+    //RETURN:
+    //		= 1 if parsed and published OK
+    //		= 0 if JSON syntax error (check 'pJError' for details)
+    //		= -1 if other error (check CJSON::GetLastError() for info)
+    JSON_DATA* pJData = new (std::nothrow) JSON_DATA;
+    if(!pJData)
+    {
+        CJSON::SetLastError(ERROR_OUTOFMEMORY);
+        return -1;
+    }
+
+    int nRes = CJSON::parseJSON(pStr, nchLen, *pJData, pJError, nParseFlags & ~JPF_REFERENCE_SOURCE);
+    if(nRes == 1)
+    {
+        if(!publish(pJData))
+            nRes = -1;
+    }
+    else
+    {
+        delete pJData;
+    }
+
+    return nRes;
+}
+
+
+int JSON_SNAPSHOTS::publishJSONFile(LPCTSTR pStrFilePath, JSON_ERROR* pJError, UINT nParseFlags, uint64_t ncbSzMaxFileSz)
+{
+    //Parse JSON file in this thread, and publish it as the current version if it's valid (see publish())
+    //INFO: If it's not valid, the current version stays unchanged.
+    //'pStrFilePath' = file path to parse (see CJSON::parseJSONFile)
+    //'pJError' = if not nullptr, will be filled with parsing error details
+    //'nParseFlags' = JPF_* flags to parse with
+    //'ncbSzMaxFileSz' = maximum allowed file size in BYTEs, or 0 for no limit
+    //RETURN:
+    //		= 1 if parsed and published OK
+    //		= 0 if JSON syntax error (check 'pJError' for details)
+    //		= -1 if other error (check CJSON::GetLastError() for info)
+    JSON_DATA* pJData = new (std::nothrow) JSON_DATA;
+    if(!pJData)
+    {
+        CJSON::SetLastError(ERROR_OUTOFMEMORY);
+        return -1;
+    }
+
+    int nRes = CJSON::parseJSONFile(pStrFilePath, *pJData, pJError, nParseFlags, ncbSzMaxFileSz);
+    if(nRes == 1)
+    {
+        if(!publish(pJData))
+            nRes = -1;
+    }
+    else
+    {
+        delete pJData;
+    }
+
+    return nRes;
+}
+
+
+size_t JSON_SNAPSHOTS::reclaim()
+{
+    //Delete replaced versions of JSON data that are no longer used by any JSON_SNAPSHOT_REF
+    //INFO: It's done on each publish() as well, so call it only to free old versions sooner.
+    //RETURN:
+    //		= Number of replaced versions that are still in use
+    if(!pState)
+        return 0;
+
+    std::lock_guard<std::mutex> lock(pState->mtxPublish);
+
+    return _reclaimRetired();
+}
+
+
+size_t JSON_SNAPSHOTS::_reclaimRetired()
+{
+    //Delete replaced versions of JSON data that are not in any hazard pointer
+    //INFO: 'mtxPublish' must be locked when this is called!
+    //RETURN:
+    //		= Number of replaced versions that are still in use
+    std::vector<JSON_DATA*>& arrRetired = pState->arrRetired;
+    if(arrRetired.empty())
+        return 0;
+
+    //Versions that references use now (any reference that didn't set its hazard pointer yet
+    //will see that its version was replaced, and will pick the current one)
+    std::vector<JSON_DATA*> arrInUse;
+    for(JSON_HAZARD* pHaz = pState->pHazards.load(); pHaz; pHaz = pHaz->pNext)
+    {
+        JSON_DATA* pJData = pHaz->pJData.load();
+        if(pJData)
+            arrInUse.push_back(pJData);
+    }
+
+    std::sort(arrInUse.begin(), arrInUse.end());
+
+    size_t nCntKept = 0;
+    for(size_t i = 0; i < arrRetired.size(); i++)
+    {
+        if(std::binary_search(arrInUse.begin(), arrInUse.end(), arrRetired[i]))
+        {
+            arrRetired[nCntKept++] = arrRetired[i];
+        }
+        else
+        {
+            delete arrRetired[i];
+        }
+    }
+
+    arrRetired.resize(nCntKept);
+
+    return nCntKept;
+}
+
+
+JSON_DATA* JSON_SNAPSHOT_REF::acquire(JSON_SNAPSHOTS* pSnapshots)
+{
+    //Acquire the current version of JSON data from 'pSnapshots', releasing the one acquired before (if any)
+    //INFO: This never locks. It allocates memory only if more references are used at once than ever before.
+    //RETURN:
+    //		= Acquired version of JSON data (it's frozen and must not be changed), or
+    //		= nullptr if none was published yet, or if error (check CJSON::GetLastError() for info)
+    if(!pSnapshots ||
+        !pSnapshots->pState)
+    {
+        release();
+        CJSON::SetLastError(pSnapshots ? ERROR_OUTOFMEMORY : ERROR_INVALID_PARAMETER);
+        return nullptr;
+    }
 
-                    //Add it
-                    pJA->arrArrElmts.push_back(jae);
+    JSON_SNAPSHOTS_STATE* pState = pSnapshots->pState;
 
-                    //Done
-                    bRes = true;
-                }
+    if(pHolder != pSnapshots)
+    {
+        release();
+
+        //Take a free hazard pointer
+        JSON_HAZARD* pHaz = pState->pHazards.load();
+        for(; pHaz; pHaz = pHaz->pNext)
+        {
+            bool bTaken = false;
+            if(!pHaz->bTaken.load(std::memory_order_relaxed) &&
+                pHaz->bTaken.compare_exchange_strong(bTaken, true))
+            {
+                break;
             }
-            else
+        }
+
+        if(!pHaz)
+        {
+            //All are taken, add a new one
+            pHaz = new (std::nothrow) JSON_HAZARD;
+            if(!pHaz)
             {
-                //Can add only to the Array or Object note
-                ASSERT(nullptr);
+                CJSON::SetLastError(ERROR_OUTOFMEMORY);
+                return nullptr;
+            }
+
+            pHaz->pJData = nullptr;
+            pHaz->bTaken = true;
+
+            JSON_HAZARD* pHead = pState->pHazards.load();
+            do
+            {
+                pHaz->pNext = pHead;
             }
+            while(!pState->pHazards.compare_exchange_weak(pHead, pHaz));
         }
+
+        pHolder = pSnapshots;
+        pHazard = pHaz;
     }
 
-    return bRes;
+    //Announce the version that we'll use, and make sure that it wasn't replaced in the meantime
+    //(otherwise the publishing thread could have missed it and deleted it)
+    JSON_DATA* pCurJData = pState->pCurrent.load();
+    for(;;)
+    {
+        pHazard->pJData.store(pCurJData);
+
+        JSON_DATA* pNowJData = pState->pCurrent.load();
+        if(pNowJData == pCurJData)
+            break;
+
+        pCurJData = pNowJData;
+    }
+
+    pJData = pCurJData;
+
+    if(!pJData)
+    {
+        CJSON::SetLastError(ERROR_INVALID_DATA);
+    }
+
+    return pJData;
 }
 
-bool JSON_NODE::addNode_String(LPCTSTR pStrName, LPCTSTR pStrValue)
+
+void JSON_SNAPSHOT_REF::release()
 {
-    //Add new string node to this node (where this node is either an object or array node)
-    //'pStrName' = node name (cannot be empty for objects and not used for arrays)
-    //				INFO: JSON specs do not allow duplicate names (this class allows it.)
-    //				INFO: JSON specs specifies that names are case-sensitive (this class can treat them as case-insensitive when looking for nodes)
-    //						http://tools.ietf.org/html/rfc7158
-    //'pStrValue' = value
-    //RETURN:
-    //		= true if success
-    return _addNode_WithType(pStrName, JVT_DOUBLE_QUOTED, pStrValue);
+    //Release the acquired version of JSON data, so that it can be deleted if it was replaced
+    if(pHazard)
+    {
+        pHazard->pJData.store(nullptr, std::memory_order_release);
+        pHazard->bTaken.store(false, std::memory_order_release);
+        pHazard = nullptr;
+    }
+
+    pHolder = nullptr;
+    pJData = nullptr;
 }
 
-bool JSON_NODE::addNode_BOOL(LPCTSTR pStrName, bool bValue)
+
+
+struct JSON_MSGPACK_WRITER
 {
-    //Add new boolean node to this node (where this node is either an object or array node)
-    //'pStrName' = node name (cannot be empty for objects and not used for arrays)
-    //				INFO: JSON specs do not allow duplicate names (this class allows it.)
-    //				INFO: JSON specs specifies that names are case-sensitive (this class can treat them as case-insensitive when looking for nodes)
-    //						http://tools.ietf.org/html/rfc7158
-    //'bValue' = value
+    //Output of CJSON::toMsgPack()
+    std::vector<BYTE>* pOutData;        //Receives MessagePack data (it's kept larger than needed while writing)
+    size_t ncbUsed;                     //Number of BYTEs written into 'pOutData'
+
+    BYTE* append(size_t ncbSz)
+    {
+        //RETURN: = Pointer to write next 'ncbSz' BYTEs to
+        if(ncbUsed + ncbSz > pOutData->size())
+        {
+            pOutData->resize(std::max(pOutData->size() * 2, ncbUsed + ncbSz + 0x100));
+        }
+
+        BYTE* p = pOutData->data() + ncbUsed;
+        ncbUsed += ncbSz;
+
+        return p;
+    }
+};
+
+
+bool CJSON::toMsgPack(JSON_DATA* pJE, std::vector<BYTE>* pOutData)
+{
+    //Convert JSON data into MessagePack binary format
+    //INFO: Strings are written as UTF-8, objects as maps and arrays as arrays (both with their sizes up front.)
+    //      Plain values are written as nil, boolean, integer or float64 only if they would be written back with the same text,
+    //      otherwise their text is kept in an extension of JSON_MSGPACK_EXT_PLAIN_TEXT type, so that CJSON::parseMsgPack() gives the same JSON back.
+    //'pOutData' = receives MessagePack data (it's replaced, but its memory is reused)
     //RETURN:
     //		= true if success
+    //		= false if error (check CJSON::GetLastError() for info)
+    if(!pJE ||
+        !pOutData ||
+        pJE->val.isEmptyValue())
+    {
+        CJSON::SetLastError(ERROR_INVALID_PARAMETER);
+        return false;
+    }
 
-    //And add it
-    return _addNode_WithType(pStrName, JVT_PLAIN, bValue ? L("true") : L("false"));
+    JSON_MSGPACK_WRITER writer;
+    writer.pOutData = pOutData;
+    writer.ncbUsed = 0;
+
+    //Use all memory that it already has
+    pOutData->resize(pOutData->capacity());
+
+    bool bRes = _writeMsgPackValue(pJE->val, &writer);
+
+    pOutData->resize(bRes ? writer.ncbUsed : 0);
+
+    return bRes;
 }
 
-bool JSON_NODE::addNode_Bool(LPCTSTR pStrName, bool bValue)
+
+int CJSON::parseMsgPack(const BYTE* pData, size_t ncbDataSz, JSON_DATA& outJEs, JSON_ERROR* pJError)
 {
-    //Add new boolean node to this node (where this node is either an object or array node)
-    //'pStrName' = node name (cannot be empty for objects and not used for arrays)
-    //				INFO: JSON specs do not allow duplicate names (this class allows it.)
-    //				INFO: JSON specs specifies that names are case-sensitive (this class can treat them as case-insensitive when looking for nodes)
-    //						http://tools.ietf.org/html/rfc7158
-    //'bValue' = value
+    //Parse MessagePack binary data into JSON data
+    //INFO: Integers and floats are kept as converted values (the same way as JPF_NATIVE_VALUES does it), nil and booleans
+    //      become null, true and false, and extensions of JSON_MSGPACK_EXT_PLAIN_TEXT type become plain values with their text.
+    //      Other extensions and binary data can't be represented in JSON and are treated as errors. Keys of maps must be strings.
+    //'pData' = MessagePack data with one root value
+    //'ncbDataSz' = size of 'pData' in BYTEs
+    //'outJEs' = receives parsed JSON data (it's emptied if this method fails)
+    //'pJError' = if not nullptr, will be filled with parsing error details (with 'nErrIndex' as offset in 'pData' in BYTEs)
     //RETURN:
-    //		= true if success
+    //		= 1 if got it OK
+    //		= 0 if MessagePack format error
+    //		= -1 if other error (such as out of memory, etc.)
+    //           INFO: Check CJSON::GetLastError() for more info.
+    outJEs.emptyData();
 
-    //And add it
-    return _addNode_WithType(pStrName, JVT_PLAIN, bValue ? L("true") : L("false"));
+    if(!pData &&
+        ncbDataSz)
+    {
+        _describeError(pJError, -1, L("Bad input parameter(s)"));
+        CJSON::SetLastError(ERROR_INVALID_PARAMETER);
+        return -1;
+    }
+
+    CJSON::SetLastError(0);
+
+    size_t i = 0;
+    int nRes = _parseMsgPackValue(outJEs.val, pData, i, ncbDataSz, outJEs.getArena(), pJError, 0);
+    if(nRes == 1 &&
+        i != ncbDataSz)
+    {
+        //Something else follows the root value
+        ASSERT(nullptr);
+        _describeError(pJError, i, L("Unexpected data after the root node"));
+        nRes = 0;
+    }
+
+    if(nRes != 1)
+    {
+        int nErr = CJSON::GetLastError();
+        outJEs.emptyData();
+
+        CJSON::SetLastError(nRes == 0 ? ERROR_INVALID_DATA : nErr);
+    }
+
+    return nRes;
 }
 
-bool JSON_NODE::addNode_Null(LPCTSTR pStrName)
+
+bool CJSON::_writeMsgPackValue(const JSON_VALUE& jv, JSON_MSGPACK_WRITER* pWriter)
 {
-    //Add new null node to this node (where this node is either an object or array node)
-    //'pStrName' = node name (cannot be empty for objects and not used for arrays)
-    //				INFO: JSON specs do not allow duplicate names (this class allows it.)
-    //				INFO: JSON specs specifies that names are case-sensitive (this class can treat them as case-insensitive when looking for nodes)
-    //						http://tools.ietf.org/html/rfc7158
+    //Append 'jv' and all values nested in it in MessagePack format
     //RETURN:
     //		= true if success
+    //		= false if error (check CJSON::GetLastError() for info)
+    switch(jv.valType)
+    {
+    case JVT_PLAIN:
+        return _writeMsgPackPlainValue(jv, pWriter);
 
-    //And add it
-    return _addNode_WithType(pStrName, JVT_PLAIN, L("null"));
+    case JVT_DOUBLE_QUOTED:
+        return _writeMsgPackString(jv.getStrPtr(), jv.getStrLen(), false, pWriter);
+
+    case JVT_ARRAY:
+        {
+            JSON_ARRAY* pJA = (JSON_ARRAY*)jv.pValue;
+            ASSERT(pJA);
+
+            size_t nCnt = pJA->arrArrElmts.size();
+            _writeMsgPackSize(nCnt, 0x90, 15, 0, 0xdc, 0xdd, pWriter);
+
+            for(size_t a = 0; a < nCnt; a++)
+            {
+                if(!_writeMsgPackValue(pJA->arrArrElmts[a].val, pWriter))
+                    return false;
+            }
+        }
+        return true;
+
+    case JVT_OBJECT:
+        {
+            JSON_OBJECT* pJO = (JSON_OBJECT*)jv.pValue;
+            ASSERT(pJO);
+
+            size_t nCnt = pJO->arrObjElmts.size();
+            _writeMsgPackSize(nCnt, 0x80, 15, 0, 0xde, 0xdf, pWriter);
+
+            for(size_t o = 0; o < nCnt; o++)
+            {
+                const JSON_OBJECT_ELEMENT& joe = pJO->arrObjElmts[o];
+
+                if(!_writeMsgPackString(joe.getNamePtr(), joe.getNameLen(), false, pWriter) ||
+                    !_writeMsgPackValue(joe.val, pWriter))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+
+    default:
+        break;
+    }
+
+    //Value that wasn't filled
+    ASSERT(nullptr);
+    CJSON::SetLastError(ERROR_INVALID_DATA);
+    return false;
 }
 
-bool JSON_NODE::addNode_Int(LPCTSTR pStrName, LPCTSTR pStrValue)
+
+bool CJSON::_writeMsgPackPlainValue(const JSON_VALUE& jv, JSON_MSGPACK_WRITER* pWriter)
 {
-    //Add new integer node to this node (where this node is either an object or array node)
-    //'pStrName' = node name (cannot be empty for objects and not used for arrays)
-    //				INFO: JSON specs do not allow duplicate names (this class allows it.)
-    //				INFO: JSON specs specifies that names are case-sensitive (this class can treat them as case-insensitive when looking for nodes)
-    //						http://tools.ietf.org/html/rfc7158
-    //'pStrValue' = value
+    //Append plain value 'jv' in MessagePack format
+    //INFO: It's written as a native MessagePack value only if CJSON::toString() would write that value back with the same text
     //RETURN:
     //		= true if success
+    //		= false if error (check CJSON::GetLastError() for info)
+    ASSERT(jv.valType == JVT_PLAIN);
 
-    //Check if number
-    if(!CJSON::isIntegerBase10String(pStrValue))
-        return false;
+    int64_t iiVal = 0;
+    double fVal = 0;
 
-    //And add it
-    return _addNode_WithType(pStrName, JVT_PLAIN, pStrValue);
+    switch(_getCanonicalPlainValue(jv, &iiVal, &fVal))
+    {
+    case JNT_NULL:
+        *pWriter->append(1) = 0xc0;
+        break;
+
+    case JNT_BOOLEAN:
+        *pWriter->append(1) = iiVal ? 0xc3 : 0xc2;
+        break;
+
+    case JNT_INTEGER:
+        if(iiVal >= 0)
+        {
+            if(iiVal <= 0x7f)
+                *pWriter->append(1) = (BYTE)iiVal;
+            else if(iiVal <= 0xff)
+                _writeMsgPackHeader(0xcc, (uint64_t)iiVal, 1, pWriter);
+            else if(iiVal <= 0xffff)
+                _writeMsgPackHeader(0xcd, (uint64_t)iiVal, 2, pWriter);
+            else if(iiVal <= 0xffffffffLL)
+                _writeMsgPackHeader(0xce, (uint64_t)iiVal, 4, pWriter);
+            else
+                _writeMsgPackHeader(0xcf, (uint64_t)iiVal, 8, pWriter);
+        }
+        else
+        {
+            if(iiVal >= -32)
+                *pWriter->append(1) = (BYTE)(int8_t)iiVal;
+            else if(iiVal >= INT8_MIN)
+                _writeMsgPackHeader(0xd0, (uint64_t)iiVal, 1, pWriter);
+            else if(iiVal >= INT16_MIN)
+                _writeMsgPackHeader(0xd1, (uint64_t)iiVal, 2, pWriter);
+            else if(iiVal >= INT32_MIN)
+                _writeMsgPackHeader(0xd2, (uint64_t)iiVal, 4, pWriter);
+            else
+                _writeMsgPackHeader(0xd3, (uint64_t)iiVal, 8, pWriter);
+        }
+        break;
+
+    case JNT_FLOAT:
+        {
+            uint64_t uiBits;
+            memcpy(&uiBits, &fVal, sizeof(uiBits));
+
+            _writeMsgPackHeader(0xcb, uiBits, 8, pWriter);
+        }
+        break;
+
+    default:
+        //Keep its text
+        return _writeMsgPackString(jv.getStrPtr(), jv.getStrLen(), true, pWriter);
+    }
+
+    return true;
 }
 
-bool JSON_NODE::addNode_Int(LPCTSTR pStrName, int nValue)
+
+JSON_NODE_TYPE CJSON::_getCanonicalPlainValue(const JSON_VALUE& jv, int64_t* piiOutVal, double* pfOutVal)
 {
-    //Add new integer node to this node (where this node is either an object or array node)
-    //'pStrName' = node name (cannot be empty for objects and not used for arrays)
-    //				INFO: JSON specs do not allow duplicate names (this class allows it.)
-    //				INFO: JSON specs specifies that names are case-sensitive (this class can treat them as case-insensitive when looking for nodes)
-    //						http://tools.ietf.org/html/rfc7158
-    //'nValue' = value
+    //Check if plain value 'jv' can be kept as null, boolean, integer or float instead of its text,
+    //because CJSON::toString() would write that value back with the same text
+    //'piiOutVal' = receives the integer, or 1 for true and 0 for false
+    //'pfOutVal' = receives the float
     //RETURN:
-    //		= true if success
+    //		= JNT_NULL, JNT_BOOLEAN, JNT_INTEGER or JNT_FLOAT if yes
+    //		= JNT_NONE if its text must be kept
+    ASSERT(jv.valType == JVT_PLAIN);
 
-    //And add it
-    return _addNode_WithType(pStrName, JVT_PLAIN, CJSON::easyFormat(L("%d"), nValue).c_str());
+    if(jv.isNativeOnly())
+    {
+        //Converted when parsed, and always written from the value
+        if(jv.nativeType == JNT_INTEGER)
+        {
+            *piiOutVal = jv.iiNative;
+            return JNT_INTEGER;
+        }
+
+        *pfOutVal = jv.fNative;
+        return JNT_FLOAT;
+    }
+
+    const WCHAR* pStr = jv.getStrPtr();
+    intptr_t nchLen = jv.getStrLen();
+
+    WCHAR c = nchLen > 0 ? pStr[0] : 0;
+    if(c == 'n' ||
+        c == 't' ||
+        c == 'f')
+    {
+        if(nchLen == 4 && memcmp(pStr, L("null"), 4 * sizeof(WCHAR)) == 0)
+            return JNT_NULL;
+
+        if(nchLen == 4 && memcmp(pStr, L("true"), 4 * sizeof(WCHAR)) == 0)
+        {
+            *piiOutVal = 1;
+            return JNT_BOOLEAN;
+        }
+
+        if(nchLen == 5 && memcmp(pStr, L("false"), 5 * sizeof(WCHAR)) == 0)
+        {
+            *piiOutVal = 0;
+            return JNT_BOOLEAN;
+        }
+    }
+
+    //Most integers are written back as they are
+    if(_isCanonicalInt64(pStr, nchLen, piiOutVal))
+        return JNT_INTEGER;
+
+    //Other numbers have to be written back with the same text
+    JSON_NODE_TYPE type = JNT_NONE;
+    WCHAR buff[JSON_NUMBER_BUFF_LEN];
+    intptr_t nchLnNum = -1;
+    int64_t iiVal = 0;
+    double fVal = 0;
+
+    if(jv.nativeType == JNT_INTEGER ||
+        (jv.nativeType == JNT_NONE && parseInt64(pStr, nchLen, &iiVal) > 0))
+    {
+        if(jv.nativeType == JNT_INTEGER)
+            iiVal = jv.iiNative;
+
+        nchLnNum = _formatInt64(iiVal, buff);
+        type = JNT_INTEGER;
+    }
+    else if(jv.nativeType == JNT_FLOAT ||
+        (jv.nativeType == JNT_NONE && parseDouble(pStr, nchLen, &fVal)))
+    {
+        if(jv.nativeType == JNT_FLOAT)
+            fVal = jv.fNative;
+
+        if(std::isfinite(fVal))
+        {
+            nchLnNum = _formatDouble(fVal, buff);
+            type = JNT_FLOAT;
+        }
+    }
+
+    if(nchLnNum != nchLen ||
+        memcmp(buff, pStr, nchLen * sizeof(WCHAR)) != 0)
+    {
+        return JNT_NONE;
+    }
+
+    *piiOutVal = iiVal;
+    *pfOutVal = fVal;
+
+    return type;
 }
 
-bool JSON_NODE::addNode_Int64(LPCTSTR pStrName, LPCTSTR pStrValue)
+
+bool CJSON::_isCanonicalInt64(const WCHAR* pStr, intptr_t nchLen, int64_t* piiOutVal)
 {
-    //Add new 64-bit integer node to this node (where this node is either an object or array node)
-    //'pStrName' = node name (cannot be empty for objects and not used for arrays)
-    //				INFO: JSON specs do not allow duplicate names (this class allows it.)
-    //				INFO: JSON specs specifies that names are case-sensitive (this class can treat them as case-insensitive when looking for nodes)
-    //						http://tools.ietf.org/html/rfc7158
-    //'pStrValue' = value
+    //Check if 'pStr' is an integer of up to 18 digits, that CJSON::_formatInt64() would write the same way
+    //'piiOutVal' = receives the integer
     //RETURN:
-    //		= true if success
-    return addNode_Int(pStrName, pStrValue);
+    //		= true if yes
+    intptr_t i = 0;
+    bool bNegative = false;
+    if(nchLen > 0 &&
+        pStr[0] == '-')
+    {
+        bNegative = true;
+        i++;
+    }
+
+    intptr_t nCntDigits = nchLen - i;
+    if(nCntDigits <= 0 ||
+        nCntDigits > 18)
+    {
+        return false;
+    }
+
+    //No leading zeros, or "-0"
+    if(pStr[i] == '0' &&
+        (nCntDigits > 1 || bNegative))
+    {
+        return false;
+    }
+
+    int64_t iiVal = 0;
+    for(; i < nchLen; i++)
+    {
+        UINT nDigit = (UINT)pStr[i] - '0';
+        if(nDigit > 9)
+            return false;
+
+        iiVal = iiVal * 10 + nDigit;
+    }
+
+    *piiOutVal = bNegative ? -iiVal : iiVal;
+    return true;
 }
 
-bool JSON_NODE::addNode_Int64(LPCTSTR pStrName, int64_t iiValue)
+
+bool CJSON::_writeMsgPackString(const WCHAR* pStr, intptr_t nchLen, bool bPlainText, JSON_MSGPACK_WRITER* pWriter)
 {
-    //Add new 64-bit integer node to this node (where this node is either an object or array node)
-    //'pStrName' = node name (cannot be empty for objects and not used for arrays)
-    //				INFO: JSON specs do not allow duplicate names (this class allows it.)
-    //				INFO: JSON specs specifies that names are case-sensitive (this class can treat them as case-insensitive when looking for nodes)
-    //						http://tools.ietf.org/html/rfc7158
-    //'nValue' = value
+    //Append 'pStr' in MessagePack format, as UTF-8 encoded string
+    //'bPlainText' = true to write it as an extension of JSON_MSGPACK_EXT_PLAIN_TEXT type, false to write it as a string
     //RETURN:
     //		= true if success
+    //		= false if error (check CJSON::GetLastError() for info)
+#ifdef _WIN32
+    //Windows specific
+    int ncbLen = 0;
+    if(nchLen > 0)
+    {
+        ncbLen = ::WideCharToMultiByte(CP_UTF8, 0, pStr, (int)nchLen, nullptr, 0, nullptr, nullptr);
+        if(ncbLen <= 0)
+        {
+            CJSON::SetLastError(::GetLastError());
+            return false;
+        }
+    }
+#elif JSON_UTF8
+    //macOS & POSIX specific
+    size_t ncbLen = (size_t)nchLen;
+#endif
 
-    //And add it
-    return _addNode_WithType(pStrName, JVT_PLAIN, CJSON::easyFormat(L("%lld"), iiValue).c_str());
+    if(bPlainText)
+    {
+        _writeMsgPackSize((size_t)ncbLen, 0, 0, 0xc7, 0xc8, 0xc9, pWriter);
+        *pWriter->append(1) = JSON_MSGPACK_EXT_PLAIN_TEXT;
+    }
+    else
+    {
+        _writeMsgPackSize((size_t)ncbLen, 0xa0, 31, 0xd9, 0xda, 0xdb, pWriter);
+    }
+
+    if(ncbLen > 0)
+    {
+        BYTE* pDest = pWriter->append((size_t)ncbLen);
+
+#ifdef _WIN32
+        //Windows specific
+        if(::WideCharToMultiByte(CP_UTF8, 0, pStr, (int)nchLen, (char*)pDest, ncbLen, nullptr, nullptr) != ncbLen)
+        {
+            CJSON::SetLastError(::GetLastError());
+            return false;
+        }
+#elif JSON_UTF8
+        //macOS & POSIX specific
+        memcpy(pDest, pStr, ncbLen);
+#endif
+    }
+
+    return true;
 }
 
 
-bool JSON_NODE::addNode_Double(LPCTSTR pStrName, LPCTSTR pStrValue)
+void CJSON::_writeMsgPackHeader(BYTE nCode, uint64_t nValue, int ncbValueSz, JSON_MSGPACK_WRITER* pWriter)
 {
-    //Add new floating point value node to this node (where this node is either an object or array node)
-    //'pStrName' = node name (cannot be empty for objects and not used for arrays)
-    //				INFO: JSON specs do not allow duplicate names (this class allows it.)
-    //				INFO: JSON specs specifies that names are case-sensitive (this class can treat them as case-insensitive when looking for nodes)
-    //						http://tools.ietf.org/html/rfc7158
-    //'pStrValue' = value
-    //RETURN:
-    //		= true if success
+    //Append 'nCode' followed by 'ncbValueSz' low BYTEs of 'nValue' in big-endian order
+    BYTE* pDest = pWriter->append(1 + ncbValueSz);
+    pDest[0] = nCode;
 
-    //Check if number
-    if(!CJSON::isFloatingPointNumberString(pStrValue))
-        return false;
+    for(int b = ncbValueSz; b > 0; b--)
+    {
+        pDest[b] = (BYTE)nValue;
+        nValue >>= 8;
+    }
+}
 
-    //And add it
-    return _addNode_WithType(pStrName, JVT_PLAIN, pStrValue);
+
+void CJSON::_writeMsgPackSize(size_t nSize, BYTE nFixCode, size_t nFixMax, BYTE nCode8, BYTE nCode16, BYTE nCode32, JSON_MSGPACK_WRITER* pWriter)
+{
+    //Append MessagePack header with 'nSize', using the shortest form available
+    //'nFixCode' = code to add 'nSize' to, if it's not more than 'nFixMax', or 0 if there's no such form
+    //'nCode8' = code followed by 1-BYTE size, or 0 if there's no such form
+    //'nCode16' = code followed by 2-BYTE size
+    //'nCode32' = code followed by 4-BYTE size
+    if(nFixCode &&
+        nSize <= nFixMax)
+    {
+        *pWriter->append(1) = (BYTE)(nFixCode | nSize);
+    }
+    else if(nCode8 &&
+        nSize <= 0xff)
+    {
+        _writeMsgPackHeader(nCode8, nSize, 1, pWriter);
+    }
+    else if(nSize <= 0xffff)
+    {
+        _writeMsgPackHeader(nCode16, nSize, 2, pWriter);
+    }
+    else
+    {
+        //INFO: MessagePack can't have more than 4GB in one string, or 4G elements in one container
+        ASSERT(nSize <= 0xffffffff);
+        _writeMsgPackHeader(nCode32, nSize, 4, pWriter);
+    }
 }
 
-bool JSON_NODE::addNode_Double(LPCTSTR pStrName, double fValue)
+
+static uint64_t _readMsgPackUInt(const BYTE* pData, int ncbSz)
 {
-    //Add new floating point value node to this node (where this node is either an object or array node)
-    //'pStrName' = node name (cannot be empty for objects and not used for arrays)
-    //				INFO: JSON specs do not allow duplicate names (this class allows it.)
-    //				INFO: JSON specs specifies that names are case-sensitive (this class can treat them as case-insensitive when looking for nodes)
-    //						http://tools.ietf.org/html/rfc7158
-    //'nValue' = value
-    //RETURN:
-    //		= true if success
+    //RETURN: = Unsigned integer from 'ncbSz' BYTEs of 'pData' in big-endian order
+    uint64_t nVal = 0;
+    for(int b = 0; b < ncbSz; b++)
+    {
+        nVal = (nVal << 8) | pData[b];
+    }
 
-    //And add it
-    return _addNode_WithType(pStrName, JVT_PLAIN, CJSON::easyFormat(L("%f"), fValue).c_str());
+    return nVal;
 }
 
 
-
-intptr_t JSON_NODE::setNodeByName(LPCTSTR pStrName, JSON_NODE* pJNode, bool bCaseSensitive)
+int CJSON::_parseMsgPackValue(JSON_VALUE& jv, const BYTE* pData, size_t& i, size_t nLen, JSON_ARENA* pArena, JSON_ERROR* pJError, int nDepth)
 {
-    //Set node with 'pStrName' in this node to a new value
-    //INFO: It makes a "deep" copy of 'pJNode'
-    //INFO: Can't be used to set nodes from the same JSON data.
-    //INFO: Sets ALL nodes with the matching name, if there's more than one
-    //'pStrName' = node name to set (cannot be empty)
-    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
+    //Parse one MessagePack value from 'pData' at 'i' into 'jv'
+    //'i' = offset of the value in 'pData', receives offset after it
+    //'nDepth' = number of arrays and maps that the value is nested in
     //RETURN:
-    //		= [1 and up) number if nodes set, or
-    //		= 0 if no nodes matched the name provided
-    //		= -1 if error setting (some elements might have been copied into destination node)
-    intptr_t nCntNodesSet = -1;
-    ASSERT(pJSONData);
-
-    //Node must be specified and it must have a name
-    if(pJNode &&
-        pStrName &&
-        pStrName[0] &&
-        pJSONData)
+    //		= 1 if got it OK
+    //		= 0 if format error
+    //		= -1 if other error
+    if(i >= nLen)
     {
-        //Make sure that JSON data is not the same
-        if(this->pJSONData != pJNode->pJSONData &&
-            pJNode->pJSONData)
-        {
-            ASSERT(pVal);
-            if(pVal->valType == JVT_OBJECT)
-            {
-                JSON_OBJECT* pJO = (JSON_OBJECT*)pVal->pValue;
-                ASSERT(pJO);
-                if(pJO)
-                {
-                    //Assume success
-                    nCntNodesSet = 0;
-
-                    //Start looking for needed nodes
-                    for(JSON_SRCH jSrch;;)
-                    {
-                        //Find next node by name
-                        JSON_NODE_TYPE resFN = findNodeByName(pStrName, nullptr, bCaseSensitive, &jSrch);
-                        if(resFN > JNT_NONE)
-                        {
-                            intptr_t nFndInd = jSrch.getIndexFoundAt();
-                            if(nFndInd >= 0 &&
-                                nFndInd < (intptr_t)pJO->arrObjElmts.size())
-                            {
-                                //Pick element found
-                                JSON_OBJECT_ELEMENT* pJOE = &pJO->arrObjElmts[nFndInd];
+        ASSERT(nullptr);
+        _describeError(pJError, i, L("Unexpected EOF"));
+        return 0;
+    }
 
-                                //First clear the old value
-                            //	CJSON::_freeJSON_VALUE(pJOE->val);			//No need to do it -- it will be done by _deepCopyJSON_VALUE()!
+    size_t iStart = i;
+    BYTE c = pData[i++];
 
-                                //And do "deep" copy
-                                if(CJSON::_deepCopyJSON_VALUE(&pJOE->val, pJNode->pVal))
-                                {
-                                    //Count the ones set
-                                    if(nCntNodesSet >= 0)
-                                        nCntNodesSet++;
-                                }
-                                else
-                                {
-                                    //Failed
-                                    ASSERT(nullptr);
-                                    nCntNodesSet = -1;
-                                }
-                            }
-                            else
-                            {
-                                //Error
-                                ASSERT(nullptr);
-                                nCntNodesSet = -1;
-                                break;
-                            }
-                        }
-                        else
-                        {
-                            if(resFN == JNT_ERROR)
-                            {
-                                //Error
-                                ASSERT(nullptr);
-                                nCntNodesSet = -1;
-                            }
+    //Sizes of MessagePack values: size of the following length or value in BYTEs
+    int ncbSz = 0;
+    uint64_t nVal = 0;
 
-                            break;
-                        }
-                    }
+    enum
+    {
+        MPK_INT, MPK_UINT, MPK_FLOAT32, MPK_FLOAT64, MPK_STR, MPK_EXT, MPK_ARRAY, MPK_MAP,
+    }
+    kind;
 
-                }
-            }
-            else
-            {
-                //Can be only an Object node
-                ASSERT(nullptr);
-            }
-        }
-        else
+    if(c <= 0x7f)
+    {
+        //Positive fixint
+        kind = MPK_INT;
+        nVal = c;
+    }
+    else if(c >= 0xe0)
+    {
+        //Negative fixint
+        kind = MPK_INT;
+        nVal = (uint64_t)(int64_t)(int8_t)c;
+    }
+    else if(c <= 0x8f)
+    {
+        kind = MPK_MAP;
+        nVal = c & 0x0f;
+    }
+    else if(c <= 0x9f)
+    {
+        kind = MPK_ARRAY;
+        nVal = c & 0x0f;
+    }
+    else if(c <= 0xbf)
+    {
+        kind = MPK_STR;
+        nVal = c & 0x1f;
+    }
+    else
+    {
+        switch(c)
         {
-            //Can't use same JSON object
+        case 0xc0:
+            jv.valType = JVT_PLAIN;
+            jv.strValue = L("null");
+            jv.nativeType = JNT_NULL;
+            return 1;
+        case 0xc2:
+        case 0xc3:
+            jv.valType = JVT_PLAIN;
+            jv.strValue = c == 0xc3 ? L("true") : L("false");
+            jv.nativeType = JNT_BOOLEAN;
+            jv.bNative = c == 0xc3;
+            return 1;
+
+        case 0xcc: kind = MPK_UINT; ncbSz = 1; break;
+        case 0xcd: kind = MPK_UINT; ncbSz = 2; break;
+        case 0xce: kind = MPK_UINT; ncbSz = 4; break;
+        case 0xcf: kind = MPK_UINT; ncbSz = 8; break;
+        case 0xd0: kind = MPK_INT; ncbSz = 1; break;
+        case 0xd1: kind = MPK_INT; ncbSz = 2; break;
+        case 0xd2: kind = MPK_INT; ncbSz = 4; break;
+        case 0xd3: kind = MPK_INT; ncbSz = 8; break;
+        case 0xca: kind = MPK_FLOAT32; ncbSz = 4; break;
+        case 0xcb: kind = MPK_FLOAT64; ncbSz = 8; break;
+        case 0xd9: kind = MPK_STR; ncbSz = 1; break;
+        case 0xda: kind = MPK_STR; ncbSz = 2; break;
+        case 0xdb: kind = MPK_STR; ncbSz = 4; break;
+        case 0xdc: kind = MPK_ARRAY; ncbSz = 2; break;
+        case 0xdd: kind = MPK_ARRAY; ncbSz = 4; break;
+        case 0xde: kind = MPK_MAP; ncbSz = 2; break;
+        case 0xdf: kind = MPK_MAP; ncbSz = 4; break;
+        case 0xc7: kind = MPK_EXT; ncbSz = 1; break;
+        case 0xc8: kind = MPK_EXT; ncbSz = 2; break;
+        case 0xc9: kind = MPK_EXT; ncbSz = 4; break;
+        case 0xd4: kind = MPK_EXT; nVal = 1; break;
+        case 0xd5: kind = MPK_EXT; nVal = 2; break;
+        case 0xd6: kind = MPK_EXT; nVal = 4; break;
+        case 0xd7: kind = MPK_EXT; nVal = 8; break;
+        case 0xd8: kind = MPK_EXT; nVal = 16; break;
+
+        default:
+            //Binary data (0xc4 - 0xc6) and never used (0xc1)
             ASSERT(nullptr);
+            _describeError(pJError, iStart, L("Unsupported MessagePack type"));
+            return 0;
         }
-    }
 
-    return nCntNodesSet;
-}
+        if(ncbSz)
+        {
+            if(nLen - i < (size_t)ncbSz)
+            {
+                ASSERT(nullptr);
+                _describeError(pJError, iStart, L("Unexpected EOF"));
+                return 0;
+            }
 
+            nVal = _readMsgPackUInt(pData + i, ncbSz);
+            i += ncbSz;
 
-bool JSON_NODE::setNodeByIndex(intptr_t nIndex, JSON_NODE* pJNode)
-{
-    //Set node with 'nIndex' in this node to a new value
-    //INFO: It makes a "deep" copy of 'pJNode'
-    //INFO: Can't be used to set nodes from the same JSON data.
-    //'nIndex' = node's 0-based index to set
-    //RETURN:
-    //		= true if success
-    bool bRes = false;
-    ASSERT(pJSONData);
+            if(kind == MPK_INT)
+            {
+                //Sign-extend it
+                int nShift = 64 - ncbSz * 8;
+                if(nShift)
+                    nVal = (uint64_t)(((int64_t)(nVal << nShift)) >> nShift);
+            }
+        }
+    }
 
-    //Node must be specified and valid
-    if(pJNode &&
-        pJSONData)
+    switch(kind)
     {
-        //Make sure that JSON data is not the same
-        if(this->pJSONData != pJNode->pJSONData &&
-            pJNode->pJSONData)
+    case MPK_UINT:
+        if(nVal > (uint64_t)INT64_MAX)
         {
-            ASSERT(pVal);
-            if(pVal->valType == JVT_OBJECT)
-            {
-                JSON_OBJECT* pJO = (JSON_OBJECT*)pVal->pValue;
-                ASSERT(pJO);
-                if(pJO)
-                {
-                    //Make sure index is within limits
-                    if(nIndex >= 0 &&
-                        nIndex < (intptr_t)pJO->arrObjElmts.size())
-                    {
-                        //Pick element found
-                        JSON_OBJECT_ELEMENT* pJOE = &pJO->arrObjElmts[nIndex];
-
-                        //First clear the old value
-                    //	CJSON::_freeJSON_VALUE(pJOE->val);			//No need to do it -- it will be done by _deepCopyJSON_VALUE()!
+            //Doesn't fit into a converted value
+            jv.valType = JVT_PLAIN;
 
-                        //And do "deep" copy
-                        if(CJSON::_deepCopyJSON_VALUE(&pJOE->val, pJNode->pVal))
-                        {
-                            //Done
-                            bRes = true;
-                        }
-                        else
-                        {
-                            //Failed
-                            ASSERT(nullptr);
-                        }
-                    }
-                }
-            }
-            else if(pVal->valType == JVT_ARRAY)
+            WCHAR buff[JSON_NUMBER_BUFF_LEN];
+            intptr_t nch = JSON_NUMBER_BUFF_LEN;
+            while(nVal)
             {
-                JSON_ARRAY* pJA = (JSON_ARRAY*)pVal->pValue;
-                ASSERT(pJA);
-                if(pJA)
-                {
-                    //Make sure index is within limits
-                    if(nIndex >= 0 &&
-                        nIndex < (intptr_t)pJA->arrArrElmts.size())
-                    {
-                        //Pick element found
-                        JSON_ARRAY_ELEMENT* pJAE = &pJA->arrArrElmts[nIndex];
-
-                        //First clear the old value
-                    //	CJSON::_freeJSON_VALUE(pJAE->val);			//No need to do it -- it will be done by _deepCopyJSON_VALUE()!
+                buff[--nch] = (WCHAR)('0' + nVal % 10);
+                nVal /= 10;
+            }
 
-                        //And do "deep" copy
-                        if(CJSON::_deepCopyJSON_VALUE(&pJAE->val, pJNode->pVal))
-                        {
-                            //Done
-                            bRes = true;
-                        }
-                        else
-                        {
-                            //Failed
-                            ASSERT(nullptr);
-                        }
-                    }
-                }
+            jv.strValue.assign(buff + nch, JSON_NUMBER_BUFF_LEN - nch);
+            jv.plainType = JNT_INTEGER;
+            return 1;
+        }
+        //Fall through
+    case MPK_INT:
+        jv.valType = JVT_PLAIN;
+        jv.nativeType = JNT_INTEGER;
+        jv.iiNative = (int64_t)nVal;
+        return 1;
+
+    case MPK_FLOAT32:
+    case MPK_FLOAT64:
+        {
+            double fVal;
+            if(kind == MPK_FLOAT32)
+            {
+                uint32_t uiBits = (uint32_t)nVal;
+                float f;
+                memcpy(&f, &uiBits, sizeof(f));
+                fVal = f;
             }
             else
+                memcpy(&fVal, &nVal, sizeof(fVal));
+
+            jv.valType = JVT_PLAIN;
+            jv.nativeType = JNT_FLOAT;
+            jv.fNative = fVal;
+
+            if(!std::isfinite(fVal))
+            {
+                //Keep its text, same as when parsed
+                WCHAR buff[JSON_NUMBER_BUFF_LEN];
+                jv.strValue.assign(buff, _formatDouble(fVal, buff));
+            }
+        }
+        return 1;
+
+    default:
+        break;
+    }
+
+    //The rest have 'nVal' as their size
+    if(kind == MPK_STR ||
+        kind == MPK_EXT)
+    {
+        int nExtType = 0;
+        if(kind == MPK_EXT)
+        {
+            if(i >= nLen)
             {
-                //Can be only an Object node
                 ASSERT(nullptr);
+                _describeError(pJError, iStart, L("Unexpected EOF"));
+                return 0;
             }
+
+            nExtType = (int8_t)pData[i++];
         }
-        else
+
+        if(nVal > nLen - i)
+        {
+            ASSERT(nullptr);
+            _describeError(pJError, iStart, L("Unexpected EOF"));
+            return 0;
+        }
+
+        if(kind == MPK_EXT &&
+            (nExtType != JSON_MSGPACK_EXT_PLAIN_TEXT || nVal == 0))
         {
-            //Can't use same JSON object
             ASSERT(nullptr);
+            _describeError(pJError, iStart, L("Unsupported MessagePack extension"));
+            return 0;
+        }
+
+        jv.valType = kind == MPK_STR ? JVT_DOUBLE_QUOTED : JVT_PLAIN;
+
+        if(!_readMsgPackString(jv.strValue, pData + i, (size_t)nVal))
+        {
+            _describeError(pJError, iStart, L("Bad UTF-8 string"));
+            return 0;
         }
+
+        //Text of plain values has its type determined now, same as when parsed
+        if(jv.valType == JVT_PLAIN)
+            jv.plainType = _determinePlainType(&jv);
+
+        i += (size_t)nVal;
+        return 1;
     }
 
-    return bRes;
-}
+    if(nDepth >= JSON_MSGPACK_MAX_DEPTH)
+    {
+        ASSERT(nullptr);
+        _describeError(pJError, iStart, L("Too deeply nested"));
+        return 0;
+    }
 
+    //Each element takes at least one BYTE (so that a bad size can't make us reserve too much memory)
+    if(nVal > (nLen - i) / (kind == MPK_MAP ? 2 : 1))
+    {
+        ASSERT(nullptr);
+        _describeError(pJError, iStart, L("Unexpected EOF"));
+        return 0;
+    }
 
-intptr_t JSON_NODE::_setNodeByName_WithType(LPCTSTR pStrName, JSON_VALUE_TYPE type, LPCTSTR pStrValue, bool bCaseSensitive)
-{
-    //Set node with 'pStrName' in this node to a new value
-    //INFO: This node must be an object.
-    //'pStrName' = node name to set (cannot be empty)
-    //'type' = type to assign to value. Can be JVT_PLAIN or JVT_DOUBLE_QUOTED
-    //'pStrValue' = value
-    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
-    //RETURN:
-    //		= [1 and up) number if nodes set, or
-    //		= 0 if no nodes matched the name provided
-    //		= -1 if error setting (some elements might have been copied into destination node)
-    intptr_t nCntNodesSet = -1;
-    ASSERT(pJSONData);
+    size_t nCnt = (size_t)nVal;
 
-    if(pJSONData)
+    if(kind == MPK_ARRAY)
     {
-        //Check allowed types
-        if(type == JVT_PLAIN ||
-            type == JVT_DOUBLE_QUOTED)
+        JSON_ARRAY* pJA = _newJSON_ARRAY(pArena);
+        if(!pJA)
         {
-            ASSERT(pVal);
-            if(pVal->valType == JVT_OBJECT)
-            {
-                //Only if we have a name
-                if(pStrName &&
-                    pStrName[0])
-                {
-                    JSON_OBJECT* pJO = (JSON_OBJECT*)pVal->pValue;
-                    ASSERT(pJO);
-                    if(pJO)
-                    {
-                        //Assume success
-                        nCntNodesSet = 0;
-
-                        //Start looking for needed nodes
-                        for(JSON_SRCH jSrch;;)
-                        {
-                            //Find next node by name
-                            JSON_NODE_TYPE resFN = findNodeByName(pStrName, nullptr, bCaseSensitive, &jSrch);
-                            if(resFN > JNT_NONE)
-                            {
-                                intptr_t nFndInd = jSrch.getIndexFoundAt();
-                                if(nFndInd >= 0 &&
-                                    nFndInd < (intptr_t)pJO->arrObjElmts.size())
-                                {
-                                    //Pick element found
-                                    JSON_OBJECT_ELEMENT* pJOE = &pJO->arrObjElmts[nFndInd];
+            ASSERT(nullptr);
+            _describeError(pJError, iStart, L("Out of memory"));
+            CJSON::SetLastError(ERROR_OUTOFMEMORY);
+            return -1;
+        }
 
-                                    //First clear the old value
-                                    CJSON::_freeJSON_VALUE(pJOE->val);
+        //Attach it now, so that it's freed with the rest of the data if anything fails
+        jv.valType = JVT_ARRAY;
+        jv.pValue = pJA;
 
-                                    //And set new simple value
-                                    pJOE->strName = pStrName;
+        pJA->arrArrElmts.resize(nCnt);
 
-                                    //And value
-                                    pJOE->val.valType = type;
-                                    pJOE->val.strValue = pStrValue ? pStrValue : L("");
-                                    pJOE->val.pValue = nullptr;
+        for(size_t a = 0; a < nCnt; a++)
+        {
+            int nR = _parseMsgPackValue(pJA->arrArrElmts[a].val, pData, i, nLen, pArena, pJError, nDepth + 1);
+            if(nR != 1)
+                return nR;
+        }
+    }
+    else
+    {
+        ASSERT(kind == MPK_MAP);
 
-                                    if(type == JVT_PLAIN)
-                                    {
-                                        //Trim value
-                                        CJSON::Trim(pJOE->val.strValue);
-                                    }
+        JSON_OBJECT* pJO = _newJSON_OBJECT(pArena);
+        if(!pJO)
+        {
+            ASSERT(nullptr);
+            _describeError(pJError, iStart, L("Out of memory"));
+            CJSON::SetLastError(ERROR_OUTOFMEMORY);
+            return -1;
+        }
 
-                                    //Count the ones set
-                                    if(nCntNodesSet >= 0)
-                                        nCntNodesSet++;
-                                }
-                                else
-                                {
-                                    //Error
-                                    ASSERT(nullptr);
-                                    nCntNodesSet = -1;
-                                    break;
-                                }
-                            }
-                            else
-                            {
-                                if(resFN == JNT_ERROR)
-                                {
-                                    //Error
-                                    ASSERT(nullptr);
-                                    nCntNodesSet = -1;
-                                }
+        //Attach it now, so that it's freed with the rest of the data if anything fails
+        jv.valType = JVT_OBJECT;
+        jv.pValue = pJO;
 
-                                break;
-                            }
-                        }
+        pJO->arrObjElmts.resize(nCnt);
 
-                    }
-                }
-            }
-            else
+        for(size_t o = 0; o < nCnt; o++)
+        {
+            JSON_OBJECT_ELEMENT& joe = pJO->arrObjElmts[o];
+
+            //Name must be a string
+            size_t iName = i;
+            JSON_VALUE jvName;
+            int nR = _parseMsgPackValue(jvName, pData, i, nLen, pArena, pJError, nDepth + 1);
+            if(nR == 1 &&
+                jvName.valType != JVT_DOUBLE_QUOTED)
             {
-                //Can add only to the Array or Object note
                 ASSERT(nullptr);
+                _describeError(pJError, iName, L("Name must be a string"));
+                nR = 0;
             }
+
+            if(nR != 1)
+            {
+                _freeJSON_VALUE(jvName);
+                return nR;
+            }
+
+            joe.strName.swap(jvName.strValue);
+
+            nR = _parseMsgPackValue(joe.val, pData, i, nLen, pArena, pJError, nDepth + 1);
+            if(nR != 1)
+                return nR;
         }
     }
 
-    return nCntNodesSet;
+    return 1;
 }
 
 
-intptr_t JSON_NODE::setNodeByName_String(LPCTSTR pStrName, LPCTSTR pStrValue, bool bCaseSensitive)
-{
-    //Set node with 'pStrName' to the 'pStrValue'
-    //'pStrName' = node name to set (cannot be empty)
-    //'pStrValue' = value to set
-    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
-    //RETURN:
-    //		= [1 and up) number if nodes set, or
-    //		= 0 if no nodes matched the name provided
-    //		= -1 if error setting (some elements might have been copied into destination node)
-    return _setNodeByName_WithType(pStrName, JVT_DOUBLE_QUOTED, pStrValue, bCaseSensitive);
-}
-
-intptr_t JSON_NODE::setNodeByName_BOOL(LPCTSTR pStrName, bool bValue, bool bCaseSensitive)
-{
-    //Set node with 'pStrName' to the 'bValue'
-    //'pStrName' = node name to set (cannot be empty)
-    //'bValue' = value to set
-    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
-    //RETURN:
-    //		= [1 and up) number if nodes set, or
-    //		= 0 if no nodes matched the name provided
-    //		= -1 if error setting (some elements might have been copied into destination node)
-    return _setNodeByName_WithType(pStrName, JVT_PLAIN, bValue ? L("true") : L("false"), bCaseSensitive);
-}
-intptr_t JSON_NODE::setNodeByName_Bool(LPCTSTR pStrName, bool bValue, bool bCaseSensitive)
+bool CJSON::_readMsgPackString(std_wstring& str, const BYTE* pData, size_t ncbSz)
 {
-    //Set node with 'pStrName' to the 'bValue'
-    //'pStrName' = node name to set (cannot be empty)
-    //'bValue' = value to set
-    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
+    //Set 'str' from UTF-8 encoded 'pData' of 'ncbSz' BYTEs
     //RETURN:
-    //		= [1 and up) number if nodes set, or
-    //		= 0 if no nodes matched the name provided
-    //		= -1 if error setting (some elements might have been copied into destination node)
-    return _setNodeByName_WithType(pStrName, JVT_PLAIN, bValue ? L("true") : L("false"), bCaseSensitive);
-}
+    //		= true if success
+    //		= false if it's not valid UTF-8 (check CJSON::GetLastError() for info)
+#ifdef _WIN32
+    //Windows specific
+    str.clear();
 
-intptr_t JSON_NODE::setNodeByName_Null(LPCTSTR pStrName, bool bCaseSensitive)
-{
-    //Set node with 'pStrName' to the null value
-    //'pStrName' = node name to set (cannot be empty)
-    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
-    //RETURN:
-    //		= [1 and up) number if nodes set, or
-    //		= 0 if no nodes matched the name provided
-    //		= -1 if error setting (some elements might have been copied into destination node)
-    return _setNodeByName_WithType(pStrName, JVT_PLAIN, L("null"), bCaseSensitive);
-}
+    if(ncbSz > 0)
+    {
+        int nchLen = ::MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, (const char*)pData, (int)ncbSz, nullptr, 0);
+        if(nchLen <= 0)
+        {
+            CJSON::SetLastError(ERROR_INVALID_DATA);
+            return false;
+        }
 
-intptr_t JSON_NODE::setNodeByName_Int(LPCTSTR pStrName, LPCTSTR pStrValue, bool bCaseSensitive)
-{
-    //Set node with 'pStrName' to the 'pStrValue'
-    //'pStrName' = node name to set (cannot be empty)
-    //'pStrValue' = value to set -- it must be an intefer
-    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
-    //RETURN:
-    //		= [1 and up) number if nodes set, or
-    //		= 0 if no nodes matched the name provided
-    //		= -1 if error setting (some elements might have been copied into destination node)
+        str.resize(nchLen);
+        if(::MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, (const char*)pData, (int)ncbSz, &str[0], nchLen) != nchLen)
+        {
+            CJSON::SetLastError(ERROR_INVALID_DATA);
+            return false;
+        }
+    }
+#elif JSON_UTF8
+    //macOS & POSIX specific
+    if(!json::JSON_NODE::isValidUtf8((const char*)pData, (intptr_t)ncbSz))
+    {
+        CJSON::SetLastError(ERROR_INVALID_DATA);
+        return false;
+    }
 
-    //Check if number
-    if(!CJSON::isIntegerBase10String(pStrValue))
-        return -1;
+    str.assign((const char*)pData, ncbSz);
+#endif
 
-    //And add it
-    return _setNodeByName_WithType(pStrName, JVT_PLAIN, pStrValue, bCaseSensitive);
+    return true;
 }
 
-intptr_t JSON_NODE::setNodeByName_Int(LPCTSTR pStrName, int nValue, bool bCaseSensitive)
+
+//Layout of the binary image written by CJSON::writeJSONImage() (JSON_IMAGE_VERSION):
+//  - JSON_IMAGE_HEADER, with the record of the root value
+//  - then blocks that records refer to by their offsets from the beginning of the image (each aligned to 8 BYTEs):
+//    null-terminated strings, JSON_IMAGE_ARRAY and JSON_IMAGE_OBJECT
+//INFO: Everything is in the byte order and the encoding of strings of the OS that wrote it.
+#define JSON_IMAGE_SIGNATURE "CJSONIMG"        //Signature in JSON_IMAGE_HEADER::sig
+#define JSON_IMAGE_BYTE_ORDER 0xFEFF            //Value of JSON_IMAGE_HEADER::nByteOrder
+#define JSON_IMAGE_VAL_TEXT 0x1                 //Flag for JSON_IMAGE_VALUE::nFlags: the value is kept as its text
+#define JSON_IMAGE_NO_ELEMENT 0xFFFFFFFF        //End of a chain in the index of names of JSON_IMAGE_OBJECT
+
+
+struct JSON_IMAGE_VALUE
 {
-    //Set node with 'pStrName' to the 'pStrValue'
-    //'pStrName' = node name to set (cannot be empty)
-    //'nValue' = value to set
-    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
-    //RETURN:
-    //		= [1 and up) number if nodes set, or
-    //		= 0 if no nodes matched the name provided
-    //		= -1 if error setting (some elements might have been copied into destination node)
+    //Record of a value in the image
+    uint8_t nType;                      //JSON_NODE_TYPE of the value: JNT_NULL, JNT_BOOLEAN, JNT_INTEGER, JNT_FLOAT, JNT_STRING, JNT_ARRAY or JNT_OBJECT
+    uint8_t nFlags;                     //JSON_IMAGE_VAL_* flags
+    uint16_t nReserved;                 //0
+    uint32_t nchLen;                    //Length of the text in TCHARs (without the terminating null), if JSON_IMAGE_VAL_TEXT
+    uint64_t nValue;                    //Depends on 'nType':
+                                        //  - with JSON_IMAGE_VAL_TEXT: offset of the text
+                                        //  - JNT_ARRAY: offset of JSON_IMAGE_ARRAY, JNT_OBJECT: offset of JSON_IMAGE_OBJECT
+                                        //  - JNT_INTEGER: int64_t, JNT_FLOAT: bits of the double, JNT_BOOLEAN: 1 or 0, JNT_NULL: 0
+};
 
-    //And add it
-    return _setNodeByName_WithType(pStrName, JVT_PLAIN, CJSON::easyFormat(L("%d"), nValue).c_str(), bCaseSensitive);
-}
+struct JSON_IMAGE_ARRAY
+{
+    //Block of an array in the image, followed by JSON_IMAGE_VALUE of each element
+    uint32_t nCnt;                      //Number of elements
+    uint32_t nReserved;                 //0
+};
 
-intptr_t JSON_NODE::setNodeByName_Int64(LPCTSTR pStrName, LPCTSTR pStrValue, bool bCaseSensitive)
+struct JSON_IMAGE_ELEMENT
 {
-    //Set node with 'pStrName' to the 'pStrValue'
-    //'pStrName' = node name to set (cannot be empty)
-    //'pStrValue' = value to set -- it must be an integer
-    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
-    //RETURN:
-    //		= [1 and up) number if nodes set, or
-    //		= 0 if no nodes matched the name provided
-    //		= -1 if error setting (some elements might have been copied into destination node)
-    return setNodeByName_Int(pStrName, pStrValue, bCaseSensitive);
-}
+    //Element of JSON_IMAGE_OBJECT
+    uint64_t nOffsetName;               //Offset of the name of the element
+    uint32_t nchName;                   //Length of the name in TCHARs (without the terminating null)
+    uint32_t nHashCI;                   //Hash of the name for case-insensitive search (only if the object has an index of names)
+    JSON_IMAGE_VALUE val;               //Value of the element
+};
 
-intptr_t JSON_NODE::setNodeByName_Int64(LPCTSTR pStrName, int64_t iiValue, bool bCaseSensitive)
+struct JSON_IMAGE_OBJECT
 {
-    //Set node with 'pStrName' to the 'pStrValue'
-    //'pStrName' = node name to set (cannot be empty)
-    //'iiValue' = value to set
-    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
-    //RETURN:
-    //		= [1 and up) number if nodes set, or
-    //		= 0 if no nodes matched the name provided
-    //		= -1 if error setting (some elements might have been copied into destination node)
+    //Block of an object in the image, followed by:
+    //  - JSON_IMAGE_ELEMENT of each element
+    //  - if 'nCntBuckets' is not 0, index of names (made of uint32_t indexes of elements, or JSON_IMAGE_NO_ELEMENT):
+    //     - first elements in each bucket for case-sensitive search ('nCntBuckets' of them), then the same for case-insensitive search
+    //     - next elements in the same bucket for case-sensitive search ('nCnt' of them), then the same for case-insensitive search
+    //     - elements with names that can't be case-folded ('nCntNotFolded' of them, in ascending order)
+    //INFO: Elements in each bucket are chained in ascending order.
+    uint32_t nCnt;                      //Number of elements
+    uint32_t nCntBuckets;               //Number of buckets in the index of names (power of 2), or 0 if there's no index
+    uint32_t nCntNotFolded;             //Number of elements with names that can't be case-folded (they are not in any bucket for case-insensitive search)
+    uint32_t nReserved;                 //0
+};
 
-    //And add it
-    return _setNodeByName_WithType(pStrName, JVT_PLAIN, CJSON::easyFormat(L("%lld"), iiValue).c_str(), bCaseSensitive);
-}
+struct JSON_IMAGE_HEADER
+{
+    //Beginning of the image
+    char sig[8];                        //JSON_IMAGE_SIGNATURE
+    uint32_t nVersion;                  //JSON_IMAGE_VERSION
+    uint16_t ncbChar;                   //Size of TCHAR in BYTEs
+    uint16_t nByteOrder;                //JSON_IMAGE_BYTE_ORDER
+    uint64_t ncbImage;                  //Size of the whole image in BYTEs
+    JSON_IMAGE_VALUE root;              //Root value
+    BYTE reserved[24];                  //0
+};
 
+static_assert(sizeof(JSON_IMAGE_VALUE) == 16 && sizeof(JSON_IMAGE_ELEMENT) == 32 && sizeof(JSON_IMAGE_HEADER) == 64, "Layout of the image must not change");
 
-intptr_t JSON_NODE::setNodeByName_Double(LPCTSTR pStrName, LPCTSTR pStrValue, bool bCaseSensitive)
+
+static bool _getImageNameHash(const WCHAR* pStr, intptr_t nchLen, bool bFold, uint32_t* pOutHash)
 {
-    //Set node with 'pStrName' to the 'pStrValue'
-    //'pStrName' = node name to set (cannot be empty)
-    //'pStrValue' = value to set -- it must be a floating point value
-    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
+    //Calculate hash of the name in 'pStr' of 'nchLen' TCHARs, for the index of names in the image
+    //INFO: It must be the same on any OS that can read the image, so for case-insensitive search only printable ASCII is folded
+    //      (as JSON_NODE::_getFoldedNameHash() does on Windows.) FNV-1a.
+    //'bFold' = true for case-insensitive search, false for case-sensitive
+    //'pOutHash' = receives the hash
     //RETURN:
-    //		= [1 and up) number if nodes set, or
-    //		= 0 if no nodes matched the name provided
-    //		= -1 if error setting (some elements might have been copied into destination node)
+    //		= true if success
+    //		= false if the name can't be case-folded (it must be compared with JSON_NODE::compareStringsEqual() then)
+    uint32_t uiHash = 2166136261U;
 
-    //Check if number
-    if(!CJSON::isFloatingPointNumberString(pStrValue))
-        return -1;
+    for(intptr_t i = 0; i < nchLen; i++)
+    {
+#ifdef _WIN32
+        //Windows specific
+        UINT z = (unsigned short)pStr[i];
+#elif JSON_UTF8
+        //macOS & POSIX specific
+        UINT z = (BYTE)pStr[i];
+#endif
+        if(bFold)
+        {
+            if(z < 0x20 ||
+                z > 0x7E)
+            {
+                return false;
+            }
 
-    //And add it
-    return _setNodeByName_WithType(pStrName, JVT_PLAIN, pStrValue, bCaseSensitive);
+            if(z >= 'A' &&
+                z <= 'Z')
+            {
+                z += 'a' - 'A';
+            }
+        }
+
+        uiHash = (uiHash ^ z) * 16777619U;
+    }
+
+    *pOutHash = uiHash;
+    return true;
 }
 
-intptr_t JSON_NODE::setNodeByName_Double(LPCTSTR pStrName, double fValue, bool bCaseSensitive)
+
+bool CJSON::writeJSONImage(JSON_DATA* pJE, std::vector<BYTE>* pOutData)
 {
-    //Set node with 'pStrName' to the 'pStrValue'
-    //'pStrName' = node name to set (cannot be empty)
-    //'fValue' = value to set
-    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
+    //Convert JSON data into a binary image that JSON_IMAGE can use without parsing it (for instance, from a memory-mapped file)
+    //INFO: Values refer to each other by offsets from the beginning of the image, so it can be used at any address.
+    //      Strings are kept in the encoding of this OS, and objects that would get an index of names in JSON_DATA get it in the image.
+    //      Plain values are kept as null, boolean, integer or float only if CJSON::toString() would write them back with the same text,
+    //      otherwise their text is kept. The image can be read only on an OS with the same encoding of strings and byte order.
+    //'pOutData' = receives the image (it's replaced)
     //RETURN:
-    //		= [1 and up) number if nodes set, or
-    //		= 0 if no nodes matched the name provided
-    //		= -1 if error setting (some elements might have been copied into destination node)
+    //		= true if success
+    //		= false if error (check CJSON::GetLastError() for info)
+    if(!pJE ||
+        !pOutData ||
+        pJE->val.isEmptyValue())
+    {
+        CJSON::SetLastError(ERROR_INVALID_PARAMETER);
+        return false;
+    }
 
-    //And add it
-    return _setNodeByName_WithType(pStrName, JVT_PLAIN, CJSON::easyFormat(L("%f"), fValue).c_str(), bCaseSensitive);
-}
+    std::vector<BYTE>& buff = *pOutData;
+    buff.assign(sizeof(JSON_IMAGE_HEADER), 0);
+
+    if(!_writeImageValue(pJE->val, offsetof(JSON_IMAGE_HEADER, root), buff))
+    {
+        buff.clear();
+        return false;
+    }
 
+    JSON_IMAGE_HEADER* pHdr = (JSON_IMAGE_HEADER*)buff.data();
+    memcpy(pHdr->sig, JSON_IMAGE_SIGNATURE, sizeof(pHdr->sig));
+    pHdr->nVersion = JSON_IMAGE_VERSION;
+    pHdr->ncbChar = sizeof(WCHAR);
+    pHdr->nByteOrder = JSON_IMAGE_BYTE_ORDER;
+    pHdr->ncbImage = buff.size();
+
+    return true;
+}
 
 
+bool CJSON::writeJSONImageFile(LPCTSTR pStrFilePath, JSON_DATA* pJE)
+{
+    //Convert JSON data into a binary image (see CJSON::writeJSONImage()) and save it into a file, that can be opened with JSON_IMAGE::open()
+    //'pStrFilePath' = file path
+    //RETURN:
+    //		= true if success
+    //		= false if failed (check CJSON::GetLastError() for info)
+    std::vector<BYTE> buff;
+    if(!writeJSONImage(pJE, &buff))
+        return false;
 
+    return writeFileContents(pStrFilePath, buff.data(), buff.size());
+}
 
 
-bool JSON_NODE::_setNodeByIndex_WithType(intptr_t nIndex, JSON_VALUE_TYPE type, LPCTSTR pStrValue)
+bool CJSON::_writeImageValue(const JSON_VALUE& jv, size_t nOffsetRec, std::vector<BYTE>& buff)
 {
-    //Set node at 'nIndex' in this node to a new value
-    //INFO: This node must be an object or an array.
-    //'nIndex' = 0-based index of the node to set
-    //'type' = type to assign to value. Can be JVT_PLAIN or JVT_DOUBLE_QUOTED
-    //'pStrValue' = value
+    //Fill the record of 'jv' in the image, and append everything that it refers to
+    //'nOffsetRec' = offset of JSON_IMAGE_VALUE for 'jv' in 'buff' (it must be zeroed)
+    //'buff' = image being written
     //RETURN:
     //		= true if success
-    bool bRes = false;
-    ASSERT(pJSONData);
+    //		= false if error (check CJSON::GetLastError() for info)
+    JSON_IMAGE_VALUE rec = {};
 
-    if(pJSONData)
+    switch(jv.valType)
     {
-        //Check allowed types
-        if(type == JVT_PLAIN ||
-            type == JVT_DOUBLE_QUOTED)
+    case JVT_PLAIN:
         {
-            ASSERT(pVal);
-            if(pVal->valType == JVT_OBJECT)
+            int64_t iiVal = 0;
+            double fVal = 0;
+
+            JSON_NODE_TYPE type = _getCanonicalPlainValue(jv, &iiVal, &fVal);
+            if(type == JNT_FLOAT)
             {
-                JSON_OBJECT* pJO = (JSON_OBJECT*)pVal->pValue;
-                ASSERT(pJO);
-                if(pJO)
-                {
-                    //Make sure index is within limits
-                    if(nIndex >= 0 &&
-                        nIndex < (intptr_t)pJO->arrObjElmts.size())
-                    {
-                        //Pick element found
-                        JSON_OBJECT_ELEMENT* pJOE = &pJO->arrObjElmts[nIndex];
+                memcpy(&rec.nValue, &fVal, sizeof(rec.nValue));
+            }
+            else if(type != JNT_NONE)
+            {
+                rec.nValue = (uint64_t)iiVal;
+            }
+            else
+            {
+                //Keep its text
+                type = _determinePlainType(&jv);
 
-                        //First clear the old value
-                        CJSON::_freeJSON_VALUE(pJOE->val);
+                rec.nFlags = JSON_IMAGE_VAL_TEXT;
+                rec.nchLen = (uint32_t)jv.getStrLen();
+                if(!_writeImageString(jv.getStrPtr(), jv.getStrLen(), &rec.nValue, buff))
+                    return false;
+            }
 
-                        //And set new simple value
-                        pJOE->val.valType = type;
-                        pJOE->val.strValue = pStrValue ? pStrValue : L("");
-                        pJOE->val.pValue = nullptr;
+            rec.nType = (uint8_t)type;
+        }
+        break;
 
-                        if(type == JVT_PLAIN)
-                        {
-                            //Trim value
-                            CJSON::Trim(pJOE->val.strValue);
-                        }
+    case JVT_DOUBLE_QUOTED:
+        {
+            rec.nType = JNT_STRING;
+            rec.nFlags = JSON_IMAGE_VAL_TEXT;
+            rec.nchLen = (uint32_t)jv.getStrLen();
+            if(!_writeImageString(jv.getStrPtr(), jv.getStrLen(), &rec.nValue, buff))
+                return false;
+        }
+        break;
 
-                        //Done
-                        bRes = true;
-                    }
-                }
-            }
-            else if(pVal->valType == JVT_ARRAY)
-            {
-                JSON_ARRAY* pJA = (JSON_ARRAY*)pVal->pValue;
-                ASSERT(pJA);
-                if(pJA)
-                {
-                    //Make sure index is within limits
-                    if(nIndex >= 0 &&
-                        nIndex < (intptr_t)pJA->arrArrElmts.size())
-                    {
-                        //Pick element found
-                        JSON_ARRAY_ELEMENT* pJAE = &pJA->arrArrElmts[nIndex];
+    case JVT_ARRAY:
+        {
+            JSON_ARRAY* pJA = (JSON_ARRAY*)jv.pValue;
+            ASSERT(pJA);
 
-                        //First clear the old value
-                        CJSON::_freeJSON_VALUE(pJAE->val);
+            size_t nCnt = pJA->arrArrElmts.size();
+            if(nCnt >= JSON_IMAGE_NO_ELEMENT)
+            {
+                CJSON::SetLastError(ERROR_INVALID_DATA);
+                return false;
+            }
 
-                        //And set new simple value
-                        pJAE->val.valType = type;
-                        pJAE->val.strValue = pStrValue ? pStrValue : L("");
-                        pJAE->val.pValue = nullptr;
+            size_t nOffset = _appendImageBlock(sizeof(JSON_IMAGE_ARRAY) + nCnt * sizeof(JSON_IMAGE_VALUE), buff);
+            ((JSON_IMAGE_ARRAY*)(buff.data() + nOffset))->nCnt = (uint32_t)nCnt;
 
-                        if(type == JVT_PLAIN)
-                        {
-                            //Trim value
-                            CJSON::Trim(pJAE->val.strValue);
-                        }
+            rec.nType = JNT_ARRAY;
+            rec.nValue = nOffset;
+            memcpy(buff.data() + nOffsetRec, &rec, sizeof(rec));
 
-                        //Done
-                        bRes = true;
-                    }
-                }
-            }
-            else
+            for(size_t a = 0; a < nCnt; a++)
             {
-                //Can add only to the Array or Object note
-                ASSERT(nullptr);
+                if(!_writeImageValue(pJA->arrArrElmts[a].val, nOffset + sizeof(JSON_IMAGE_ARRAY) + a * sizeof(JSON_IMAGE_VALUE), buff))
+                    return false;
             }
         }
+        return true;
+
+    case JVT_OBJECT:
+        return _writeImageObject((JSON_OBJECT*)jv.pValue, nOffsetRec, buff);
+
+    default:
+        {
+            //Value that wasn't filled
+            ASSERT(nullptr);
+            CJSON::SetLastError(ERROR_INVALID_DATA);
+        }
+        return false;
     }
 
-    return bRes;
+    memcpy(buff.data() + nOffsetRec, &rec, sizeof(rec));
+    return true;
 }
 
 
-bool JSON_NODE::setNodeByIndex_String(intptr_t nIndex, LPCTSTR pStrValue)
+bool CJSON::_writeImageObject(JSON_OBJECT* pJO, size_t nOffsetRec, std::vector<BYTE>& buff)
 {
-    //Set node at 'nIndex' in this node to a new value
-    //INFO: This node must be an object or an array.
-    //'nIndex' = 0-based index of the node to set
-    //'pStrValue' = value to set
+    //Fill the record of the object 'pJO' in the image, and append its block with all of its elements
+    //'nOffsetRec' = offset of JSON_IMAGE_VALUE for 'pJO' in 'buff' (it must be zeroed)
+    //'buff' = image being written
     //RETURN:
     //		= true if success
-    return _setNodeByIndex_WithType(nIndex, JVT_DOUBLE_QUOTED, pStrValue);
-}
+    //		= false if error (check CJSON::GetLastError() for info)
+    ASSERT(pJO);
 
-bool JSON_NODE::setNodeByIndex_BOOL(intptr_t nIndex, bool bValue)
-{
-    //Set node at 'nIndex' in this node to a new value
-    //INFO: This node must be an object or an array.
-    //'nIndex' = 0-based index of the node to set
-    //'bValue' = value to set
-    //RETURN:
-    //		= true if success
+    size_t nCnt = pJO->arrObjElmts.size();
+    if(nCnt >= JSON_IMAGE_NO_ELEMENT)
+    {
+        CJSON::SetLastError(ERROR_INVALID_DATA);
+        return false;
+    }
 
-    return _setNodeByIndex_WithType(nIndex, JVT_PLAIN, bValue ? L("true") : L("false"));
-}
+    const JSON_OBJECT_ELEMENT* pJOEs = pJO->arrObjElmts.data();
 
-bool JSON_NODE::setNodeByIndex_Bool(intptr_t nIndex, bool bValue)
-{
-    //Set node at 'nIndex' in this node to a new value
-    //INFO: This node must be an object or an array.
-    //'nIndex' = 0-based index of the node to set
-    //'bValue' = value to set
-    //RETURN:
-    //		= true if success
+    //Same objects as in JSON_DATA get an index of names
+    size_t nCntBuckets = 0;
+    std::vector<uint32_t> arrHashes;
+    std::vector<uint32_t> arrNotFolded;
+
+    if(nCnt >= JSON_NAME_INDEX_MIN_CNT)
+    {
+        nCntBuckets = 1;
+        while(nCntBuckets < nCnt)
+            nCntBuckets <<= 1;
+
+        //Hashes for case-sensitive search, then for case-insensitive search
+        arrHashes.resize(nCnt * 2);
+        for(size_t o = 0; o < nCnt; o++)
+        {
+            _getImageNameHash(pJOEs[o].getNamePtr(), pJOEs[o].getNameLen(), false, &arrHashes[o]);
+            if(!_getImageNameHash(pJOEs[o].getNamePtr(), pJOEs[o].getNameLen(), true, &arrHashes[nCnt + o]))
+            {
+                arrNotFolded.push_back((uint32_t)o);
+                arrHashes[nCnt + o] = 0;
+            }
+        }
+    }
+
+    size_t ncbElmts = sizeof(JSON_IMAGE_OBJECT) + nCnt * sizeof(JSON_IMAGE_ELEMENT);
+    size_t nCntIdx = nCntBuckets ? nCntBuckets * 2 + nCnt * 2 + arrNotFolded.size() : 0;
+
+    size_t nOffset = _appendImageBlock(ncbElmts + nCntIdx * sizeof(uint32_t), buff);
+
+    JSON_IMAGE_OBJECT* pIO = (JSON_IMAGE_OBJECT*)(buff.data() + nOffset);
+    pIO->nCnt = (uint32_t)nCnt;
+    pIO->nCntBuckets = (uint32_t)nCntBuckets;
+    pIO->nCntNotFolded = (uint32_t)arrNotFolded.size();
+
+    if(nCntBuckets)
+    {
+        uint32_t* pHeads = (uint32_t*)(buff.data() + nOffset + ncbElmts);
+        uint32_t* pNext = pHeads + nCntBuckets * 2;
+        size_t nMask = nCntBuckets - 1;
+
+        memset(pHeads, 0xFF, nCntBuckets * 2 * sizeof(uint32_t));
+
+        //Chain elements in each bucket in ascending order
+        for(size_t o = nCnt; o-- > 0; )
+        {
+            size_t nBucket = arrHashes[o] & nMask;
+            pNext[o] = pHeads[nBucket];
+            pHeads[nBucket] = (uint32_t)o;
+
+            if(std::binary_search(arrNotFolded.begin(), arrNotFolded.end(), (uint32_t)o))
+            {
+                pNext[nCnt + o] = JSON_IMAGE_NO_ELEMENT;
+            }
+            else
+            {
+                nBucket = arrHashes[nCnt + o] & nMask;
+                pNext[nCnt + o] = pHeads[nCntBuckets + nBucket];
+                pHeads[nCntBuckets + nBucket] = (uint32_t)o;
+            }
+        }
+
+        if(!arrNotFolded.empty())
+            memcpy(pNext + nCnt * 2, arrNotFolded.data(), arrNotFolded.size() * sizeof(uint32_t));
+    }
+
+    JSON_IMAGE_VALUE rec = {};
+    rec.nType = JNT_OBJECT;
+    rec.nValue = nOffset;
+    memcpy(buff.data() + nOffsetRec, &rec, sizeof(rec));
+
+    for(size_t o = 0; o < nCnt; o++)
+    {
+        uint64_t nOffsetName = 0;
+        if(!_writeImageString(pJOEs[o].getNamePtr(), pJOEs[o].getNameLen(), &nOffsetName, buff))
+            return false;
 
-    return _setNodeByIndex_WithType(nIndex, JVT_PLAIN, bValue ? L("true") : L("false"));
-}
+        //INFO: 'buff' may have been reallocated
+        size_t nOffsetElmt = nOffset + sizeof(JSON_IMAGE_OBJECT) + o * sizeof(JSON_IMAGE_ELEMENT);
+        JSON_IMAGE_ELEMENT* pIE = (JSON_IMAGE_ELEMENT*)(buff.data() + nOffsetElmt);
 
-bool JSON_NODE::setNodeByIndex_Null(intptr_t nIndex)
-{
-    //Set node at 'nIndex' in this node to a new value
-    //INFO: This node must be an object or an array.
-    //'nIndex' = 0-based index of the node to set
-    //RETURN:
-    //		= true if success
+        pIE->nOffsetName = nOffsetName;
+        pIE->nchName = (uint32_t)pJOEs[o].getNameLen();
+        pIE->nHashCI = nCntBuckets ? arrHashes[nCnt + o] : 0;
 
-    return _setNodeByIndex_WithType(nIndex, JVT_PLAIN, L("null"));
+        if(!_writeImageValue(pJOEs[o].val, nOffsetElmt + offsetof(JSON_IMAGE_ELEMENT, val), buff))
+            return false;
+    }
+
+    return true;
 }
 
-bool JSON_NODE::setNodeByIndex_Int(intptr_t nIndex, LPCTSTR pStrValue)
+
+bool CJSON::_writeImageString(const WCHAR* pStr, intptr_t nchLen, uint64_t* pnOutOffset, std::vector<BYTE>& buff)
 {
-    //Set node at 'nIndex' in this node to a new value
-    //INFO: This node must be an object or an array.
-    //'nIndex' = 0-based index of the node to set
-    //'pStrValue' = value to set -- must be an integer
+    //Append 'pStr' of 'nchLen' TCHARs to the image, with the terminating null
+    //'pnOutOffset' = receives its offset in 'buff'
+    //'buff' = image being written
     //RETURN:
     //		= true if success
-
-    //Check if number
-    if(!CJSON::isIntegerBase10String(pStrValue))
+    //		= false if error (check CJSON::GetLastError() for info)
+    if(nchLen < 0 ||
+        (uint64_t)nchLen >= JSON_IMAGE_NO_ELEMENT)
+    {
+        CJSON::SetLastError(ERROR_INVALID_DATA);
         return false;
+    }
 
-    //And add it
-    return _setNodeByIndex_WithType(nIndex, JVT_PLAIN, pStrValue);
+    size_t nOffset = _appendImageBlock((nchLen + 1) * sizeof(WCHAR), buff);
+    if(nchLen > 0)
+        memcpy(buff.data() + nOffset, pStr, nchLen * sizeof(WCHAR));
+
+    *pnOutOffset = nOffset;
+    return true;
 }
 
-bool JSON_NODE::setNodeByIndex_Int(intptr_t nIndex, int nValue)
+
+size_t CJSON::_appendImageBlock(size_t ncbSz, std::vector<BYTE>& buff)
 {
-    //Set node at 'nIndex' in this node to a new value
-    //INFO: This node must be an object or an array.
-    //'nIndex' = 0-based index of the node to set
-    //'nValue' = value to set
-    //RETURN:
-    //		= true if success
+    //Append a zeroed block of 'ncbSz' BYTEs to the image, aligned to 8 BYTEs
+    //'buff' = image being written
+    //RETURN: = Offset of the block in 'buff'
+    size_t nOffset = (buff.size() + 7) & ~(size_t)7;
+    buff.resize(nOffset + ncbSz);
 
-    //And add it
-    return _setNodeByIndex_WithType(nIndex, JVT_PLAIN, CJSON::easyFormat(L("%d"), nValue).c_str());
+    return nOffset;
 }
 
-bool JSON_NODE::setNodeByIndex_Int64(intptr_t nIndex, LPCTSTR pStrValue)
-{
-    //Set node at 'nIndex' in this node to a new value
-    //INFO: This node must be an object or an array.
-    //'nIndex' = 0-based index of the node to set
-    //'pStrValue' = value to set -- must be an integer
-    //RETURN:
-    //		= true if success
-    return setNodeByIndex_Int(nIndex, pStrValue);
-}
 
-bool JSON_NODE::setNodeByIndex_Int64(intptr_t nIndex, int64_t iiValue)
+JSON_IMAGE::JSON_IMAGE()
 {
-    //Set node at 'nIndex' in this node to a new value
-    //INFO: This node must be an object or an array.
-    //'nIndex' = 0-based index of the node to set
-    //'iiValue' = value to set
-    //RETURN:
-    //		= true if success
-
-    //And add it
-    return _setNodeByIndex_WithType(nIndex, JVT_PLAIN, CJSON::easyFormat(L("%lld"), iiValue).c_str());
+    pData = nullptr;
+    ncbDataSz = 0;
 }
 
 
-bool JSON_NODE::setNodeByIndex_Double(intptr_t nIndex, LPCTSTR pStrValue)
+bool JSON_IMAGE::open(LPCTSTR pStrFilePath)
 {
-    //Set node at 'nIndex' in this node to a new value
-    //INFO: This node must be an object or an array.
-    //'nIndex' = 0-based index of the node to set
-    //'pStrValue' = value to set -- must be a floating point number
+    //Open an image from a file saved by CJSON::writeJSONImageFile()
+    //INFO: Closes the previously opened image, if any. The file is mapped into memory and only the pages that are looked up are read.
+    //'pStrFilePath' = file path
     //RETURN:
     //		= true if success
+    //		= false if failed (check CJSON::GetLastError() for info -- it's ERROR_BAD_FORMAT if it's not an image that can be read on this OS)
+    close();
 
-    //Check if number
-    if(!CJSON::isFloatingPointNumberString(pStrValue))
+    if(!fileMap.open(pStrFilePath, 0, false))
         return false;
 
-    //And add it
-    return _setNodeByIndex_WithType(nIndex, JVT_PLAIN, pStrValue);
-}
+    if(!_setData(fileMap.getData(), fileMap.getSize()))
+    {
+        int nOSError = CJSON::GetLastError();
+        fileMap.close();
 
-bool JSON_NODE::setNodeByIndex_Double(intptr_t nIndex, double fValue)
-{
-    //Set node at 'nIndex' in this node to a new value
-    //INFO: This node must be an object or an array.
-    //'nIndex' = 0-based index of the node to set
-    //'fValue' = value to set
-    //RETURN:
-    //		= true if success
+        CJSON::SetLastError(nOSError);
+        return false;
+    }
 
-    //And add it
-    return _setNodeByIndex_WithType(nIndex, JVT_PLAIN, CJSON::easyFormat(L("%f"), fValue).c_str());
+    return true;
 }
 
 
-
-intptr_t JSON_NODE::removeNodeByName(LPCTSTR pStrName, bool bCaseSensitive)
+bool JSON_IMAGE::openData(const BYTE* pImageData, size_t ncbImageSz)
 {
-    //Remove nodes from this node that match the name
-    //'pStrName' = node name to remove (cannot be empty)
-    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
+    //Open an image in memory, made by CJSON::writeJSONImage()
+    //INFO: Closes the previously opened image, if any. 'pImageData' is not copied, so it must stay valid while the image is open.
+    //'pImageData' = image (must be aligned to 8 BYTEs)
+    //'ncbImageSz' = size of 'pImageData' in BYTEs
     //RETURN:
-    //		= [1 and up) number if nodes removed, or
-    //		= 0 if no nodes matched the name provided
-    //		= -1 if error (some elements might have been removed)
-    intptr_t nCntDel = -1;
-
-    ASSERT(pJSONData);
+    //		= true if success
+    //		= false if failed (check CJSON::GetLastError() for info -- it's ERROR_BAD_FORMAT if it's not an image that can be read on this OS)
+    close();
 
-    //Node must be specified and it must have a name
-    if(pStrName &&
-        pStrName[0] &&
-        pJSONData)
+    if(!pImageData ||
+        ((uintptr_t)pImageData & 7) != 0)
     {
-        ASSERT(pVal);
-        if(pVal->valType == JVT_OBJECT)
-        {
-            JSON_OBJECT* pJO = (JSON_OBJECT*)pVal->pValue;
-            ASSERT(pJO);
-            if(pJO)
-            {
-                //Assume success
-                nCntDel = 0;
+        CJSON::SetLastError(ERROR_INVALID_PARAMETER);
+        return false;
+    }
 
-                //Start looking for needed nodes
-                for(;;)
-                {
-                    //Find next node by name
-                    JSON_SRCH jSrch;		//Place it here, because we're removing elements from array, so need to start from index 0!
-                    JSON_NODE_TYPE resFN = findNodeByName(pStrName, nullptr, bCaseSensitive, &jSrch);
-                    if(resFN > JNT_NONE)
-                    {
-                        intptr_t nFndInd = jSrch.getIndexFoundAt();
-                        if(nFndInd >= 0 &&
-                            nFndInd < (intptr_t)pJO->arrObjElmts.size())
-                        {
-                            //Pick element found
-                            JSON_OBJECT_ELEMENT* pJOE = &pJO->arrObjElmts[nFndInd];
+    return _setData(pImageData, ncbImageSz);
+}
 
-                            //First clear the old value
-                            CJSON::_freeJSON_VALUE(pJOE->val);
 
-                            //Then remove the element itself
-                            pJO->arrObjElmts.erase(pJO->arrObjElmts.begin() + nFndInd);
+void JSON_IMAGE::close()
+{
+    //Close the image, if it was open
+    //INFO: Nodes of the image can't be used after that
+    fileMap.close();
 
-                            //Count the ones deleted
-                            if(nCntDel >= 0)
-                                nCntDel++;
+    pData = nullptr;
+    ncbDataSz = 0;
+}
 
-                        }
-                        else
-                        {
-                            //Error
-                            ASSERT(nullptr);
-                            nCntDel = -1;
-                            break;
-                        }
-                    }
-                    else
-                    {
-                        if(resFN == JNT_ERROR)
-                        {
-                            //Error
-                            ASSERT(nullptr);
-                            nCntDel = -1;
-                        }
 
-                        break;
-                    }
-                }
+bool JSON_IMAGE::getRootNode(JSON_IMAGE_NODE* pOutJNode)
+{
+    //'pOutJNode' = if not nullptr, set it to be the root node of the image
+    //RETURN:
+    //		= true if success
+    if(!pData)
+        return false;
 
-            }
-        }
-        else
-            ASSERT(nullptr);		//Can be only an object node
+    if(pOutJNode)
+    {
+        pOutJNode->pImage = this;
+        pOutJNode->pRec = &((const JSON_IMAGE_HEADER*)pData)->root;
+        pOutJNode->pName = nullptr;
+        pOutJNode->nchName = 0;
     }
 
-    return nCntDel;
+    return true;
 }
 
 
-bool JSON_NODE::removeNodeByIndex(intptr_t nIndex)
+bool JSON_IMAGE::_setData(const BYTE* pImageData, uint64_t ncbImageSz)
 {
-    //Remove node from this node by the 'nIndex'
-    //'nIndex' = node's 0-based index to remove
+    //Use 'pImageData' of 'ncbImageSz' BYTEs as the image, if its header is valid
+    //INFO: The rest of it is checked when it's used
     //RETURN:
-    //		= true if removed OK
-    bool bRes = false;
-    ASSERT(pJSONData);
-
-    //Node must be specified and valid
-    if(pJSONData)
+    //		= true if success
+    //		= false if failed (check CJSON::GetLastError() for info)
+    const JSON_IMAGE_HEADER* pHdr = (const JSON_IMAGE_HEADER*)pImageData;
+
+    if(!pImageData ||
+        ncbImageSz < sizeof(JSON_IMAGE_HEADER) ||
+        memcmp(pHdr->sig, JSON_IMAGE_SIGNATURE, sizeof(pHdr->sig)) != 0 ||
+        pHdr->nVersion != JSON_IMAGE_VERSION ||
+        pHdr->ncbChar != sizeof(WCHAR) ||
+        pHdr->nByteOrder != JSON_IMAGE_BYTE_ORDER ||
+        pHdr->ncbImage != ncbImageSz)
     {
-        ASSERT(pVal);
-        if(pVal->valType == JVT_OBJECT)
-        {
-            JSON_OBJECT* pJO = (JSON_OBJECT*)pVal->pValue;
-            ASSERT(pJO);
-            if(pJO)
-            {
-                //Make sure index is within limits
-                if(nIndex >= 0 &&
-                    nIndex < (intptr_t)pJO->arrObjElmts.size())
-                {
-                    //Pick element found
-                    JSON_OBJECT_ELEMENT* pJOE = &pJO->arrObjElmts[nIndex];
-
-                    //First clear the old value
-                    CJSON::_freeJSON_VALUE(pJOE->val);
-
-                    //Then remove the element itself
-                    pJO->arrObjElmts.erase(pJO->arrObjElmts.begin() + nIndex);
+        CJSON::SetLastError(ERROR_BAD_FORMAT);
+        return false;
+    }
 
-                    //Done
-                    bRes = true;
-                }
-            }
-        }
-        else if(pVal->valType == JVT_ARRAY)
-        {
-            JSON_ARRAY* pJA = (JSON_ARRAY*)pVal->pValue;
-            ASSERT(pJA);
-            if(pJA)
-            {
-                //Make sure index is within limits
-                if(nIndex >= 0 &&
-                    nIndex < (intptr_t)pJA->arrArrElmts.size())
-                {
-                    //Pick element found
-                    JSON_ARRAY_ELEMENT* pJAE = &pJA->arrArrElmts[nIndex];
+    pData = pImageData;
+    ncbDataSz = ncbImageSz;
 
-                    //First clear the old value
-                    CJSON::_freeJSON_VALUE(pJAE->val);
+    return true;
+}
 
-                    //Then remove the element itself
-                    pJA->arrArrElmts.erase(pJA->arrArrElmts.begin() + nIndex);
 
-                    //Done
-                    bRes = true;
-                }
-            }
-        }
-        else
-        {
-            //Can be only an Object or Array node
-            ASSERT(nullptr);
-        }
+const BYTE* JSON_IMAGE::_getBlock(uint64_t nOffset, uint64_t ncbSz, size_t nAlign)
+{
+    //RETURN: = Pointer to 'ncbSz' BYTEs at 'nOffset' in the image, or nullptr if they are not all in it or 'nOffset' isn't aligned to 'nAlign' BYTEs
+    if(nOffset % nAlign != 0 ||
+        nOffset > ncbDataSz ||
+        ncbSz > ncbDataSz - nOffset)
+    {
+        return nullptr;
     }
 
-    return bRes;
+    return pData + nOffset;
 }
 
 
-#ifdef __APPLE__
-//macOS specific
-
-int JSON_NODE::_compareStringsEqualNoCase_macOS(const char* pStr1,
-                                                intptr_t ncbStrLen1,
-                                                const char* pStr2,
-                                                intptr_t ncbStrLen2)
+const WCHAR* JSON_IMAGE::_getString(uint64_t nOffset, uint32_t nchLen)
 {
-    //Compare two strings in case-insensitive way
-    //INFO: This function takes into account non-English alphabets during comparison.
-    //'pStr1' = string 1 pointer (may be 0)
-    //'ncbStrLen1' = number of bytes in 'pStr1' to compare, or negative to calculate automatically
-    //'pStr2' = string 2 pointer (may be 0)
-    //'ncbStrLen2' = number of bytes in 'pStr2' to compare, or negative to calculate automatically
-    //RETURN:
-    //      = 1 if equal
-    //      = 0 if not equal
-    //      = -1 if error
-    int nResult = -1;
-    
-    if(ncbStrLen1 < 0)
+    //RETURN: = Null-terminated string of 'nchLen' TCHARs at 'nOffset' in the image, or nullptr if it's not valid
+    const WCHAR* pStr = (const WCHAR*)_getBlock(nOffset, ((uint64_t)nchLen + 1) * sizeof(WCHAR), sizeof(WCHAR));
+    if(pStr &&
+        pStr[nchLen] != 0)
     {
-        ncbStrLen1 = pStr1 ? strlen(pStr1) : 0;
+        return nullptr;
     }
 
-    if(ncbStrLen2 < 0)
-    {
-        ncbStrLen2 = pStr2 ? strlen(pStr2) : 0;
-    }
-    
-    CFStringRef refStr1 = CFStringCreateWithBytesNoCopy(kCFAllocatorDefault,
-                                                        (const UInt8 *)(pStr1 ? pStr1 : ""),
-                                                        ncbStrLen1,
-                                                        kCFStringEncodingUTF8,
-                                                        false,
-                                                        kCFAllocatorNull);
-    if(refStr1)
-    {
-        CFStringRef refStr2 = CFStringCreateWithBytesNoCopy(kCFAllocatorDefault,
-                                                            (const UInt8 *)(pStr2 ? pStr2 : ""),
-                                                            ncbStrLen2,
-                                                            kCFStringEncodingUTF8,
-                                                            false,
-                                                            kCFAllocatorNull);
-        if(refStr2)
-        {
-            CFComparisonResult res = CFStringCompare(refStr1,
-                                                     refStr2,
-                                                     kCFCompareCaseInsensitive);
-            
-            nResult = res == kCFCompareEqualTo ? 1 : 0;
-            
-            CFRelease(refStr2);
-            refStr2 = nullptr;
-        }
-        else
-            ASSERT(false);
-     
-        CFRelease(refStr1);
-        refStr1 = nullptr;
-    }
-    else
-        ASSERT(false);
-    
-    return nResult;
+    return pStr;
 }
 
-#endif
-
-
-bool JSON_NODE::compareStringsEqual(LPCTSTR pStr1, LPCTSTR pStr2, bool bCaseSensitive)
-{
-    //RETURN:
-    //		= true if strings are equal
-
-    if(pStr1 &&
-        pStr2)
-    {
-#ifdef _WIN32
-        //Windows specific
-        return CompareStringEx(LOCALE_NAME_SYSTEM_DEFAULT, 
-                               bCaseSensitive ? 0 : NORM_IGNORECASE,
-                               pStr1, -1,
-                               pStr2, -1,
-                               nullptr, nullptr, NULL) == CSTR_EQUAL;
-        
-#elif __APPLE__
-        //macOS specific
-        bool bRes = false;
-        
-        if(bCaseSensitive)
-        {
-            //Use binary comparison
-            intptr_t nchLnStr1 = strlen(pStr1);
-            intptr_t nchLnStr2 = strlen(pStr2);
 
-            if(nchLnStr1 == nchLnStr2)
-            {
-                if(memcmp(pStr1, pStr2, nchLnStr1) == 0)
-                {
-                    bRes = true;
-                }
-            }
-        }
-        else
-        {
-            //Case-insensitive comparison
-            //INFO: We'll use the OS to provide locale-specific comparison.
-            bRes = _compareStringsEqualNoCase_macOS(pStr1, -1, pStr2, -1) == 1;
-        }
-        
-        return bRes;
-        
-#endif
+const JSON_IMAGE_ARRAY* JSON_IMAGE::_getArray(const JSON_IMAGE_VALUE* pRec)
+{
+    //RETURN: = Block of the array in 'pRec', or nullptr if it's not an array, or if it's not valid
+    if(pRec->nType != JNT_ARRAY ||
+        pRec->nFlags != 0)
+    {
+        return nullptr;
     }
-    else if(!pStr1 && !pStr2)
+
+    const JSON_IMAGE_ARRAY* pIA = (const JSON_IMAGE_ARRAY*)_getBlock(pRec->nValue, sizeof(JSON_IMAGE_ARRAY), 8);
+    if(!pIA ||
+        !_getBlock(pRec->nValue, sizeof(JSON_IMAGE_ARRAY) + (uint64_t)pIA->nCnt * sizeof(JSON_IMAGE_VALUE), 8))
     {
-        return true;
+        return nullptr;
     }
 
-    return false;
+    return pIA;
 }
 
-bool JSON_NODE::compareStringsEqual(LPCTSTR pStr1, intptr_t nchLn1, LPCTSTR pStr2, intptr_t nchLn2, bool bCaseSensitive)
+
+const JSON_IMAGE_OBJECT* JSON_IMAGE::_getObject(const JSON_IMAGE_VALUE* pRec)
 {
-    //'nchLn1' = length of 'pStr1' in WCHARs, or -1 to calculate automatically
-    //'nchLn2' = length of 'pStr2' in WCHARs, or -1 to calculate automatically
-    //RETURN:
-    //		= true if strings are equal
+    //RETURN: = Block of the object in 'pRec' (with its index of names), or nullptr if it's not an object, or if it's not valid
+    if(pRec->nType != JNT_OBJECT ||
+        pRec->nFlags != 0)
+    {
+        return nullptr;
+    }
 
-    if(pStr1 &&
-        pStr2)
+    const JSON_IMAGE_OBJECT* pIO = (const JSON_IMAGE_OBJECT*)_getBlock(pRec->nValue, sizeof(JSON_IMAGE_OBJECT), 8);
+    if(!pIO ||
+        pIO->nCnt == JSON_IMAGE_NO_ELEMENT ||
+        (pIO->nCntBuckets & (pIO->nCntBuckets - 1)) != 0 ||
+        pIO->nCntNotFolded > pIO->nCnt)
     {
-#ifdef _WIN32
-        //Windows specific
-        
-        //INFO: Values must be either negative, or less than or equal to 0x7FFFFFFF
-        if(nchLn1 <= 0x7FFFFFFF &&
-           nchLn2 <= 0x7FFFFFFF)
-        {
-            return CompareStringEx(LOCALE_NAME_SYSTEM_DEFAULT,
-                                   bCaseSensitive ? 0 : NORM_IGNORECASE,
-                                   pStr1, nchLn1 >= 0 ? (int)nchLn1 : -1,
-                                   pStr2, nchLn2 >= 0 ? (int)nchLn2 : -1,
-                                   nullptr, nullptr, NULL) == CSTR_EQUAL;
-        }
-        else
-        {
-            //Strings are too long!
-            ASSERT(false);
-        }
-        
-#elif __APPLE__
-        //macOS specific
-        if(nchLn1 < 0)
-        {
-            nchLn1 = strlen(pStr1);
-        }
+        return nullptr;
+    }
 
-        if(nchLn2 < 0)
+    uint64_t ncbSz = sizeof(JSON_IMAGE_OBJECT) + (uint64_t)pIO->nCnt * sizeof(JSON_IMAGE_ELEMENT);
+    if(pIO->nCntBuckets)
+        ncbSz += ((uint64_t)pIO->nCntBuckets * 2 + (uint64_t)pIO->nCnt * 2 + pIO->nCntNotFolded) * sizeof(uint32_t);
+
+    if(!_getBlock(pRec->nValue, ncbSz, 8))
+        return nullptr;
+
+    return pIO;
+}
+
+
+intptr_t JSON_IMAGE::_findInIndex(const JSON_IMAGE_OBJECT* pIO, LPCTSTR pStrName, intptr_t nchName, bool bCaseSensitive, intptr_t nFrom)
+{
+    //Look for the first element in 'pIO' with the name 'pStrName', starting from 'nFrom', using its index of names
+    //INFO: Same as JSON_NODE::_findInNameIndex()
+    //'nchName' = length of 'pStrName' in TCHARs
+    //RETURN:
+    //		= [0 and up) Index of the element found, or
+    //		= -1 if none, or
+    //		= -2 if 'pStrName' can't be looked up in the index
+    ASSERT(pIO->nCntBuckets);
+    const JSON_IMAGE_ELEMENT* pIEs = (const JSON_IMAGE_ELEMENT*)(pIO + 1);
+    uint32_t nCnt = pIO->nCnt;
+    uint32_t nMask = pIO->nCntBuckets - 1;
+
+    const uint32_t* pHeadsCS = (const uint32_t*)(pIEs + nCnt);
+    const uint32_t* pHeadsCI = pHeadsCS + pIO->nCntBuckets;
+    const uint32_t* pNextCS = pHeadsCI + pIO->nCntBuckets;
+    const uint32_t* pNextCI = pNextCS + nCnt;
+    const uint32_t* pNotFolded = pNextCI + nCnt;
+
+    uint32_t uiHash;
+    if(!_getImageNameHash(pStrName, nchName, !bCaseSensitive, &uiHash))
+        return -2;
+
+    const uint32_t* pHeads = bCaseSensitive ? pHeadsCS : pHeadsCI;
+    const uint32_t* pNext = bCaseSensitive ? pNextCS : pNextCI;
+
+    intptr_t nFndInd = -1;
+    intptr_t nPrev = -1;
+
+    for(uint32_t i = pHeads[uiHash & nMask]; i != JSON_IMAGE_NO_ELEMENT; i = pNext[i])
+    {
+        //Chains are in ascending order (which also makes sure that they end)
+        if((intptr_t)i <= nPrev ||
+            i >= nCnt)
         {
-            nchLn2 = strlen(pStr2);
+            return -1;
         }
-        
+
+        nPrev = i;
+
+        if((intptr_t)i < nFrom)
+            continue;
+
         if(bCaseSensitive)
         {
-            if(nchLn1 == nchLn2 &&
-               memcmp(pStr1, pStr2, nchLn1) == 0)
+            if(pIEs[i].nchName == nchName)
             {
-                return true;
+                const WCHAR* pName = _getString(pIEs[i].nOffsetName, pIEs[i].nchName);
+                if(pName &&
+                    memcmp(pName, pStrName, nchName * sizeof(WCHAR)) == 0)
+                {
+                    return i;
+                }
             }
         }
-        else
+        else if(pIEs[i].nHashCI == uiHash)
         {
-            //use CFStringCreateWithBytesNoCopy
-            return _compareStringsEqualNoCase_macOS(pStr1, nchLn1, pStr2, nchLn2) == 1;
+            const WCHAR* pName = _getString(pIEs[i].nOffsetName, pIEs[i].nchName);
+            if(pName &&
+                JSON_NODE::compareStringsEqual(pName, pIEs[i].nchName, pStrName, nchName, false))
+            {
+                nFndInd = i;
+                break;
+            }
         }
-#endif
     }
-    else if(!pStr1 && !pStr2)
+
+    if(!bCaseSensitive)
     {
-        return true;
+        //Names that couldn't be case-folded may still match, so check those before it
+        for(uint32_t n = 0; n < pIO->nCntNotFolded; n++)
+        {
+            uint32_t i = pNotFolded[n];
+            if(i >= nCnt ||
+                (nFndInd >= 0 && (intptr_t)i > nFndInd))
+            {
+                break;
+            }
+
+            if((intptr_t)i < nFrom)
+                continue;
+
+            const WCHAR* pName = _getString(pIEs[i].nOffsetName, pIEs[i].nchName);
+            if(pName &&
+                JSON_NODE::compareStringsEqual(pName, pIEs[i].nchName, pStrName, nchName, false))
+            {
+                nFndInd = i;
+                break;
+            }
+        }
     }
 
-    return false;
+    return nFndInd;
 }
 
-bool JSON_NODE::compareStringsEqual(std_wstring& str1, std_wstring& str2, bool bCaseSensitive)
+
+static JSON_NODE_TYPE _getImageValueType(const JSON_IMAGE_VALUE* pRec)
 {
-    //RETURN:
-    //		= true if strings are equal
-    return compareStringsEqual(str1.c_str(), str1.size(), str2.c_str(), str2.size(), bCaseSensitive);
+    //RETURN: = Node type of the value in 'pRec', or JNT_ERROR if it's not valid
+    switch(pRec->nType)
+    {
+    case JNT_NULL:
+    case JNT_BOOLEAN:
+    case JNT_INTEGER:
+    case JNT_FLOAT:
+        if(pRec->nFlags == 0 ||
+            pRec->nFlags == JSON_IMAGE_VAL_TEXT)
+        {
+            return (JSON_NODE_TYPE)pRec->nType;
+        }
+        break;
+
+    case JNT_STRING:
+        if(pRec->nFlags == JSON_IMAGE_VAL_TEXT)
+            return JNT_STRING;
+        break;
+
+    case JNT_ARRAY:
+    case JNT_OBJECT:
+        if(pRec->nFlags == 0)
+            return (JSON_NODE_TYPE)pRec->nType;
+        break;
+
+    default:
+        break;
+    }
+
+    return JNT_ERROR;
 }
 
-bool JSON_NODE::compareStringsEqual(std_wstring& str1, LPCTSTR pStr2, bool bCaseSensitive)
+
+JSON_NODE_TYPE JSON_IMAGE_NODE::getNodeType()
 {
     //RETURN:
-    //		= true if strings are equal
-    return compareStringsEqual(str1.c_str(), str1.size(), pStr2, -1, bCaseSensitive);
-}
+    //		= Type of this node, or
+    //		= JNT_NONE if this node is not set, or
+    //		= JNT_ERROR if the image is corrupted
+    if(!isNodeSet())
+        return JNT_NONE;
 
+    return _getImageValueType(pRec);
+}
 
-#ifdef __APPLE__
-//macOS specific
 
-bool JSON_NODE::appendUtf8Char(std_wstring& str,
-                                unsigned int z)
+intptr_t JSON_IMAGE_NODE::getNodeCount()
 {
-    //Append 'z' to 'str' as UTF-8 byte sequence
     //RETURN:
-    //      = true if success
-    //      = false if 'z' is out of range for UTF-8 and nothing was appended
-    bool bRes = true;
-    
-    //    0x00000000 - 0x0000007F:
-    //        0xxxxxxx
-    //
-    //    0x00000080 - 0x000007FF:
-    //        110xxxxx 10xxxxxx
-    //
-    //    0x00000800 - 0x0000FFFF:
-    //        1110xxxx 10xxxxxx 10xxxxxx
-    //
-    //    0x00010000 - 0x001FFFFF:
-    //        11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
-
-    if(z != 0)
+    //		= [0 and up) Number of nodes in this node, or
+    //		= -1 if it's not an array or an object node
+    if(isNodeSet())
     {
-        if(z <= 0x7f)
-        {
-            //Just a single char
-            str += (char)z;
-        }
-        else if(z <= 0x7FF)
-        {
-            //110xxxxx 10xxxxxx
-            str += (char)(0xC0 | ((z >> 6) & 0x1F));
-            str += (char)(0x80 | (z & 0x3F));
-        }
-        else if(z <= 0xFFFF)
-        {
-            //1110xxxx 10xxxxxx 10xxxxxx
-            str += (char)(0xE0 | ((z >> 12) & 0xF));
-            str += (char)(0x80 | ((z >> 6) & 0x3F));
-            str += (char)(0x80 | (z & 0x3F));
-        }
-        else if(z <= 0x1FFFFF)
+        if(pRec->nType == JNT_ARRAY)
         {
-            //11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
-            str += (char)(0xF0 | ((z >> 18) & 0x7));
-            str += (char)(0x80 | ((z >> 12) & 0x3F));
-            str += (char)(0x80 | ((z >> 6) & 0x3F));
-            str += (char)(0x80 | (z & 0x3F));
+            const JSON_IMAGE_ARRAY* pIA = pImage->_getArray(pRec);
+            if(pIA)
+                return pIA->nCnt;
         }
-        else
+        else if(pRec->nType == JNT_OBJECT)
         {
-            //Bad utf-8 sequence
-            bRes = false;
+            const JSON_IMAGE_OBJECT* pIO = pImage->_getObject(pRec);
+            if(pIO)
+                return pIO->nCnt;
         }
     }
-    else
-    {
-        //Can't add a null-char
-        bRes = false;
-    }
 
-    return bRes;
+    return -1;
 }
 
 
-intptr_t JSON_NODE::getUtf8Char(const char* pStr,
-                                intptr_t i,
-                                intptr_t nLn,
-                                unsigned int* pOutChar)
+JSON_NODE_TYPE JSON_IMAGE_NODE::findNodeByIndex(intptr_t nIndex, JSON_IMAGE_NODE* pJNodeFound)
 {
-    //Get UTF-8 char, and its length, that starts at index 'i' in 'pStr'
-    //'pStr' = pointer to the beginning of the string - must be valid!
-    //'nLn' = length of 'pStr' in bytes (not including last 0)
-    //'pOutChar' = if not 0, the UTF-8 char itself, or 0 if error
+    //Look for the node in this node with the 'nIndex'
+    //INFO: Same as JSON_NODE::findNodeByIndex()
+    //'nIndex' = node zero-based index (use JSON_IMAGE_NODE::getNodeCount() to get number of nodes)
+    //'pJNodeFound' = if not nullptr, receives the node found
     //RETURN:
-    //      [1 - up) length of UTF-8 char in bytes,
-    //      0 if end-of-file was reached
-    //      -1 if error in UTF-8 encoding
-    
-    //    0x00000000 - 0x0000007F:
-    //        0xxxxxxx
-    //
-    //    0x00000080 - 0x000007FF:
-    //        110xxxxx 10xxxxxx
-    //
-    //    0x00000800 - 0x0000FFFF:
-    //        1110xxxx 10xxxxxx 10xxxxxx
-    //
-    //    0x00010000 - 0x001FFFFF:
-    //        11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
-    
-    intptr_t ncbLen = 0;
-    unsigned int uiChar = 0;
-    
-    if(i < nLn)
+    //		= Node type if found, or
+    //		= JNT_ERROR if error in search parameters (or if the image is corrupted)
+    if(isNodeSet() &&
+        nIndex >= 0)
     {
-        //Assume an error
-        ncbLen = -1;
-        
-        unsigned char c = pStr[i], c1, c2, c3;
-        
-        if(!(c & 0x80))
-        {
-            ncbLen = 1;
-            uiChar = c;
-        }
-        else if((c & 0xE0) == 0xC0)
+        if(pRec->nType == JNT_OBJECT)
         {
-            if(i + 2 <= nLn)
+            const JSON_IMAGE_OBJECT* pIO = pImage->_getObject(pRec);
+            if(pIO &&
+                nIndex < (intptr_t)pIO->nCnt)
             {
-                //c        c1
-                //110xxxxx 10xxxxxx
-                
-                c1 = pStr[i + 1];
-                if((c1 & 0xC0) == 0x80)
-                {
-                    ncbLen = 2;
-                    uiChar = (c1 & 0x3F) | ((unsigned int)(c & 0x1F) << 6);
-                }
+                const JSON_IMAGE_ELEMENT* pIE = (const JSON_IMAGE_ELEMENT*)(pIO + 1) + nIndex;
+
+                const WCHAR* pName = pImage->_getString(pIE->nOffsetName, pIE->nchName);
+                if(pName)
+                    return _setFound(pJNodeFound, &pIE->val, pName, pIE->nchName);
             }
         }
-        else if((c & 0xF0) == 0xE0)
+        else if(pRec->nType == JNT_ARRAY)
         {
-            if(i + 3 <= nLn)
+            const JSON_IMAGE_ARRAY* pIA = pImage->_getArray(pRec);
+            if(pIA &&
+                nIndex < (intptr_t)pIA->nCnt)
             {
-                //c        c1       c2
-                //1110xxxx 10xxxxxx 10xxxxxx
-                
-                c1 = pStr[i + 1];
-                c2 = pStr[i + 2];
-                if((c1 & 0xC0) == 0x80 &&
-                   (c2 & 0xC0) == 0x80)
-                {
-                    ncbLen = 3;
-                    uiChar = (c2 & 0x3F) |
-                             ((unsigned int)(c1 & 0x3F) << 6) |
-                             ((unsigned int)(c & 0xF) << 12);
-                }
+                return _setFound(pJNodeFound, (const JSON_IMAGE_VALUE*)(pIA + 1) + nIndex, nullptr, 0);
             }
         }
-        else if((c & 0xF8) == 0xF0)
+    }
+
+    return JNT_ERROR;
+}
+
+
+JSON_NODE_TYPE JSON_IMAGE_NODE::findNodeByName(LPCTSTR pStrName, JSON_IMAGE_NODE* pJNodeFound, bool bCaseSensitive, JSON_SRCH* pJSrch)
+{
+    //Look for the next node in this node with the name 'pStrName'
+    //INFO: Same as JSON_NODE::findNodeByName()
+    //'pStrName' = node (or element) name to look for (cannot be ""!)
+    //'pJNodeFound' = if not nullptr, receives the node found
+    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
+    //'pJSrch' = if not nullptr, must be used for repeated searches for the same node name (keep calling this method while it succeeds in finding)
+    //RETURN:
+    //		= Node type if found, or
+    //		= JNT_NONE if nothing was found, or
+    //		= JNT_ERROR if error in search parameters (or if the image is corrupted)
+    if(!isNodeSet() ||
+        !pStrName ||
+        !pStrName[0] ||
+        pRec->nType != JNT_OBJECT)
+    {
+        return JNT_ERROR;
+    }
+
+    const JSON_IMAGE_OBJECT* pIO = pImage->_getObject(pRec);
+    if(!pIO)
+        return JNT_ERROR;
+
+    const JSON_IMAGE_ELEMENT* pIEs = (const JSON_IMAGE_ELEMENT*)(pIO + 1);
+    intptr_t nCnt = pIO->nCnt;
+    intptr_t nFrom = pJSrch ? pJSrch->nIndex : 0;
+    intptr_t nLnStrName = STRLEN(pStrName);
+
+    //Use the index of names, if it has one
+    intptr_t nFndInd = -2;
+    if(pIO->nCntBuckets)
+        nFndInd = pImage->_findInIndex(pIO, pStrName, nLnStrName, bCaseSensitive, nFrom);
+
+    if(nFndInd == -2)
+    {
+        //Go through all elements
+        nFndInd = -1;
+
+        for(intptr_t i = nFrom; i < nCnt; i++)
         {
-            if(i + 4 <= nLn)
+            if(bCaseSensitive &&
+                pIEs[i].nchName != nLnStrName)
             {
-                //c        c1       c2       c3
-                //11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
-                
-                c1 = pStr[i + 1];
-                c2 = pStr[i + 2];
-                c3 = pStr[i + 3];
-                if((c1 & 0xC0) == 0x80 &&
-                   (c2 & 0xC0) == 0x80 &&
-                   (c3 & 0xC0) == 0x80)
-                {
-                    ncbLen = 4;
-                    uiChar = (c3 & 0x3F) |
-                             ((unsigned int)(c2 & 0x3F) << 6) |
-                             ((unsigned int)(c1 & 0x3F) << 12) |
-                             ((unsigned int)(c & 0x7) << 18);
-                }
+                continue;
+            }
+
+            const WCHAR* pName = pImage->_getString(pIEs[i].nOffsetName, pIEs[i].nchName);
+            if(pName &&
+                (bCaseSensitive ? memcmp(pName, pStrName, nLnStrName * sizeof(WCHAR)) == 0 :
+                    JSON_NODE::compareStringsEqual(pName, pIEs[i].nchName, pStrName, nLnStrName, false)))
+            {
+                //Matched
+                nFndInd = i;
+                break;
             }
         }
     }
-    
-    if(pOutChar)
-        *pOutChar = uiChar;
-    
-    return ncbLen;
-}
 
-#endif
+    if(nFndInd < 0)
+        return JNT_NONE;
 
+    const JSON_IMAGE_ELEMENT* pIE = &pIEs[nFndInd];
+    const WCHAR* pName = pImage->_getString(pIE->nOffsetName, pIE->nchName);
 
+    JSON_NODE_TYPE resType = _setFound(pJNodeFound, &pIE->val, pName, pIE->nchName);
+    if(resType != JNT_ERROR &&
+        pJSrch)
+    {
+        //Update index for the next search
+        pJSrch->nIndex = nFndInd + 1;
+    }
+
+    return resType;
+}
 
 
-bool CJSON::getStringForUTF8(LPCTSTR pStr, std::string& strOut)
+LPCTSTR JSON_IMAGE_NODE::getValueAsStringPtr(intptr_t* pnchOutLen)
 {
-    //Convert 'pStr' into UTF-8 string
-    //'strOut' = receives encoding string as a sequence of bytes
+    //Get the text of the value of this node right from the image, without copying it
+    //INFO: Numbers that are kept as values in the image have no text (use getValueAsString() for them)
+    //'pnchOutLen' = if not nullptr, receives the length of the text in TCHARs
     //RETURN:
-    //		= true if success
-    //		= false if error (check CJSON::GetLastError() for info)
-    return getStringForEncoding(pStr, JENC_UTF_8, strOut);
+    //		= Null-terminated text of the value, or
+    //		= nullptr if it has no text in the image
+    LPCTSTR pStr = nullptr;
+    intptr_t nchLen = 0;
+
+    if(isNodeSet())
+    {
+        if(pRec->nFlags == JSON_IMAGE_VAL_TEXT)
+        {
+            pStr = pImage->_getString(pRec->nValue, pRec->nchLen);
+            if(pStr)
+                nchLen = pRec->nchLen;
+        }
+        else if(pRec->nFlags == 0)
+        {
+            if(pRec->nType == JNT_NULL)
+            {
+                pStr = L("null");
+                nchLen = 4;
+            }
+            else if(pRec->nType == JNT_BOOLEAN)
+            {
+                pStr = pRec->nValue ? L("true") : L("false");
+                nchLen = pRec->nValue ? 4 : 5;
+            }
+        }
+    }
+
+    if(pnchOutLen)
+        *pnchOutLen = nchLen;
+
+    return pStr;
 }
 
-bool CJSON::getStringForEncoding(LPCTSTR pStr, JSON_ENCODING enc, std::string& strOut
-#ifdef _WIN32
-                                 , bool* pbOutDataLoss
-#endif
-                                 )
+
+bool JSON_IMAGE_NODE::_getNode(JSON_VALUE& val, JSON_NODE& jNode)
 {
-    //Convert 'pStr' into some other encoding
-    //'enc' = encoding to convert into
-    //'strOut' = receives encoding string as a sequence of bytes
-    //'pbOutDataLoss' = if not nullptr, will receive true if data loss occurred during conversion
-    //                  INFO: Works only on Windows!
+    //Set 'jNode' to read the value of this node the same way as JSON_NODE that the image was written from
+    //'val' = receives the value that 'jNode' points to (it refers to the image)
     //RETURN:
     //		= true if success
-    //		= false if error -- check CJSON::GetLastError() for info
-    bool bRes = false;
-    int nOSError = NO_ERROR;
+    //		= false if this node is not set, or if the image is corrupted ('jNode' is not set then)
+    if(!isNodeSet())
+        return false;
 
-#ifdef _WIN32
-    bool bUsedDefault = false;
-#endif
+    JSON_NODE_TYPE type = _getImageValueType(pRec);
+    switch(type)
+    {
+    case JNT_ARRAY:
+        val.valType = JVT_ARRAY;
+        break;
 
-    //Free string
-    strOut.clear();
+    case JNT_OBJECT:
+        val.valType = JVT_OBJECT;
+        break;
 
-    if(pStr &&
-        pStr[0])
-    {
-#ifdef _WIN32
-        //Windows specific
-        UINT nCodePage;
-        
-        switch(enc)
+    case JNT_ERROR:
+        return false;
+
+    default:
+        if(pRec->nFlags == JSON_IMAGE_VAL_TEXT)
         {
-            case JENC_ANSI:
-                nCodePage = CP_ACP;
-                break;
-            case JENC_UTF_8:
-                nCodePage = CP_UTF8;
-                break;
-            case JENC_UNICODE_16:
-                nCodePage = 1200;
-                break;
-            case JENC_UNICODE_16BE:
-                nCodePage = 1201;
-                break;
+            const WCHAR* pStr = pImage->_getString(pRec->nValue, pRec->nchLen);
+            if(!pStr)
+                return false;
 
-            default:
-                nCodePage = -1;
-                break;
+            val.valType = type == JNT_STRING ? JVT_DOUBLE_QUOTED : JVT_PLAIN;
+            val.pStrRef = pStr;
+            val.nchStrRef = pRec->nchLen;
         }
-        
-        if(nCodePage != -1)
+        else
         {
-            int nchLn = (int)wcslen(pStr);
-            
-            if(nCodePage == 1200)
-            {
-                //No conversion necessary
-                strOut.assign((const char*)pStr, nchLn * sizeof(WCHAR));
+            //Same as converted when parsed (see JPF_NATIVE_VALUES)
+            val.valType = JVT_PLAIN;
+            val.nativeType = type;
 
-                bRes = true;
+            if(type == JNT_NULL)
+            {
+                val.pStrRef = L("null");
+                val.nchStrRef = 4;
             }
-            else if(nCodePage == 1201)
+            else if(type == JNT_BOOLEAN)
             {
-                //utf-16 with reversed bytes
-                size_t szcb = nchLn * sizeof(WCHAR);
-                strOut.resize(szcb);
-                
-                char* pD = &strOut[0];
-                const WCHAR* pS = pStr;
-                
-                for(size_t i = 0; i < szcb; pS++)
-                {
-                    WCHAR ch = *pS;
-                    pD[i++] = (char)(ch >> 8);
-                    pD[i++] = (char)(ch);
-                }
-                
-                bRes = true;
+                val.bNative = pRec->nValue != 0;
+                val.pStrRef = val.bNative ? L("true") : L("false");
+                val.nchStrRef = val.bNative ? 4 : 5;
+            }
+            else if(type == JNT_INTEGER)
+            {
+                val.iiNative = (int64_t)pRec->nValue;
             }
             else
             {
-                //Get length needed
-                int ncbLen = ::WideCharToMultiByte(nCodePage, 0, pStr, nchLn, 0, 0, nullptr, nullptr);
-                if(ncbLen > 0)
-                {
-                    //Check if code page accepts default char
-                    bool bUseDefChar = pbOutDataLoss &&
-                        nCodePage != CP_UTF8 &&
-                        nCodePage != CP_UTF7;
-                    
-                    //Reserve mem
-                    strOut.resize(ncbLen);
-                    
-                    BOOL b_UsedDef = FALSE;
-                    
-                    //Convert
-                    const char def[] = "?";
-                    if(::WideCharToMultiByte(nCodePage, 0, pStr, nchLn, &strOut[0], ncbLen,
-                                             bUseDefChar ? def : nullptr, bUseDefChar ? &b_UsedDef : nullptr) == ncbLen)
-                    {
-                        //Success
-                        bRes = true;
-                        
-                        bUsedDefault = !!b_UsedDef;
-                    }
-                    else
-                        nOSError = ::GetLastError();
-                }
-                else
-                    nOSError = ::GetLastError();
+                memcpy(&val.fNative, &pRec->nValue, sizeof(val.fNative));
             }
         }
-        else
-            nOSError = ERROR_INVALID_PARAMETER;
 
-#elif __APPLE__
-        //macOS specific
-        
-        CFStringEncoding encTo;
-        
-        switch(enc)
-        {
-            case JENC_ANSI:
-                encTo = kCFStringEncodingWindowsLatin1;
-                break;
-            case JENC_UTF_8:
-                encTo = kCFStringEncodingUTF8;
-                break;
-            case JENC_UNICODE_16:
-                encTo = kCFStringEncodingUTF16;
-                break;
-            case JENC_UNICODE_16BE:
-                encTo = kCFStringEncodingUTF16BE;
-                break;
+        if(val.valType == JVT_PLAIN)
+            val.plainType = type;
+        break;
+    }
 
-            default:
-                encTo = -1;
-                break;
-        }
+    jNode.typeNode = type;
+    jNode.pVal = &val;
+    jNode.pJSONData = &pImage->jDataEmpty;
+
+    return true;
+}
+
+
+JSON_NODE_TYPE JSON_IMAGE_NODE::_setFound(JSON_IMAGE_NODE* pJNodeFound, const JSON_IMAGE_VALUE* pR, const WCHAR* pN, intptr_t nchN)
+{
+    //Set 'pJNodeFound' (if not nullptr) to the node found in this node
+    //'pR' = record of the value of the node found
+    //'pN' = name of the node found, or nullptr if none
+    //'nchN' = length of 'pN' in TCHARs
+    //RETURN:
+    //		= Type of the node found, or
+    //		= JNT_ERROR if its record is not valid ('pJNodeFound' is not changed then)
+    JSON_NODE_TYPE resType = _getImageValueType(pR);
+    if(resType != JNT_ERROR &&
+        pJNodeFound)
+    {
+        pJNodeFound->pImage = pImage;
+        pJNodeFound->pRec = pR;
+        pJNodeFound->pName = pN;
+        pJNodeFound->nchName = pN ? nchN : 0;
+    }
+
+    return resType;
+}
+
+
+
+enum JSON_TAPE_TAG
+{
+    //Tag in the top BYTE of each word on JSON_TAPE, with the rest of the word (JSON_TAPE_PAYLOAD_MASK) used as:
+    JTT_NULL =          'n',            //null (1 word)
+    JTT_TRUE =          't',            //true (1 word)
+    JTT_FALSE =         'f',            //false (1 word)
+    JTT_INTEGER =       'l',            //Integer, with int64_t in the next word (2 words)
+    JTT_FLOAT =         'd',            //Floating point number, with bits of the double in the next word (2 words)
+    JTT_STRING =        's',            //"string" or a name in an object: offset of the text in JSON_TAPE::strBuff, with its length in the next word (2 words)
+    JTT_INTEGER_TEXT =  'L',            //Integer that is kept as its text (because it wouldn't be written back the same way), same as JTT_STRING
+    JTT_FLOAT_TEXT =    'D',            //Floating point number that is kept as its text, same as JTT_STRING
+    JTT_START_OBJECT =  '{',            //Start of an object: index of its JTT_END_OBJECT word, with the number of elements in the next word,
+                                        //then the name (as JTT_STRING) and value of each element
+    JTT_END_OBJECT =    '}',            //End of an object: index of its JTT_START_OBJECT word (1 word)
+    JTT_START_ARRAY =   '[',            //Start of an array: index of its JTT_END_ARRAY word, with the number of elements in the next word,
+                                        //then each element
+    JTT_END_ARRAY =     ']',            //End of an array: index of its JTT_START_ARRAY word (1 word)
+};
+
+#define JSON_TAPE_TAG_SHIFT 56                          //Shift of JSON_TAPE_TAG in a word on JSON_TAPE
+#define JSON_TAPE_PAYLOAD_MASK 0x00FFFFFFFFFFFFFFULL    //Rest of the word
+
+
+struct JSON_TAPE_BUILDER : public JSON_SAX_HANDLER
+{
+    //Handler that puts events from CJSON::parseJSONTape() on JSON_TAPE
+    JSON_TAPE* pTape;                   //Tape being filled
+    std::vector<size_t> arrOpen;        //Indexes of the starting words of objects and arrays that are not closed yet
+
+    JSON_TAPE_BUILDER(JSON_TAPE* pUseTape)
+    {
+        pTape = pUseTape;
+    }
+
+    void addWord(JSON_TAPE_TAG tag, uint64_t nPayload = 0)
+    {
+        pTape->arrTape.push_back(((uint64_t)tag << JSON_TAPE_TAG_SHIFT) | nPayload);
+    }
+
+    void addValue()
+    {
+        //Count one more element in the object or array that is open
+        if(!arrOpen.empty())
+            pTape->arrTape[arrOpen.back() + 1]++;
+    }
+
+    void addString(JSON_TAPE_TAG tag, const WCHAR* pStr, intptr_t nchLen)
+    {
+        addWord(tag, pTape->strBuff.size());
+        pTape->arrTape.push_back((uint64_t)nchLen);
+
+        pTape->strBuff.append(pStr, nchLen);
+        pTape->strBuff.push_back(0);
+    }
+
+    JSON_SAX_ACTION startContainer(JSON_TAPE_TAG tag)
+    {
+        addValue();
+        arrOpen.push_back(pTape->arrTape.size());
+
+        addWord(tag);
+        pTape->arrTape.push_back(0);
+
+        return JSAX_CONTINUE;
+    }
+
+    JSON_SAX_ACTION endContainer(JSON_TAPE_TAG tag)
+    {
+        ASSERT(!arrOpen.empty());
+        size_t nStart = arrOpen.back();
+        arrOpen.pop_back();
+
+        //Both ends point to each other
+        pTape->arrTape[nStart] |= pTape->arrTape.size();
+        addWord(tag, nStart);
+
+        return JSAX_CONTINUE;
+    }
+
+    virtual JSON_SAX_ACTION onStartObject() { return startContainer(JTT_START_OBJECT); }
+    virtual JSON_SAX_ACTION onEndObject() { return endContainer(JTT_END_OBJECT); }
+    virtual JSON_SAX_ACTION onStartArray() { return startContainer(JTT_START_ARRAY); }
+    virtual JSON_SAX_ACTION onEndArray() { return endContainer(JTT_END_ARRAY); }
+
+    virtual JSON_SAX_ACTION onName(const WCHAR* pName, intptr_t nchLen)
+    {
+        addString(JTT_STRING, pName, nchLen);
+        return JSAX_CONTINUE;
+    }
+
+    virtual JSON_SAX_ACTION onString(const WCHAR* pStr, intptr_t nchLen)
+    {
+        addValue();
+        addString(JTT_STRING, pStr, nchLen);
+        return JSAX_CONTINUE;
+    }
+
+    virtual JSON_SAX_ACTION onNumber(const WCHAR* pNum, intptr_t nchLen, JSON_NODE_TYPE type)
+    {
+        addValue();
+
+        //Keep the number as a value only if it would be written back the same way
+        JSON_VALUE jv;
+        jv.valType = JVT_PLAIN;
+        jv.pStrRef = pNum;
+        jv.nchStrRef = nchLen;
+
+        int64_t iiVal = 0;
+        double fVal = 0;
 
-        if(encTo != -1)
+        switch(CJSON::_getCanonicalPlainValue(jv, &iiVal, &fVal))
         {
-            CFStringRef refStr = CFStringCreateWithCString(kCFAllocatorDefault,
-                                                           pStr ? pStr : "",
-                                                           kCFStringEncodingUTF8);
-            if(refStr)
+        case JNT_INTEGER:
+            addWord(JTT_INTEGER);
+            pTape->arrTape.push_back((uint64_t)iiVal);
+            break;
+
+        case JNT_FLOAT:
             {
-                const UInt8 chLoss = '?';
-                CFRange range = CFRangeMake(0,  CFStringGetLength(refStr));
-                
-                //Get required length
-                CFIndex ncbSz = 0;
-                CFIndex ncbConv = CFStringGetBytes(refStr,
-                                                   range,
-                                                   encTo,
-                                                   chLoss,
-                                                   false,
-                                                   nullptr,
-                                                   0,
-                                                   &ncbSz);
-                if(ncbConv > 0)
-                {
-                    strOut.resize(ncbSz);
-                    
-                    //And convert
-                    if(CFStringGetBytes(refStr,
-                                        range,
-                                        encTo,
-                                        chLoss,
-                                        false,
-                                        (UInt8*)&strOut[0],
-                                        strOut.size(),
-                                        &ncbSz) == ncbConv)
-                    {
-                        //Done
-                        bRes = true;
-                    }
-                    else
-                        nOSError = ERROR_BAD_FORMAT;
-                }
-                else
-                    nOSError = ERROR_BAD_FORMAT;
-             
-                CFRelease(refStr);
-                refStr = nullptr;
+                uint64_t uiBits;
+                memcpy(&uiBits, &fVal, sizeof(uiBits));
+
+                addWord(JTT_FLOAT);
+                pTape->arrTape.push_back(uiBits);
             }
-            else
-                nOSError = ERROR_OUTOFMEMORY;
+            break;
+
+        default:
+            addString(type == JNT_INTEGER ? JTT_INTEGER_TEXT : JTT_FLOAT_TEXT, pNum, nchLen);
+            break;
         }
-        else
-            nOSError = ERROR_INVALID_PARAMETER;
-#endif
+
+        return JSAX_CONTINUE;
     }
-    else
+
+    virtual JSON_SAX_ACTION onBoolean(bool bValue)
     {
-        //Empty string
-        bRes = true;
+        addValue();
+        addWord(bValue ? JTT_TRUE : JTT_FALSE);
+        return JSAX_CONTINUE;
     }
 
-#ifdef _WIN32
-    if(pbOutDataLoss)
-        *pbOutDataLoss = bUsedDefault;
-#endif
-    
-    CJSON::SetLastError(nOSError);
-    return bRes;
-}
+    virtual JSON_SAX_ACTION onNull()
+    {
+        addValue();
+        addWord(JTT_NULL);
+        return JSAX_CONTINUE;
+    }
+};
 
 
+int CJSON::parseJSONTape(LPCTSTR pStr, intptr_t nchLen, JSON_TAPE& outTape, JSON_ERROR* pJError)
+{
+    //Parse 'pStr' as JSON into one contiguous tape (see JSON_TAPE), instead of building JSON_DATA
+    //INFO: It follows the same rules and gives the same errors as CJSON::parseJSON(). Numbers are kept as values
+    //      if CJSON::toString() would write them back with the same text, otherwise as their text (like JPF_NATIVE_VALUES does.)
+    //'nchLen' = length of 'pStr' in TCHARs, or -1 if it's null-terminated
+    //'outTape' = receives parsed JSON (it's emptied if this method fails)
+    //'pJError' = if not nullptr, will be filled with parsing error details
+    //RETURN:
+    //		= 1 if got it OK
+    //		= 0 if JSON format error
+    //		= -1 if other non-JSON related error (such as out of memory, etc.)
+    //           INFO: Check CJSON::GetLastError() for more info.
+    outTape.emptyTape();
 
-bool CJSON::getUnicodeStringFromEncoding(const char* pAStr, intptr_t ncbLen, JSON_ENCODING enc, std_wstring* pOutUnicodeStr)
+    if(!pStr)
+    {
+        _describeError(pJError, -1, L("Bad input parameter(s)"));
+        CJSON::SetLastError(ERROR_INVALID_PARAMETER);
+        return -1;
+    }
+
+    if(nchLen < 0)
+        nchLen = STRLEN(pStr);
+
+    //INFO: Most JSON takes fewer words on the tape than it has TCHARs, and strings take about the same
+    outTape.arrTape.reserve(nchLen / 8 + 1);
+    outTape.strBuff.reserve(nchLen / 2 + 1);
+
+    JSON_TAPE_BUILDER builder(&outTape);
+    JSON_PARSE_CTX ctx(pJError, nullptr, JPF_REFERENCE_SOURCE, &builder);
+
+    int nRes = _saxParse(pStr, nchLen, &ctx);
+    if(nRes != 1)
+    {
+        int nErr = CJSON::GetLastError();
+        outTape.emptyTape();
+
+        CJSON::SetLastError(nRes == 0 ? ERROR_INVALID_DATA : nErr);
+    }
+
+    return nRes;
+}
+
+
+bool JSON_TAPE::getRootNode(JSON_TAPE_NODE* pOutJNode)
 {
-    //Convert 'pAStr' encoded sequence into the Unicode string
-    //INFO: For Microsoft it is UTF-16, and for Apple it's UTF-8.
-    //'pAStr' = Byte sequence to convert
-    //'ncbLen' = Length of 'pAStr' in bytes, or -1 if it's a null-terminated string
-    //'enc' = Encoding that 'pAStr' was encoded with
+    //'pOutJNode' = if not nullptr, set it to be the root node of the tape
     //RETURN:
-    //		= true if success, and 'pOutUnicodeStr' received the data (must NOT be nullptr!)
-    //		= false if error (use CJSON::GetLastError() for details)
-    bool bRes = false;
-    int nOSError = NO_ERROR;
-    ASSERT(pOutUnicodeStr);
-    
-    pOutUnicodeStr->clear();
+    //		= true if success
+    if(arrTape.empty())
+        return false;
 
-    //Do we have the length
-    if(ncbLen < 0)
+    if(pOutJNode)
     {
-        ncbLen = 0;
-        while(pAStr[ncbLen])
-            ncbLen++;
+        pOutJNode->pTape = this;
+        pOutJNode->nIndex = 0;
+        pOutJNode->pName = nullptr;
+        pOutJNode->nchName = 0;
     }
 
-    if(ncbLen)
+    return true;
+}
+
+
+static size_t _getTapeValueSize(const uint64_t* pTape, size_t nIndex)
+{
+    //RETURN: = Number of words that the value at 'nIndex' takes on the tape (with everything in it)
+    uint64_t nWord = pTape[nIndex];
+    switch(nWord >> JSON_TAPE_TAG_SHIFT)
     {
-#ifdef _WIN32
-        //Windows specific
-        UINT nCodePage;
-        
-        switch(enc)
-        {
-            case JENC_ANSI:
-                nCodePage = CP_ACP;
-                break;
-            case JENC_UTF_8:
-                nCodePage = CP_UTF8;
-                break;
-            case JENC_UNICODE_16:
-                nCodePage = 1200;
-                break;
-            case JENC_UNICODE_16BE:
-                nCodePage = 1201;
-                break;
+    case JTT_START_OBJECT:
+    case JTT_START_ARRAY:
+        return (size_t)(nWord & JSON_TAPE_PAYLOAD_MASK) - nIndex + 1;
 
-            default:
-                nCodePage = -1;
-                break;
-        }
-        
-        if(nCodePage != -1)
-        {
-            if(nCodePage == 1200)
-            {
-                //Use as-is
-                if((ncbLen % sizeof(WCHAR)) == 0)
-                {
-                    pOutUnicodeStr->assign((LPCTSTR)pAStr, ncbLen / sizeof(WCHAR));
+    case JTT_NULL:
+    case JTT_TRUE:
+    case JTT_FALSE:
+        return 1;
 
-                    bRes = true;
-                }
-                else
-                    nOSError = ERROR_INVALID_DATA;
-            }
-            else if(nCodePage == 1201)
-            {
-                //Reverse byte order
-                if((ncbLen % sizeof(WCHAR)) == 0)
-                {
-                    pOutUnicodeStr->resize(ncbLen / sizeof(WCHAR));
-                    
-                    const char* pS = (const char*)pAStr;
-                    WCHAR* pD = &pOutUnicodeStr->at(0);
-                    
-                    for(intptr_t i = 0; i < ncbLen; pD++)
-                    {
-                        WCHAR ch = ((WCHAR)pS[i++] << 8);
-                        ch |= pS[i++];
-                        
-                        *pD = ch;
-                    }
-                    
-                    bRes = true;
-                }
-                else
-                    nOSError = ERROR_INVALID_DATA;
-            }
-            else
-            {
-                //See how much data do we need?
-                int nchLen = ::MultiByteToWideChar(nCodePage, 0, pAStr, (int)ncbLen, nullptr, 0);
-                if(nchLen)
-                {
-                    WCHAR* pWTxt = new(std::nothrow) WCHAR[nchLen];
-                    if(pWTxt)
-                    {
-                        //Convert
-                        if(::MultiByteToWideChar(nCodePage, 0, pAStr, (int)ncbLen, pWTxt, nchLen) == nchLen)
-                        {
-                            //Set text
-                            bRes = true;
-                            
-                            ASSERT(pOutUnicodeStr);
-                            pOutUnicodeStr->assign(pWTxt, nchLen);
-                        }
-                        else
-                            nOSError = ::GetLastError();
-                        
-                        //Free
-                        delete[] pWTxt;
-                        pWTxt = nullptr;
-                    }
-                    else
-                        nOSError = ERROR_OUTOFMEMORY;
-                }
-                else
-                    nOSError = ::GetLastError();
-            }
-        }
-        else
-            nOSError = ERROR_INVALID_PARAMETER;
+    default:
+        break;
+    }
 
-#elif __APPLE__
-        //macOS specific
+    return 2;
+}
 
-        CFStringEncoding encFrom;
-        
-        switch(enc)
-        {
-            case JENC_ANSI:
-                encFrom = kCFStringEncodingWindowsLatin1;
-                break;
-            case JENC_UTF_8:
-                encFrom = kCFStringEncodingUTF8;
-                break;
-            case JENC_UNICODE_16:
-                encFrom = kCFStringEncodingUTF16;
-                break;
-            case JENC_UNICODE_16BE:
-                encFrom = kCFStringEncodingUTF16BE;
-                break;
 
-            default:
-                encFrom = -1;
-                break;
-        }
+JSON_NODE_TYPE JSON_TAPE_NODE::getNodeType()
+{
+    //RETURN:
+    //		= Type of this node, or
+    //		= JNT_NONE if this node is not set
+    if(!isNodeSet())
+        return JNT_NONE;
 
-        if(encFrom != -1)
-        {
-            CFStringRef refStr = CFStringCreateWithBytesNoCopy(kCFAllocatorDefault,
-                                                               (const UInt8*)pAStr,
-                                                               ncbLen,
-                                                               encFrom,
-                                                               false,
-                                                               kCFAllocatorNull);
-            
-            if(refStr)
-            {
-                //And convert it to utf-8
-                const char* pStr = CFStringGetCStringPtr(refStr, kCFStringEncodingUTF8);
-                if(pStr)
-                {
-                    //Simple example
-                    pOutUnicodeStr->assign(pStr);
-                    
-                    bRes = true;
-                }
-                else
-                {
-                    //Need to do more work
-                    CFIndex nchSize = CFStringGetLength(refStr);     //This is the size if characters
-                    if(nchSize > 0)
-                    {
-                        CFIndex ncbSz = CFStringGetMaximumSizeForEncoding(nchSize,
-                                                                          kCFStringEncodingUTF8);
-                        if(ncbSz != kCFNotFound)
-                        {
-                            UInt8* pBuff = new (std::nothrow) UInt8[ncbSz + 1];
-                            if(pBuff)
-                            {
-                                if(CFStringGetCString(refStr,
-                                                      (char*)pBuff,
-                                                      ncbSz + 1,
-                                                      kCFStringEncodingUTF8))
-                                {
-                                    //Note that 'ncbSz' will most certainly include trailing 0's,
-                                    //thus we cannot assume that that is the length of our string!
-                                    
-                                    //Let's place a safety null there first
-                                    pBuff[ncbSz] = 0;
-                                    
-                                    pOutUnicodeStr->assign((const char*)pBuff);
-                                    
-                                    bRes = true;
-                                }
-                                else
-                                    nOSError = ERROR_INVALID_DATA;
-                             
-                                //Free mem
-                                delete[] pBuff;
-                                pBuff = nullptr;
-                            }
-                            else
-                                nOSError = ERROR_OUTOFMEMORY;
-                        }
-                        else
-                            nOSError = ERROR_INVALID_DATA;
-                    }
-                    else
-                        nOSError = ERROR_INVALID_DATA;
-                }
-                
-                //Free
-                CFRelease(refStr);
-                refStr = nullptr;
-            }
-            else
-                nOSError = ERROR_INVALID_DATA;
-        }
-        else
-            nOSError = ERROR_INVALID_PARAMETER;
-        
-#endif
+    switch(pTape->arrTape[nIndex] >> JSON_TAPE_TAG_SHIFT)
+    {
+    case JTT_NULL:
+        return JNT_NULL;
+    case JTT_TRUE:
+    case JTT_FALSE:
+        return JNT_BOOLEAN;
+    case JTT_INTEGER:
+    case JTT_INTEGER_TEXT:
+        return JNT_INTEGER;
+    case JTT_FLOAT:
+    case JTT_FLOAT_TEXT:
+        return JNT_FLOAT;
+    case JTT_STRING:
+        return JNT_STRING;
+    case JTT_START_ARRAY:
+        return JNT_ARRAY;
+    case JTT_START_OBJECT:
+        return JNT_OBJECT;
+    default:
+        break;
     }
-    else
+
+    ASSERT(nullptr);
+    return JNT_ERROR;
+}
+
+
+intptr_t JSON_TAPE_NODE::getNodeCount()
+{
+    //RETURN:
+    //		= [0 and up) Number of nodes in this node, or
+    //		= -1 if it's not an array or an object node
+    if(isNodeSet())
     {
-        //Empty string
-        pOutUnicodeStr->clear();
-        bRes = true;
+        uint64_t nTag = pTape->arrTape[nIndex] >> JSON_TAPE_TAG_SHIFT;
+        if(nTag == JTT_START_OBJECT ||
+            nTag == JTT_START_ARRAY)
+        {
+            return (intptr_t)pTape->arrTape[nIndex + 1];
+        }
     }
 
-    CJSON::SetLastError(nOSError);
-    return bRes;
+    return -1;
 }
 
-bool CJSON::convertStringToUnicode(const char* pAStr, intptr_t ncbLen, JSON_ENCODING enc, std_wstring* pOutUnicodeStr)
+
+JSON_NODE_TYPE JSON_TAPE_NODE::findNodeByIndex(intptr_t nIndexFind, JSON_TAPE_NODE* pJNodeFound)
 {
-    //Convert 'pAStr' encoded sequence into the Unicode string
-    //INFO: For Microsoft it is UTF-16, and for Apple it's UTF-8.
-    //'pAStr' = Byte sequence to convert
-    //'ncbLen' = Length of 'pAStr' in bytes, or -1 if it's a null-terminated string
-    //'enc' = Encoding that 'pAStr' was encoded with
+    //Look for the node in this node with the 'nIndexFind'
+    //INFO: Same as JSON_NODE::findNodeByIndex(), but it goes through all elements before it (use getNextNode() to go through all of them)
+    //'nIndexFind' = node zero-based index (use JSON_TAPE_NODE::getNodeCount() to get number of nodes)
+    //'pJNodeFound' = if not nullptr, receives the node found
     //RETURN:
-    //        = true if success, and 'pOutUnicodeStr' received the data (must NOT be nullptr!)
-    //        = false if error (use CJSON::GetLastError() for details)
-    return CJSON::getUnicodeStringFromEncoding(pAStr, ncbLen, enc, pOutUnicodeStr);
+    //		= Node type if found, or
+    //		= JNT_ERROR if error in search parameters
+    if(nIndexFind < 0 ||
+        nIndexFind >= getNodeCount())
+    {
+        return JNT_ERROR;
+    }
+
+    const uint64_t* pT = pTape->arrTape.data();
+    bool bObject = (pT[nIndex] >> JSON_TAPE_TAG_SHIFT) == JTT_START_OBJECT;
+
+    size_t i = nIndex + 2;
+    for(intptr_t e = 0; ; e++)
+    {
+        //Elements of objects begin with their names
+        size_t iVal = bObject ? i + 2 : i;
+        if(e == nIndexFind)
+            return _setFound(pJNodeFound, iVal, bObject ? i : 0);
+
+        i = iVal + _getTapeValueSize(pT, iVal);
+    }
 }
 
-bool CJSON::readFileContents(LPCTSTR pStrFilePath, BYTE** ppOutData, UINT* pncbOutDataSz, UINT ncbSzMaxFileSz)
+
+JSON_NODE_TYPE JSON_TAPE_NODE::findNodeByName(LPCTSTR pStrName, JSON_TAPE_NODE* pJNodeFound, bool bCaseSensitive, JSON_SRCH* pJSrch)
 {
-    //Read file contents into a BYTE array
-    //'pStrFilePath' = file path
-    //'ppOutData' = if not nullptr, receives pointer to the BYTE array (must be removed with delete[]!)
-    //'pncbOutDataSz' = if not nullptr, receives the size of 'ppOutData' array in BYTEs
-    //'ncbSzMaxFileSz' = if not 0, maximum allowed file size in BYTEs
+    //Look for the next node in this node with the name 'pStrName'
+    //INFO: Same as JSON_NODE::findNodeByName(), but it always goes through the elements
+    //'pStrName' = node (or element) name to look for (cannot be ""!)
+    //'pJNodeFound' = if not nullptr, receives the node found
+    //'bCaseSensitive' = true if 'pStrName' should be matched in case-sensitive way, false if not
+    //'pJSrch' = if not nullptr, must be used for repeated searches for the same node name (keep calling this method while it succeeds in finding)
     //RETURN:
-    //		= true if success
-    //		= false if failed (check CJSON::GetLastError() for info)
-    bool bRes = false;
-    int nOSError = NO_ERROR;
-    BYTE* pFileData = nullptr;
-    UINT ncbSzFileData = 0;
+    //		= Node type if found, or
+    //		= JNT_NONE if nothing was found, or
+    //		= JNT_ERROR if error in search parameters
+    if(!isNodeSet() ||
+        !pStrName ||
+        !pStrName[0])
+    {
+        return JNT_ERROR;
+    }
 
-    if(pStrFilePath &&
-        pStrFilePath[0])
+    const uint64_t* pT = pTape->arrTape.data();
+    if((pT[nIndex] >> JSON_TAPE_TAG_SHIFT) != JTT_START_OBJECT)
+        return JNT_ERROR;
+
+    const WCHAR* pStrs = pTape->strBuff.c_str();
+    intptr_t nCnt = (intptr_t)pT[nIndex + 1];
+    intptr_t nFrom = pJSrch ? pJSrch->nIndex : 0;
+    intptr_t nLnStrName = STRLEN(pStrName);
+
+    size_t i = nIndex + 2;
+    for(intptr_t e = 0; e < nCnt; e++)
     {
-#ifdef _WIN32
-        //Windows specific
+        const WCHAR* pName = pStrs + (pT[i] & JSON_TAPE_PAYLOAD_MASK);
+        intptr_t nchLen = (intptr_t)pT[i + 1];
 
-        //Open file
-        HANDLE hFile = ::CreateFile(pStrFilePath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
-            OPEN_EXISTING, 0, nullptr);
-        if(hFile != INVALID_HANDLE_VALUE)
+        if(e >= nFrom &&
+            (bCaseSensitive ? nchLen == nLnStrName && memcmp(pName, pStrName, nLnStrName * sizeof(WCHAR)) == 0 :
+                JSON_NODE::compareStringsEqual(pName, nchLen, pStrName, nLnStrName, false)))
         {
-            LARGE_INTEGER liSz = {0};
-            if(::GetFileSizeEx(hFile, &liSz))
-            {
-                //Check file size (if needed)
-                if(!ncbSzMaxFileSz ||
-                    liSz.QuadPart <= ncbSzMaxFileSz)
-                {
-                    //Reserve mem
-                    ncbSzFileData = (UINT)liSz.QuadPart;
-                    pFileData = new (std::nothrow) BYTE[ncbSzFileData];
-                    if(pFileData)
-                    {
-                        //Read data
-                        DWORD dwcbRead = 0;
-                        if(::ReadFile(hFile, pFileData, ncbSzFileData, &dwcbRead, nullptr))
-                        {
-                            if(ncbSzFileData == dwcbRead)
-                            {
-                                //Got!
-                                bRes = true;
-                            }
-                            else
-                            {
-                                //Bad size read
-                                nOSError = ERROR_BAD_LENGTH;
-                            }
-                        }
-                        else
-                        {
-                            //Error
-                            nOSError = ::GetLastError();
-                        }
-                    }
-                    else
-                    {
-                        //Memory failed
-                        nOSError = ERROR_NOT_ENOUGH_MEMORY;
-                    }
-                }
-                else
-                {
-                    //File is too large
-                    nOSError = ERROR_FILE_TOO_LARGE;
-                }
-            }
-            else
+            //Matched
+            if(pJSrch)
             {
-                //Error
-                nOSError = ::GetLastError();
+                //Update index for the next search
+                pJSrch->nIndex = e + 1;
             }
 
-            //Close file
-            VERIFY(::CloseHandle(hFile));
+            return _setFound(pJNodeFound, i + 2, i);
         }
-        else
-            nOSError = ::GetLastError();
-        
-#elif __APPLE__
-        //macOS specific
 
-        //Read file contents
-        FILE* pFile = fopen(pStrFilePath, "rb");
-        if(pFile)
-        {
-            //Get file size
-            if(fseek(pFile, 0, SEEK_END) == 0)
-            {
-                long ncbFileSz = ftell(pFile);
-                if(ncbFileSz >= 0)
-                {
-                    if(fseek(pFile, 0, SEEK_SET) == 0)
-                    {
-                        //Check file size (if needed)
-                        if(!ncbSzMaxFileSz ||
-                           ncbFileSz <= ncbSzMaxFileSz)
-                        {
-                            //Reserve mem
-                            pFileData = new (std::nothrow) BYTE[ncbFileSz];
-                            if(pFileData)
-                            {
-                                size_t szcbRead =
-                                fread(pFileData, sizeof(char), ncbFileSz, pFile);
-                                
-                                if(szcbRead == ncbFileSz)
-                                {
-                                    //Success
-                                    bRes = true;
-                                    
-                                    ncbSzFileData = (UINT)ncbFileSz;
-                                }
-                                else
-                                {
-                                    //Bad size
-                                    nOSError = EAGAIN;
-                                }
-                            }
-                            else
-                                nOSError = ENOMEM;
-                        }
-                        else
-                            nOSError = EFBIG;
-                    }
-                    else
-                        nOSError = errno;
-                }
-                else
-                    nOSError = errno;
-            }
-            else
-                nOSError = errno;
-            
-            //Close file
-            fclose(pFile);
-        }
-        else
-            nOSError = errno;
-#endif
+        i += 2 + _getTapeValueSize(pT, i + 2);
     }
-    else
-        nOSError = ERROR_INVALID_PARAMETER;
 
-    //See if we failed, or don't need the data returned
-    if(!bRes ||
-        !ppOutData)
+    return JNT_NONE;
+}
+
+
+JSON_NODE_TYPE JSON_TAPE_NODE::getNextNode(JSON_TAPE_NODE* pJNodeNext)
+{
+    //Get the node that follows this one in the same object or array
+    //'pJNodeNext' = if not nullptr, receives the next node (it can be this node)
+    //RETURN:
+    //		= Node type of the next node, or
+    //		= JNT_NONE if this is the last node (or the root node), or
+    //		= JNT_ERROR if this node is not set
+    if(!isNodeSet())
+        return JNT_ERROR;
+
+    const uint64_t* pT = pTape->arrTape.data();
+
+    size_t i = nIndex + _getTapeValueSize(pT, nIndex);
+    if(i >= pTape->arrTape.size())
+        return JNT_NONE;
+
+    uint64_t nTag = pT[i] >> JSON_TAPE_TAG_SHIFT;
+    if(nTag == JTT_END_OBJECT ||
+        nTag == JTT_END_ARRAY)
     {
-        //Free mem
-        if(pFileData)
+        return JNT_NONE;
+    }
+
+    //Elements of objects begin with their names
+    if(pName)
+        return _setFound(pJNodeNext, i + 2, i);
+
+    return _setFound(pJNodeNext, i, 0);
+}
+
+
+LPCTSTR JSON_TAPE_NODE::getValueAsStringPtr(intptr_t* pnchOutLen)
+{
+    //Get the text of the value of this node right from the tape, without copying it
+    //INFO: Numbers that are kept as values on the tape have no text (use getValueAsString() for them)
+    //'pnchOutLen' = if not nullptr, receives the length of the text in TCHARs
+    //RETURN:
+    //		= Null-terminated text of the value, or
+    //		= nullptr if it has no text on the tape
+    LPCTSTR pStr = nullptr;
+    intptr_t nchLen = 0;
+
+    if(isNodeSet())
+    {
+        uint64_t nWord = pTape->arrTape[nIndex];
+        switch(nWord >> JSON_TAPE_TAG_SHIFT)
         {
-            delete[] pFileData;
-            pFileData = nullptr;
+        case JTT_STRING:
+        case JTT_INTEGER_TEXT:
+        case JTT_FLOAT_TEXT:
+            pStr = pTape->strBuff.c_str() + (nWord & JSON_TAPE_PAYLOAD_MASK);
+            nchLen = (intptr_t)pTape->arrTape[nIndex + 1];
+            break;
+        case JTT_NULL:
+            pStr = L("null");
+            nchLen = 4;
+            break;
+        case JTT_TRUE:
+            pStr = L("true");
+            nchLen = 4;
+            break;
+        case JTT_FALSE:
+            pStr = L("false");
+            nchLen = 5;
+            break;
+        default:
+            break;
         }
-
-        ncbSzFileData = 0;
     }
 
-    if(ppOutData)
-        *ppOutData = pFileData;
-    if(pncbOutDataSz)
-        *pncbOutDataSz = ncbSzFileData;
+    if(pnchOutLen)
+        *pnchOutLen = nchLen;
 
-    CJSON::SetLastError(nOSError);
-    return bRes;
+    return pStr;
 }
 
 
-
-bool CJSON::readFileContentsAsString(LPCTSTR pStrFilePath, std_wstring* pOutStr, UINT ncbSzMaxFileSz)
+bool JSON_TAPE_NODE::_getNode(JSON_VALUE& val, JSON_NODE& jNode)
 {
-    //Read file contents into a string
-    //INFO: Takes into account BOMs for text file encodings
-    //'pStrFilePath' = file path
-    //'pOutStr' = if not nullptr, receives the data as a string
-    //'ncbSzMaxFileSz' = if not 0, maximum allowed file size in BYTEs
+    //Set 'jNode' to read the value of this node the same way as JSON_NODE parsed from the same JSON
+    //'val' = receives the value that 'jNode' points to (it refers to the tape)
     //RETURN:
     //		= true if success
-    //		= false if failed (check CJSON::GetLastError() for info)
-    bool bRes = false;
-    int nOSError = NO_ERROR;
+    //		= false if this node is not set ('jNode' is not set then)
+    if(!isNodeSet())
+        return false;
 
-    //Read file as BYTE string first
-    BYTE* pFileData = nullptr;
-    UINT ncbSzFileData = 0;
-    if(CJSON::readFileContents(pStrFilePath, &pFileData, &ncbSzFileData, ncbSzMaxFileSz))
+    JSON_NODE_TYPE type = getNodeType();
+    uint64_t nWord = pTape->arrTape[nIndex];
+
+    switch(nWord >> JSON_TAPE_TAG_SHIFT)
     {
-        int ncbSzBOM;
-        JSON_ENCODING enc;
+    case JTT_START_OBJECT:
+        val.valType = JVT_OBJECT;
+        break;
 
-        //Look for BOMs
-        if(ncbSzFileData >= 3 &&
-            pFileData[0] == 0xef &&
-            pFileData[1] == 0xbb &&
-            pFileData[2] == 0xbf)
-        {
-            //UTF-8
-            ncbSzBOM = 3;
-            enc = JENC_UTF_8;
-        }
-        else if(ncbSzFileData >= 2 &&
-            pFileData[0] == 0xfe &&
-            pFileData[1] == 0xff)
-        {
-            //UTF-16 BE
-            ncbSzBOM = 2;
-            enc = JENC_UNICODE_16BE;
-        }
-        else if(ncbSzFileData >= 2 &&
-            pFileData[0] == 0xff &&
-            pFileData[1] == 0xfe)
-        {
-            //UTF-16 LE
-            ncbSzBOM = 2;
-            enc = JENC_UNICODE_16;
-        }
-        else
-        {
-            //Treat as ASCII
-            ncbSzBOM = 0;
-            enc = JENC_ANSI;
-        }
-        
-        
-        std_wstring strDummy;
-        if(CJSON::convertStringToUnicode((const char *)(pFileData + ncbSzBOM),
-                                         ncbSzFileData - ncbSzBOM,
-                                         enc,
-                                         pOutStr ? pOutStr : &strDummy))
+    case JTT_START_ARRAY:
+        val.valType = JVT_ARRAY;
+        break;
+
+    case JTT_STRING:
+        val.valType = JVT_DOUBLE_QUOTED;
+        val.pStrRef = pTape->strBuff.c_str() + (nWord & JSON_TAPE_PAYLOAD_MASK);
+        val.nchStrRef = (intptr_t)pTape->arrTape[nIndex + 1];
+        break;
+
+    case JTT_INTEGER_TEXT:
+    case JTT_FLOAT_TEXT:
+        val.valType = JVT_PLAIN;
+        val.pStrRef = pTape->strBuff.c_str() + (nWord & JSON_TAPE_PAYLOAD_MASK);
+        val.nchStrRef = (intptr_t)pTape->arrTape[nIndex + 1];
+        val.plainType = type;
+        break;
+
+    default:
         {
-            //Done
-            bRes = true;
+            //Same as converted when parsed (see JPF_NATIVE_VALUES)
+            val.valType = JVT_PLAIN;
+            val.nativeType = type;
+            val.plainType = type;
+
+            val.pStrRef = getValueAsStringPtr(&val.nchStrRef);
+
+            if(type == JNT_BOOLEAN)
+                val.bNative = (nWord >> JSON_TAPE_TAG_SHIFT) == JTT_TRUE;
+            else if(type == JNT_INTEGER)
+                val.iiNative = (int64_t)pTape->arrTape[nIndex + 1];
+            else if(type == JNT_FLOAT)
+                memcpy(&val.fNative, &pTape->arrTape[nIndex + 1], sizeof(val.fNative));
         }
-        else
-            nOSError = CJSON::GetLastError();
+        break;
+    }
 
-        
+    jNode.typeNode = type;
+    jNode.pVal = &val;
+    jNode.pJSONData = &pTape->jDataEmpty;
+
+    return true;
+}
+
+
+JSON_NODE_TYPE JSON_TAPE_NODE::_setFound(JSON_TAPE_NODE* pJNodeFound, size_t nIndexFound, size_t nIndexName)
+{
+    //Set 'pJNodeFound' (if not nullptr) to the node found
+    //'nIndexFound' = index of the value of the node found on the tape
+    //'nIndexName' = index of its name on the tape, or 0 if it has no name
+    //RETURN: = Type of the node found
+    JSON_TAPE_NODE jnFound;
+    jnFound.pTape = pTape;
+    jnFound.nIndex = nIndexFound;
+
+    if(nIndexName)
+    {
+        jnFound.pName = pTape->strBuff.c_str() + (pTape->arrTape[nIndexName] & JSON_TAPE_PAYLOAD_MASK);
+        jnFound.nchName = (intptr_t)pTape->arrTape[nIndexName + 1];
     }
-    else
-        nOSError = CJSON::GetLastError();
 
-    //Free mem
-    if(pFileData)
+    if(pJNodeFound)
+        *pJNodeFound = jnFound;
+
+    return jnFound.getNodeType();
+}
+
+
+
+
+JSON_ENCODING CJSON::_detectFileEncoding(const BYTE* pData, size_t ncbDataSz, int* pncbOutBOM)
+{
+    //Determine encoding of file contents from its BOM
+    //'pData' = file contents
+    //'ncbDataSz' = size of 'pData' in BYTEs
+    //'pncbOutBOM' = receives the size of the BOM in BYTEs, or 0 if there's none
+    //RETURN:
+    //		= Encoding of the text in 'pData'
+    int ncbSzBOM;
+    JSON_ENCODING enc;
+
+    //Look for BOMs
+    if(ncbDataSz >= 3 &&
+        pData[0] == 0xef &&
+        pData[1] == 0xbb &&
+        pData[2] == 0xbf)
+    {
+        //UTF-8
+        ncbSzBOM = 3;
+        enc = JENC_UTF_8;
+    }
+    else if(ncbDataSz >= 2 &&
+        pData[0] == 0xfe &&
+        pData[1] == 0xff)
+    {
+        //UTF-16 BE
+        ncbSzBOM = 2;
+        enc = JENC_UNICODE_16BE;
+    }
+    else if(ncbDataSz >= 2 &&
+        pData[0] == 0xff &&
+        pData[1] == 0xfe)
     {
-        delete[] pFileData;
-        pFileData = nullptr;
+        //UTF-16 LE
+        ncbSzBOM = 2;
+        enc = JENC_UNICODE_16;
     }
-
-    //Only if failed, otherwise it will be set prior
-    if(!bRes &&
-        pOutStr)
+    else
     {
-        pOutStr->clear();
+        //Treat as ASCII
+        ncbSzBOM = 0;
+        enc = JENC_ANSI;
+
+#ifdef JSON_UTF8
+        //macOS & POSIX specific
+        //INFO: Text files without a BOM are normally UTF-8 encoded here, so use it if the data is valid UTF-8
+        enc = JSON_NODE::isValidUtf8((const char*)pData, ncbDataSz) ? JENC_UTF_8 : JENC_ANSI;
+#endif
     }
 
-    CJSON::SetLastError(nOSError);
-    return bRes;
+    *pncbOutBOM = ncbSzBOM;
+    return enc;
 }
 
 
@@ -4647,8 +12897,8 @@ bool CJSON::writeFileContents(LPCTSTR pStrFilePath, const BYTE* pData, size_t nc
         else
             nOSError = ::GetLastError();
         
-#elif __APPLE__
-        //macOS specific
+#elif JSON_UTF8
+        //macOS & POSIX specific
 
         //Create new file
         FILE* pFile = fopen(pStrFilePath, "wb+");
@@ -4757,57 +13007,14 @@ bool CJSON::writeFileContentsAsString(LPCTSTR pStrFilePath,
             //Windows specific
             bContinue = !bAllowAnyDataLoss || !bDataLoss;
 #else
-            //macOS specific
+            //macOS & POSIX specific
             bContinue = true;
 #endif
             if(bContinue)
             {
                 //See what BOM we need to write
                 size_t szcbBomSz;
-                const BYTE* pBOM;
-                
-                switch(enc)
-                {
-                    case JENC_ANSI:
-                    {
-                        pBOM = (const BYTE*)"";
-                        szcbBomSz = 0;
-                    }
-                    break;
-                        
-                    case JENC_UTF_8:
-                    {
-                        static BYTE pBOM_utf8[] = {0xef, 0xbb, 0xbf};
-                        
-                        pBOM = pBOM_utf8;
-                        szcbBomSz = sizeof(pBOM_utf8);
-                    }
-                    break;
-                        
-                    case JENC_UNICODE_16:
-                    {
-                        static BYTE pBOM_utf_16[] = {0xff, 0xfe};
-                        
-                        pBOM = pBOM_utf_16;
-                        szcbBomSz = sizeof(pBOM_utf_16);
-                    }
-                    break;
-                    
-                    case JENC_UNICODE_16BE:
-                    {
-                        static BYTE pBOM_utf_16be[] = {0xfe, 0xff};
-                        
-                        pBOM = pBOM_utf_16be;
-                        szcbBomSz = sizeof(pBOM_utf_16be);
-                    }
-                    break;
-
-                    default:
-                        //Bad encoding
-                        pBOM = nullptr;
-                        szcbBomSz = 0;
-                        break;
-                }
+                const BYTE* pBOM = _getBOMForEncoding(enc, &szcbBomSz);
 
                 if(pBOM)
                 {
@@ -4852,4 +13059,355 @@ bool CJSON::writeFileContentsAsString(LPCTSTR pStrFilePath,
 
 
 
+
+const BYTE* CJSON::_getBOMForEncoding(JSON_ENCODING enc, size_t* pncbOutSz)
+{
+    //Get BOM for a text file in the 'enc' encoding
+    //'pncbOutSz' = receives size of BOM in BYTEs (can be 0 if encoding has no BOM)
+    //RETURN:
+    //		= Pointer to BOM
+    //		= nullptr if bad encoding
+    const BYTE* pBOM;
+    size_t szcbBomSz;
+    
+    switch(enc)
+    {
+        case JENC_ANSI:
+        {
+            pBOM = (const BYTE*)"";
+            szcbBomSz = 0;
+        }
+        break;
+            
+        case JENC_UTF_8:
+        {
+            static BYTE pBOM_utf8[] = {0xef, 0xbb, 0xbf};
+            
+            pBOM = pBOM_utf8;
+            szcbBomSz = sizeof(pBOM_utf8);
+        }
+        break;
+            
+        case JENC_UNICODE_16:
+        {
+            static BYTE pBOM_utf_16[] = {0xff, 0xfe};
+            
+            pBOM = pBOM_utf_16;
+            szcbBomSz = sizeof(pBOM_utf_16);
+        }
+        break;
+        
+        case JENC_UNICODE_16BE:
+        {
+            static BYTE pBOM_utf_16be[] = {0xfe, 0xff};
+            
+            pBOM = pBOM_utf_16be;
+            szcbBomSz = sizeof(pBOM_utf_16be);
+        }
+        break;
+
+        default:
+            //Bad encoding
+            pBOM = nullptr;
+            szcbBomSz = 0;
+            break;
+    }
+    
+    if(pncbOutSz)
+        *pncbOutSz = szcbBomSz;
+    
+    return pBOM;
+}
+
+
+
+bool CJSON::toSink(JSON_DATA* pJE, JSON_SINK_CALLBACK pfnCallback, void* pCbkParam, JSON_ENCODING enc, JSON_FORMATTING* pJFormat, bool bWriteBOM)
+{
+    //Convert 'pJE' to JSON and pass it to a callback in small encoded chunks
+    //INFO: Unlike toString(), it doesn't keep the whole JSON in memory, which is better for large exports
+    //'pfnCallback' = callback that receives encoded JSON (it may be called several times)
+    //'pCbkParam' = parameter to pass to 'pfnCallback'
+    //'enc' = encoding to convert JSON into
+    //'pJFormat' = if not nullptr, formatting to use for JSON, or nullptr to use defaults
+    //'bWriteBOM' = true to begin output with the BOM for 'enc' (if it has one)
+    //RETURN:
+    //		= true if success
+    //		= false if error (check CJSON::GetLastError() for info)
+    //          INFO: Some of the JSON may have been already passed to 'pfnCallback' by then!
+    bool bRes = false;
+    int nOSError = NO_ERROR;
+
+    size_t ncbBOM = 0;
+    const BYTE* pBOM = _getBOMForEncoding(enc, &ncbBOM);
+
+    if(pJE &&
+        pfnCallback &&
+        pBOM)
+    {
+        //Do we have a formatting struct
+        JSON_FORMATTING jFmt;
+        if(!pJFormat)
+        {
+            //Use defaults
+            pJFormat = &jFmt;
+        }
+
+        JSON_WRITER jw(pfnCallback, pCbkParam, enc, pJFormat);
+
+        bool bBOMWrittenOK = true;
+        if(bWriteBOM &&
+            ncbBOM)
+        {
+            //Write BOM
+            CJSON::SetLastError(NO_ERROR);
+            if(!pfnCallback(pBOM, ncbBOM, pCbkParam))
+            {
+                nOSError = CJSON::GetLastError();
+                if(nOSError == NO_ERROR)
+                    nOSError = ERROR_WRITE_FAULT;
+
+                bBOMWrittenOK = false;
+            }
+        }
+
+        if(bBOMWrittenOK)
+        {
+            if(_serialize(pJE, jw))
+            {
+                //Done
+                bRes = true;
+            }
+            else
+                nOSError = jw.nOSError;
+        }
+    }
+    else
+        nOSError = ERROR_INVALID_PARAMETER;
+
+    CJSON::SetLastError(nOSError);
+    return bRes;
+}
+
+
+static bool _sinkToFILE(const BYTE* pData, size_t ncbDataSz, void* pCbkParam)
+{
+    //Sink callback for CJSON::toFile()
+    if(fwrite(pData, sizeof(char), ncbDataSz, (FILE*)pCbkParam) != ncbDataSz)
+    {
+#ifdef _WIN32
+        //Windows specific
+        CJSON::SetLastError(ERROR_WRITE_FAULT);
+#elif JSON_UTF8
+        //macOS & POSIX specific
+        CJSON::SetLastError(errno);
+#endif
+        return false;
+    }
+
+    return true;
+}
+
+bool CJSON::toFile(JSON_DATA* pJE, FILE* pFile, JSON_ENCODING enc, JSON_FORMATTING* pJFormat, bool bWriteBOM)
+{
+    //Convert 'pJE' to JSON and write it into an open file, without keeping the whole JSON in memory
+    //'pFile' = file opened for writing (in binary mode) -- it is not closed, but is flushed when done
+    //'enc' = encoding to convert JSON into
+    //'pJFormat' = if not nullptr, formatting to use for JSON, or nullptr to use defaults
+    //'bWriteBOM' = true to begin with the BOM for 'enc' (if it has one)
+    //RETURN:
+    //		= true if success
+    //		= false if error (check CJSON::GetLastError() for info)
+    if(!pFile)
+    {
+        CJSON::SetLastError(ERROR_INVALID_PARAMETER);
+        return false;
+    }
+
+    if(!toSink(pJE, _sinkToFILE, pFile, enc, pJFormat, bWriteBOM))
+        return false;
+
+    if(fflush(pFile) != 0)
+    {
+#ifdef _WIN32
+        //Windows specific
+        CJSON::SetLastError(ERROR_WRITE_FAULT);
+#elif JSON_UTF8
+        //macOS & POSIX specific
+        CJSON::SetLastError(errno);
+#endif
+        return false;
+    }
+
+    return true;
+}
+
+
+#ifdef _WIN32
+//Windows specific
+
+static bool _sinkToFileHandle(const BYTE* pData, size_t ncbDataSz, void* pCbkParam)
+{
+    //Sink callback for CJSON::toFileHandle()
+    //INFO: 'ncbDataSz' is always small here, so it fits into a DWORD
+    DWORD dwcbWrtn = 0;
+    if(!::WriteFile((HANDLE)pCbkParam, pData, (DWORD)ncbDataSz, &dwcbWrtn, nullptr))
+        return false;
+
+    if(dwcbWrtn != ncbDataSz)
+    {
+        ::SetLastError(ERROR_NET_WRITE_FAULT);
+        return false;
+    }
+
+    return true;
+}
+
+bool CJSON::toFileHandle(JSON_DATA* pJE, HANDLE hFile, JSON_ENCODING enc, JSON_FORMATTING* pJFormat, bool bWriteBOM)
+{
+    //Convert 'pJE' to JSON and write it into an open file, without keeping the whole JSON in memory
+    //'hFile' = file handle opened for writing -- it is not closed
+    //'enc' = encoding to convert JSON into
+    //'pJFormat' = if not nullptr, formatting to use for JSON, or nullptr to use defaults
+    //'bWriteBOM' = true to begin with the BOM for 'enc' (if it has one)
+    //RETURN:
+    //		= true if success
+    //		= false if error (check CJSON::GetLastError() for info)
+    if(!hFile ||
+        hFile == INVALID_HANDLE_VALUE)
+    {
+        CJSON::SetLastError(ERROR_INVALID_PARAMETER);
+        return false;
+    }
+
+    return toSink(pJE, _sinkToFileHandle, hFile, enc, pJFormat, bWriteBOM);
+}
+
+#elif JSON_UTF8
+//macOS & POSIX specific
+
+static bool _sinkToFileDescriptor(const BYTE* pData, size_t ncbDataSz, void* pCbkParam)
+{
+    //Sink callback for CJSON::toFileDescriptor()
+    int fd = (int)(intptr_t)pCbkParam;
+
+    while(ncbDataSz)
+    {
+        ssize_t ncbWrtn = write(fd, pData, ncbDataSz);
+        if(ncbWrtn < 0)
+        {
+            if(errno == EINTR)
+                continue;
+
+            CJSON::SetLastError(errno);
+            return false;
+        }
+
+        pData += ncbWrtn;
+        ncbDataSz -= ncbWrtn;
+    }
+
+    return true;
+}
+
+bool CJSON::toFileDescriptor(JSON_DATA* pJE, int fd, JSON_ENCODING enc, JSON_FORMATTING* pJFormat, bool bWriteBOM)
+{
+    //Convert 'pJE' to JSON and write it into a file descriptor (file, pipe or socket), without keeping the whole JSON in memory
+    //'fd' = file descriptor opened for writing -- it is not closed
+    //'enc' = encoding to convert JSON into
+    //'pJFormat' = if not nullptr, formatting to use for JSON, or nullptr to use defaults
+    //'bWriteBOM' = true to begin with the BOM for 'enc' (if it has one)
+    //RETURN:
+    //		= true if success
+    //		= false if error (check CJSON::GetLastError() for info)
+    if(fd < 0)
+    {
+        CJSON::SetLastError(ERROR_INVALID_PARAMETER);
+        return false;
+    }
+
+    return toSink(pJE, _sinkToFileDescriptor, (void*)(intptr_t)fd, enc, pJFormat, bWriteBOM);
+}
+
+#endif
+
+
+bool CJSON::writeJSONFile(LPCTSTR pStrFilePath, JSON_DATA* pJE, JSON_ENCODING enc, JSON_FORMATTING* pJFormat)
+{
+    //Convert 'pJE' to JSON and save it into a file, without keeping the whole JSON in memory
+    //INFO: It sets specific BOMs for text file encodings (same as writeFileContentsAsString)
+    //'pStrFilePath' = file path
+    //'enc' = encoding to save JSON in
+    //'pJFormat' = if not nullptr, formatting to use for JSON, or nullptr to use defaults
+    //RETURN:
+    //		= true if success
+    //		= false if failed (check CJSON::GetLastError() for info)
+    bool bRes = false;
+    int nOSError = NO_ERROR;
+
+    if(pStrFilePath &&
+        pStrFilePath[0] &&
+        pJE)
+    {
+#ifdef _WIN32
+        //Windows specific
+        
+        //Open file
+        HANDLE hFile = ::CreateFile(pStrFilePath, GENERIC_READ | GENERIC_WRITE, 
+            FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+            CREATE_ALWAYS, 0, nullptr);
+        if(hFile != INVALID_HANDLE_VALUE)
+        {
+            if(toFileHandle(pJE, hFile, enc, pJFormat, true))
+            {
+                //Done
+                bRes = true;
+            }
+            else
+                nOSError = CJSON::GetLastError();
+
+            //Flush buffer
+            //INFO: To make sure the file is fully saved on disk
+            VERIFY(::FlushFileBuffers(hFile));
+
+            //Close file
+            VERIFY(::CloseHandle(hFile));
+        }
+        else
+            nOSError = ::GetLastError();
+        
+#elif JSON_UTF8
+        //macOS & POSIX specific
+
+        //Create new file
+        FILE* pFile = fopen(pStrFilePath, "wb+");
+        if(pFile)
+        {
+            if(toFile(pJE, pFile, enc, pJFormat, true))
+            {
+                //Done
+                bRes = true;
+            }
+            else
+                nOSError = CJSON::GetLastError();
+            
+            //Close
+            if(fclose(pFile) != 0 &&
+                bRes)
+            {
+                nOSError = errno;
+                bRes = false;
+            }
+        }
+        else
+            nOSError = errno;
+#endif
+    }
+    else
+        nOSError = ERROR_INVALID_PARAMETER;
+
+    CJSON::SetLastError(nOSError);
+    return bRes;
+}
+
+
 };
@@ -14,16 +14,41 @@
 #include <Windows.h>
 #include <tchar.h>
 
-#elif __APPLE__
-//macOS specific
-#include <CoreFoundation/CFString.h>
+#elif defined(__APPLE__) || defined(__unix__)
+//macOS, Linux & other POSIX specific
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <limits.h>
+#include <locale.h>
+#include <wctype.h>
 
+#ifdef __APPLE__
+//macOS specific: newlocale() and towlower_l()
+#include <xlocale.h>
+#endif
+
+#endif
+
+
+#if defined(__APPLE__) || defined(__unix__)
+//macOS & POSIX: all strings are kept as UTF-8 encoded 'char' sequences
+#define JSON_UTF8 1
 #endif
 
 
 #include <algorithm>
 #include <functional>
 #include <cctype>
+#include <cmath>
+#include <clocale>
+#include <new>
+#include <memory>
+#include <atomic>
+#include <cstddef>
 
 #include <assert.h>
 
@@ -36,7 +61,7 @@
 #define TSIZEOF(f) (SIZEOF(f) - 1)
 #endif
 
-#ifndef _DEBUG
+#if !defined(_DEBUG) && defined(DEBUG)
 #define _DEBUG DEBUG
 #endif
 
@@ -69,8 +94,8 @@ namespace json
 
 
 
-#elif __APPLE__
-//macOS specific
+#elif JSON_UTF8
+//macOS & POSIX specific
 //---------------------------------------------------
 #define std_wstring std::string
 
@@ -87,6 +112,10 @@ namespace json
 #define ERROR_INVALID_DATA          EBADF
 #define ERROR_OUTOFMEMORY           ENOMEM
 #define ERROR_BAD_FORMAT            ENOEXEC
+#define ERROR_WRITE_FAULT           EIO
+#define ERROR_CANCELLED             ECANCELED
+#define ERROR_ACCESS_DENIED         EACCES
+#define ERROR_BUSY                  EBUSY
 
 #define L(txt) txt
 
@@ -97,7 +126,14 @@ namespace json
 
 
 
-#define UTF8_MAX_VAL 0x001FFFFF         //Maximum allowed utf-8 value (inclusive)
+#define UTF8_MAX_VAL 0x0010FFFF         //Maximum allowed utf-8 value (inclusive) -- the end of the Unicode range
+#define JSON_NAME_INDEX_MIN_CNT 16      //Objects with at least this many elements get a hash index of names when searched by name
+#define JSON_PARALLEL_MIN_LEN 0x10000   //JSON shorter than this many TCHARs is always parsed in one thread by CJSON::parseJSONParallel()
+#define JSON_NUMBER_BUFF_LEN 32         //Size of buffer in TCHARs that fits any number written by CJSON::_formatInt64() or CJSON::_formatDouble(), with the terminating null
+#define JSON_MSGPACK_EXT_PLAIN_TEXT 1   //MessagePack extension type that CJSON::toMsgPack() uses for plain values that can't be written as nil, boolean,
+                                        //integer or float without changing their text (such as 1.50, 1e999 or 123456789012345678901234567890)
+#define JSON_MSGPACK_MAX_DEPTH 1024     //Maximum nesting of arrays and maps that CJSON::parseMsgPack() accepts
+#define JSON_IMAGE_VERSION 1            //Version of the binary format written by CJSON::writeJSONImage() (JSON_IMAGE opens only this version)
 
 
 
@@ -111,17 +147,112 @@ enum JSON_VALUE_TYPE
     JVT_OBJECT,							// { "name1":"value1", "name2" : "value2" }
 };
 
+enum JSON_NODE_TYPE
+{
+    JNT_ERROR = -1,			//Error
+    JNT_NONE = 0,			//Not known
+
+    JNT_ROOT = 1,			//Root node
+    JNT_NULL = 2,			//null
+    JNT_BOOLEAN = 3,		//true or false
+    JNT_INTEGER = 4,		//integer
+    JNT_FLOAT = 5,			//floating point number
+    JNT_STRING = 6,			//"string" - Note that "123" will also be returned as string, as well as "true" will be returned as string (because of double quotes)
+    JNT_ARRAY = 7,			//[1, 2, "3s"]
+    JNT_OBJECT = 8,			//{"name": "value"}
+};
+
 struct JSON_VALUE
 {
     JSON_VALUE_TYPE valType;			//Type of value
 
-    std_wstring strValue;				//Used in case of: JVT_PLAIN, JVT_DOUBLE_QUOTED
+    std_wstring strValue;				//Used in case of: JVT_PLAIN, JVT_DOUBLE_QUOTED (unless 'pStrRef' is used)
     void* pValue;						//Pointer to either JSON_OBJECT or JSON_ARRAY, otherwise nullptr
 
+    const WCHAR* pStrRef;				//If not nullptr, points to the value in the source JSON string (see JPF_REFERENCE_SOURCE), or in the arena of its JSON data (see JSON_DATA::useArena), and 'strValue' is not used
+                                        //INFO: It is not null-terminated! Use getStrPtr() and getStrLen() to read the value in either case.
+    intptr_t nchStrRef;					//Length of 'pStrRef' in TCHARs
+
+    JSON_NODE_TYPE nativeType;			//For JVT_PLAIN: JNT_NULL, JNT_BOOLEAN, JNT_INTEGER or JNT_FLOAT if the value was converted when parsed (see JPF_NATIVE_VALUES), otherwise JNT_NONE
+    union
+    {
+        int64_t iiNative;				//Value for JNT_INTEGER
+        double fNative;					//Value for JNT_FLOAT
+        bool bNative;					//Value for JNT_BOOLEAN
+    };
+                                        //INFO: Numbers may have no text (unless JPF_KEEP_NUMBER_TEXT was used), in which case getStr() and getStrZ() make it from the value
+    JSON_NODE_TYPE plainType;			//For JVT_PLAIN: node type determined when the value was parsed or set (lookups never set it), otherwise JNT_NONE
+
     JSON_VALUE()
     {
         valType = JVT_NONE;
         pValue = nullptr;
+        pStrRef = nullptr;
+        nchStrRef = 0;
+        nativeType = JNT_NONE;
+        iiNative = 0;
+        plainType = JNT_NONE;
+    }
+
+    const WCHAR* getStrPtr() const
+    {
+        //RETURN: = Pointer to the value for JVT_PLAIN, JVT_DOUBLE_QUOTED -- it may not be null-terminated! (see getStrLen())
+        return pStrRef ? pStrRef : strValue.c_str();
+    }
+
+    intptr_t getStrLen() const
+    {
+        //RETURN: = Length of the value for JVT_PLAIN, JVT_DOUBLE_QUOTED in TCHARs
+        return pStrRef ? nchStrRef : (intptr_t)strValue.size();
+    }
+
+    void getStr(std_wstring& str) const
+    {
+        //'str' = receives the value for JVT_PLAIN, JVT_DOUBLE_QUOTED
+        if(pStrRef)
+            str.assign(pStrRef, nchStrRef);
+        else if(isNativeOnly())
+            formatNative(str);
+        else
+            str = strValue;
+    }
+
+    LPCTSTR getStrZ(std_wstring& strBuff) const
+    {
+        //'strBuff' = buffer to use if the value has to be copied to be null-terminated
+        //RETURN: = Null-terminated value for JVT_PLAIN, JVT_DOUBLE_QUOTED
+        if(pStrRef)
+        {
+            strBuff.assign(pStrRef, nchStrRef);
+            return strBuff.c_str();
+        }
+        else if(isNativeOnly())
+        {
+            formatNative(strBuff);
+            return strBuff.c_str();
+        }
+
+        return strValue.c_str();
+    }
+
+    bool isNativeOnly() const
+    {
+        //RETURN: = true if this is a number converted when parsed, without its text
+        return (nativeType == JNT_INTEGER || nativeType == JNT_FLOAT) &&
+            !pStrRef &&
+            strValue.empty();
+    }
+
+    void formatNative(std_wstring& str) const;
+
+    void resetStrRef()
+    {
+        //Stop referencing the source JSON string (and drop the value converted from it, as well as its node type)
+        //INFO: Must be called before 'strValue' is set
+        pStrRef = nullptr;
+        nchStrRef = 0;
+        nativeType = JNT_NONE;
+        plainType = JNT_NONE;
     }
 
     bool isEmptyValue()
@@ -139,8 +270,47 @@ struct JSON_VALUE
 
 struct JSON_OBJECT_ELEMENT
 {
-    std_wstring strName;
+    std_wstring strName;                //Name of the element (unless 'pNameRef' is used)
     JSON_VALUE val;
+
+    const WCHAR* pNameRef;				//If not nullptr, points to the name in the source JSON string (see JPF_REFERENCE_SOURCE), or in the arena of its JSON data (see JSON_DATA::useArena), and 'strName' is not used
+                                        //INFO: It is not null-terminated! Use getNamePtr() and getNameLen() to read the name in either case.
+    intptr_t nchNameRef;				//Length of 'pNameRef' in TCHARs
+
+    JSON_OBJECT_ELEMENT()
+    {
+        pNameRef = nullptr;
+        nchNameRef = 0;
+    }
+
+    const WCHAR* getNamePtr() const
+    {
+        //RETURN: = Pointer to the name -- it may not be null-terminated! (see getNameLen())
+        return pNameRef ? pNameRef : strName.c_str();
+    }
+
+    intptr_t getNameLen() const
+    {
+        //RETURN: = Length of the name in TCHARs
+        return pNameRef ? nchNameRef : (intptr_t)strName.size();
+    }
+
+    void getName(std_wstring& str) const
+    {
+        //'str' = receives the name
+        if(pNameRef)
+            str.assign(pNameRef, nchNameRef);
+        else
+            str = strName;
+    }
+
+    void resetNameRef()
+    {
+        //Stop referencing the source JSON string
+        //INFO: Must be called before 'strName' is set
+        pNameRef = nullptr;
+        nchNameRef = 0;
+    }
 };
 
 struct JSON_ARRAY_ELEMENT
@@ -202,12 +372,212 @@ private:
 };
 
 
+struct JSON_NAME_INDEX;
+
+struct JSON_ARENA
+{
+    //Bump-pointer memory arena that JSON_DATA can allocate its objects and arrays from, along with their elements
+    //INFO: Parsing into JSON_DATA that uses an arena also puts names and values into it, so that such data can be emptied
+    //      by resetting the arena, without going through its nodes (see JSON_DATA::emptyData().)
+    //INFO: Memory is given back to the arena only when it is reset, which makes it best suited for parsed, read-mostly data.
+    //INFO: It is not thread-safe. An arena can be used by only one JSON_DATA at a time, but it can be reused
+    //      by the next JSON_DATA after the previous one is deleted, or by successive CJSON::parseJSON() calls
+    //      into the same JSON_DATA (see JSON_DATA::useArena())
+
+    JSON_ARENA(size_t ncbBlockSz = 0x10000)
+    {
+        //'ncbBlockSz' = size of each memory block to reserve from the heap, in BYTEs
+        pFirstBlock = nullptr;
+        pCurBlock = nullptr;
+        pCur = nullptr;
+        pEnd = nullptr;
+        ncbBlockSize = ncbBlockSz >= 0x100 ? ncbBlockSz : 0x100;
+        ncbUsed = 0;
+        pUsedBy = nullptr;
+        pNameIndexes = nullptr;
+    }
+
+    ~JSON_ARENA()
+    {
+        freeAll();
+    }
+
+    void* allocMem(size_t ncbSz);
+    void reset();
+    void freeAll();
+
+    size_t getSizeUsed()
+    {
+        //RETURN: = Number of BYTEs given out since the last reset
+        return ncbUsed;
+    }
+
+    size_t getSizeReserved();
+
+private:
+    struct ARENA_BLOCK
+    {
+        ARENA_BLOCK* pNext;             //Next block, or nullptr if none
+        size_t ncbSz;                   //Size of usable memory in this block, in BYTEs
+    };
+
+    ARENA_BLOCK* pFirstBlock;           //First block in the chain, or nullptr if none
+    ARENA_BLOCK* pCurBlock;             //Block we're allocating from now
+    BYTE* pCur;                         //Next free byte in 'pCurBlock'
+    BYTE* pEnd;                         //End of 'pCurBlock'
+    size_t ncbBlockSize;                //Size of new blocks, in BYTEs
+    size_t ncbUsed;                     //Number of BYTEs given out since the last reset
+    const void* pUsedBy;                //JSON_DATA that uses this arena now, or nullptr if none
+    std::atomic<JSON_NAME_INDEX*> pNameIndexes;    //Name indexes of objects from this arena (they come from the heap, and are deleted when the arena is reset)
+
+    friend struct JSON_DATA;
+    friend struct JSON_NODE;
+
+    static size_t _getBlockHeaderSize();
+    static BYTE* _getBlockData(ARENA_BLOCK* pBlock);
+    bool _useBlock(ARENA_BLOCK* pBlock, size_t ncbSz);
+    void _addNameIndex(JSON_NAME_INDEX* pIdx);
+    void _deleteNameIndexes();
+
+    //No assignment or copy constructor
+    JSON_ARENA(const JSON_ARENA& s) = delete;
+    JSON_ARENA& operator = (const JSON_ARENA& s) = delete;
+};
+
+
+template<typename T>
+struct JSON_ARENA_ALLOCATOR
+{
+    //[Used internally] Allocator for elements of objects and arrays, that takes memory from an arena, or from the heap
+    //INFO: Memory from the arena is not given back when the elements are reallocated, only when the arena is reset
+    typedef T value_type;
+
+    JSON_ARENA* pArena;                 //Arena to allocate from, or nullptr to use the heap
+
+    JSON_ARENA_ALLOCATOR(JSON_ARENA* pUseArena = nullptr)
+    {
+        pArena = pUseArena;
+    }
+
+    template<typename U>
+    JSON_ARENA_ALLOCATOR(const JSON_ARENA_ALLOCATOR<U>& s)
+    {
+        pArena = s.pArena;
+    }
+
+    T* allocate(size_t nCnt)
+    {
+        if(!pArena)
+            return std::allocator<T>().allocate(nCnt);
+
+        //Fail the same way as std::allocator
+        void* pMem = nCnt <= (size_t)-1 / sizeof(T) ? pArena->allocMem(nCnt * sizeof(T)) : nullptr;
+        if(!pMem)
+            throw std::bad_alloc();
+
+        return (T*)pMem;
+    }
+
+    void deallocate(T* p, size_t nCnt)
+    {
+        if(!pArena)
+            std::allocator<T>().deallocate(p, nCnt);
+    }
+
+    template<typename U>
+    bool operator == (const JSON_ARENA_ALLOCATOR<U>& s) const
+    {
+        return pArena == s.pArena;
+    }
+
+    template<typename U>
+    bool operator != (const JSON_ARENA_ALLOCATOR<U>& s) const
+    {
+        return pArena != s.pArena;
+    }
+};
+
+
+
+struct JSON_NAME_INDEX
+{
+    //[Used internally] Hash index of names in JSON_OBJECT, for JSON_NODE::findNodeByName()
+    //INFO: Once attached to an object, it's never changed by searches. Elements added to the end of the object are added to it
+    //      right away, and it must be dropped when elements are removed, reordered or renamed (see JSON_OBJECT::dropNameIndex()).
+    //INFO: Each chain lists elements in the order of their indexes, so that duplicate names are found in the same order as without it.
+    struct CHAINS
+    {
+        std::vector<intptr_t> arrHeads;         //First element in each bucket, or -1 if none
+        std::vector<intptr_t> arrTails;         //Last element in each bucket, or -1 if none
+        std::vector<intptr_t> arrNext;          //Next element in the same bucket for each element, or -1 if none
+        std::vector<size_t> arrHashes;          //Hash of each element's name
+    };
+
+    CHAINS chainsCS;                            //Case-sensitive names
+    CHAINS chainsCI;                            //Case-folded names
+    std::vector<intptr_t> arrNotFolded;         //Elements with names that can't be case-folded (see JSON_NODE::_getFoldedNameHash()), in ascending order
+    size_t nCntIndexed;                         //Number of elements (from the beginning of the object) in the index
+    size_t nMask;                               //Number of buckets - 1
+    JSON_NAME_INDEX* pNextInArena;              //For objects from an arena: next index in the list of that arena (see JSON_ARENA::pNameIndexes), or nullptr
+
+    JSON_NAME_INDEX()
+    {
+        nCntIndexed = 0;
+        nMask = 0;
+        pNextInArena = nullptr;
+    }
+
+    void clear()
+    {
+        //Empty the index and free its memory, but keep it in the list of its arena
+        JSON_NAME_INDEX* pNext = pNextInArena;
+        *this = JSON_NAME_INDEX();
+        pNextInArena = pNext;
+    }
+};
+
+
+
 struct JSON_OBJECT
 {
-    std::vector<JSON_OBJECT_ELEMENT> arrObjElmts;
+    typedef std::vector<JSON_OBJECT_ELEMENT, JSON_ARENA_ALLOCATOR<JSON_OBJECT_ELEMENT>> ELEMENTS;
+
+    ELEMENTS arrObjElmts;
+    JSON_ARENA* pArena;					//[Used internally] Arena this object and its elements were allocated from, or nullptr if from the heap
+    std::atomic<JSON_NAME_INDEX*> pNameIndex;	//[Used internally] Hash index of names, or nullptr if not built yet (it is installed by the first search)
+    std::atomic<JSON_NAME_INDEX*> pSpareNameIndex;	//[Used internally] For objects from an arena: dropped (and emptied) index to reuse for the next one, or nullptr
+
+    JSON_OBJECT(JSON_ARENA* pUseArena = nullptr)
+        : arrObjElmts(ELEMENTS::allocator_type(pUseArena))
+    {
+        pArena = pUseArena;
+        pNameIndex = nullptr;
+        pSpareNameIndex = nullptr;
+    }
+
+    ~JSON_OBJECT()
+    {
+        dropNameIndex();
+    }
 
-    JSON_OBJECT()
+    void dropNameIndex()
     {
+        //Must be called after elements were removed, reordered or renamed
+        JSON_NAME_INDEX* pIdx = pNameIndex.exchange(nullptr);
+        if(pIdx)
+        {
+            if(pArena)
+            {
+                //Indexes of objects from an arena are deleted when it's reset, so keep it for the next search to reuse
+                //(instead of adding another one to the list of the arena each time)
+                pIdx->clear();
+
+                JSON_NAME_INDEX* pIdxNull = nullptr;
+                pSpareNameIndex.compare_exchange_strong(pIdxNull, pIdx);
+            }
+            else
+                delete pIdx;
+        }
     }
 
 private:
@@ -220,10 +590,15 @@ private:
 
 struct JSON_ARRAY
 {
-    std::vector<JSON_ARRAY_ELEMENT> arrArrElmts;
+    typedef std::vector<JSON_ARRAY_ELEMENT, JSON_ARENA_ALLOCATOR<JSON_ARRAY_ELEMENT>> ELEMENTS;
+
+    ELEMENTS arrArrElmts;
+    JSON_ARENA* pArena;					//[Used internally] Arena this array and its elements were allocated from, or nullptr if from the heap
 
-    JSON_ARRAY()
+    JSON_ARRAY(JSON_ARENA* pUseArena = nullptr)
+        : arrArrElmts(ELEMENTS::allocator_type(pUseArena))
     {
+        pArena = pUseArena;
     }
 
 private:
@@ -260,23 +635,22 @@ struct JSON_SRCH
 
 
 
-enum JSON_NODE_TYPE
-{
-    JNT_ERROR = -1,			//Error
-    JNT_NONE = 0,			//Not known
-
-    JNT_ROOT = 1,			//Root node
-    JNT_NULL = 2,			//null
-    JNT_BOOLEAN = 3,		//true or false
-    JNT_INTEGER = 4,		//integer
-    JNT_FLOAT = 5,			//floating point number
-    JNT_STRING = 6,			//"string" - Note that "123" will also be returned as string, as well as "true" will be returned as string (because of double quotes)
-    JNT_ARRAY = 7,			//[1, 2, "3s"]
-    JNT_OBJECT = 8,			//{"name": "value"}
-};
 
 
 struct JSON_DATA;
+struct JSON_NODE;
+
+
+//Callback for JSON_NODE::removeNodesIf() that picks nodes to remove
+//'pJNode' = child node to check (it must not be modified)
+//'nIndex' = 0-based index of 'pJNode' in its parent node
+//'pCbkParam' = parameter that was passed to JSON_NODE::removeNodesIf()
+//RETURN:
+//		= true to remove 'pJNode'
+//		= false to keep it
+typedef bool (*JSON_REMOVE_CALLBACK)(JSON_NODE* pJNode, intptr_t nIndex, void* pCbkParam);
+
+
 
 struct JSON_NODE
 {
@@ -376,7 +750,7 @@ struct JSON_NODE
             case JVT_PLAIN:
             case JVT_DOUBLE_QUOTED:
                 {
-                    str = pVal->strValue;
+                    pVal->getStr(str);
                     bRes = true;
                 }
                 break;
@@ -449,6 +823,7 @@ struct JSON_NODE
 
     bool getValueAsInt64(int64_t* pOutVal, bool bCaseSensitive = true)
     {
+        //INFO: An empty string is read as 0
         //'bCaseSensitive' = true to look only for "true" or "false" in case sensitive way
         //RETURN: = true if value was available
         int64_t iiVal = 0;
@@ -457,21 +832,30 @@ struct JSON_NODE
         if(isNodeSet())
         {
             ASSERT(pVal);
-            if(pVal->valType == JVT_PLAIN ||
+            if(pVal->nativeType == JNT_INTEGER &&
+                typeNode == JNT_INTEGER)
+            {
+                //Converted when parsed
+                iiVal = pVal->iiNative;
+                bRes = true;
+            }
+            else if(pVal->nativeType == JNT_FLOAT &&
+                typeNode == JNT_FLOAT)
+            {
+                iiVal = (int64_t)(pVal->fNative + 0.5);		//Round it to the nearest integer
+                bRes = true;
+            }
+            else if(pVal->valType == JVT_PLAIN ||
                 pVal->valType == JVT_DOUBLE_QUOTED)
             {
+                const WCHAR* pStrVal = pVal->getStrPtr();
+                intptr_t nchStrVal = pVal->getStrLen();
+
                 //Check type as well
                 if(typeNode == JNT_INTEGER)
                 {
-#ifdef _WIN32
-                    //Windows-specific
-                    iiVal = _ttoi64(pVal->strValue.c_str());
-#elif __APPLE__
-                    //macOS specific
-                    char* pEnd = nullptr;
-                    iiVal = strtoull(pVal->strValue.c_str(), &pEnd, 10);
-#endif
-                    
+                    //Values that don't fit into 64 bits are clamped
+                    parseInt64(pStrVal, nchStrVal, &iiVal);
                     bRes = true;
                 }
                 else if(typeNode == JNT_BOOLEAN)
@@ -486,7 +870,7 @@ struct JSON_NODE
                 else if(typeNode == JNT_FLOAT)
                 {
                     double fVal = 0.0;
-                    if(parseFloat(pVal->strValue.c_str(), &fVal))
+                    if(parseDouble(pStrVal, nchStrVal, &fVal))
                     {
                         iiVal = (int64_t)(fVal + 0.5);		//Round it to the nearest integer
                         bRes = true;
@@ -494,22 +878,19 @@ struct JSON_NODE
                 }
                 else if(typeNode == JNT_STRING)
                 {
-                    if(isIntegerBase10String(pVal->strValue.c_str()))
+                    if(nchStrVal == 0)
+                    {
+                        //Empty string is read as 0
+                        bRes = true;
+                    }
+                    else if(parseInt64(pStrVal, nchStrVal, &iiVal) != 0)
                     {
-#ifdef _WIN32
-                        //Windows-specific
-                        iiVal = _ttoi64(pVal->strValue.c_str());
-#elif __APPLE__
-                        //macOS specific
-                        char* pEnd = nullptr;
-                        iiVal = strtoull(pVal->strValue.c_str(), &pEnd, 10);
-#endif
                         bRes = true;
                     }
                     else
                     {
                         double fVal = 0.0;
-                        if(parseFloat(pVal->strValue.c_str(), &fVal))
+                        if(parseDouble(pStrVal, nchStrVal, &fVal))
                         {
                             iiVal = (int64_t)(fVal + 0.5);		//Round it to the nearest integer
                             bRes = true;
@@ -525,6 +906,63 @@ struct JSON_NODE
         return bRes;
     }
 
+    bool getValueAsDouble(double* pOutVal, bool bCaseSensitive = true)
+    {
+        //INFO: An empty string is read as 0
+        //'bCaseSensitive' = true to look only for "true" or "false" in case sensitive way
+        //RETURN: = true if value was available
+        double fVal = 0.0;
+        bool bRes = false;
+
+        if(isNodeSet())
+        {
+            ASSERT(pVal);
+            if(pVal->nativeType == JNT_FLOAT &&
+                typeNode == JNT_FLOAT)
+            {
+                //Converted when parsed
+                fVal = pVal->fNative;
+                bRes = true;
+            }
+            else if(pVal->nativeType == JNT_INTEGER &&
+                typeNode == JNT_INTEGER)
+            {
+                fVal = (double)pVal->iiNative;
+                bRes = true;
+            }
+            else if(pVal->valType == JVT_PLAIN ||
+                pVal->valType == JVT_DOUBLE_QUOTED)
+            {
+                if(typeNode == JNT_BOOLEAN)
+                {
+                    bool bBool = false;
+                    if(getValueAsBool(&bBool, bCaseSensitive))
+                    {
+                        fVal = bBool ? 1.0 : 0.0;
+                        bRes = true;
+                    }
+                }
+                else if(typeNode == JNT_STRING &&
+                    pVal->getStrLen() == 0)
+                {
+                    //Empty string is read as 0
+                    bRes = true;
+                }
+                else if(typeNode == JNT_INTEGER ||
+                    typeNode == JNT_FLOAT ||
+                    typeNode == JNT_STRING)
+                {
+                    bRes = parseDouble(pVal->getStrPtr(), pVal->getStrLen(), &fVal);
+                }
+            }
+        }
+
+        if(pOutVal)
+            *pOutVal = fVal;
+
+        return bRes;
+    }
+
     bool getValueAsBool(bool* pOutBool, bool bCaseSensitive = true)
     {
         //'bCaseSensitive' = true to look only for "true" or "false" in case sensitive way
@@ -535,18 +973,24 @@ struct JSON_NODE
         if(isNodeSet())
         {
             ASSERT(pVal);
-            if(pVal->valType == JVT_PLAIN ||
+            if(pVal->nativeType == JNT_BOOLEAN)
+            {
+                //Converted when parsed
+                bVal = pVal->bNative;
+                bRes = true;
+            }
+            else if(pVal->valType == JVT_PLAIN ||
                 pVal->valType == JVT_DOUBLE_QUOTED)
             {
                 //Convert
                 bool bCaseSens = !!bCaseSensitive;
 
-                if(JSON_NODE::compareStringsEqual(pVal->strValue, L("true"), bCaseSens))
+                if(JSON_NODE::compareStringsEqual(pVal->getStrPtr(), pVal->getStrLen(), L("true"), -1, bCaseSens))
                 {
                     bVal = true;
                     bRes = true;
                 }
-                else if(JSON_NODE::compareStringsEqual(pVal->strValue, L("false"), bCaseSens))
+                else if(JSON_NODE::compareStringsEqual(pVal->getStrPtr(), pVal->getStrLen(), L("false"), -1, bCaseSens))
                 {
                     bVal = false;
                     bRes = true;
@@ -571,10 +1015,15 @@ struct JSON_NODE
         if(isNodeSet())
         {
             ASSERT(pVal);
-            if(pVal->valType == JVT_PLAIN ||
+            if(pVal->nativeType == JNT_NULL)
+            {
+                //Converted when parsed
+                bRes = true;
+            }
+            else if(pVal->valType == JVT_PLAIN ||
                 pVal->valType == JVT_DOUBLE_QUOTED)
             {
-                if(JSON_NODE::compareStringsEqual(pVal->strValue, L("null"), !!bCaseSensitive))
+                if(JSON_NODE::compareStringsEqual(pVal->getStrPtr(), pVal->getStrLen(), L("null"), -1, !!bCaseSensitive))
                 {
                     bRes = true;
                 }
@@ -621,6 +1070,11 @@ struct JSON_NODE
 
     JSON_NODE_TYPE findNodeByIndex(intptr_t nIndex, JSON_NODE* pJNodeFound = nullptr);
     JSON_NODE_TYPE findNodeByIndexAndGetValueAsString(intptr_t nIndex, std_wstring* pOutStr = nullptr);
+    //INFO: The first search by name in an object with JSON_NAME_INDEX_MIN_CNT or more elements builds a hash index of its names
+    //      and attaches it to the object, thus such searches change the data. Searches from several threads at once are safe
+    //      as long as nothing else changes the data (each thread may build the same index, but only one gets attached), yet they
+    //      can't overlap with any other changes to it. An attached index is never changed by searches: adding nodes to the object
+    //      updates it, and removing or renaming them drops it. Call JSON_DATA::freeze() to build all indexes ahead of time instead.
     JSON_NODE_TYPE findNodeByName(LPCTSTR pStrName, JSON_NODE* pJNodeFound, bool bCaseSensitive = false, JSON_SRCH* pJSrch = nullptr);
     JSON_NODE_TYPE findNodeByNameAndGetValueAsString(LPCTSTR pStrName, std_wstring* pOutStr = nullptr, bool bCaseSensitive = false);
     JSON_NODE_TYPE findNodeByNameAndGetValueAsInt32(LPCTSTR pStrName, int* pOuVal = nullptr, bool bCaseSensitive = false);
@@ -629,6 +1083,7 @@ struct JSON_NODE
     bool setAsRootNode(JSON_DATA* pJSON_Data = nullptr);
     bool setAsEmptyNode(JSON_DATA* pJSON_Data = nullptr, JSON_NODE_TYPE type = JNT_OBJECT);
     bool addNode(JSON_NODE* pJNode);
+    bool addNodeMove(JSON_NODE* pJNode);
     bool addNode_String(LPCTSTR pStrName, LPCTSTR pStrValue = nullptr);
     bool addNode_BOOL(LPCTSTR pStrName, bool bValue);
     bool addNode_Bool(LPCTSTR pStrName, bool bValue);
@@ -641,6 +1096,7 @@ struct JSON_NODE
     bool addNode_Double(LPCTSTR pStrName, double fValue);
 
     intptr_t setNodeByName(LPCTSTR pStrName, JSON_NODE* pJNode, bool bCaseSensitive = false);
+    intptr_t setNodeByNameMove(LPCTSTR pStrName, JSON_NODE* pJNode, bool bCaseSensitive = false);
     intptr_t setNodeByName_String(LPCTSTR pStrName, LPCTSTR pStrValue, bool bCaseSensitive = false);
     intptr_t setNodeByName_BOOL(LPCTSTR pStrName, bool bValue, bool bCaseSensitive = false);
     intptr_t setNodeByName_Bool(LPCTSTR pStrName, bool bValue, bool bCaseSensitive = false);
@@ -653,6 +1109,7 @@ struct JSON_NODE
     intptr_t setNodeByName_Double(LPCTSTR pStrName, double fValue, bool bCaseSensitive = false);
 
     bool setNodeByIndex(intptr_t nIndex, JSON_NODE* pJNode);
+    bool setNodeByIndexMove(intptr_t nIndex, JSON_NODE* pJNode);
     bool setNodeByIndex_String(intptr_t nIndex, LPCTSTR pStrValue);
     bool setNodeByIndex_BOOL(intptr_t nIndex, bool bValue);
     bool setNodeByIndex_Bool(intptr_t nIndex, bool bValue);
@@ -666,14 +1123,19 @@ struct JSON_NODE
 
     intptr_t removeNodeByName(LPCTSTR pStrName, bool bCaseSensitive = false);
     bool removeNodeByIndex(intptr_t nIndex);
+    intptr_t removeNodesByNames(LPCTSTR* ppStrNames, intptr_t nCntNames, bool bCaseSensitive = false);
+    intptr_t removeNodesByIndexes(const intptr_t* pIndexes, intptr_t nCntIndexes);
+    intptr_t removeNodesIf(JSON_REMOVE_CALLBACK pfnCallback, void* pCbkParam);
+
+    bool buildNameIndex(bool bDeep = false);
 
     static bool compareStringsEqual(LPCTSTR pStr1, LPCTSTR pStr2, bool bCaseSensitive);
     static bool compareStringsEqual(LPCTSTR pStr1, intptr_t nchLn1, LPCTSTR pStr2, intptr_t nchLn2, bool bCaseSensitive);
     static bool compareStringsEqual(std_wstring& str1, std_wstring& str2, bool bCaseSensitive);
     static bool compareStringsEqual(std_wstring& str1, LPCTSTR pStr2, bool bCaseSensitive);
     
-#ifdef __APPLE__
-    //macOS specific
+#ifdef JSON_UTF8
+    //macOS & POSIX specific
 
     static intptr_t getUtf8Char(const char* pStr,
                                 intptr_t i,
@@ -682,25 +1144,51 @@ struct JSON_NODE
 
     static bool appendUtf8Char(std_wstring& str,
                                 unsigned int z);
+
+    static intptr_t skipAsciiChars(const char* pStr,
+                                   intptr_t i,
+                                   intptr_t nLn);
+
+    static bool isValidUtf8(const char* pStr,
+                            intptr_t nLn);
     
 #endif
     
     
 private:
     bool _addNode_WithType(LPCTSTR pStrName, JSON_VALUE_TYPE type, LPCTSTR pStrValue);
+    bool _addNode_FromNode(JSON_NODE* pJNode, bool bMove);
+    intptr_t _setNodeByName_FromNode(LPCTSTR pStrName, JSON_NODE* pJNode, bool bCaseSensitive, bool bMove);
+    bool _setNodeByIndex_FromNode(intptr_t nIndex, JSON_NODE* pJNode, bool bMove);
     intptr_t _setNodeByName_WithType(LPCTSTR pStrName, JSON_VALUE_TYPE type, LPCTSTR pStrValue, bool bCaseSensitive);
     bool _setNodeByIndex_WithType(intptr_t nIndex, JSON_VALUE_TYPE type, LPCTSTR pStrValue);
+    intptr_t _removeMarkedNodes(const std::vector<bool>& arrMarks);
+    bool _canChange(JSON_DATA* pOtherData = nullptr);
     static void _freeJSON_VALUE(JSON_VALUE& val);
     static bool isIntegerBase10String(LPCTSTR pStr);
     static bool parseFloat(LPCTSTR pStr, double* pfOutVal = nullptr);
+    static int parseInt64(const WCHAR* pStr, intptr_t nch, int64_t* piiOutVal = nullptr);
+    static bool parseDouble(const WCHAR* pStr, intptr_t nch, double* pfOutVal = nullptr);
     static JSON_NODE_TYPE _determineNodeType(JSON_VALUE* pVal);
+    static JSON_NAME_INDEX* _getNameIndex(JSON_OBJECT* pJO, bool bAnySize);
+    static void _updateNameIndex(JSON_NAME_INDEX* pIdx, JSON_OBJECT* pJO);
+    static void _addToNameIndex(JSON_OBJECT* pJO);
+    static void _addToNameChains(JSON_NAME_INDEX::CHAINS& chains, intptr_t nInd, size_t nMask);
+    static intptr_t _findInNameIndex(JSON_NAME_INDEX* pIdx, JSON_OBJECT* pJO, LPCTSTR pStrName, intptr_t nchName, bool bCaseSensitive, intptr_t nFrom);
+    static size_t _getNameHash(const WCHAR* pStr, intptr_t nchLen);
+    static bool _getFoldedNameHash(const WCHAR* pStr, intptr_t nchLen, size_t* pOutHash);
+    static bool _buildNameIndex(JSON_VALUE* pVal, bool bDeep);
+    static bool _freezeJSON_VALUE(JSON_VALUE* pVal);
 
-#ifdef __APPLE__
-    //macOS specific
-    static int _compareStringsEqualNoCase_macOS(const char* pStr1,
+    friend struct JSON_DATA;
+
+#ifdef JSON_UTF8
+    //macOS & POSIX specific
+    static int _compareStringsEqualNoCase_POSIX(const char* pStr1,
                                                 intptr_t ncbStrLen1,
                                                 const char* pStr2,
                                                 intptr_t ncbStrLen2);
+    static unsigned int _toLowerCaseChar_POSIX(unsigned int z);
 
 #endif
 };
@@ -748,17 +1236,63 @@ struct JSON_DATA
 
     JSON_DATA()
     {
+        pArena = nullptr;
+        bOwnArena = false;
+        bFrozen = false;
+        bOnlyInArena = false;
     }
     ~JSON_DATA()
     {
         //Destructor
         emptyData();
+
+        if(bOwnArena)
+        {
+            delete pArena;
+        }
+        else if(pArena)
+        {
+            //Arena can be used by another JSON data now
+            ASSERT(pArena->pUsedBy == this);
+            pArena->pUsedBy = nullptr;
+        }
     }
 
     void emptyData()
     {
         //Frees all data
-        _freeJSON_VALUE(val);
+        //INFO: Data that was parsed into an arena, and wasn't changed since, is freed by resetting the arena, without going through its nodes
+        if(!bOnlyInArena)
+            _freeJSON_VALUE(val);
+
+        val.valType = JVT_NONE;
+        val.pValue = nullptr;
+        val.strValue.clear();
+        val.resetStrRef();
+
+        //Nothing lives in the arena anymore
+        if(pArena)
+            pArena->reset();
+
+        bOnlyInArena = false;
+
+        //Can be changed again
+        bFrozen = false;
+    }
+
+    bool freeze();
+    bool isFrozen()
+    {
+        //RETURN: = true if this JSON data was frozen with freeze() and can't be changed
+        return bFrozen;
+    }
+
+    bool useArena(JSON_ARENA* pUseArena = nullptr, size_t ncbBlockSz = 0x10000);
+
+    JSON_ARENA* getArena()
+    {
+        //RETURN: = Arena that this JSON data allocates its objects and arrays from, or nullptr if it uses the heap
+        return pArena;
     }
 
     bool getRootNode(JSON_NODE* pOutJNode)
@@ -794,9 +1328,17 @@ struct JSON_DATA
     }
 
 private:
+    JSON_ARENA* pArena;			//Arena to allocate objects and arrays from, or nullptr to use the heap
+    bool bOwnArena;				//true if 'pArena' was created by this JSON data
+    bool bFrozen;				//true if this JSON data was frozen with freeze()
+    bool bOnlyInArena;			//true if all of this JSON data is in 'pArena' (except name indexes that the arena keeps track of), i.e. it was parsed into it and not changed since
+
     void _freeJSON_VALUE(JSON_VALUE& val);
     static bool json_toString(JSON_DATA* pJE, JSON_FORMATTING* pJFormat, std_wstring* pOutStr);
 
+    friend class CJSON;
+    friend struct JSON_NODE;
+
 private:
     //Copy constructor and assignments are NOT available!
     JSON_DATA(const JSON_DATA& s) = delete;
@@ -805,6 +1347,23 @@ private:
 
 
 
+enum JSON_PARSE_FLAGS
+{
+    JPF_NONE = 0x0,                     //Default parsing
+    JPF_REFERENCE_SOURCE = 0x1,         //Do not copy names and values without escapes, but point to them in the source JSON string instead
+                                        //INFO: The source JSON string must remain unchanged for as long as the parsed JSON_DATA is used!
+    JPF_NATIVE_VALUES = 0x2,            //Convert numbers, booleans and nulls when parsing, so that reading them later doesn't need to parse their text
+                                        //INFO: Numbers are not kept as text then (unless JPF_KEEP_NUMBER_TEXT is used), so they may be written out differently by toString()
+    JPF_KEEP_NUMBER_TEXT = 0x4,         //With JPF_NATIVE_VALUES: keep text of numbers as well
+};
+
+enum JSON_SIMD_LEVEL
+{
+    JSIMD_NONE,                         //Scan one character at a time
+    JSIMD_SSE2,                         //Use SSE2 to scan 16 bytes at a time
+    JSIMD_AVX2,                         //Use AVX2 to scan 32 bytes at a time
+};
+
 enum JSON_ENCODING
 {
     JENC_ANSI,              //8-byte ANSI encoding (may lead to loss of characters!)
@@ -815,16 +1374,694 @@ enum JSON_ENCODING
 };
 
 
+//Callback that receives serialized JSON from CJSON::toSink()
+//'pData' = next chunk of encoded JSON
+//'ncbDataSz' = size of 'pData' in BYTEs (never 0)
+//'pCbkParam' = parameter that was passed to CJSON::toSink()
+//RETURN:
+//		= true to continue
+//		= false to stop serializing (CJSON::toSink() will fail with the last error set by the callback)
+typedef bool (*JSON_SINK_CALLBACK)(const BYTE* pData, size_t ncbDataSz, void* pCbkParam);
+
+
+//Callback that receives each line parsed by CJSON::parseJSONLines()
+//INFO: It may be called from any of the parsing threads, but never from more than one at a time
+//'nLine' = 0-based index of the line in the input (lines with only white spaces are skipped, but still counted)
+//'nRes' = result of parsing the line (as returned by CJSON::parseJSON())
+//'pJData' = parsed line, if 'nRes' is 1 -- it is freed after the callback returns (use JSON_NODE::addNodeMove() to keep it)
+//'pJError' = details of the parsing error, if 'nRes' is not 1 (its 'nErrIndex' is from the beginning of the line)
+//'pCbkParam' = parameter that was passed to CJSON::parseJSONLines()
+//RETURN:
+//		= true to continue
+//		= false to stop parsing (CJSON::parseJSONLines() will fail with ERROR_CANCELLED)
+typedef bool (*JSON_LINE_CALLBACK)(intptr_t nLine, int nRes, JSON_DATA* pJData, JSON_ERROR* pJError, void* pCbkParam);
 
 
 
+enum JSON_SAX_ACTION
+{
+    JSAX_CONTINUE,                      //Keep parsing
+    JSAX_SKIP,                          //Skip the object or array that was just opened, or the value for the name that was just reported
+                                        //INFO: It is still checked for errors, but no events are sent for it
+    JSAX_ABORT,                         //Stop parsing (CJSON::parseJSONWithHandler() will fail with ERROR_CANCELLED)
+};
+
+struct JSON_SAX_HANDLER
+{
+    //Receives events from CJSON::parseJSONWithHandler() as it goes through JSON, without building JSON_DATA
+    //INFO: Strings passed into it are not null-terminated, and are only valid until the method returns.
+    //INFO: Override only the methods that you need, others just continue.
+    //RETURN: = one of JSAX_* values (JSAX_SKIP is used only by onStartObject(), onStartArray() and onName())
+    virtual ~JSON_SAX_HANDLER()
+    {
+    }
+
+    virtual JSON_SAX_ACTION onStartObject() { return JSAX_CONTINUE; }
+    virtual JSON_SAX_ACTION onEndObject() { return JSAX_CONTINUE; }
+    virtual JSON_SAX_ACTION onStartArray() { return JSAX_CONTINUE; }
+    virtual JSON_SAX_ACTION onEndArray() { return JSAX_CONTINUE; }
+
+    //'pName' = name in the object (unescaped), 'nchLen' = its length in TCHARs
+    virtual JSON_SAX_ACTION onName(const WCHAR* /*pName*/, intptr_t /*nchLen*/) { return JSAX_CONTINUE; }
+
+    //'pStr' = "string" (unescaped) or a plain value that isn't a number, boolean or null, 'nchLen' = its length in TCHARs
+    virtual JSON_SAX_ACTION onString(const WCHAR* /*pStr*/, intptr_t /*nchLen*/) { return JSAX_CONTINUE; }
+
+    //'pNum' = number as it appears in JSON, 'nchLen' = its length in TCHARs
+    //'type' = JNT_INTEGER or JNT_FLOAT
+    virtual JSON_SAX_ACTION onNumber(const WCHAR* /*pNum*/, intptr_t /*nchLen*/, JSON_NODE_TYPE /*type*/) { return JSAX_CONTINUE; }
+
+    virtual JSON_SAX_ACTION onBoolean(bool /*bValue*/) { return JSAX_CONTINUE; }
+    virtual JSON_SAX_ACTION onNull() { return JSAX_CONTINUE; }
+};
+
+
+
+
+
+
+struct JSON_PARSE_CTX
+{
+    //[Used internally] State shared by the parsing functions
+    JSON_ERROR* pJError;				//If not nullptr, receives parsing error details
+    JSON_ARENA* pArena;					//Arena to allocate objects and arrays from, or nullptr to use the heap
+    UINT nFlags;						//Parsing flags, one or more of JPF_* values
+    JSON_SAX_HANDLER* pHandler;			//Handler that receives events, only when parsing with CJSON::parseJSONWithHandler()
+    std_wstring strBuff;				//Buffer for unescaped strings, when parsing with CJSON::parseJSONWithHandler(), or into an arena
+
+    JSON_PARSE_CTX(JSON_ERROR* pJErr = nullptr, JSON_ARENA* pUseArena = nullptr, UINT nParseFlags = JPF_NONE, JSON_SAX_HANDLER* pUseHandler = nullptr)
+    {
+        pJError = pJErr;
+        pArena = pUseArena;
+        nFlags = nParseFlags;
+        pHandler = pUseHandler;
+    }
+};
+
+
+struct JSON_WRITER
+{
+    //[Used internally] Output buffer for CJSON::toString() and CJSON::toSink() that is shared by the serializing functions
+    //INFO: Output is collected in a small fixed buffer that stays in the CPU cache, and is flushed into the output string,
+    //      or encoded and passed to the sink callback, when it fills up
+    JSON_FORMATTING* pJFormat;			//Formatting to use
+    bool bHumanReadable;				//Copy of 'pJFormat->bHumanReadable'
+    bool bFailed;						//true if the sink callback failed, or if output could not be encoded -- the rest of the output is dropped
+    int nOSError;						//[Used if 'bFailed' == true] Error code for the failure
+
+    JSON_WRITER(std_wstring* pOutStr, JSON_FORMATTING* pFormat)
+    {
+        //'pOutStr' = string to write JSON into, or nullptr to discard the output (when only checking the data)
+        //'pFormat' = formatting to use (cannot be nullptr)
+        _init(pFormat);
+        pStr = pOutStr;
+    }
+
+    JSON_WRITER(JSON_SINK_CALLBACK pfnCallback, void* pParam, JSON_ENCODING enc, JSON_FORMATTING* pFormat)
+    {
+        //'pfnCallback' = callback to pass encoded JSON to (cannot be nullptr)
+        //'pParam' = parameter to pass to 'pfnCallback'
+        //'enc' = encoding to convert JSON into before passing it to 'pfnCallback'
+        //'pFormat' = formatting to use (cannot be nullptr)
+        _init(pFormat);
+        pfnSink = pfnCallback;
+        pCbkParam = pParam;
+        encSink = enc;
+    }
+
+    void put(WCHAR c)
+    {
+        if(pCur >= buff + SIZEOF(buff))
+            flush();
+
+        *pCur++ = c;
+    }
+
+    void write(const WCHAR* p, size_t nch)
+    {
+        if((size_t)(buff + SIZEOF(buff) - pCur) < nch)
+        {
+            _writeLong(p, nch);
+            return;
+        }
+
+        memcpy(pCur, p, nch * sizeof(WCHAR));
+        pCur += nch;
+    }
+
+    void writeNewLineIndent(intptr_t nIndent);
+    void flush();
+    bool finish();
+
+private:
+    std_wstring* pStr;					//String that receives the output, or nullptr to discard it (not used with 'pfnSink')
+    JSON_SINK_CALLBACK pfnSink;			//If not nullptr, callback that receives encoded output instead of 'pStr'
+    void* pCbkParam;					//Parameter for 'pfnSink'
+    JSON_ENCODING encSink;				//Encoding to use for 'pfnSink'
+    std::string strEncoded;				//Buffer for the output encoded for 'pfnSink'
+    WCHAR* pCur;						//Where to write next in 'buff'
+    WCHAR buff[0x2000];					//Output that wasn't flushed yet
+    std::vector<std_wstring> arrNewLineIndents;	//[n] = new line followed by 'n' indentation steps, built on demand
+
+    void _init(JSON_FORMATTING* pFormat)
+    {
+        pJFormat = pFormat;
+        bHumanReadable = pFormat->bHumanReadable;
+        bFailed = false;
+        nOSError = NO_ERROR;
+        pStr = nullptr;
+        pfnSink = nullptr;
+        pCbkParam = nullptr;
+        encSink = JENC_UTF_8;
+        pCur = buff;
+    }
+
+    void _writeLong(const WCHAR* p, size_t nch);
+    void _flushToSink(bool bLast);
+    void _setFailed(int nError);
+
+    //No assignment or copy constructor
+    JSON_WRITER(const JSON_WRITER& s) = delete;
+    JSON_WRITER& operator = (const JSON_WRITER& s) = delete;
+};
+
+
+struct JSON_PUSH_PARSER
+{
+    //Incremental parser that takes JSON in pieces (for instance, as it is received from a socket), and produces
+    //the same JSON_DATA and JSON_ERROR as CJSON::parseJSON() would for the whole string
+    //INFO: Index in JSON_ERROR is counted from the beginning of the first piece.
+    //INFO: Pieces can be split anywhere, including in the middle of strings, escapes and UTF-8 sequences.
+    //      Only the incomplete token at the end of a piece is kept until the next one arrives.
+    //INFO: It is not thread-safe.
+
+    JSON_PUSH_PARSER()
+    {
+        pJData = nullptr;
+        pJError = nullptr;
+        nState = PPS_NONE;
+        pSlot = nullptr;
+        nFailRes = 0;
+        nPendingBase = 0;
+        nTokenScan = -1;
+    }
+
+    void begin(JSON_DATA& outJEs, JSON_ERROR* pJErr = nullptr);
+    int feed(const WCHAR* pData, intptr_t nchLen);
+    int finish();
+
+private:
+    enum PP_STATE
+    {
+        PPS_NONE,                       //begin() was not called
+        PPS_VALUE,                      //Expecting a value into 'pSlot'
+        PPS_ARRAY_NEXT,                 //Expecting an element, ',' or ']' in the array at the top of 'arrStack'
+        PPS_OBJECT_NEXT,                //Expecting a name, ',' or '}' in the object at the top of 'arrStack'
+        PPS_OBJECT_COLON,               //Expecting ':' after a name in the object at the top of 'arrStack'
+        PPS_AFTER_ROOT,                 //Root value was parsed, only white spaces may follow
+        PPS_DONE,                       //finish() succeeded
+        PPS_FAILED,                     //Parsing failed
+    };
+
+    struct PP_FRAME
+    {
+        JSON_VALUE* pVal;               //Array or object that is being parsed
+        bool bFirst;                    //true if nothing was parsed in it yet
+        bool bGotPreviousComma;         //true if the last thing parsed in it was a comma
+    };
+
+    JSON_DATA* pJData;                  //Data that receives parsed JSON
+    JSON_ERROR* pJError;                //If not nullptr, receives parsing error details
+    JSON_PARSE_CTX ctx;                 //Context for the CJSON parsing functions
+    PP_STATE nState;                    //Parsing state
+    int nFailRes;                       //[Used if 'nState' == PPS_FAILED] What to return from feed() and finish()
+    std::vector<PP_FRAME> arrStack;     //Arrays and objects that are being parsed, from the root
+    JSON_VALUE* pSlot;                  //[Used if 'nState' == PPS_VALUE] Where to parse the next value into
+    std_wstring strPending;             //Unparsed end of the previous pieces
+    intptr_t nPendingBase;              //Index of the first TCHAR in 'strPending' from the beginning of the first piece
+    intptr_t nTokenScan;                //Index (from the beginning of the first piece) to resume looking for the end of an incomplete token from, or -1
+
+    int _parse(const WCHAR* pData, intptr_t nLen, intptr_t nBase, bool bFinal, intptr_t& i);
+    bool _isTokenComplete(const WCHAR* pData, intptr_t i, intptr_t nLen, intptr_t nBase);
+    int _fail(int nRes, intptr_t nIndex, LPCTSTR pErrDesc);
+    int _failWith(int nRes, JSON_ERROR& jErr, intptr_t nBase);
+    void _endValue();
+
+    //No assignment or copy constructor
+    JSON_PUSH_PARSER(const JSON_PUSH_PARSER& s) = delete;
+    JSON_PUSH_PARSER& operator = (const JSON_PUSH_PARSER& s) = delete;
+};
+
+
+
+struct JSON_FILE_MAPPING
+{
+    //Read-only view of a whole file in memory (used by CJSON::parseJSONFile)
+    JSON_FILE_MAPPING()
+    {
+        pData = nullptr;
+        ncbDataSz = 0;
+    }
+    ~JSON_FILE_MAPPING()
+    {
+        close();
+    }
+
+    bool open(LPCTSTR pStrFilePath, uint64_t ncbSzMaxFileSz = 0, bool bSequential = true);
+    void close();
+
+    const BYTE* getData()
+    {
+        //RETURN: = File contents, or nullptr if no file is open, or if it's empty
+        return pData;
+    }
+
+    uint64_t getSize()
+    {
+        //RETURN: = Size of the file in BYTEs
+        return ncbDataSz;
+    }
+
+private:
+    const BYTE* pData;                  //Mapped file contents, or nullptr if none
+    uint64_t ncbDataSz;                 //Size of 'pData' in BYTEs
+
+    //No assignment or copy constructor
+    JSON_FILE_MAPPING(const JSON_FILE_MAPPING& s) = delete;
+    JSON_FILE_MAPPING& operator = (const JSON_FILE_MAPPING& s) = delete;
+};
+
+
+
+struct JSON_SNAPSHOTS_STATE;
+struct JSON_HAZARD;
+
+
+struct JSON_SNAPSHOTS
+{
+    //Holder of the current version of read-only JSON data, that is replaced as a whole (for instance, when a config file is reloaded)
+    //while other threads keep reading it
+    //INFO: Readers never lock: they get the current version with JSON_SNAPSHOT_REF, which keeps it from being deleted until released.
+    //      New versions are published with one atomic pointer swap, and old ones are deleted by the publishing thread once
+    //      no JSON_SNAPSHOT_REF uses them anymore (via hazard pointers.) Only publishing threads lock against each other.
+    JSON_SNAPSHOTS();
+    ~JSON_SNAPSHOTS();
+
+    bool publish(JSON_DATA* pJData);
+    int publishJSON(LPCTSTR pStr, intptr_t nchLen, JSON_ERROR* pJError = nullptr, UINT nParseFlags = JPF_NONE);
+    int publishJSONFile(LPCTSTR pStrFilePath, JSON_ERROR* pJError = nullptr, UINT nParseFlags = JPF_NONE, uint64_t ncbSzMaxFileSz = 0);
+    size_t reclaim();
+
+private:
+    friend struct JSON_SNAPSHOT_REF;
+
+    JSON_SNAPSHOTS_STATE* pState;       //Current version, retired versions and hazard pointers, or nullptr if out of memory
+
+    size_t _reclaimRetired();
+
+    //No assignment or copy constructor
+    JSON_SNAPSHOTS(const JSON_SNAPSHOTS& s) = delete;
+    JSON_SNAPSHOTS& operator = (const JSON_SNAPSHOTS& s) = delete;
+};
+
+
+struct JSON_SNAPSHOT_REF
+{
+    //Reference to the current version of JSON data in JSON_SNAPSHOTS, that keeps it from being deleted until it's released
+    //INFO: It's meant to be used by one reading thread at a time. The same reference can be acquired again to move to the latest version,
+    //      which is faster than using a new one each time.
+    JSON_SNAPSHOT_REF(JSON_SNAPSHOTS* pSnapshots = nullptr)
+    {
+        //'pSnapshots' = if not nullptr, acquire its current version right away
+        pHolder = nullptr;
+        pHazard = nullptr;
+        pJData = nullptr;
+
+        if(pSnapshots)
+            acquire(pSnapshots);
+    }
+    ~JSON_SNAPSHOT_REF()
+    {
+        release();
+    }
+
+    JSON_DATA* acquire(JSON_SNAPSHOTS* pSnapshots);
+    void release();
+
+    JSON_DATA* getData()
+    {
+        //RETURN: = Acquired version of JSON data (it's frozen), or nullptr if none
+        return pJData;
+    }
+
+    bool getRootNode(JSON_NODE* pOutJNode)
+    {
+        //'pOutJNode' = if not nullptr, set it to be root node of the acquired JSON data
+        //RETURN:
+        //		= true if success
+        return pJData ? pJData->getRootNode(pOutJNode) : false;
+    }
+
+private:
+    JSON_SNAPSHOTS* pHolder;            //Holder that 'pHazard' belongs to, or nullptr if none
+    JSON_HAZARD* pHazard;               //Hazard pointer taken from 'pHolder', or nullptr if none
+    JSON_DATA* pJData;                  //Acquired version, or nullptr if none
+
+    //No assignment or copy constructor
+    JSON_SNAPSHOT_REF(const JSON_SNAPSHOT_REF& s) = delete;
+    JSON_SNAPSHOT_REF& operator = (const JSON_SNAPSHOT_REF& s) = delete;
+};
+
+
+
+struct JSON_IMAGE_VALUE;
+struct JSON_IMAGE_ARRAY;
+struct JSON_IMAGE_OBJECT;
+struct JSON_IMAGE_NODE;
+
+
+struct JSON_IMAGE
+{
+    //Read-only view of JSON data saved by CJSON::writeJSONImage() or CJSON::writeJSONImageFile(), that is used right from memory
+    //(or from a memory-mapped file) without parsing it
+    //INFO: The image has no pointers, only offsets, so nothing is read until it's looked up: opening even a large file takes no time,
+    //      and processes that open the same file share its pages. Each offset is checked against the size of the image when it's used.
+    JSON_IMAGE();
+    ~JSON_IMAGE()
+    {
+        close();
+    }
+
+    bool open(LPCTSTR pStrFilePath);
+    bool openData(const BYTE* pData, size_t ncbDataSz);
+    void close();
+
+    bool isOpen()
+    {
+        //RETURN: = true if an image is open
+        return pData != nullptr;
+    }
+
+    bool getRootNode(JSON_IMAGE_NODE* pOutJNode);
+
+private:
+    friend struct JSON_IMAGE_NODE;
+
+    JSON_FILE_MAPPING fileMap;          //Mapped file, if the image was opened from a file
+    const BYTE* pData;                  //Image, or nullptr if none is open
+    uint64_t ncbDataSz;                 //Size of 'pData' in BYTEs
+    JSON_DATA jDataEmpty;               //Never filled: JSON_NODEs made from the image to read values refer to it
+
+    bool _setData(const BYTE* pImageData, uint64_t ncbImageSz);
+    const BYTE* _getBlock(uint64_t nOffset, uint64_t ncbSz, size_t nAlign);
+    const WCHAR* _getString(uint64_t nOffset, uint32_t nchLen);
+    const JSON_IMAGE_ARRAY* _getArray(const JSON_IMAGE_VALUE* pRec);
+    const JSON_IMAGE_OBJECT* _getObject(const JSON_IMAGE_VALUE* pRec);
+    intptr_t _findInIndex(const JSON_IMAGE_OBJECT* pJO, LPCTSTR pStrName, intptr_t nchName, bool bCaseSensitive, intptr_t nFrom);
+
+    //No assignment or copy constructor
+    JSON_IMAGE(const JSON_IMAGE& s) = delete;
+    JSON_IMAGE& operator = (const JSON_IMAGE& s) = delete;
+};
+
+
+struct JSON_IMAGE_NODE
+{
+    //Node in JSON_IMAGE, that is used the same way as JSON_NODE (but can't be changed)
+    //INFO: Values are read the same way as from JSON_NODE that the image was written from, and names and strings are read
+    //      right from the image (so it must stay open while they are used.)
+    JSON_IMAGE_NODE()
+    {
+        pImage = nullptr;
+        pRec = nullptr;
+        pName = nullptr;
+        nchName = 0;
+    }
+
+    bool isNodeSet()
+    {
+        //RETURN: = true if this node is set to point to a node in JSON_IMAGE
+        return (pImage && pRec) ? true : false;
+    }
+
+    LPCTSTR getName(intptr_t* pnchOutLen = nullptr)
+    {
+        //'pnchOutLen' = if not nullptr, receives the length of the name in TCHARs
+        //RETURN: = Null-terminated name of this node in the image ("" if it's not an element of an object)
+        if(pnchOutLen)
+            *pnchOutLen = nchName;
+
+        return pName ? pName : L("");
+    }
+
+    JSON_NODE_TYPE getNodeType();
+    intptr_t getNodeCount();
+    JSON_NODE_TYPE findNodeByIndex(intptr_t nIndex, JSON_IMAGE_NODE* pJNodeFound = nullptr);
+    JSON_NODE_TYPE findNodeByName(LPCTSTR pStrName, JSON_IMAGE_NODE* pJNodeFound, bool bCaseSensitive = false, JSON_SRCH* pJSrch = nullptr);
+    LPCTSTR getValueAsStringPtr(intptr_t* pnchOutLen = nullptr);
+
+    bool getValueAsString(std_wstring* pOutStr)
+    {
+        //Same as JSON_NODE::getValueAsString()
+        JSON_VALUE val;
+        JSON_NODE jNode;
+        _getNode(val, jNode);
+        return jNode.getValueAsString(pOutStr);
+    }
+
+    bool getValueAsInt32(int* pOutVal, bool bCaseSensitive = true)
+    {
+        //Same as JSON_NODE::getValueAsInt32()
+        JSON_VALUE val;
+        JSON_NODE jNode;
+        _getNode(val, jNode);
+        return jNode.getValueAsInt32(pOutVal, bCaseSensitive);
+    }
+
+    bool getValueAsInt64(int64_t* pOutVal, bool bCaseSensitive = true)
+    {
+        //Same as JSON_NODE::getValueAsInt64()
+        JSON_VALUE val;
+        JSON_NODE jNode;
+        _getNode(val, jNode);
+        return jNode.getValueAsInt64(pOutVal, bCaseSensitive);
+    }
+
+    bool getValueAsDouble(double* pOutVal, bool bCaseSensitive = true)
+    {
+        //Same as JSON_NODE::getValueAsDouble()
+        JSON_VALUE val;
+        JSON_NODE jNode;
+        _getNode(val, jNode);
+        return jNode.getValueAsDouble(pOutVal, bCaseSensitive);
+    }
+
+    bool getValueAsBool(bool* pOutBool, bool bCaseSensitive = true)
+    {
+        //Same as JSON_NODE::getValueAsBool()
+        JSON_VALUE val;
+        JSON_NODE jNode;
+        _getNode(val, jNode);
+        return jNode.getValueAsBool(pOutBool, bCaseSensitive);
+    }
+
+    bool isNullValue(bool bCaseSensitive = true)
+    {
+        //Same as JSON_NODE::isNullValue()
+        JSON_VALUE val;
+        JSON_NODE jNode;
+        _getNode(val, jNode);
+        return jNode.isNullValue(bCaseSensitive);
+    }
+
+private:
+    friend struct JSON_IMAGE;
+
+    JSON_IMAGE* pImage;                 //Image that this node is in, or nullptr if not set
+    const JSON_IMAGE_VALUE* pRec;       //Record of the value of this node in 'pImage', or nullptr if not set
+    const WCHAR* pName;                 //Name of this node in 'pImage', or nullptr if none
+    intptr_t nchName;                   //Length of 'pName' in TCHARs
+
+    bool _getNode(JSON_VALUE& val, JSON_NODE& jNode);
+    JSON_NODE_TYPE _setFound(JSON_IMAGE_NODE* pJNodeFound, const JSON_IMAGE_VALUE* pR, const WCHAR* pN, intptr_t nchN);
+};
+
+
+
+struct JSON_TAPE_NODE;
+struct JSON_TAPE_BUILDER;
+
+
+struct JSON_TAPE
+{
+    //Read-only JSON parsed by CJSON::parseJSONTape() into one contiguous tape of 64-bit words and one buffer of strings,
+    //instead of a tree of separately allocated objects and arrays
+    //INFO: Objects and arrays on the tape know where they end, so they are skipped in one step. Nodes are read with JSON_TAPE_NODE
+    //      the same way as with JSON_NODE, but elements are found by going through the ones before them (there is no index of names,
+    //      use JSON_TAPE_NODE::getNextNode() to go through all elements.) It's freed in two deallocations.
+    JSON_TAPE()
+    {
+    }
+
+    void emptyTape()
+    {
+        //Free the whole tape
+        //INFO: Its nodes can't be used after that
+        std::vector<uint64_t>().swap(arrTape);
+        std_wstring().swap(strBuff);
+    }
+
+    bool isEmpty()
+    {
+        //RETURN: = true if nothing was parsed into it
+        return arrTape.empty();
+    }
+
+    size_t getMemorySize()
+    {
+        //RETURN: = Size of memory used by the tape and its strings in BYTEs
+        return arrTape.capacity() * sizeof(uint64_t) + strBuff.capacity() * sizeof(WCHAR);
+    }
+
+    bool getRootNode(JSON_TAPE_NODE* pOutJNode);
+
+private:
+    friend class CJSON;
+    friend struct JSON_TAPE_NODE;
+    friend struct JSON_TAPE_BUILDER;
+
+    std::vector<uint64_t> arrTape;      //Tape of values, beginning from the root (see JSON_TAPE_TAG in JSON.cpp for its layout)
+    std_wstring strBuff;                //Names and strings on the tape, each null-terminated
+    JSON_DATA jDataEmpty;               //Never filled: JSON_NODEs made from the tape to read values refer to it
+
+    //No assignment or copy constructor
+    JSON_TAPE(const JSON_TAPE& s) = delete;
+    JSON_TAPE& operator = (const JSON_TAPE& s) = delete;
+};
+
+
+struct JSON_TAPE_NODE
+{
+    //Node in JSON_TAPE, that is used the same way as JSON_NODE (but can't be changed)
+    //INFO: Values are read the same way as from JSON_NODE parsed from the same JSON. Names and strings are read right from the tape.
+    JSON_TAPE_NODE()
+    {
+        pTape = nullptr;
+        nIndex = 0;
+        pName = nullptr;
+        nchName = 0;
+    }
+
+    bool isNodeSet()
+    {
+        //RETURN: = true if this node is set to point to a node in JSON_TAPE
+        return pTape != nullptr;
+    }
+
+    LPCTSTR getName(intptr_t* pnchOutLen = nullptr)
+    {
+        //'pnchOutLen' = if not nullptr, receives the length of the name in TCHARs
+        //RETURN: = Null-terminated name of this node on the tape ("" if it's not an element of an object)
+        if(pnchOutLen)
+            *pnchOutLen = nchName;
+
+        return pName ? pName : L("");
+    }
+
+    JSON_NODE_TYPE getNodeType();
+    intptr_t getNodeCount();
+    JSON_NODE_TYPE findNodeByIndex(intptr_t nIndex, JSON_TAPE_NODE* pJNodeFound = nullptr);
+    JSON_NODE_TYPE findNodeByName(LPCTSTR pStrName, JSON_TAPE_NODE* pJNodeFound, bool bCaseSensitive = false, JSON_SRCH* pJSrch = nullptr);
+    JSON_NODE_TYPE getNextNode(JSON_TAPE_NODE* pJNodeNext = nullptr);
+    LPCTSTR getValueAsStringPtr(intptr_t* pnchOutLen = nullptr);
+
+    bool getValueAsString(std_wstring* pOutStr)
+    {
+        //Same as JSON_NODE::getValueAsString()
+        JSON_VALUE val;
+        JSON_NODE jNode;
+        _getNode(val, jNode);
+        return jNode.getValueAsString(pOutStr);
+    }
+
+    bool getValueAsInt32(int* pOutVal, bool bCaseSensitive = true)
+    {
+        //Same as JSON_NODE::getValueAsInt32()
+        JSON_VALUE val;
+        JSON_NODE jNode;
+        _getNode(val, jNode);
+        return jNode.getValueAsInt32(pOutVal, bCaseSensitive);
+    }
+
+    bool getValueAsInt64(int64_t* pOutVal, bool bCaseSensitive = true)
+    {
+        //Same as JSON_NODE::getValueAsInt64()
+        JSON_VALUE val;
+        JSON_NODE jNode;
+        _getNode(val, jNode);
+        return jNode.getValueAsInt64(pOutVal, bCaseSensitive);
+    }
+
+    bool getValueAsDouble(double* pOutVal, bool bCaseSensitive = true)
+    {
+        //Same as JSON_NODE::getValueAsDouble()
+        JSON_VALUE val;
+        JSON_NODE jNode;
+        _getNode(val, jNode);
+        return jNode.getValueAsDouble(pOutVal, bCaseSensitive);
+    }
+
+    bool getValueAsBool(bool* pOutBool, bool bCaseSensitive = true)
+    {
+        //Same as JSON_NODE::getValueAsBool()
+        JSON_VALUE val;
+        JSON_NODE jNode;
+        _getNode(val, jNode);
+        return jNode.getValueAsBool(pOutBool, bCaseSensitive);
+    }
+
+    bool isNullValue(bool bCaseSensitive = true)
+    {
+        //Same as JSON_NODE::isNullValue()
+        JSON_VALUE val;
+        JSON_NODE jNode;
+        _getNode(val, jNode);
+        return jNode.isNullValue(bCaseSensitive);
+    }
+
+private:
+    friend struct JSON_TAPE;
+
+    JSON_TAPE* pTape;                   //Tape that this node is in, or nullptr if not set
+    size_t nIndex;                      //Index of the first word of the value of this node in 'pTape'
+    const WCHAR* pName;                 //Name of this node in 'pTape', or nullptr if it's not an element of an object
+    intptr_t nchName;                   //Length of 'pName' in TCHARs
+
+    bool _getNode(JSON_VALUE& val, JSON_NODE& jNode);
+    JSON_NODE_TYPE _setFound(JSON_TAPE_NODE* pJNodeFound, size_t nIndexFound, size_t nIndexName);
+};
+
+
+
+struct JSON_ARRAY_PARSE_STATE;
+struct JSON_MSGPACK_WRITER;
+
 
 class CJSON
 {
 public:
-    static int parseJSON(LPCTSTR pStr, JSON_DATA& outJEs, JSON_ERROR* pJError = nullptr);
+    static int parseJSON(LPCTSTR pStr, JSON_DATA& outJEs, JSON_ERROR* pJError = nullptr, UINT nParseFlags = JPF_NONE);
+    static int parseJSON(LPCTSTR pStr, intptr_t nchLen, JSON_DATA& outJEs, JSON_ERROR* pJError = nullptr, UINT nParseFlags = JPF_NONE);
+    static int parseJSONParallel(LPCTSTR pStr, intptr_t nchLen, JSON_DATA& outJEs, JSON_ERROR* pJError = nullptr, UINT nParseFlags = JPF_NONE, UINT nCntThreads = 0);
+    static int parseJSONFile(LPCTSTR pStrFilePath, JSON_DATA& outJEs, JSON_ERROR* pJError = nullptr, UINT nParseFlags = JPF_NONE, uint64_t ncbSzMaxFileSz = 0, UINT nCntThreads = 1);
+    static int parseJSONLines(LPCTSTR pStr, intptr_t nchLen, JSON_LINE_CALLBACK pfnCallback, void* pCbkParam, UINT nCntThreads = 0, bool bInOrder = true, UINT nParseFlags = JPF_NONE);
+    static int parseJSONLinesFile(LPCTSTR pStrFilePath, JSON_LINE_CALLBACK pfnCallback, void* pCbkParam, UINT nCntThreads = 0, bool bInOrder = true, UINT nParseFlags = JPF_NONE);
+    static int parseJSONWithHandler(LPCTSTR pStr, JSON_SAX_HANDLER& handler, JSON_ERROR* pJError = nullptr);
+    static int parseJSONTape(LPCTSTR pStr, intptr_t nchLen, JSON_TAPE& outTape, JSON_ERROR* pJError = nullptr);
     static bool toString(JSON_DATA* pJE, JSON_FORMATTING* pJFormat = nullptr, std_wstring* pOutStr = nullptr);
     static bool parseFloat(LPCTSTR pStr, double* pfOutVal = nullptr);
+    static bool parseDouble(const WCHAR* pStr, intptr_t nch, double* pfOutVal = nullptr);
+    static int parseInt64(const WCHAR* pStr, intptr_t nch, int64_t* piiOutVal = nullptr);
     static bool isFloatingPointNumberString(LPCTSTR pStr);
     static bool isIntegerBase10String(LPCTSTR pStr);
     static bool getStringForUTF8(LPCTSTR pStr, std::string& strOut);
@@ -847,20 +2084,34 @@ public:
                                           bool* pbOutDataLoss = nullptr
 #endif
                                           );
+    static bool toSink(JSON_DATA* pJE, JSON_SINK_CALLBACK pfnCallback, void* pCbkParam, JSON_ENCODING enc = JENC_UTF_8, JSON_FORMATTING* pJFormat = nullptr, bool bWriteBOM = false);
+    static bool toFile(JSON_DATA* pJE, FILE* pFile, JSON_ENCODING enc = JENC_UTF_8, JSON_FORMATTING* pJFormat = nullptr, bool bWriteBOM = false);
+#ifdef _WIN32
+    static bool toFileHandle(JSON_DATA* pJE, HANDLE hFile, JSON_ENCODING enc = JENC_UTF_8, JSON_FORMATTING* pJFormat = nullptr, bool bWriteBOM = false);
+#elif JSON_UTF8
+    static bool toFileDescriptor(JSON_DATA* pJE, int fd, JSON_ENCODING enc = JENC_UTF_8, JSON_FORMATTING* pJFormat = nullptr, bool bWriteBOM = false);
+#endif
+    static bool writeJSONFile(LPCTSTR pStrFilePath, JSON_DATA* pJE, JSON_ENCODING enc = JENC_UTF_8, JSON_FORMATTING* pJFormat = nullptr);
+    static bool toMsgPack(JSON_DATA* pJE, std::vector<BYTE>* pOutData);
+    static int parseMsgPack(const BYTE* pData, size_t ncbDataSz, JSON_DATA& outJEs, JSON_ERROR* pJError = nullptr);
+    static bool writeJSONImage(JSON_DATA* pJE, std::vector<BYTE>* pOutData);
+    static bool writeJSONImageFile(LPCTSTR pStrFilePath, JSON_DATA* pJE);
     static std_wstring& appendFormat(std_wstring& str, LPCTSTR pszFormat, ...);
     static WCHAR* remove_nulls_from_str(WCHAR* p_str, size_t& szch);
     static std_wstring& lTrim(std_wstring &s);
     static std_wstring& rTrim(std_wstring &s);
     static std_wstring& Trim(std_wstring &s);
+    static JSON_SIMD_LEVEL getSimdLevel();
+    static JSON_SIMD_LEVEL setSimdLevel(JSON_SIMD_LEVEL level);
     
     static int GetLastError()
     {
 #ifdef _WIN32
         //Windows specific
         return ::GetLastError();
-#elif __APPLE__
-        //macOS specific
-        return g_tls_LastErr;
+#elif JSON_UTF8
+        //macOS & POSIX specific
+        return errno;
 #endif
     }
     
@@ -869,9 +2120,9 @@ public:
 #ifdef _WIN32
         //Windows specific
         ::SetLastError(nError);
-#elif __APPLE__
-        //macOS specific
-        g_tls_LastErr = nError;
+#elif JSON_UTF8
+        //macOS & POSIX specific
+        errno = nError;
 #endif
     }
     
@@ -880,13 +2131,12 @@ public:
 private:
     friend struct JSON_DATA;
     friend struct JSON_NODE;
+    friend struct JSON_PUSH_PARSER;
+    friend struct JSON_VALUE;
+    friend struct JSON_TAPE_BUILDER;
     CJSON(void){};
     ~CJSON(void){};
     
-#ifdef __APPLE__
-    static thread_local int g_tls_LastErr;
-#endif
-    
     
 #ifdef _WIN32
     //Windows specific
@@ -907,8 +2157,8 @@ private:
             ::IsCharAlphaNumeric(z);
     }
 
-#elif __APPLE__
-//macOS specific
+#elif JSON_UTF8
+//macOS & POSIX specific
 
     static bool _isWhiteSpace(UINT z)
     {
@@ -932,6 +2182,10 @@ private:
 #endif
 
 
+    static bool _parseDoubleSlow(const WCHAR* pStr, intptr_t nch, double* pfOutVal);
+    static intptr_t _formatInt64(int64_t iiValue, WCHAR* pBuff);
+    static intptr_t _formatDouble(double fValue, WCHAR* pBuff);
+
 	static std_wstring easyFormat(LPCTSTR pszFormat, ...)
 	{
 		//Format the string
@@ -949,9 +2203,9 @@ private:
 		//Windows specific
 		intptr_t nSz = _vscwprintf(pszFormat, args);        
 
-#elif __APPLE__
-		//macOS specific
-		intptr_t nSz = vprintf(pszFormat, args);
+#elif JSON_UTF8
+		//macOS & POSIX specific
+		intptr_t nSz = vsnprintf(nullptr, 0, pszFormat, args);
 #endif
 
 		if(nSz >= 0)
@@ -967,9 +2221,9 @@ private:
 				//Windows specific
 				vswprintf_s(p_buff, nSz + 1, pszFormat, args2);
 
-#elif __APPLE__
+#elif JSON_UTF8
 
-				//macOS specific
+				//macOS & POSIX specific
 				vsnprintf(p_buff, nSz + 1, pszFormat, args2);
 
 #endif
@@ -987,21 +2241,57 @@ private:
 
 		return str;
 	}
+    static JSON_ENCODING _detectFileEncoding(const BYTE* pData, size_t ncbDataSz, int* pncbOutBOM);
+    static bool _findArrayElements(const WCHAR* pData, intptr_t nLen, std::vector<intptr_t>& arrSeps);
+    static void _parseArrayElements(JSON_ARRAY_PARSE_STATE* pState);
     static WCHAR _skipWhiteSpaces(const WCHAR* pData, intptr_t& i, intptr_t nLen);
-    static int _parseForArray(JSON_ARRAY& ja, const WCHAR* pData, intptr_t& i, intptr_t nLen, JSON_ERROR* pJError);
-    static int _parseForObject(JSON_OBJECT& jo, const WCHAR* pData, intptr_t& i, intptr_t nLen, JSON_ERROR* pJError);
-    static int _parseDoubleQuotedString(std_wstring& str, const WCHAR* pData, intptr_t& i, intptr_t nLen, JSON_ERROR* pJError);
-    static int _parseForValue(JSON_VALUE& jv, const WCHAR* pData, intptr_t& i, intptr_t nLen, JSON_ERROR* pJError);
-    static size_t _toString_Value(JSON_VALUE& val, JSON_FORMATTING* pJFormat, std_wstring* pOutStr, intptr_t nIndent);
-    static size_t _escapeDoubleQuotedVal(std_wstring& s, JSON_FORMATTING* pJFormat, std_wstring* pOutStr = nullptr);
+    static intptr_t _findStringSpecialChar(const WCHAR* pData, intptr_t i, intptr_t nLen);
+    static bool _parseHex4(const WCHAR* pHex, UINT* pOutVal);
+    static JSON_SIMD_LEVEL _detectSimdLevel();
+    static int _parseForArray(JSON_ARRAY& ja, const WCHAR* pData, intptr_t& i, intptr_t nLen, JSON_PARSE_CTX* pCtx);
+    static int _parseForObject(JSON_OBJECT& jo, const WCHAR* pData, intptr_t& i, intptr_t nLen, JSON_PARSE_CTX* pCtx);
+    static int _parseDoubleQuotedString(std_wstring& str, const WCHAR*& pStrRef, intptr_t& nchStrRef, const WCHAR* pData, intptr_t& i, intptr_t nLen, JSON_PARSE_CTX* pCtx);
+    static int _parseDoubleQuotedForData(std_wstring& str, const WCHAR*& pStrRef, intptr_t& nchStrRef, const WCHAR* pData, intptr_t& i, intptr_t nLen, JSON_PARSE_CTX* pCtx);
+    static bool _copyToArena(JSON_ARENA* pArena, const WCHAR* pStr, intptr_t nch, const WCHAR*& pStrRef, intptr_t& nchStrRef);
+    static int _parseForValue(JSON_VALUE& jv, const WCHAR* pData, intptr_t& i, intptr_t nLen, JSON_PARSE_CTX* pCtx);
+    static bool _convertPlainValue(JSON_VALUE& jv, const WCHAR* pStr, intptr_t nch, JSON_PARSE_CTX* pCtx);
+    static intptr_t _formatNativeValue(const JSON_VALUE& jv, WCHAR* pBuff);
+    static bool _writeMsgPackValue(const JSON_VALUE& jv, JSON_MSGPACK_WRITER* pWriter);
+    static bool _writeMsgPackPlainValue(const JSON_VALUE& jv, JSON_MSGPACK_WRITER* pWriter);
+    static bool _writeMsgPackString(const WCHAR* pStr, intptr_t nchLen, bool bPlainText, JSON_MSGPACK_WRITER* pWriter);
+    static void _writeMsgPackHeader(BYTE nCode, uint64_t nValue, int ncbValueSz, JSON_MSGPACK_WRITER* pWriter);
+    static void _writeMsgPackSize(size_t nSize, BYTE nFixCode, size_t nFixMax, BYTE nCode8, BYTE nCode16, BYTE nCode32, JSON_MSGPACK_WRITER* pWriter);
+    static bool _isCanonicalInt64(const WCHAR* pStr, intptr_t nchLen, int64_t* piiOutVal);
+    static int _parseMsgPackValue(JSON_VALUE& jv, const BYTE* pData, size_t& i, size_t nLen, JSON_ARENA* pArena, JSON_ERROR* pJError, int nDepth);
+    static bool _readMsgPackString(std_wstring& str, const BYTE* pData, size_t ncbSz);
+    static JSON_NODE_TYPE _getCanonicalPlainValue(const JSON_VALUE& jv, int64_t* piiOutVal, double* pfOutVal);
+    static bool _writeImageValue(const JSON_VALUE& jv, size_t nOffsetRec, std::vector<BYTE>& buff);
+    static bool _writeImageObject(JSON_OBJECT* pJO, size_t nOffsetRec, std::vector<BYTE>& buff);
+    static bool _writeImageString(const WCHAR* pStr, intptr_t nchLen, uint64_t* pnOutOffset, std::vector<BYTE>& buff);
+    static size_t _appendImageBlock(size_t ncbSz, std::vector<BYTE>& buff);
+    static int _skipPlainValue(const WCHAR* pData, intptr_t& i, intptr_t nLen, intptr_t i_delta, JSON_ERROR* pJError);
+    static int _saxParse(const WCHAR* pData, intptr_t nLen, JSON_PARSE_CTX* pCtx);
+    static int _saxParseForArray(const WCHAR* pData, intptr_t& i, intptr_t nLen, JSON_PARSE_CTX* pCtx, bool bSkip);
+    static int _saxParseForObject(const WCHAR* pData, intptr_t& i, intptr_t nLen, JSON_PARSE_CTX* pCtx, bool bSkip);
+    static int _saxParseForValue(const WCHAR* pData, intptr_t& i, intptr_t nLen, JSON_PARSE_CTX* pCtx, bool bSkip);
+    static int _saxPlainValue(const WCHAR* pStr, intptr_t nchLen, intptr_t i, JSON_PARSE_CTX* pCtx);
+    static int _saxResult(JSON_SAX_ACTION action, intptr_t i, JSON_PARSE_CTX* pCtx);
+    static bool _toString_Value(JSON_VALUE& val, JSON_WRITER& jw, intptr_t nIndent);
+    static bool _escapeDoubleQuotedVal(LPCTSTR pStr, intptr_t nLn, JSON_WRITER& jw);
+    static bool _serialize(JSON_DATA* pJE, JSON_WRITER& jw);
+    static const BYTE* _getBOMForEncoding(JSON_ENCODING enc, size_t* pncbOutSz);
+    static JSON_ARRAY* _newJSON_ARRAY(JSON_ARENA* pArena);
+    static JSON_OBJECT* _newJSON_OBJECT(JSON_ARENA* pArena);
     static void _freeJSON_ARRAY(JSON_ARRAY* pJA);
     static void _freeJSON_OBJECT(JSON_OBJECT* pJO);
     static void _freeJSON_VALUE(JSON_VALUE& val);
     static void _describeError(JSON_ERROR* pJError, intptr_t i, LPCTSTR pErrDesc = nullptr);
     static JSON_NODE_TYPE _determineNodeTypeSafe(JSON_VALUE* pVal);
     static JSON_NODE_TYPE _determineNodeType(JSON_VALUE* pVal);
-    static bool _deepCopyJSON_VALUE(JSON_VALUE* pDestV, JSON_VALUE* pSrcV);
-    static bool __copySingleVal(JSON_VALUE* pDestV, JSON_VALUE* pSrcV);
+    static JSON_NODE_TYPE _determinePlainType(const JSON_VALUE* pVal);
+    static bool _deepCopyJSON_VALUE(JSON_VALUE* pDestV, JSON_VALUE* pSrcV, JSON_ARENA* pArena);
+    static bool _moveJSON_VALUE(JSON_VALUE* pDestV, JSON_NODE* pSrcNode, JSON_ARENA* pArena);
+    static bool __copySingleVal(JSON_VALUE* pDestV, JSON_VALUE* pSrcV, JSON_ARENA* pArena);
 };
 
 };
@@ -0,0 +1,2002 @@
+//Benchmark for CJSON
+//
+// (C) 2015, www.dennisbabkin.com
+//
+//Usage:
+//      cjson_bench [-docs N] [-kb N] [-iters N]
+//
+//'-docs' = number of documents to generate for the corpus (64 by default)
+//'-kb' = approximate size of each generated document in KB (64 by default)
+//'-iters' = number of passes over the corpus per measurement (5 by default)
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "JSON.h"
+
+
+using namespace json;
+
+
+
+//Count every heap allocation made by the process
+static std::atomic<size_t> g_nCntAllocs(0);
+
+void* operator new(size_t sz)
+{
+    g_nCntAllocs.fetch_add(1, std::memory_order_relaxed);
+    void* p = malloc(sz ? sz : 1);
+    if(!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t sz)
+{
+    return operator new(sz);
+}
+
+void* operator new(size_t sz, const std::nothrow_t&) noexcept
+{
+    g_nCntAllocs.fetch_add(1, std::memory_order_relaxed);
+    return malloc(sz ? sz : 1);
+}
+
+void* operator new[](size_t sz, const std::nothrow_t& nt) noexcept
+{
+    return operator new(sz, nt);
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+    free(p);
+}
+
+
+
+struct BENCH_RANDOM
+{
+    //Simple deterministic PRNG, so that all runs use the same corpus
+    uint64_t uiState;
+
+    BENCH_RANDOM(uint64_t uiSeed = 0x2545F4914F6CDD1DULL)
+    {
+        uiState = uiSeed;
+    }
+
+    UINT next(UINT nMax)
+    {
+        //RETURN: = Random number in range [0, nMax)
+        uiState ^= uiState << 13;
+        uiState ^= uiState >> 7;
+        uiState ^= uiState << 17;
+        return nMax ? (UINT)(uiState % nMax) : 0;
+    }
+};
+
+
+struct BENCH_CORPUS
+{
+    std::vector<std_wstring> arrDocs;       //Generated JSON documents
+    size_t ncbTotal;                        //Total size of all documents in bytes
+
+    BENCH_CORPUS()
+    {
+        ncbTotal = 0;
+    }
+};
+
+
+static void appendRandomString(std_wstring& str, BENCH_RANDOM& rnd)
+{
+    static LPCTSTR kWords[] = {
+        L("alpha"), L("beta"), L("gamma"), L("delta"), L("request"), L("response"),
+        L("user"), L("session"), L("feature"), L("config"), L("telemetry"), L("value"),
+        L("Wójcik"), L("Guðmundsdóttir"), L("大谷"), L("€"),
+    };
+
+    str += '"';
+
+    UINT nCntWords = 1 + rnd.next(6);
+    for(UINT w = 0; w < nCntWords; w++)
+    {
+        if(w)
+            str += ' ';
+
+        str += kWords[rnd.next(SIZEOF(kWords))];
+    }
+
+    if(rnd.next(8) == 0)
+    {
+        //Some escapes
+        str += L("\\n\\\"\\u00e9");
+    }
+
+    str += '"';
+}
+
+
+static void appendRandomValue(std_wstring& str, BENCH_RANDOM& rnd, int nDepth)
+{
+    UINT nType = rnd.next(nDepth < 4 ? 10 : 7);
+    switch(nType)
+    {
+    case 0:
+    case 1:
+        appendRandomString(str, rnd);
+        break;
+    case 2:
+        CJSON::appendFormat(str, L("%d"), (int)rnd.next(2000000) - 1000000);
+        break;
+    case 3:
+        CJSON::appendFormat(str, L("%u.%03u"), rnd.next(100000), rnd.next(1000));
+        break;
+    case 4:
+        str += rnd.next(2) ? L("true") : L("false");
+        break;
+    case 5:
+        str += L("null");
+        break;
+    case 6:
+        CJSON::appendFormat(str, L("%ue-%u"), 1 + rnd.next(9), rnd.next(30));
+        break;
+    case 7:
+    case 8:
+        {
+            //Object
+            str += L("{\n");
+            UINT nCnt = rnd.next(8);
+            for(UINT i = 0; i < nCnt; i++)
+            {
+                if(i)
+                    str += L(",\n");
+
+                CJSON::appendFormat(str, L("  \"key_%u\": "), rnd.next(50));
+                appendRandomValue(str, rnd, nDepth + 1);
+            }
+            str += L("\n}");
+        }
+        break;
+    default:
+        {
+            //Array
+            str += '[';
+            UINT nCnt = rnd.next(8);
+            for(UINT i = 0; i < nCnt; i++)
+            {
+                if(i)
+                    str += L(", ");
+
+                appendRandomValue(str, rnd, nDepth + 1);
+            }
+            str += ']';
+        }
+        break;
+    }
+}
+
+
+static void generateCorpus(BENCH_CORPUS& corpus, int nCntDocs, size_t ncbDocSz)
+{
+    BENCH_RANDOM rnd;
+
+    for(int d = 0; d < nCntDocs; d++)
+    {
+        std_wstring str = L("{\"records\": [\n");
+
+        for(int r = 0; str.size() * sizeof(WCHAR) < ncbDocSz; r++)
+        {
+            if(r)
+                str += L(",\n");
+
+            CJSON::appendFormat(str, L("{\"id\": %d, \"name\": "), r);
+            appendRandomString(str, rnd);
+            str += L(", \"payload\": ");
+            appendRandomValue(str, rnd, 1);
+            str += '}';
+        }
+
+        str += L("\n]}");
+
+        corpus.ncbTotal += str.size() * sizeof(WCHAR);
+        corpus.arrDocs.push_back(str);
+    }
+}
+
+
+
+static void generateStringCorpus(BENCH_CORPUS& corpus, int nCntDocs, size_t ncbDocSz)
+{
+    //Same as generateCorpus() but with long, mostly ASCII, strings and deep indentation (like logs)
+    BENCH_RANDOM rnd(0x9E3779B97F4A7C15ULL);
+
+    for(int d = 0; d < nCntDocs; d++)
+    {
+        std_wstring str = L("{\"events\": [\n");
+
+        for(int r = 0; str.size() * sizeof(WCHAR) < ncbDocSz; r++)
+        {
+            if(r)
+                str += L(",\n");
+
+            CJSON::appendFormat(str, L("                {\n                    \"seq\": %d,\n                    \"message\": \""), r);
+
+            UINT nCntWords = 20 + rnd.next(60);
+            for(UINT w = 0; w < nCntWords; w++)
+            {
+                if(w)
+                    str += ' ';
+
+                CJSON::appendFormat(str, L("token%u"), rnd.next(100000));
+            }
+
+            if(rnd.next(4) == 0)
+            {
+                str += L(" \\\"quoted\\\" / path\\\\to\\\\file");
+            }
+
+            str += L("\"\n                }");
+        }
+
+        str += L("\n]}");
+
+        corpus.ncbTotal += str.size() * sizeof(WCHAR);
+        corpus.arrDocs.push_back(str);
+    }
+}
+
+
+
+static void generateEscapeCorpus(BENCH_CORPUS& corpus, int nCntDocs, size_t ncbDocSz)
+{
+    //Strings with mostly \uXXXX-escaped non-Latin text (including surrogate pairs), as some loggers emit
+    static LPCTSTR kEscWords[] = {
+        L("\\u041f\\u0440\\u0438\\u0432\\u0435\\u0442"),
+        L("\\u4e2d\\u6587\\u65e5\\u672c"),
+        L("\\u03b1\\u03b2\\u03b3"),
+        L("\\ud83d\\ude00\\ud83d\\udc4d"),
+        L("\\u00e9t\\u00e9"),
+        L("id\\u003d42"),
+    };
+
+    BENCH_RANDOM rnd(0xD1B54A32D192ED03ULL);
+
+    for(int d = 0; d < nCntDocs; d++)
+    {
+        std_wstring str = L("[\n");
+
+        for(int r = 0; str.size() * sizeof(WCHAR) < ncbDocSz; r++)
+        {
+            if(r)
+                str += L(",\n");
+
+            str += L("{\"text\": \"");
+
+            UINT nCntWords = 5 + rnd.next(20);
+            for(UINT w = 0; w < nCntWords; w++)
+            {
+                if(w)
+                    str += ' ';
+
+                str += kEscWords[rnd.next(SIZEOF(kEscWords))];
+            }
+
+            str += L("\"}");
+        }
+
+        str += L("\n]");
+
+        corpus.ncbTotal += str.size() * sizeof(WCHAR);
+        corpus.arrDocs.push_back(str);
+    }
+}
+
+
+
+struct BENCH_RESULT
+{
+    double fSeconds;            //Time it took
+    size_t ncbProcessed;        //Bytes processed
+    size_t nCntAllocs;          //Allocations made
+    size_t nCntDocs;            //Documents processed
+};
+
+
+static void printResult(const char* pName, const BENCH_RESULT& res)
+{
+    printf("%-28s %10.1f MB/s %12.1f allocs/doc\n",
+           pName,
+           res.fSeconds > 0 ? (double)res.ncbProcessed / (1024.0 * 1024.0) / res.fSeconds : 0.0,
+           res.nCntDocs ? (double)res.nCntAllocs / (double)res.nCntDocs : 0.0);
+}
+
+
+static bool benchParse(BENCH_CORPUS& corpus, int nIters, bool bUseArena, UINT nParseFlags, BENCH_RESULT& res)
+{
+    //Time CJSON::parseJSON over the whole corpus
+    //'bUseArena' = true to parse into one JSON_DATA with a reused arena, false to parse into a new JSON_DATA each time
+    //'nParseFlags' = JPF_* flags to parse with
+    memset(&res, 0, sizeof(res));
+
+    JSON_DATA jDataArena;
+    if(bUseArena &&
+        !jDataArena.useArena())
+    {
+        printf("ERROR: Failed to create arena\n");
+        return false;
+    }
+
+    for(int it = 0; it < nIters; it++)
+    {
+        for(size_t d = 0; d < corpus.arrDocs.size(); d++)
+        {
+            size_t nCntAllocs0 = g_nCntAllocs.load();
+            auto tmStart = std::chrono::steady_clock::now();
+
+            {
+                JSON_DATA jData;
+                if(CJSON::parseJSON(corpus.arrDocs[d].c_str(), bUseArena ? jDataArena : jData, nullptr, nParseFlags) != 1)
+                {
+                    printf("ERROR: Failed to parse document %d\n", (int)d);
+                    return false;
+                }
+            }
+
+            res.fSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - tmStart).count();
+            res.nCntAllocs += g_nCntAllocs.load() - nCntAllocs0;
+            res.ncbProcessed += corpus.arrDocs[d].size() * sizeof(WCHAR);
+            res.nCntDocs++;
+        }
+    }
+
+    return true;
+}
+
+
+static bool benchEmptyData(BENCH_CORPUS& corpus, int nIters, bool bUseArena, BENCH_RESULT& res)
+{
+    //Time JSON_DATA::emptyData() for each parsed document of the corpus
+    //'bUseArena' = true to parse into JSON_DATA with an arena, false to parse into one that uses the heap
+    memset(&res, 0, sizeof(res));
+
+    JSON_DATA jData;
+    if(bUseArena &&
+        !jData.useArena())
+    {
+        printf("ERROR: Failed to create arena\n");
+        return false;
+    }
+
+    for(int it = 0; it < nIters; it++)
+    {
+        for(size_t d = 0; d < corpus.arrDocs.size(); d++)
+        {
+            if(CJSON::parseJSON(corpus.arrDocs[d].c_str(), jData) != 1)
+            {
+                printf("ERROR: Failed to parse document %d\n", (int)d);
+                return false;
+            }
+
+            size_t nCntAllocs0 = g_nCntAllocs.load();
+            auto tmStart = std::chrono::steady_clock::now();
+
+            jData.emptyData();
+
+            res.fSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - tmStart).count();
+            res.nCntAllocs += g_nCntAllocs.load() - nCntAllocs0;
+            res.ncbProcessed += corpus.arrDocs[d].size() * sizeof(WCHAR);
+            res.nCntDocs++;
+        }
+    }
+
+    return true;
+}
+
+
+struct BENCH_SAX_HANDLER : public JSON_SAX_HANDLER
+{
+    //Counts values, as a typical "pluck a few fields" job would look at them
+    size_t nCntValues;
+
+    BENCH_SAX_HANDLER()
+    {
+        nCntValues = 0;
+    }
+
+    virtual JSON_SAX_ACTION onString(const WCHAR* /*pStr*/, intptr_t /*nchLen*/) { nCntValues++; return JSAX_CONTINUE; }
+    virtual JSON_SAX_ACTION onNumber(const WCHAR* /*pNum*/, intptr_t /*nchLen*/, JSON_NODE_TYPE /*type*/) { nCntValues++; return JSAX_CONTINUE; }
+    virtual JSON_SAX_ACTION onBoolean(bool /*bValue*/) { nCntValues++; return JSAX_CONTINUE; }
+    virtual JSON_SAX_ACTION onNull() { nCntValues++; return JSAX_CONTINUE; }
+};
+
+static bool benchParseFile(BENCH_CORPUS& corpus, int nIters, bool bMapped, BENCH_RESULT& res)
+{
+    //Time parsing the whole corpus saved as one UTF-8 file
+    //'bMapped' = true to use CJSON::parseJSONFile, false to read it with CJSON::readFileContentsAsString and then parse
+    memset(&res, 0, sizeof(res));
+
+    LPCTSTR pStrPath = L("cjson_bench_file.json");
+
+    std_wstring strAll = L("[");
+    for(size_t d = 0; d < corpus.arrDocs.size(); d++)
+    {
+        if(d)
+            strAll += L(",");
+
+        strAll += corpus.arrDocs[d];
+    }
+    strAll += L("]");
+
+    if(!CJSON::writeFileContentsAsString(pStrPath, &strAll, JENC_UTF_8))
+    {
+        printf("ERROR: Failed to write %s\n", pStrPath);
+        return false;
+    }
+
+    bool bRes = true;
+
+    for(int it = 0; it < nIters; it++)
+    {
+        size_t nCntAllocs0 = g_nCntAllocs.load();
+        auto tmStart = std::chrono::steady_clock::now();
+
+        JSON_DATA jData;
+        if(bMapped)
+        {
+            bRes = CJSON::parseJSONFile(pStrPath, jData) == 1;
+        }
+        else
+        {
+            std_wstring str;
+            bRes = CJSON::readFileContentsAsString(pStrPath, &str) &&
+                CJSON::parseJSON(str.c_str(), jData) == 1;
+        }
+
+        if(!bRes)
+        {
+            printf("ERROR: Failed to parse %s\n", pStrPath);
+            break;
+        }
+
+        res.fSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - tmStart).count();
+        res.nCntAllocs += g_nCntAllocs.load() - nCntAllocs0;
+        res.ncbProcessed += strAll.size() * sizeof(WCHAR);
+        res.nCntDocs++;
+    }
+
+    remove(pStrPath);
+
+    return bRes;
+}
+
+
+static bool benchStartupLookups(BENCH_CORPUS& corpus, int nIters, bool bImage, BENCH_RESULT& res)
+{
+    //Time loading the whole corpus saved in a file, and then looking up one record in each document (as a service would do on startup)
+    //'bImage' = true to save it with CJSON::writeJSONImageFile and open it with JSON_IMAGE, false to save it as UTF-8 and use CJSON::parseJSONFile
+    //INFO: Throughput is counted in the size of JSON text of documents
+    memset(&res, 0, sizeof(res));
+
+    LPCTSTR pStrPath = L("cjson_bench_startup.bin");
+
+    std_wstring strAll = L("[");
+    for(size_t d = 0; d < corpus.arrDocs.size(); d++)
+    {
+        if(d)
+            strAll += L(",");
+
+        strAll += corpus.arrDocs[d];
+    }
+    strAll += L("]");
+
+    bool bRes;
+    if(bImage)
+    {
+        JSON_DATA jData;
+        bRes = CJSON::parseJSON(strAll.c_str(), jData) == 1 &&
+            CJSON::writeJSONImageFile(pStrPath, &jData);
+    }
+    else
+        bRes = CJSON::writeFileContentsAsString(pStrPath, &strAll, JENC_UTF_8);
+
+    if(!bRes)
+    {
+        printf("ERROR: Failed to write %s\n", pStrPath);
+        return false;
+    }
+
+    for(int it = 0; it < nIters && bRes; it++)
+    {
+        size_t nCntAllocs0 = g_nCntAllocs.load();
+        auto tmStart = std::chrono::steady_clock::now();
+
+        int64_t iiSum = 0;
+        int64_t iiVal = 0;
+
+        if(bImage)
+        {
+            JSON_IMAGE img;
+            JSON_IMAGE_NODE jRoot, jDoc, jRecs, jRec;
+            bRes = img.open(pStrPath) &&
+                img.getRootNode(&jRoot);
+
+            for(size_t d = 0; d < corpus.arrDocs.size() && bRes; d++)
+            {
+                bRes = jRoot.findNodeByIndex(d, &jDoc) == JNT_OBJECT &&
+                    jDoc.findNodeByName(L("records"), &jRecs) == JNT_ARRAY &&
+                    jRecs.findNodeByIndex(jRecs.getNodeCount() / 2, &jRec) == JNT_OBJECT &&
+                    jRec.findNodeByName(L("id"), &jRec) == JNT_INTEGER &&
+                    jRec.getValueAsInt64(&iiVal);
+
+                iiSum += iiVal;
+            }
+        }
+        else
+        {
+            JSON_DATA jData;
+            JSON_NODE jRoot, jDoc, jRecs, jRec;
+            bRes = CJSON::parseJSONFile(pStrPath, jData) == 1 &&
+                jData.getRootNode(&jRoot);
+
+            for(size_t d = 0; d < corpus.arrDocs.size() && bRes; d++)
+            {
+                bRes = jRoot.findNodeByIndex(d, &jDoc) == JNT_OBJECT &&
+                    jDoc.findNodeByName(L("records"), &jRecs) == JNT_ARRAY &&
+                    jRecs.findNodeByIndex(jRecs.getNodeCount() / 2, &jRec) == JNT_OBJECT &&
+                    jRec.findNodeByName(L("id"), &jRec) == JNT_INTEGER &&
+                    jRec.getValueAsInt64(&iiVal);
+
+                iiSum += iiVal;
+            }
+        }
+
+        if(!bRes ||
+            iiSum <= 0)
+        {
+            printf("ERROR: Failed to look up records in %s\n", pStrPath);
+            bRes = false;
+            break;
+        }
+
+        res.fSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - tmStart).count();
+        res.nCntAllocs += g_nCntAllocs.load() - nCntAllocs0;
+        res.ncbProcessed += strAll.size() * sizeof(WCHAR);
+        res.nCntDocs++;
+    }
+
+    remove(pStrPath);
+
+    return bRes;
+}
+
+
+static size_t countTreeValues(JSON_NODE& jNode)
+{
+    //Go through all values in 'jNode' and under it, as a job that reads the whole document would do
+    //RETURN: = Number of values (that are not objects or arrays)
+    JSON_NODE_TYPE type = jNode.getNodeType();
+    if(type != JNT_OBJECT &&
+        type != JNT_ARRAY)
+    {
+        return 1;
+    }
+
+    size_t nCnt = 0;
+
+    JSON_NODE jChild;
+    intptr_t nCntNodes = jNode.getNodeCount();
+    for(intptr_t i = 0; i < nCntNodes; i++)
+    {
+        if(jNode.findNodeByIndex(i, &jChild) > JNT_NONE)
+            nCnt += countTreeValues(jChild);
+    }
+
+    return nCnt;
+}
+
+
+static size_t countTapeValues(JSON_TAPE_NODE& jNode)
+{
+    //Same as countTreeValues(), but for a node on the tape
+    JSON_NODE_TYPE type = jNode.getNodeType();
+    if(type != JNT_OBJECT &&
+        type != JNT_ARRAY)
+    {
+        return 1;
+    }
+
+    size_t nCnt = 0;
+
+    JSON_TAPE_NODE jChild;
+    if(jNode.findNodeByIndex(0, &jChild) > JNT_NONE)
+    {
+        do
+        {
+            nCnt += countTapeValues(jChild);
+        }
+        while(jChild.getNextNode(&jChild) > JNT_NONE);
+    }
+
+    return nCnt;
+}
+
+
+static bool benchTape(BENCH_CORPUS& corpus, int nIters, bool bTape, BENCH_RESULT& resParse, BENCH_RESULT& resTraverse, BENCH_RESULT& resFree)
+{
+    //Time parsing, going through all values, and freeing each document of the corpus
+    //'bTape' = true to parse it into JSON_TAPE, false to parse it into JSON_DATA
+    //'resParse', 'resTraverse', 'resFree' = receive results for each of these steps
+    memset(&resParse, 0, sizeof(resParse));
+    memset(&resTraverse, 0, sizeof(resTraverse));
+    memset(&resFree, 0, sizeof(resFree));
+
+    for(int it = 0; it < nIters; it++)
+    {
+        for(size_t d = 0; d < corpus.arrDocs.size(); d++)
+        {
+            size_t ncbDoc = corpus.arrDocs[d].size() * sizeof(WCHAR);
+            size_t nCntValues = 0;
+
+            JSON_DATA* pJData = new JSON_DATA;
+            JSON_TAPE* pTape = new JSON_TAPE;
+
+            //Parse
+            size_t nCntAllocs0 = g_nCntAllocs.load();
+            auto tmStart = std::chrono::steady_clock::now();
+
+            bool bRes = bTape ?
+                CJSON::parseJSONTape(corpus.arrDocs[d].c_str(), -1, *pTape) == 1 :
+                CJSON::parseJSON(corpus.arrDocs[d].c_str(), *pJData) == 1;
+
+            resParse.fSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - tmStart).count();
+            resParse.nCntAllocs += g_nCntAllocs.load() - nCntAllocs0;
+
+            if(!bRes)
+            {
+                printf("ERROR: Failed to parse document %d\n", (int)d);
+                delete pJData;
+                delete pTape;
+                return false;
+            }
+
+            //Go through all values
+            nCntAllocs0 = g_nCntAllocs.load();
+            tmStart = std::chrono::steady_clock::now();
+
+            if(bTape)
+            {
+                JSON_TAPE_NODE jRoot;
+                if(pTape->getRootNode(&jRoot))
+                    nCntValues = countTapeValues(jRoot);
+            }
+            else
+            {
+                JSON_NODE jRoot;
+                if(pJData->getRootNode(&jRoot))
+                    nCntValues = countTreeValues(jRoot);
+            }
+
+            resTraverse.fSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - tmStart).count();
+            resTraverse.nCntAllocs += g_nCntAllocs.load() - nCntAllocs0;
+
+            //Free
+            nCntAllocs0 = g_nCntAllocs.load();
+            tmStart = std::chrono::steady_clock::now();
+
+            delete pJData;
+            delete pTape;
+
+            resFree.fSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - tmStart).count();
+            resFree.nCntAllocs += g_nCntAllocs.load() - nCntAllocs0;
+
+            if(!nCntValues)
+            {
+                printf("ERROR: Failed to go through document %d\n", (int)d);
+                return false;
+            }
+
+            resParse.ncbProcessed += ncbDoc;
+            resTraverse.ncbProcessed += ncbDoc;
+            resFree.ncbProcessed += ncbDoc;
+
+            resParse.nCntDocs++;
+            resTraverse.nCntDocs++;
+            resFree.nCntDocs++;
+        }
+    }
+
+    return true;
+}
+
+
+static bool benchParseParallel(BENCH_CORPUS& corpus, int nIters, UINT nCntThreads, BENCH_RESULT& res)
+{
+    //Time parsing the whole corpus as one root array with CJSON::parseJSONParallel
+    //'nCntThreads' = number of threads to use, or 0 for one per CPU core
+    memset(&res, 0, sizeof(res));
+
+    std_wstring strAll = L("[");
+    for(size_t d = 0; d < corpus.arrDocs.size(); d++)
+    {
+        if(d)
+            strAll += L(",");
+
+        strAll += corpus.arrDocs[d];
+    }
+    strAll += L("]");
+
+    for(int it = 0; it < nIters; it++)
+    {
+        size_t nCntAllocs0 = g_nCntAllocs.load();
+        auto tmStart = std::chrono::steady_clock::now();
+
+        {
+            JSON_DATA jData;
+            if(CJSON::parseJSONParallel(strAll.c_str(), strAll.size(), jData, nullptr, JPF_NONE, nCntThreads) != 1)
+            {
+                printf("ERROR: Failed to parse the root array\n");
+                return false;
+            }
+        }
+
+        res.fSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - tmStart).count();
+        res.nCntAllocs += g_nCntAllocs.load() - nCntAllocs0;
+        res.ncbProcessed += strAll.size() * sizeof(WCHAR);
+        res.nCntDocs++;
+    }
+
+    return true;
+}
+
+
+static void generateJSONLines(std_wstring& strLines, int nCntLines)
+{
+    //Make JSON Lines input with one log record per line
+    BENCH_RANDOM rnd;
+    strLines.clear();
+
+    for(int n = 0; n < nCntLines; n++)
+    {
+        char buff[256];
+        snprintf(buff, sizeof(buff),
+                 "{\"id\":%d,\"ts\":\"2024-05-%02dT%02d:%02d:%02dZ\",\"level\":\"%s\",\"msg\":\"request %d done\","
+                 "\"latency\":%d.%03d,\"tags\":[\"api\",\"v%d\"],\"ok\":%s}\n",
+                 n, (int)rnd.next(28) + 1, (int)rnd.next(24), (int)rnd.next(60), (int)rnd.next(60),
+                 rnd.next(10) ? "info" : "warn", (int)rnd.next(100000),
+                 (int)rnd.next(500), (int)rnd.next(1000), (int)rnd.next(4),
+                 rnd.next(20) ? "true" : "false");
+
+        for(const char* p = buff; *p; p++)
+            strLines += (WCHAR)*p;
+    }
+}
+
+
+static bool countLineCbk(intptr_t /*nLine*/, int nRes, JSON_DATA* /*pJData*/, JSON_ERROR* /*pJError*/, void* pCbkParam)
+{
+    //Count lines that parsed OK
+    if(nRes == 1)
+        (*(size_t*)pCbkParam)++;
+
+    return true;
+}
+
+
+static bool benchJSONLines(const std_wstring& strLines, int nCntLines, int nIters, int nCntThreads, BENCH_RESULT& res)
+{
+    //Time parsing JSON Lines input
+    //'nCntThreads' = number of threads for CJSON::parseJSONLines, or -1 to split lines and call CJSON::parseJSON for each one
+    memset(&res, 0, sizeof(res));
+
+    for(int it = 0; it < nIters; it++)
+    {
+        size_t nCntParsed = 0;
+
+        size_t nCntAllocs0 = g_nCntAllocs.load();
+        auto tmStart = std::chrono::steady_clock::now();
+
+        if(nCntThreads < 0)
+        {
+            for(size_t i = 0; i < strLines.size(); )
+            {
+                size_t nEOL = strLines.find('\n', i);
+                if(nEOL == std_wstring::npos)
+                    nEOL = strLines.size();
+
+                std_wstring strLine(strLines, i, nEOL - i);
+
+                JSON_DATA jData;
+                if(CJSON::parseJSON(strLine.c_str(), jData) == 1)
+                    nCntParsed++;
+
+                i = nEOL + 1;
+            }
+        }
+        else if(CJSON::parseJSONLines(strLines.c_str(), strLines.size(), countLineCbk, &nCntParsed, nCntThreads) != 1)
+        {
+            printf("ERROR: Failed to parse JSON Lines\n");
+            return false;
+        }
+
+        res.fSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - tmStart).count();
+        res.nCntAllocs += g_nCntAllocs.load() - nCntAllocs0;
+        res.ncbProcessed += strLines.size() * sizeof(WCHAR);
+        res.nCntDocs += nCntParsed;
+
+        if(nCntParsed != (size_t)nCntLines)
+        {
+            printf("ERROR: Parsed %d lines out of %d\n", (int)nCntParsed, nCntLines);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+static bool benchSaxParse(BENCH_CORPUS& corpus, int nIters, BENCH_RESULT& res)
+{
+    //Time CJSON::parseJSONWithHandler over the whole corpus
+    memset(&res, 0, sizeof(res));
+
+    BENCH_SAX_HANDLER handler;
+
+    for(int it = 0; it < nIters; it++)
+    {
+        for(size_t d = 0; d < corpus.arrDocs.size(); d++)
+        {
+            size_t nCntAllocs0 = g_nCntAllocs.load();
+            auto tmStart = std::chrono::steady_clock::now();
+
+            if(CJSON::parseJSONWithHandler(corpus.arrDocs[d].c_str(), handler) != 1)
+            {
+                printf("ERROR: Failed to parse document %d\n", (int)d);
+                return false;
+            }
+
+            res.fSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - tmStart).count();
+            res.nCntAllocs += g_nCntAllocs.load() - nCntAllocs0;
+            res.ncbProcessed += corpus.arrDocs[d].size() * sizeof(WCHAR);
+            res.nCntDocs++;
+        }
+    }
+
+    return handler.nCntValues != 0;
+}
+
+
+static bool benchPushParse(BENCH_CORPUS& corpus, int nIters, size_t nchPiece, BENCH_RESULT& res)
+{
+    //Time JSON_PUSH_PARSER over the whole corpus, with documents passed in pieces
+    //'nchPiece' = size of each piece in TCHARs
+    memset(&res, 0, sizeof(res));
+
+    JSON_DATA jData;
+    if(!jData.useArena())
+    {
+        printf("ERROR: Failed to create arena\n");
+        return false;
+    }
+
+    JSON_PUSH_PARSER jpp;
+
+    for(int it = 0; it < nIters; it++)
+    {
+        for(size_t d = 0; d < corpus.arrDocs.size(); d++)
+        {
+            const std_wstring& strDoc = corpus.arrDocs[d];
+
+            size_t nCntAllocs0 = g_nCntAllocs.load();
+            auto tmStart = std::chrono::steady_clock::now();
+
+            jpp.begin(jData);
+
+            int nRes = 1;
+            for(size_t i = 0; i < strDoc.size() && nRes == 1; i += nchPiece)
+            {
+                nRes = jpp.feed(strDoc.c_str() + i, (intptr_t)std::min(nchPiece, strDoc.size() - i));
+            }
+
+            if(nRes != 1 ||
+                jpp.finish() != 1)
+            {
+                printf("ERROR: Failed to push-parse document %d\n", (int)d);
+                return false;
+            }
+
+            res.fSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - tmStart).count();
+            res.nCntAllocs += g_nCntAllocs.load() - nCntAllocs0;
+            res.ncbProcessed += strDoc.size() * sizeof(WCHAR);
+            res.nCntDocs++;
+        }
+    }
+
+    return true;
+}
+
+
+static bool benchFindByName(int nCntMembers, int nIters, bool bCaseSensitive, double* pfOutLookupsPerSec)
+{
+    //Time JSON_NODE::findNodeByName for every member of one large object
+    JSON_DATA jData;
+    JSON_NODE jRoot;
+    if(!jRoot.setAsRootNode(&jData))
+        return false;
+
+    std::vector<std_wstring> arrNames;
+
+    for(int m = 0; m < nCntMembers; m++)
+    {
+        //Names like in a per-user map
+        std_wstring strName = L("user_");
+        for(int v = m; ; v /= 26)
+        {
+            strName += (WCHAR)('a' + v % 26);
+            if(v < 26)
+                break;
+        }
+
+        if(!jRoot.addNode_Int(strName.c_str(), m))
+            return false;
+
+        arrNames.push_back(strName);
+    }
+
+    auto tmStart = std::chrono::steady_clock::now();
+
+    size_t nCntFound = 0;
+    for(int it = 0; it < nIters; it++)
+    {
+        for(size_t m = 0; m < arrNames.size(); m++)
+        {
+            if(jRoot.findNodeByName(arrNames[m].c_str(), nullptr, bCaseSensitive) > JNT_NONE)
+                nCntFound++;
+        }
+    }
+
+    double fSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - tmStart).count();
+    *pfOutLookupsPerSec = fSeconds > 0 ? (double)nCntFound / fSeconds : 0.0;
+
+    return nCntFound == arrNames.size() * nIters;
+}
+
+
+static void lookupFrozenNames(JSON_NODE* pJObj, const std::vector<std_wstring>* pArrNames, int nIters, size_t* pnOutCntFound)
+{
+    //Look up all 'pArrNames' in frozen 'pJObj' 'nIters' times from one thread
+    size_t nCntFound = 0;
+    for(int it = 0; it < nIters; it++)
+    {
+        for(size_t m = 0; m < pArrNames->size(); m++)
+        {
+            int64_t iiVal;
+            if(pJObj->findNodeByNameAndGetValueAsInt64((*pArrNames)[m].c_str(), &iiVal) == JNT_INTEGER &&
+                iiVal == (int64_t)m)
+            {
+                nCntFound++;
+            }
+        }
+    }
+
+    *pnOutCntFound = nCntFound;
+}
+
+
+static bool benchFrozenLookups(int nCntMembers, int nIters, UINT nCntThreads, double* pfOutLookupsPerSec)
+{
+    //Time case-insensitive lookups in a frozen object from 'nCntThreads' threads at once (0 for all cores)
+    //INFO: Each thread makes the same number of lookups, so with linear scaling lookups/s grow with the number of threads.
+    if(!nCntThreads)
+    {
+        nCntThreads = std::thread::hardware_concurrency();
+        if(!nCntThreads)
+            nCntThreads = 1;
+    }
+
+    JSON_DATA jData;
+    JSON_NODE jRoot;
+    if(!jRoot.setAsRootNode(&jData))
+        return false;
+
+    std::vector<std_wstring> arrNames;
+
+    for(int m = 0; m < nCntMembers; m++)
+    {
+        std_wstring strName = L("setting_");
+        for(int v = m; ; v /= 26)
+        {
+            strName += (WCHAR)('a' + v % 26);
+            if(v < 26)
+                break;
+        }
+
+        if(!jRoot.addNode_Int(strName.c_str(), m))
+            return false;
+
+        arrNames.push_back(strName);
+    }
+
+    if(!jData.freeze() ||
+        !jData.getRootNode(&jRoot))
+    {
+        return false;
+    }
+
+    std::vector<std::thread> arrThreads;
+    std::vector<size_t> arrCntFound(nCntThreads, 0);
+
+    auto tmStart = std::chrono::steady_clock::now();
+
+    for(UINT t = 0; t < nCntThreads; t++)
+    {
+        arrThreads.push_back(std::thread(lookupFrozenNames, &jRoot, &arrNames, nIters, &arrCntFound[t]));
+    }
+
+    size_t nCntFound = 0;
+    for(UINT t = 0; t < nCntThreads; t++)
+    {
+        arrThreads[t].join();
+        nCntFound += arrCntFound[t];
+    }
+
+    double fSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - tmStart).count();
+    *pfOutLookupsPerSec = fSeconds > 0 ? (double)nCntFound / fSeconds : 0.0;
+
+    return nCntFound == arrNames.size() * nIters * nCntThreads;
+}
+
+
+struct RELOAD_BENCH
+{
+    //Shared state of reader threads in benchReloadReads()
+    JSON_SNAPSHOTS snaps;               //Config when using snapshots
+    std::mutex mtx;                     //Lock for 'pJData' when not using snapshots
+    JSON_DATA* pJData;                  //Config when not using snapshots
+    bool bUseMutex;                     //true to read 'pJData' under 'mtx', false to read 'snaps'
+    int nCntReads;                      //Number of reads for each thread to make
+    std::atomic<int> nCntRunning;       //Number of reader threads still running
+    std::atomic<size_t> nCntOK;         //Number of successful reads
+};
+
+static void readReloadedConfig(RELOAD_BENCH* pBench)
+{
+    //Read a value from the current config 'nCntReads' times
+    size_t nCntOK = 0;
+    JSON_SNAPSHOT_REF ref;
+
+    for(int r = 0; r < pBench->nCntReads; r++)
+    {
+        JSON_NODE jRoot;
+        int64_t iiVal;
+
+        if(pBench->bUseMutex)
+        {
+            std::lock_guard<std::mutex> lock(pBench->mtx);
+
+            if(pBench->pJData->getRootNode(&jRoot) &&
+                jRoot.findNodeByNameAndGetValueAsInt64(L("timeout"), &iiVal) == JNT_INTEGER)
+            {
+                nCntOK++;
+            }
+        }
+        else
+        {
+            if(ref.acquire(&pBench->snaps) &&
+                ref.getRootNode(&jRoot) &&
+                jRoot.findNodeByNameAndGetValueAsInt64(L("timeout"), &iiVal) == JNT_INTEGER)
+            {
+                nCntOK++;
+            }
+        }
+    }
+
+    pBench->nCntOK += nCntOK;
+    pBench->nCntRunning--;
+}
+
+
+static bool benchReloadReads(UINT nCntReaders, int nCntReads, bool bUseMutex, double* pfOutReadsPerSec)
+{
+    //Time reads of a config from 'nCntReaders' threads (0 for all cores), while this thread keeps reloading it
+    if(!nCntReaders)
+    {
+        nCntReaders = std::thread::hardware_concurrency();
+        if(!nCntReaders)
+            nCntReaders = 1;
+    }
+
+    std_wstring strJSON = L("{\"timeout\": 30, \"hosts\": [");
+    for(int h = 0; h < 100; h++)
+    {
+        char buff[64];
+        snprintf(buff, sizeof(buff), "%s{\"host\": \"node%d.local\", \"port\": %d}", h ? ", " : "", h, 8000 + h);
+        for(const char* p = buff; *p; p++)
+            strJSON += (WCHAR)*p;
+    }
+    strJSON += L("]}");
+
+    RELOAD_BENCH bench;
+    bench.bUseMutex = bUseMutex;
+    bench.nCntReads = nCntReads;
+    bench.nCntRunning = (int)nCntReaders;
+    bench.nCntOK = 0;
+
+    bench.pJData = new (std::nothrow) JSON_DATA;
+    if(!bench.pJData ||
+        CJSON::parseJSON(strJSON.c_str(), *bench.pJData) != 1 ||
+        bench.snaps.publishJSON(strJSON.c_str(), strJSON.size()) != 1)
+    {
+        delete bench.pJData;
+        return false;
+    }
+
+    std::vector<std::thread> arrThreads;
+
+    auto tmStart = std::chrono::steady_clock::now();
+
+    for(UINT t = 0; t < nCntReaders; t++)
+    {
+        arrThreads.push_back(std::thread(readReloadedConfig, &bench));
+    }
+
+    //Reload while they read
+    bool bOK = true;
+    while(bench.nCntRunning > 0 &&
+        bOK)
+    {
+        if(bUseMutex)
+        {
+            JSON_DATA* pNewJData = new (std::nothrow) JSON_DATA;
+            if(pNewJData &&
+                CJSON::parseJSON(strJSON.c_str(), *pNewJData) == 1)
+            {
+                JSON_DATA* pOldJData;
+                {
+                    std::lock_guard<std::mutex> lock(bench.mtx);
+                    pOldJData = bench.pJData;
+                    bench.pJData = pNewJData;
+                }
+
+                delete pOldJData;
+            }
+            else
+            {
+                delete pNewJData;
+                bOK = false;
+            }
+        }
+        else
+        {
+            bOK = bench.snaps.publishJSON(strJSON.c_str(), strJSON.size()) == 1;
+        }
+
+        std::this_thread::yield();
+    }
+
+    for(UINT t = 0; t < nCntReaders; t++)
+    {
+        arrThreads[t].join();
+    }
+
+    double fSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - tmStart).count();
+    *pfOutReadsPerSec = fSeconds > 0 ? (double)bench.nCntOK / fSeconds : 0.0;
+
+    delete bench.pJData;
+
+    return bOK &&
+        bench.nCntOK == (size_t)nCntReads * nCntReaders;
+}
+
+
+static bool benchScrubNames(int nCntMembers, int nIters, bool bBatch, double* pfOutMembersPerSec)
+{
+    //Time removing a set of names (with many repeats) from one large object
+    //'bBatch' = true to remove them with one call to JSON_NODE::removeNodesByNames, false to call JSON_NODE::removeNodeByName for each name
+    static LPCTSTR kNames[] = {
+        L("ssn"), L("email"), L("phone"), L("address"), L("birth_date"), L("passport"), L("card_number"), L("ip_addr"),
+    };
+
+    std_wstring strJSON = L("{");
+    for(int m = 0; m < nCntMembers; m++)
+    {
+        if(m)
+            strJSON += L(", ");
+
+        char buff[64];
+        if(m % 10 == 0)
+        {
+            strJSON += L("\"");
+            strJSON += kNames[(m / 10) % SIZEOF(kNames)];
+            snprintf(buff, sizeof(buff), "\": %d", m);
+        }
+        else
+            snprintf(buff, sizeof(buff), "\"field_%d\": %d", m, m);
+
+        for(const char* p = buff; *p; p++)
+            strJSON += (WCHAR)*p;
+    }
+    strJSON += L("}");
+
+    double fSeconds = 0;
+    size_t nCntRemoved = 0;
+
+    for(int it = 0; it < nIters; it++)
+    {
+        JSON_DATA jData;
+        JSON_NODE jRoot;
+        if(CJSON::parseJSON(strJSON.c_str(), jData) != 1 ||
+            !jData.getRootNode(&jRoot))
+            return false;
+
+        auto tmStart = std::chrono::steady_clock::now();
+
+        if(bBatch)
+        {
+            intptr_t nCntDel = jRoot.removeNodesByNames(kNames, SIZEOF(kNames), true);
+            if(nCntDel < 0)
+                return false;
+
+            nCntRemoved += nCntDel;
+        }
+        else
+        {
+            for(size_t n = 0; n < SIZEOF(kNames); n++)
+            {
+                intptr_t nCntDel = jRoot.removeNodeByName(kNames[n], true);
+                if(nCntDel < 0)
+                    return false;
+
+                nCntRemoved += nCntDel;
+            }
+        }
+
+        fSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - tmStart).count();
+    }
+
+    *pfOutMembersPerSec = fSeconds > 0 ? (double)nCntMembers * nIters / fSeconds : 0.0;
+
+    return nCntRemoved == (size_t)((nCntMembers + 9) / 10) * nIters;
+}
+
+
+static void generateNumberArray(std_wstring& strJSON, int nCntNumbers)
+{
+    //Make JSON array of 'nCntNumbers' integers and floating point numbers
+    BENCH_RANDOM rnd;
+    strJSON = L("[");
+
+    for(int n = 0; n < nCntNumbers; n++)
+    {
+        char buff[64];
+        if(n & 1)
+            snprintf(buff, sizeof(buff), "%s%d", n ? "," : "", (int)rnd.next(1000000));
+        else
+            snprintf(buff, sizeof(buff), "%s%d.%03d", n ? "," : "", (int)rnd.next(10000), (int)rnd.next(1000));
+
+        for(const char* p = buff; *p; p++)
+            strJSON += (WCHAR)*p;
+    }
+
+    strJSON += L("]");
+}
+
+
+static bool benchFindByIndex(int nCntNumbers, int nIters, double* pfOutLookupsPerSec)
+{
+    //Time JSON_NODE::findNodeByIndex for every element of a large array of numbers
+    std_wstring strJSON;
+    generateNumberArray(strJSON, nCntNumbers);
+
+    JSON_DATA jData;
+    JSON_NODE jRoot, jNode;
+    if(CJSON::parseJSON(strJSON.c_str(), jData) != 1 ||
+        !jData.getRootNode(&jRoot))
+        return false;
+
+    auto tmStart = std::chrono::steady_clock::now();
+
+    size_t nCntNumbersFound = 0;
+    for(int it = 0; it < nIters; it++)
+    {
+        for(int n = 0; n < nCntNumbers; n++)
+        {
+            JSON_NODE_TYPE type = jRoot.findNodeByIndex(n, &jNode);
+            if(type == JNT_INTEGER ||
+                type == JNT_FLOAT)
+                nCntNumbersFound++;
+        }
+    }
+
+    double fSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - tmStart).count();
+    *pfOutLookupsPerSec = fSeconds > 0 ? (double)nCntNumbersFound / fSeconds : 0.0;
+
+    return nCntNumbersFound == (size_t)nCntNumbers * nIters;
+}
+
+
+static bool benchReadNumbers(int nCntNumbers, int nIters, UINT nParseFlags, double* pfOutReadsPerSec)
+{
+    //Time reading every number of a large array with JSON_NODE::getValueAsDouble, after parsing it with 'nParseFlags'
+    std_wstring strJSON;
+    generateNumberArray(strJSON, nCntNumbers);
+
+    JSON_DATA jData;
+    JSON_NODE jRoot, jNode;
+    if(CJSON::parseJSON(strJSON.c_str(), jData, nullptr, nParseFlags) != 1 ||
+        !jData.getRootNode(&jRoot))
+        return false;
+
+    auto tmStart = std::chrono::steady_clock::now();
+
+    size_t nCntRead = 0;
+    double fSum = 0.0;
+    for(int it = 0; it < nIters; it++)
+    {
+        for(int n = 0; n < nCntNumbers; n++)
+        {
+            double fVal;
+            if(jRoot.findNodeByIndex(n, &jNode) > JNT_NONE &&
+                jNode.getValueAsDouble(&fVal))
+            {
+                fSum += fVal;
+                nCntRead++;
+            }
+        }
+    }
+
+    double fSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - tmStart).count();
+    *pfOutReadsPerSec = fSeconds > 0 ? (double)nCntRead / fSeconds : 0.0;
+
+    return nCntRead == (size_t)nCntNumbers * nIters && fSum >= 0.0;
+}
+
+
+static bool benchAddDoubles(int nCntNumbers, int nIters, bool bUsePrintf, double* pfOutNumbersPerSec)
+{
+    //Time adding floating point numbers to an array with JSON_NODE::addNode_Double
+    //'bUsePrintf' = true to format them with snprintf("%.17g") and add as text, false to pass them as doubles
+    BENCH_RANDOM rnd;
+    std::vector<double> arrNumbers;
+    for(int n = 0; n < nCntNumbers; n++)
+    {
+        arrNumbers.push_back((double)rnd.next(100000000) / (double)(1 + rnd.next(1000)));
+    }
+
+    auto tmStart = std::chrono::steady_clock::now();
+
+    size_t nCntAdded = 0;
+    for(int it = 0; it < nIters; it++)
+    {
+        JSON_DATA jData;
+        JSON_NODE jRoot;
+        if(CJSON::parseJSON(L("[]"), jData) != 1 ||
+            !jData.getRootNode(&jRoot))
+            return false;
+
+        for(size_t n = 0; n < arrNumbers.size(); n++)
+        {
+            bool bAdded;
+            if(bUsePrintf)
+            {
+                char buff[64];
+                snprintf(buff, sizeof(buff), "%.17g", arrNumbers[n]);
+
+                WCHAR wbuff[64];
+                size_t c = 0;
+                for(; buff[c]; c++)
+                    wbuff[c] = (WCHAR)buff[c];
+                wbuff[c] = 0;
+
+                bAdded = jRoot.addNode_Double(nullptr, wbuff);
+            }
+            else
+                bAdded = jRoot.addNode_Double(nullptr, arrNumbers[n]);
+
+            if(bAdded)
+                nCntAdded++;
+        }
+    }
+
+    double fSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - tmStart).count();
+    *pfOutNumbersPerSec = fSeconds > 0 ? (double)nCntAdded / fSeconds : 0.0;
+
+    return nCntAdded == (size_t)nCntNumbers * nIters;
+}
+
+
+static bool benchParseDoubles(int nCntNumbers, int nIters, bool bUseStrtod, double* pfOutNumbersPerSec)
+{
+    //Time parsing floating point numbers with CJSON::parseDouble
+    //'bUseStrtod' = true to use strtod() instead
+    BENCH_RANDOM rnd;
+    std::vector<std::string> arrNumbers;
+    for(int n = 0; n < nCntNumbers; n++)
+    {
+        char buff[64];
+        snprintf(buff, sizeof(buff), "%.*g", 6 + (int)rnd.next(12), (double)rnd.next(100000000) / (double)(1 + rnd.next(1000)));
+        arrNumbers.push_back(buff);
+    }
+
+    std::vector<std_wstring> arrStrs;
+    for(size_t n = 0; n < arrNumbers.size(); n++)
+    {
+        arrStrs.push_back(std_wstring(arrNumbers[n].begin(), arrNumbers[n].end()));
+    }
+
+    auto tmStart = std::chrono::steady_clock::now();
+
+    size_t nCntParsed = 0;
+    double fSum = 0.0;
+    for(int it = 0; it < nIters; it++)
+    {
+        for(size_t n = 0; n < arrNumbers.size(); n++)
+        {
+            double fVal;
+            bool bParsed;
+            if(bUseStrtod)
+            {
+                char* pEnd = nullptr;
+                fVal = strtod(arrNumbers[n].c_str(), &pEnd);
+                bParsed = pEnd && *pEnd == 0;
+            }
+            else
+                bParsed = CJSON::parseDouble(arrStrs[n].c_str(), arrStrs[n].size(), &fVal);
+
+            if(bParsed)
+            {
+                fSum += fVal;
+                nCntParsed++;
+            }
+        }
+    }
+
+    double fSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - tmStart).count();
+    *pfOutNumbersPerSec = fSeconds > 0 ? (double)nCntParsed / fSeconds : 0.0;
+
+    return nCntParsed == (size_t)nCntNumbers * nIters && fSum >= 0.0;
+}
+
+
+static bool benchToString(BENCH_CORPUS& corpus, int nIters, bool bHumanReadable, BENCH_RESULT& res)
+{
+    //Time JSON_DATA::toString over the whole corpus
+    memset(&res, 0, sizeof(res));
+
+    std::vector<JSON_DATA*> arrData;
+    for(size_t d = 0; d < corpus.arrDocs.size(); d++)
+    {
+        JSON_DATA* pJData = new JSON_DATA;
+        if(CJSON::parseJSON(corpus.arrDocs[d].c_str(), *pJData) != 1)
+        {
+            printf("ERROR: Failed to parse document %d\n", (int)d);
+            delete pJData;
+            break;
+        }
+
+        arrData.push_back(pJData);
+    }
+
+    bool bRes = arrData.size() == corpus.arrDocs.size();
+
+    JSON_FORMATTING fmt;
+    fmt.bHumanReadable = bHumanReadable;
+
+    for(int it = 0; it < nIters && bRes; it++)
+    {
+        for(size_t d = 0; d < arrData.size(); d++)
+        {
+            std_wstring str;
+
+            size_t nCntAllocs0 = g_nCntAllocs.load();
+            auto tmStart = std::chrono::steady_clock::now();
+
+            if(!arrData[d]->toString(&fmt, &str))
+            {
+                printf("ERROR: Failed to serialize document %d\n", (int)d);
+                bRes = false;
+                break;
+            }
+
+            res.fSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - tmStart).count();
+            res.nCntAllocs += g_nCntAllocs.load() - nCntAllocs0;
+            res.ncbProcessed += str.size() * sizeof(WCHAR);
+            res.nCntDocs++;
+        }
+    }
+
+    for(size_t d = 0; d < arrData.size(); d++)
+    {
+        delete arrData[d];
+    }
+
+    return bRes;
+}
+
+
+
+static bool benchMsgPack(BENCH_CORPUS& corpus, int nIters, bool bDecode, BENCH_RESULT& res)
+{
+    //Time CJSON::toMsgPack (or CJSON::parseMsgPack) over the whole corpus
+    //INFO: Throughput is counted in the size of JSON text of documents, to compare it with parsing and writing JSON
+    memset(&res, 0, sizeof(res));
+
+    std::vector<JSON_DATA*> arrData;
+    std::vector<std::vector<BYTE> > arrBins;
+    for(size_t d = 0; d < corpus.arrDocs.size(); d++)
+    {
+        JSON_DATA* pJData = new JSON_DATA;
+        arrData.push_back(pJData);
+        arrBins.push_back(std::vector<BYTE>());
+
+        if(CJSON::parseJSON(corpus.arrDocs[d].c_str(), *pJData) != 1 ||
+            !CJSON::toMsgPack(pJData, &arrBins[d]))
+        {
+            printf("ERROR: Failed to convert document %d\n", (int)d);
+            break;
+        }
+    }
+
+    bool bRes = arrBins.size() == corpus.arrDocs.size() &&
+        !arrBins.back().empty();
+
+    std::vector<BYTE> arrOut;
+    JSON_DATA jDataOut;
+
+    for(int it = 0; it < nIters && bRes; it++)
+    {
+        for(size_t d = 0; d < arrData.size(); d++)
+        {
+            size_t nCntAllocs0 = g_nCntAllocs.load();
+            auto tmStart = std::chrono::steady_clock::now();
+
+            if(bDecode ? CJSON::parseMsgPack(arrBins[d].data(), arrBins[d].size(), jDataOut) != 1 :
+                !CJSON::toMsgPack(arrData[d], &arrOut))
+            {
+                printf("ERROR: Failed to %s document %d\n", bDecode ? "decode" : "encode", (int)d);
+                bRes = false;
+                break;
+            }
+
+            res.fSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - tmStart).count();
+            res.nCntAllocs += g_nCntAllocs.load() - nCntAllocs0;
+            res.ncbProcessed += corpus.arrDocs[d].size() * sizeof(WCHAR);
+            res.nCntDocs++;
+        }
+    }
+
+    for(size_t d = 0; d < arrData.size(); d++)
+    {
+        delete arrData[d];
+    }
+
+    return bRes;
+}
+
+
+static bool countSinkBytes(const BYTE* /*pData*/, size_t ncbDataSz, void* pCbkParam)
+{
+    //Sink callback that only counts the bytes
+    *(size_t*)pCbkParam += ncbDataSz;
+    return true;
+}
+
+
+static bool benchExport(BENCH_CORPUS& corpus, int nIters, bool bUseSink, JSON_ENCODING enc, BENCH_RESULT& res)
+{
+    //Time exporting JSON_DATA in the 'enc' encoding
+    //'bUseSink' = true to stream through CJSON::toSink, false to use toString followed by CJSON::getStringForEncoding
+    memset(&res, 0, sizeof(res));
+
+    std::vector<JSON_DATA*> arrData;
+    for(size_t d = 0; d < corpus.arrDocs.size(); d++)
+    {
+        JSON_DATA* pJData = new JSON_DATA;
+        if(CJSON::parseJSON(corpus.arrDocs[d].c_str(), *pJData) != 1)
+        {
+            printf("ERROR: Failed to parse document %d\n", (int)d);
+            delete pJData;
+            break;
+        }
+
+        arrData.push_back(pJData);
+    }
+
+    bool bRes = arrData.size() == corpus.arrDocs.size();
+
+    for(int it = 0; it < nIters && bRes; it++)
+    {
+        for(size_t d = 0; d < arrData.size(); d++)
+        {
+            size_t ncbOut = 0;
+
+            size_t nCntAllocs0 = g_nCntAllocs.load();
+            auto tmStart = std::chrono::steady_clock::now();
+
+            if(bUseSink)
+            {
+                bRes = CJSON::toSink(arrData[d], countSinkBytes, &ncbOut, enc);
+            }
+            else
+            {
+                std_wstring str;
+                std::string strEnc;
+                bRes = arrData[d]->toString(nullptr, &str) &&
+                    CJSON::getStringForEncoding(str.c_str(), enc, strEnc);
+
+                ncbOut = strEnc.size();
+            }
+
+            if(!bRes)
+            {
+                printf("ERROR: Failed to export document %d\n", (int)d);
+                break;
+            }
+
+            res.fSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - tmStart).count();
+            res.nCntAllocs += g_nCntAllocs.load() - nCntAllocs0;
+            res.ncbProcessed += ncbOut;
+            res.nCntDocs++;
+        }
+    }
+
+    for(size_t d = 0; d < arrData.size(); d++)
+    {
+        delete arrData[d];
+    }
+
+    return bRes;
+}
+
+
+
+static bool benchAssemble(BENCH_CORPUS& corpus, int nIters, bool bMove, BENCH_RESULT& res)
+{
+    //Time collecting the whole corpus into one JSON array
+    //'bMove' = true to use JSON_NODE::addNodeMove, false to use JSON_NODE::addNode that copies each document
+    memset(&res, 0, sizeof(res));
+
+    bool bRes = true;
+
+    for(int it = 0; it < nIters && bRes; it++)
+    {
+        std::vector<JSON_DATA*> arrData;
+        for(size_t d = 0; d < corpus.arrDocs.size(); d++)
+        {
+            JSON_DATA* pJData = new JSON_DATA;
+            if(CJSON::parseJSON(corpus.arrDocs[d].c_str(), *pJData) != 1)
+            {
+                printf("ERROR: Failed to parse document %d\n", (int)d);
+                delete pJData;
+                bRes = false;
+                break;
+            }
+
+            arrData.push_back(pJData);
+        }
+
+        JSON_DATA jDataAll;
+        JSON_NODE jAll(&jDataAll, nullptr, JNT_ARRAY);
+
+        for(size_t d = 0; d < arrData.size() && bRes; d++)
+        {
+            JSON_NODE jDoc;
+            arrData[d]->getRootNode(&jDoc);
+
+            size_t nCntAllocs0 = g_nCntAllocs.load();
+            auto tmStart = std::chrono::steady_clock::now();
+
+            if(!(bMove ? jAll.addNodeMove(&jDoc) : jAll.addNode(&jDoc)))
+            {
+                printf("ERROR: Failed to add document %d\n", (int)d);
+                bRes = false;
+                break;
+            }
+
+            res.fSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - tmStart).count();
+            res.nCntAllocs += g_nCntAllocs.load() - nCntAllocs0;
+            res.ncbProcessed += corpus.arrDocs[d].size() * sizeof(WCHAR);
+            res.nCntDocs++;
+        }
+
+        for(size_t d = 0; d < arrData.size(); d++)
+        {
+            delete arrData[d];
+        }
+    }
+
+    return bRes;
+}
+
+
+
+int main(int argc, char* argv[])
+{
+    int nCntDocs = 64;
+    int nKBPerDoc = 64;
+    int nIters = 5;
+
+    for(int a = 1; a + 1 < argc; a += 2)
+    {
+        if(strcmp(argv[a], "-docs") == 0)
+            nCntDocs = atoi(argv[a + 1]);
+        else if(strcmp(argv[a], "-kb") == 0)
+            nKBPerDoc = atoi(argv[a + 1]);
+        else if(strcmp(argv[a], "-iters") == 0)
+            nIters = atoi(argv[a + 1]);
+    }
+
+    if(nCntDocs < 1)
+        nCntDocs = 1;
+    if(nKBPerDoc < 1)
+        nKBPerDoc = 1;
+    if(nIters < 1)
+        nIters = 1;
+
+    BENCH_CORPUS corpus;
+    generateCorpus(corpus, nCntDocs, (size_t)nKBPerDoc * 1024);
+
+    printf("Corpus: %d documents, %.1f MB total, %d iterations\n\n",
+           (int)corpus.arrDocs.size(),
+           (double)corpus.ncbTotal / (1024.0 * 1024.0),
+           nIters);
+
+    BENCH_RESULT res;
+
+    if(!benchParse(corpus, nIters, false, JPF_NONE, res))
+        return 1;
+    printResult("parseJSON", res);
+
+    if(!benchParse(corpus, nIters, true, JPF_NONE, res))
+        return 1;
+    printResult("parseJSON (arena)", res);
+
+    if(!benchParse(corpus, nIters, true, JPF_REFERENCE_SOURCE, res))
+        return 1;
+    printResult("parseJSON (arena, ref src)", res);
+
+    if(!benchParse(corpus, nIters, true, JPF_REFERENCE_SOURCE | JPF_NATIVE_VALUES, res))
+        return 1;
+    printResult("parseJSON (arena, native)", res);
+
+    if(!benchEmptyData(corpus, nIters, false, res))
+        return 1;
+    printResult("emptyData", res);
+
+    if(!benchEmptyData(corpus, nIters, true, res))
+        return 1;
+    printResult("emptyData (arena)", res);
+
+    if(!benchParseFile(corpus, nIters, false, res))
+        return 1;
+    printResult("readFile + parseJSON", res);
+
+    if(!benchParseFile(corpus, nIters, true, res))
+        return 1;
+    printResult("parseJSONFile (mapped)", res);
+
+    if(!benchStartupLookups(corpus, nIters, false, res))
+        return 1;
+    printResult("parseJSONFile + lookups", res);
+
+    if(!benchStartupLookups(corpus, nIters, true, res))
+        return 1;
+    printResult("JSON_IMAGE::open + lookups", res);
+
+    BENCH_RESULT resTraverse, resFree;
+    if(!benchTape(corpus, nIters, false, res, resTraverse, resFree))
+        return 1;
+    printResult("JSON_DATA: parse", res);
+    printResult("JSON_DATA: go through all", resTraverse);
+    printResult("JSON_DATA: free", resFree);
+
+    if(!benchTape(corpus, nIters, true, res, resTraverse, resFree))
+        return 1;
+    printResult("JSON_TAPE: parse", res);
+    printResult("JSON_TAPE: go through all", resTraverse);
+    printResult("JSON_TAPE: free", resFree);
+
+    if(!benchParseParallel(corpus, nIters, 1, res))
+        return 1;
+    printResult("root array (1 thread)", res);
+
+    if(!benchParseParallel(corpus, nIters, 0, res))
+        return 1;
+    printResult("parseJSONParallel", res);
+
+    //JSON Lines
+    std_wstring strLines;
+    generateJSONLines(strLines, 100000);
+
+    if(!benchJSONLines(strLines, 100000, nIters, -1, res))
+        return 1;
+    printResult("parseJSON for each line", res);
+
+    if(!benchJSONLines(strLines, 100000, nIters, 1, res))
+        return 1;
+    printResult("parseJSONLines (1 thread)", res);
+
+    if(!benchJSONLines(strLines, 100000, nIters, 0, res))
+        return 1;
+    printResult("parseJSONLines (all cores)", res);
+
+    if(!benchPushParse(corpus, nIters, 4096, res))
+        return 1;
+    printResult("push parser (4 KB pieces)", res);
+
+    if(!benchSaxParse(corpus, nIters, res))
+        return 1;
+    printResult("parseJSONWithHandler", res);
+
+    //Compare SIMD levels on string-heavy data
+    BENCH_CORPUS corpusStr;
+    generateStringCorpus(corpusStr, nCntDocs, (size_t)nKBPerDoc * 1024);
+
+    static const struct
+    {
+        JSON_SIMD_LEVEL level;
+        const char* pName;
+    }
+    kLevels[] = {
+        { JSIMD_NONE,   "parseJSON strings (scalar)" },
+        { JSIMD_SSE2,   "parseJSON strings (SSE2)" },
+        { JSIMD_AVX2,   "parseJSON strings (AVX2)" },
+    };
+
+    JSON_SIMD_LEVEL levelOrig = CJSON::getSimdLevel();
+
+    for(size_t l = 0; l < SIZEOF(kLevels); l++)
+    {
+        if(CJSON::setSimdLevel(kLevels[l].level) != kLevels[l].level)
+            continue;
+
+        if(!benchParse(corpusStr, nIters, true, JPF_REFERENCE_SOURCE, res))
+            return 1;
+        printResult(kLevels[l].pName, res);
+    }
+
+    CJSON::setSimdLevel(levelOrig);
+
+    //Escape-dense strings
+    BENCH_CORPUS corpusEsc;
+    generateEscapeCorpus(corpusEsc, nCntDocs, (size_t)nKBPerDoc * 1024);
+
+    if(!benchParse(corpusEsc, nIters, true, JPF_NONE, res))
+        return 1;
+    printResult("parseJSON \\u escapes", res);
+
+    if(!benchToString(corpus, nIters, false, res))
+        return 1;
+    printResult("toString (compact)", res);
+
+    if(!benchToString(corpus, nIters, true, res))
+        return 1;
+    printResult("toString (human readable)", res);
+
+    if(!benchMsgPack(corpus, nIters, false, res))
+        return 1;
+    printResult("toMsgPack", res);
+
+    if(!benchMsgPack(corpus, nIters, true, res))
+        return 1;
+    printResult("parseMsgPack", res);
+
+    if(!benchExport(corpus, nIters, false, JENC_UNICODE_16, res))
+        return 1;
+    printResult("toString + UTF-16 encoding", res);
+
+    if(!benchExport(corpus, nIters, true, JENC_UNICODE_16, res))
+        return 1;
+    printResult("toSink (UTF-16)", res);
+
+    if(!benchAssemble(corpus, nIters, false, res))
+        return 1;
+    printResult("addNode (copy documents)", res);
+
+    if(!benchAssemble(corpus, nIters, true, res))
+        return 1;
+    printResult("addNodeMove", res);
+
+    //Lookups in one object with many members
+    double fLookupsPerSec;
+
+    if(!benchFindByName(5000, nIters, true, &fLookupsPerSec))
+        return 1;
+    printf("%-28s %10.2f M lookups/s\n", "findNodeByName (5000)", fLookupsPerSec / 1e6);
+
+    if(!benchFindByName(5000, nIters, false, &fLookupsPerSec))
+        return 1;
+    printf("%-28s %10.2f M lookups/s\n", "findNodeByName (5000, CI)", fLookupsPerSec / 1e6);
+
+    if(!benchFindByIndex(100000, nIters, &fLookupsPerSec))
+        return 1;
+    printf("%-28s %10.2f M lookups/s\n", "findNodeByIndex (numbers)", fLookupsPerSec / 1e6);
+
+    //Lookups in a frozen object from several threads
+    if(!benchFrozenLookups(5000, nIters * 4, 1, &fLookupsPerSec))
+        return 1;
+    printf("%-28s %10.2f M lookups/s\n", "frozen lookups (1 thread)", fLookupsPerSec / 1e6);
+
+    if(!benchFrozenLookups(5000, nIters * 4, 0, &fLookupsPerSec))
+        return 1;
+    printf("%-28s %10.2f M lookups/s\n", "frozen lookups (all cores)", fLookupsPerSec / 1e6);
+
+    //Reading a config while it's reloaded
+    double fConfigReadsPerSec;
+
+    if(!benchReloadReads(0, 200000 * nIters, true, &fConfigReadsPerSec))
+        return 1;
+    printf("%-28s %10.2f M reads/s\n", "reload reads (mutex)", fConfigReadsPerSec / 1e6);
+
+    if(!benchReloadReads(0, 200000 * nIters, false, &fConfigReadsPerSec))
+        return 1;
+    printf("%-28s %10.2f M reads/s\n", "reload reads (snapshots)", fConfigReadsPerSec / 1e6);
+
+    //Removing names
+    double fMembersPerSec;
+
+    if(!benchScrubNames(100000, nIters, false, &fMembersPerSec))
+        return 1;
+    printf("%-28s %10.2f M members/s\n", "removeNodeByName (8 names)", fMembersPerSec / 1e6);
+
+    if(!benchScrubNames(100000, nIters, true, &fMembersPerSec))
+        return 1;
+    printf("%-28s %10.2f M members/s\n", "removeNodesByNames", fMembersPerSec / 1e6);
+
+    //Reading numbers back
+    double fReadsPerSec;
+
+    if(!benchReadNumbers(100000, nIters, JPF_NONE, &fReadsPerSec))
+        return 1;
+    printf("%-28s %10.2f M reads/s\n", "getValueAsDouble", fReadsPerSec / 1e6);
+
+    if(!benchReadNumbers(100000, nIters, JPF_NATIVE_VALUES, &fReadsPerSec))
+        return 1;
+    printf("%-28s %10.2f M reads/s\n", "getValueAsDouble (native)", fReadsPerSec / 1e6);
+
+    //Formatting numbers
+    double fNumbersPerSec;
+
+    if(!benchAddDoubles(100000, nIters, true, &fNumbersPerSec))
+        return 1;
+    printf("%-28s %10.2f M numbers/s\n", "addNode_Double (printf)", fNumbersPerSec / 1e6);
+
+    if(!benchAddDoubles(100000, nIters, false, &fNumbersPerSec))
+        return 1;
+    printf("%-28s %10.2f M numbers/s\n", "addNode_Double", fNumbersPerSec / 1e6);
+
+    if(!benchParseDoubles(100000, nIters, true, &fNumbersPerSec))
+        return 1;
+    printf("%-28s %10.2f M numbers/s\n", "strtod", fNumbersPerSec / 1e6);
+
+    if(!benchParseDoubles(100000, nIters, false, &fNumbersPerSec))
+        return 1;
+    printf("%-28s %10.2f M numbers/s\n", "parseDouble", fNumbersPerSec / 1e6);
+
+    return 0;
+}
@@ -0,0 +1,2954 @@
+//Unit tests for CJSON
+//
+// (C) 2015, www.dennisbabkin.com
+//
+
+#include <stdio.h>
+#include <string.h>
+#include <locale.h>
+#include <math.h>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "JSON.h"
+
+
+using namespace json;
+
+
+static int g_nCntChecks = 0;
+static int g_nCntFailed = 0;
+
+#define CHECK(f)                                                            \
+    do                                                                      \
+    {                                                                       \
+        g_nCntChecks++;                                                     \
+        if(!(f))                                                            \
+        {                                                                   \
+            g_nCntFailed++;                                                 \
+            printf("FAILED: %s:%d: %s\n", __FILE__, __LINE__, #f);          \
+        }                                                                   \
+    }                                                                       \
+    while(0)
+
+
+struct TEST_CASE
+{
+    const char* pName;
+    void (*pfnTest)();
+};
+
+
+
+static std_wstring toCompactString(JSON_DATA& jData)
+{
+    JSON_FORMATTING fmt;
+    fmt.bHumanReadable = false;
+
+    std_wstring str;
+    CHECK(jData.toString(&fmt, &str));
+
+    return str;
+}
+
+
+
+static void test_ParseAndRoundTrip()
+{
+    LPCTSTR pStrJSON = L("{\"name\": \"value\", \"int\": -12, \"flt\": 1.5e3, \"b\": true, \"n\": null, "
+                         "\"arr\": [1, \"two\", [], {}], \"obj\": {\"x\": \"y\"}}");
+
+    JSON_DATA jData;
+    JSON_ERROR jErr;
+    CHECK(CJSON::parseJSON(pStrJSON, jData, &jErr) == 1);
+    CHECK(jErr.isEmpty());
+
+    CHECK(toCompactString(jData) ==
+          L("{\"name\":\"value\",\"int\":-12,\"flt\":1.5e3,\"b\":true,\"n\":null,\"arr\":[1,\"two\",[],{}],\"obj\":{\"x\":\"y\"}}"));
+
+    JSON_NODE jRoot;
+    CHECK(jData.getRootNode(&jRoot));
+    CHECK(jRoot.getNodeType() == JNT_OBJECT);
+    CHECK(jRoot.getNodeCount() == 7);
+
+    JSON_NODE jNode;
+    CHECK(jRoot.findNodeByName(L("int"), &jNode) == JNT_INTEGER);
+
+    int64_t iiVal = 0;
+    CHECK(jNode.getValueAsInt64(&iiVal) && iiVal == -12);
+
+    CHECK(jRoot.findNodeByName(L("flt"), &jNode) == JNT_FLOAT);
+    CHECK(jRoot.findNodeByName(L("b"), &jNode) == JNT_BOOLEAN);
+    CHECK(jRoot.findNodeByName(L("n"), &jNode) == JNT_NULL);
+    CHECK(jRoot.findNodeByName(L("arr"), &jNode) == JNT_ARRAY);
+    CHECK(jNode.getNodeCount() == 4);
+    CHECK(jNode.findNodeByIndex(1) == JNT_STRING);
+    CHECK(jRoot.findNodeByName(L("missing"), &jNode) == JNT_NONE);
+}
+
+
+static void test_ParseErrors()
+{
+    static const struct
+    {
+        LPCTSTR pStrJSON;
+        intptr_t nErrIndex;
+    }
+    kBad[] = {
+        { L(""),                    0 },
+        { L("{\"a\": 1,, \"b\": 2}"), 8 },
+        { L("[1 2]"),               3 },
+        { L("{\"a\" 1}"),           5 },
+        { L("{\"a\": \"x\n\"}"),    8 },
+        { L("[1, 2] 3"),            7 },
+        { L("{\"a\": [1, 2}"),      11 },
+    };
+
+    for(size_t i = 0; i < SIZEOF(kBad); i++)
+    {
+        JSON_DATA jData;
+        JSON_ERROR jErr;
+        CHECK(CJSON::parseJSON(kBad[i].pStrJSON, jData, &jErr) == 0);
+        CHECK(!jErr.isEmpty());
+        CHECK(jErr.nErrIndex == kBad[i].nErrIndex);
+    }
+}
+
+
+static void test_Utf8AndCaseInsensitiveNames()
+{
+    LPCTSTR pStrJSON = L("{\"Ärger\": \"大谷\", \"ЖУК\": 1, \"Name\": \"\\u00e9\\n\"}");
+
+    JSON_DATA jData;
+    CHECK(CJSON::parseJSON(pStrJSON, jData) == 1);
+
+    JSON_NODE jRoot;
+    CHECK(jData.getRootNode(&jRoot));
+
+    std_wstring str;
+    CHECK(jRoot.findNodeByNameAndGetValueAsString(L("ärger"), &str) == JNT_STRING);
+    CHECK(str == L("大谷"));
+
+    CHECK(jRoot.findNodeByName(L("жук"), nullptr, false) == JNT_INTEGER);
+    CHECK(jRoot.findNodeByName(L("жук"), nullptr, true) == JNT_NONE);
+    CHECK(jRoot.findNodeByName(L("NAME"), nullptr, false) == JNT_STRING);
+
+    CHECK(jRoot.findNodeByNameAndGetValueAsString(L("Name"), &str) == JNT_STRING);
+    CHECK(str == L("é\n"));
+    CHECK(jRoot.findNodeByNameAndGetValueAsString(L("NAME"), &str, false) == JNT_STRING);
+    CHECK(jRoot.findNodeByNameAndGetValueAsString(L("NAME"), &str, true) == JNT_NONE);
+
+    CHECK(JSON_NODE::compareStringsEqual(L("ÉCOLE"), L("école"), false));
+    CHECK(!JSON_NODE::compareStringsEqual(L("ÉCOLE"), L("école"), true));
+    CHECK(!JSON_NODE::compareStringsEqual(L("école"), L("écoles"), false));
+}
+
+
+static void test_BuildDocument()
+{
+    JSON_NODE jRoot;
+    JSON_DATA jDataRoot;
+    CHECK(jRoot.setAsRootNode(&jDataRoot));
+
+    JSON_DATA jDataNode;
+    JSON_NODE jNode(&jDataNode, L("employee"), JNT_OBJECT);
+    CHECK(jNode.addNode_String(L("Surname Name"), L("Wójcik")));
+    CHECK(jNode.addNode_Int(L("Age"), 44));
+    CHECK(jNode.addNode_Int64(L("Id"), (int64_t)-9000000000LL));
+    CHECK(jNode.addNode_Bool(L("Married"), true));
+    CHECK(jNode.addNode_Null(L("Spouse")));
+
+    JSON_DATA jDataArr;
+    JSON_NODE jNodeArr(&jDataArr, L("Grades"), JNT_ARRAY);
+    CHECK(jNodeArr.addNode_Int(nullptr, 34));
+    CHECK(jNodeArr.addNode_Int(nullptr, 0));
+    CHECK(jNode.addNode(&jNodeArr));
+
+    CHECK(jRoot.addNode(&jNode));
+
+    CHECK(toCompactString(jDataRoot) ==
+          L("{\"employee\":{\"Surname Name\":\"Wójcik\",\"Age\":44,\"Id\":-9000000000,\"Married\":true,\"Spouse\":null,\"Grades\":[34,0]}}"));
+
+    JSON_NODE jEmp;
+    CHECK(jRoot.findNodeByName(L("employee"), &jEmp) == JNT_OBJECT);
+    CHECK(jEmp.setNodeByName_Int(L("Age"), 45) == 1);
+    CHECK(jEmp.removeNodeByName(L("Spouse")) == 1);
+
+    int nAge = 0;
+    CHECK(jEmp.findNodeByNameAndGetValueAsInt32(L("Age"), &nAge) == JNT_INTEGER && nAge == 45);
+    CHECK(jEmp.getNodeCount() == 5);
+
+    //Human readable output
+    std_wstring strJSON;
+    CHECK(jDataRoot.toString(nullptr, &strJSON));
+    CHECK(strJSON.find(L("\n\t\t\"Age\": 45,\n")) != std_wstring::npos);
+}
+
+
+static void test_Encodings()
+{
+    LPCTSTR pStr = L("Aé€𝄞");
+
+    std::string strA;
+    std_wstring strBack;
+
+    CHECK(CJSON::getStringForEncoding(pStr, JENC_UNICODE_16, strA));
+    CHECK(strA.size() == 10);
+    CHECK(CJSON::getUnicodeStringFromEncoding(strA.data(), strA.size(), JENC_UNICODE_16, &strBack));
+    CHECK(strBack == pStr);
+
+    CHECK(CJSON::getStringForEncoding(pStr, JENC_UNICODE_16BE, strA));
+    CHECK(strA.size() == 10 && strA[0] == 0 && strA[1] == 'A');
+    CHECK(CJSON::getUnicodeStringFromEncoding(strA.data(), strA.size(), JENC_UNICODE_16BE, &strBack));
+    CHECK(strBack == pStr);
+
+    CHECK(CJSON::getStringForEncoding(pStr, JENC_ANSI, strA));
+    CHECK(strA == "A\xE9\x80?");
+    CHECK(CJSON::getUnicodeStringFromEncoding(strA.data(), strA.size(), JENC_ANSI, &strBack));
+    CHECK(strBack == L("Aé€?"));
+
+    CHECK(!CJSON::getUnicodeStringFromEncoding("\xC3", 1, JENC_UTF_8, &strBack));
+}
+
+
+static void test_Files()
+{
+    LPCTSTR pStrPath = L("cjson_tests_file.json");
+
+    std_wstring str = L("{\"a\": \"€\"}");
+    CHECK(CJSON::writeFileContentsAsString(pStrPath, &str, JENC_UNICODE_16BE));
+
+    std_wstring strRead;
+    CHECK(CJSON::readFileContentsAsString(pStrPath, &strRead));
+    CHECK(strRead == str);
+
+    //No BOM
+    CHECK(CJSON::writeFileContents(pStrPath, (const BYTE*)str.c_str(), str.size()));
+    CHECK(CJSON::readFileContentsAsString(pStrPath, &strRead));
+    CHECK(strRead == str);
+
+    remove(pStrPath);
+
+    CHECK(!CJSON::readFileContentsAsString(pStrPath, &strRead));
+    CHECK(CJSON::GetLastError() == ENOENT);
+}
+
+
+static void test_LastError()
+{
+    CJSON::SetLastError(ERROR_INVALID_DATA);
+    CHECK(CJSON::GetLastError() == ERROR_INVALID_DATA);
+
+    JSON_DATA jData;
+    CHECK(CJSON::parseJSON(nullptr, jData) == -1);
+    CHECK(CJSON::GetLastError() == ERROR_INVALID_PARAMETER);
+
+    CHECK(CJSON::parseJSON(L("[]"), jData) == 1);
+    CHECK(CJSON::GetLastError() == 0);
+}
+
+
+static void test_Arena()
+{
+    LPCTSTR pStrJSON = L("{\"a\": [1, {\"b\": [true, null]}, []], \"c\": {}}");
+
+    JSON_DATA jData;
+    CHECK(jData.useArena());
+    CHECK(jData.getArena() != nullptr);
+
+    //Reparse into the same data a few times -- the arena must be recycled
+    size_t ncbReserved = 0;
+    for(int p = 0; p < 3; p++)
+    {
+        CHECK(CJSON::parseJSON(pStrJSON, jData) == 1);
+        CHECK(toCompactString(jData) == L("{\"a\":[1,{\"b\":[true,null]},[]],\"c\":{}}"));
+        CHECK(jData.getArena()->getSizeUsed() > 0);
+
+        if(p == 0)
+            ncbReserved = jData.getArena()->getSizeReserved();
+        else
+            CHECK(jData.getArena()->getSizeReserved() == ncbReserved);
+    }
+
+    //Failed parse must not leave anything behind
+    CHECK(CJSON::parseJSON(L("{\"a\": [1, {\"b\": }]}"), jData) == 0);
+
+    //Edit arena-backed data with nodes from heap-backed data, and the other way around
+    CHECK(CJSON::parseJSON(pStrJSON, jData) == 1);
+
+    JSON_NODE jRoot;
+    CHECK(jData.getRootNode(&jRoot));
+
+    JSON_DATA jDataHeap;
+    JSON_NODE jNodeHeap(&jDataHeap, L("h"), JNT_ARRAY);
+    CHECK(jNodeHeap.addNode_Int(nullptr, 7));
+    CHECK(jRoot.addNode(&jNodeHeap));
+    CHECK(jRoot.setNodeByName(L("c"), &jNodeHeap) == 1);
+    CHECK(jRoot.removeNodeByName(L("a")) == 1);
+
+    CHECK(toCompactString(jData) == L("{\"c\":[7],\"h\":[7]}"));
+
+    JSON_NODE jNodeH;
+    CHECK(jRoot.findNodeByName(L("h"), &jNodeH) == JNT_ARRAY);
+
+    JSON_NODE jRootHeap;
+    JSON_DATA jDataHeap2;
+    CHECK(jRootHeap.setAsRootNode(&jDataHeap2));
+    CHECK(jRootHeap.addNode(&jNodeH));
+    CHECK(toCompactString(jDataHeap2) == L("{\"h\":[7]}"));
+
+    //Shared arena, used by one data at a time
+    JSON_ARENA arena(0x100);
+    {
+        JSON_DATA jData1;
+        CHECK(jData1.useArena(&arena));
+        CHECK(CJSON::parseJSON(pStrJSON, jData1) == 1);
+        CHECK(arena.getSizeReserved() >= arena.getSizeUsed());
+    }
+
+    JSON_DATA jData2;
+    CHECK(jData2.useArena(&arena));
+    CHECK(arena.getSizeUsed() == 0);
+    CHECK(CJSON::parseJSON(pStrJSON, jData2) == 1);
+    CHECK(toCompactString(jData2) == L("{\"a\":[1,{\"b\":[true,null]},[]],\"c\":{}}"));
+
+    //Emptying twice must be harmless
+    jData2.emptyData();
+    jData2.emptyData();
+    CHECK(jData2.val.isEmptyValue());
+
+    //Arena can't be used by another data while the first one is still around
+    JSON_ARENA arena2(0x100);
+    JSON_DATA* pJDataA = new JSON_DATA;
+    CHECK(pJDataA->useArena(&arena2));
+    CHECK(CJSON::parseJSON(pStrJSON, *pJDataA) == 1);
+    pJDataA->emptyData();
+
+    JSON_DATA jDataB;
+    CJSON::SetLastError(NO_ERROR);
+    CHECK(!jDataB.useArena(&arena2));
+    CHECK(CJSON::GetLastError() == ERROR_BUSY);
+    CHECK(jDataB.getArena() == nullptr);
+
+    //Not even after it was emptied
+    CHECK(CJSON::parseJSON(pStrJSON, *pJDataA) == 1);
+    CHECK(pJDataA->useArena(&arena2));
+    CHECK(pJDataA->getArena() == &arena2);
+    CHECK(!jDataB.useArena(&arena2));
+
+    //Only after it was deleted
+    CHECK(CJSON::parseJSON(pStrJSON, *pJDataA) == 1);
+    delete pJDataA;
+    CHECK(arena2.getSizeUsed() == 0);
+
+    CHECK(jDataB.useArena(&arena2));
+    CHECK(CJSON::parseJSON(pStrJSON, jDataB) == 1);
+    CHECK(arena2.getSizeUsed() > 0);
+
+    JSON_NODE jRootB;
+    CHECK(jDataB.getRootNode(&jRootB));
+    CHECK(jRootB.addNode_Int(L("d"), 5));
+    CHECK(toCompactString(jDataB) == L("{\"a\":[1,{\"b\":[true,null]},[]],\"c\":{},\"d\":5}"));
+
+    jDataB.emptyData();
+    CHECK(arena2.getSizeUsed() == 0);
+
+    //Elements of objects and arrays come from the arena too
+    CHECK(CJSON::parseJSON(L("[1, 2, 3, {\"a\": 4}]"), jDataB) == 1);
+    JSON_ARRAY* pJA = (JSON_ARRAY*)jDataB.val.pValue;
+    CHECK(pJA && pJA->arrArrElmts.get_allocator().pArena == &arena2);
+    if(pJA && pJA->arrArrElmts.size() == 4)
+    {
+        JSON_OBJECT* pJO = (JSON_OBJECT*)pJA->arrArrElmts[3].val.pValue;
+        CHECK(pJO && pJO->arrObjElmts.get_allocator().pArena == &arena2);
+    }
+
+    //Names and values are put into the arena as well, including unescaped ones
+    std_wstring strLong(100, 'x');
+    std_wstring str = L("{\"long name ") + strLong + L("\": \"") + strLong + L("\", \"esc\\n\": \"a\\tb\", \"\": \"\", \"arr\": [");
+    for(int n = 0; n < 100; n++)
+    {
+        char buff[32];
+        snprintf(buff, sizeof(buff), "%s{\"k%d\": %d.5}", n ? ", " : "", n, n);
+        for(const char* p = buff; *p; p++)
+            str += (WCHAR)*p;
+    }
+    str += L("], \"n\": 12345678901234567890123}");
+
+    JSON_DATA jDataHeap3;
+    CHECK(CJSON::parseJSON(str.c_str(), jDataHeap3) == 1);
+    std_wstring strCompact3 = toCompactString(jDataHeap3);
+
+    JSON_DATA jData3;
+    CHECK(jData3.useArena());
+    for(int p = 0; p < 3; p++)
+    {
+        CHECK(CJSON::parseJSON(str.c_str(), jData3) == 1);
+
+        JSON_OBJECT* pJO = (JSON_OBJECT*)jData3.val.pValue;
+        CHECK(pJO && pJO->arrObjElmts.size() == 5);
+        if(pJO && pJO->arrObjElmts.size() == 5)
+        {
+            for(size_t i = 0; i < pJO->arrObjElmts.size(); i++)
+            {
+                const JSON_OBJECT_ELEMENT& joe = pJO->arrObjElmts[i];
+                CHECK(joe.pNameRef && joe.strName.empty());
+                CHECK(joe.val.valType == JVT_ARRAY || (joe.val.pStrRef && joe.val.strValue.empty()));
+            }
+        }
+
+        JSON_NODE jRoot3, jArr, jElmt;
+        std_wstring strVal;
+        CHECK(jData3.getRootNode(&jRoot3));
+        CHECK(jRoot3.findNodeByNameAndGetValueAsString(L("esc\n"), &strVal) == JNT_STRING);
+        CHECK(strVal == L("a\tb"));
+        CHECK(jRoot3.findNodeByNameAndGetValueAsString((L("long name ") + strLong).c_str(), &strVal) == JNT_STRING);
+        CHECK(strVal == strLong);
+        CHECK(jRoot3.findNodeByName(L("n"), &jElmt) == JNT_INTEGER);
+
+        //Name indexes of objects are deleted with the arena
+        CHECK(jRoot3.buildNameIndex(true));
+        CHECK(jRoot3.findNodeByName(L("arr"), &jArr) == JNT_ARRAY);
+        CHECK(jArr.findNodeByIndex(99, &jElmt) == JNT_OBJECT);
+        CHECK(jElmt.findNodeByName(L("K99"), nullptr) == JNT_FLOAT);
+
+        if(p == 1)
+            CHECK(jData3.freeze());
+
+        CHECK(toCompactString(jData3) == strCompact3);
+    }
+
+    //Changed data is freed node by node
+    JSON_NODE jRoot3;
+    CHECK(jData3.getRootNode(&jRoot3));
+    CHECK(jRoot3.addNode_String(strLong.c_str(), strLong.c_str()));
+    CHECK(jRoot3.removeNodeByName(L("arr")) == 1);
+    jData3.emptyData();
+    CHECK(jData3.getArena()->getSizeUsed() == 0);
+
+    //As well as data that failed to parse
+    CHECK(CJSON::parseJSON((str + L(",")).c_str(), jData3) == 0);
+}
+
+
+static void test_ReferenceSource()
+{
+    std_wstring strSrc = L("{\"plain\": \"Wójcik\", \"esc\": \"a\\tb\", \"Int\": -42, \"f\": 2.5, \"b\": true, \"n\": null, "
+                           "\"arr\": [\"x\", 7, {\"k\\n\": \"v\"}]}");
+
+    JSON_DATA jData;
+    JSON_ERROR jErr;
+    CHECK(CJSON::parseJSON(strSrc.c_str(), jData, &jErr, JPF_REFERENCE_SOURCE) == 1);
+
+    const WCHAR* pSrcBegin = strSrc.c_str();
+    const WCHAR* pSrcEnd = pSrcBegin + strSrc.size();
+
+    //Names and values without escapes must point into the source
+    JSON_OBJECT* pJO = (JSON_OBJECT*)jData.val.pValue;
+    CHECK(pJO && pJO->arrObjElmts.size() == 7);
+    if(pJO && pJO->arrObjElmts.size() == 7)
+    {
+        CHECK(pJO->arrObjElmts[0].pNameRef >= pSrcBegin && pJO->arrObjElmts[0].pNameRef < pSrcEnd);
+        CHECK(pJO->arrObjElmts[0].strName.empty());
+        CHECK(pJO->arrObjElmts[0].val.pStrRef >= pSrcBegin && pJO->arrObjElmts[0].val.pStrRef < pSrcEnd);
+        CHECK(pJO->arrObjElmts[1].val.pStrRef == nullptr);
+        CHECK(pJO->arrObjElmts[1].val.strValue == L("a\tb"));
+        CHECK(pJO->arrObjElmts[2].val.pStrRef != nullptr);
+    }
+
+    CHECK(toCompactString(jData) ==
+          L("{\"plain\":\"Wójcik\",\"esc\":\"a\\tb\",\"Int\":-42,\"f\":2.5,\"b\":true,\"n\":null,\"arr\":[\"x\",7,{\"k\n\":\"v\"}]}"));
+
+    JSON_NODE jRoot;
+    CHECK(jData.getRootNode(&jRoot));
+
+    int64_t iiVal = 0;
+    CHECK(jRoot.findNodeByNameAndGetValueAsInt64(L("int"), &iiVal) == JNT_INTEGER && iiVal == -42);
+    CHECK(jRoot.findNodeByName(L("f"), nullptr) == JNT_FLOAT);
+    CHECK(jRoot.findNodeByName(L("b"), nullptr) == JNT_BOOLEAN);
+    CHECK(jRoot.findNodeByName(L("n"), nullptr) == JNT_NULL);
+
+    std_wstring str;
+    CHECK(jRoot.findNodeByNameAndGetValueAsString(L("PLAIN"), &str) == JNT_STRING);
+    CHECK(str == L("Wójcik"));
+
+    JSON_NODE jNode;
+    CHECK(jRoot.findNodeByName(L("Int"), &jNode) == JNT_INTEGER);
+    CHECK(jNode.strName == L("Int"));
+
+    //Copies into other data must not reference the source
+    JSON_NODE jRoot2;
+    JSON_DATA jData2;
+    CHECK(jRoot2.setAsRootNode(&jData2));
+    CHECK(jRoot.findNodeByName(L("arr"), &jNode) == JNT_ARRAY);
+    CHECK(jRoot2.addNode(&jNode));
+    CHECK(jRoot.findNodeByName(L("plain"), &jNode) == JNT_STRING);
+    CHECK(jRoot2.addNode(&jNode));
+
+    //Editing
+    CHECK(jRoot.setNodeByName_String(L("plain"), L("changed")) == 1);
+    CHECK(jRoot.findNodeByNameAndGetValueAsString(L("plain"), &str) == JNT_STRING && str == L("changed"));
+
+    //Wipe the source
+    strSrc.assign(strSrc.size(), ' ');
+
+    CHECK(toCompactString(jData2) == L("{\"arr\":[\"x\",7,{\"k\n\":\"v\"}],\"plain\":\"Wójcik\"}"));
+}
+
+
+static void test_SimdLevels()
+{
+    //Build strings where special characters land at every offset of a 16 and 32 byte block
+    std_wstring strJSON = L("[");
+    std_wstring strExpected = L("[");
+    for(int n = 0; n < 70; n++)
+    {
+        std_wstring strPad(n, 'a');
+        std_wstring strWS(n, n % 2 ? ' ' : '\t');
+
+        if(n)
+        {
+            strJSON += L(",");
+            strExpected += L(",");
+        }
+
+        strJSON += strWS + L("\"") + strPad + L("\\\"x\"") + strWS + L(",\n") + strWS + L("\"") + strPad + L("é\\n") + strPad + L("\"");
+        strExpected += L("\"") + strPad + L("\\\"x\",\"") + strPad + L("é\\n") + strPad + L("\"");
+    }
+    strJSON += L("\r\n]\r\n");
+    strExpected += L("]");
+
+    JSON_SIMD_LEVEL levelOrig = CJSON::getSimdLevel();
+
+    static const JSON_SIMD_LEVEL kLevels[] = { JSIMD_NONE, JSIMD_SSE2, JSIMD_AVX2 };
+    for(size_t l = 0; l < SIZEOF(kLevels); l++)
+    {
+        JSON_SIMD_LEVEL level = CJSON::setSimdLevel(kLevels[l]);
+        CHECK(level <= kLevels[l]);
+        CHECK(CJSON::getSimdLevel() == level);
+
+        JSON_DATA jData;
+        CHECK(CJSON::parseJSON(strJSON.c_str(), jData) == 1);
+        CHECK(toCompactString(jData) == strExpected);
+
+        //Newlines are not allowed in strings
+        JSON_ERROR jErr;
+        std_wstring strBad = L("[\"") + std_wstring(40, 'b') + L("\n\"]");
+        CHECK(CJSON::parseJSON(strBad.c_str(), jData, &jErr) == 0);
+        CHECK(jErr.nErrIndex == 42);
+
+        //Unterminated string
+        strBad = L("[\"") + std_wstring(40, 'b');
+        CHECK(CJSON::parseJSON(strBad.c_str(), jData) == 0);
+    }
+
+    CJSON::setSimdLevel(levelOrig);
+}
+
+
+static void test_StrictUtf8()
+{
+#ifndef _WIN32
+    static const char* kBad[] = {
+        "\xC0\xAF",               //Overlong '/'
+        "\xC1\xBF",               //Overlong
+        "\xE0\x80\xAF",           //Overlong '/'
+        "\xE0\x9F\xBF",           //Overlong
+        "\xED\xA0\x80",           //Surrogate 0xD800
+        "\xED\xBF\xBF",           //Surrogate 0xDFFF
+        "\xF0\x80\x80\xAF",       //Overlong '/'
+        "\xF0\x8F\xBF\xBF",       //Overlong
+        "\xF4\x90\x80\x80",       //Past 0x10FFFF
+        "\xF7\xBF\xBF\xBF",       //Past 0x10FFFF
+        "\xF8\x88\x80\x80\x80",   //5-byte sequence
+        "\x80",                   //Stray continuation byte
+        "\xE2\x82",               //Truncated
+    };
+
+    static const char* kGood[] = {
+        "\xC2\x80",               //0x80
+        "\xDF\xBF",               //0x7FF
+        "\xE0\xA0\x80",           //0x800
+        "\xED\x9F\xBF",           //0xD7FF
+        "\xEE\x80\x80",           //0xE000
+        "\xEF\xBF\xBF",           //0xFFFF
+        "\xF0\x90\x80\x80",       //0x10000
+        "\xF4\x8F\xBF\xBF",       //0x10FFFF
+    };
+
+    JSON_SIMD_LEVEL levelOrig = CJSON::getSimdLevel();
+
+    static const JSON_SIMD_LEVEL kLevels[] = { JSIMD_NONE, JSIMD_SSE2, JSIMD_AVX2 };
+    for(size_t l = 0; l < SIZEOF(kLevels); l++)
+    {
+        CJSON::setSimdLevel(kLevels[l]);
+
+        for(size_t i = 0; i < SIZEOF(kBad); i++)
+        {
+            //Put it both at the start and past the first block
+            std::string strPad(i * 5, 'p');
+            std::string str = std::string(kBad[i]) + strPad;
+            std::string strJSON = "[\"" + strPad + str + "\"]";
+
+            JSON_DATA jData;
+            JSON_ERROR jErr;
+            CHECK(CJSON::parseJSON(strJSON.c_str(), jData, &jErr) == 0);
+            CHECK(jErr.nErrIndex == 2 + (intptr_t)strPad.size());
+
+            strJSON = "{\"" + str + "\": 1}";
+            CHECK(CJSON::parseJSON(strJSON.c_str(), jData) == 0);
+
+            CHECK(!JSON_NODE::isValidUtf8(str.c_str(), str.size()));
+
+            std_wstring strOut;
+            CHECK(!CJSON::getUnicodeStringFromEncoding(str.c_str(), str.size(), JENC_UTF_8, &strOut));
+        }
+
+        for(size_t i = 0; i < SIZEOF(kGood); i++)
+        {
+            std::string str = std::string(40, 'a') + kGood[i] + "z";
+            std::string strJSON = "[\"" + str + "\"]";
+
+            JSON_DATA jData;
+            CHECK(CJSON::parseJSON(strJSON.c_str(), jData) == 1);
+            CHECK(toCompactString(jData) == strJSON);
+
+            CHECK(JSON_NODE::isValidUtf8(str.c_str(), str.size()));
+        }
+    }
+
+    CJSON::setSimdLevel(levelOrig);
+
+    CHECK(JSON_NODE::skipAsciiChars("0123456789abcdef\xC3\xA9", 0, 18) == 16);
+    CHECK(JSON_NODE::skipAsciiChars("0123456789abcdef", 3, 16) == 16);
+#endif
+}
+
+
+static void test_UnicodeEscapes()
+{
+    JSON_DATA jData;
+    CHECK(CJSON::parseJSON(L("[\"\\u00e9\\u4E2D\\uD834\\uDD1Ex\\u0041\\ud83d\\ude00\"]"), jData) == 1);
+
+    JSON_NODE jRoot;
+    CHECK(jData.getRootNode(&jRoot));
+
+    std_wstring str;
+    CHECK(jRoot.findNodeByIndexAndGetValueAsString(0, &str) == JNT_STRING);
+    CHECK(str == L("é中𝄞xA😀"));
+
+    //Escape it back
+    JSON_FORMATTING fmt;
+    fmt.bHumanReadable = false;
+    fmt.escapeType = JESCT_ESCAPE_CHARS_AFTER_0x80;
+    CHECK(jData.toString(&fmt, &str));
+    CHECK(str == L("[\"\\u00e9\\u4e2d\\ud834\\udd1exA\\ud83d\\ude00\"]"));
+
+    JSON_DATA jData2;
+    CHECK(CJSON::parseJSON(str.c_str(), jData2) == 1);
+    CHECK(toCompactString(jData2) == L("[\"é中𝄞xA😀\"]"));
+
+    static const struct
+    {
+        LPCTSTR pStrJSON;
+        intptr_t nErrIndex;
+    }
+    kBad[] = {
+        { L("[\"ab\\u12 g\"]"),           4 },
+        { L("[\"ab\\u00G0\"]"),           4 },
+        { L("[\"ab\\u+123\"]"),           4 },
+        { L("[\"ab\\uD834x\"]"),          4 },
+        { L("[\"ab\\uDD1E\"]"),           4 },
+        { L("[\"ab\\uD834\\u0041\"]"),    4 },
+        { L("[\"ab\\uD834\\uD834\"]"),    4 },
+        { L("[\"ab\\uD834\\n\"]"),       4 },
+        { L("[\"ab\\u00e"),              5 },
+    };
+
+    for(size_t i = 0; i < SIZEOF(kBad); i++)
+    {
+        JSON_ERROR jErr;
+        CHECK(CJSON::parseJSON(kBad[i].pStrJSON, jData, &jErr) == 0);
+        CHECK(jErr.nErrIndex == kBad[i].nErrIndex);
+    }
+}
+
+
+static void test_Formatting()
+{
+    JSON_DATA jData;
+    CHECK(CJSON::parseJSON(L("{\"a\":[1,\"x/y\\t\",{}],\"b\":{\"c\":{\"d\":null}},\"e\":[]}"), jData) == 1);
+
+    CHECK(toCompactString(jData) == L("{\"a\":[1,\"x\\/y\\t\",{}],\"b\":{\"c\":{\"d\":null}},\"e\":[]}"));
+
+    std_wstring str;
+    CHECK(jData.toString(nullptr, &str));
+    CHECK(str == L("{\n\t\"a\": [1, \"x\\/y\\t\", {}],\n\t\"b\": {\n\t\t\"c\": {\n\t\t\t\"d\": null\n\t\t}\n\t},\n\t\"e\": []\n}"));
+
+    JSON_FORMATTING fmt;
+    fmt.spacesType = JSP_USE_SPACES;
+    fmt.nSpacesPerTab = 2;
+    fmt.strNewLine = L("\r\n");
+    CHECK(jData.toString(&fmt, &str));
+    CHECK(str == L("{\r\n  \"a\": [1, \"x\\/y\\t\", {}],\r\n  \"b\": {\r\n    \"c\": {\r\n      \"d\": null\r\n    }\r\n  },\r\n  \"e\": []\r\n}"));
+
+    //Only check the data
+    CHECK(jData.toString(&fmt, nullptr));
+
+    //Deep nesting and strings longer than the internal output buffer
+    std_wstring strLong(100000, 'z');
+    strLong[50000] = '\n';
+
+    std_wstring strJSON;
+    for(int i = 0; i < 100; i++)
+        strJSON += L("{\"k\":");
+    strJSON += L("\"") + strLong.substr(0, 50000) + L("\\n") + strLong.substr(50001) + L("\"");
+    for(int i = 0; i < 100; i++)
+        strJSON += '}';
+
+    CHECK(CJSON::parseJSON(strJSON.c_str(), jData) == 1);
+    CHECK(toCompactString(jData) == strJSON);
+
+    CHECK(jData.toString(nullptr, &str));
+    CHECK(str.size() == strJSON.size() + 100 + (100 + 5050) + (100 + 4950));
+    CHECK(str.compare(str.size() - 4, 4, L("\t}\n}")) == 0);
+
+    JSON_DATA jData2;
+    CHECK(CJSON::parseJSON(str.c_str(), jData2) == 1);
+    CHECK(toCompactString(jData2) == strJSON);
+}
+
+
+static bool appendToString(const BYTE* pData, size_t ncbDataSz, void* pCbkParam)
+{
+    //Sink callback that collects the output
+    ((std::string*)pCbkParam)->append((const char*)pData, ncbDataSz);
+    return true;
+}
+
+static bool failOnSecondChunk(const BYTE* /*pData*/, size_t /*ncbDataSz*/, void* pCbkParam)
+{
+    //Sink callback that fails after the first chunk
+    if(++*(int*)pCbkParam > 1)
+    {
+        CJSON::SetLastError(ERROR_HANDLE_EOF);
+        return false;
+    }
+
+    return true;
+}
+
+static void test_Sink()
+{
+    //Long enough to be flushed several times, with multi-byte characters that end up split between the chunks
+    std_wstring strJSON = L("{\"list\": [");
+    for(int i = 0; i < 3000; i++)
+    {
+        if(i)
+            strJSON += L(", ");
+
+        strJSON += L("\"€ü𝄞\\nx\"");
+    }
+    strJSON += L("], \"long\": \"");
+    for(int i = 0; i < 20000; i++)
+        strJSON += L("ж");
+    strJSON += L("\"}");
+
+    JSON_DATA jData;
+    CHECK(CJSON::parseJSON(strJSON.c_str(), jData) == 1);
+
+    std_wstring str;
+    CHECK(jData.toString(nullptr, &str));
+
+    static const JSON_ENCODING kEncs[] = { JENC_UTF_8, JENC_UNICODE_16, JENC_UNICODE_16BE, JENC_ANSI };
+    for(size_t e = 0; e < SIZEOF(kEncs); e++)
+    {
+        std::string strExpected;
+        CHECK(CJSON::getStringForEncoding(str.c_str(), kEncs[e], strExpected));
+
+        std::string strOut;
+        CHECK(CJSON::toSink(&jData, appendToString, &strOut, kEncs[e]));
+        CHECK(strOut == strExpected);
+
+        //With BOM
+        size_t ncbBOM = kEncs[e] == JENC_UTF_8 ? 3 : kEncs[e] == JENC_ANSI ? 0 : 2;
+        strOut.clear();
+        CHECK(CJSON::toSink(&jData, appendToString, &strOut, kEncs[e], nullptr, true));
+        CHECK(strOut.size() == strExpected.size() + ncbBOM);
+        CHECK(strOut.compare(ncbBOM, std::string::npos, strExpected) == 0);
+    }
+
+    //Sink that fails
+    int nCntCalls = 0;
+    CHECK(!CJSON::toSink(&jData, failOnSecondChunk, &nCntCalls));
+    CHECK(CJSON::GetLastError() == ERROR_HANDLE_EOF);
+    CHECK(nCntCalls == 2);
+
+    CHECK(!CJSON::toSink(&jData, nullptr, nullptr));
+    CHECK(CJSON::GetLastError() == ERROR_INVALID_PARAMETER);
+
+    //Files
+    LPCTSTR pStrPath = L("cjson_tests_sink.json");
+
+    CHECK(CJSON::writeJSONFile(pStrPath, &jData, JENC_UNICODE_16BE));
+
+    std_wstring strRead;
+    CHECK(CJSON::readFileContentsAsString(pStrPath, &strRead));
+    CHECK(strRead == str);
+
+    FILE* pFile = fopen(pStrPath, "wb");
+    CHECK(pFile != nullptr);
+    if(pFile)
+    {
+        JSON_FORMATTING fmt;
+        fmt.bHumanReadable = false;
+        CHECK(CJSON::toFile(&jData, pFile, JENC_UTF_8, &fmt));
+        fclose(pFile);
+
+        CHECK(CJSON::readFileContentsAsString(pStrPath, &strRead));
+        CHECK(strRead == toCompactString(jData));
+    }
+
+#ifdef JSON_UTF8
+    pFile = fopen(pStrPath, "wb");
+    CHECK(pFile != nullptr);
+    if(pFile)
+    {
+        CHECK(CJSON::toFileDescriptor(&jData, fileno(pFile), JENC_UTF_8, nullptr, true));
+        fclose(pFile);
+
+        CHECK(CJSON::readFileContentsAsString(pStrPath, &strRead));
+        CHECK(strRead == str);
+    }
+
+    CHECK(!CJSON::toFileDescriptor(&jData, -1));
+    CHECK(CJSON::GetLastError() == ERROR_INVALID_PARAMETER);
+
+    //Write errors come from the OS
+    pFile = fopen(pStrPath, "rb");
+    CHECK(pFile != nullptr);
+    if(pFile)
+    {
+        CHECK(!CJSON::toFile(&jData, pFile));
+        CHECK(CJSON::GetLastError() == EBADF);
+
+        CHECK(!CJSON::toFileDescriptor(&jData, fileno(pFile)));
+        CHECK(CJSON::GetLastError() == EBADF);
+        fclose(pFile);
+    }
+#endif
+
+    remove(pStrPath);
+}
+
+
+static int pushParseInPieces(const std_wstring& strJSON, size_t nchPiece, JSON_DATA& jData, JSON_ERROR& jErr)
+{
+    //Parse 'strJSON' with JSON_PUSH_PARSER, passing it in pieces of 'nchPiece' TCHARs
+    JSON_PUSH_PARSER jpp;
+    jpp.begin(jData, &jErr);
+
+    for(size_t i = 0; i < strJSON.size(); i += nchPiece)
+    {
+        int nRes = jpp.feed(strJSON.c_str() + i, (intptr_t)std::min(nchPiece, strJSON.size() - i));
+        if(nRes != 1)
+            return nRes;
+    }
+
+    return jpp.finish();
+}
+
+static void test_PushParser()
+{
+    static LPCTSTR kDocs[] = {
+        //Good
+        L("{\"name\": \"value\", \"int\": -12, \"flt\": 1.5e3, \"b\": true, \"n\": null, "
+          "\"arr\": [1, \"two\", [], {}], \"obj\": {\"x\": \"y\"}}"),
+        L("  [ \"\\u00e9\\u4E2D\\uD834\\uDD1Ex\\u0041\\\"\\\\\", \"é中𝄞\", {\"é\" :\t[ ]} ]\r\n"),
+        L("\"root string\""),
+        L("12345"),
+        L("[[[[[[{\"a\":[{\"b\":{}}]}]]]]]]"),
+        L("[1,]"),
+
+        //Bad
+        L(""),
+        L("   "),
+        L("{\"a\": 1,, \"b\": 2}"),
+        L("[1 2]"),
+        L("{\"a\" 1}"),
+        L("{\"a\": \"x\n\"}"),
+        L("[1, 2] 3"),
+        L("{\"a\": [1, 2}"),
+        L("[\"ab\\u12 g\"]"),
+        L("[\"ab\\uD834\\u0041\"]"),
+        L("[\"ab\\u00e"),
+        L("[\"ab\\uD834"),
+        L("{\"a\": 1"),
+        L("{\"a\""),
+        L("{\"a\":"),
+        L("[,1]"),
+        L("{1: 2}"),
+        L("[1, :]"),
+        L("[tru"),
+    };
+
+    for(size_t d = 0; d < SIZEOF(kDocs); d++)
+    {
+        std_wstring strJSON = kDocs[d];
+
+        JSON_DATA jDataExp;
+        JSON_ERROR jErrExp;
+        int nResExp = CJSON::parseJSON(strJSON.c_str(), jDataExp, &jErrExp);
+
+        std_wstring strExp;
+        if(nResExp == 1)
+            strExp = toCompactString(jDataExp);
+
+        //Every piece size must give the same result as parsing it all at once
+        for(size_t n = 1; n <= strJSON.size() + 1; n++)
+        {
+            JSON_DATA jData;
+            JSON_ERROR jErr;
+            int nRes = pushParseInPieces(strJSON, n, jData, jErr);
+            CHECK(nRes == nResExp);
+
+            if(nRes == 1)
+            {
+                CHECK(jErr.isEmpty());
+                CHECK(toCompactString(jData) == strExp);
+            }
+            else
+            {
+                CHECK(jErr.nErrIndex == jErrExp.nErrIndex);
+                CHECK(jErr.strErrDesc == jErrExp.strErrDesc);
+
+                JSON_NODE jRoot;
+                CHECK(!jData.getRootNode(&jRoot));
+            }
+        }
+    }
+
+    //Long strings that arrive in many pieces
+    std_wstring strLong;
+    for(int i = 0; i < 20000; i++)
+        strLong += L("ab\\\"cdé");
+
+    std_wstring strJSON = L("{\"") + strLong + L("\": [\"") + strLong + L("\", 1234567890123]}");
+
+    JSON_DATA jDataExp;
+    CHECK(CJSON::parseJSON(strJSON.c_str(), jDataExp) == 1);
+
+    static const size_t kPieces[] = { 1, 7, 4096, 65536 };
+    for(size_t p = 0; p < SIZEOF(kPieces); p++)
+    {
+        JSON_DATA jData;
+        JSON_ERROR jErr;
+        CHECK(pushParseInPieces(strJSON, kPieces[p], jData, jErr) == 1);
+        CHECK(toCompactString(jData) == toCompactString(jDataExp));
+    }
+
+    //Wrong use
+    JSON_DATA jData;
+    JSON_PUSH_PARSER jpp;
+    CHECK(jpp.feed(L("[]"), 2) == -1);
+    CHECK(CJSON::GetLastError() == ERROR_INVALID_PARAMETER);
+
+    jpp.begin(jData);
+    CHECK(jpp.feed(L("[1"), 2) == 1);
+    CHECK(jpp.feed(L("]"), 1) == 1);
+    CHECK(jpp.finish() == 1);
+    CHECK(jpp.finish() == -1);
+    CHECK(jpp.feed(L("1"), 1) == -1);
+
+    //Stays failed
+    jpp.begin(jData);
+    CHECK(jpp.feed(L("[1 2"), 4) == 0);
+    CHECK(jpp.feed(L("]"), 1) == 0);
+    CHECK(jpp.finish() == 0);
+}
+
+
+struct TEST_SAX_HANDLER : public JSON_SAX_HANDLER
+{
+    //Writes down all events, and skips or aborts on request
+    std_wstring strLog;
+    std_wstring strSkipName;            //Skip value for this name
+    std_wstring strAbortName;           //Abort on this name
+    int nSkipArrayDepth;                //Skip arrays at this depth, or -1 not to
+    int nDepth;
+
+    TEST_SAX_HANDLER()
+    {
+        nSkipArrayDepth = -1;
+        nDepth = 0;
+    }
+
+    virtual JSON_SAX_ACTION onStartObject()
+    {
+        strLog += L("{");
+        nDepth++;
+        return JSAX_CONTINUE;
+    }
+    virtual JSON_SAX_ACTION onEndObject()
+    {
+        strLog += L("}");
+        nDepth--;
+        return JSAX_CONTINUE;
+    }
+    virtual JSON_SAX_ACTION onStartArray()
+    {
+        if(nDepth == nSkipArrayDepth)
+        {
+            strLog += L("[..");
+            return JSAX_SKIP;
+        }
+
+        strLog += L("[");
+        nDepth++;
+        return JSAX_CONTINUE;
+    }
+    virtual JSON_SAX_ACTION onEndArray()
+    {
+        strLog += L("]");
+        nDepth--;
+        return JSAX_CONTINUE;
+    }
+    virtual JSON_SAX_ACTION onName(const WCHAR* pName, intptr_t nchLen)
+    {
+        std_wstring strName(pName, nchLen);
+        strLog += L("N:") + strName + L(" ");
+
+        if(strName == strAbortName)
+            return JSAX_ABORT;
+
+        return strName == strSkipName ? JSAX_SKIP : JSAX_CONTINUE;
+    }
+    virtual JSON_SAX_ACTION onString(const WCHAR* pStr, intptr_t nchLen)
+    {
+        strLog += L("S:") + std_wstring(pStr, nchLen) + L(" ");
+        return JSAX_CONTINUE;
+    }
+    virtual JSON_SAX_ACTION onNumber(const WCHAR* pNum, intptr_t nchLen, JSON_NODE_TYPE type)
+    {
+        strLog += (type == JNT_INTEGER ? L("I:") : L("F:")) + std_wstring(pNum, nchLen) + L(" ");
+        return JSAX_CONTINUE;
+    }
+    virtual JSON_SAX_ACTION onBoolean(bool bValue)
+    {
+        strLog += bValue ? L("true ") : L("false ");
+        return JSAX_CONTINUE;
+    }
+    virtual JSON_SAX_ACTION onNull()
+    {
+        strLog += L("null ");
+        return JSAX_CONTINUE;
+    }
+};
+
+static void test_SaxHandler()
+{
+    LPCTSTR pStrJSON = L("{\"name\": \"va\\\"lue\", \"int\": -12, \"flt\": 1.5e3, \"b\": true, \"n\": null, \"word\": abc, "
+                         "\"arr\": [1, \"two\", [false], {}], \"obj\": {\"x\": \"y\"}}");
+
+    TEST_SAX_HANDLER h;
+    JSON_ERROR jErr;
+    CHECK(CJSON::parseJSONWithHandler(pStrJSON, h, &jErr) == 1);
+    CHECK(jErr.isEmpty());
+    CHECK(h.strLog == L("{N:name S:va\"lue N:int I:-12 N:flt F:1.5e3 N:b true N:n null N:word S:abc "
+                        "N:arr [I:1 S:two [false ]{}]N:obj {N:x S:y }}"));
+
+    //Skip a value by its name, and arrays in the root object
+    TEST_SAX_HANDLER hSkip;
+    hSkip.strSkipName = L("obj");
+    hSkip.nSkipArrayDepth = 1;
+    CHECK(CJSON::parseJSONWithHandler(pStrJSON, hSkip) == 1);
+    CHECK(hSkip.strLog == L("{N:name S:va\"lue N:int I:-12 N:flt F:1.5e3 N:b true N:n null N:word S:abc "
+                            "N:arr [..N:obj }"));
+
+    //Skipped parts are still checked for errors
+    CHECK(CJSON::parseJSONWithHandler(L("{\"obj\": {\"a\" 1}}"), hSkip, &jErr) == 0);
+    CHECK(jErr.nErrIndex == 13);
+
+    //Abort
+    TEST_SAX_HANDLER hAbort;
+    hAbort.strAbortName = L("flt");
+    jErr = JSON_ERROR();
+    CHECK(CJSON::parseJSONWithHandler(pStrJSON, hAbort, &jErr) == -1);
+    CHECK(CJSON::GetLastError() == ERROR_CANCELLED);
+    CHECK(jErr.nErrIndex == 32);
+    CHECK(hAbort.strLog == L("{N:name S:va\"lue N:int I:-12 N:flt "));
+
+    //Same errors as when parsing into JSON_DATA
+    static LPCTSTR kBad[] = {
+        L(""),
+        L("{\"a\": 1,, \"b\": 2}"),
+        L("[1 2]"),
+        L("{\"a\" 1}"),
+        L("{\"a\": \"x\n\"}"),
+        L("[1, 2] 3"),
+        L("{\"a\": [1, 2}"),
+        L("[\"ab\\u12 g\"]"),
+        L("[\"ab\\uD834\\u0041\"]"),
+        L("[,1]"),
+        L("{1: 2}"),
+    };
+
+    for(size_t i = 0; i < SIZEOF(kBad); i++)
+    {
+        JSON_DATA jData;
+        JSON_ERROR jErrExp;
+        CHECK(CJSON::parseJSON(kBad[i], jData, &jErrExp) == 0);
+
+        TEST_SAX_HANDLER hBad;
+        jErr = JSON_ERROR();
+        CHECK(CJSON::parseJSONWithHandler(kBad[i], hBad, &jErr) == 0);
+        CHECK(jErr.nErrIndex == jErrExp.nErrIndex);
+        CHECK(jErr.strErrDesc == jErrExp.strErrDesc);
+    }
+}
+
+
+static std::vector<intptr_t> findAllByName(JSON_NODE& jNode, LPCTSTR pStrName, bool bCaseSensitive)
+{
+    //Find all nodes with the name with JSON_SRCH
+    std::vector<intptr_t> arrInds;
+
+    JSON_SRCH jSrch;
+    while(jNode.findNodeByName(pStrName, nullptr, bCaseSensitive, &jSrch) > JNT_NONE)
+        arrInds.push_back(jSrch.getIndexFoundAt());
+
+    return arrInds;
+}
+
+static std::vector<intptr_t> findAllByNameSlowly(JSON_NODE& jNode, LPCTSTR pStrName, bool bCaseSensitive)
+{
+    //Find all nodes with the name by comparing each one
+    std::vector<intptr_t> arrInds;
+
+    for(intptr_t i = 0; i < jNode.getNodeCount(); i++)
+    {
+        JSON_NODE jn;
+        CHECK(jNode.findNodeByIndex(i, &jn) > JNT_NONE);
+
+        if(bCaseSensitive ? jn.strName == pStrName : JSON_NODE::compareStringsEqual(jn.strName, pStrName, false))
+            arrInds.push_back(i);
+    }
+
+    return arrInds;
+}
+
+static void checkFindByName(JSON_NODE& jNode)
+{
+    static LPCTSTR kNames[] = {
+        L("key0"), L("key17"), L("KEY17"), L("key99"), L("key100"), L("dup"), L("DUP"), L("Mixed"), L("mixed"),
+        L("Ключ"), L("ключ"), L("KЛЮЧ"), L("none"), L("ke"),
+    };
+
+    for(size_t n = 0; n < SIZEOF(kNames); n++)
+    {
+        CHECK(findAllByName(jNode, kNames[n], true) == findAllByNameSlowly(jNode, kNames[n], true));
+        CHECK(findAllByName(jNode, kNames[n], false) == findAllByNameSlowly(jNode, kNames[n], false));
+    }
+}
+
+static void test_NameIndex()
+{
+    JSON_DATA jData;
+    JSON_NODE jRoot;
+    CHECK(jRoot.setAsRootNode(&jData));
+
+    //Small object is searched without the index
+    CHECK(jRoot.addNode_Int(L("dup"), 1));
+    CHECK(jRoot.addNode_Int(L("Mixed"), 2));
+    checkFindByName(jRoot);
+
+    //Grows large enough for the index, with new names picked up by it as they are added
+    for(int i = 0; i < 100; i++)
+    {
+        std_wstring strName = L("key");
+        for(int v = i; ; v /= 10)
+        {
+            strName.insert(3, 1, (WCHAR)('0' + v % 10));
+            if(v < 10)
+                break;
+        }
+
+        CHECK(jRoot.addNode_Int(strName.c_str(), i));
+
+        if(i % 10 == 0)
+        {
+            CHECK(jRoot.addNode_Int(i % 20 ? L("dup") : L("DUP"), i));
+            checkFindByName(jRoot);
+        }
+    }
+
+    CHECK(jRoot.addNode_String(L("Ключ"), L("1")));
+    CHECK(jRoot.addNode_String(L("ключ"), L("2")));
+    CHECK(jRoot.addNode_String(L("MIXED"), L("3")));
+    checkFindByName(jRoot);
+
+    //Renaming drops it
+    CHECK(jRoot.setNodeByName_Int(L("MIXED"), 5) == 2);
+    checkFindByName(jRoot);
+
+    CHECK(jRoot.setNodeByName_Int(L("KEY17"), 5, true) == 0);
+    CHECK(jRoot.setNodeByName_Int(L("key17"), 5, true) == 1);
+    checkFindByName(jRoot);
+
+    //As does removing
+    CHECK(jRoot.removeNodeByName(L("dup")) == 11);
+    CHECK(jRoot.removeNodeByIndex(0));
+    checkFindByName(jRoot);
+
+    CHECK(jRoot.getNodeCount() == 103);
+
+    //Build it ahead of time
+    JSON_DATA jData2;
+    CHECK(CJSON::parseJSON(L("[{\"a\": {\"b\": 1, \"B\": 2}}, [{\"c\": 3}], 4]"), jData2) == 1);
+
+    JSON_NODE jRoot2;
+    CHECK(jData2.getRootNode(&jRoot2));
+    CHECK(!jRoot2.buildNameIndex());
+    CHECK(jRoot2.buildNameIndex(true));
+
+    JSON_NODE jObj, jNode;
+    CHECK(jRoot2.findNodeByIndex(0, &jObj) == JNT_OBJECT);
+    CHECK(jObj.findNodeByName(L("a"), &jNode) == JNT_OBJECT);
+    CHECK(findAllByName(jNode, L("b"), false).size() == 2);
+    CHECK(findAllByName(jNode, L("B"), true) == std::vector<intptr_t>(1, 1));
+}
+
+
+static void test_NativeValues()
+{
+    LPCTSTR pStrJSON = L("{\"i\":-42,\"big\":123456789012345678901,\"f\":2.5,\"e\":1e999,\"b\":true,\"B\":TRUE,"
+                         "\"n\":null,\"s\":\"7\",\"d\":0.1,\"x\":1.50,\"arr\":[1,false]}");
+
+    JSON_DATA jData;
+    JSON_ERROR jErr;
+    CHECK(CJSON::parseJSON(pStrJSON, jData, &jErr, JPF_NATIVE_VALUES) == 1);
+
+    JSON_NODE jRoot, jNode, jNode2;
+    CHECK(jData.getRootNode(&jRoot));
+
+    //Numbers that fit are stored without text
+    CHECK(jRoot.findNodeByName(L("i"), &jNode) == JNT_INTEGER);
+    CHECK(jNode.pVal->nativeType == JNT_INTEGER && jNode.pVal->strValue.empty());
+    int64_t iiVal = 0;
+    CHECK(jNode.getValueAsInt64(&iiVal) && iiVal == -42);
+    double fVal = 0.0;
+    CHECK(jNode.getValueAsDouble(&fVal) && fVal == -42.0);
+    std_wstring str;
+    CHECK(jNode.getValueAsString(&str) && str == L("-42"));
+
+    CHECK(jRoot.findNodeByName(L("f"), &jNode) == JNT_FLOAT);
+    CHECK(jNode.pVal->nativeType == JNT_FLOAT && jNode.pVal->strValue.empty());
+    CHECK(jNode.getValueAsDouble(&fVal) && fVal == 2.5);
+    CHECK(jNode.getValueAsInt64(&iiVal) && iiVal == 3);
+
+    //Out of range values keep their text
+    CHECK(jRoot.findNodeByName(L("big"), &jNode) == JNT_INTEGER);
+    CHECK(jNode.pVal->nativeType == JNT_NONE);
+    CHECK(jNode.getValueAsString(&str) && str == L("123456789012345678901"));
+
+    CHECK(jRoot.findNodeByName(L("e"), &jNode) == JNT_FLOAT);
+    CHECK(jNode.pVal->nativeType == JNT_FLOAT && jNode.pVal->strValue == L("1e999"));
+
+    //Same rules as without the flag for the rest
+    bool bVal = false;
+    CHECK(jRoot.findNodeByName(L("b"), &jNode, true) == JNT_BOOLEAN);
+    CHECK(jNode.pVal->nativeType == JNT_BOOLEAN);
+    CHECK(jNode.getValueAsBool(&bVal) && bVal);
+    CHECK(jRoot.findNodeByName(L("B"), &jNode, true) == JNT_STRING);
+    CHECK(jNode.pVal->nativeType == JNT_NONE);
+    CHECK(jNode.getValueAsBool(&bVal, false) && bVal);
+    CHECK(jRoot.findNodeByName(L("n"), &jNode) == JNT_NULL);
+    CHECK(jNode.isNullValue());
+    CHECK(jRoot.findNodeByName(L("s"), &jNode) == JNT_STRING);
+    CHECK(jNode.pVal->nativeType == JNT_NONE);
+    CHECK(jNode.getValueAsInt64(&iiVal) && iiVal == 7);
+
+    CHECK(jRoot.findNodeByName(L("arr"), &jNode) == JNT_ARRAY);
+    CHECK(jNode.findNodeByIndex(1, &jNode2) == JNT_BOOLEAN);
+    CHECK(jNode2.getValueAsBool(&bVal) && !bVal);
+
+    //Numbers are written out from their values, and read back the same
+    std_wstring strOut = toCompactString(jData);
+    CHECK(strOut.find(L("\"i\":-42,\"big\":123456789012345678901,\"f\":2.5,\"e\":1e999,\"b\":true,\"B\":TRUE,\"n\":null,\"s\":\"7\",")) != std_wstring::npos);
+    CHECK(strOut.find(L("\"x\":1.5,")) != std_wstring::npos);
+
+    JSON_DATA jData2;
+    CHECK(CJSON::parseJSON(strOut.c_str(), jData2) == 1);
+    JSON_NODE jRoot2;
+    CHECK(jData2.getRootNode(&jRoot2));
+    CHECK(jRoot2.findNodeByName(L("d"), &jNode) == JNT_FLOAT);
+    CHECK(jNode.getValueAsDouble(&fVal) && fVal == 0.1);
+
+    //Copies keep the values
+    JSON_DATA jCopy;
+    JSON_NODE jCopyRoot;
+    CHECK(CJSON::parseJSON(L("{}"), jCopy) == 1);
+    CHECK(jCopy.getRootNode(&jCopyRoot));
+    CHECK(jRoot.findNodeByName(L("f"), &jNode) == JNT_FLOAT);
+    CHECK(jCopyRoot.addNode(&jNode));
+    CHECK(jCopyRoot.findNodeByName(L("f"), &jNode) == JNT_FLOAT);
+    CHECK(jNode.pVal->nativeType == JNT_FLOAT && jNode.pVal->fNative == 2.5);
+    CHECK(toCompactString(jCopy) == L("{\"f\":2.5}"));
+
+    //Setting a value drops the one converted when parsed
+    CHECK(jRoot.setNodeByName_String(L("i"), L("abc"), true) == 1);
+    CHECK(jRoot.findNodeByName(L("i"), &jNode) == JNT_STRING);
+    CHECK(jNode.pVal->nativeType == JNT_NONE);
+    CHECK(!jNode.getValueAsInt64(&iiVal));
+    CHECK(jRoot.setNodeByName_Int64(L("f"), 9, true) == 1);
+    CHECK(jRoot.findNodeByName(L("f"), &jNode) == JNT_INTEGER);
+    CHECK(jNode.getValueAsDouble(&fVal) && fVal == 9.0);
+
+    //Text can be kept as well, also when referencing the source
+    std_wstring strSrc = pStrJSON;
+    JSON_DATA jData3;
+    CHECK(CJSON::parseJSON(strSrc.c_str(), jData3, &jErr, JPF_NATIVE_VALUES | JPF_KEEP_NUMBER_TEXT | JPF_REFERENCE_SOURCE) == 1);
+    CHECK(toCompactString(jData3) == strSrc);
+    CHECK(jData3.getRootNode(&jRoot));
+    CHECK(jRoot.findNodeByName(L("x"), &jNode) == JNT_FLOAT);
+    CHECK(jNode.pVal->nativeType == JNT_FLOAT && jNode.pVal->pStrRef != nullptr);
+    CHECK(jNode.getValueAsDouble(&fVal) && fVal == 1.5);
+
+    //Getters on a root value give the same results in both modes
+    static const WCHAR* kRoots[] = { L("5"), L("2.5"), L("true"), L("null"), L("\"7\"") };
+    for(size_t i = 0; i < SIZEOF(kRoots); i++)
+    {
+        JSON_DATA jDataText, jDataNative;
+        JSON_NODE jRootText, jRootNative;
+        CHECK(CJSON::parseJSON(kRoots[i], jDataText) == 1);
+        CHECK(CJSON::parseJSON(kRoots[i], jDataNative, nullptr, JPF_NATIVE_VALUES) == 1);
+        CHECK(jDataText.getRootNode(&jRootText));
+        CHECK(jDataNative.getRootNode(&jRootNative));
+
+        int64_t iiText = 1, iiNative = 2;
+        CHECK(jRootText.getValueAsInt64(&iiText) == jRootNative.getValueAsInt64(&iiNative));
+        CHECK(iiText == iiNative);
+        double fText = 1.0, fNative = 2.0;
+        CHECK(jRootText.getValueAsDouble(&fText) == jRootNative.getValueAsDouble(&fNative));
+        CHECK(fText == fNative);
+        bool bText = false, bNative = true;
+        CHECK(jRootText.getValueAsBool(&bText) == jRootNative.getValueAsBool(&bNative));
+        CHECK(bText == bNative);
+        CHECK(jRootText.isNullValue() == jRootNative.isNullValue());
+        std_wstring strText, strNative;
+        CHECK(jRootText.getValueAsString(&strText) == jRootNative.getValueAsString(&strNative));
+        CHECK(strText == strNative);
+    }
+}
+
+
+static void test_NodeTypeCache()
+{
+    JSON_DATA jData;
+    CHECK(CJSON::parseJSON(L("[12, 1.5, null, true, abc, \"s\", 99999999999999999999]"), jData) == 1);
+
+    JSON_NODE jRoot, jNode;
+    CHECK(jData.getRootNode(&jRoot));
+
+    static const JSON_NODE_TYPE kTypes[] = { JNT_INTEGER, JNT_FLOAT, JNT_NULL, JNT_BOOLEAN, JNT_STRING, JNT_STRING, JNT_INTEGER };
+
+    //Determined when parsed, so that lookups don't change it
+    JSON_ARRAY* pJA = (JSON_ARRAY*)jData.val.pValue;
+    CHECK(pJA && pJA->arrArrElmts.size() == SIZEOF(kTypes));
+    if(pJA && pJA->arrArrElmts.size() == SIZEOF(kTypes))
+    {
+        for(size_t i = 0; i < SIZEOF(kTypes); i++)
+        {
+            if(pJA->arrArrElmts[i].val.valType == JVT_PLAIN)
+                CHECK(pJA->arrArrElmts[i].val.plainType == kTypes[i]);
+        }
+    }
+
+    for(size_t i = 0; i < SIZEOF(kTypes); i++)
+    {
+        CHECK(jRoot.findNodeByIndex(i, &jNode) == kTypes[i]);
+    }
+
+    //Changing a value changes its type
+    CHECK(jRoot.setNodeByIndex_String(0, L("x")));
+    CHECK(jRoot.findNodeByIndex(0, &jNode) == JNT_STRING);
+    CHECK(jRoot.setNodeByIndex_Int(1, 5));
+    CHECK(jRoot.findNodeByIndex(1, &jNode) == JNT_INTEGER);
+    CHECK(jNode.pVal->plainType == JNT_INTEGER);
+    CHECK(jRoot.setNodeByIndex_Bool(4, false));
+    CHECK(pJA && pJA->arrArrElmts[4].val.plainType == JNT_BOOLEAN);
+    CHECK(jRoot.findNodeByIndex(4, &jNode) == JNT_BOOLEAN);
+    CHECK(jRoot.setNodeByIndex_Null(6));
+    CHECK(jRoot.findNodeByIndex(6, &jNode) == JNT_NULL);
+
+    CHECK(toCompactString(jData) == L("[\"x\",5,null,true,false,\"s\",null]"));
+
+    //Values that were not converted when parsed have their type right away
+    JSON_DATA jData2;
+    CHECK(CJSON::parseJSON(L("{\"a\": abc, \"b\": 99999999999999999999, \"c\": 1}"), jData2, nullptr, JPF_NATIVE_VALUES) == 1);
+    JSON_OBJECT* pJO = (JSON_OBJECT*)jData2.val.pValue;
+    CHECK(pJO && pJO->arrObjElmts.size() == 3);
+    if(pJO && pJO->arrObjElmts.size() == 3)
+    {
+        CHECK(pJO->arrObjElmts[0].val.plainType == JNT_STRING);
+        CHECK(pJO->arrObjElmts[1].val.plainType == JNT_INTEGER);
+        CHECK(pJO->arrObjElmts[2].val.nativeType == JNT_INTEGER);
+    }
+}
+
+
+static void test_NumberFormatting()
+{
+    static const struct
+    {
+        double fVal;
+        LPCTSTR pStrExpected;
+    }
+    kDoubles[] = {
+        { 0.1,                      L("0.1") },
+        { -2.5,                     L("-2.5") },
+        { 5.0,                      L("5.0") },
+        { 0.0,                      L("0.0") },
+        { -0.0,                     L("-0.0") },
+        { 1e-9,                     L("1e-9") },
+        { 0.000001,                 L("0.000001") },
+        { 123456789012.5,           L("123456789012.5") },
+        { 1e21,                     L("1e21") },
+        { 1.5e300,                  L("1.5e300") },
+        { 5e-324,                   L("5e-324") },
+        { 1.7976931348623157e308,   L("1.7976931348623157e308") },
+        { 1.0 / 3.0,                L("0.3333333333333333") },
+        //Grisu2 alone gives 17 digits for these
+        { 5.5627572016460904,       L("5.56275720164609") },
+        { 22565467092700128.0,      L("22565467092700130.0") },
+        { 1.9352941507282278e286,   L("1.935294150728228e286") },
+    };
+
+    JSON_DATA jData;
+    JSON_NODE jRoot, jNode;
+    CHECK(jRoot.setAsRootNode(&jData));
+
+    std_wstring str;
+    for(size_t i = 0; i < SIZEOF(kDoubles); i++)
+    {
+        //Shortest text that reads back the same, and still a floating point number
+        CHECK(jRoot.addNode_Double(L("v"), kDoubles[i].fVal));
+        CHECK(jRoot.findNodeByIndex(jRoot.getNodeCount() - 1, &jNode) == JNT_FLOAT);
+        CHECK(jNode.getValueAsString(&str) && str == kDoubles[i].pStrExpected);
+
+        double fVal = 0.0;
+        CHECK(jNode.getValueAsDouble(&fVal) && fVal == kDoubles[i].fVal);
+    }
+
+    CHECK(jRoot.setNodeByName_Double(L("v"), 0.3, true) == (intptr_t)SIZEOF(kDoubles));
+    CHECK(jRoot.findNodeByIndex(0, &jNode) == JNT_FLOAT);
+    CHECK(jNode.getValueAsString(&str) && str == L("0.3"));
+    CHECK(jRoot.setNodeByIndex_Double(1, 7e-7));
+    CHECK(jRoot.findNodeByIndex(1, &jNode) == JNT_FLOAT);
+    CHECK(jNode.getValueAsString(&str) && str == L("7e-7"));
+
+    //Integers
+    JSON_DATA jData2;
+    CHECK(CJSON::parseJSON(L("[]"), jData2) == 1);
+    CHECK(jData2.getRootNode(&jRoot));
+    CHECK(jRoot.addNode_Int(nullptr, 0));
+    CHECK(jRoot.addNode_Int(nullptr, -2147483647 - 1));
+    CHECK(jRoot.addNode_Int64(nullptr, INT64_MAX));
+    CHECK(jRoot.addNode_Int64(nullptr, INT64_MIN));
+    CHECK(jRoot.addNode_Int64(nullptr, 1));
+    CHECK(jRoot.setNodeByIndex_Int64(4, -1234567890123LL));
+    CHECK(toCompactString(jData2) == L("[0,-2147483648,9223372036854775807,-9223372036854775808,-1234567890123]"));
+
+    int64_t iiVal = 0;
+    CHECK(jRoot.findNodeByIndex(3, &jNode) == JNT_INTEGER);
+    CHECK(jNode.getValueAsInt64(&iiVal) && iiVal == INT64_MIN);
+
+    //Numbers converted when parsed are written the same way
+    JSON_DATA jData3;
+    CHECK(CJSON::parseJSON(L("[0.10, 1E2, -0, 2.50e-3, 007]"), jData3, nullptr, JPF_NATIVE_VALUES) == 1);
+    CHECK(toCompactString(jData3) == L("[0.1,100.0,0,0.0025,7]"));
+}
+
+
+static void test_NumberParsing()
+{
+    //Integers
+    static const struct
+    {
+        LPCTSTR pStr;
+        int nRes;
+        int64_t iiVal;
+    }
+    kInts[] = {
+        { L("0"),                       1,  0 },
+        { L("-12"),                     1,  -12 },
+        { L("+007"),                    1,  7 },
+        { L("9223372036854775807"),     1,  INT64_MAX },
+        { L("-9223372036854775808"),    1,  INT64_MIN },
+        { L("9223372036854775808"),     -1, INT64_MAX },
+        { L("-9223372036854775809"),    -1, INT64_MIN },
+        { L("123456789012345678901"),   -1, INT64_MAX },
+        { L(""),                        0,  0 },
+        { L("-"),                       0,  0 },
+        { L("1.0"),                     0,  0 },
+        { L("12a"),                     0,  0 },
+        { L(" 1"),                      0,  0 },
+    };
+
+    for(size_t i = 0; i < SIZEOF(kInts); i++)
+    {
+        int64_t iiVal = 1;
+        CHECK(CJSON::parseInt64(kInts[i].pStr, STRLEN(kInts[i].pStr), &iiVal) == kInts[i].nRes);
+        CHECK(iiVal == kInts[i].iiVal);
+    }
+
+    //Floating point numbers, correctly rounded
+    static const struct
+    {
+        LPCTSTR pStr;
+        double fVal;
+    }
+    kDoubles[] = {
+        { L("1.5"),                         1.5 },
+        { L("-0.1"),                        -0.1 },
+        { L(".5"),                          0.5 },
+        { L("5."),                          5.0 },
+        { L("+1E-3"),                       0.001 },
+        { L("  2.5"),                       2.5 },
+        { L("1e23"),                        1e23 },
+        { L("9007199254740993"),            9007199254740992.0 },
+        { L("2.2250738585072011e-308"),     2.2250738585072011e-308 },
+        { L("4.9406564584124654e-324"),     4.9406564584124654e-324 },
+        { L("1.7976931348623157e308"),      1.7976931348623157e308 },
+        { L("0.1000000000000000055511151231257827021181583404541015625"), 0.1 },
+        { L("123456789012345678901234567890"), 1.2345678901234568e29 },
+        { L("1e-400"),                      0.0 },
+    };
+
+    for(size_t i = 0; i < SIZEOF(kDoubles); i++)
+    {
+        double fVal = -1.0;
+        CHECK(CJSON::parseDouble(kDoubles[i].pStr, STRLEN(kDoubles[i].pStr), &fVal));
+        CHECK(fVal == kDoubles[i].fVal);
+    }
+
+    double fVal = 0.0;
+    CHECK(CJSON::parseFloat(L("1e999"), &fVal) && std::isinf(fVal) && fVal > 0);
+    CHECK(CJSON::parseFloat(L("-inf"), &fVal) && std::isinf(fVal) && fVal < 0);
+    CHECK(CJSON::parseFloat(L("nan"), &fVal) && std::isnan(fVal));
+    CHECK(CJSON::parseFloat(L("-0"), &fVal) && fVal == 0.0 && std::signbit(fVal));
+
+    static const WCHAR* kBad[] = { L(""), L("-"), L("."), L("e5"), L("1e"), L("1e+"), L("1.5 "), L("1,5"), L("0x10"), L("--1") };
+    for(size_t i = 0; i < SIZEOF(kBad); i++)
+    {
+        CHECK(!CJSON::parseDouble(kBad[i], STRLEN(kBad[i]), &fVal));
+        CHECK(!CJSON::isFloatingPointNumberString(kBad[i]));
+    }
+
+    //Slices of a longer string
+    LPCTSTR pStrSlice = L("12.25,7");
+    CHECK(CJSON::parseDouble(pStrSlice, 5, &fVal) && fVal == 12.25);
+    int64_t iiVal = 0;
+    CHECK(CJSON::parseInt64(pStrSlice, 2, &iiVal) == 1 && iiVal == 12);
+    CHECK(CJSON::parseInt64(pStrSlice + 6, 1, &iiVal) == 1 && iiVal == 7);
+
+    //'.' is the decimal point in any locale
+    std::string strLocale = setlocale(LC_NUMERIC, nullptr);
+    if(setlocale(LC_NUMERIC, "de_DE.UTF-8") ||
+        setlocale(LC_NUMERIC, "fr_FR.UTF-8") ||
+        setlocale(LC_NUMERIC, "German"))
+    {
+        CHECK(CJSON::parseFloat(L("1.5"), &fVal) && fVal == 1.5);
+        CHECK(CJSON::parseFloat(L("0.1000000000000000055511151231257827021181583404541015625"), &fVal) && fVal == 0.1);
+        CHECK(!CJSON::parseFloat(L("1,5")));
+    }
+    setlocale(LC_NUMERIC, strLocale.c_str());
+
+    //Nodes
+    JSON_DATA jData;
+    CHECK(CJSON::parseJSON(L("[99999999999999999999, -, \"-3.5\", \" 12\", 0x10, \"\"]"), jData) == 1);
+
+    JSON_NODE jRoot, jNode;
+    CHECK(jData.getRootNode(&jRoot));
+    CHECK(jRoot.findNodeByIndex(0, &jNode) == JNT_INTEGER);
+    CHECK(jNode.getValueAsInt64(&iiVal) && iiVal == INT64_MAX);
+    CHECK(jNode.getValueAsDouble(&fVal) && fVal == 1e20);
+    CHECK(jRoot.findNodeByIndex(1, &jNode) == JNT_STRING);
+    CHECK(jRoot.findNodeByIndex(2, &jNode) == JNT_STRING);
+    CHECK(jNode.getValueAsInt64(&iiVal) && iiVal == -3);
+    CHECK(jRoot.findNodeByIndex(3, &jNode) == JNT_STRING);
+    CHECK(jNode.getValueAsInt64(&iiVal) && iiVal == 12);
+    CHECK(jRoot.findNodeByIndex(4, &jNode) == JNT_STRING);
+
+    //Empty string is read as 0
+    CHECK(jRoot.findNodeByIndex(5, &jNode) == JNT_STRING);
+    CHECK(jNode.getValueAsInt64(&iiVal) && iiVal == 0);
+    CHECK(jNode.getValueAsDouble(&fVal) && fVal == 0.0);
+}
+
+
+static void test_MoveNodes()
+{
+    JSON_NODE jRoot;
+    JSON_DATA jDataRoot;
+    CHECK(jRoot.setAsRootNode(&jDataRoot));
+
+    JSON_DATA jDataNode;
+    JSON_NODE jNode(&jDataNode, L("employee"), JNT_OBJECT);
+    CHECK(jNode.addNode_String(L("Name"), L("Wójcik")));
+
+    JSON_DATA jDataArr;
+    JSON_NODE jNodeArr(&jDataArr, L("Grades"), JNT_ARRAY);
+    CHECK(jNodeArr.addNode_Int(nullptr, 34));
+    CHECK(jNodeArr.addNode_Int(nullptr, 0));
+
+    //Objects and arrays are taken over as they are, and the source JSON data is emptied
+    JSON_ARRAY* pJA = (JSON_ARRAY*)jDataArr.val.pValue;
+    CHECK(jNode.addNodeMove(&jNodeArr));
+    CHECK(jDataArr.val.isEmptyValue());
+
+    JSON_NODE jFound;
+    CHECK(jNode.findNodeByName(L("Grades"), &jFound) == JNT_ARRAY);
+    CHECK(jFound.pVal->pValue == pJA);
+
+    JSON_OBJECT* pJO = (JSON_OBJECT*)jDataNode.val.pValue;
+    CHECK(jRoot.addNodeMove(&jNode));
+    CHECK(jDataNode.val.isEmptyValue());
+    CHECK(jRoot.findNodeByName(L("employee"), &jFound) == JNT_OBJECT);
+    CHECK(jFound.pVal->pValue == pJO);
+
+    CHECK(toCompactString(jDataRoot) == L("{\"employee\":{\"Name\":\"Wójcik\",\"Grades\":[34,0]}}"));
+
+    //Moving a node that isn't the root leaves null in its place
+    JSON_DATA jDataSrc;
+    CHECK(CJSON::parseJSON(L("{\"a\": [1, {\"b\": 2}], \"c\": \"text\"}"), jDataSrc) == 1);
+
+    JSON_NODE jSrcRoot, jSrc;
+    CHECK(jDataSrc.getRootNode(&jSrcRoot));
+    CHECK(jSrcRoot.findNodeByName(L("a"), &jSrc) == JNT_ARRAY);
+    CHECK(jFound.setNodeByNameMove(L("Name"), &jSrc) == 1);
+    CHECK(jSrc.getNodeType() == JNT_NULL);
+    CHECK(toCompactString(jDataSrc) == L("{\"a\":null,\"c\":\"text\"}"));
+
+    CHECK(jSrcRoot.findNodeByName(L("c"), &jSrc) == JNT_STRING);
+    CHECK(jFound.setNodeByIndexMove(1, &jSrc));
+    CHECK(toCompactString(jDataSrc) == L("{\"a\":null,\"c\":null}"));
+
+    CHECK(toCompactString(jDataRoot) == L("{\"employee\":{\"Name\":[1,{\"b\":2}],\"Grades\":\"text\"}}"));
+
+    //Nothing is moved if there's no match
+    CHECK(jSrcRoot.findNodeByName(L("a"), &jSrc) == JNT_NULL);
+    CHECK(jFound.setNodeByNameMove(L("missing"), &jSrc) == 0);
+    CHECK(jFound.setNodeByIndexMove(5, &jSrc) == false);
+
+    //Duplicate names get the moved value and copies of it
+    JSON_DATA jDataDup;
+    CHECK(CJSON::parseJSON(L("{\"x\": 1, \"y\": 2, \"x\": 3}"), jDataDup) == 1);
+    JSON_NODE jDupRoot;
+    CHECK(jDataDup.getRootNode(&jDupRoot));
+
+    JSON_DATA jDataPart;
+    CHECK(CJSON::parseJSON(L("{\"k\": [true]}"), jDataPart) == 1);
+    JSON_NODE jPartRoot;
+    CHECK(jDataPart.getRootNode(&jPartRoot));
+    CHECK(jDupRoot.setNodeByNameMove(L("x"), &jPartRoot) == 2);
+    CHECK(jDataPart.val.isEmptyValue());
+    CHECK(toCompactString(jDataDup) == L("{\"x\":{\"k\":[true]},\"y\":2,\"x\":{\"k\":[true]}}"));
+
+    //From JSON data that uses an arena it's copied, since the arena can be reset
+    JSON_DATA jDataArena;
+    CHECK(jDataArena.useArena());
+    CHECK(CJSON::parseJSON(L("[{\"z\": [1, 2, 3]}]"), jDataArena) == 1);
+    JSON_NODE jArenaRoot;
+    CHECK(jDataArena.getRootNode(&jArenaRoot));
+    CHECK(jDupRoot.setNodeByIndexMove(1, &jArenaRoot));
+    CHECK(jDataArena.val.isEmptyValue());
+    CHECK(CJSON::parseJSON(L("[\"reused\"]"), jDataArena) == 1);
+    CHECK(toCompactString(jDataDup) == L("{\"x\":{\"k\":[true]},\"y\":[{\"z\":[1,2,3]}],\"x\":{\"k\":[true]}}"));
+
+    //Not within the same JSON data
+    JSON_NODE jDup2;
+    CHECK(jDupRoot.findNodeByName(L("y"), &jDup2) == JNT_ARRAY);
+    CHECK(!jDupRoot.addNodeMove(&jDup2));
+}
+
+
+static bool removeNegativeCbk(JSON_NODE* pJNode, intptr_t /*nIndex*/, void* pCbkParam)
+{
+    //Remove numbers below 0, and count how many nodes were checked
+    (*(int*)pCbkParam)++;
+
+    int64_t iiVal;
+    return pJNode->getNodeType() == JNT_INTEGER &&
+        pJNode->getValueAsInt64(&iiVal) &&
+        iiVal < 0;
+}
+
+
+static void test_BatchRemoval()
+{
+    JSON_DATA jData;
+    CHECK(CJSON::parseJSON(L("{\"name\": \"Ann\", \"ssn\": \"000-00-0000\", \"Email\": \"a@b.c\", \"age\": 30, \"SSN\": \"dup\", \"tags\": [1, -2, 3, -4, \"x\"]}"), jData) == 1);
+
+    JSON_NODE jRoot;
+    CHECK(jData.getRootNode(&jRoot));
+
+    //By names
+    LPCTSTR arrPII[] = { L("ssn"), L("email"), L("phone") };
+    CHECK(jRoot.removeNodesByNames(arrPII, SIZEOF(arrPII), true) == 1);
+    CHECK(jRoot.removeNodesByNames(arrPII, SIZEOF(arrPII)) == 2);
+    CHECK(jRoot.removeNodesByNames(arrPII, SIZEOF(arrPII)) == 0);
+    CHECK(toCompactString(jData) == L("{\"name\":\"Ann\",\"age\":30,\"tags\":[1,-2,3,-4,\"x\"]}"));
+
+    LPCTSTR arrBad[] = { L("name"), L("") };
+    CHECK(jRoot.removeNodesByNames(arrBad, SIZEOF(arrBad)) == -1);
+    CHECK(jRoot.getNodeCount() == 3);
+
+    //By predicate
+    JSON_NODE jTags;
+    CHECK(jRoot.findNodeByName(L("tags"), &jTags) == JNT_ARRAY);
+    CHECK(jTags.removeNodesByNames(arrPII, SIZEOF(arrPII)) == -1);
+
+    int nCntChecked = 0;
+    CHECK(jTags.removeNodesIf(removeNegativeCbk, &nCntChecked) == 2);
+    CHECK(nCntChecked == 5);
+    CHECK(toCompactString(jData) == L("{\"name\":\"Ann\",\"age\":30,\"tags\":[1,3,\"x\"]}"));
+
+    //By indexes, in any order
+    intptr_t arrInds[] = { 2, 0, 2 };
+    CHECK(jTags.removeNodesByIndexes(arrInds, SIZEOF(arrInds)) == 2);
+
+    intptr_t arrOutOfRange[] = { 0, 1 };
+    CHECK(jTags.removeNodesByIndexes(arrOutOfRange, SIZEOF(arrOutOfRange)) == -1);
+    CHECK(jTags.removeNodesByIndexes(nullptr, 0) == 0);
+
+    intptr_t arrObjInds[] = { 1 };
+    CHECK(jRoot.removeNodesByIndexes(arrObjInds, SIZEOF(arrObjInds)) == 1);
+    CHECK(toCompactString(jData) == L("{\"name\":\"Ann\",\"tags\":[3]}"));
+
+    //Large object with its name index, in an arena
+    JSON_DATA jDataBig;
+    CHECK(jDataBig.useArena());
+
+    std_wstring strBig = L("{");
+    for(int i = 0; i < 1000; i++)
+    {
+        strBig += i % 10 == 0 ? L("\"pii\": 1, ") : L("\"k\": 2, ");
+        strBig += L("\"sub\": [{\"a\": [1]}], ");
+    }
+    strBig += L("\"end\": 3}");
+
+    CHECK(CJSON::parseJSON(strBig.c_str(), jDataBig) == 1);
+
+    JSON_NODE jBig;
+    CHECK(jDataBig.getRootNode(&jBig));
+
+    LPCTSTR arrBig[] = { L("PII"), L("sub") };
+    CHECK(jBig.removeNodesByNames(arrBig, SIZEOF(arrBig)) == 1100);
+    CHECK(jBig.getNodeCount() == 901);
+    CHECK(jBig.findNodeByName(L("pii"), nullptr) == JNT_NONE);
+    CHECK(jBig.findNodeByName(L("end"), nullptr) == JNT_INTEGER);
+}
+
+
+static void test_ParseFile()
+{
+    LPCTSTR pStrPath = L("cjson_tests_parse.json");
+
+    std_wstring str = L("{\"name\": \"Łódź €\", \"arr\": [1, 2.5, true, null]}");
+    LPCTSTR pStrCompact = L("{\"name\":\"Łódź €\",\"arr\":[1,2.5,true,null]}");
+
+    //Straight from the mapped file, or converted first
+    static const JSON_ENCODING kEncs[] = { JENC_UTF_8, JENC_UNICODE_16, JENC_UNICODE_16BE };
+    for(size_t e = 0; e < SIZEOF(kEncs); e++)
+    {
+        CHECK(CJSON::writeFileContentsAsString(pStrPath, &str, kEncs[e]));
+
+        JSON_DATA jData;
+        CHECK(CJSON::parseJSONFile(pStrPath, jData) == 1);
+        CHECK(toCompactString(jData) == pStrCompact);
+    }
+
+    //No BOM
+    std::string strUtf8;
+    CHECK(CJSON::getStringForUTF8(str.c_str(), strUtf8));
+    CHECK(CJSON::writeFileContents(pStrPath, (const BYTE*)strUtf8.data(), strUtf8.size()));
+
+    //Strings can't reference the file after it's unmapped
+    JSON_DATA jData;
+    CHECK(CJSON::parseJSONFile(pStrPath, jData, nullptr, JPF_REFERENCE_SOURCE) == 1);
+    CHECK(toCompactString(jData) == pStrCompact);
+
+    JSON_NODE jRoot, jName;
+    CHECK(jData.getRootNode(&jRoot));
+    CHECK(jRoot.findNodeByName(L("name"), &jName) == JNT_STRING);
+    CHECK(jName.pVal->pStrRef == nullptr);
+
+    //Ends right at the end of a page
+    std::string strPage = "[\"x\"";
+    while(strPage.size() < 4096 - 1)
+        strPage += ' ';
+    strPage += ']';
+    CHECK(CJSON::writeFileContents(pStrPath, (const BYTE*)strPage.data(), strPage.size()));
+    CHECK(CJSON::parseJSONFile(pStrPath, jData) == 1);
+    CHECK(toCompactString(jData) == L("[\"x\"]"));
+
+    strPage.back() = '1';
+    JSON_ERROR jErr;
+    CHECK(CJSON::writeFileContents(pStrPath, (const BYTE*)strPage.data(), strPage.size()));
+    CHECK(CJSON::parseJSONFile(pStrPath, jData, &jErr) == 0);
+    CHECK(jErr.nErrIndex == 4095);
+    CHECK(jData.val.isEmptyValue());
+
+    //Size limit
+    CHECK(CJSON::parseJSONFile(pStrPath, jData, nullptr, JPF_NONE, 4095) == -1);
+    CHECK(CJSON::GetLastError() == EFBIG);
+    CHECK(CJSON::parseJSONFile(pStrPath, jData, nullptr, JPF_NONE, 4096) == 0);
+
+    //Empty file
+    CHECK(CJSON::writeFileContents(pStrPath, (const BYTE*)"", 0));
+    CHECK(CJSON::parseJSONFile(pStrPath, jData) == 0);
+
+    remove(pStrPath);
+
+    CHECK(CJSON::parseJSONFile(pStrPath, jData, &jErr) == -1);
+    CHECK(CJSON::GetLastError() == ENOENT);
+
+    //Strings that aren't null-terminated
+    const char* pStrJSON = "[12, 3]";
+    std::vector<WCHAR> arrBuff(pStrJSON, pStrJSON + 5);
+
+    CHECK(CJSON::parseJSON(arrBuff.data(), 5, jData) == 0);
+    CHECK(CJSON::parseJSON(arrBuff.data(), 3, jData) == 0);
+    arrBuff[3] = ']';
+    CHECK(CJSON::parseJSON(arrBuff.data(), 4, jData) == 1);
+    CHECK(toCompactString(jData) == L("[12]"));
+}
+
+
+struct LINES_TEST_STATE
+{
+    std::vector<intptr_t> arrLines;         //Lines in the order they were delivered
+    std::vector<intptr_t> arrBadLines;      //Lines that failed to parse
+    std::vector<intptr_t> arrErrIndexes;    //JSON_ERROR::nErrIndex for each of 'arrBadLines'
+    intptr_t nCntWrongValues;               //Lines where "n" wasn't the line index
+    intptr_t nStopAt;                       //Line to stop at, or -1 not to
+};
+
+
+static bool collectLinesCbk(intptr_t nLine, int nRes, JSON_DATA* pJData, JSON_ERROR* pJError, void* pCbkParam)
+{
+    //Collect lines like {"n": <line index>}
+    LINES_TEST_STATE* pState = (LINES_TEST_STATE*)pCbkParam;
+    pState->arrLines.push_back(nLine);
+
+    if(nRes == 1)
+    {
+        JSON_NODE jRoot;
+        int64_t iiVal = -1;
+        if(!pJData->getRootNode(&jRoot) ||
+            jRoot.findNodeByNameAndGetValueAsInt64(L("n"), &iiVal) != JNT_INTEGER ||
+            iiVal != nLine)
+        {
+            pState->nCntWrongValues++;
+        }
+    }
+    else
+    {
+        pState->arrBadLines.push_back(nLine);
+        pState->arrErrIndexes.push_back(pJError->nErrIndex);
+    }
+
+    return nLine != pState->nStopAt;
+}
+
+
+static void test_JSONLines()
+{
+    //Lines like {"n": <line index>}, with empty lines and a few errors
+    std_wstring str;
+    std::vector<intptr_t> arrExpLines, arrExpBad;
+
+    for(int n = 0; n < 20000; n++)
+    {
+        if(n % 97 == 5)
+        {
+            str += n % 2 ? L("  \r\n") : L("\n");
+            continue;
+        }
+
+        arrExpLines.push_back(n);
+
+        if(n % 1000 == 999)
+        {
+            str += L("{\"n\": ]\n");
+            arrExpBad.push_back(n);
+            continue;
+        }
+
+        char buff[64];
+        snprintf(buff, sizeof(buff), "{\"n\": %d, \"pad\": [1, 2, 3]}%s", n, n % 3 ? "\n" : "\r\n");
+        for(const char* p = buff; *p; p++)
+            str += (WCHAR)*p;
+    }
+
+    //Last line without a new-line
+    str += L("{\"n\": 20000}");
+    arrExpLines.push_back(20000);
+
+    static const UINT kThreads[] = { 1, 3, 0 };
+    for(size_t t = 0; t < SIZEOF(kThreads); t++)
+    {
+        for(int o = 0; o < 2; o++)
+        {
+            LINES_TEST_STATE state = {};
+            state.nStopAt = -1;
+            CHECK(CJSON::parseJSONLines(str.c_str(), str.size(), collectLinesCbk, &state, kThreads[t], o == 0) == 0);
+
+            if(o == 1)
+            {
+                std::sort(state.arrLines.begin(), state.arrLines.end());
+                std::sort(state.arrBadLines.begin(), state.arrBadLines.end());
+            }
+
+            CHECK(state.arrLines == arrExpLines);
+            CHECK(state.arrBadLines == arrExpBad);
+            CHECK(state.arrErrIndexes.size() == arrExpBad.size() &&
+                std::count(state.arrErrIndexes.begin(), state.arrErrIndexes.end(), 6) == (intptr_t)arrExpBad.size());
+            CHECK(state.nCntWrongValues == 0);
+        }
+    }
+
+    //Stop early
+    LINES_TEST_STATE state = {};
+    state.nStopAt = 500;
+    CHECK(CJSON::parseJSONLines(str.c_str(), str.size(), collectLinesCbk, &state, 4) == -1);
+    CHECK(CJSON::GetLastError() == ERROR_CANCELLED);
+    CHECK(!state.arrLines.empty() && state.arrLines.back() == 500);
+
+    //Nothing to parse
+    state = LINES_TEST_STATE();
+    state.nStopAt = -1;
+    CHECK(CJSON::parseJSONLines(L("\n\n  \n"), 5, collectLinesCbk, &state) == 1);
+    CHECK(state.arrLines.empty());
+    CHECK(CJSON::parseJSONLines(nullptr, 0, collectLinesCbk, &state) == -1);
+
+    //From files
+    LPCTSTR pStrPath = L("cjson_tests_lines.json");
+    std_wstring strOK = L("{\"n\": 0}\n{\"n\": 1, \"s\": \"€\"}\n\n{\"n\": 3}\n");
+
+    static const JSON_ENCODING kEncs[] = { JENC_UTF_8, JENC_UNICODE_16BE };
+    for(size_t e = 0; e < SIZEOF(kEncs); e++)
+    {
+        CHECK(CJSON::writeFileContentsAsString(pStrPath, &strOK, kEncs[e]));
+
+        state = LINES_TEST_STATE();
+        state.nStopAt = -1;
+        CHECK(CJSON::parseJSONLinesFile(pStrPath, collectLinesCbk, &state, 2) == 1);
+        CHECK(state.arrLines.size() == 3 && state.arrLines[2] == 3);
+        CHECK(state.nCntWrongValues == 0);
+    }
+
+    remove(pStrPath);
+
+    CHECK(CJSON::parseJSONLinesFile(pStrPath, collectLinesCbk, &state) == -1);
+    CHECK(CJSON::GetLastError() == ENOENT);
+}
+
+
+static void test_ParallelArray()
+{
+    //Elements with strings that look like separators, nesting, escapes and plain values
+    std_wstring str = L("[\n");
+    for(int n = 0; n < 3000; n++)
+    {
+        char buff[256];
+        snprintf(buff, sizeof(buff),
+                 "  {\"id\": %d, \"s\": \"a,b]c[{\\\"%d\\\\\", \"arr\": [[%d, -1.5e3], {\"x\": \"}\"}, []], \"ok\": %s},\n"
+                 "  \"str %d ,]\", %d, null, [ ],\n",
+                 n, n, n, n % 2 ? "true" : "false", n, n);
+
+        for(const char* p = buff; *p; p++)
+            str += (WCHAR)*p;
+    }
+    str += L("  \"Łódź €\"\n]  ");
+    CHECK(str.size() > JSON_PARALLEL_MIN_LEN);
+
+    static const UINT kFlags[] = { JPF_NONE, JPF_NATIVE_VALUES, JPF_REFERENCE_SOURCE };
+    for(size_t f = 0; f < SIZEOF(kFlags); f++)
+    {
+        JSON_DATA jDataSerial, jDataPar;
+        CHECK(CJSON::parseJSON(str.c_str(), jDataSerial, nullptr, kFlags[f]) == 1);
+        CHECK(CJSON::parseJSONParallel(str.c_str(), str.size(), jDataPar, nullptr, kFlags[f], 4) == 1);
+
+        JSON_NODE jRoot;
+        CHECK(jDataPar.getRootNode(&jRoot));
+        CHECK(jRoot.getNodeCount() == 3000 * 5 + 1);
+        CHECK(toCompactString(jDataPar) == toCompactString(jDataSerial));
+    }
+
+    //Errors must be the same as when parsed in one thread
+    struct ERR_CASE
+    {
+        const char* pFind;      //Text to replace
+        const char* pReplace;   //Replacement
+    };
+
+    static const ERR_CASE kErrs[] = {
+        { "\"id\": 1500,", "\"id\": 1500" },                 //Missing comma in an object
+        { "\"str 2000 ,]\", 2000,", "\"str 2000 ,]\" 2000," },  //Missing comma between root elements
+        { "[[2999,", "[[2999,," },                           //Extra comma in nested array
+        { "\"str 10 ,]\", 10, null,", "\"str 10 ,]\", 10, }, null," },    //Stray closing brace
+        { "[[10, -1.5e3]", "[[10 -1.5e3]" },                //Missing comma in nested array
+        { "\"str 5 ,]\",", "\"str 5 ,]\",," },                //Empty root element
+        { "\"Łódź €\"\n]", "\"Łódź €\"\n]]" },              //Data after the root
+        { "\"Łódź €\"\n]", "\"Łódź €\n]" },                 //Unterminated string
+    };
+
+    for(size_t e = 0; e < SIZEOF(kErrs); e++)
+    {
+        std_wstring strFind, strRepl;
+        for(const char* p = kErrs[e].pFind; *p; p++)
+            strFind += (WCHAR)*p;
+        for(const char* p = kErrs[e].pReplace; *p; p++)
+            strRepl += (WCHAR)*p;
+
+        std_wstring strBad = str;
+        size_t nFnd = strBad.find(strFind);
+        CHECK(nFnd != std_wstring::npos);
+        strBad.replace(nFnd, strFind.size(), strRepl);
+
+        JSON_DATA jDataSerial, jDataPar;
+        JSON_ERROR jErrSerial, jErrPar;
+        int nResSerial = CJSON::parseJSON(strBad.c_str(), jDataSerial, &jErrSerial);
+        CHECK(nResSerial == 0);
+        CHECK(CJSON::parseJSONParallel(strBad.c_str(), strBad.size(), jDataPar, &jErrPar, JPF_NONE, 3) == nResSerial);
+        CHECK(jErrPar.nErrIndex == jErrSerial.nErrIndex);
+        CHECK(jErrPar.strErrDesc == jErrSerial.strErrDesc);
+        CHECK(jDataPar.val.isEmptyValue() == jDataSerial.val.isEmptyValue());
+    }
+
+    //Not an array, or with an arena
+    JSON_DATA jDataSerial;
+    CHECK(CJSON::parseJSON(str.c_str(), jDataSerial) == 1);
+    std_wstring strCompact = toCompactString(jDataSerial);
+
+    JSON_DATA jData;
+    std_wstring strObj = L("{\"a\": ") + str + L("}");
+    CHECK(CJSON::parseJSONParallel(strObj.c_str(), strObj.size(), jData, nullptr, JPF_NONE, 4) == 1);
+    CHECK(toCompactString(jData) == L("{\"a\":") + strCompact + L("}"));
+
+    JSON_DATA jDataArena;
+    CHECK(jDataArena.useArena());
+    CHECK(CJSON::parseJSONParallel(str.c_str(), str.size(), jDataArena, nullptr, JPF_NONE, 4) == 1);
+    CHECK(toCompactString(jDataArena) == strCompact);
+
+    //From a file
+    LPCTSTR pStrPath = L("cjson_tests_parallel.json");
+    CHECK(CJSON::writeFileContentsAsString(pStrPath, &str, JENC_UTF_8));
+
+    JSON_DATA jDataFile;
+    CHECK(CJSON::parseJSONFile(pStrPath, jDataFile, nullptr, JPF_NONE, 0, 4) == 1);
+    CHECK(toCompactString(jDataFile) == strCompact);
+
+    remove(pStrPath);
+}
+
+
+struct FREEZE_READER
+{
+    JSON_DATA* pJData;          //Data to read (frozen, or not changed while it is read)
+    int nCntBad;                //Receives number of lookups with wrong results
+};
+
+static void readFrozenData(FREEZE_READER* pReader)
+{
+    //Look up every member of the frozen document from one thread
+    pReader->nCntBad = 0;
+
+    JSON_NODE jRoot, jCfg;
+    if(!pReader->pJData->getRootNode(&jRoot) ||
+        jRoot.findNodeByName(L("cfg"), &jCfg) != JNT_OBJECT)
+    {
+        pReader->nCntBad++;
+        return;
+    }
+
+    for(int r = 0; r < 20; r++)
+    {
+        for(int n = 0; n < 200; n++)
+        {
+            char buff[32];
+            snprintf(buff, sizeof(buff), "K%d", n);
+            std_wstring strName;
+            for(const char* p = buff; *p; p++)
+                strName += (WCHAR)*p;
+
+            //Case-insensitive search
+            int64_t iiVal = -1;
+            if(jCfg.findNodeByNameAndGetValueAsInt64(strName.c_str(), &iiVal) != JNT_INTEGER ||
+                iiVal != n * 3)
+            {
+                pReader->nCntBad++;
+            }
+        }
+
+        JSON_NODE jArr, jElmt;
+        double fVal = 0;
+        if(jRoot.findNodeByName(L("arr"), &jArr, true) != JNT_ARRAY ||
+            jArr.findNodeByIndex(r, &jElmt) != JNT_FLOAT ||
+            !jElmt.getValueAsDouble(&fVal) ||
+            fVal != r + 0.5)
+        {
+            pReader->nCntBad++;
+        }
+    }
+}
+
+
+static void test_Freeze()
+{
+    std_wstring str = L("{\"cfg\": {");
+    for(int n = 0; n < 200; n++)
+    {
+        char buff[64];
+        snprintf(buff, sizeof(buff), "%s\"k%d\": %d", n ? ", " : "", n, n * 3);
+        for(const char* p = buff; *p; p++)
+            str += (WCHAR)*p;
+    }
+    str += L("}, \"arr\": [");
+    for(int n = 0; n < 20; n++)
+    {
+        char buff[64];
+        snprintf(buff, sizeof(buff), "%s%d.5", n ? ", " : "", n);
+        for(const char* p = buff; *p; p++)
+            str += (WCHAR)*p;
+    }
+    str += L("], \"small\": {\"a\": true, \"b\": null}}");
+
+    JSON_DATA jData;
+    CHECK(CJSON::parseJSON(str.c_str(), jData) == 1);
+    std_wstring strCompact = toCompactString(jData);
+
+    JSON_NODE jRoot, jSmall;
+    CHECK(jData.getRootNode(&jRoot));
+    CHECK(jRoot.findNodeByName(L("small"), &jSmall) == JNT_OBJECT);
+    CHECK(jSmall.buildNameIndex());
+    CHECK(jSmall.addNode_Int(L("c"), 1));
+
+    CHECK(!jData.isFrozen());
+    CHECK(jData.freeze());
+    CHECK(jData.isFrozen());
+    CHECK(jData.freeze());
+
+    //Nothing can be changed
+    JSON_NODE jCfg, jElmt;
+    CHECK(jData.getRootNode(&jRoot));
+    CHECK(jRoot.findNodeByName(L("cfg"), &jCfg) == JNT_OBJECT);
+    CHECK(jRoot.findNodeByName(L("small"), &jSmall) == JNT_OBJECT);
+
+    CJSON::SetLastError(NO_ERROR);
+    CHECK(!jCfg.addNode_Int(L("new"), 1));
+    CHECK(CJSON::GetLastError() == ERROR_ACCESS_DENIED);
+    CHECK(jCfg.setNodeByName_Int(L("k1"), 7) == -1);
+    CHECK(!jCfg.setNodeByIndex_Null(0));
+    CHECK(jCfg.removeNodeByName(L("k2")) == -1);
+    CHECK(!jCfg.removeNodeByIndex(0));
+    intptr_t arrInds[] = { 0 };
+    CHECK(jCfg.removeNodesByIndexes(arrInds, SIZEOF(arrInds)) == -1);
+    CHECK(!jRoot.setAsRootNode());
+    CHECK(!jSmall.setAsEmptyNode(nullptr, JNT_ARRAY));
+    CHECK(jCfg.buildNameIndex(true));
+
+    //Nor moved out of it
+    JSON_DATA jDataOther;
+    JSON_NODE jOther(&jDataOther);
+    CHECK(jCfg.findNodeByName(L("k5"), &jElmt) == JNT_INTEGER);
+    CHECK(!jOther.addNodeMove(&jElmt));
+    CHECK(jOther.addNode(&jElmt));
+    CHECK(!jCfg.addNode(&jElmt));
+
+    CHECK(toCompactString(jData) == strCompact.substr(0, strCompact.size() - 2) + L(",\"c\":1}}"));
+
+    //Read from several threads
+    FREEZE_READER readers[4];
+    std::thread threads[SIZEOF(readers)];
+    for(size_t t = 0; t < SIZEOF(readers); t++)
+    {
+        readers[t].pJData = &jData;
+        threads[t] = std::thread(readFrozenData, &readers[t]);
+    }
+
+    for(size_t t = 0; t < SIZEOF(readers); t++)
+    {
+        threads[t].join();
+        CHECK(readers[t].nCntBad == 0);
+    }
+
+    //Can be changed again once emptied
+    CHECK(CJSON::parseJSON(str.c_str(), jData) == 1);
+    CHECK(!jData.isFrozen());
+
+    //Data that isn't frozen can be searched from several threads too, as long as nothing changes it
+    JSON_DATA jDataArena;
+    CHECK(jDataArena.useArena());
+    CHECK(CJSON::parseJSON(str.c_str(), jDataArena) == 1);
+
+    JSON_DATA* pJDatas[] = { &jData, &jDataArena };
+    for(size_t d = 0; d < SIZEOF(pJDatas); d++)
+    {
+        for(size_t t = 0; t < SIZEOF(readers); t++)
+        {
+            readers[t].pJData = pJDatas[d];
+            threads[t] = std::thread(readFrozenData, &readers[t]);
+        }
+
+        for(size_t t = 0; t < SIZEOF(readers); t++)
+        {
+            threads[t].join();
+            CHECK(readers[t].nCntBad == 0);
+        }
+
+        //Including objects that got more members after they were searched, which adds them to its index right away
+        JSON_NODE jRootD, jCfgD;
+        CHECK(pJDatas[d]->getRootNode(&jRootD));
+        CHECK(jRootD.findNodeByName(L("cfg"), &jCfgD) == JNT_OBJECT);
+
+        std::vector<intptr_t> arrInds;
+        for(intptr_t n = 50; n < 200; n++)
+            arrInds.push_back(n);
+
+        CHECK(jCfgD.removeNodesByIndexes(arrInds.data(), arrInds.size()) == 150);
+        CHECK(jCfgD.findNodeByName(L("K10"), nullptr) == JNT_INTEGER);
+        CHECK(jCfgD.findNodeByName(L("K60"), nullptr) == JNT_NONE);
+
+        for(int n = 50; n < 200; n++)
+        {
+            char buff[32];
+            snprintf(buff, sizeof(buff), "k%d", n);
+            std_wstring strName;
+            for(const char* p = buff; *p; p++)
+                strName += (WCHAR)*p;
+
+            CHECK(jCfgD.addNode_Int(strName.c_str(), n * 3));
+        }
+
+        for(size_t t = 0; t < SIZEOF(readers); t++)
+        {
+            threads[t] = std::thread(readFrozenData, &readers[t]);
+        }
+
+        for(size_t t = 0; t < SIZEOF(readers); t++)
+        {
+            threads[t].join();
+            CHECK(readers[t].nCntBad == 0);
+        }
+    }
+
+    CHECK(jData.getRootNode(&jRoot));
+    CHECK(jRoot.addNode_Null(L("z")));
+}
+
+
+static std_wstring makeVersionJSON(int nVersion)
+{
+    //RETURN: = JSON config with 'nVersion'
+    char buff[128];
+    snprintf(buff, sizeof(buff), "{\"version\": %d, \"check\": %d, \"name\": \"config %d\"}", nVersion, nVersion * 2, nVersion);
+
+    std_wstring str;
+    for(const char* p = buff; *p; p++)
+        str += (WCHAR)*p;
+
+    return str;
+}
+
+struct SNAPSHOT_READER
+{
+    JSON_SNAPSHOTS* pSnapshots;     //Snapshots to read
+    std::atomic<bool>* pbStop;      //Set to true to stop reading
+    int nCntBad;                    //Receives number of reads with wrong results
+};
+
+static void readSnapshots(SNAPSHOT_READER* pReader)
+{
+    //Keep reading the latest version of config, which must never go back
+    pReader->nCntBad = 0;
+
+    int64_t iiLastVersion = 0;
+    JSON_SNAPSHOT_REF ref;
+
+    while(!pReader->pbStop->load())
+    {
+        JSON_NODE jRoot;
+        int64_t iiVersion = -1, iiCheck = -1;
+        if(!ref.acquire(pReader->pSnapshots) ||
+            !ref.getRootNode(&jRoot) ||
+            jRoot.findNodeByNameAndGetValueAsInt64(L("version"), &iiVersion) != JNT_INTEGER ||
+            jRoot.findNodeByNameAndGetValueAsInt64(L("check"), &iiCheck) != JNT_INTEGER ||
+            iiCheck != iiVersion * 2 ||
+            iiVersion < iiLastVersion)
+        {
+            pReader->nCntBad++;
+        }
+
+        iiLastVersion = iiVersion;
+    }
+}
+
+
+static void test_Snapshots()
+{
+    JSON_SNAPSHOTS snaps;
+
+    //Nothing published yet
+    JSON_SNAPSHOT_REF ref0(&snaps);
+    CHECK(ref0.getData() == nullptr);
+
+    std_wstring str = makeVersionJSON(1);
+    CHECK(snaps.publishJSON(str.c_str(), str.size(), nullptr, JPF_REFERENCE_SOURCE) == 1);
+    str = makeVersionJSON(9);   //Must not be referenced
+
+    JSON_SNAPSHOT_REF ref1(&snaps);
+    JSON_NODE jRoot;
+    int64_t iiVal = 0;
+    CHECK(ref1.getData() && ref1.getData()->isFrozen());
+    CHECK(ref1.getRootNode(&jRoot));
+    CHECK(jRoot.findNodeByNameAndGetValueAsInt64(L("version"), &iiVal) == JNT_INTEGER && iiVal == 1);
+    CHECK(!jRoot.addNode_Null(L("x")));
+
+    //Bad JSON doesn't replace it
+    JSON_ERROR jErr;
+    std_wstring strBad = L("{\"version\": 2,");
+    CHECK(snaps.publishJSON(strBad.c_str(), strBad.size(), &jErr) == 0);
+    CHECK(jErr.nErrIndex >= 0);
+
+    //Version 1 stays alive for as long as it's used
+    str = makeVersionJSON(2);
+    CHECK(snaps.publishJSON(str.c_str(), str.size()) == 1);
+    CHECK(snaps.reclaim() == 1);
+    CHECK(ref1.getRootNode(&jRoot));
+    CHECK(jRoot.findNodeByNameAndGetValueAsInt64(L("version"), &iiVal) == JNT_INTEGER && iiVal == 1);
+
+    JSON_SNAPSHOT_REF ref2(&snaps);
+    CHECK(ref2.getRootNode(&jRoot));
+    CHECK(jRoot.findNodeByNameAndGetValueAsInt64(L("version"), &iiVal) == JNT_INTEGER && iiVal == 2);
+
+    //Acquiring again moves to the latest version
+    CHECK(ref1.acquire(&snaps) == ref2.getData());
+    CHECK(snaps.reclaim() == 0);
+
+    //From a file
+    LPCTSTR pStrPath = L("cjson_tests_snapshot.json");
+    str = makeVersionJSON(3);
+    CHECK(CJSON::writeFileContentsAsString(pStrPath, &str, JENC_UTF_8));
+    CHECK(snaps.publishJSONFile(pStrPath) == 1);
+    remove(pStrPath);
+    CHECK(snaps.publishJSONFile(pStrPath) == -1);
+
+    CHECK(ref1.acquire(&snaps));
+    CHECK(ref1.getRootNode(&jRoot));
+    CHECK(jRoot.findNodeByNameAndGetValueAsInt64(L("version"), &iiVal) == JNT_INTEGER && iiVal == 3);
+
+    ref1.release();
+    ref2.release();
+    ref0.release();
+    CHECK(snaps.reclaim() == 0);
+
+    //Read while new versions are published
+    std::atomic<bool> bStop(false);
+    SNAPSHOT_READER readers[4];
+    std::thread threads[SIZEOF(readers)];
+    for(size_t t = 0; t < SIZEOF(readers); t++)
+    {
+        readers[t].pSnapshots = &snaps;
+        readers[t].pbStop = &bStop;
+        threads[t] = std::thread(readSnapshots, &readers[t]);
+    }
+
+    for(int v = 4; v < 300; v++)
+    {
+        str = makeVersionJSON(v);
+        CHECK(snaps.publishJSON(str.c_str(), str.size()) == 1);
+    }
+
+    bStop = true;
+
+    for(size_t t = 0; t < SIZEOF(readers); t++)
+    {
+        threads[t].join();
+        CHECK(readers[t].nCntBad == 0);
+    }
+
+    CHECK(snaps.reclaim() == 0);
+
+    //No current version
+    CHECK(snaps.publish(nullptr));
+    CHECK(!ref1.acquire(&snaps));
+}
+
+
+static void test_MsgPack()
+{
+    //Known encoding
+    {
+        JSON_DATA jData;
+        CHECK(CJSON::parseJSON(L("{\"a\": [1, -1, true, null, \"x\", 1.5, 1.50]}"), jData) == 1);
+
+        std::vector<BYTE> arrData;
+        CHECK(CJSON::toMsgPack(&jData, &arrData));
+
+        static const BYTE kExpected[] = {
+            0x81, 0xa1, 'a', 0x97, 0x01, 0xff, 0xc3, 0xc0, 0xa1, 'x',
+            0xcb, 0x3f, 0xf8, 0, 0, 0, 0, 0, 0,
+            0xc7, 4, JSON_MSGPACK_EXT_PLAIN_TEXT, '1', '.', '5', '0',
+        };
+        CHECK(arrData.size() == sizeof(kExpected));
+        CHECK(memcmp(arrData.data(), kExpected, std::min(arrData.size(), sizeof(kExpected))) == 0);
+    }
+
+    //Lossless round trip for all kinds of values and sizes
+    std_wstring str = L("{\"ints\": [0, 127, 128, 255, 256, 65535, 65536, 4294967295, 4294967296, 9223372036854775807, "
+                        "-1, -32, -33, -128, -129, -32768, -32769, -2147483648, -2147483649, -9223372036854775808], "
+                        "\"floats\": [1.5, -0.25, 1.0e300, 5e-324, 0.1], "
+                        "\"texts\": [1.50, 1E5, -0, 007, 12345678901234567890123, 1e999, nan], "
+                        "\"other\": [null, true, false, \"\", \"t\\\"ab\\t\\u0001\", \"Łódź €\", {}, []], "
+                        "\"dup\": 1, \"dup\": 2, \"Ключ\": {\"nested\": [[[{\"deep\": true}]]]}");
+
+    std_wstring strLong;
+    for(int n = 0; n < 70000; n++)
+        strLong += (WCHAR)('a' + n % 26);
+
+    const int kLongLens[] = { 31, 32, 255, 256, 65535, 65536 };
+    for(size_t l = 0; l < SIZEOF(kLongLens); l++)
+    {
+        str += L(", \"") + strLong.substr(0, kLongLens[l]) + L("\": \"") + strLong.substr(0, kLongLens[l]) + L("\"");
+    }
+
+    const int kArrLens[] = { 15, 16, 65535, 65536 };
+    for(size_t l = 0; l < SIZEOF(kArrLens); l++)
+    {
+        str += L(", \"arr\": [");
+        for(int n = 0; n < kArrLens[l]; n++)
+            str += n ? L(",{\"k\":0}") : L("{\"k\":0}");
+        str += L("]");
+    }
+    str += L("}");
+
+    static const UINT kFlags[] = { JPF_NONE, JPF_NATIVE_VALUES, JPF_NATIVE_VALUES | JPF_KEEP_NUMBER_TEXT, JPF_REFERENCE_SOURCE };
+    std::vector<BYTE> arrData;
+
+    for(size_t f = 0; f < SIZEOF(kFlags); f++)
+    {
+        JSON_DATA jData;
+        CHECK(CJSON::parseJSON(str.c_str(), jData, nullptr, kFlags[f]) == 1);
+        CHECK(CJSON::toMsgPack(&jData, &arrData));
+
+        JSON_DATA jDataBin;
+        CHECK(CJSON::parseMsgPack(arrData.data(), arrData.size(), jDataBin) == 1);
+        CHECK(toCompactString(jDataBin) == toCompactString(jData));
+
+        //And again from the decoded data
+        std::vector<BYTE> arrData2;
+        CHECK(CJSON::toMsgPack(&jDataBin, &arrData2));
+        CHECK(arrData2 == arrData);
+    }
+
+    //Decoded values
+    JSON_DATA jData;
+    CHECK(CJSON::parseMsgPack(arrData.data(), arrData.size(), jData) == 1);
+
+    JSON_NODE jRoot, jArr, jElmt;
+    int64_t iiVal = 0;
+    double fVal = 0;
+    bool bVal = false;
+    CHECK(jData.getRootNode(&jRoot));
+    CHECK(jRoot.findNodeByName(L("ints"), &jArr) == JNT_ARRAY);
+    CHECK(jArr.findNodeByIndex(19, &jElmt) == JNT_INTEGER);
+    CHECK(jElmt.getValueAsInt64(&iiVal) && iiVal == INT64_MIN);
+    CHECK(jRoot.findNodeByName(L("floats"), &jArr) == JNT_ARRAY);
+    CHECK(jArr.findNodeByIndex(1, &jElmt) == JNT_FLOAT);
+    CHECK(jElmt.getValueAsDouble(&fVal) && fVal == -0.25);
+    CHECK(jRoot.findNodeByName(L("texts"), &jArr) == JNT_ARRAY);
+    CHECK(jArr.findNodeByIndexAndGetValueAsString(0, &str) == JNT_FLOAT && str == L("1.50"));
+    CHECK(jArr.findNodeByIndexAndGetValueAsString(4, &str) == JNT_INTEGER && str == L("12345678901234567890123"));
+    CHECK(jRoot.findNodeByName(L("other"), &jArr) == JNT_ARRAY);
+    CHECK(jArr.findNodeByIndex(1, &jElmt) == JNT_BOOLEAN && jElmt.getValueAsBool(&bVal) && bVal);
+    CHECK(jArr.findNodeByIndex(0, &jElmt) == JNT_NULL && jElmt.isNullValue());
+    CHECK(jArr.findNodeByIndexAndGetValueAsString(5, &str) == JNT_STRING && str == L("Łódź €"));
+    CHECK(jRoot.findNodeByNameAndGetValueAsInt64(L("dup"), &iiVal) == JNT_INTEGER && iiVal == 1);
+
+    //With an arena
+    JSON_DATA jDataArena;
+    CHECK(jDataArena.useArena());
+    CHECK(CJSON::parseMsgPack(arrData.data(), arrData.size(), jDataArena) == 1);
+    CHECK(toCompactString(jDataArena) == toCompactString(jData));
+
+    //Forms that CJSON::toMsgPack() doesn't write
+    {
+        static const BYTE kData[] = {
+            0x94,
+            0xca, 0x3f, 0xc0, 0, 0,                                 //float32 1.5
+            0xcf, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,   //uint64 max
+            0xd9, 1, 'x',                                           //str8
+            0xd4, JSON_MSGPACK_EXT_PLAIN_TEXT, '7',                 //fixext1
+        };
+
+        JSON_DATA jDataForms;
+        CHECK(CJSON::parseMsgPack(kData, sizeof(kData), jDataForms) == 1);
+        CHECK(toCompactString(jDataForms) == L("[1.5,18446744073709551615,\"x\",7]"));
+    }
+
+    //Errors
+    std::vector<BYTE> arrSmall;
+    CHECK(CJSON::parseJSON(L("{\"a\": [1, \"xyz\", {\"b\": 1.50}], \"c\": 300}"), jData) == 1);
+    CHECK(CJSON::toMsgPack(&jData, &arrSmall));
+
+    for(size_t n = 0; n < arrSmall.size(); n++)
+    {
+        JSON_DATA jDataBad;
+        JSON_ERROR jErr;
+        CHECK(CJSON::parseMsgPack(arrSmall.data(), n, jDataBad, &jErr) == 0);
+        CHECK(jDataBad.val.isEmptyValue());
+        CHECK(jErr.nErrIndex >= 0);
+    }
+
+    struct ERR_CASE
+    {
+        BYTE data[8];           //MessagePack data
+        size_t ncbSz;           //Size of 'data' in BYTEs
+        intptr_t nErrIndex;     //Expected error offset
+    };
+
+    static const ERR_CASE kErrs[] = {
+        { { 0xc0, 0xc0 }, 2, 1 },                                   //Data after the root
+        { { 0x91, 0xc4, 1, 0 }, 4, 1 },                             //Binary data
+        { { 0x91, 0xc1 }, 2, 1 },                                   //Never used
+        { { 0x81, 0x01, 0xc0 }, 3, 1 },                             //Name that is not a string
+        { { 0x81, 0x91, 0xa0, 0xc0 }, 4, 1 },                       //Name that is an array
+        { { 0xd4, 0x05, '1' }, 3, 0 },                              //Unknown extension
+        { { 0xc7, 0, JSON_MSGPACK_EXT_PLAIN_TEXT }, 3, 0 },         //Empty plain value
+        { { 0xdd, 0xff, 0xff, 0xff, 0xff, 0xc0 }, 6, 0 },           //Bad size of array
+        { { 0xdb, 0xff, 0xff, 0xff, 0xff, 'a' }, 6, 0 },            //Bad size of string
+        { { 0xa2, 0xc3, 0x28 }, 3, 0 },                             //Bad UTF-8
+    };
+
+    for(size_t e = 0; e < SIZEOF(kErrs); e++)
+    {
+        JSON_DATA jDataBad;
+        JSON_ERROR jErr;
+        CHECK(CJSON::parseMsgPack(kErrs[e].data, kErrs[e].ncbSz, jDataBad, &jErr) == 0);
+        CHECK(jErr.nErrIndex == kErrs[e].nErrIndex);
+        CHECK(jDataBad.val.isEmptyValue());
+    }
+
+    //Too deeply nested
+    std::vector<BYTE> arrDeep(JSON_MSGPACK_MAX_DEPTH + 1, 0x91);
+    arrDeep.push_back(0xc0);
+    CHECK(CJSON::parseMsgPack(arrDeep.data(), arrDeep.size(), jData) == 0);
+    arrDeep.erase(arrDeep.begin());
+    CHECK(CJSON::parseMsgPack(arrDeep.data(), arrDeep.size(), jData) == 1);
+
+    //Nothing to write
+    JSON_DATA jDataEmpty;
+    CHECK(!CJSON::toMsgPack(&jDataEmpty, &arrData));
+}
+
+
+static std::vector<intptr_t> findAllInImage(JSON_IMAGE_NODE& jNode, LPCTSTR pStrName, bool bCaseSensitive)
+{
+    std::vector<intptr_t> arrInds;
+    JSON_SRCH srch;
+
+    while(jNode.findNodeByName(pStrName, nullptr, bCaseSensitive, &srch) > JNT_NONE)
+        arrInds.push_back(srch.getIndexFoundAt());
+
+    return arrInds;
+}
+
+static void checkImageNode(JSON_NODE& jNode, JSON_IMAGE_NODE& jImgNode)
+{
+    //Image must read the same as the tree
+    JSON_NODE_TYPE type = jNode.getNodeType();
+    CHECK(jImgNode.getNodeType() == type);
+    CHECK(jImgNode.getNodeCount() == jNode.getNodeCount());
+
+    std_wstring str1, str2;
+    CHECK(jImgNode.getValueAsString(&str1) == jNode.getValueAsString(&str2) && str1 == str2);
+
+    intptr_t nchLen = 0;
+    LPCTSTR pStr = jImgNode.getValueAsStringPtr(&nchLen);
+    if(pStr)
+        CHECK(str1 == std_wstring(pStr, nchLen));
+
+    int64_t iiVal1 = 0, iiVal2 = 0;
+    CHECK(jImgNode.getValueAsInt64(&iiVal1) == jNode.getValueAsInt64(&iiVal2) && iiVal1 == iiVal2);
+
+    double fVal1 = 0, fVal2 = 0;
+    CHECK(jImgNode.getValueAsDouble(&fVal1) == jNode.getValueAsDouble(&fVal2));
+    CHECK(fVal1 == fVal2 || (fVal1 != fVal1 && fVal2 != fVal2));
+
+    bool bVal1 = false, bVal2 = false;
+    CHECK(jImgNode.getValueAsBool(&bVal1, false) == jNode.getValueAsBool(&bVal2, false) && bVal1 == bVal2);
+    CHECK(jImgNode.isNullValue() == jNode.isNullValue());
+
+    for(intptr_t i = 0; i < jNode.getNodeCount(); i++)
+    {
+        JSON_NODE jn;
+        JSON_IMAGE_NODE jin;
+        CHECK(jImgNode.findNodeByIndex(i, &jin) == jNode.findNodeByIndex(i, &jn));
+        CHECK(jn.strName == jin.getName());
+
+        checkImageNode(jn, jin);
+
+        if(type == JNT_OBJECT)
+        {
+            CHECK(findAllInImage(jImgNode, jn.strName.c_str(), true) == findAllByName(jNode, jn.strName.c_str(), true));
+            CHECK(findAllInImage(jImgNode, jn.strName.c_str(), false) == findAllByName(jNode, jn.strName.c_str(), false));
+        }
+    }
+
+    CHECK(jImgNode.findNodeByIndex(jNode.getNodeCount() < 0 ? 0 : jNode.getNodeCount()) == JNT_ERROR);
+}
+
+
+static void test_JSONImage()
+{
+    std_wstring str = L("{\"ints\": [0, -1, 9223372036854775807, -9223372036854775808, 12345678901234567890123, -0, 007], "
+                        "\"floats\": [1.5, -0.25, 1.0e300, 5e-324, 0.1, 1.50, 1E5, 1e999], "
+                        "\"other\": [null, true, false, \"\", \"t\\\"ab\\t\\u0001\", \"Łódź €\", \"123\", \"true\", {}, [], nan, True], "
+                        "\"Ключ\": {\"nested\": [[[{\"deep\": true}]]]}, \"big\": {");
+
+    //Large enough for the index of names, with repeated names and names that can't be case-folded
+    for(int i = 0; i < 100; i++)
+    {
+        char buff[64];
+        if(i % 10 == 0)
+            snprintf(buff, sizeof(buff), "\"key%d\": %d, \"%s\": %d, ", i, i, i % 20 ? "dup" : "DUP", i);
+        else
+            snprintf(buff, sizeof(buff), "\"key%d\": %d, ", i, i);
+
+        for(const char* p = buff; *p; p++)
+            str += (WCHAR)*p;
+    }
+    str += L("\"Ключ\": 1, \"ключ\": 2, \"Mixed\": 3, \"MIXED\": 4, \"dup\": \"last\"}}");
+
+    static const UINT kFlags[] = { JPF_NONE, JPF_NATIVE_VALUES, JPF_NATIVE_VALUES | JPF_KEEP_NUMBER_TEXT };
+    std::vector<BYTE> arrData;
+
+    for(size_t f = 0; f < SIZEOF(kFlags); f++)
+    {
+        JSON_DATA jData;
+        CHECK(CJSON::parseJSON(str.c_str(), jData, nullptr, kFlags[f]) == 1);
+        CHECK(CJSON::writeJSONImage(&jData, &arrData));
+
+        JSON_IMAGE img;
+        JSON_NODE jRoot;
+        JSON_IMAGE_NODE jImgRoot;
+        CHECK(img.openData(arrData.data(), arrData.size()));
+        CHECK(jData.getRootNode(&jRoot));
+        CHECK(img.getRootNode(&jImgRoot));
+        checkImageNode(jRoot, jImgRoot);
+
+        JSON_IMAGE_NODE jBig;
+        CHECK(jImgRoot.findNodeByName(L("BIG"), &jBig) == JNT_OBJECT);
+        CHECK(jBig.findNodeByName(L("BIG"), nullptr) == JNT_NONE);
+        CHECK(findAllInImage(jBig, L("KЛЮЧ"), false) == std::vector<intptr_t>(0));
+        CHECK(findAllInImage(jBig, L("DUP"), false).size() == 11);
+        CHECK(findAllInImage(jBig, L("mixed"), false).size() == 2);
+        CHECK(jImgRoot.findNodeByName(L(""), nullptr) == JNT_ERROR);
+    }
+
+    //Values read right from the image
+    JSON_IMAGE img;
+    CHECK(img.openData(arrData.data(), arrData.size()));
+
+    JSON_IMAGE_NODE jRoot, jArr, jNode;
+    CHECK(img.getRootNode(&jRoot));
+    CHECK(jRoot.findNodeByName(L("other"), &jArr) == JNT_ARRAY);
+    CHECK(jArr.findNodeByIndex(5, &jNode) == JNT_STRING);
+    CHECK(std_wstring(jNode.getValueAsStringPtr()) == L("Łódź €"));
+
+    int64_t iiVal = 0;
+    CHECK(jRoot.findNodeByName(L("ints"), &jArr) == JNT_ARRAY);
+    CHECK(jArr.findNodeByIndex(3, &jNode) == JNT_INTEGER);
+    CHECK(jNode.getValueAsStringPtr() == nullptr);
+    CHECK(jNode.getValueAsInt64(&iiVal) && iiVal == INT64_MIN);
+    CHECK(jArr.findNodeByIndex(4, &jNode) == JNT_INTEGER);
+    CHECK(std_wstring(jNode.getValueAsStringPtr()) == L("12345678901234567890123"));
+    CHECK(jNode.getValueAsInt64(&iiVal) && iiVal == INT64_MAX);
+
+    //From a file
+    LPCTSTR pStrPath = L("cjson_tests_image.bin");
+    {
+        JSON_DATA jData;
+        CHECK(CJSON::parseJSON(str.c_str(), jData) == 1);
+        CHECK(CJSON::writeJSONImageFile(pStrPath, &jData));
+
+        JSON_IMAGE imgFile;
+        CHECK(imgFile.open(pStrPath));
+        CHECK(imgFile.isOpen());
+
+        JSON_NODE jDataRoot;
+        CHECK(jData.getRootNode(&jDataRoot));
+        CHECK(imgFile.getRootNode(&jRoot));
+        checkImageNode(jDataRoot, jRoot);
+
+        imgFile.close();
+        CHECK(!imgFile.getRootNode(&jRoot));
+    }
+
+    //Not an image
+    std_wstring strText = str;
+    CHECK(CJSON::writeFileContentsAsString(pStrPath, &strText, JENC_UTF_8));
+    CHECK(!img.open(pStrPath));
+    CHECK(CJSON::GetLastError() == ERROR_BAD_FORMAT);
+    CHECK(!img.isOpen());
+    remove(pStrPath);
+    CHECK(!img.open(pStrPath));
+
+    CHECK(!img.openData(arrData.data(), arrData.size() - 8));
+    CHECK(CJSON::GetLastError() == ERROR_BAD_FORMAT);
+    CHECK(!img.openData(arrData.data() + 1, arrData.size() - 1));
+    CHECK(CJSON::GetLastError() == ERROR_INVALID_PARAMETER);
+
+    std::vector<BYTE> arrBad = arrData;
+    arrBad[8]++;
+    CHECK(!img.openData(arrBad.data(), arrBad.size()));
+
+    //Corrupted contents are never read outside of the image
+    for(size_t i = 24; i < arrData.size(); i += 3)
+    {
+        arrBad = arrData;
+        arrBad[i] ^= (BYTE)(0x5A + i);
+
+        CHECK(img.openData(arrBad.data(), arrBad.size()));
+        CHECK(img.getRootNode(&jRoot));
+
+        for(intptr_t r = 0; r < 5; r++)
+        {
+            JSON_IMAGE_NODE jObj, jElmt;
+            if(jRoot.findNodeByIndex(r, &jObj) <= JNT_NONE)
+                continue;
+
+            for(intptr_t e = 0; e < jObj.getNodeCount(); e++)
+            {
+                std_wstring strVal;
+                jObj.findNodeByIndex(e, &jElmt);
+                jElmt.getValueAsString(&strVal);
+                jElmt.getValueAsDouble(nullptr);
+            }
+
+            jObj.findNodeByName(L("key50"), nullptr, true);
+            jObj.findNodeByName(L("KEY50"), nullptr, false);
+            jObj.findNodeByName(L("ключ"), nullptr, false);
+        }
+    }
+
+    //Nothing to write
+    JSON_DATA jDataEmpty;
+    CHECK(!CJSON::writeJSONImage(&jDataEmpty, &arrData));
+    CHECK(!CJSON::writeJSONImage(nullptr, &arrData));
+}
+
+
+static void checkTapeNode(JSON_NODE& jNode, JSON_TAPE_NODE& jTapeNode)
+{
+    //Tape must read the same as the tree
+    JSON_NODE_TYPE type = jNode.getNodeType();
+    CHECK(jTapeNode.getNodeType() == type);
+    CHECK(jTapeNode.getNodeCount() == jNode.getNodeCount());
+
+    //INFO: Root node of JSON_DATA doesn't read numbers from their text, but the root of the tape does
+    if(jNode.typeNode != JNT_ROOT)
+    {
+        std_wstring str1, str2;
+        CHECK(jTapeNode.getValueAsString(&str1) == jNode.getValueAsString(&str2) && str1 == str2);
+
+        intptr_t nchLen = 0;
+        LPCTSTR pStr = jTapeNode.getValueAsStringPtr(&nchLen);
+        if(pStr)
+            CHECK(str1 == std_wstring(pStr, nchLen));
+
+        int64_t iiVal1 = 0, iiVal2 = 0;
+        CHECK(jTapeNode.getValueAsInt64(&iiVal1) == jNode.getValueAsInt64(&iiVal2) && iiVal1 == iiVal2);
+
+        double fVal1 = 0, fVal2 = 0;
+        CHECK(jTapeNode.getValueAsDouble(&fVal1) == jNode.getValueAsDouble(&fVal2));
+        CHECK(fVal1 == fVal2 || (fVal1 != fVal1 && fVal2 != fVal2));
+
+        bool bVal1 = false, bVal2 = false;
+        CHECK(jTapeNode.getValueAsBool(&bVal1, false) == jNode.getValueAsBool(&bVal2, false) && bVal1 == bVal2);
+        CHECK(jTapeNode.isNullValue() == jNode.isNullValue());
+    }
+
+    //Going through elements one after another gives the same nodes as finding them
+    JSON_TAPE_NODE jtnNext;
+    intptr_t nCnt = jNode.getNodeCount();
+
+    for(intptr_t i = 0; i < nCnt; i++)
+    {
+        JSON_NODE jn;
+        JSON_TAPE_NODE jtn;
+        CHECK(jTapeNode.findNodeByIndex(i, &jtn) == jNode.findNodeByIndex(i, &jn));
+        CHECK(jn.strName == jtn.getName());
+
+        if(i == 0)
+            jtnNext = jtn;
+        else
+            CHECK(jtnNext.getNextNode(&jtnNext) == jn.getNodeType() && jn.strName == jtnNext.getName());
+
+        checkTapeNode(jn, jtn);
+
+        if(type == JNT_OBJECT)
+        {
+            JSON_SRCH srch;
+            std::vector<intptr_t> arrInds;
+            while(jTapeNode.findNodeByName(jn.strName.c_str(), nullptr, false, &srch) > JNT_NONE)
+                arrInds.push_back(srch.getIndexFoundAt());
+
+            CHECK(arrInds == findAllByName(jNode, jn.strName.c_str(), false));
+        }
+    }
+
+    if(nCnt > 0)
+        CHECK(jtnNext.getNextNode() == JNT_NONE);
+
+    CHECK(jTapeNode.findNodeByIndex(nCnt < 0 ? 0 : nCnt) == JNT_ERROR);
+}
+
+
+static void test_Tape()
+{
+    std_wstring str = L("{\"ints\": [0, -1, 9223372036854775807, -9223372036854775808, 12345678901234567890123, -0], "
+                        "\"floats\": [1.5, -0.25, 1.0e300, 5e-324, 0.1, 1.50, 1E5, 1e999], "
+                        "\"other\": [null, true, false, \"\", \"t\\\"ab\\t\\u0001\", \"Łódź €\", \"123\", \"true\", {}, [], nan, True], "
+                        "\"Ключ\": {\"nested\": [[[{\"deep\": true}]], [], {\"\": 1}]}, "
+                        "\"dup\": 1, \"DUP\": 2, \"ключ\": 3, \"dup\": \"last\"}");
+
+    JSON_DATA jData;
+    JSON_TAPE tape;
+    CHECK(CJSON::parseJSON(str.c_str(), jData) == 1);
+    CHECK(CJSON::parseJSONTape(str.c_str(), -1, tape) == 1);
+    CHECK(!tape.isEmpty());
+    CHECK(tape.getMemorySize() > 0);
+
+    JSON_NODE jRoot;
+    JSON_TAPE_NODE jTapeRoot;
+    CHECK(jData.getRootNode(&jRoot));
+    CHECK(tape.getRootNode(&jTapeRoot));
+    checkTapeNode(jRoot, jTapeRoot);
+    CHECK(jTapeRoot.getNextNode() == JNT_NONE);
+
+    JSON_TAPE_NODE jNode;
+    CHECK(jTapeRoot.findNodeByName(L("DUP"), &jNode, true) == JNT_INTEGER);
+    CHECK(jTapeRoot.findNodeByName(L("none"), &jNode) == JNT_NONE);
+    CHECK(jTapeRoot.findNodeByName(L(""), &jNode) == JNT_ERROR);
+    CHECK(jTapeRoot.findNodeByName(L("ints"), &jNode) == JNT_ARRAY);
+    CHECK(jNode.findNodeByName(L("x"), nullptr) == JNT_ERROR);
+    CHECK(jNode.getNextNode(&jNode) == JNT_ARRAY && std_wstring(jNode.getName()) == L("floats"));
+
+    //Scalar roots, and only a part of the string
+    static LPCTSTR kRoots[] = { L("1"), L("\"s\""), L("null"), L(" [ ] "), L("{}"), L("-1.5e3") };
+    for(size_t r = 0; r < SIZEOF(kRoots); r++)
+    {
+        JSON_DATA jd;
+        CHECK(CJSON::parseJSON(kRoots[r], jd) == 1);
+        CHECK(CJSON::parseJSONTape(kRoots[r], -1, tape) == 1);
+        CHECK(jd.getRootNode(&jRoot));
+        CHECK(tape.getRootNode(&jTapeRoot));
+        checkTapeNode(jRoot, jTapeRoot);
+    }
+
+    CHECK(CJSON::parseJSONTape(L("[1, 2] trailing"), 6, tape) == 1);
+    CHECK(tape.getRootNode(&jTapeRoot) && jTapeRoot.getNodeCount() == 2);
+
+    //Same errors as parseJSON()
+    static LPCTSTR kBad[] = { L(""), L("[1, 2"), L("{\"a\" 1}"), L("[1] 2"), L("{\"a\": }"), L("[1 2]"), L("[\"abc]") };
+    for(size_t b = 0; b < SIZEOF(kBad); b++)
+    {
+        JSON_ERROR jErr1, jErr2;
+        CHECK(CJSON::parseJSON(kBad[b], jData, &jErr1) == 0);
+        CHECK(CJSON::parseJSONTape(kBad[b], -1, tape, &jErr2) == 0);
+        CHECK(jErr1.nErrIndex == jErr2.nErrIndex && jErr1.strErrDesc == jErr2.strErrDesc);
+        CHECK(CJSON::GetLastError() == ERROR_INVALID_DATA);
+        CHECK(tape.isEmpty());
+        CHECK(!tape.getRootNode(&jTapeRoot));
+    }
+
+    CHECK(CJSON::parseJSONTape(nullptr, -1, tape) == -1);
+
+    //Unset node
+    JSON_TAPE_NODE jtnNone;
+    CHECK(jtnNone.getNodeType() == JNT_NONE);
+    CHECK(jtnNone.getNodeCount() == -1);
+    CHECK(jtnNone.getNextNode() == JNT_ERROR);
+    CHECK(!jtnNone.getValueAsString(nullptr));
+    CHECK(jtnNone.findNodeByName(L("a"), nullptr) == JNT_ERROR);
+}
+
+
+static const TEST_CASE g_tests[] = {
+    { "ParseAndRoundTrip",              test_ParseAndRoundTrip },
+    { "ParseErrors",                    test_ParseErrors },
+    { "Utf8AndCaseInsensitiveNames",    test_Utf8AndCaseInsensitiveNames },
+    { "BuildDocument",                  test_BuildDocument },
+    { "Encodings",                      test_Encodings },
+    { "Files",                          test_Files },
+    { "LastError",                      test_LastError },
+    { "Arena",                          test_Arena },
+    { "ReferenceSource",                test_ReferenceSource },
+    { "SimdLevels",                     test_SimdLevels },
+    { "StrictUtf8",                     test_StrictUtf8 },
+    { "UnicodeEscapes",                 test_UnicodeEscapes },
+    { "Formatting",                     test_Formatting },
+    { "Sink",                           test_Sink },
+    { "PushParser",                     test_PushParser },
+    { "SaxHandler",                     test_SaxHandler },
+    { "NameIndex",                      test_NameIndex },
+    { "NativeValues",                   test_NativeValues },
+    { "NodeTypeCache",                  test_NodeTypeCache },
+    { "NumberFormatting",               test_NumberFormatting },
+    { "NumberParsing",                  test_NumberParsing },
+    { "MoveNodes",                      test_MoveNodes },
+    { "BatchRemoval",                   test_BatchRemoval },
+    { "ParseFile",                      test_ParseFile },
+    { "JSONLines",                      test_JSONLines },
+    { "ParallelArray",                  test_ParallelArray },
+    { "Freeze",                         test_Freeze },
+    { "Snapshots",                      test_Snapshots },
+    { "MsgPack",                        test_MsgPack },
+    { "JSONImage",                      test_JSONImage },
+    { "Tape",                           test_Tape },
+};
+
+
+int main(int argc, char* argv[])
+{
+    for(size_t t = 0; t < SIZEOF(g_tests); t++)
+    {
+        //Run only the tests requested on the command line (if any)
+        bool bRun = argc <= 1;
+        for(int a = 1; a < argc; a++)
+        {
+            if(strcmp(argv[a], g_tests[t].pName) == 0)
+                bRun = true;
+        }
+
+        if(!bRun)
+            continue;
+
+        int nCntFailed = g_nCntFailed;
+        g_tests[t].pfnTest();
+
+        printf("%s %s\n", g_nCntFailed == nCntFailed ? "[ OK ]" : "[FAIL]", g_tests[t].pName);
+    }
+
+    printf("%d checks, %d failed\n", g_nCntChecks, g_nCntFailed);
+
+    return g_nCntFailed ? 1 : 0;
+}